@@ -0,0 +1,423 @@
+#include "HeadlessRender.h"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "ExportSinkPipeline.h"
+#include "IsolatedRenderEngine.h"
+#include "OfflineStemCapture.h"
+#include "ProjectSerializer.h"
+#include "RenderProjectBuilder.h"
+#include "TempoMap.h"
+
+namespace sampledex
+{
+    namespace
+    {
+        constexpr std::size_t stemMemoryBudgetBytes = static_cast<std::size_t>(512) << 20;
+
+        juce::String getArgValue(const juce::StringArray& args, const juce::String& key)
+        {
+            const auto keyWithEquals = key + "=";
+            for (int i = 0; i < args.size(); ++i)
+            {
+                const auto token = args[i].trim();
+                if (token.startsWithIgnoreCase(keyWithEquals))
+                    return token.fromFirstOccurrenceOf("=", false, false).trim().unquoted();
+                if (token.equalsIgnoreCase(key) && i + 1 < args.size() && !args[i + 1].trim().startsWith("--"))
+                    return args[i + 1].trim().unquoted();
+            }
+            return {};
+        }
+
+        bool hasArg(const juce::StringArray& args, const juce::String& key)
+        {
+            for (const auto& token : args)
+                if (token.trim().equalsIgnoreCase(key) || token.trim().startsWithIgnoreCase(key + "="))
+                    return true;
+            return false;
+        }
+
+        juce::File resolvePath(const juce::String& path)
+        {
+            return juce::File::isAbsolutePath(path) ? juce::File(path)
+                                                    : juce::File::getCurrentWorkingDirectory().getChildFile(path);
+        }
+
+        juce::AudioFormat* findWritableFormat(juce::AudioFormatManager& formats, const juce::String& extension)
+        {
+            auto* format = formats.findFormatForFileExtension(extension);
+            if (format == nullptr && extension.equalsIgnoreCase("aiff"))
+                format = formats.findFormatForFileExtension("aif");
+            return format != nullptr && format->canDoStereo() ? format : nullptr;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> createWriter(juce::AudioFormat& format,
+                                                              const juce::File& file,
+                                                              double sampleRate,
+                                                              int bitDepth,
+                                                              juce::String& error)
+        {
+            if (!file.getParentDirectory().createDirectory() || (file.existsAsFile() && !file.deleteFile()))
+            {
+                error = "Unable to write " + file.getFullPathName();
+                return {};
+            }
+
+            std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+            if (stream == nullptr)
+            {
+                error = "Unable to create output stream: " + file.getFullPathName();
+                return {};
+            }
+
+            juce::AudioFormatWriterOptions options;
+            options = options.withSampleRate(sampleRate)
+                             .withNumChannels(2)
+                             .withBitsPerSample(bitDepth)
+                             .withQualityOptionIndex(0);
+            std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(stream, options));
+            if (writer == nullptr)
+                error = "Unable to create " + format.getFormatName() + " writer for " + file.getFullPathName();
+            return writer;
+        }
+
+        int resolveBitDepth(juce::AudioFormat& format, int requested)
+        {
+            const auto possible = format.getPossibleBitDepths();
+            return possible.isEmpty() || possible.contains(requested) ? requested : possible.getLast();
+        }
+
+        // The track as loadProjectFromFile builds it, except that plugins load synchronously
+        // from their saved description (no plugin list or quarantine here) and live input
+        // is left off.
+        std::unique_ptr<Track> createTrack(const ProjectSerializer::TrackState& source,
+                                           int trackNumber,
+                                           juce::AudioPluginFormatManager& pluginFormats,
+                                           double sampleRate,
+                                           int blockSize,
+                                           juce::StringArray& warnings)
+        {
+            auto track = std::make_unique<Track>(source.name.isNotEmpty() ? source.name : "Track " + juce::String(trackNumber),
+                                                 pluginFormats);
+            RenderProjectBuilder::applyTrackState(*track, source, trackNumber, sampleRate, blockSize, warnings);
+
+            for (const auto& slot : source.pluginSlots)
+            {
+                if (!slot.hasDescription)
+                    continue;
+
+                const auto label = slot.description.name.isNotEmpty() ? slot.description.name : slot.description.fileOrIdentifier;
+                juce::String error;
+                const bool loaded = slot.slotIndex == Track::instrumentSlotIndex
+                    ? track->loadInstrumentPlugin(slot.description, error)
+                    : track->loadPluginInSlot(slot.slotIndex, slot.description, error);
+                if (!loaded)
+                {
+                    warnings.add("Track " + juce::String(trackNumber) + " plugin load failed (" + label + "): " + error);
+                    continue;
+                }
+                if (!slot.state.isEmpty() && !track->setPluginStateForSlot(slot.slotIndex, slot.state))
+                    warnings.add("Track " + juce::String(trackNumber) + " plugin state restore failed (" + label + ")");
+                track->setPluginSlotBypassed(slot.slotIndex, slot.bypassed);
+            }
+            return track;
+        }
+
+        // Same search as the app: a missing audio file is looked for by name below the
+        // project folder.
+        void relinkMissingAudioFiles(std::vector<Clip>& clips,
+                                     const juce::File& projectFile,
+                                     juce::AudioFormatManager& audioFormats,
+                                     juce::StringArray& warnings)
+        {
+            const auto root = projectFile.getParentDirectory();
+            for (auto& clip : clips)
+            {
+                if (clip.type != ClipType::Audio || clip.audioFilePath.isEmpty() || juce::File(clip.audioFilePath).existsAsFile())
+                    continue;
+
+                const auto targetName = juce::File(clip.audioFilePath).getFileName();
+                juce::File found;
+                for (const auto& entry : juce::RangedDirectoryIterator(root, true, targetName, juce::File::findFiles))
+                {
+                    found = entry.getFile();
+                    break;
+                }
+
+                if (!found.existsAsFile())
+                {
+                    warnings.add("Missing audio file: " + clip.audioFilePath);
+                    continue;
+                }
+                clip.audioFilePath = found.getFullPathName();
+                if (std::unique_ptr<juce::AudioFormatReader> reader(audioFormats.createReaderFor(found)); reader != nullptr)
+                    clip.audioSampleRate = juce::jmax(1.0, reader->sampleRate);
+            }
+        }
+
+        juce::var describePass(const juce::String& name,
+                               const OfflineRenderProgress& progress,
+                               double sampleRate,
+                               double wallSeconds,
+                               bool rendered)
+        {
+            auto* pass = new juce::DynamicObject();
+            pass->setProperty("name", name);
+            pass->setProperty("ok", rendered);
+            pass->setProperty("audioSeconds", static_cast<double>(progress.samplesRendered) / sampleRate);
+            pass->setProperty("renderSeconds", progress.elapsedSeconds);
+            pass->setProperty("speedFactor", progress.speedFactor);
+            pass->setProperty("wallSeconds", wallSeconds); // includes waiting on the encoders
+            return juce::var(pass);
+        }
+
+        int finish(juce::DynamicObject& report, const juce::String& reportPath, int exitCode)
+        {
+            report.setProperty("status", exitCode == 0 ? "ok" : "error");
+            report.setProperty("exitCode", exitCode);
+            const juce::var reportVar(&report);
+            std::cout << juce::JSON::toString(reportVar, true).toStdString() << "\n" << std::flush;
+            if (reportPath.isNotEmpty() && !resolvePath(reportPath).replaceWithText(juce::JSON::toString(reportVar) + "\n"))
+                std::cerr << "Unable to write report: " << reportPath << "\n";
+            return exitCode;
+        }
+    }
+
+    int runHeadlessRender(const juce::StringArray& args)
+    {
+        juce::DynamicObject::Ptr report = new juce::DynamicObject();
+        const auto reportPath = getArgValue(args, "--report");
+        const auto fail = [&](const juce::String& error, int exitCode)
+        {
+            report->setProperty("error", error);
+            return finish(*report, reportPath, exitCode);
+        };
+
+        const auto projectPath = getArgValue(args, "--render");
+        const auto outPath = getArgValue(args, "--out");
+        const auto stemsPath = getArgValue(args, "--stems");
+        if (projectPath.isEmpty() || (outPath.isEmpty() && stemsPath.isEmpty()))
+            return fail("Usage: --render <project> --out <file> [--stems <dir> [--stem-format <ext>]]", 2);
+
+        // Message manager for plugins that expect one; no window or audio device is opened.
+        const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+        const double sampleRate = hasArg(args, "--sample-rate") ? getArgValue(args, "--sample-rate").getDoubleValue() : 48000.0;
+        if (sampleRate < 8000.0 || sampleRate > 768000.0)
+            return fail("Unsupported sample rate.", 2);
+
+        OfflineRenderSettings settings;
+        if (hasArg(args, "--block-size"))
+            settings.blockSize = getArgValue(args, "--block-size").getIntValue();
+        if (hasArg(args, "--threads"))
+        {
+            // Threads count the calling thread, which renders too.
+            const int threads = juce::jmax(1, getArgValue(args, "--threads").getIntValue());
+            settings.workerCount = threads - 1;
+            settings.workerLimit = threads - 1;
+        }
+        const int requestedBitDepth = hasArg(args, "--bit-depth") ? getArgValue(args, "--bit-depth").getIntValue() : 24;
+
+        const auto projectFile = resolvePath(projectPath);
+        report->setProperty("project", projectFile.getFullPathName());
+        report->setProperty("sampleRate", sampleRate);
+        report->setProperty("blockSize", settings.getResolvedBlockSize());
+
+        juce::AudioFormatManager audioFormats;
+        audioFormats.registerBasicFormats();
+        juce::AudioPluginFormatManager pluginFormats;
+        pluginFormats.addDefaultFormats();
+
+        ProjectSerializer::ProjectState loaded;
+        juce::String loadError;
+        const double loadStartMs = juce::Time::getMillisecondCounterHiRes();
+        if (!ProjectSerializer::loadProject(projectFile, loaded, audioFormats, loadError))
+            return fail(loadError.isNotEmpty() ? loadError : juce::String("Unable to load project."), 1);
+
+        juce::StringArray warnings;
+        auto project = std::make_unique<IsolatedRenderProject>();
+        const int trackCount = juce::jmin(static_cast<int>(loaded.tracks.size()), IsolatedRenderEngine::maxTracks);
+        if (static_cast<int>(loaded.tracks.size()) > trackCount)
+            warnings.add("Only the first " + juce::String(trackCount) + " tracks are rendered.");
+        juce::StringArray trackNames;
+        for (int i = 0; i < trackCount; ++i)
+        {
+            project->tracks.push_back(createTrack(loaded.tracks[static_cast<size_t>(i)], i + 1, pluginFormats,
+                                                  sampleRate, settings.getResolvedBlockSize(), warnings));
+            trackNames.add(project->tracks.back()->getTrackName());
+        }
+        if (project->tracks.empty())
+            return fail("The project has no tracks.", 1);
+
+        // Laid out as loadProjectFromFile lays out the session. The master and aux settings
+        // are not stored in the project, so the app's startup defaults apply.
+        auto arrangement = loaded.arrangement;
+        relinkMissingAudioFiles(arrangement, projectFile, audioFormats, warnings);
+        for (auto& clip : arrangement)
+            clip.trackIndex = juce::jlimit(0, trackCount - 1, clip.trackIndex);
+        const double bpm = juce::jmax(1.0, loaded.bpm);
+        std::vector<TempoEvent> tempoEvents;
+        for (const auto& tempo : loaded.tempoMap)
+            tempoEvents.push_back({ tempo.beat, tempo.bpm });
+        RenderProjectBuilder::normaliseTempoEvents(tempoEvents, bpm);
+        RenderProjectBuilder::setBaseTempo(tempoEvents, bpm);
+        RenderProjectBuilder::normaliseTempoEvents(tempoEvents, bpm);
+        TempoMapIndex tempoMap;
+        tempoMap.rebuild(tempoEvents, bpm);
+        std::vector<int> renderIndexForTrack(static_cast<size_t>(trackCount));
+        std::iota(renderIndexForTrack.begin(), renderIndexForTrack.end(), 0);
+        RenderProjectBuilder::setSession(*project,
+                                         renderIndexForTrack,
+                                         arrangement,
+                                         loaded.automationLanes,
+                                         tempoMap,
+                                         bpm,
+                                         juce::jlimit(-24, 24, loaded.transposeSemitones),
+                                         RenderProjectBuilder::MixSettings {});
+
+        IsolatedRenderEngine::Pass pass;
+        if (hasArg(args, "--loop") && loaded.loopEnabled)
+        {
+            pass.startBeat = loaded.loopStartBeat;
+            pass.endBeat = loaded.loopEndBeat;
+        }
+        else
+        {
+            pass.endBeat = 4.0;
+            for (const auto& clip : project->arrangement)
+                pass.endBeat = juce::jmax(pass.endBeat, clip.startBeat + juce::jmax(0.0625, clip.lengthBeats));
+        }
+        if (hasArg(args, "--start-beat"))
+            pass.startBeat = juce::jmax(0.0, getArgValue(args, "--start-beat").getDoubleValue());
+        if (hasArg(args, "--end-beat"))
+            pass.endBeat = getArgValue(args, "--end-beat").getDoubleValue();
+        if (pass.endBeat <= pass.startBeat + 0.0001)
+            pass.endBeat = pass.startBeat + 4.0;
+        if (hasArg(args, "--tail"))
+            pass.tailSeconds = juce::jlimit(0.0, 60.0, getArgValue(args, "--tail").getDoubleValue());
+        pass.includeMasterProcessing = !hasArg(args, "--no-master");
+
+        IsolatedRenderEngine engine(std::move(project), audioFormats, settings);
+        engine.prepare(sampleRate);
+        report->setProperty("tracks", engine.getNumTracks());
+        report->setProperty("loadSeconds", (juce::Time::getMillisecondCounterHiRes() - loadStartMs) * 0.001);
+        report->setProperty("startBeat", pass.startBeat);
+        report->setProperty("endBeat", pass.endBeat);
+
+        juce::Array<juce::var> passes;
+        juce::Array<juce::var> files;
+        double audioSeconds = 0.0;
+        double renderSeconds = 0.0;
+        bool success = true;
+        juce::String failure;
+
+        int stemBitDepth = 24;
+        const auto runPass = [&](const juce::String& name, ExportSinkPipeline* sinks, OfflineStemCapture* capture)
+        {
+            auto thisPass = pass;
+            thisPass.stemCapture = capture;
+            const double startMs = juce::Time::getMillisecondCounterHiRes();
+            if (sinks != nullptr)
+                sinks->start();
+            bool rendered = engine.renderPass(thisPass,
+                                              [&](juce::AudioBuffer<float>& block, int numSamples)
+                                              {
+                                                  if (capture != nullptr
+                                                      && !capture->writeBlock(numSamples,
+                                                                              [&](juce::AudioBuffer<float>& stemBlock, int stemSamples, std::uint32_t& stemDitherState)
+                                                                              {
+                                                                                  ExportSinkPipeline::applyTpdfDither(stemBlock, 0, stemSamples, stemBitDepth, stemDitherState);
+                                                                              }))
+                                                      return false;
+                                                  return sinks == nullptr || sinks->push(block, numSamples);
+                                              });
+            if (sinks != nullptr)
+            {
+                if (!rendered)
+                    sinks->cancel();
+                rendered = sinks->finish() && rendered;
+            }
+            if (capture != nullptr)
+                capture->close();
+
+            const auto& progress = engine.getLastProgress();
+            audioSeconds += static_cast<double>(progress.samplesRendered) / engine.getSampleRate();
+            renderSeconds += progress.elapsedSeconds;
+            passes.add(describePass(name, progress, engine.getSampleRate(),
+                                    (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001, rendered));
+            if (!rendered && failure.isEmpty())
+                failure = (sinks != nullptr && sinks->getError().isNotEmpty()) ? sinks->getError() : "Render failed: " + name;
+            success = success && rendered;
+        };
+
+        if (outPath.isNotEmpty())
+        {
+            auto outFile = resolvePath(outPath);
+            if (outFile.getFileExtension().isEmpty())
+                outFile = outFile.withFileExtension(".wav");
+            auto* format = findWritableFormat(audioFormats, outFile.getFileExtension().substring(1));
+            if (format == nullptr)
+                return fail("No writable format for " + outFile.getFileName(), 2);
+
+            const int bitDepth = resolveBitDepth(*format, requestedBitDepth);
+            juce::String writerError;
+            auto writer = createWriter(*format, outFile, sampleRate, bitDepth, writerError);
+            if (writer == nullptr)
+                return fail(writerError, 1);
+
+            ExportSinkPipeline sinks(engine.getSampleRate(), engine.getBlockSize());
+            sinks.addSink(outFile.getFileName(), std::move(writer), bitDepth, bitDepth < 24);
+            runPass("master", &sinks, nullptr);
+            files.add(outFile.getFullPathName());
+        }
+
+        if (success && stemsPath.isNotEmpty())
+        {
+            const auto stemsDir = resolvePath(stemsPath);
+            const auto extension = hasArg(args, "--stem-format") ? getArgValue(args, "--stem-format") : juce::String("wav");
+            auto* format = findWritableFormat(audioFormats, extension);
+            if (format == nullptr)
+                return fail("No writable format for ." + extension + " stems", 2);
+            const int bitDepth = resolveBitDepth(*format, requestedBitDepth);
+            stemBitDepth = bitDepth;
+
+            // Pre-master stems, tapped in as few passes as the writer budget allows. Every
+            // pass renders the same tracks, so a stem does not depend on its shard.
+            const int stemTrackCount = juce::jmin(engine.getNumTracks(), OfflineStemCapture::maxTracks);
+            const int stemsPerPass = OfflineStemCapture::getMaxStemsPerPass(stemMemoryBudgetBytes, engine.getBlockSize());
+            pass.includeMasterProcessing = false;
+            for (int shardStart = 0; success && shardStart < stemTrackCount; shardStart += stemsPerPass)
+            {
+                const int shardEnd = juce::jmin(stemTrackCount, shardStart + stemsPerPass);
+                OfflineStemCapture capture;
+                for (int trackIndex = shardStart; trackIndex < shardEnd; ++trackIndex)
+                {
+                    auto stemName = juce::String(trackIndex + 1).paddedLeft('0', 2) + " - " + juce::File::createLegalFileName(trackNames[trackIndex]);
+                    const auto stemFile = stemsDir.getChildFile(stemName + "." + extension);
+                    juce::String writerError;
+                    auto writer = createWriter(*format, stemFile, sampleRate, bitDepth, writerError);
+                    if (writer == nullptr)
+                        return fail(writerError, 1);
+                    capture.addTrackStem(trackIndex, std::move(writer));
+                    files.add(stemFile.getFullPathName());
+                }
+                runPass("stems " + juce::String(shardStart + 1) + "-" + juce::String(shardEnd), nullptr, &capture);
+            }
+        }
+
+        report->setProperty("workers", engine.getLastWorkerCount());
+        report->setProperty("passes", passes);
+        report->setProperty("files", files);
+        report->setProperty("audioSeconds", audioSeconds);
+        report->setProperty("renderSeconds", renderSeconds);
+        report->setProperty("speedFactor", renderSeconds > 0.0 ? audioSeconds / renderSeconds : 0.0);
+        report->setProperty("warnings", warnings);
+        if (!success)
+            return fail(failure, 1);
+        return finish(*report, reportPath, 0);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace sampledex
+{
+    // Command-line render (--render): loads a project file without an audio device or a
+    // window, renders the master mix and optionally pre-master stems through an
+    // IsolatedRenderEngine, and prints a JSON report (render time, speed factor, files)
+    // to stdout. Returns the process exit code: 0 rendered, 1 failed, 2 bad arguments.
+    //
+    //   --render <project>       project to load
+    //   --out <file>             master mix; the extension picks the format (default .wav)
+    //   --stems <dir>            also write one pre-master stem per track
+    //   --stem-format <ext>      stem file format by extension: wav (default), aiff, flac, ...
+    //   --sample-rate <hz>       default 48000
+    //   --block-size <samples>   offline block size (default OfflineRenderSettings)
+    //   --threads <n>            threads in the render, counting the calling thread
+    //   --bit-depth <bits>       default 24; TPDF dither below 24
+    //   --start-beat, --end-beat range (default: the whole arrangement), --loop for the loop range
+    //   --tail <seconds>         render past the end, default 2
+    //   --no-master              skip master gain, soft clip and limiter
+    //
+    // The render project is built through RenderProjectBuilder, as the app's export is,
+    // with the app's startup master and aux settings.
+    //   --report <file>          also write the report there
+    int runHeadlessRender(const juce::StringArray& args);
+}
@@ -1,5 +1,7 @@
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "HeadlessRender.h"
+#include "PluginBridge.h"
 #include <cstdlib>
 #include <iostream>
 #include <memory>
@@ -20,16 +22,6 @@ namespace
             || formatName.containsIgnoreCase("AU");
     }
 
-    static bool formatLooksLikeVST3(const juce::AudioPluginFormat& format)
-    {
-        return formatNameLooksLikeVST3(format.getName());
-    }
-
-    static bool formatLooksLikeAudioUnit(const juce::AudioPluginFormat& format)
-    {
-        return formatNameLooksLikeAudioUnit(format.getName());
-    }
-
     static bool formatMatchesRequested(const juce::AudioPluginFormat& format, const juce::String& requestedFormat)
     {
         if (requestedFormat.isEmpty())
@@ -48,54 +40,6 @@ namespace
         return false;
     }
 
-    static void addSearchDirectoryIfPresent(juce::FileSearchPath& path, const juce::File& directory)
-    {
-        if (!directory.isDirectory())
-            return;
-
-        const auto canonical = directory.getFullPathName();
-        for (int i = 0; i < path.getNumPaths(); ++i)
-        {
-            if (path[i].getFullPathName() == canonical)
-                return;
-        }
-
-        path.add(canonical);
-    }
-
-    static juce::FileSearchPath buildAugmentedSearchPathForFormat(juce::AudioPluginFormat& format)
-    {
-        auto searchPath = format.getDefaultLocationsToSearch();
-
-        const auto userHome = juce::File::getSpecialLocation(juce::File::userHomeDirectory);
-        const juce::File systemAudioPlugins("/Library/Audio/Plug-Ins");
-        const juce::File userAudioPlugins = userHome.getChildFile("Library")
-                                                    .getChildFile("Audio")
-                                                    .getChildFile("Plug-Ins");
-
-        const auto currentExe = juce::File::getSpecialLocation(juce::File::currentExecutableFile);
-        const auto appContents = currentExe.getParentDirectory().getParentDirectory();
-        const auto appPlugIns = appContents.getChildFile("PlugIns");
-        const auto appResourcesPlugins = appContents.getChildFile("Resources").getChildFile("Plugins");
-
-        if (formatLooksLikeVST3(format))
-        {
-            addSearchDirectoryIfPresent(searchPath, systemAudioPlugins.getChildFile("VST3"));
-            addSearchDirectoryIfPresent(searchPath, userAudioPlugins.getChildFile("VST3"));
-            addSearchDirectoryIfPresent(searchPath, appPlugIns.getChildFile("VST3"));
-            addSearchDirectoryIfPresent(searchPath, appResourcesPlugins.getChildFile("VST3"));
-        }
-        else if (formatLooksLikeAudioUnit(format))
-        {
-            addSearchDirectoryIfPresent(searchPath, systemAudioPlugins.getChildFile("Components"));
-            addSearchDirectoryIfPresent(searchPath, userAudioPlugins.getChildFile("Components"));
-            addSearchDirectoryIfPresent(searchPath, appPlugIns.getChildFile("Components"));
-            addSearchDirectoryIfPresent(searchPath, appResourcesPlugins.getChildFile("Components"));
-        }
-
-        return searchPath;
-    }
-
     static int parsePluginUidArg(const juce::String& token) noexcept
     {
         const auto trimmed = token.trim();
@@ -217,64 +161,17 @@ namespace
         return {};
     }
 
-    static int parseScanTimeoutMsArg(const juce::StringArray& tokens,
-                                     const juce::String& key,
-                                     int defaultValueMs) noexcept
-    {
-        const auto timeoutArg = getCommandArgValue(tokens, key);
-        if (timeoutArg.isEmpty())
-            return defaultValueMs;
-
-        const auto parsed = timeoutArg.getIntValue();
-        if (parsed <= 0)
-            return defaultValueMs;
-
-        return juce::jlimit(1000, 600000, parsed);
-    }
-
-    static juce::StringArray loadDeadMansPedalEntries(const juce::File& deadMansPedalFile)
+    static int runPluginBridgeHostMode(const juce::StringArray& tokens)
     {
-        juce::StringArray entries;
-        if (!deadMansPedalFile.existsAsFile())
-            return entries;
-
-        entries.addLines(deadMansPedalFile.loadFileAsString());
-        entries.trim();
-        entries.removeEmptyStrings();
-        return entries;
-    }
-
-    static juce::String getLikelyCurrentScanTarget(const juce::String& pluginName,
-                                                   const juce::StringArray& beforeEntries,
-                                                   const juce::StringArray& afterEntries)
-    {
-        if (pluginName.trim().isNotEmpty())
-            return pluginName.trim();
-        if (afterEntries.size() > 0)
-            return afterEntries[afterEntries.size() - 1].trim();
-        if (beforeEntries.size() > 0)
-            return beforeEntries[beforeEntries.size() - 1].trim();
-        return "<unknown plugin>";
-    }
+        const auto sharedMemoryName = getCommandArgValue(tokens, "--plugin-bridge-host");
+        if (sharedMemoryName.isEmpty())
+        {
+            std::cout << "ERROR: Missing plugin bridge shared memory name.\n";
+            return 2;
+        }
 
-    static void appendDeadMansPedalEntryIfNeeded(const juce::File& deadMansPedalFile,
-                                                  const juce::String& entry)
-    {
-        const auto trimmed = entry.trim();
-        if (trimmed.isEmpty())
-            return;
-
-        auto existingEntries = loadDeadMansPedalEntries(deadMansPedalFile);
-        if (existingEntries.contains(trimmed))
-            return;
-
-        juce::String content = deadMansPedalFile.existsAsFile()
-            ? deadMansPedalFile.loadFileAsString()
-            : juce::String();
-        if (content.isNotEmpty() && !content.endsWithChar('\n'))
-            content << "\n";
-        content << trimmed << "\n";
-        deadMansPedalFile.replaceWithText(content);
+        return sampledex::PluginBridgeServer::run(sharedMemoryName,
+                                                  sampledex::PluginBridgeServer::createDefaultFactory());
     }
 
     static int runPluginProbeMode(const juce::StringArray& tokens)
@@ -479,135 +376,69 @@ namespace
         return 0;
     }
 
-    static int runPluginScanPassMode(const juce::StringArray& tokens)
+    static int runPluginScanFileMode(const juce::StringArray& tokens)
     {
-        const auto knownListPath = getCommandArgValue(tokens, "--known");
-        const auto deadMansPedalPath = getCommandArgValue(tokens, "--deadman");
+        const auto target = getCommandArgValue(tokens, "--plugin-scan-file");
         const auto requestedFormat = getCommandArgValue(tokens, "--plugin-scan-format");
-        const int scanTimeoutMs = parseScanTimeoutMsArg(tokens,
-                                                        "--plugin-scan-timeout-ms",
-                                                        45000);
-
-        if (knownListPath.isEmpty() || deadMansPedalPath.isEmpty())
+        const auto outputPath = getCommandArgValue(tokens, "--out");
+        if (target.isEmpty() || requestedFormat.isEmpty() || outputPath.isEmpty())
         {
-            std::cout << "ERROR: Missing plugin scan pass arguments.\n";
+            std::cout << "ERROR: Missing plugin scan arguments.\n";
             return 2;
         }
 
-        const juce::File knownListFile(knownListPath);
-        const juce::File deadMansPedalFile(deadMansPedalPath);
-        knownListFile.getParentDirectory().createDirectory();
-        deadMansPedalFile.getParentDirectory().createDirectory();
-
-        juce::KnownPluginList pluginList;
-        if (knownListFile.existsAsFile())
-        {
-            if (std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(knownListFile)); xml != nullptr)
-                pluginList.recreateFromXml(*xml);
-        }
-
         juce::AudioPluginFormatManager formatManager;
         formatManager.addDefaultFormats();
 
-        juce::StringArray failedFiles;
-        juce::StringArray blacklistedEntries;
-        int scannedFormatCount = 0;
-        for (int formatIndex = 0; formatIndex < formatManager.getNumFormats(); ++formatIndex)
+        juce::AudioPluginFormat* format = nullptr;
+        for (int formatIndex = 0; formatIndex < formatManager.getNumFormats() && format == nullptr; ++formatIndex)
         {
-            auto* format = formatManager.getFormat(formatIndex);
-            if (format == nullptr)
-                continue;
-            if (!formatMatchesRequested(*format, requestedFormat))
-                continue;
-
-            const auto searchPath = buildAugmentedSearchPathForFormat(*format);
-            if (searchPath.getNumPaths() <= 0)
-                continue;
-
-            ++scannedFormatCount;
-            deadMansPedalFile.deleteFile();
-
-            juce::PluginDirectoryScanner scanner(pluginList,
-                                                 *format,
-                                                 searchPath,
-                                                 true,
-                                                 deadMansPedalFile);
-
-            const double formatStartMs = juce::Time::getMillisecondCounterHiRes();
-            juce::String pluginName;
-            while (true)
-            {
-                const auto beforeEntries = loadDeadMansPedalEntries(deadMansPedalFile);
-                const double fileStartMs = juce::Time::getMillisecondCounterHiRes();
-                const bool hasNext = scanner.scanNextFile(true, pluginName);
-                const double nowMs = juce::Time::getMillisecondCounterHiRes();
-
-                const auto afterEntries = loadDeadMansPedalEntries(deadMansPedalFile);
-                const auto target = getLikelyCurrentScanTarget(pluginName, beforeEntries, afterEntries);
-                const auto fileElapsedMs = static_cast<int>(std::llround(nowMs - fileStartMs));
-                const auto formatElapsedMs = static_cast<int>(std::llround(nowMs - formatStartMs));
-
-                if (fileElapsedMs > scanTimeoutMs)
-                {
-                    const auto timeoutLabel = target + " (timeout after "
-                                            + juce::String(fileElapsedMs) + " ms)";
-                    failedFiles.addIfNotAlreadyThere(timeoutLabel);
-                    blacklistedEntries.addIfNotAlreadyThere(format->getName() + ": " + timeoutLabel);
-                    appendDeadMansPedalEntryIfNeeded(deadMansPedalFile, target);
-                }
-
-                if (formatElapsedMs > scanTimeoutMs)
-                {
-                    const auto timeoutLabel = target + " (format timeout after "
-                                            + juce::String(formatElapsedMs) + " ms)";
-                    failedFiles.addIfNotAlreadyThere(timeoutLabel);
-                    blacklistedEntries.addIfNotAlreadyThere(format->getName() + ": " + timeoutLabel);
-                    appendDeadMansPedalEntryIfNeeded(deadMansPedalFile, target);
-                    break;
-                }
-
-                if (!hasNext)
-                    break;
-            }
-
-            for (const auto& failed : scanner.getFailedFiles())
-                failedFiles.addIfNotAlreadyThere(failed);
-
-            if (deadMansPedalFile.existsAsFile())
-            {
-                juce::StringArray deadmanLines;
-                deadmanLines.addLines(deadMansPedalFile.loadFileAsString());
-                for (auto line : deadmanLines)
-                {
-                    line = line.trim();
-                    if (line.isNotEmpty())
-                        blacklistedEntries.addIfNotAlreadyThere(format->getName() + ": " + line);
-                }
-            }
-
-            juce::PluginDirectoryScanner::applyBlacklistingsFromDeadMansPedal(pluginList, deadMansPedalFile);
-            deadMansPedalFile.deleteFile();
-
-            if (std::unique_ptr<juce::XmlElement> xml(pluginList.createXml()); xml != nullptr)
-                xml->writeTo(knownListFile);
+            auto* candidate = formatManager.getFormat(formatIndex);
+            if (candidate != nullptr && formatMatchesRequested(*candidate, requestedFormat))
+                format = candidate;
         }
 
-        if (requestedFormat.isNotEmpty() && scannedFormatCount == 0)
+        if (format == nullptr)
         {
             std::cout << "ERROR: Requested plugin format not available: "
                       << requestedFormat.toStdString() << "\n";
             return 2;
         }
 
-        if (std::unique_ptr<juce::XmlElement> xml(pluginList.createXml()); xml != nullptr)
-            xml->writeTo(knownListFile);
+        juce::OwnedArray<juce::PluginDescription> found;
+        try
+        {
+            format->findAllTypesForFile(found, target);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "ERROR: Plugin scan exception: " << e.what() << "\n";
+            return 2;
+        }
+        catch (...)
+        {
+            std::cout << "ERROR: Plugin scan threw an unknown exception.\n";
+            return 2;
+        }
+
+        if (found.isEmpty())
+        {
+            std::cout << "ERROR: No loadable plugin found.\n";
+            return 2;
+        }
 
-        for (const auto& failed : failedFiles)
-            std::cout << "FAILED: " << failed << "\n";
-        for (const auto& blacklisted : blacklistedEntries)
-            std::cout << "BLACKLISTED: " << blacklisted << "\n";
+        juce::XmlElement result("PLUGINS");
+        for (auto* description : found)
+            if (description != nullptr)
+                result.addChildElement(description->createXml().release());
 
-        std::cout << "OK: Plugin scan pass complete.\n";
+        if (!result.writeTo(juce::File(outputPath)))
+        {
+            std::cout << "ERROR: Unable to write plugin scan result.\n";
+            return 2;
+        }
+
+        std::cout << "OK: " << found.size() << " plugin(s) found.\n" << std::flush;
         return 0;
     }
 }
@@ -716,12 +547,18 @@ int main(int argc, char* argv[])
         return false;
     };
 
-    if (hasArg("--plugin-scan-pass"))
-        return runPluginScanPassMode(args);
+    if (hasArg("--plugin-scan-file"))
+        return runPluginScanFileMode(args);
 
     if (hasArg("--plugin-probe"))
         return runPluginProbeMode(args);
 
+    if (hasArg("--plugin-bridge-host"))
+        return runPluginBridgeHostMode(args);
+
+    if (hasArg("--render"))
+        return sampledex::runHeadlessRender(args);
+
     juce::JUCEApplicationBase::createInstance = &juce_CreateApplication;
     return juce::JUCEApplicationBase::main(argc, (const char**) argv);
 }
@@ -3,6 +3,7 @@
 #include "NormalizeDialog.h"
 #include "ProjectSerializer.h"  
 #include "PianoRollComponent.h" 
+#include "RealtimeSafetyMonitor.h"
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
@@ -46,6 +47,7 @@ namespace
     constexpr int menuIdViewScanPlugins = 20102;
     constexpr int menuIdViewProjectSettings = 20103;
     constexpr int menuIdViewAutoScanPlugins = 20104;
+    constexpr int menuIdViewRescanAllPlugins = 20105;
 
     const juce::StringArray keyNames { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
     const juce::StringArray scaleNames { "Major", "Minor", "Dorian", "Mixolydian", "Pentatonic" };
@@ -84,147 +86,68 @@ namespace
             || lower.contains("plugin crashed");
     }
 
-    static bool formatNameLooksLikeAudioUnit(const juce::String& formatName)
-    {
-        return formatName.containsIgnoreCase("AudioUnit")
-            || formatName.containsIgnoreCase("AU");
-    }
-
-    static bool formatNameLooksLikeVST3(const juce::String& formatName)
+    // Runs one plugin in a throwaway --plugin-probe child. Safe to call from a worker thread.
+    static bool runPluginProbeProcess(const juce::File& executable,
+                                      const juce::PluginDescription& desc,
+                                      bool instrumentPlugin,
+                                      double sr,
+                                      int bs,
+                                      juce::String& errorMessage)
     {
-        return formatName.containsIgnoreCase("VST3");
-    }
-
-    static constexpr int clipResamplerPhases = 128;
-    static constexpr int clipResamplerTaps = 32;
-
-    using PolyphaseCoefficients = std::array<std::array<float, clipResamplerTaps>, clipResamplerPhases>;
+        const juce::String command = executable.getFullPathName().quoted()
+                                   + " --plugin-probe"
+                                   + " --format=" + desc.pluginFormatName.quoted()
+                                   + " --id=" + desc.fileOrIdentifier.quoted()
+                                   + " --name=" + desc.name.quoted()
+                                   + " --mfr=" + desc.manufacturerName.quoted()
+                                   + " --uid2=" + juce::String::toHexString(desc.uniqueId)
+                                   + " --uid=" + juce::String::toHexString(desc.deprecatedUid)
+                                   + " --instrument=" + juce::String(instrumentPlugin ? 1 : 0)
+                                   + " --sr=" + juce::String(sr, 5)
+                                   + " --bs=" + juce::String(bs);
 
-    static const PolyphaseCoefficients& getClipResamplerCoefficients()
-    {
-        static const PolyphaseCoefficients coeffs = []
+        juce::ChildProcess probe;
+        if (!probe.start(command))
         {
-            PolyphaseCoefficients table {};
-            constexpr int halfTaps = clipResamplerTaps / 2;
-            constexpr double cutoff = 0.965;
-            constexpr double pi = juce::MathConstants<double>::pi;
-
-            for (int phase = 0; phase < clipResamplerPhases; ++phase)
-            {
-                const double frac = static_cast<double>(phase) / static_cast<double>(clipResamplerPhases);
-                double norm = 0.0;
-                for (int tap = 0; tap < clipResamplerTaps; ++tap)
-                {
-                    const double x = static_cast<double>(tap - halfTaps + 1) - frac;
-                    const double sincArg = x * cutoff;
-                    const double sinc = std::abs(sincArg) < 1.0e-8
-                        ? 1.0
-                        : std::sin(pi * sincArg) / (pi * sincArg);
-                    const double window = 0.54 - (0.46 * std::cos((2.0 * pi * static_cast<double>(tap))
-                                                                   / static_cast<double>(clipResamplerTaps - 1)));
-                    const double v = cutoff * sinc * window;
-                    table[static_cast<size_t>(phase)][static_cast<size_t>(tap)] = static_cast<float>(v);
-                    norm += v;
-                }
-                const float normInv = static_cast<float>(1.0 / juce::jmax(1.0e-12, norm));
-                for (int tap = 0; tap < clipResamplerTaps; ++tap)
-                    table[static_cast<size_t>(phase)][static_cast<size_t>(tap)] *= normInv;
-            }
-            return table;
-        }();
-
-        return coeffs;
-    }
-
-    static inline float sampleBandlimited(const float* src, int srcLength, double sourcePosition) noexcept
-    {
-        if (src == nullptr || srcLength <= 0)
-            return 0.0f;
+            errorMessage = "Plugin probe failed: unable to launch isolation process.";
+            return false;
+        }
 
-        const auto& coeffs = getClipResamplerCoefficients();
-        constexpr int halfTaps = clipResamplerTaps / 2;
-        const int baseIndex = static_cast<int>(std::floor(sourcePosition));
-        const double frac = sourcePosition - static_cast<double>(baseIndex);
-        const double phasePosition = frac * static_cast<double>(clipResamplerPhases - 1);
-        const int phaseA = juce::jlimit(0,
-                                        clipResamplerPhases - 1,
-                                        static_cast<int>(std::floor(phasePosition)));
-        const int phaseB = juce::jlimit(0, clipResamplerPhases - 1, phaseA + 1);
-        const float phaseMix = static_cast<float>(phasePosition - static_cast<double>(phaseA));
-        const int start = baseIndex - halfTaps + 1;
-        float out = 0.0f;
-        for (int tap = 0; tap < clipResamplerTaps; ++tap)
+        if (!probe.waitForProcessToFinish(12000))
         {
-            const int srcIndex = juce::jlimit(0, srcLength - 1, start + tap);
-            const float coeffA = coeffs[static_cast<size_t>(phaseA)][static_cast<size_t>(tap)];
-            const float coeffB = coeffs[static_cast<size_t>(phaseB)][static_cast<size_t>(tap)];
-            const float coeff = coeffA + ((coeffB - coeffA) * phaseMix);
-            out += src[srcIndex] * coeff;
+            probe.kill();
+            errorMessage = "Plugin probe timed out.";
+            return false;
         }
-        return out;
-    }
-
 
+        const auto exitCode = probe.getExitCode();
+        const juce::String output = probe.readAllProcessOutput().trim();
+        if (exitCode != 0)
+        {
+            errorMessage = "Plugin isolation probe failed."
+                         + (output.isNotEmpty() ? ("\n" + output) : juce::String());
+            return false;
+        }
 
-    enum class ClipStretchQuality
-    {
-        Fast = 0,
-        High = 1
-    };
-
-    static inline float sampleLinear(const float* src, int srcLength, double sourcePosition) noexcept
-    {
-        if (src == nullptr || srcLength <= 0)
-            return 0.0f;
+        if (!output.startsWithIgnoreCase("OK"))
+        {
+            errorMessage = "Plugin isolation probe returned an unexpected result."
+                         + (output.isNotEmpty() ? ("\n" + output) : juce::String());
+            return false;
+        }
 
-        const double clamped = juce::jlimit(0.0, static_cast<double>(srcLength - 1), sourcePosition);
-        const int idxA = juce::jlimit(0, srcLength - 1, static_cast<int>(std::floor(clamped)));
-        const int idxB = juce::jlimit(0, srcLength - 1, idxA + 1);
-        const float frac = static_cast<float>(clamped - static_cast<double>(idxA));
-        return src[idxA] + ((src[idxB] - src[idxA]) * frac);
+        return true;
     }
 
-    static inline float sampleForStretchQuality(const float* src,
-                                                int srcLength,
-                                                double sourcePosition,
-                                                ClipStretchQuality quality) noexcept
+    static bool formatNameLooksLikeAudioUnit(const juce::String& formatName)
     {
-        return quality == ClipStretchQuality::High
-            ? sampleBandlimited(src, srcLength, sourcePosition)
-            : sampleLinear(src, srcLength, sourcePosition);
+        return formatName.containsIgnoreCase("AudioUnit")
+            || formatName.containsIgnoreCase("AU");
     }
 
-    static double mapClipBeatToSourceBeat(const Clip& clip, double clipBeat) noexcept
+    static bool formatNameLooksLikeVST3(const juce::String& formatName)
     {
-        const double localBeat = juce::jmax(0.0, clipBeat);
-        if (clip.stretchMode != ClipStretchMode::BeatWarp || clip.warpMarkers.empty())
-            return localBeat;
-
-        const auto& markers = clip.warpMarkers;
-        if (markers.size() == 1)
-            return juce::jmax(0.0, markers.front().sourceBeat + (localBeat - markers.front().clipBeat));
-
-        if (localBeat <= markers.front().clipBeat)
-            return juce::jmax(0.0, markers.front().sourceBeat + (localBeat - markers.front().clipBeat));
-
-        for (size_t i = 0; i + 1 < markers.size(); ++i)
-        {
-            const auto& a = markers[i];
-            const auto& b = markers[i + 1];
-            if (localBeat <= b.clipBeat)
-            {
-                const double clipSpan = juce::jmax(1.0e-6, b.clipBeat - a.clipBeat);
-                const double sourceSpan = b.sourceBeat - a.sourceBeat;
-                const double t = juce::jlimit(0.0, 1.0, (localBeat - a.clipBeat) / clipSpan);
-                return juce::jmax(0.0, a.sourceBeat + (sourceSpan * t));
-            }
-        }
-
-        const auto& tailA = markers[markers.size() - 2];
-        const auto& tailB = markers.back();
-        const double clipSpan = juce::jmax(1.0e-6, tailB.clipBeat - tailA.clipBeat);
-        const double slope = (tailB.sourceBeat - tailA.sourceBeat) / clipSpan;
-        return juce::jmax(0.0, tailB.sourceBeat + ((localBeat - tailB.clipBeat) * slope));
+        return formatName.containsIgnoreCase("VST3");
     }
 
     static std::vector<WarpMarker> detectTransientWarpMarkers(juce::AudioFormatReader& reader,
@@ -293,69 +216,6 @@ namespace
         markers.erase(std::unique(markers.begin(), markers.end(), [](const WarpMarker& a, const WarpMarker& b){ return std::abs(a.clipBeat - b.clipBeat) < 1.0e-4; }), markers.end());
         return markers;
     }
-    static inline float applyMicroFadeWindow(double beatInClip,
-                                             double clipLengthBeats,
-                                             double beatsPerSample,
-                                             float inSample) noexcept
-    {
-        constexpr int microFadeSamples = 48;
-        const double microFadeBeats = static_cast<double>(microFadeSamples) * beatsPerSample;
-        if (microFadeBeats <= 0.0)
-            return inSample;
-
-        float fade = 1.0f;
-        if (beatInClip < microFadeBeats)
-            fade = juce::jmin(fade, static_cast<float>(juce::jlimit(0.0, 1.0, beatInClip / microFadeBeats)));
-
-        const double beatsToEnd = juce::jmax(0.0, clipLengthBeats - beatInClip);
-        if (beatsToEnd < microFadeBeats)
-            fade = juce::jmin(fade, static_cast<float>(juce::jlimit(0.0, 1.0, beatsToEnd / microFadeBeats)));
-
-        return inSample * fade;
-    }
-
-    static inline float applyEqualPowerFade(float linearFade) noexcept
-    {
-        const float clamped = juce::jlimit(0.0f, 1.0f, linearFade);
-        return std::sin(clamped * static_cast<float>(juce::MathConstants<double>::halfPi));
-    }
-
-    static inline std::uint32_t nextDitherState(std::uint32_t& state) noexcept
-    {
-        state = (state * 1664525u) + 1013904223u;
-        return state;
-    }
-
-    static void applyTpdfDither(juce::AudioBuffer<float>& buffer,
-                                int startSample,
-                                int numSamples,
-                                int bitDepth,
-                                std::uint32_t& rngState)
-    {
-        if (bitDepth <= 0 || bitDepth >= 24)
-            return;
-
-        const float scale = static_cast<float>(1u << juce::jmax(1, bitDepth - 1));
-        const float invScale = 1.0f / scale;
-        const float lsb = invScale;
-        constexpr float invUint = 1.0f / 4294967295.0f;
-        const int channels = buffer.getNumChannels();
-
-        for (int ch = 0; ch < channels; ++ch)
-        {
-            auto* write = buffer.getWritePointer(ch, startSample);
-            if (write == nullptr)
-                continue;
-            for (int i = 0; i < numSamples; ++i)
-            {
-                const float r1 = static_cast<float>(nextDitherState(rngState)) * invUint;
-                const float r2 = static_cast<float>(nextDitherState(rngState)) * invUint;
-                const float dither = (r1 - r2) * lsb;
-                const float withDither = juce::jlimit(-1.0f, 1.0f, write[i] + dither);
-                write[i] = std::round(withDither * scale) * invScale;
-            }
-        }
-    }
 
     static juce::String scanFormatDisplayName(const juce::String& formatName)
     {
@@ -562,28 +422,6 @@ namespace
         return false;
     }
 
-    static void sanitizeAudioBuffer(juce::AudioBuffer<float>& buffer, int numSamples)
-    {
-        const int samples = juce::jmin(numSamples, buffer.getNumSamples());
-        if (samples <= 0)
-            return;
-
-        constexpr float clampAbs = 6.0f;
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-        {
-            auto* write = buffer.getWritePointer(ch);
-            if (write == nullptr)
-                continue;
-            for (int i = 0; i < samples; ++i)
-            {
-                float s = write[i];
-                if (!std::isfinite(s))
-                    s = 0.0f;
-                write[i] = juce::jlimit(-clampAbs, clampAbs, s);
-            }
-        }
-    }
-
     class AudioCallbackPerfScope final
     {
     public:
@@ -2209,6 +2047,7 @@ namespace
     {
     public:
         std::function<void()> onCalibrateInput;
+        std::function<void()> onMeasureLatency;
         std::function<void()> onResetHolds;
         std::function<void(bool)> onMonitorSafeChanged;
         std::function<void(int)> onCountInBarsChanged;
@@ -2394,6 +2233,15 @@ namespace
             };
             addAndMakeVisible(postRollBox);
 
+            measureLatencyButton.setButtonText("Measure Latency");
+            measureLatencyButton.setTooltip("Connect an output to an input, then play a test signal to measure the real round trip for this device.");
+            measureLatencyButton.onClick = [this]
+            {
+                if (onMeasureLatency)
+                    onMeasureLatency();
+            };
+            addAndMakeVisible(measureLatencyButton);
+
             offsetLabel.setText("Offset", juce::dontSendNotification);
             offsetLabel.setJustificationType(juce::Justification::centredLeft);
             offsetLabel.setColour(juce::Label::textColourId, juce::Colours::white.withAlpha(0.78f));
@@ -2511,6 +2359,7 @@ namespace
             r.removeFromTop(2);
             auto offsetRow = r.removeFromTop(24);
             offsetLabel.setBounds(offsetRow.removeFromLeft(56));
+            measureLatencyButton.setBounds(offsetRow.removeFromRight(130).reduced(2, 0));
             offsetSlider.setBounds(offsetRow.reduced(2, 0));
             latencyLabel.setBounds(r.removeFromTop(24));
         }
@@ -2674,6 +2523,7 @@ namespace
         juce::ComboBox postRollBox;
         juce::Label offsetLabel;
         juce::Slider offsetSlider;
+        juce::TextButton measureLatencyButton;
         juce::Label latencyLabel;
         juce::Rectangle<int> rowsBounds;
     };
@@ -2961,7 +2811,6 @@ namespace sampledex
         appDataDir.createDirectory();
         knownPluginListFile = appDataDir.getChildFile("known_plugins.xml");
         startupSettingsFile = appDataDir.getChildFile("startup_settings.txt");
-        pluginScanDeadMansPedalFile = appDataDir.getChildFile("plugin_scan_dead_mans_pedal.txt");
         pluginSessionGuardFile = appDataDir.getChildFile("plugin_session_guard.json");
         quarantinedPluginsFile = appDataDir.getChildFile("plugin_quarantine.txt");
         pluginStabilityFile = appDataDir.getChildFile("plugin_stability.json");
@@ -2977,6 +2826,14 @@ namespace sampledex
             std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(knownPluginListFile));
             if (xml) knownPluginList.recreateFromXml(*xml);
         }
+        pluginScanner = std::make_unique<PluginScanner>(formatManager,
+                                                        knownPluginList,
+                                                        appDataDir.getChildFile("plugin_scan_db.xml"));
+        pluginScanner->onPluginScanned = [this](const PluginScanDatabase::Entry& entry, bool previouslyFailed)
+        {
+            handlePluginScanResult(entry, previouslyFailed);
+        };
+        pluginScanner->onFinished = [this] { finishPluginScan(true, {}); };
         loadQuarantinedPlugins();
         loadPluginStabilityStats();
         handleUncleanPluginSessionRecovery();
@@ -2993,6 +2850,11 @@ namespace sampledex
         refreshControlSurfaceInputSelector();
         externalMidiClockSyncEnabledRt.store(externalMidiClockSyncEnabled, std::memory_order_relaxed);
         backgroundRenderingEnabledRt.store(backgroundRenderingEnabled, std::memory_order_relaxed);
+        trackSleepEnabledRt.store(trackSleepEnabled, std::memory_order_relaxed);
+        renderJobQueue.setRunsOnMessageThread(!backgroundRenderingEnabled);
+        renderJobQueue.setWorkerCount(renderJobWorkers);
+        renderJobQueue.onIdle = [this](const RenderJobQueue::Stats& stats) { finishTrackRenderBatch(stats); };
+        trackRenderCache.setDirectory(appDataDir.getChildFile("RenderCache"));
         lowLatencyMode = safeModeStartup;
         lowLatencyModeRt.store(lowLatencyMode, std::memory_order_relaxed);
         const unsigned int hardwareThreads = std::thread::hardware_concurrency();
@@ -3002,10 +2864,7 @@ namespace sampledex
         realtimeGraphScheduler.setWorkerCount(safeModeStartup ? 0 : juce::jlimit(0, 6, suggestedWorkers));
 
         // 4. Aux FX
-        reverbParams.roomSize = 0.6f;
-        reverbParams.damping = 0.5f;
-        reverbParams.wetLevel = 1.0f; 
-        reverbParams.dryLevel = 0.0f;
+        reverbParams = RenderProjectBuilder::getDefaultAuxReverbParameters();
         for (auto& auxReverb : auxReverbs)
             auxReverb.setParameters(reverbParams);
 
@@ -3435,7 +3294,11 @@ namespace sampledex
             menu.addItem(1, hasFrozenTrack ? "Update Freeze Render" : "Freeze Track");
             menu.addItem(2, "Unfreeze Track", hasFrozenTrack);
             menu.addItem(3, "Commit Track To Audio");
+            menu.addItem(5, "Freeze All Tracks");
             menu.addItem(4, "Cancel Active Render", backgroundRenderBusyRt.load(std::memory_order_relaxed));
+            menu.addSeparator();
+            menu.addItem(6, "Smart Freeze Idle Tracks", true, smartFreezeEnabled);
+            menu.addItem(7, "Sleep Silent Tracks", true, trackSleepEnabled);
             menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&freezeButton),
                                [this](int selectedId)
                                {
@@ -3450,6 +3313,12 @@ namespace sampledex
                                        commitTrackToAudio(selectedTrackIndex);
                                    else if (selectedId == 4)
                                        cancelActiveRenderTask();
+                                   else if (selectedId == 5)
+                                       freezeAllTracksToAudio();
+                                   else if (selectedId == 6)
+                                       setSmartFreezeEnabled(!smartFreezeEnabled);
+                                   else if (selectedId == 7)
+                                       setTrackSleepEnabled(!trackSleepEnabled);
                                });
         };
         freezeButton.setTooltip("Freeze/unfreeze/commit selected track.");
@@ -3484,9 +3353,10 @@ namespace sampledex
         {
             backgroundRenderingEnabled = backgroundRenderToggle.getToggleState();
             backgroundRenderingEnabledRt.store(backgroundRenderingEnabled, std::memory_order_relaxed);
+            renderJobQueue.setRunsOnMessageThread(!backgroundRenderingEnabled);
             refreshStatusText();
         };
-        backgroundRenderToggle.setTooltip("Run freeze/commit renders in a background worker.");
+        backgroundRenderToggle.setTooltip("Run freeze/commit renders on background render workers.");
         addAndMakeVisible(backgroundRenderToggle);
 
         addAndMakeVisible(rackButton);
@@ -4180,6 +4050,10 @@ namespace sampledex
         {
             calibrateInputMonitoring();
         };
+        recordingContent->onMeasureLatency = [this]
+        {
+            startLatencyCalibration();
+        };
         recordingContent->onResetHolds = [this]
         {
             clearInputPeakHolds();
@@ -4440,7 +4314,7 @@ namespace sampledex
                 slotState.slotIndex = slot;
                 slotState.bypassed = track->isPluginSlotBypassed(slot);
                 slotState.hostingPolicy = static_cast<int>(track->getPluginHostingPolicyForSlot(slot));
-                slotState.encodedState = track->getPluginStateForSlot(slot);
+                slotState.state = track->getPluginStateBlobForSlot(slot);
                 slotState.hasDescription = track->getPluginDescriptionForSlot(slot, slotState.description);
                 state.pluginSlots.push_back(std::move(slotState));
             }
@@ -4448,6 +4322,7 @@ namespace sampledex
             project.tracks.push_back(std::move(state));
         }
         project.automationLanes = automationLanes;
+        automationWriteRecorder.applyStagedTo(project.automationLanes, automationThinningTolerance);
 
         return project;
     }
@@ -4782,35 +4657,6 @@ namespace sampledex
         refreshStatusText();
     }
 
-    float MainComponent::evaluateAutomationLaneValueAtBeat(const AutomationLane& lane, double beat) const
-    {
-        if (lane.points.empty())
-            return 0.0f;
-
-        if (beat <= lane.points.front().beat)
-            return lane.points.front().value;
-        if (beat >= lane.points.back().beat)
-            return lane.points.back().value;
-
-        const auto it = std::lower_bound(lane.points.begin(),
-                                         lane.points.end(),
-                                         beat,
-                                         [](const AutomationPoint& point, double b)
-                                         {
-                                             return point.beat < b;
-                                         });
-        if (it == lane.points.begin())
-            return it->value;
-        if (it == lane.points.end())
-            return lane.points.back().value;
-
-        const auto& right = *it;
-        const auto& left = *(it - 1);
-        const double span = juce::jmax(1.0e-9, right.beat - left.beat);
-        const double alpha = juce::jlimit(0.0, 1.0, (beat - left.beat) / span);
-        return left.value + static_cast<float>((right.value - left.value) * alpha);
-    }
-
     void MainComponent::enqueueAutomationWriteEvent(int laneId, double beat, float value)
     {
         const int read = automationWriteReadIndex.load(std::memory_order_acquire);
@@ -4828,63 +4674,41 @@ namespace sampledex
 
     void MainComponent::drainAutomationWriteEvents()
     {
-        bool updated = false;
+        const double nowMs = juce::Time::getMillisecondCounterHiRes();
         int read = automationWriteReadIndex.load(std::memory_order_relaxed);
         const int write = automationWriteWriteIndex.load(std::memory_order_acquire);
         while (read != write)
         {
             const auto& event = automationWriteQueue[static_cast<size_t>(read)];
             read = (read + 1) % automationWriteQueueCapacity;
+            automationWriteRecorder.append(event.laneId, event.beat, event.value, nowMs);
+        }
+        automationWriteReadIndex.store(read, std::memory_order_release);
+
+        if (!automationWriteRecorder.hasStagedPoints())
+            return;
 
+        // Written points stay staged until their pass ends, so a pass costs one merge and
+        // one snapshot rebuild instead of one per control-rate point.
+        bool updated = false;
+        for (const int laneId : automationWriteRecorder.getFinishedLaneIds(nowMs, !transport.playing()))
+        {
             auto laneIt = std::find_if(automationLanes.begin(),
                                        automationLanes.end(),
-                                       [&event](const AutomationLane& lane)
+                                       [laneId](const AutomationLane& lane)
                                        {
-                                           return lane.laneId == event.laneId;
+                                           return lane.laneId == laneId;
                                        });
             if (laneIt == automationLanes.end())
-                continue;
-
-            auto& points = laneIt->points;
-            const AutomationPoint point { juce::jmax(0.0, event.beat), event.value };
-            if (points.empty())
-            {
-                points.push_back(point);
-                updated = true;
-                continue;
-            }
-
-            constexpr double minBeatDelta = 1.0 / 128.0;
-            if (point.beat >= points.back().beat)
             {
-                if (std::abs(point.beat - points.back().beat) <= minBeatDelta)
-                    points.back() = point;
-                else
-                    points.push_back(point);
-                updated = true;
+                automationWriteRecorder.discard(laneId);
                 continue;
             }
 
-            const auto insertPos = std::lower_bound(points.begin(),
-                                                    points.end(),
-                                                    point.beat,
-                                                    [](const AutomationPoint& lhs, double b)
-                                                    {
-                                                        return lhs.beat < b;
-                                                    });
-            if (insertPos != points.end() && std::abs(insertPos->beat - point.beat) <= minBeatDelta)
-            {
-                *insertPos = point;
-                updated = true;
-            }
-            else
-            {
-                points.insert(insertPos, point);
+            if (automationWriteRecorder.commit(laneId, *laneIt, automationThinningTolerance))
                 updated = true;
-            }
         }
 
-        automationWriteReadIndex.store(read, std::memory_order_release);
         if (updated)
             rebuildRealtimeSnapshot();
     }
@@ -4898,17 +4722,43 @@ namespace sampledex
     }
 
     void MainComponent::applyAutomationForBlock(const RealtimeStateSnapshot& snapshot,
-                                                double beat,
+                                                const TempoBlockSpan& blockSpan,
                                                 bool isPlaying)
     {
-        if (!isPlaying || snapshot.automationLanes.empty())
+        for (auto* track : snapshot.trackPointers)
+            if (track != nullptr)
+                track->clearBlockAutomationRamps();
+        masterAutomationRamp.clear();
+
+        if (!isPlaying || snapshot.automationLanes.empty() || blockSpan.getNumSamples() <= 0)
             return;
 
-        for (const auto& lane : snapshot.automationLanes)
+        const double beat = blockSpan.beatAtSample(0.0);
+        // Ramps break at the lane's points, at tempo changes and where a block wraps at the
+        // loop end. Returns the value the lane reaches at the end of the block.
+        const auto buildRamp = [&](const AutomationLane& lane,
+                                   AutomationLaneCursor& cursor,
+                                   AutomationBlockRamp& ramp,
+                                   float minValue,
+                                   float maxValue)
+        {
+            ramp.reset(minValue, maxValue);
+            blockSpan.forEachConstantTempoRun([&](double runStartBeat, double beatsPerSample, int sampleOffset, int runSamples)
+            {
+                ramp.append(lane.points, cursor, runStartBeat, beatsPerSample, sampleOffset, runSamples);
+            });
+            return ramp.getEndValue();
+        };
+
+        AutomationLaneCursor overflowCursor;
+        for (size_t laneIndex = 0; laneIndex < snapshot.automationLanes.size(); ++laneIndex)
         {
+            const auto& lane = snapshot.automationLanes[laneIndex];
             if (!lane.enabled)
                 continue;
 
+            auto& cursor = laneIndex < automationLaneCursors.size() ? automationLaneCursors[laneIndex] : overflowCursor;
+
             bool shouldRead = false;
             bool shouldWrite = false;
             float currentValue = 0.0f;
@@ -4947,7 +4797,7 @@ namespace sampledex
 
                 if (shouldRead && !lane.points.empty())
                 {
-                    const float automatedValue = juce::jlimit(0.0f, 1.4f, evaluateAutomationLaneValueAtBeat(lane, beat));
+                    const float automatedValue = buildRamp(lane, cursor, masterAutomationRamp, 0.0f, 1.4f);
                     masterOutputGainRt.store(automatedValue, std::memory_order_relaxed);
                 }
                 else if (shouldWrite && lane.laneId > 0)
@@ -5006,19 +4856,19 @@ namespace sampledex
 
             if (shouldRead && !lane.points.empty())
             {
-                const float automatedValue = evaluateAutomationLaneValueAtBeat(lane, beat);
+                auto& ramp = track->getBlockAutomationRamp(lane.target);
                 switch (lane.target)
                 {
                     case AutomationTarget::TrackPan:
-                        track->setPan(juce::jlimit(-1.0f, 1.0f, automatedValue));
+                        track->setPan(buildRamp(lane, cursor, ramp, -1.0f, 1.0f));
                         break;
                     case AutomationTarget::TrackSend:
-                        track->setSendLevel(juce::jlimit(0.0f, 1.0f, automatedValue));
+                        track->setSendLevel(buildRamp(lane, cursor, ramp, 0.0f, 1.0f));
                         break;
                     case AutomationTarget::MasterOutput:
                     case AutomationTarget::TrackVolume:
                     default:
-                        track->setVolume(juce::jlimit(0.0f, 1.2f, automatedValue));
+                        track->setVolume(buildRamp(lane, cursor, ramp, 0.0f, 1.2f));
                         break;
                 }
             }
@@ -5376,9 +5226,8 @@ namespace sampledex
         saveToolbarLayoutSettings();
         saveMidiLearnMappings();
         writePluginSessionGuard(true);
-        if (pluginScanProcess != nullptr && pluginScanProcess->isRunning())
-            pluginScanProcess->kill();
-        pluginScanProcess.reset();
+        if (pluginScanner != nullptr)
+            pluginScanner->cancel();
         closePluginEditorWindow();
         closeEqWindow();
         closeChannelRackWindow();
@@ -6111,20 +5960,23 @@ namespace sampledex
         for (auto& buffer : inputTapBuffers)
             buffer.setSize(juce::jmax(2, activeInputChannels), reserveSamples);
         
+        const int trackMidiCapacityBytes = Track::getMidiArenaCapacityBytesForBlock(samplesPerBlockExpected);
         for (auto& b : trackMidiBuffers)
-            b.ensureSize(4096);
+            b.ensureSize(static_cast<size_t>(trackMidiCapacityBytes));
         for (auto& b : previewMidiBuffers)
             b.ensureSize(128);
         
         liveMidiBuffer.ensureSize(2048);
         chordEngineOutputBuffer.ensureSize(2048);
-        masterGainSmoothingState = masterOutputGainRt.load(std::memory_order_relaxed);
-        outputDcPrevInput = { 0.0f, 0.0f };
-        outputDcPrevOutput = { 0.0f, 0.0f };
-        masterLimiterPrevInput = { 0.0f, 0.0f };
-        masterTruePeakMidpointPrevInput = { 0.0f, 0.0f };
+        masterLimiter.prepare(resolvedSampleRate, reserveSamples);
+        masterLimiter.setCurrentGain(masterOutputGainRt.load(std::memory_order_relaxed));
+        masterLimiterLatencySamplesRt.store(masterLimiter.getLatencySamples(true), std::memory_order_relaxed);
+        masterAutomationValues.setSize(1, reserveSamples);
+        masterAutomationRamp.clear();
+        externalClockTempoMap.setConstantTempo(bpmRt.load(std::memory_order_relaxed));
+        for (auto& cursor : automationLaneCursors)
+            cursor.reset();
         outputBoundaryPrevSample = { 0.0f, 0.0f };
-        masterLimiterGainState = 1.0f;
         inputTapUnderrunCountRt.store(0, std::memory_order_relaxed);
         previewMidiLockMissCountRt.store(0, std::memory_order_relaxed);
         startupSafetyRampEventsRt.store(0, std::memory_order_relaxed);
@@ -6149,6 +6001,12 @@ namespace sampledex
         ensureTrackPdcCapacity(maxGraphLatency + reserveSamples + 128);
         resetTrackPdcState();
         rebuildRealtimeSnapshot();
+
+        if (RealtimeSafetyMonitor::isCompiledIn())
+        {
+            RealtimeSafetyMonitor::setAbortOnViolation(juce::SystemStats::getEnvironmentVariable("SAMPLEDEX_RT_SAFETY_ABORT", "0") == "1");
+            RealtimeSafetyMonitor::setEnabled(true);
+        }
     }
 
     // --- THE REAL-TIME AUDIO ENGINE ---
@@ -6161,6 +6019,7 @@ namespace sampledex
             return;
 
         juce::ScopedNoDenormals noDenormals;
+        RealtimeSafetyMonitor::ScopedRealtimeContext realtimeSafetyScope;
 
         AudioCallbackPerfScope callbackPerf(sampleRateRt,
                                             bufferToFill.numSamples,
@@ -6197,12 +6056,8 @@ namespace sampledex
                 startupOutputRampSamplesRemainingRt.store(releaseRampSamples, std::memory_order_relaxed);
                 startupSafetyRampLoggedRt.store(false, std::memory_order_relaxed);
             }
-            outputDcPrevInput = { 0.0f, 0.0f };
-            outputDcPrevOutput = { 0.0f, 0.0f };
-            masterLimiterPrevInput = { 0.0f, 0.0f };
-            masterTruePeakMidpointPrevInput = { 0.0f, 0.0f };
+            masterLimiter.reset();
             outputBoundaryPrevSample = { 0.0f, 0.0f };
-            masterLimiterGainState = 1.0f;
             masterPeakMeterRt.store(masterPeakMeterRt.load(std::memory_order_relaxed) * 0.86f, std::memory_order_relaxed);
             masterRmsMeterRt.store(masterRmsMeterRt.load(std::memory_order_relaxed) * 0.82f, std::memory_order_relaxed);
             return;
@@ -6266,6 +6121,15 @@ namespace sampledex
         }
 
         bufferToFill.clearActiveBufferRegion();
+
+        // A latency measurement owns the output while it runs; the session stays silent.
+        if (latencyCalibrator.processBlock(liveInputCaptureBuffer,
+                                           capturedInputChannels,
+                                           *bufferToFill.buffer,
+                                           bufferToFill.startSample,
+                                           bufferToFill.numSamples))
+            return;
+
         const auto snapshot = getRealtimeSnapshot();
         if (!snapshot || snapshot->trackPointers.empty())
             return;
@@ -6312,19 +6176,8 @@ namespace sampledex
         for (int bus = 0; bus < auxBusCount; ++bus)
             auxBusLatencySamples[static_cast<size_t>(bus)] = getAuxBusProcessingLatencySamples(bus);
 
-        const auto resolveTempoAtBeat = [](double beat, const std::vector<MainComponent::TempoEvent>& map, double fallbackBpm)
-        {
-            double resolved = fallbackBpm;
-            for (const auto& event : map)
-            {
-                if (event.beat > beat + 1.0e-9)
-                    break;
-                resolved = juce::jmax(1.0, event.bpm);
-            }
-            return juce::jmax(1.0, resolved);
-        };
-
         double blockTempoBpm = 120.0;
+        const TempoMapIndex* blockTempoMap = &snapshot->tempoMap;
 
         if (externalMidiClockSyncEnabledRt.load(std::memory_order_relaxed)
             && externalMidiClockActiveRt.load(std::memory_order_relaxed))
@@ -6348,31 +6201,46 @@ namespace sampledex
                 transport.setPositionBeatsRt(externalBeat);
                 lastAppliedExternalClockGeneration = generation;
             }
+
+            externalClockTempoMap.setConstantTempo(blockTempoBpm);
+            blockTempoMap = &externalClockTempoMap;
         }
         else
         {
             externalMidiClockWasRunning = false;
             lastAppliedExternalClockGeneration = -1;
-            const double preAdvanceBeat = transport.getCurrentBeat();
-            blockTempoBpm = resolveTempoAtBeat(preAdvanceBeat,
-                                               snapshot->tempoEvents,
-                                               bpmRt.load(std::memory_order_relaxed));
+            if (blockTempoMap->isEmpty())
+            {
+                externalClockTempoMap.setConstantTempo(bpmRt.load(std::memory_order_relaxed));
+                blockTempoMap = &externalClockTempoMap;
+            }
+            blockTempoBpm = blockTempoMap->getTempoAtBeat(transport.getCurrentBeat());
         }
 
         bpmRt.store(blockTempoBpm, std::memory_order_relaxed);
 
         // 1. Advance transport and capture exact block range (single transport lock path).
-        const auto blockRange = transport.advanceWithTempo(bufferToFill.numSamples, blockTempoBpm);
+        const auto blockRange = transport.advanceWithTempoMap(bufferToFill.numSamples, *blockTempoMap);
         const double startBeat = blockRange.startBeat;
         const double endBeat = blockRange.endBeat;
         const bool isPlaying = transport.playing();
         const bool chaseNotesThisBlock = isPlaying && !wasTransportPlayingLastBlock;
         const bool transportStopThisBlock = !isPlaying && wasTransportPlayingLastBlock;
-        applyAutomationForBlock(*snapshot, startBeat, isPlaying);
 
         const bool wrappedLoopBlock = blockRange.wrapped && transport.isLooping();
         const double loopStartBeat = transport.getLoopStartBeat();
         const double loopEndBeat = transport.getLoopEndBeat();
+        // Beat <-> sample placement inside this block, split at tempo changes and the loop wrap.
+        const double blockSampleRate = sampleRateRt.load(std::memory_order_relaxed);
+        TempoBlockSpan blockSpan;
+        blockSpan.set(*blockTempoMap,
+                      blockSampleRate > 0.0 ? blockSampleRate : 44100.0,
+                      isPlaying ? bufferToFill.numSamples : 0,
+                      startBeat,
+                      wrappedLoopBlock,
+                      loopStartBeat,
+                      loopEndBeat);
+        applyAutomationForBlock(*snapshot, blockSpan, isPlaying);
         const auto blockCoversBeat = [&](double beat)
         {
             return beatFallsInRange(beat,
@@ -6390,11 +6258,9 @@ namespace sampledex
             const double pendingBeat = recordStartPendingBeatRt.load(std::memory_order_relaxed);
             if (blockCoversBeat(pendingBeat))
             {
-                const double beatsPerSample = juce::jmax(1.0e-12, transport.getBeatsPerSample());
-                const double beatDelta = juce::jmax(0.0, pendingBeat - startBeat);
                 const int offsetSamples = juce::jlimit(0,
                                                        juce::jmax(0, bufferToFill.numSamples - 1),
-                                                       static_cast<int>(std::llround(beatDelta / beatsPerSample)));
+                                                       static_cast<int>(std::llround(blockSpan.sampleOffsetForBeat(pendingBeat))));
                 const int64_t startSample = blockRange.startSample + static_cast<int64_t>(offsetSamples);
                 recordingStartBeatRt.store(pendingBeat, std::memory_order_relaxed);
                 recordingStartSampleRt.store(startSample, std::memory_order_relaxed);
@@ -6610,14 +6476,13 @@ namespace sampledex
         // Record generated input output with sample-accurate beat timestamps.
         if (isPlaying && recordEnabledRt.load(std::memory_order_relaxed) && midiInputTargetCount > 0)
         {
-            const double beatsPerSample = transport.getBeatsPerSample();
             for (const auto meta : chordEngineOutputBuffer)
             {
                 auto m = meta.getMessage();
                 if (!(m.isNoteOn() || m.isNoteOff()))
                     continue;
 
-                const double eventBeat = startBeat + (static_cast<double>(meta.samplePosition) * beatsPerSample);
+                const double eventBeat = blockSpan.beatAtSample(static_cast<double>(meta.samplePosition));
                 for (int targetIdx = 0; targetIdx < midiInputTargetCount; ++targetIdx)
                 {
                     const auto trackIndex = static_cast<size_t>(midiInputTargets[static_cast<size_t>(targetIdx)]);
@@ -6648,313 +6513,240 @@ namespace sampledex
             return true;
         };
 
+        // Smart freeze: a track with a current render cache streams it in place of its clips,
+        // instrument and inserts. Selecting, arming or monitoring it goes live at once, and a
+        // track coming back to live processing chases its notes.
+        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackUsesRenderCache {};
+        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackLeftRenderCache {};
+        const int selectedTrackForCache = selectedTrackIndexRt.load(std::memory_order_relaxed);
+        for (int i = 0; i < activeTrackCount; ++i)
+        {
+            auto* track = snapshot->trackPointers[static_cast<size_t>(i)];
+            const bool hasCache = static_cast<size_t>(i) < snapshot->renderCacheForTrack.size()
+                                  && snapshot->renderCacheForTrack[static_cast<size_t>(i)] >= 0;
+            const bool useCache = hasCache
+                                  && track != nullptr
+                                  && i != selectedTrackForCache
+                                  && !track->isArmed()
+                                  && !track->isInputMonitoringEnabled();
+            trackUsesRenderCache[static_cast<size_t>(i)] = useCache;
+            trackLeftRenderCache[static_cast<size_t>(i)] = trackPlayedRenderCacheRt[static_cast<size_t>(i)] && !useCache;
+            trackPlayedRenderCacheRt[static_cast<size_t>(i)] = useCache;
+        }
+
+        // Track sleeping: a track may sleep while none of its clips plays in this block or
+        // within the pre-roll after it (plugin latency, one block and a margin), so it is
+        // awake and settled before its next clip starts. Stopped, nothing is scheduled.
+        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackClipScheduled {};
+        const bool sleepTracksThisBlock = trackSleepEnabledRt.load(std::memory_order_relaxed);
+        if (sleepTracksThisBlock && isPlaying && sampleRate > 0.0)
+        {
+            const bool looping = transport.isLooping();
+            const bool wrapped = blockRange.wrapped && looping;
+            const double loopStart = transport.getLoopStartBeat();
+            const double loopEnd = transport.getLoopEndBeat();
+            const double beatsPerSample = blockTempoMap->getTempoAtBeat(startBeat) / (60.0 * sampleRate);
+            const int wakeMarginSamples = juce::roundToInt(sampleRate * trackWakeMarginSeconds);
+
+            std::array<double, static_cast<size_t>(maxRealtimeTracks)> wakeEndBeat {};
+            for (int i = 0; i < activeTrackCount; ++i)
+            {
+                auto* track = snapshot->trackPointers[static_cast<size_t>(i)];
+                const int preRollSamples = (track != nullptr ? track->getTotalPluginLatencySamples() : 0)
+                                           + bufferToFill.numSamples
+                                           + wakeMarginSamples;
+                wakeEndBeat[static_cast<size_t>(i)] = endBeat + (preRollSamples * beatsPerSample);
+            }
+
+            for (const auto& clip : snapshot->arrangement)
+            {
+                if (!juce::isPositiveAndBelow(clip.trackIndex, activeTrackCount)
+                    || trackClipScheduled[static_cast<size_t>(clip.trackIndex)])
+                    continue;
+
+                const double clipEnd = clip.startBeat + clip.lengthBeats;
+                const double wakeEnd = wakeEndBeat[static_cast<size_t>(clip.trackIndex)];
+                const auto overlaps = [&](double from, double to) { return clip.startBeat < to && clipEnd > from; };
+                bool scheduled = false;
+                if (wrapped)
+                    scheduled = overlaps(startBeat, loopEnd) || overlaps(loopStart, wakeEnd);
+                else
+                {
+                    scheduled = overlaps(startBeat, wakeEnd);
+                    // The pre-roll runs past the loop end into the loop start.
+                    if (!scheduled && looping && startBeat < loopEnd && wakeEnd > loopEnd)
+                        scheduled = overlaps(loopStart, loopStart + (wakeEnd - loopEnd));
+                }
+                trackClipScheduled[static_cast<size_t>(clip.trackIndex)] = scheduled;
+            }
+        }
+
         // 6. Gather Sequencer MIDI (From Clips)
         if (isPlaying)
         {
             const bool wrappedThisBlock = blockRange.wrapped && transport.isLooping();
             const double loopStart = transport.getLoopStartBeat();
             const double loopEnd = transport.getLoopEndBeat();
-            const bool extClockActive = externalMidiClockSyncEnabledRt.load(std::memory_order_relaxed)
-                                     && externalMidiClockActiveRt.load(std::memory_order_relaxed);
-            const double bpmValue = extClockActive
-                ? juce::jmax(1.0, bpmRt.load(std::memory_order_relaxed))
-                : resolveTempoAtBeat(startBeat, snapshot->tempoEvents, bpmRt.load(std::memory_order_relaxed));
+            const double bpmValue = blockTempoMap->getTempoAtBeat(startBeat);
             const int globalTranspose = juce::jlimit(-48, 48, snapshot->globalTransposeSemitones);
+            const int lastBlockSample = juce::jmax(0, bufferToFill.numSamples - 1);
+            const auto blockSampleForBeat = [&](double beat)
+            {
+                return juce::jlimit(0, lastBlockSample, static_cast<int>(std::llround(blockSpan.sampleOffsetForBeat(beat))));
+            };
+
+            const auto renderClipAudio = [&](const Clip& clip, const std::shared_ptr<StreamingClipSource>& clipStream)
+            {
+                const bool hasInMemoryAudio = (clip.audioData != nullptr);
+                const bool hasDiskStream = (clipStream != nullptr && clipStream->isReady());
+                if (!hasInMemoryAudio && !hasDiskStream)
+                    return;
+
+                if (!trackIsAudible(clip.trackIndex))
+                    return;
+
+                AudioClipRenderer::StreamInfo streamInfo;
+                if (hasDiskStream)
+                {
+                    streamInfo.numSamples = clipStream->getNumSamples();
+                    streamInfo.numChannels = clipStream->getNumChannels();
+                    streamInfo.sampleRate = clipStream->getSampleRate();
+                }
+
+                AudioClipRenderer::renderSegment(clip,
+                                                 hasDiskStream ? &streamInfo : nullptr,
+                                                 [&clipStream](juce::AudioBuffer<float>& window, int64 windowStart, int windowLength)
+                                                 {
+                                                     return clipStream->readSamples(window, windowStart, windowLength);
+                                                 },
+                                                 *blockTempoMap,
+                                                 blockSpan,
+                                                 startBeat,
+                                                 endBeat,
+                                                 bufferToFill.numSamples,
+                                                 sampleRate,
+                                                 bpmValue,
+                                                 AudioClipRenderer::StretchQuality::Fast,
+                                                 audioStreamScratch,
+                                                 trackTimelineWorkBuffers[static_cast<size_t>(clip.trackIndex)]);
+            };
 
             for (size_t clipIdx = 0; clipIdx < snapshot->arrangement.size(); ++clipIdx)
             {
                 const auto& clip = snapshot->arrangement[clipIdx];
                 if (!juce::isPositiveAndBelow(clip.trackIndex, activeTrackCount))
                     continue;
+                if (trackUsesRenderCache[static_cast<size_t>(clip.trackIndex)])
+                    continue;
 
                 if (clip.type == ClipType::MIDI)
                 {
+                    const auto clipTrackBufferIndex = static_cast<size_t>(clip.trackIndex);
+                    const bool chaseClipNotes = chaseNotesThisBlock || trackLeftRenderCache[clipTrackBufferIndex];
                     if (wrappedThisBlock)
                     {
-                        const auto clipTrackBufferIndex = static_cast<size_t>(clip.trackIndex);
-                        clip.getEventsInRange(startBeat,
-                                              loopEnd,
-                                              trackMidiBuffers[clipTrackBufferIndex],
-                                              bpmValue,
-                                              sampleRate,
-                                              bufferToFill.numSamples,
-                                              chaseNotesThisBlock,
-                                              1,
-                                              globalTranspose);
-                        clip.getEventsInRange(loopStart,
-                                              endBeat,
-                                              trackMidiBuffers[clipTrackBufferIndex],
-                                              bpmValue,
-                                              sampleRate,
-                                              bufferToFill.numSamples,
-                                              true,
-                                              1,
-                                              globalTranspose);
+                        clip.getEventsInRangeMapped(startBeat,
+                                                    loopEnd,
+                                                    trackMidiBuffers[clipTrackBufferIndex],
+                                                    blockSampleForBeat,
+                                                    chaseClipNotes,
+                                                    1,
+                                                    globalTranspose);
+                        clip.getEventsInRangeMapped(loopStart,
+                                                    endBeat,
+                                                    trackMidiBuffers[clipTrackBufferIndex],
+                                                    blockSampleForBeat,
+                                                    true,
+                                                    1,
+                                                    globalTranspose);
                     }
                     else
                     {
-                        const auto clipTrackBufferIndex = static_cast<size_t>(clip.trackIndex);
-                        clip.getEventsInRange(startBeat,
-                                              endBeat,
-                                              trackMidiBuffers[clipTrackBufferIndex],
-                                              bpmValue,
-                                              sampleRate,
-                                              bufferToFill.numSamples,
-                                              chaseNotesThisBlock,
-                                              1,
-                                              globalTranspose);
+                        clip.getEventsInRangeMapped(startBeat,
+                                                    endBeat,
+                                                    trackMidiBuffers[clipTrackBufferIndex],
+                                                    blockSampleForBeat,
+                                                    chaseClipNotes,
+                                                    1,
+                                                    globalTranspose);
                     }
                 }
                 else if (clip.type == ClipType::Audio)
                 {
-                    const auto clipStream = clipIdx < snapshot->audioClipStreams.size()
-                        ? snapshot->audioClipStreams[clipIdx]
-                        : std::shared_ptr<StreamingClipSource>();
-                    const bool hasInMemoryAudio = (clip.audioData != nullptr);
-                    const bool hasDiskStream = (clipStream != nullptr && clipStream->isReady());
-                    if (!hasInMemoryAudio && !hasDiskStream)
-                        continue;
+                    renderClipAudio(clip,
+                                    clipIdx < snapshot->audioClipStreams.size()
+                                        ? snapshot->audioClipStreams[clipIdx]
+                                        : std::shared_ptr<StreamingClipSource>());
+                }
+            }
 
-                    if (!trackIsAudible(clip.trackIndex))
-                        continue;
+            for (size_t cacheIdx = 0; cacheIdx < snapshot->renderCacheClips.size(); ++cacheIdx)
+            {
+                const auto& clip = snapshot->renderCacheClips[cacheIdx];
+                if (juce::isPositiveAndBelow(clip.trackIndex, activeTrackCount)
+                    && trackUsesRenderCache[static_cast<size_t>(clip.trackIndex)]
+                    && cacheIdx < snapshot->renderCacheStreams.size())
+                    renderClipAudio(clip, snapshot->renderCacheStreams[cacheIdx]);
+            }
+        }
 
-                    const double clipStart = clip.startBeat;
-                    const double clipEnd = clip.startBeat + juce::jmax(0.0001, clip.lengthBeats);
-                    if (clipEnd <= startBeat || clipStart >= endBeat)
-                        continue;
+        // 7. Process Audio Tracks
+        tempMixingBuffer.clear(0, 0, bufferToFill.numSamples);
+        tempMixingBuffer.clear(1, 0, bufferToFill.numSamples);
+        const int bestAutoInputPair = chooseBestInputPairForCurrentBlock(capturedInputChannels, bufferToFill.numSamples);
+        const bool recordingCaptureActive = transport.recording();
+        const bool builtInFailSafe = builtInMicHardFailSafeRt.load(std::memory_order_relaxed);
+        const bool startupGuardActive = startupSafetyBlocksRemainingRt.load(std::memory_order_relaxed) > 0;
+        const bool lowLatencyProcessing = lowLatencyModeRt.load(std::memory_order_relaxed)
+                                       || xrunRecoveryBlocksRt.load(std::memory_order_relaxed) > 0;
+        const bool monitorSafeForTrackProcessing = monitorSafeModeRt.load(std::memory_order_relaxed);
+        bool monitoredTrackInputActive = false;
+        std::array<RealtimeTrackGraphJob, static_cast<size_t>(maxRealtimeTracks)> trackGraphJobs {};
+        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackGraphAudible {};
+        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackMonitorInputUsed {};
+        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackSendFeedbackBlocked {};
+        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackOutputToBus {};
+        std::array<int, static_cast<size_t>(maxRealtimeTracks)> trackSendBusIndex {};
+        std::array<int, static_cast<size_t>(maxRealtimeTracks)> trackOutputBusIndex {};
 
-                    const double segmentStartBeat = juce::jmax(startBeat, clipStart);
-                    const double segmentEndBeat = juce::jmin(endBeat, clipEnd);
-                    if (segmentEndBeat <= segmentStartBeat)
-                        continue;
+        // One push of every input channel covers all recording takes; the disk thread picks
+        // each take's pair out of it.
+        if (recordingCaptureActive
+            && recordCaptureRingActive
+            && capturedInputChannels > 0
+            && liveInputCaptureBuffer.getNumSamples() >= bufferToFill.numSamples)
+        {
+            recordCaptureRing.push(liveInputCaptureBuffer,
+                                   capturedInputChannels,
+                                   bufferToFill.numSamples,
+                                   inputMonitorSafetyTrimRt.load(std::memory_order_relaxed),
+                                   bestAutoInputPair);
+        }
 
-                    const double secondsPerBeat = 60.0 / bpmValue;
-                    const double outputSeconds = (segmentEndBeat - segmentStartBeat) * secondsPerBeat;
-                    int targetNumSamples = static_cast<int>(std::floor(outputSeconds * sampleRate));
-                    if (targetNumSamples <= 0)
-                        continue;
-
-                    const int targetStartSample = static_cast<int>(std::round((segmentStartBeat - startBeat) * secondsPerBeat * sampleRate));
-                    if (targetStartSample < 0 || targetStartSample >= bufferToFill.numSamples)
-                        continue;
-                    targetNumSamples = juce::jmin(targetNumSamples, bufferToFill.numSamples - targetStartSample);
-                    if (targetNumSamples <= 0)
-                        continue;
-
-                    const bool offlineStretchQuality = offlineRenderActiveRt.load(std::memory_order_relaxed);
-                    const ClipStretchQuality stretchQuality = offlineStretchQuality
-                        ? ClipStretchQuality::High
-                        : ClipStretchQuality::Fast;
-                    const double sourceSampleRate = hasDiskStream
-                        ? juce::jmax(1.0, clipStream->getSampleRate())
-                        : juce::jmax(1.0, clip.audioSampleRate);
-                                        const double beatStep = bpmValue / (60.0 * juce::jmax(1.0, sampleRate));
-                    const double clipStartOffsetBeat = segmentStartBeat - clip.startBeat;
-                    const double sourceTempoBpm = juce::jmax(1.0,
-                                                             clip.originalTempoBpm > 0.0 ? clip.originalTempoBpm
-                                                                                         : (clip.detectedTempoBpm > 0.0 ? clip.detectedTempoBpm
-                                                                                                                 : bpmValue));
-                    const double sourceSecondsPerBeat = 60.0 / sourceTempoBpm;
-                    const double sourceSamplesPerBeat = sourceSecondsPerBeat * sourceSampleRate;
-                    auto sourcePositionForClipBeat = [&](double beatInClip)
-                    {
-                        const double clipBeatWithOffset = juce::jmax(0.0, beatInClip + clip.offsetBeats);
-                        if (clip.oneShot || clip.stretchMode == ClipStretchMode::OneShot)
-                            return clip.offsetBeats * sourceSamplesPerBeat + (beatInClip * secondsPerBeat * sourceSampleRate);
-
-                        if (clip.stretchMode == ClipStretchMode::BeatWarp)
-                            return mapClipBeatToSourceBeat(clip, clipBeatWithOffset) * sourceSamplesPerBeat;
-
-                        return clipBeatWithOffset * secondsPerBeat * sourceSampleRate;
-                    };
-
-                    const int clipNumSamples = hasDiskStream
-                        ? static_cast<int>(juce::jmin<int64>(std::numeric_limits<int>::max(), clipStream->getNumSamples()))
-                        : clip.audioData->getNumSamples();
-                    const int clipNumChannels = hasDiskStream
-                        ? clipStream->getNumChannels()
-                        : clip.audioData->getNumChannels();
-                    if (clipNumSamples <= 1 || clipNumChannels <= 0)
-                        continue;
-
-                    int64 readWindowStart = 0;
-                    int readWindowLength = 0;
-                    if (hasDiskStream)
-                    {
-                        const int64 clipTotalSamples = clipStream->getNumSamples();
-                        const double sourceStartPosition = sourcePositionForClipBeat(clipStartOffsetBeat);
-                        const double sourceEndPosition = sourcePositionForClipBeat(clipStartOffsetBeat + (beatStep * targetNumSamples));
-                        const double minSourcePosition = juce::jmin(sourceStartPosition, sourceEndPosition);
-                        const double maxSourcePosition = juce::jmax(sourceStartPosition, sourceEndPosition);
-                        readWindowStart = juce::jlimit<int64>(0,
-                                                              juce::jmax<int64>(0, clipTotalSamples - 1),
-                                                              static_cast<int64>(std::floor(minSourcePosition)) - clipResamplerTaps);
-                        const double readWindowEndPos = maxSourcePosition + static_cast<double>(clipResamplerTaps);
-                        const int64 windowEnd = juce::jlimit<int64>(0,
-                                                                     clipTotalSamples,
-                                                                     static_cast<int64>(std::ceil(readWindowEndPos)) + 2);
-                        readWindowLength = static_cast<int>(juce::jmax<int64>(0, windowEnd - readWindowStart));
-                        if (readWindowLength <= 1
-                            || audioStreamScratch.getNumChannels() < clipNumChannels
-                            || audioStreamScratch.getNumSamples() < readWindowLength)
-                        {
-                            continue;
-                        }
-
-                        if (!clipStream->readSamples(audioStreamScratch, readWindowStart, readWindowLength))
-                            continue;
-                    }
-
-                    const float baseGain = juce::jlimit(0.0f, 8.0f, clip.gainLinear);
-                    const double fadeInBeats = juce::jmax(0.0, juce::jmax(clip.fadeInBeats, clip.crossfadeInBeats));
-                    const double fadeOutBeats = juce::jmax(0.0, juce::jmax(clip.fadeOutBeats, clip.crossfadeOutBeats));
-                    double beatInClip = clipStartOffsetBeat;
-                    auto& clipTrackBuffer = trackTimelineWorkBuffers[static_cast<size_t>(clip.trackIndex)];
-                    const int clipOutputChannels = clipTrackBuffer.getNumChannels();
-                    if (clipOutputChannels <= 0 || clipTrackBuffer.getNumSamples() < bufferToFill.numSamples)
-                        continue;
-                    const int sourceBufferNumSamples = hasDiskStream ? readWindowLength : clipNumSamples;
-                    const double sourceBaseOffset = hasDiskStream ? static_cast<double>(readWindowStart) : 0.0;
-                    auto computeLocalSourcePosition = [&](double localBeat)
-                    {
-                        return sourcePositionForClipBeat(localBeat) - sourceBaseOffset;
-                    };
-
-                    if (clipNumChannels == 1)
-                    {
-                        const auto* src = hasDiskStream ? audioStreamScratch.getReadPointer(0)
-                                                        : clip.audioData->getReadPointer(0);
-                        auto* dstL = clipOutputChannels > 0 ? clipTrackBuffer.getWritePointer(0) : nullptr;
-                        auto* dstR = clipOutputChannels > 1 ? clipTrackBuffer.getWritePointer(1) : nullptr;
-
-                        for (int sampleIdx = 0; sampleIdx < targetNumSamples; ++sampleIdx)
-                        {
-                            const double localSourcePosition = computeLocalSourcePosition(beatInClip);
-                            if (localSourcePosition >= static_cast<double>(sourceBufferNumSamples - 1))
-                                break;
-
-                            float fadeGain = 1.0f;
-                            if (fadeInBeats > 0.0)
-                            {
-                                const float fadeInLinear = static_cast<float>(juce::jlimit(0.0,
-                                                                                           1.0,
-                                                                                           beatInClip / fadeInBeats));
-                                fadeGain = juce::jmin(fadeGain, applyEqualPowerFade(fadeInLinear));
-                            }
-                            if (fadeOutBeats > 0.0)
-                            {
-                                const double beatsToEnd = juce::jmax(0.0, clip.lengthBeats - beatInClip);
-                                const float fadeOutLinear = static_cast<float>(juce::jlimit(0.0,
-                                                                                             1.0,
-                                                                                             beatsToEnd / fadeOutBeats));
-                                fadeGain = juce::jmin(fadeGain, applyEqualPowerFade(fadeOutLinear));
-                            }
-
-                            const int writeIndex = targetStartSample + sampleIdx;
-                            float interpolated = sampleForStretchQuality(src,
-                                                                    sourceBufferNumSamples,
-                                                                    localSourcePosition,
-                                                                    stretchQuality);
-                            interpolated = applyMicroFadeWindow(beatInClip, clip.lengthBeats, beatStep, interpolated);
-                            const float scaled = interpolated * (baseGain * fadeGain);
-                            if (dstL != nullptr)
-                                dstL[writeIndex] += scaled;
-                            if (dstR != nullptr)
-                                dstR[writeIndex] += scaled;
-
-                            beatInClip += beatStep;
-                        }
-                    }
-                    else
-                    {
-                        const int mixChannels = juce::jmin(clipNumChannels, clipOutputChannels);
-                        if (mixChannels <= 0)
-                            continue;
-
-                        std::array<const float*, 2> srcPointers {};
-                        std::array<float*, 2> dstPointers {};
-                        for (int ch = 0; ch < mixChannels; ++ch)
-                        {
-                            srcPointers[static_cast<size_t>(ch)] = hasDiskStream ? audioStreamScratch.getReadPointer(ch)
-                                                                                  : clip.audioData->getReadPointer(ch);
-                            dstPointers[static_cast<size_t>(ch)] = clipTrackBuffer.getWritePointer(ch);
-                        }
-
-                        for (int sampleIdx = 0; sampleIdx < targetNumSamples; ++sampleIdx)
-                        {
-                            const double localSourcePosition = computeLocalSourcePosition(beatInClip);
-                            if (localSourcePosition >= static_cast<double>(sourceBufferNumSamples - 1))
-                                break;
-
-                            float fadeGain = 1.0f;
-                            if (fadeInBeats > 0.0)
-                            {
-                                const float fadeInLinear = static_cast<float>(juce::jlimit(0.0,
-                                                                                           1.0,
-                                                                                           beatInClip / fadeInBeats));
-                                fadeGain = juce::jmin(fadeGain, applyEqualPowerFade(fadeInLinear));
-                            }
-                            if (fadeOutBeats > 0.0)
-                            {
-                                const double beatsToEnd = juce::jmax(0.0, clip.lengthBeats - beatInClip);
-                                const float fadeOutLinear = static_cast<float>(juce::jlimit(0.0,
-                                                                                             1.0,
-                                                                                             beatsToEnd / fadeOutBeats));
-                                fadeGain = juce::jmin(fadeGain, applyEqualPowerFade(fadeOutLinear));
-                            }
-
-                            const int writeIndex = targetStartSample + sampleIdx;
-                            const float sampleGain = baseGain * fadeGain;
-                            for (int ch = 0; ch < mixChannels; ++ch)
-                            {
-                                float interpolated = sampleForStretchQuality(srcPointers[static_cast<size_t>(ch)],
-                                                                        sourceBufferNumSamples,
-                                                                        localSourcePosition,
-                                                                        stretchQuality);
-                                interpolated = applyMicroFadeWindow(beatInClip, clip.lengthBeats, beatStep, interpolated);
-                                dstPointers[static_cast<size_t>(ch)][writeIndex] += interpolated * sampleGain;
-                            }
-
-                            beatInClip += beatStep;
-                        }
-                    }
-                }
-            }
-        }
-
-        // 7. Process Audio Tracks
-        tempMixingBuffer.clear(0, 0, bufferToFill.numSamples);
-        tempMixingBuffer.clear(1, 0, bufferToFill.numSamples);
-        const int bestAutoInputPair = chooseBestInputPairForCurrentBlock(capturedInputChannels, bufferToFill.numSamples);
-        const bool recordingCaptureActive = transport.recording();
-        const bool builtInFailSafe = builtInMicHardFailSafeRt.load(std::memory_order_relaxed);
-        const bool startupGuardActive = startupSafetyBlocksRemainingRt.load(std::memory_order_relaxed) > 0;
-        const bool lowLatencyProcessing = lowLatencyModeRt.load(std::memory_order_relaxed)
-                                       || xrunRecoveryBlocksRt.load(std::memory_order_relaxed) > 0;
-        const bool offlineRenderActive = offlineRenderActiveRt.load(std::memory_order_relaxed);
-        const bool monitorSafeForTrackProcessing = monitorSafeModeRt.load(std::memory_order_relaxed);
-        bool monitoredTrackInputActive = false;
-        std::array<RealtimeTrackGraphJob, static_cast<size_t>(maxRealtimeTracks)> trackGraphJobs {};
-        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackGraphAudible {};
-        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackMonitorInputUsed {};
-        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackSendFeedbackBlocked {};
-        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackOutputToBus {};
-        std::array<int, static_cast<size_t>(maxRealtimeTracks)> trackSendBusIndex {};
-        std::array<int, static_cast<size_t>(maxRealtimeTracks)> trackOutputBusIndex {};
-
-        for (int i = 0; i < activeTrackCount; ++i)
-        {
-            auto* track = snapshot->trackPointers[static_cast<size_t>(i)];
-            auto& job = trackGraphJobs[static_cast<size_t>(i)];
-            job.track = track;
-            job.mainBuffer = &trackMainWorkBuffers[static_cast<size_t>(i)];
-            job.sourceAudio = &trackTimelineWorkBuffers[static_cast<size_t>(i)];
-            job.sendBuffer = &trackSendWorkBuffers[static_cast<size_t>(i)];
-            job.midi = &trackMidiBuffers[static_cast<size_t>(i)];
-            job.monitorInput = nullptr;
-            job.blockSamples = bufferToFill.numSamples;
-            job.monitorSafeInput = monitorSafeForTrackProcessing;
-            job.processTrack = false;
+        for (int i = 0; i < activeTrackCount; ++i)
+        {
+            auto* track = snapshot->trackPointers[static_cast<size_t>(i)];
+            auto& job = trackGraphJobs[static_cast<size_t>(i)];
+            job.track = track;
+            job.mainBuffer = &trackMainWorkBuffers[static_cast<size_t>(i)];
+            job.sourceAudio = &trackTimelineWorkBuffers[static_cast<size_t>(i)];
+            job.sendBuffer = &trackSendWorkBuffers[static_cast<size_t>(i)];
+            job.midi = &trackMidiBuffers[static_cast<size_t>(i)];
+            job.monitorInput = nullptr;
+            job.blockSamples = bufferToFill.numSamples;
+            job.monitorSafeInput = monitorSafeForTrackProcessing;
+            job.sourceIsRenderCache = trackUsesRenderCache[static_cast<size_t>(i)];
+            // Selected, armed and monitoring tracks take live input and stay awake, and a
+            // render cache already skips the plugins.
+            job.sleepAllowed = sleepTracksThisBlock
+                               && track != nullptr
+                               && !trackClipScheduled[static_cast<size_t>(i)]
+                               && !job.sourceIsRenderCache
+                               && i != selectedTrackForCache
+                               && track->getChannelType() != Track::ChannelType::Aux
+                               && !track->isArmed()
+                               && !track->isInputMonitoringEnabled();
+            job.processTrack = false;
 
             if (track == nullptr)
                 continue;
@@ -6981,10 +6773,8 @@ namespace sampledex
                                              || track->isArmed();
 
             const juce::AudioBuffer<float>* monitorInput = nullptr;
-            const juce::AudioBuffer<float>* recordInput = nullptr;
             auto& trackInputBuffer = trackInputWorkBuffers[static_cast<size_t>(i)];
-            if (!offlineRenderActive
-                && capturedInputChannels > 0
+            if (capturedInputChannels > 0
                 && trackInputBuffer.getNumChannels() >= 2
                 && trackInputBuffer.getNumSamples() >= bufferToFill.numSamples
                 && liveInputCaptureBuffer.getNumSamples() >= bufferToFill.numSamples)
@@ -7008,8 +6798,6 @@ namespace sampledex
                     trackInputBuffer.applyGain(1, 0, bufferToFill.numSamples, monitorTrim);
                 }
 
-                recordInput = &trackInputBuffer;
-
                 bool allowMonitorForMode = false;
                 switch (inputMonitoringMode)
                 {
@@ -7039,57 +6827,12 @@ namespace sampledex
             }
             job.monitorInput = monitorInput;
             job.processTrack = true;
-
-            if (recordingCaptureActive
-                && track->isArmed()
-                && recordInput != nullptr
-                && juce::isPositiveAndBelow(i, maxRealtimeTracks))
-            {
-                auto& take = audioTakeWriters[static_cast<size_t>(i)];
-                if (take.active && take.ringFifo != nullptr
-                    && recordInput->getNumChannels() >= 2
-                    && recordInput->getNumSamples() >= bufferToFill.numSamples)
-                {
-                    int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
-                    take.ringFifo->prepareToWrite(bufferToFill.numSamples, start1, size1, start2, size2);
-                    const float* left = recordInput->getReadPointer(0);
-                    const float* right = recordInput->getReadPointer(1);
-                    if (left != nullptr && right != nullptr)
-                    {
-                        int copied = 0;
-                        if (size1 > 0)
-                        {
-                            std::memcpy(take.ringLeft.data() + start1,
-                                        left,
-                                        static_cast<size_t>(size1) * sizeof(float));
-                            std::memcpy(take.ringRight.data() + start1,
-                                        right,
-                                        static_cast<size_t>(size1) * sizeof(float));
-                            copied += size1;
-                        }
-                        if (size2 > 0)
-                        {
-                            std::memcpy(take.ringLeft.data() + start2,
-                                        left + copied,
-                                        static_cast<size_t>(size2) * sizeof(float));
-                            std::memcpy(take.ringRight.data() + start2,
-                                        right + copied,
-                                        static_cast<size_t>(size2) * sizeof(float));
-                            copied += size2;
-                        }
-                        take.ringFifo->finishedWrite(copied);
-                        if (copied < bufferToFill.numSamples)
-                            take.droppedSamples.fetch_add(static_cast<int64>(bufferToFill.numSamples - copied), std::memory_order_relaxed);
-                    }
-                }
-            }
         }
 
         TransportBlockContext transportBlockContext {};
         transportBlockContext.numSamples = bufferToFill.numSamples;
         transportBlockContext.sampleRate = sampleRate;
         transportBlockContext.lowLatencyProcessing = lowLatencyProcessing;
-        transportBlockContext.offlineRenderActive = offlineRenderActive;
 
         RealtimeMixInputs mixInputs {};
         mixInputs.activeTrackCount = activeTrackCount;
@@ -7126,91 +6869,22 @@ namespace sampledex
                                                                            mainBuffer,
                                                                            sendBuffer);
                                            });
-        
+
         // 8. Aux Effects
-        const bool auxEnabled = auxFxEnabledRt.load(std::memory_order_relaxed);
-        const float auxReturnLevel = auxReturnGainRt.load(std::memory_order_relaxed);
+        RealtimeAuxReturnSettings auxReturnSettings;
+        auxReturnSettings.fxEnabled = auxFxEnabledRt.load(std::memory_order_relaxed);
+        auxReturnSettings.returnGain = auxReturnGainRt.load(std::memory_order_relaxed);
+        auxReturnSettings.monitorSafe = monitorSafeModeRt.load(std::memory_order_relaxed);
+        std::array<float, static_cast<size_t>(auxBusCount)> auxBusPeaks {};
+        RealtimeAudioEngine::processAuxReturns(transportBlockContext,
+                                               auxReturnSettings,
+                                               auxBusBuffers,
+                                               auxReverbs,
+                                               &auxBusPeaks);
         float auxMeterMax = 0.0f;
         for (int bus = 0; bus < auxBusCount; ++bus)
         {
-            auto& auxBus = auxBusBuffers[static_cast<size_t>(bus)];
-            const int auxChannels = auxBus.getNumChannels();
-            const bool auxCanProcess = bufferToFill.numSamples > 0
-                                       && auxBus.getNumSamples() >= bufferToFill.numSamples
-                                       && auxChannels > 0;
-            float auxMeter = 0.0f;
-            if (auxCanProcess && auxReturnLevel > 0.0001f)
-            {
-                sanitizeAudioBuffer(auxBus, bufferToFill.numSamples);
-                bool auxProcessed = !auxEnabled;
-                if (auxEnabled && lowLatencyProcessing)
-                {
-                    auxProcessed = true;
-                }
-                else if (auxEnabled && auxChannels >= 2)
-                {
-                    auto* left = auxBus.getWritePointer(0);
-                    auto* right = auxBus.getWritePointer(1);
-                    if (left != nullptr && right != nullptr)
-                    {
-                        auxReverbs[static_cast<size_t>(bus)].processStereo(left, right, bufferToFill.numSamples);
-                        auxProcessed = true;
-                    }
-
-                    // Any channels above stereo are treated as mono for safety.
-                    for (int ch = 2; ch < auxChannels; ++ch)
-                    {
-                        auto* mono = auxBus.getWritePointer(ch);
-                        if (mono == nullptr)
-                            continue;
-                        auxReverbs[static_cast<size_t>(bus)].processMono(mono, bufferToFill.numSamples);
-                        auxProcessed = true;
-                    }
-                }
-                else if (auxEnabled)
-                {
-                    for (int ch = 0; ch < auxChannels; ++ch)
-                    {
-                        auto* mono = auxBus.getWritePointer(ch);
-                        if (mono == nullptr)
-                            continue;
-                        auxReverbs[static_cast<size_t>(bus)].processMono(mono, bufferToFill.numSamples);
-                        auxProcessed = true;
-                    }
-                }
-
-                if (auxProcessed)
-                {
-                    auxBus.applyGain(auxReturnLevel);
-                    sanitizeAudioBuffer(auxBus, bufferToFill.numSamples);
-
-                    if (auxEnabled && monitorSafeModeRt.load(std::memory_order_relaxed))
-                    {
-                        constexpr float drive = 1.18f;
-                        const float normalise = 1.0f / std::tanh(drive);
-                        for (int ch = 0; ch < auxChannels; ++ch)
-                        {
-                            auto* write = auxBus.getWritePointer(ch);
-                            if (write == nullptr)
-                                continue;
-                            for (int sampleIdx = 0; sampleIdx < bufferToFill.numSamples; ++sampleIdx)
-                                write[sampleIdx] = std::tanh(write[sampleIdx] * drive) * normalise;
-                        }
-                    }
-
-                    for (int ch = 0; ch < auxChannels; ++ch)
-                        auxMeter = juce::jmax(auxMeter, auxBus.getMagnitude(ch, 0, bufferToFill.numSamples));
-                }
-                else
-                {
-                    auxBus.clear();
-                }
-            }
-            else
-            {
-                auxBus.clear();
-            }
-
+            const float auxMeter = auxBusPeaks[static_cast<size_t>(bus)];
             auxBusMeterRt[static_cast<size_t>(bus)].store(auxMeter, std::memory_order_relaxed);
             auxMeterMax = juce::jmax(auxMeterMax, auxMeter);
         }
@@ -7219,12 +6893,11 @@ namespace sampledex
         // 9. Metronome (short decaying click with bar accent)
         if (metronomeEnabledRt.load(std::memory_order_relaxed) && isPlaying)
         {
-            const double beatsPerSample = transport.getBeatsPerSample();
-            if (beatsPerSample > 0.0 && sampleRate > 0.0)
+            if (sampleRate > 0.0)
             {
-                const auto addClick = [&](double beatInSegment, double segmentStartBeat)
+                const auto addClick = [&](double beatInSegment)
                 {
-                    const int sampleOffset = static_cast<int>(std::round((beatInSegment - segmentStartBeat) / beatsPerSample));
+                    const int sampleOffset = static_cast<int>(std::round(blockSpan.sampleOffsetForBeat(beatInSegment)));
                     if (!juce::isPositiveAndBelow(sampleOffset, bufferToFill.numSamples))
                         return;
 
@@ -7255,7 +6928,7 @@ namespace sampledex
                         beat = std::round(segmentStartBeat);
 
                     for (; beat < segmentEndBeat - 1.0e-9; beat += 1.0)
-                        addClick(beat, segmentStartBeat);
+                        addClick(beat);
                 };
 
                 if (blockRange.wrapped && transport.isLooping())
@@ -7270,69 +6943,12 @@ namespace sampledex
             }
         }
 
-        // 10. Final Sum
+        // 10. Final Sum and master chain
         const int outputChannels = juce::jmin(tempMixingBuffer.getNumChannels(), bufferToFill.buffer->getNumChannels());
-        sanitizeAudioBuffer(tempMixingBuffer, bufferToFill.numSamples);
-        for (int ch = 0; ch < outputChannels; ++ch)
-        {
-            bufferToFill.buffer->addFrom(ch, bufferToFill.startSample, tempMixingBuffer, ch, 0, bufferToFill.numSamples);
-            for (int bus = 0; bus < auxBusCount; ++bus)
-            {
-                const auto& auxBus = auxBusBuffers[static_cast<size_t>(bus)];
-                if (ch < auxBus.getNumChannels())
-                    bufferToFill.buffer->addFrom(ch, bufferToFill.startSample, auxBus, ch, 0, bufferToFill.numSamples);
-            }
-        }
-
-        const bool applyTransportBoundaryFade = chaseNotesThisBlock || transportStopThisBlock || wrappedLoopBlock;
-        if (applyTransportBoundaryFade)
-        {
-            const int boundaryFadeSamples = juce::jmin(64, juce::jmax(1, bufferToFill.numSamples / 8));
-            for (int ch = 0; ch < outputChannels; ++ch)
-            {
-                auto* write = bufferToFill.buffer->getWritePointer(ch, bufferToFill.startSample);
-                if (write == nullptr)
-                    continue;
-
-                if (chaseNotesThisBlock || wrappedLoopBlock)
-                {
-                    const float first = write[0];
-                    for (int i = 0; i < boundaryFadeSamples; ++i)
-                    {
-                        const float t = static_cast<float>(i + 1) / static_cast<float>(boundaryFadeSamples);
-                        write[i] = first * t;
-                    }
-                }
-
-                if (transportStopThisBlock)
-                {
-                    const float last = write[bufferToFill.numSamples - 1];
-                    for (int i = 0; i < boundaryFadeSamples; ++i)
-                    {
-                        const int idx = bufferToFill.numSamples - boundaryFadeSamples + i;
-                        const float t = 1.0f - (static_cast<float>(i + 1) / static_cast<float>(boundaryFadeSamples));
-                        write[idx] = last * t;
-                    }
-                }
-            }
-        }
-
-        const int continuityFadeSamples = juce::jmin(32, bufferToFill.numSamples);
-        for (int ch = 0; ch < juce::jmin(outputChannels, 2); ++ch)
-        {
-            auto* write = bufferToFill.buffer->getWritePointer(ch, bufferToFill.startSample);
-            if (write == nullptr)
-                continue;
-
-            const float previousTail = outputBoundaryPrevSample[static_cast<size_t>(ch)];
-            const float currentHead = write[0];
-            for (int i = 0; i < continuityFadeSamples; ++i)
-            {
-                const float t = static_cast<float>(i + 1) / static_cast<float>(continuityFadeSamples);
-                write[i] = previousTail + ((currentHead - previousTail) * t);
-            }
-            outputBoundaryPrevSample[static_cast<size_t>(ch)] = write[bufferToFill.numSamples - 1];
-        }
+        RealtimeOutputStage outputStage;
+        outputStage.fadeInAtStart = chaseNotesThisBlock || wrappedLoopBlock;
+        outputStage.fadeOutAtEnd = transportStopThisBlock;
+        outputStage.monitorSafe = monitorSafeModeRt.load(std::memory_order_relaxed);
 
         const int startupRampRemaining = startupOutputRampSamplesRemainingRt.load(std::memory_order_relaxed);
         if (startupRampRemaining > 0)
@@ -7341,20 +6957,12 @@ namespace sampledex
                 startupSafetyRampEventsRt.fetch_add(1, std::memory_order_relaxed);
             const int startupRampTotal = juce::jmax(1, startupOutputRampTotalSamplesRt.load(std::memory_order_relaxed));
             const int nextRampRemaining = juce::jmax(0, startupRampRemaining - bufferToFill.numSamples);
-            const float startGain = juce::jlimit(0.0f,
-                                                 1.0f,
-                                                 1.0f - (static_cast<float>(startupRampRemaining) / static_cast<float>(startupRampTotal)));
-            const float endGain = juce::jlimit(0.0f,
-                                               1.0f,
-                                               1.0f - (static_cast<float>(nextRampRemaining) / static_cast<float>(startupRampTotal)));
-            for (int ch = 0; ch < outputChannels; ++ch)
-            {
-                bufferToFill.buffer->applyGainRamp(ch,
-                                                   bufferToFill.startSample,
-                                                   bufferToFill.numSamples,
-                                                   startGain,
-                                                   endGain);
-            }
+            outputStage.rampStartGain = juce::jlimit(0.0f,
+                                                     1.0f,
+                                                     1.0f - (static_cast<float>(startupRampRemaining) / static_cast<float>(startupRampTotal)));
+            outputStage.rampEndGain = juce::jlimit(0.0f,
+                                                   1.0f,
+                                                   1.0f - (static_cast<float>(nextRampRemaining) / static_cast<float>(startupRampTotal)));
             startupOutputRampSamplesRemainingRt.store(nextRampRemaining, std::memory_order_relaxed);
         }
         if (startupSafetyBlocksRemainingRt.load(std::memory_order_relaxed) > 0)
@@ -7365,26 +6973,25 @@ namespace sampledex
         outputMixInputs.useSoftClip = masterSoftClipEnabledRt.load(std::memory_order_relaxed);
         outputMixInputs.limiterEnabled = masterLimiterEnabledRt.load(std::memory_order_relaxed);
         outputMixInputs.masterGainDezipperCoeff = masterGainDezipperCoeff > 0.0f ? masterGainDezipperCoeff : 0.0015f;
-        outputMixInputs.softClipDrive = monitorSafeModeRt.load(std::memory_order_relaxed) ? 1.22f : 1.15f;
-        outputMixInputs.softClipNormaliser = 1.0f / std::tanh(outputMixInputs.softClipDrive);
-        outputMixInputs.limiterCeiling = 0.985f;
-        outputMixInputs.limiterAttack = 0.45f;
-        outputMixInputs.limiterRelease = 0.0025f;
-        outputMixInputs.limiterRecovery = 0.015f;
         outputMixInputs.outputDcHighPassEnabled = outputDcHighPassEnabledRt.load(std::memory_order_relaxed);
+        if (masterAutomationRamp.isActive()
+            && masterAutomationValues.getNumSamples() >= bufferToFill.numSamples)
+        {
+            masterAutomationRamp.fillValues(masterAutomationValues.getWritePointer(0), bufferToFill.numSamples);
+            outputMixInputs.masterGainValues = masterAutomationValues.getReadPointer(0);
+        }
 
         RealtimeMixOutputs outputMixOutputs {};
-        RealtimeAudioEngine::applyOutputLimiting(transportBlockContext,
-                                                 outputMixInputs,
-                                                 *bufferToFill.buffer,
-                                                 bufferToFill.startSample,
-                                                 masterGainSmoothingState,
-                                                 masterLimiterGainState,
-                                                 masterLimiterPrevInput,
-                                                 masterTruePeakMidpointPrevInput,
-                                                 outputDcPrevInput,
-                                                 outputDcPrevOutput,
-                                                 outputMixOutputs);
+        RealtimeAudioEngine::renderOutputStage(transportBlockContext,
+                                               outputStage,
+                                               outputMixInputs,
+                                               tempMixingBuffer,
+                                               auxBusBuffers,
+                                               *bufferToFill.buffer,
+                                               bufferToFill.startSample,
+                                               outputBoundaryPrevSample,
+                                               masterLimiter,
+                                               outputMixOutputs);
 
         juce::ignoreUnused(outputMixOutputs.outputChannels);
         const bool severeOutputFault = outputMixOutputs.severeOutputFault;
@@ -7600,6 +7207,8 @@ namespace sampledex
             tapBuffer.setSize(channels, samples, false, false, true);
         inputTapReadyIndex.store(-1, std::memory_order_relaxed);
         activeInputChannelCountRt.store(activeInputChannels, std::memory_order_relaxed);
+        // A measurement spanning a device restart would include the gap.
+        latencyCalibrator.cancel();
         startupSafetyBlocksRemainingRt.store(startupGuardBlocks, std::memory_order_relaxed);
         startupOutputRampTotalSamplesRt.store(startupRampSamples, std::memory_order_relaxed);
         startupOutputRampSamplesRemainingRt.store(startupRampSamples, std::memory_order_relaxed);
@@ -7608,18 +7217,15 @@ namespace sampledex
         feedbackHazardBlocksRt.store(0, std::memory_order_relaxed);
         feedbackAutoMuteRequestedRt.store(false, std::memory_order_relaxed);
         outputSafetyMuteBlocksRt.store(0, std::memory_order_relaxed);
-        outputDcPrevInput = { 0.0f, 0.0f };
-        outputDcPrevOutput = { 0.0f, 0.0f };
-        masterLimiterPrevInput = { 0.0f, 0.0f };
-        masterTruePeakMidpointPrevInput = { 0.0f, 0.0f };
+        masterLimiter.reset();
         outputBoundaryPrevSample = { 0.0f, 0.0f };
-        masterLimiterGainState = 1.0f;
         lastAudioDeviceNameSeen = device->getName();
         refreshInputDeviceSafetyState();
     }
 
     void MainComponent::audioDeviceStopped()
     {
+        latencyCalibrator.cancel();
         inputTapReadyIndex.store(-1, std::memory_order_relaxed);
         activeInputChannelCountRt.store(0, std::memory_order_relaxed);
         inputMonitorSafetyTrimRt.store(1.0f, std::memory_order_relaxed);
@@ -7633,12 +7239,8 @@ namespace sampledex
         feedbackHazardBlocksRt.store(0, std::memory_order_relaxed);
         feedbackAutoMuteRequestedRt.store(false, std::memory_order_relaxed);
         outputSafetyMuteBlocksRt.store(0, std::memory_order_relaxed);
-        outputDcPrevInput = { 0.0f, 0.0f };
-        outputDcPrevOutput = { 0.0f, 0.0f };
-        masterLimiterPrevInput = { 0.0f, 0.0f };
-        masterTruePeakMidpointPrevInput = { 0.0f, 0.0f };
+        masterLimiter.reset();
         outputBoundaryPrevSample = { 0.0f, 0.0f };
-        masterLimiterGainState = 1.0f;
         for (auto& tapInfo : inputTapNumChannels)
             tapInfo.store(0, std::memory_order_relaxed);
         for (auto& tapInfo : inputTapNumSamples)
@@ -7797,6 +7399,14 @@ namespace sampledex
     }
     void MainComponent::releaseResources()
     {
+        if (RealtimeSafetyMonitor::isEnabled())
+        {
+            RealtimeSafetyMonitor::setEnabled(false);
+            if (RealtimeSafetyMonitor::getViolationCount() > 0)
+                juce::Logger::writeToLog(RealtimeSafetyMonitor::createReport());
+            RealtimeSafetyMonitor::reset();
+        }
+
         for (auto* t : tracks)
             t->releaseResources();
 
@@ -8158,9 +7768,10 @@ namespace sampledex
         newClip.formantPreserve = false;
         newClip.oneShot = false;
 
-        const double bpmNow = juce::jmax(1.0, bpmRt.load(std::memory_order_relaxed));
+        const double bpmNow = getTempoAtBeat(newClip.startBeat);
         const double lengthSeconds = static_cast<double>(reader->lengthInSamples) / newClip.audioSampleRate;
-        newClip.lengthBeats = juce::jmax(0.25, lengthSeconds * (bpmNow / 60.0));
+        const double clipEndBeat = tempoMapIndex.beatAtSeconds(tempoMapIndex.secondsAtBeat(newClip.startBeat) + lengthSeconds);
+        newClip.lengthBeats = juce::jmax(0.25, clipEndBeat - newClip.startBeat);
 
         AcidLoopMetadata acidMeta;
         const bool hasAcidMeta = parseAcidMetadataFromWav(file, acidMeta);
@@ -8469,7 +8080,7 @@ namespace sampledex
             hideControl(toolbarMoreButton);
         }
 
-        const bool showPluginScanStatus = pluginScanProcess != nullptr;
+        const bool showPluginScanStatus = pluginScanner != nullptr && pluginScanner->isScanning();
         if (showPluginScanStatus && statusArea.getWidth() >= scaled(340))
         {
             auto scanArea = statusArea.removeFromLeft(scaled(320)).reduced(4, 3);
@@ -8725,22 +8336,22 @@ namespace sampledex
         recordingsDir.createDirectory();
         const auto timestampToken = juce::String(juce::Time::getCurrentTime().toMilliseconds());
 
-        const juce::ScopedLock audioLock(deviceManager.getAudioCallbackLock());
-        const int ringCapacitySamples = juce::jmax(maxRealtimeBlockSize * 32, 65536);
+        {
+            const juce::ScopedLock audioLock(deviceManager.getAudioCallbackLock());
+            recordCaptureRingActive = false;
+        }
+
+        const juce::ScopedLock fileLock(audioTakeFileLock);
+        bool anyTakeOpen = false;
         for (auto& take : audioTakeWriters)
         {
-            take.writer.reset();
+            take.takeFile.close();
             take.file = juce::File();
             take.active = false;
             take.inputPair = -1;
-            take.samplesWritten = 0;
             take.startBeat = startBeat;
             take.sampleRate = sampleRate;
             take.trackIndex = -1;
-            take.ringLeft.clear();
-            take.ringRight.clear();
-            take.ringFifo.reset();
-            take.droppedSamples.store(0, std::memory_order_relaxed);
             take.hadWriteError.store(false, std::memory_order_relaxed);
             take.writeErrorMessage.clear();
         }
@@ -8761,88 +8372,101 @@ namespace sampledex
             take.sampleRate = sampleRate;
             take.trackIndex = trackIndex;
 
-            auto fileOutput = take.file.createOutputStream();
-            if (fileOutput == nullptr || !fileOutput->openedOk())
-            {
-                take.writeErrorMessage = "Unable to open recording file for writing.";
-                take.file = juce::File();
-                continue;
-            }
-
-            juce::WavAudioFormat wavFormat;
-            juce::AudioFormatWriterOptions writerOptions;
-            writerOptions = writerOptions.withSampleRate(sampleRate)
-                                         .withNumChannels(2)
-                                         .withBitsPerSample(24);
-            std::unique_ptr<juce::OutputStream> outputStream(std::move(fileOutput));
-            auto writer = wavFormat.createWriterFor(outputStream, writerOptions);
-            if (writer == nullptr)
+            juce::String openError;
+            if (!take.takeFile.open(take.file, sampleRate, 2, openError))
             {
                 take.file.deleteFile();
-                take.writeErrorMessage = "Unable to create WAV writer for recording take.";
+                take.writeErrorMessage = openError;
                 take.file = juce::File();
                 continue;
             }
 
-            take.writer = std::move(writer);
-            take.ringLeft.assign(static_cast<size_t>(ringCapacitySamples), 0.0f);
-            take.ringRight.assign(static_cast<size_t>(ringCapacitySamples), 0.0f);
-            take.ringFifo = std::make_unique<juce::AbstractFifo>(ringCapacitySamples);
-            take.active = (take.writer != nullptr);
-            take.samplesWritten = 0;
+            take.active = true;
+            anyTakeOpen = true;
+        }
+
+        if (!anyTakeOpen)
+        {
+            recordCaptureRing.release();
+            return;
+        }
+
+        // One ring for every input channel, sized like a single take's ring used to be.
+        int inputChannels = 2;
+        {
+            const juce::ScopedLock audioLock(deviceManager.getAudioCallbackLock());
+            inputChannels = juce::jmax(2, liveInputCaptureBuffer.getNumChannels());
         }
+        recordCaptureRing.prepare(inputChannels, juce::jmax(maxRealtimeBlockSize * 32, 65536));
+        recordDeinterleaveLeft.assign(static_cast<size_t>(maxRealtimeBlockSize), 0.0f);
+        recordDeinterleaveRight.assign(static_cast<size_t>(maxRealtimeBlockSize), 0.0f);
+
+        const juce::ScopedLock audioLock(deviceManager.getAudioCallbackLock());
+        recordCaptureRingActive = true;
     }
 
     void MainComponent::flushAudioTakeRingBuffers(bool flushAllPending)
     {
-        for (auto& take : audioTakeWriters)
+        // Each block is de-interleaved once per distinct source pair; every take recording
+        // that pair appends the same samples. Nothing is allocated here.
+        const juce::ScopedLock fileLock(audioTakeFileLock);
+        if (!recordCaptureRing.isPrepared())
+            return;
+
+        const int scratchFrames = static_cast<int>(juce::jmin(recordDeinterleaveLeft.size(), recordDeinterleaveRight.size()));
+        if (scratchFrames <= 0)
+            return;
+
+        int blocksToRead = flushAllPending ? std::numeric_limits<int>::max() : recordCaptureRing.getNumBlocksReady();
+        InputCaptureRing::Block block;
+        while (blocksToRead-- > 0 && recordCaptureRing.peekBlock(block))
         {
-            if (take.writer == nullptr || take.ringFifo == nullptr)
-                continue;
+            const auto sourceForTake = [&block](const AudioTakeWriterState& take)
+            {
+                const int pairIndex = take.inputPair >= 0 ? take.inputPair : block.autoInputPair;
+                const int sourceLeft = juce::jlimit(0, block.numChannels - 1, pairIndex * 2);
+                const int sourceRight = sourceLeft + 1 < block.numChannels ? sourceLeft + 1 : sourceLeft;
+                return std::make_pair(sourceLeft, sourceRight);
+            };
 
-            while (take.ringFifo->getNumReady() > 0)
+            for (size_t takeIndex = 0; takeIndex < audioTakeWriters.size(); ++takeIndex)
             {
-                const int numReady = take.ringFifo->getNumReady();
-                if (numReady <= 0)
-                    break;
+                const auto& take = audioTakeWriters[takeIndex];
+                if (!take.active || !take.takeFile.isOpen())
+                    continue;
 
-                int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
-                take.ringFifo->prepareToRead(numReady, start1, size1, start2, size2);
-                if (size1 > 0)
+                const auto source = sourceForTake(take);
+                bool alreadyWritten = false;
+                for (size_t earlier = 0; earlier < takeIndex && !alreadyWritten; ++earlier)
                 {
-                    juce::AudioBuffer<float> writeBuffer(2, size1);
-                    std::memcpy(writeBuffer.getWritePointer(0), take.ringLeft.data() + start1, static_cast<size_t>(size1) * sizeof(float));
-                    std::memcpy(writeBuffer.getWritePointer(1), take.ringRight.data() + start1, static_cast<size_t>(size1) * sizeof(float));
-                    if (!take.writer->writeFromAudioSampleBuffer(writeBuffer, 0, size1))
-                    {
-                        take.hadWriteError.store(true, std::memory_order_relaxed);
-                        if (take.writeErrorMessage.isEmpty())
-                            take.writeErrorMessage = "Disk write failed (disk full or permission denied).";
-                        take.active = false;
-                        break;
-                    }
-                    take.samplesWritten += static_cast<int64>(size1);
+                    const auto& other = audioTakeWriters[earlier];
+                    alreadyWritten = other.active && other.takeFile.isOpen() && sourceForTake(other) == source;
                 }
-                if (size2 > 0)
+                if (alreadyWritten)
+                    continue;
+
+                for (int offset = 0; offset < block.numSamples; offset += scratchFrames)
                 {
-                    juce::AudioBuffer<float> writeBuffer(2, size2);
-                    std::memcpy(writeBuffer.getWritePointer(0), take.ringLeft.data() + start2, static_cast<size_t>(size2) * sizeof(float));
-                    std::memcpy(writeBuffer.getWritePointer(1), take.ringRight.data() + start2, static_cast<size_t>(size2) * sizeof(float));
-                    if (!take.writer->writeFromAudioSampleBuffer(writeBuffer, 0, size2))
+                    const int count = juce::jmin(scratchFrames, block.numSamples - offset);
+                    recordCaptureRing.copyPair(source.first, source.second, offset, count,
+                                               recordDeinterleaveLeft.data(), recordDeinterleaveRight.data());
+                    const float* const channels[] { recordDeinterleaveLeft.data(), recordDeinterleaveRight.data() };
+                    for (size_t sharing = takeIndex; sharing < audioTakeWriters.size(); ++sharing)
                     {
-                        take.hadWriteError.store(true, std::memory_order_relaxed);
-                        if (take.writeErrorMessage.isEmpty())
-                            take.writeErrorMessage = "Disk write failed (disk full or permission denied).";
-                        take.active = false;
-                        break;
+                        auto& target = audioTakeWriters[sharing];
+                        if (!target.active || !target.takeFile.isOpen() || sourceForTake(target) != source)
+                            continue;
+                        if (!target.takeFile.append(channels, count))
+                        {
+                            target.hadWriteError.store(true, std::memory_order_relaxed);
+                            if (target.writeErrorMessage.isEmpty())
+                                target.writeErrorMessage = "Disk write failed (disk full or permission denied).";
+                            target.active = false;
+                        }
                     }
-                    take.samplesWritten += static_cast<int64>(size2);
                 }
-                take.ringFifo->finishedRead(size1 + size2);
-
-                if (!flushAllPending)
-                    break;
             }
+            recordCaptureRing.popBlock();
         }
     }
 
@@ -8862,40 +8486,57 @@ namespace sampledex
         std::vector<ClosedTake> closedTakes;
         closedTakes.reserve(static_cast<size_t>(tracks.size()));
 
-        flushAudioTakeRingBuffers(true);
+        // Stop the callback feeding the ring first, so the final flush takes everything.
         {
             const juce::ScopedLock audioLock(deviceManager.getAudioCallbackLock());
+            recordCaptureRingActive = false;
+        }
+
+        {
+            const juce::ScopedLock fileLock(audioTakeFileLock);
+            flushAudioTakeRingBuffers(true);
+
+            const auto droppedSamples = static_cast<int64>(recordCaptureRing.getDroppedFrames());
+            if (recordCaptureRing.isPrepared())
+                juce::Logger::writeToLog("Recording input ring: peak "
+                                         + juce::String(juce::roundToInt(100.0 * recordCaptureRing.getHighWaterFrames()
+                                                                         / juce::jmax(1, recordCaptureRing.getCapacityFrames())))
+                                         + "%, " + juce::String(recordCaptureRing.getOverflowCount()) + " overflow(s)"
+                                         + (droppedSamples > 0 ? ", " + juce::String(droppedSamples) + " samples dropped" : juce::String()));
+
+            // Closing writes the header and trims the file; the callback is not held for it.
             for (auto& take : audioTakeWriters)
             {
-                if (!take.active && take.writer == nullptr)
+                if (!take.takeFile.isOpen())
                     continue;
 
+                const auto samplesWritten = static_cast<int64>(take.takeFile.getSamplesWritten());
+                const bool closedCleanly = take.takeFile.close();
+                if (!closedCleanly)
+                    juce::Logger::writeToLog("Recording take T" + juce::String(take.trackIndex + 1) + ": write failed");
+
                 ClosedTake closed;
                 closed.file = take.file;
                 closed.trackIndex = take.trackIndex;
-                closed.samplesWritten = take.samplesWritten;
+                closed.samplesWritten = samplesWritten;
                 closed.startBeat = take.startBeat;
                 closed.endBeat = endBeat;
                 closed.sampleRate = take.sampleRate;
-                closed.hadError = take.hadWriteError.load(std::memory_order_relaxed)
-                                  || take.droppedSamples.load(std::memory_order_relaxed) > 0;
+                closed.hadError = !closedCleanly
+                                  || take.hadWriteError.load(std::memory_order_relaxed)
+                                  || droppedSamples > 0;
                 closedTakes.push_back(std::move(closed));
 
-                take.writer.reset();
                 take.file = juce::File();
                 take.active = false;
                 take.inputPair = -1;
-                take.samplesWritten = 0;
                 take.startBeat = 0.0;
                 take.sampleRate = 44100.0;
                 take.trackIndex = -1;
-                take.ringLeft.clear();
-                take.ringRight.clear();
-                take.ringFifo.reset();
-                take.droppedSamples.store(0, std::memory_order_relaxed);
                 take.hadWriteError.store(false, std::memory_order_relaxed);
                 take.writeErrorMessage.clear();
             }
+            recordCaptureRing.release();
         }
 
         for (const auto& take : closedTakes)
@@ -8922,7 +8563,7 @@ namespace sampledex
             Clip clip;
             clip.type = ClipType::Audio;
             clip.name = "Audio Take " + juce::String(recordingTakeCounter++);
-            clip.startBeat = juce::jmax(0.0, take.startBeat + preRollSafetyBeats - recordingLatencyCompensationBeats);
+            clip.startBeat = juce::jmax(0.0, take.startBeat + preRollSafetyBeats - recordingAudioLatencyCompensationBeats);
             clip.lengthBeats = clipDurationBeats;
             clip.trackIndex = take.trackIndex;
             clip.audioData.reset();
@@ -8960,14 +8601,22 @@ namespace sampledex
         }
 
         const int manualOffsetSamples = recordingManualOffsetSamples;
-        const int latencySamples = juce::jmax(0, inputLatencySamples + manualOffsetSamples);
+        // The player hears the session late by the master limiter's lookahead as well.
+        const int masterLookaheadSamples = getMasterLatencySamples();
+        const int latencySamples = juce::jmax(0, inputLatencySamples + masterLookaheadSamples + manualOffsetSamples);
         recordingSafetyPreRollSamples = juce::jmax(0, blockSizeSamples * juce::jmax(1, recordingSafetyPreRollBlocks));
         recordingSafetyPreRollSamplesRt.store(recordingSafetyPreRollSamples, std::memory_order_relaxed);
         recordingLatencyCompensationSamplesRt.store(latencySamples, std::memory_order_relaxed);
 
+        // A measured round trip also covers output latency and anything the driver misreports.
+        const int calibratedRoundTrip = getCalibratedRoundTripSamples();
+        const int audioLatencySamples = juce::jmax(0, (calibratedRoundTrip >= 0 ? calibratedRoundTrip : inputLatencySamples)
+                                                      + masterLookaheadSamples + manualOffsetSamples);
+
         const double currentTempo = juce::jmax(1.0, transport.getTempo());
         const double sampleRate = juce::jmax(1.0, sampleRateRt.load(std::memory_order_relaxed));
         recordingLatencyCompensationBeats = (static_cast<double>(latencySamples) / sampleRate) * (currentTempo / 60.0);
+        recordingAudioLatencyCompensationBeats = (static_cast<double>(audioLatencySamples) / sampleRate) * (currentTempo / 60.0);
 
         const double preRollSafetyBeats = (static_cast<double>(recordingSafetyPreRollSamples) / sampleRate) * (currentTempo / 60.0);
         const double writerStartBeat = juce::jmax(0.0, recordingStartBeat - preRollSafetyBeats);
@@ -9745,6 +9394,74 @@ namespace sampledex
         refreshStatusText();
     }
 
+    void MainComponent::startLatencyCalibration()
+    {
+        auto* device = deviceManager.getCurrentAudioDevice();
+        if (device == nullptr || activeInputChannelCountRt.load(std::memory_order_relaxed) <= 0)
+        {
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                                                   "Measure Latency",
+                                                   "Select an audio device with an enabled input first.");
+            return;
+        }
+        if (transport.playing() || latencyCalibrator.isRunning())
+            return;
+
+        bool started = false;
+        {
+            const juce::ScopedLock audioLock(deviceManager.getAudioCallbackLock());
+            started = latencyCalibrator.start(juce::jmax(1.0, device->getCurrentSampleRate()));
+        }
+        if (started)
+        {
+            latencyCalibrationStartedMs = juce::Time::getMillisecondCounterHiRes();
+            refreshStatusText();
+        }
+    }
+
+    void MainComponent::finishLatencyCalibration()
+    {
+        const auto result = latencyCalibrator.analyse();
+        const auto key = getLatencyCalibrationKey();
+        juce::Logger::writeToLog("Latency calibration (" + key + "): " + result.message);
+        if (!result.ok || key.isEmpty())
+        {
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Measure Latency", result.message);
+            return;
+        }
+
+        calibratedRoundTripSamples[key] = result.latencySamples;
+        saveStartupPreferences();
+        refreshStatusText();
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
+                                               "Measure Latency",
+                                               result.message + ". Recorded audio on this device will be moved back by this much.");
+    }
+
+    juce::String MainComponent::getLatencyCalibrationKey() const
+    {
+        auto* device = deviceManager.getCurrentAudioDevice();
+        if (device == nullptr)
+            return {};
+        // The round trip changes with rate and buffer size, so each gets its own measurement.
+        return device->getTypeName() + "/" + device->getName()
+             + "@" + juce::String(juce::roundToInt(device->getCurrentSampleRate()))
+             + "/" + juce::String(device->getCurrentBufferSizeSamples());
+    }
+
+    int MainComponent::getCalibratedRoundTripSamples() const
+    {
+        const auto it = calibratedRoundTripSamples.find(getLatencyCalibrationKey());
+        return it != calibratedRoundTripSamples.end() ? it->second : -1;
+    }
+
+    int MainComponent::getMasterLatencySamples() const
+    {
+        return masterLimiterEnabledRt.load(std::memory_order_relaxed)
+            ? masterLimiterLatencySamplesRt.load(std::memory_order_relaxed)
+            : 0;
+    }
+
     void MainComponent::clearInputPeakHolds()
     {
         for (auto* track : tracks)
@@ -9977,81 +9694,35 @@ namespace sampledex
         return ordered;
     }
 
-    void MainComponent::applyDeadMansPedalBlacklist(const juce::String& scanFormatName)
+    void MainComponent::handlePluginScanResult(const PluginScanDatabase::Entry& entry, bool previouslyFailed)
     {
-        if (!pluginScanDeadMansPedalFile.existsAsFile())
+        const auto displayFormat = scanFormatDisplayName(entry.formatName);
+        juce::PluginDescription scannedFile;
+        scannedFile.pluginFormatName = entry.formatName;
+        scannedFile.fileOrIdentifier = entry.fileOrIdentifier;
+        scannedFile.name = juce::File::isAbsolutePath(entry.fileOrIdentifier)
+            ? juce::File(entry.fileOrIdentifier).getFileNameWithoutExtension()
+            : entry.fileOrIdentifier;
+
+        if (entry.status == PluginScanDatabase::Status::Scanned)
+        {
+            // A changed binary that now scans cleanly gets another chance.
+            if (previouslyFailed)
+                unquarantinePlugin(scannedFile);
             return;
-
-        juce::StringArray deadmanEntries;
-        deadmanEntries.addLines(pluginScanDeadMansPedalFile.loadFileAsString());
-        for (auto entry : deadmanEntries)
-        {
-            entry = entry.trim();
-            if (entry.isEmpty())
-                continue;
-            pluginScanBlacklistedItems.addIfNotAlreadyThere(scanFormatDisplayName(scanFormatName)
-                                                            + ": " + entry);
         }
 
-        if (knownPluginListFile.existsAsFile())
-        {
-            if (std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(knownPluginListFile)); xml != nullptr)
-                knownPluginList.recreateFromXml(*xml);
-        }
-
-        juce::PluginDirectoryScanner::applyBlacklistingsFromDeadMansPedal(knownPluginList,
-                                                                           pluginScanDeadMansPedalFile);
-        pluginScanDeadMansPedalFile.deleteFile();
-
-        if (std::unique_ptr<juce::XmlElement> xml(knownPluginList.createXml()); xml != nullptr)
-            xml->writeTo(knownPluginListFile);
-    }
-
-    void MainComponent::handlePluginScanPassResult(int exitCode, const juce::String& output, bool timedOut)
-    {
-        const auto currentFormat = activeScanFormat;
-        const auto displayFormat = scanFormatDisplayName(currentFormat);
-        juce::StringArray lines;
-        lines.addLines(output);
-
-        for (auto line : lines)
-        {
-            line = line.trim();
-            if (line.startsWithIgnoreCase("FAILED:"))
-            {
-                const auto failedPath = line.fromFirstOccurrenceOf("FAILED:", false, false).trim();
-                if (failedPath.isNotEmpty())
-                    pluginScanFailedItems.addIfNotAlreadyThere(displayFormat + ": " + failedPath);
-                continue;
-            }
-
-            if (line.startsWithIgnoreCase("BLACKLISTED:"))
-            {
-                auto blacklistedItem = line.fromFirstOccurrenceOf("BLACKLISTED:", false, false).trim();
-                if (blacklistedItem.contains(":"))
-                    blacklistedItem = blacklistedItem.fromFirstOccurrenceOf(":", false, false).trim();
-                if (blacklistedItem.isNotEmpty())
-                    pluginScanBlacklistedItems.addIfNotAlreadyThere(displayFormat + ": " + blacklistedItem);
-            }
-        }
-
-        if (timedOut)
-        {
-            pluginScanFailedItems.addIfNotAlreadyThere(displayFormat
-                + ": scan pass timed out after "
-                + juce::String(pluginScanPassTimeoutMs) + " ms");
-        }
-        else if (exitCode != 0)
-        {
-            pluginScanFailedItems.addIfNotAlreadyThere(displayFormat
-                + ": scan pass exited with code "
-                + juce::String(exitCode));
-        }
+        pluginScanFailedItems.addIfNotAlreadyThere(displayFormat + ": " + scannedFile.name
+                                                   + " (" + entry.failureReason + ")");
+        if (entry.status == PluginScanDatabase::Status::Failed || !pluginSafetyGuardsEnabled)
+            return;
 
-        if (timedOut || exitCode != 0)
-            applyDeadMansPedalBlacklist(currentFormat);
-        else
-            pluginScanDeadMansPedalFile.deleteFile();
+        // A scan crash or hang counts against the plugin like a host failure does.
+        auto& stats = pluginStabilityById[getPluginIdentity(scannedFile)];
+        ++stats.crashCount;
+        stats.lastCrashSummary = "Plugin scan " + entry.failureReason + ".";
+        quarantinePlugin(scannedFile, stats.lastCrashSummary);
+        pluginScanBlacklistedItems.addIfNotAlreadyThere(displayFormat + ": " + scannedFile.name);
     }
 
     void MainComponent::recordLastLoadedPlugin(const juce::PluginDescription& desc)
@@ -10537,50 +10208,7 @@ namespace sampledex
                                      device != nullptr ? device->getCurrentSampleRate() : 44100.0);
         const int bs = juce::jlimit(64, 4096,
                                     device != nullptr ? device->getCurrentBufferSizeSamples() : 512);
-
-        const juce::String command = executable.getFullPathName().quoted()
-                                   + " --plugin-probe"
-                                   + " --format=" + desc.pluginFormatName.quoted()
-                                   + " --id=" + desc.fileOrIdentifier.quoted()
-                                   + " --name=" + desc.name.quoted()
-                                   + " --mfr=" + desc.manufacturerName.quoted()
-                                   + " --uid2=" + juce::String::toHexString(desc.uniqueId)
-                                   + " --uid=" + juce::String::toHexString(desc.deprecatedUid)
-                                   + " --instrument=" + juce::String(instrumentPlugin ? 1 : 0)
-                                   + " --sr=" + juce::String(sr, 5)
-                                   + " --bs=" + juce::String(bs);
-
-        juce::ChildProcess probe;
-        if (!probe.start(command))
-        {
-            errorMessage = "Plugin probe failed: unable to launch isolation process.";
-            return false;
-        }
-
-        if (!probe.waitForProcessToFinish(12000))
-        {
-            probe.kill();
-            errorMessage = "Plugin probe timed out.";
-            return false;
-        }
-
-        const auto exitCode = probe.getExitCode();
-        const juce::String output = probe.readAllProcessOutput().trim();
-        if (exitCode != 0)
-        {
-            errorMessage = "Plugin isolation probe failed."
-                         + (output.isNotEmpty() ? ("\n" + output) : juce::String());
-            return false;
-        }
-
-        if (!output.startsWithIgnoreCase("OK"))
-        {
-            errorMessage = "Plugin isolation probe returned an unexpected result."
-                         + (output.isNotEmpty() ? ("\n" + output) : juce::String());
-            return false;
-        }
-
-        return true;
+        return runPluginProbeProcess(executable, desc, instrumentPlugin, sr, bs, errorMessage);
     }
 
     juce::String MainComponent::getLatencySummaryText() const
@@ -10617,16 +10245,26 @@ namespace sampledex
         const int graphPdcSamples = juce::jmax(maxPluginLatencySamples,
                                                maxPdcLatencySamplesRt.load(std::memory_order_relaxed));
 
-        const int captureCompSamples = juce::jmax(0, inputLatencySamples + recordingManualOffsetSamples);
+        const int masterLookaheadSamples = getMasterLatencySamples();
+        const int calibratedRoundTrip = getCalibratedRoundTripSamples();
+        const int captureCompSamples = juce::jmax(0, (calibratedRoundTrip >= 0 ? calibratedRoundTrip : inputLatencySamples)
+                                                     + recordingManualOffsetSamples + masterLookaheadSamples);
+        const juce::String measuredText = latencyCalibrator.isRunning()
+            ? juce::String("measuring...")
+            : (calibratedRoundTrip >= 0
+                   ? juce::String(calibratedRoundTrip) + " (" + juce::String(toMs(calibratedRoundTrip), 2) + "ms)"
+                   : juce::String("not measured"));
         return "Latency: In " + juce::String(inputLatencySamples) + " (" + juce::String(toMs(inputLatencySamples), 2) + "ms)"
              + "  Out " + juce::String(outputLatencySamples) + " (" + juce::String(toMs(outputLatencySamples), 2) + "ms)"
              + "  RTL " + juce::String(roundTripSamples) + " (" + juce::String(toMs(roundTripSamples), 2) + "ms)"
+             + "  Measured " + measuredText
              + "  |  RecComp " + juce::String(captureCompSamples) + " (" + juce::String(toMs(captureCompSamples), 2) + "ms)"
              + "  Manual " + juce::String(recordingManualOffsetSamples) + " smp"
              + "  |  SR " + juce::String(sampleRate, 0) + "  Buf " + juce::String(bufferSamples)
              + "  |  PDC Sel " + juce::String(selectedTrackLatencySamples) + " (" + juce::String(toMs(selectedTrackLatencySamples), 2) + "ms)"
              + "  AuxMax " + juce::String(maxAuxInsertLatencySamples) + " (" + juce::String(toMs(maxAuxInsertLatencySamples), 2) + "ms)"
              + "  Graph " + juce::String(graphPdcSamples) + " (" + juce::String(toMs(graphPdcSamples), 2) + "ms)"
+             + "  Master " + juce::String(masterLookaheadSamples) + " (" + juce::String(toMs(masterLookaheadSamples), 2) + "ms)"
              + "  |  Safe " + (monitorSafeMode ? juce::String("ON") : juce::String("OFF"));
     }
 
@@ -10909,9 +10547,41 @@ namespace sampledex
             return;
         }
 
+        constexpr int deliverableSetId = 100;
+        if (findWritableExportFormatForExtension("wav") != nullptr)
+        {
+            menu.addSeparator();
+            menu.addItem(deliverableSetId, "WAV Deliverables (24-bit + 32-bit float + 16-bit 44.1 kHz)");
+        }
+
+        // Applies to whichever mixdown is picked next, and is remembered.
+        constexpr int loudnessBaseId = 200;
+        const std::array<float, 4> loudnessTargets { 0.0f, -14.0f, -16.0f, -23.0f };
+        const std::array<const char*, 4> loudnessLabels { "Off", "-14 LUFS (streaming)", "-16 LUFS", "-23 LUFS (EBU R128)" };
+        juce::PopupMenu loudnessMenu;
+        for (size_t i = 0; i < loudnessTargets.size(); ++i)
+            loudnessMenu.addItem(loudnessBaseId + static_cast<int>(i),
+                                 loudnessLabels[i],
+                                 true,
+                                 std::abs(exportLoudnessTargetLufs - loudnessTargets[i]) < 0.01f);
+        menu.addSeparator();
+        menu.addSubMenu("Normalise Loudness (true peak " + juce::String(exportTruePeakCeilingDb, 1) + " dBTP)", loudnessMenu);
+
         menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&exportButton),
-                           [this, availableFormats](int selectedId)
+                           [this, availableFormats, loudnessTargets](int selectedId)
                            {
+                               if (selectedId == deliverableSetId)
+                               {
+                                   beginMixdownExportForFormat("wav", true);
+                                   return;
+                               }
+                               if (selectedId >= loudnessBaseId && selectedId < loudnessBaseId + static_cast<int>(loudnessTargets.size()))
+                               {
+                                   exportLoudnessTargetLufs = loudnessTargets[static_cast<size_t>(selectedId - loudnessBaseId)];
+                                   saveStartupPreferences();
+                                   exportMixdown();
+                                   return;
+                               }
                                if (selectedId <= 0 || selectedId > static_cast<int>(availableFormats.size()))
                                    return;
                                beginMixdownExportForFormat(availableFormats[static_cast<size_t>(selectedId - 1)].extension);
@@ -10967,14 +10637,23 @@ namespace sampledex
         outSettings.loopRangeOnly = transport.isLooping();
         outSettings.includeMasterProcessing = !exportingStems;
         outSettings.enableDither = outSettings.bitDepth < 24;
+        outSettings.includeBusStems = exportingStems && stemExportIncludeBuses;
+        outSettings.loudnessTargetLufs = exportingStems ? 0.0f : exportLoudnessTargetLufs;
+        outSettings.truePeakCeilingDb = exportTruePeakCeilingDb;
         return true;
     }
 
-    void MainComponent::beginMixdownExportForFormat(const juce::String& formatExtension)
+    void MainComponent::beginMixdownExportForFormat(const juce::String& formatExtension, bool withDeliverableSet)
     {
         ExportSettings settings;
         if (!promptForExportSettings(formatExtension, false, settings))
             return;
+        if (withDeliverableSet)
+        {
+            // One render feeds all three files.
+            settings.extraDeliverables.push_back({ "wav", 0.0, 32, false, " (32f)" });
+            settings.extraDeliverables.push_back({ "wav", 44100.0, 16, true, " (16-bit 44.1k)" });
+        }
 
         const auto documentsDir = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory);
 
@@ -10996,19 +10675,7 @@ namespace sampledex
                                            if (selectedFile == juce::File{})
                                                return;
 
-                                           if (!runOfflineExport(selectedFile,
-                                                                 false,
-                                                                 formatExtension,
-                                                                 settings.sampleRate,
-                                                                 settings.bitDepth,
-                                                                 settings.loopRangeOnly,
-                                                                 settings.includeMasterProcessing,
-                                                                 settings.enableDither))
-                                               return;
-
-                                           juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
-                                                                                  "Export Complete",
-                                                                                  "Mixdown exported to:\n" + selectedFile.getFullPathName());
+                                           runOfflineExport(selectedFile, false, formatExtension, settings);
                                        });
     }
 
@@ -11037,19 +10704,7 @@ namespace sampledex
                                            if (selectedFolder == juce::File{})
                                                return;
 
-                                           if (!runOfflineExport(selectedFolder,
-                                                                 true,
-                                                                 formatExtension,
-                                                                 settings.sampleRate,
-                                                                 settings.bitDepth,
-                                                                 settings.loopRangeOnly,
-                                                                 settings.includeMasterProcessing,
-                                                                 settings.enableDither))
-                                               return;
-
-                                           juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
-                                                                                  "Export Complete",
-                                                                                  "Stems exported to:\n" + selectedFolder.getFullPathName());
+                                           runOfflineExport(selectedFolder, true, formatExtension, settings);
                                        });
     }
 
@@ -11077,93 +10732,410 @@ namespace sampledex
         return format;
     }
 
-    bool MainComponent::renderOfflinePassToWriter(juce::AudioFormatWriter& writer,
-                                                   double startBeat,
-                                                   double endBeat,
-                                                   double exportSampleRate,
-                                                   int targetBitDepth,
-                                                   bool enableDither,
-                                                   std::atomic<bool>* cancelFlag,
-                                                   std::function<void(float)> progressCallback)
+    bool MainComponent::renderOfflinePassToSinks(IsolatedRenderEngine& engine,
+                                                  ExportSinkPipeline* sinks,
+                                                  const IsolatedRenderEngine::Pass& pass,
+                                                  int targetBitDepth,
+                                                  bool enableDither,
+                                                  std::atomic<bool>* cancelFlag,
+                                                  std::function<void(const OfflineRenderProgress&)> progressCallback)
     {
-        if (endBeat <= startBeat)
-            return false;
+        auto* stemCapture = pass.stemCapture;
+        if (sinks != nullptr)
+            sinks->start();
+        bool rendered = engine.renderPass(
+            pass,
+            [&](juce::AudioBuffer<float>& block, int numSamples)
+            {
+                if (stemCapture != nullptr
+                    && !stemCapture->writeBlock(numSamples,
+                                                [&](juce::AudioBuffer<float>& stemBlock, int stemSamples, std::uint32_t& stemDitherState)
+                                                {
+                                                    if (enableDither)
+                                                        ExportSinkPipeline::applyTpdfDither(stemBlock, 0, stemSamples, targetBitDepth, stemDitherState);
+                                                }))
+                    return false;
+                return sinks == nullptr || sinks->push(block, numSamples);
+            },
+            cancelFlag,
+            progressCallback);
+
+        // A stopped render stops the encoders too; either way every file gets closed.
+        if (sinks != nullptr)
+        {
+            if (!rendered)
+                sinks->cancel();
+            rendered = sinks->finish() && rendered;
+        }
+
+        const auto& result = engine.getLastProgress();
+        const double renderSampleRate = engine.getSampleRate();
+        juce::Logger::writeToLog("Offline render " + juce::String(rendered ? "finished" : "stopped")
+                                 + ": " + juce::String(static_cast<double>(result.samplesRendered) / renderSampleRate, 1) + " s in "
+                                 + juce::String(result.elapsedSeconds, 2) + " s ("
+                                 + juce::String(result.speedFactor, 1) + "x realtime, block "
+                                 + juce::String(engine.getBlockSize()) + ", "
+                                 + juce::String(engine.getLastWorkerCount()) + " graph workers"
+                                 + (sinks != nullptr ? ", " + juce::String(sinks->getNumSinks()) + " encoder(s), "
+                                                           + juce::String(sinks->getRenderWaitSeconds(), 2) + " s waiting on encoders"
+                                                     : juce::String())
+                                 + ")");
+        return rendered;
+    }
 
-        const double bpmValue = juce::jmax(1.0, bpmRt.load(std::memory_order_relaxed));
-        const double secondsPerBeat = 60.0 / bpmValue;
-        const double contentSeconds = (endBeat - startBeat) * secondsPerBeat;
-        const double tailSeconds = 2.0;
-        const int64_t totalSamples = static_cast<int64_t>(std::ceil((contentSeconds + tailSeconds) * exportSampleRate));
-        if (totalSamples <= 0)
-            return false;
+    std::unique_ptr<Track> MainComponent::createTrackClone(const Track& source,
+                                                           const juce::String& cloneName,
+                                                           juce::AudioPlayHead* playHead,
+                                                           double sampleRate,
+                                                           int blockSize,
+                                                           bool recordLoadedPlugins,
+                                                           juce::String& firstLoadError,
+                                                           std::vector<DeferredPluginLoad>* deferredPluginLoads)
+    {
+        auto clonedTrack = std::make_unique<Track>(cloneName, formatManager);
+        clonedTrack->setTransportPlayHead(playHead);
+        clonedTrack->setVolume(source.getVolume());
+        clonedTrack->setPan(source.getPan());
+        clonedTrack->setSendLevel(source.getSendLevel());
+        clonedTrack->setSendTapMode(source.getSendTapMode());
+        clonedTrack->setSendTargetBus(source.getSendTargetBus());
+        clonedTrack->setMute(source.isMuted());
+        clonedTrack->setSolo(source.isSolo());
+        clonedTrack->setArm(false);
+        clonedTrack->setInputMonitoring(false);
+        clonedTrack->setInputSourcePair(source.getInputSourcePair());
+        clonedTrack->setMonitorTapMode(source.getMonitorTapMode());
+        clonedTrack->setInputMonitorGain(source.getInputMonitorGain());
+        clonedTrack->setChannelType(source.getChannelType());
+        clonedTrack->setOutputTargetType(source.getOutputTargetType());
+        clonedTrack->setOutputTargetBus(source.getOutputTargetBus());
+        clonedTrack->setEqEnabled(source.isEqEnabled());
+        clonedTrack->setEqBandGains(source.getEqLowGainDb(),
+                                    source.getEqMidGainDb(),
+                                    source.getEqHighGainDb());
+        clonedTrack->setBuiltInEffectsMask(source.getBuiltInEffectsMask());
+        clonedTrack->prepareToPlay(sampleRate > 0.0 ? sampleRate : 44100.0, juce::jmax(128, blockSize));
 
-        static constexpr int renderBlockSize = 1024;
-        juce::AudioBuffer<float> renderBlock(2, renderBlockSize);
+        // Bridged slots stay bridged in the copy.
+        clonedTrack->setPluginHostingPolicyForSlot(Track::instrumentSlotIndex,
+                                                   source.getPluginHostingPolicyForSlot(Track::instrumentSlotIndex));
+        for (int slot = 0; slot < source.getPluginSlotCount(); ++slot)
+            clonedTrack->setPluginHostingPolicyForSlot(slot, source.getPluginHostingPolicyForSlot(slot));
+
+        const auto deferPluginLoad = [&](int slot, const juce::PluginDescription& description)
+        {
+            DeferredPluginLoad load;
+            load.slotIndex = slot;
+            load.description = description;
+            load.state = source.getPluginStateBlobForSlot(slot);
+            load.bypassed = source.isPluginSlotBypassed(slot);
+            load.pendingToken = clonedTrack->beginPendingPluginLoad(slot, description);
+            deferredPluginLoads->push_back(std::move(load));
+        };
 
-        midiCollector.reset(exportSampleRate);
-        midiScheduler.reset();
-        offlineRenderActiveRt.store(true, std::memory_order_relaxed);
-        for (auto* track : tracks)
+        juce::PluginDescription instrumentDescription;
+        if (source.getPluginDescriptionForSlot(Track::instrumentSlotIndex, instrumentDescription))
         {
-            if (track != nullptr)
+            juce::String error;
+            if (deferredPluginLoads != nullptr)
+            {
+                deferPluginLoad(Track::instrumentSlotIndex, instrumentDescription);
+            }
+            else if (!clonedTrack->loadInstrumentPlugin(instrumentDescription, error))
+            {
+                if (firstLoadError.isEmpty() && error.isNotEmpty())
+                    firstLoadError = error;
+            }
+            else
             {
-                track->setPluginsNonRealtime(true);
-                track->panic();
+                const auto instrumentState = source.getPluginStateBlobForSlot(Track::instrumentSlotIndex);
+                if (!instrumentState.isEmpty()
+                    && !clonedTrack->setPluginStateForSlot(Track::instrumentSlotIndex, instrumentState)
+                    && firstLoadError.isEmpty())
+                {
+                    firstLoadError = "Instrument state restore failed for track copy.";
+                }
+                clonedTrack->setPluginSlotBypassed(Track::instrumentSlotIndex,
+                                                   source.isPluginSlotBypassed(Track::instrumentSlotIndex));
+                if (recordLoadedPlugins)
+                    recordLastLoadedPlugin(instrumentDescription);
+            }
+        }
+        else
+        {
+            const auto mode = source.getBuiltInInstrumentMode();
+            if (mode == Track::BuiltInInstrument::None)
+            {
+                clonedTrack->disableBuiltInInstrument();
+            }
+            else if (mode == Track::BuiltInInstrument::Sampler)
+            {
+                const auto samplePath = source.getSamplerSamplePath();
+                if (samplePath.isNotEmpty())
+                {
+                    juce::String error;
+                    if (!clonedTrack->loadSamplerSoundFromFile(juce::File(samplePath), error))
+                    {
+                        if (firstLoadError.isEmpty() && error.isNotEmpty())
+                            firstLoadError = error;
+                    }
+                }
+                else
+                {
+                    clonedTrack->useBuiltInSynthInstrument();
+                }
+            }
+            else
+            {
+                clonedTrack->useBuiltInSynthInstrument();
             }
         }
-        panicRequestedRt.store(true, std::memory_order_relaxed);
 
-        struct OfflineRenderScope
+        for (int slot = 0; slot < source.getPluginSlotCount(); ++slot)
         {
-            MainComponent& owner;
-            ~OfflineRenderScope()
+            juce::PluginDescription description;
+            if (!source.getPluginDescriptionForSlot(slot, description))
+                continue;
+            if (deferredPluginLoads != nullptr)
             {
-                owner.offlineRenderActiveRt.store(false, std::memory_order_relaxed);
-                for (auto* track : owner.tracks)
-                    if (track != nullptr)
-                        track->setPluginsNonRealtime(false);
+                deferPluginLoad(slot, description);
+                continue;
             }
-        } offlineRenderScope { *this };
 
-        transport.stop();
-        transport.setPosition(startBeat);
-        transport.play();
+            juce::String error;
+            if (!clonedTrack->loadPluginInSlot(slot, description, error))
+            {
+                if (firstLoadError.isEmpty() && error.isNotEmpty())
+                    firstLoadError = error;
+                continue;
+            }
 
-        std::uint32_t ditherState = 0x51ed270bu;
-        int64_t samplesRendered = 0;
-        while (samplesRendered < totalSamples)
-        {
-            if (cancelFlag != nullptr && cancelFlag->load(std::memory_order_relaxed))
+            const auto state = source.getPluginStateBlobForSlot(slot);
+            if (!state.isEmpty()
+                && !clonedTrack->setPluginStateForSlot(slot, state)
+                && firstLoadError.isEmpty())
             {
-                transport.stop();
-                return false;
+                firstLoadError = "Insert state restore failed for track copy (slot "
+                               + juce::String(slot + 1) + ").";
             }
+            clonedTrack->setPluginSlotBypassed(slot, source.isPluginSlotBypassed(slot));
+            if (recordLoadedPlugins)
+                recordLastLoadedPlugin(description);
+        }
+
+        return clonedTrack;
+    }
 
-            const int numSamples = static_cast<int>(juce::jmin<int64_t>(renderBlockSize, totalSamples - samplesRendered));
-            renderBlock.clear();
-            juce::AudioSourceChannelInfo blockInfo(&renderBlock, 0, numSamples);
-            getNextAudioBlock(blockInfo);
-            if (enableDither)
-                applyTpdfDither(renderBlock, 0, numSamples, targetBitDepth, ditherState);
-            if (!writer.writeFromAudioSampleBuffer(renderBlock, 0, numSamples))
+    void MainComponent::createIsolatedRenderEngine(const std::vector<int>& trackIndices,
+                                                   int bounceTrackIndex,
+                                                   double renderSampleRate,
+                                                   IsolatedRenderEngineReadyFn onReady,
+                                                   std::atomic<bool>* cancelFlag)
+    {
+        // Shared with the plugin requests; the engine is built when the last one lands.
+        struct Build
+        {
+            std::unique_ptr<IsolatedRenderProject> project;
+            IsolatedRenderEngineReadyFn onReady;
+            std::atomic<bool>* cancelFlag = nullptr;
+            juce::AudioFormatManager* audioFormats = nullptr;
+            OfflineRenderSettings settings;
+            double sampleRate = 44100.0;
+            int pendingLoads = 0;
+            bool finished = false;
+
+            bool isCancelled() const noexcept
             {
-                transport.stop();
-                return false;
+                return cancelFlag != nullptr && cancelFlag->load(std::memory_order_relaxed);
+            }
+
+            void finish(const juce::String& error)
+            {
+                if (finished)
+                    return;
+                finished = true;
+                auto ready = std::move(onReady);
+                if (error.isNotEmpty() || isCancelled())
+                {
+                    project.reset();
+                    ready(nullptr, isCancelled() ? juce::String() : error);
+                    return;
+                }
+
+                auto engine = std::make_unique<IsolatedRenderEngine>(std::move(project), *audioFormats, settings);
+                engine->prepare(sampleRate);
+                ready(std::move(engine), {});
             }
-            samplesRendered += numSamples;
+        };
+
+        auto build = std::make_shared<Build>();
+        build->project = std::make_unique<IsolatedRenderProject>();
+        build->onReady = std::move(onReady);
+        build->cancelFlag = cancelFlag;
+        build->audioFormats = &audioFormatManager;
+        build->settings = offlineRenderSettings;
+        build->sampleRate = renderSampleRate;
+
+        struct CloneLoad
+        {
+            Track* clone = nullptr;
+            juce::String trackName;
+            DeferredPluginLoad load;
+        };
+        std::vector<CloneLoad> cloneLoads;
+        auto* project = build->project.get();
+        std::array<int, static_cast<size_t>(maxRealtimeTracks)> cloneIndexForTrack {};
+        cloneIndexForTrack.fill(-1);
+        const int blockSize = offlineRenderSettings.getResolvedBlockSize();
+
+        for (const int trackIndex : trackIndices)
+        {
+            if (!juce::isPositiveAndBelow(trackIndex, juce::jmin(tracks.size(), maxRealtimeTracks))
+                || tracks[trackIndex] == nullptr)
+                continue;
 
-            if (progressCallback)
+            const auto& source = *tracks[trackIndex];
+            bool loadPending = source.isPluginSlotLoadPending(Track::instrumentSlotIndex);
+            for (int slot = 0; slot < source.getPluginSlotCount() && !loadPending; ++slot)
+                loadPending = source.isPluginSlotLoadPending(slot);
+            if (loadPending)
             {
-                const float progress = static_cast<float>(static_cast<double>(samplesRendered)
-                                                          / static_cast<double>(juce::jmax<int64_t>(1, totalSamples)));
-                progressCallback(juce::jlimit(0.0f, 1.0f, progress));
+                build->finish("Plugins on \"" + source.getTrackName() + "\" are still loading. Try again once they are ready.");
+                return;
+            }
+
+            juce::String loadError;
+            std::vector<DeferredPluginLoad> deferredLoads;
+            auto clone = createTrackClone(source, source.getTrackName(), nullptr, renderSampleRate, blockSize, false, loadError, &deferredLoads);
+            if (loadError.isNotEmpty())
+            {
+                build->finish("Unable to copy \"" + source.getTrackName() + "\" for rendering:\n" + loadError);
+                return;
             }
+            for (auto& load : deferredLoads)
+                cloneLoads.push_back({ clone.get(), source.getTrackName(), std::move(load) });
+
+            const bool bounceTarget = trackIndex == bounceTrackIndex;
+            clone->setFrozenPlaybackOnly(!bounceTarget && source.isFrozenPlaybackOnly());
+            clone->setFrozenRenderPath(bounceTarget ? juce::String() : source.getFrozenRenderPath());
+            cloneIndexForTrack[static_cast<size_t>(trackIndex)] = static_cast<int>(project->tracks.size());
+            project->tracks.push_back(std::move(clone));
         }
 
-        transport.stop();
-        if (progressCallback)
-            progressCallback(1.0f);
-        return true;
+        if (project->tracks.empty())
+        {
+            build->finish("No tracks available to render.");
+            return;
+        }
+
+        const juce::String bounceFrozenPath = juce::isPositiveAndBelow(bounceTrackIndex, tracks.size())
+            ? tracks[bounceTrackIndex]->getFrozenRenderPath()
+            : juce::String();
+        // A bounce renders the track itself, not its previous freeze.
+        const auto isBounceFreezeClip = [bounceTrackIndex, bounceFrozenPath](const Clip& clip)
+        {
+            return clip.trackIndex == bounceTrackIndex
+                && clip.type == ClipType::Audio
+                && ((bounceFrozenPath.isNotEmpty() && clip.audioFilePath == bounceFrozenPath)
+                    || clip.name.startsWithIgnoreCase("Freeze: "));
+        };
+
+        RenderProjectBuilder::MixSettings mix;
+        mix.masterGain = masterOutputGainRt.load(std::memory_order_relaxed);
+        mix.softClipEnabled = masterSoftClipEnabledRt.load(std::memory_order_relaxed);
+        mix.limiterEnabled = masterLimiterEnabledRt.load(std::memory_order_relaxed);
+        mix.outputDcHighPassEnabled = outputDcHighPassEnabledRt.load(std::memory_order_relaxed);
+        mix.monitorSafeMode = monitorSafeModeRt.load(std::memory_order_relaxed);
+        mix.auxFxEnabled = auxFxEnabledRt.load(std::memory_order_relaxed);
+        mix.auxReturnGain = auxReturnGainRt.load(std::memory_order_relaxed);
+        mix.auxReverbParameters = reverbParams;
+        RenderProjectBuilder::setSession(*project,
+                                         std::vector<int>(cloneIndexForTrack.begin(), cloneIndexForTrack.end()),
+                                         arrangement,
+                                         automationLanes,
+                                         tempoMapIndex,
+                                         bpmRt.load(std::memory_order_relaxed),
+                                         globalTransposeRt.load(std::memory_order_relaxed),
+                                         mix,
+                                         isBounceFreezeClip);
+
+        build->pendingLoads = static_cast<int>(cloneLoads.size());
+        if (cloneLoads.empty())
+        {
+            build->finish({});
+            return;
+        }
+
+        for (auto& cloneLoad : cloneLoads)
+        {
+            auto* clone = cloneLoad.clone;
+            const int slotIndex = cloneLoad.load.slotIndex;
+            PluginInstantiationService::Request request;
+            request.description = cloneLoad.load.description;
+            request.isInstrument = slotIndex == Track::instrumentSlotIndex;
+            request.sampleRate = clone->getPluginHostingSampleRate();
+            request.blockSize = clone->getPluginHostingBlockSize();
+            request.sandboxed = clone->getPluginHostingPolicyForSlot(slotIndex) == Track::PluginHostingPolicy::IsolatedBridge;
+            request.onComplete = [safeThis = juce::Component::SafePointer<MainComponent>(this),
+                                  build,
+                                  clone,
+                                  trackName = cloneLoad.trackName,
+                                  load = cloneLoad.load](std::unique_ptr<juce::AudioPluginInstance> instance,
+                                                         double preparedSampleRate,
+                                                         int preparedBlockSize,
+                                                         const juce::String& creationError)
+            {
+                --build->pendingLoads;
+                if (safeThis != nullptr)
+                {
+                    --safeThis->renderClonePluginLoadsPending;
+                    safeThis->refreshStatusText();
+                }
+                if (build->finished)
+                    return;
+                if (safeThis == nullptr)
+                {
+                    build->finish("The session closed before the render started.");
+                    return;
+                }
+                if (build->isCancelled())
+                {
+                    build->finish({});
+                    return;
+                }
+
+                juce::String loadError = creationError;
+                if (instance != nullptr
+                    && clone->attachPreparedPlugin(load.slotIndex,
+                                                   std::move(instance),
+                                                   load.description,
+                                                   preparedSampleRate,
+                                                   preparedBlockSize,
+                                                   loadError,
+                                                   load.pendingToken))
+                {
+                    loadError.clear();
+                    if (!load.state.isEmpty() && !clone->setPluginStateForSlot(load.slotIndex, load.state))
+                        loadError = load.slotIndex == Track::instrumentSlotIndex
+                                        ? juce::String("Instrument state restore failed for track copy.")
+                                        : "Insert state restore failed for track copy (slot " + juce::String(load.slotIndex + 1) + ").";
+                    clone->setPluginSlotBypassed(load.slotIndex, load.bypassed);
+                }
+                else if (loadError.isEmpty())
+                {
+                    loadError = "Plugin load failed.";
+                }
+
+                if (loadError.isNotEmpty())
+                    build->finish("Unable to copy \"" + trackName + "\" for rendering:\n" + loadError);
+                else if (build->pendingLoads == 0)
+                    build->finish({});
+            };
+
+            ++renderClonePluginLoadsPending;
+            pluginInstantiationService.requestInstance(std::move(request));
+        }
+        refreshStatusText();
     }
 
     double MainComponent::getProjectEndBeat() const
@@ -11177,12 +11149,12 @@ namespace sampledex
     bool MainComponent::runOfflineExport(const juce::File& destination,
                                          bool exportStems,
                                          const juce::String& formatExtension,
-                                         double exportSampleRate,
-                                         int bitDepth,
-                                         bool loopRangeOnly,
-                                         bool includeMasterProcessing,
-                                         bool enableDither)
+                                         const ExportSettings& settings)
     {
+        const double exportSampleRate = settings.sampleRate;
+        const bool includeMasterProcessing = settings.includeMasterProcessing;
+        const bool includeBusStems = settings.includeBusStems;
+        const bool enableDither = settings.enableDither;
         if (tracks.isEmpty())
         {
             juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
@@ -11200,14 +11172,58 @@ namespace sampledex
             return false;
         }
 
-        auto possibleBitDepths = format->getPossibleBitDepths();
-        int resolvedBitDepth = bitDepth;
-        if (!possibleBitDepths.isEmpty() && !possibleBitDepths.contains(resolvedBitDepth))
-            resolvedBitDepth = possibleBitDepths.getFirst();
+        if (backgroundRenderBusyRt.load(std::memory_order_acquire))
+        {
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
+                                                   "Background Render",
+                                                   "A render task is already running.");
+            return false;
+        }
+
+        const auto resolveBitDepth = [](juce::AudioFormat& outputFormat, int requested)
+        {
+            auto possibleBitDepths = outputFormat.getPossibleBitDepths();
+            if (!possibleBitDepths.isEmpty() && !possibleBitDepths.contains(requested))
+                return possibleBitDepths.getFirst();
+            return requested;
+        };
+        const int resolvedBitDepth = resolveBitDepth(*format, settings.bitDepth);
+
+        // Every mixdown file is encoded from the same render.
+        struct MixdownOutput
+        {
+            juce::AudioFormat* format = nullptr;
+            juce::String extension;
+            juce::File file;
+            double sampleRate = 48000.0;
+            int bitDepth = 24;
+            bool dither = false;
+        };
+        std::vector<MixdownOutput> mixdownOutputs;
+        if (!exportStems)
+        {
+            mixdownOutputs.push_back({ format, formatExtension, destination, exportSampleRate, resolvedBitDepth,
+                                       enableDither && resolvedBitDepth < 24 });
+            for (const auto& deliverable : settings.extraDeliverables)
+            {
+                auto* deliverableFormat = findWritableExportFormatForExtension(deliverable.extension);
+                if (deliverableFormat == nullptr)
+                {
+                    juce::Logger::writeToLog("Export: skipped ." + deliverable.extension + " deliverable (format not writable).");
+                    continue;
+                }
+                const int deliverableBitDepth = resolveBitDepth(*deliverableFormat, deliverable.bitDepth);
+                const auto file = destination.getSiblingFile(destination.getFileNameWithoutExtension() + deliverable.fileSuffix)
+                                      .withFileExtension("." + deliverable.extension);
+                mixdownOutputs.push_back({ deliverableFormat, deliverable.extension, file,
+                                           deliverable.sampleRate > 0.0 ? deliverable.sampleRate : exportSampleRate,
+                                           deliverableBitDepth, deliverable.dither && deliverableBitDepth < 24 });
+            }
+        }
 
         double startBeat = 0.0;
         double endBeat = getProjectEndBeat();
-        if (loopRangeOnly && transport.isLooping())
+        if (settings.loopRangeOnly && transport.isLooping())
         {
             startBeat = transport.getLoopStartBeat();
             endBeat = transport.getLoopEndBeat();
@@ -11215,221 +11231,418 @@ namespace sampledex
         if (endBeat <= startBeat + 0.0001)
             endBeat = startBeat + 4.0;
 
-        juce::String failureReason;
-        bool success = true;
+        if (exportStems && ((!destination.exists() && !destination.createDirectory()) || !destination.isDirectory()))
+        {
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                                                   "Export Stems",
+                                                   "Unable to access stems output folder.");
+            return false;
+        }
 
-        const juce::ScopedLock audioLock(deviceManager.getAudioCallbackLock());
+        // The export renders a clone of the session, so the device keeps playing the live
+        // session and nothing has to be restored afterwards.
+        std::vector<int> trackIndices;
+        juce::StringArray trackNames;
+        for (int i = 0; i < tracks.size(); ++i)
+        {
+            trackIndices.push_back(i);
+            trackNames.add(tracks[i]->getTrackName());
+        }
 
-        juce::AudioDeviceManager::AudioDeviceSetup setup;
-        deviceManager.getAudioDeviceSetup(setup);
-        const double restoreSampleRate = setup.sampleRate > 0.0
-                                         ? setup.sampleRate
-                                         : sampleRateRt.load(std::memory_order_relaxed);
-        const int restoreBlockSize = setup.bufferSize > 0 ? setup.bufferSize : 512;
-
-        const bool wasPlaying = transport.playing();
-        const double previousBeat = transport.getCurrentBeat();
-        const bool previousLooping = transport.isLooping();
-        const double previousLoopStart = transport.getLoopStartBeat();
-        const double previousLoopEnd = transport.getLoopEndBeat();
-        const bool previousRecordEnabled = recordEnabledRt.load(std::memory_order_relaxed);
-        const bool previousMetronomeEnabled = metronomeEnabledRt.load(std::memory_order_relaxed);
-        const float previousMasterGain = masterOutputGainRt.load(std::memory_order_relaxed);
-        const bool previousSoftClipEnabled = masterSoftClipEnabledRt.load(std::memory_order_relaxed);
-        const bool previousLimiterEnabled = masterLimiterEnabledRt.load(std::memory_order_relaxed);
-
-        std::vector<bool> previousSoloStates;
-        previousSoloStates.reserve(static_cast<size_t>(tracks.size()));
-        for (auto* track : tracks)
-            previousSoloStates.push_back(track->isSolo());
+        // The render status is held from here, so cancelling also drops a clone whose
+        // plugins are still loading.
+        if (!beginRenderTask(-1, Track::RenderTaskType::Export))
+            return false;
+
+        const int stemsPerPass = OfflineStemCapture::getMaxStemsPerPass(
+            static_cast<std::size_t>(juce::jmax(1, stemExportMemoryBudgetMb)) << 20,
+            offlineRenderSettings.getResolvedBlockSize());
+        juce::Component::SafePointer<MainComponent> safeThis(this);
 
-        auto restoreRenderState = [&]
+        auto renderExport = [safeThis, destination, exportStems, formatExtension, format, exportSampleRate,
+                             resolvedBitDepth, startBeat, endBeat, includeMasterProcessing, includeBusStems, trackNames, stemsPerPass,
+                             mixdownOutputs, loudnessTargetLufs = settings.loudnessTargetLufs,
+                             truePeakCeilingDb = static_cast<double>(settings.truePeakCeilingDb),
+                             dither = enableDither && resolvedBitDepth < 24](IsolatedRenderEngine* renderEngine) mutable
         {
-            sampleRateRt.store(restoreSampleRate, std::memory_order_relaxed);
-            transport.prepare(restoreSampleRate);
-            for (auto* track : tracks)
-                track->prepareToPlay(restoreSampleRate, restoreBlockSize);
+            if (safeThis == nullptr)
+                return;
 
-            for (int i = 0; i < tracks.size() && i < static_cast<int>(previousSoloStates.size()); ++i)
-                tracks[i]->setSolo(previousSoloStates[static_cast<size_t>(i)]);
+            juce::String failureReason;
+            bool success = true;
 
-            recordEnabledRt.store(previousRecordEnabled, std::memory_order_relaxed);
-            metronomeEnabledRt.store(previousMetronomeEnabled, std::memory_order_relaxed);
-            masterOutputGainRt.store(previousMasterGain, std::memory_order_relaxed);
-            masterSoftClipEnabledRt.store(previousSoftClipEnabled, std::memory_order_relaxed);
-            masterLimiterEnabledRt.store(previousLimiterEnabled, std::memory_order_relaxed);
+            auto createWriterFor = [&](const juce::File& outputFile,
+                                       juce::AudioFormat& outputFormat,
+                                       const juce::String& outputExtension,
+                                       double outputSampleRate,
+                                       int outputBitDepth)
+                -> std::unique_ptr<juce::AudioFormatWriter>
+            {
+                auto parentDir = outputFile.getParentDirectory();
+                if (!parentDir.exists() && !parentDir.createDirectory())
+                {
+                    failureReason = "Unable to create output directory:\n" + parentDir.getFullPathName();
+                    return {};
+                }
 
-            transport.setLoop(previousLooping, previousLoopStart, previousLoopEnd);
-            transport.setPosition(previousBeat);
-            if (wasPlaying)
-                transport.play();
-            else
-                transport.stop();
+                auto outputFileWithExt = outputFile.withFileExtension("." + outputExtension);
+                if (outputFileWithExt.existsAsFile() && !outputFileWithExt.deleteFile())
+                {
+                    failureReason = "Unable to overwrite output file:\n" + outputFileWithExt.getFullPathName();
+                    return {};
+                }
 
-            masterGainSmoothingState = masterOutputGainRt.load(std::memory_order_relaxed);
-        };
+                std::unique_ptr<juce::FileOutputStream> stream(outputFileWithExt.createOutputStream());
+                if (stream == nullptr)
+                {
+                    failureReason = "Unable to create output stream:\n" + outputFileWithExt.getFullPathName();
+                    return {};
+                }
 
-        auto createWriterForFile = [&](const juce::File& outputFile)
-            -> std::unique_ptr<juce::AudioFormatWriter>
-        {
-            auto parentDir = outputFile.getParentDirectory();
-            if (!parentDir.exists() && !parentDir.createDirectory())
+                juce::AudioFormatWriterOptions writerOptions;
+                writerOptions = writerOptions.withSampleRate(outputSampleRate)
+                                             .withNumChannels(2)
+                                             .withBitsPerSample(outputBitDepth)
+                                             .withQualityOptionIndex(0);
+                std::unique_ptr<juce::OutputStream> outputStream(std::move(stream));
+                std::unique_ptr<juce::AudioFormatWriter> writer(
+                    outputFormat.createWriterFor(outputStream, writerOptions));
+                if (writer == nullptr)
+                    failureReason = "Unable to create " + outputExtension.toUpperCase() + " writer.";
+                return writer;
+            };
+            auto createWriterForFile = [&](const juce::File& outputFile)
             {
-                failureReason = "Unable to create output directory:\n" + parentDir.getFullPathName();
-                return {};
-            }
+                return createWriterFor(outputFile, *format, formatExtension, exportSampleRate, resolvedBitDepth);
+            };
 
-            auto outputFileWithExt = outputFile.withFileExtension("." + formatExtension);
-            if (outputFileWithExt.existsAsFile() && !outputFileWithExt.deleteFile())
-            {
-                failureReason = "Unable to overwrite output file:\n" + outputFileWithExt.getFullPathName();
-                return {};
-            }
+            IsolatedRenderEngine::Pass pass;
+            pass.startBeat = startBeat;
+            pass.endBeat = endBeat;
+            pass.includeMasterProcessing = includeMasterProcessing;
+            const int trackCount = renderEngine->getNumTracks();
 
-            std::unique_ptr<juce::FileOutputStream> stream(outputFileWithExt.createOutputStream());
-            if (stream == nullptr)
+            // Progress runs across every pass of the export.
+            int passCount = 1;
+            int passIndex = 0;
+            const auto passProgress = [&safeThis, &passIndex, &passCount](const OfflineRenderProgress& progress)
             {
-                failureReason = "Unable to create output stream:\n" + outputFileWithExt.getFullPathName();
-                return {};
-            }
+                if (safeThis == nullptr)
+                    return;
+                safeThis->renderProgressRt.store((static_cast<float>(passIndex) + progress.getFraction()) / static_cast<float>(passCount),
+                                                 std::memory_order_relaxed);
+                safeThis->renderSpeedFactorRt.store(static_cast<float>(progress.speedFactor), std::memory_order_relaxed);
+            };
 
-            juce::AudioFormatWriterOptions writerOptions;
-            writerOptions = writerOptions.withSampleRate(exportSampleRate)
-                                         .withNumChannels(2)
-                                         .withBitsPerSample(resolvedBitDepth)
-                                         .withQualityOptionIndex(0);
-            std::unique_ptr<juce::OutputStream> outputStream(std::move(stream));
-            std::unique_ptr<juce::AudioFormatWriter> writer(
-                format->createWriterFor(outputStream, writerOptions));
-            if (writer == nullptr)
-                failureReason = "Unable to create " + formatExtension.toUpperCase() + " writer.";
-            return writer;
-        };
+            const double renderRate = renderEngine->getSampleRate();
+            const int renderBlockSize = renderEngine->getBlockSize();
+            const auto addMixdownSinks = [&](ExportSinkPipeline& sinks)
+            {
+                for (const auto& output : mixdownOutputs)
+                {
+                    auto writer = createWriterFor(output.file, *output.format, output.extension, output.sampleRate, output.bitDepth);
+                    if (writer == nullptr)
+                        return false;
+                    sinks.addSink(output.file.getFileName(), std::move(writer), output.bitDepth, output.dither);
+                }
+                return true;
+            };
 
-        const auto configureRenderState = [&]
-        {
-            recordEnabledRt.store(false, std::memory_order_relaxed);
-            metronomeEnabledRt.store(false, std::memory_order_relaxed);
-            transport.stop();
-            transport.setRecording(false);
-            transport.setLoop(false, startBeat, endBeat);
-            sampleRateRt.store(exportSampleRate, std::memory_order_relaxed);
-            transport.prepare(exportSampleRate);
-            for (auto* track : tracks)
-                track->prepareToPlay(exportSampleRate, 1024);
+            juce::String loudnessReport;
+            if (!exportStems && loudnessTargetLufs < 0.0f)
+            {
+                // Pass 1 renders once into a float intermediate (nothing is clipped or
+                // quantised) while the encoder thread measures it. Pass 2 only reads the
+                // intermediate back with the gain applied and encodes every deliverable.
+                passCount = 2;
+                const auto intermediate = juce::File::createTempFile(".wav");
+                LoudnessAnalyzer analyzer;
+                analyzer.prepare(renderRate, 2);
+                {
+                    juce::WavAudioFormat wavFormat;
+                    ExportSinkPipeline sinks(renderRate, renderBlockSize);
+                    if (auto writer = createWriterFor(intermediate, wavFormat, "wav", renderRate, 32))
+                        sinks.addSink("loudness intermediate", std::move(writer), 32, false,
+                                      [&analyzer](const juce::AudioBuffer<float>& block, int numSamples)
+                                      {
+                                          analyzer.process(block, numSamples);
+                                      });
+                    if (failureReason.isNotEmpty()
+                        || !safeThis->renderOfflinePassToSinks(*renderEngine, &sinks, pass, resolvedBitDepth, dither,
+                                                               &safeThis->renderCancelRequestedRt, passProgress))
+                    {
+                        success = false;
+                        if (failureReason.isEmpty())
+                            failureReason = sinks.getError().isNotEmpty() ? sinks.getError() : juce::String("Mix export render failed.");
+                    }
+                }
 
-            if (includeMasterProcessing)
+                if (success)
+                {
+                    const auto measured = analyzer.getMeasurement();
+                    const double gainDb = LoudnessAnalyzer::getNormalisationGainDb(measured, loudnessTargetLufs, truePeakCeilingDb);
+                    const float gain = juce::Decibels::decibelsToGain(static_cast<float>(gainDb));
+                    passIndex = 1;
+
+                    std::unique_ptr<juce::AudioFormatReader> reader(safeThis->audioFormatManager.createReaderFor(intermediate));
+                    ExportSinkPipeline sinks(renderRate, renderBlockSize);
+                    if (reader == nullptr)
+                        failureReason = "Unable to read the loudness intermediate back.";
+                    else if (addMixdownSinks(sinks))
+                    {
+                        sinks.start();
+                        juce::AudioBuffer<float> block(2, renderBlockSize);
+                        const auto totalSamples = reader->lengthInSamples;
+                        bool encoded = true;
+                        for (std::int64_t position = 0; encoded && position < totalSamples; position += renderBlockSize)
+                        {
+                            if (safeThis->renderCancelRequestedRt.load(std::memory_order_relaxed))
+                            {
+                                encoded = false;
+                                break;
+                            }
+                            const int numSamples = static_cast<int>(juce::jmin<std::int64_t>(renderBlockSize, totalSamples - position));
+                            encoded = reader->read(&block, 0, numSamples, position, true, true);
+                            block.applyGain(0, numSamples, gain);
+                            encoded = encoded && sinks.push(block, numSamples);
+                            safeThis->renderProgressRt.store((1.0f + static_cast<float>(position + numSamples) / static_cast<float>(totalSamples)) * 0.5f,
+                                                             std::memory_order_relaxed);
+                        }
+                        if (!encoded)
+                            sinks.cancel();
+                        encoded = sinks.finish() && encoded;
+                        if (!encoded && failureReason.isEmpty())
+                            failureReason = sinks.getError().isNotEmpty() ? sinks.getError() : juce::String("Loudness-normalised encode failed.");
+                    }
+                    success = failureReason.isEmpty();
+
+                    loudnessReport = measured.valid
+                        ? "Measured: " + juce::String(measured.integratedLufs, 1) + " LUFS integrated, "
+                              + juce::String(measured.truePeakDbtp, 1) + " dBTP true peak, LRA "
+                              + juce::String(measured.loudnessRangeLu, 1) + " LU\n"
+                              + "Applied gain: " + juce::String(gainDb, 2) + " dB -> "
+                              + juce::String(measured.integratedLufs + gainDb, 1) + " LUFS, "
+                              + juce::String(measured.truePeakDbtp + gainDb, 1) + " dBTP"
+                              + (gainDb < (loudnessTargetLufs - measured.integratedLufs) - 0.05
+                                     ? " (held back by the " + juce::String(truePeakCeilingDb, 1) + " dBTP ceiling)"
+                                     : juce::String())
+                        : juce::String("Measured: silent (below the -70 LUFS gate); no gain applied");
+                    juce::Logger::writeToLog("Loudness export: " + loudnessReport.replace("\n", "; "));
+                    if (success)
+                        juce::ignoreUnused(destination.getSiblingFile(destination.getFileNameWithoutExtension() + " (loudness).txt")
+                                               .replaceWithText("Target: " + juce::String(loudnessTargetLufs, 1) + " LUFS, ceiling "
+                                                                + juce::String(truePeakCeilingDb, 1) + " dBTP\n" + loudnessReport + "\n"));
+                }
+                intermediate.deleteFile();
+            }
+            else if (!exportStems)
             {
-                masterOutputGainRt.store(previousMasterGain, std::memory_order_relaxed);
-                masterSoftClipEnabledRt.store(previousSoftClipEnabled, std::memory_order_relaxed);
-                masterLimiterEnabledRt.store(previousLimiterEnabled, std::memory_order_relaxed);
-                masterGainSmoothingState = previousMasterGain;
+                ExportSinkPipeline sinks(renderRate, renderBlockSize);
+                if (!addMixdownSinks(sinks)
+                    || !safeThis->renderOfflinePassToSinks(*renderEngine, &sinks, pass, resolvedBitDepth, dither,
+                                                           &safeThis->renderCancelRequestedRt, passProgress))
+                {
+                    success = false;
+                    if (failureReason.isEmpty())
+                        failureReason = sinks.getError().isNotEmpty() ? sinks.getError() : juce::String("Mix export render failed.");
+                }
             }
             else
             {
-                masterOutputGainRt.store(1.0f, std::memory_order_relaxed);
-                masterSoftClipEnabledRt.store(false, std::memory_order_relaxed);
-                masterLimiterEnabledRt.store(false, std::memory_order_relaxed);
-                masterGainSmoothingState = 1.0f;
-            }
-        };
+                const auto stemFileFor = [&](int trackIndex)
+                {
+                    juce::String stemName = juce::String(trackIndex + 1).paddedLeft('0', 2)
+                                          + " - "
+                                          + juce::File::createLegalFileName(trackNames[trackIndex]);
+                    if (stemName.trim().isEmpty())
+                        stemName = "Track " + juce::String(trackIndex + 1);
+                    return destination.getChildFile(stemName + "." + formatExtension);
+                };
 
-        if (!exportStems)
-        {
-            configureRenderState();
-            auto writer = createWriterForFile(destination);
-            if (writer == nullptr
-                || !renderOfflinePassToWriter(*writer,
-                                              startBeat,
-                                              endBeat,
-                                              exportSampleRate,
-                                              resolvedBitDepth,
-                                              enableDither && resolvedBitDepth < 24))
-            {
-                success = false;
-                if (failureReason.isEmpty())
-                    failureReason = "Mix export render failed.";
-            }
-        }
-        else
-        {
-            if ((!destination.exists() && !destination.createDirectory()) || !destination.isDirectory())
-            {
-                restoreRenderState();
-                juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
-                                                       "Export Stems",
-                                                       "Unable to access stems output folder.");
-                return false;
-            }
+                if (includeMasterProcessing)
+                {
+                    // The master chain acts on the sum, so master-processed stems need one
+                    // soloed pass per track.
+                    passCount = juce::jmax(1, trackCount);
+                    for (int trackIndex = 0; trackIndex < trackCount; ++trackIndex)
+                    {
+                        passIndex = trackIndex;
+                        for (int i = 0; i < trackCount; ++i)
+                            renderEngine->getTrack(i)->setSolo(i == trackIndex);
+
+                        ExportSinkPipeline sinks(renderEngine->getSampleRate(), renderEngine->getBlockSize());
+                        auto writer = createWriterForFile(stemFileFor(trackIndex));
+                        if (writer != nullptr)
+                            sinks.addSink(trackNames[trackIndex], std::move(writer), resolvedBitDepth, dither);
+                        if (sinks.getNumSinks() == 0
+                            || !safeThis->renderOfflinePassToSinks(*renderEngine, &sinks, pass, resolvedBitDepth, dither,
+                                                                   &safeThis->renderCancelRequestedRt, passProgress))
+                        {
+                            success = false;
+                            if (failureReason.isEmpty())
+                                failureReason = "Stem export failed on track: " + trackNames[trackIndex];
+                            break;
+                        }
+                    }
+                }
+                else
+                {
+                    // Pre-master stems are tapped from one pass. When more writers are needed
+                    // than the memory budget allows open at once, the tracks are split into
+                    // shards. Every pass renders the same tracks and only the writers change:
+                    // an aux strip hears its bus whichever shard the tracks sending to it are in.
+                    const int stemTrackCount = juce::jmin(trackCount, OfflineStemCapture::maxTracks);
+                    const int busStemSlots = includeBusStems ? juce::jmin(stemsPerPass, auxBusCount) : 0;
+                    passCount = juce::jmax(1, (stemTrackCount + busStemSlots + stemsPerPass - 1) / stemsPerPass);
+                    int nextTrack = 0;
+                    bool busStemsPending = includeBusStems;
+                    while (success && (nextTrack < stemTrackCount || busStemsPending))
+                    {
+                        OfflineStemCapture capture;
+                        if (busStemsPending)
+                        {
+                            for (int bus = 0; bus < auxBusCount && capture.getNumStems() < stemsPerPass; ++bus)
+                            {
+                                auto writer = createWriterForFile(destination.getChildFile("Bus " + juce::String(bus + 1)
+                                                                                           + "." + formatExtension));
+                                if (writer == nullptr)
+                                    break;
+                                capture.addBusStem(bus, std::move(writer));
+                            }
+                            busStemsPending = false;
+                        }
 
-            for (int trackIndex = 0; trackIndex < tracks.size(); ++trackIndex)
-            {
-                for (int i = 0; i < tracks.size(); ++i)
-                    tracks[i]->setSolo(i == trackIndex);
+                        while (failureReason.isEmpty() && nextTrack < stemTrackCount && capture.getNumStems() < stemsPerPass)
+                        {
+                            auto writer = createWriterForFile(stemFileFor(nextTrack));
+                            if (writer == nullptr)
+                                break;
+                            capture.addTrackStem(nextTrack++, std::move(writer));
+                        }
 
-                configureRenderState();
+                        if (failureReason.isNotEmpty())
+                        {
+                            success = false;
+                            break;
+                        }
 
-                juce::String stemName = juce::String(trackIndex + 1).paddedLeft('0', 2)
-                                      + " - "
-                                      + juce::File::createLegalFileName(tracks[trackIndex]->getTrackName());
-                if (stemName.trim().isEmpty())
-                    stemName = "Track " + juce::String(trackIndex + 1);
+                        auto stemPass = pass;
+                        stemPass.stemCapture = &capture;
+                        if (!safeThis->renderOfflinePassToSinks(*renderEngine, nullptr, stemPass, resolvedBitDepth, dither,
+                                                                &safeThis->renderCancelRequestedRt, passProgress))
+                        {
+                            success = false;
+                            failureReason = "Stem export failed while rendering pass " + juce::String(passIndex + 1) + ".";
+                        }
+                        capture.close();
+                        ++passIndex;
+                    }
 
-                auto writer = createWriterForFile(destination.getChildFile(stemName + "." + formatExtension));
-                if (writer == nullptr
-                    || !renderOfflinePassToWriter(*writer,
-                                                  startBeat,
-                                                  endBeat,
-                                                  exportSampleRate,
-                                                  resolvedBitDepth,
-                                                  enableDither && resolvedBitDepth < 24))
-                {
-                    success = false;
-                    if (failureReason.isEmpty())
-                        failureReason = "Stem export failed on track: " + tracks[trackIndex]->getTrackName();
-                    break;
+                    juce::Logger::writeToLog("Stem export: " + juce::String(stemTrackCount) + " track stems"
+                                             + (includeBusStems ? " + bus stems" : "")
+                                             + " in " + juce::String(passIndex) + " pass(es), up to "
+                                             + juce::String(stemsPerPass) + " writers per pass");
                 }
             }
-        }
 
-        restoreRenderState();
-        refreshChannelRackWindow();
-        refreshStatusText();
+            if (!success && safeThis != nullptr && safeThis->renderCancelRequestedRt.load(std::memory_order_relaxed))
+                return;
 
-        if (!success)
-        {
-            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
-                                                   "Export",
-                                                   failureReason.isNotEmpty() ? failureReason
-                                                                              : juce::String("Export failed."));
-        }
-        return success;
+            const int extraFiles = exportStems ? 0 : static_cast<int>(mixdownOutputs.size()) - 1;
+            juce::MessageManager::callAsync([success, exportStems, destination, failureReason, extraFiles, loudnessReport]
+            {
+                if (!success)
+                {
+                    juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                                                           "Export",
+                                                           failureReason.isNotEmpty() ? failureReason
+                                                                                      : juce::String("Export failed."));
+                    return;
+                }
+
+                juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
+                                                       "Export Complete",
+                                                       (exportStems ? "Stems exported to:\n" : "Mixdown exported to:\n")
+                                                           + destination.getFullPathName()
+                                                           + (extraFiles > 0 ? "\n(+" + juce::String(extraFiles) + " more deliverable(s) alongside)"
+                                                                             : juce::String())
+                                                           + (loudnessReport.isNotEmpty() ? "\n\n" + loudnessReport : juce::String()));
+            });
+        };
+
+        createIsolatedRenderEngine(trackIndices,
+                                   -1,
+                                   exportSampleRate,
+                                   [safeThis, taskName = juce::String(exportStems ? "Export Stems" : "Export Mixdown"),
+                                    renderExport = std::move(renderExport)](std::unique_ptr<IsolatedRenderEngine> engine,
+                                                                            const juce::String& engineError) mutable
+                                   {
+                                       if (safeThis == nullptr)
+                                           return;
+                                       if (engine == nullptr)
+                                       {
+                                           // An empty error means the export was cancelled.
+                                           safeThis->abandonRenderTask();
+                                           if (engineError.isNotEmpty())
+                                               juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                                                                                      "Export",
+                                                                                      engineError);
+                                           return;
+                                       }
+
+                                       safeThis->isolatedRenderEngine = std::move(engine);
+                                       safeThis->runRenderTask(taskName,
+                                                               [renderExport = std::move(renderExport),
+                                                                renderEngine = safeThis->isolatedRenderEngine.get()]() mutable
+                                                               {
+                                                                   renderExport(renderEngine);
+                                                               });
+                                   },
+                                   &renderCancelRequestedRt);
+        return true;
     }
 
-    void MainComponent::runRenderTask(const juce::String& taskName,
-                                      std::function<void()> task,
-                                      int renderTrackIndex,
-                                      Track::RenderTaskType taskType)
+    bool MainComponent::beginRenderTask(int renderTrackIndex, Track::RenderTaskType taskType)
     {
-        if (!task)
-            return;
-
         bool expectedIdle = false;
         if (!backgroundRenderBusyRt.compare_exchange_strong(expectedIdle, true, std::memory_order_acq_rel))
         {
             juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
                                                    "Background Render",
                                                    "A render task is already running.");
-            return;
+            return false;
         }
 
         renderCancelRequestedRt.store(false, std::memory_order_relaxed);
         renderProgressRt.store(0.0f, std::memory_order_relaxed);
+        renderSpeedFactorRt.store(0.0f, std::memory_order_relaxed);
         renderTrackIndexRt.store(renderTrackIndex, std::memory_order_relaxed);
         renderTaskTypeRt.store(static_cast<int>(taskType), std::memory_order_relaxed);
         if (juce::isPositiveAndBelow(renderTrackIndex, tracks.size()) && tracks[renderTrackIndex] != nullptr)
             tracks[renderTrackIndex]->setRenderTaskState(taskType, true, 0.0f);
         refreshStatusText();
+        return true;
+    }
+
+    void MainComponent::abandonRenderTask()
+    {
+        const int trackIndex = renderTrackIndexRt.exchange(-1, std::memory_order_relaxed);
+        renderCancelRequestedRt.store(false, std::memory_order_relaxed);
+        renderTaskTypeRt.store(static_cast<int>(Track::RenderTaskType::None), std::memory_order_relaxed);
+        renderProgressRt.store(0.0f, std::memory_order_relaxed);
+        if (juce::isPositiveAndBelow(trackIndex, tracks.size()) && tracks[trackIndex] != nullptr)
+            tracks[trackIndex]->setRenderTaskState(Track::RenderTaskType::None, false, 0.0f);
+        backgroundRenderBusyRt.store(false, std::memory_order_release);
+        refreshStatusText();
+    }
+
+    void MainComponent::runRenderTask(const juce::String& taskName, std::function<void()> task)
+    {
+        if (!task)
+        {
+            abandonRenderTask();
+            return;
+        }
 
         auto wrappedTask = [this, taskFn = std::move(task)]() mutable
         {
@@ -11463,11 +11676,15 @@ namespace sampledex
             if (juce::isPositiveAndBelow(trackIndex, tracks.size()) && tracks[trackIndex] != nullptr)
                 tracks[trackIndex]->setRenderTaskState(Track::RenderTaskType::None, false, 0.0f);
 
-            backgroundRenderBusyRt.store(false, std::memory_order_release);
+            // The isolated engine is released on the message thread before the next task
+            // may start, since its cloned plugins are destroyed there.
             juce::MessageManager::callAsync([safeThis = juce::Component::SafePointer<MainComponent>(this)]
             {
-                if (safeThis != nullptr)
-                    safeThis->refreshStatusText();
+                if (safeThis == nullptr)
+                    return;
+                safeThis->isolatedRenderEngine.reset();
+                safeThis->backgroundRenderBusyRt.store(false, std::memory_order_release);
+                safeThis->refreshStatusText();
             });
         };
 
@@ -11486,6 +11703,7 @@ namespace sampledex
             return;
 
         renderCancelRequestedRt.store(true, std::memory_order_relaxed);
+        renderJobQueue.cancelAll();
         const int trackIndex = renderTrackIndexRt.load(std::memory_order_relaxed);
         if (juce::isPositiveAndBelow(trackIndex, tracks.size()) && tracks[trackIndex] != nullptr)
             tracks[trackIndex]->setRenderTaskState(tracks[trackIndex]->getRenderTaskType(),
@@ -11494,21 +11712,14 @@ namespace sampledex
         refreshStatusText();
     }
 
-    bool MainComponent::renderTrackToAudioFile(int trackIndex,
+    bool MainComponent::renderTrackToAudioFile(IsolatedRenderEngine& engine,
                                                const juce::File& outputFile,
                                                double startBeat,
                                                double endBeat,
-                                               double renderSampleRate,
-                                               bool includeMasterProcessing,
+                                               RenderJobQueue::JobContext& context,
                                                juce::String& errorMessage)
     {
         errorMessage.clear();
-        if (!juce::isPositiveAndBelow(trackIndex, tracks.size()))
-        {
-            errorMessage = "Invalid track selected for rendering.";
-            return false;
-        }
-
         if (endBeat <= startBeat + 1.0e-9)
         {
             errorMessage = "Invalid render range.";
@@ -11521,126 +11732,10 @@ namespace sampledex
             return false;
         }
 
-        const juce::ScopedLock audioLock(deviceManager.getAudioCallbackLock());
-
-        juce::AudioDeviceManager::AudioDeviceSetup setup;
-        deviceManager.getAudioDeviceSetup(setup);
-        const double restoreSampleRate = setup.sampleRate > 0.0
-                                         ? setup.sampleRate
-                                         : juce::jmax(1.0, sampleRateRt.load(std::memory_order_relaxed));
-        const int restoreBlockSize = setup.bufferSize > 0 ? setup.bufferSize : 512;
-
-        const bool wasPlaying = transport.playing();
-        const bool wasRecording = transport.recording();
-        const double previousBeat = transport.getCurrentBeat();
-        const bool previousLooping = transport.isLooping();
-        const double previousLoopStart = transport.getLoopStartBeat();
-        const double previousLoopEnd = transport.getLoopEndBeat();
-        const bool previousRecordEnabled = recordEnabledRt.load(std::memory_order_relaxed);
-        const bool previousMetronomeEnabled = metronomeEnabledRt.load(std::memory_order_relaxed);
-        const float previousMasterGain = masterOutputGainRt.load(std::memory_order_relaxed);
-        const bool previousSoftClipEnabled = masterSoftClipEnabledRt.load(std::memory_order_relaxed);
-        const bool previousLimiterEnabled = masterLimiterEnabledRt.load(std::memory_order_relaxed);
-        const bool previousExternalClockSync = externalMidiClockSyncEnabledRt.load(std::memory_order_relaxed);
-
-        std::vector<bool> previousSoloStates;
-        previousSoloStates.reserve(static_cast<size_t>(tracks.size()));
-        for (auto* track : tracks)
-            previousSoloStates.push_back(track != nullptr ? track->isSolo() : false);
-
-        auto* targetTrack = tracks[trackIndex];
-        const bool targetWasFrozen = targetTrack != nullptr && targetTrack->isFrozenPlaybackOnly();
-        const juce::String targetFrozenPath = targetTrack != nullptr ? targetTrack->getFrozenRenderPath()
-                                                                     : juce::String();
-
-        auto restoreRenderState = [&]
-        {
-            sampleRateRt.store(restoreSampleRate, std::memory_order_relaxed);
-            transport.prepare(restoreSampleRate);
-            for (auto* track : tracks)
-            {
-                if (track != nullptr)
-                    track->prepareToPlay(restoreSampleRate, restoreBlockSize);
-            }
-
-            for (int i = 0; i < tracks.size() && i < static_cast<int>(previousSoloStates.size()); ++i)
-            {
-                if (tracks[i] != nullptr)
-                    tracks[i]->setSolo(previousSoloStates[static_cast<size_t>(i)]);
-            }
-
-            if (targetTrack != nullptr)
-            {
-                targetTrack->setFrozenPlaybackOnly(targetWasFrozen);
-                targetTrack->setFrozenRenderPath(targetFrozenPath);
-            }
-
-            recordEnabledRt.store(previousRecordEnabled, std::memory_order_relaxed);
-            metronomeEnabledRt.store(previousMetronomeEnabled, std::memory_order_relaxed);
-            masterOutputGainRt.store(previousMasterGain, std::memory_order_relaxed);
-            masterSoftClipEnabledRt.store(previousSoftClipEnabled, std::memory_order_relaxed);
-            masterLimiterEnabledRt.store(previousLimiterEnabled, std::memory_order_relaxed);
-            externalMidiClockSyncEnabledRt.store(previousExternalClockSync, std::memory_order_relaxed);
-
-            transport.setLoop(previousLooping, previousLoopStart, previousLoopEnd);
-            transport.setPosition(previousBeat);
-            transport.setRecording(false);
-            if (wasRecording)
-                transport.setRecording(true);
-            else if (wasPlaying)
-                transport.play();
-            else
-                transport.stop();
-
-            masterGainSmoothingState = masterOutputGainRt.load(std::memory_order_relaxed);
-            externalMidiClockWasRunning = false;
-            lastAppliedExternalClockGeneration = -1;
-        };
-
-        for (int i = 0; i < tracks.size(); ++i)
-        {
-            if (tracks[i] == nullptr)
-                continue;
-            tracks[i]->setSolo(i == trackIndex);
-        }
-
-        if (targetTrack != nullptr)
-            targetTrack->setFrozenPlaybackOnly(false);
-
-        recordEnabledRt.store(false, std::memory_order_relaxed);
-        metronomeEnabledRt.store(false, std::memory_order_relaxed);
-        externalMidiClockSyncEnabledRt.store(false, std::memory_order_relaxed);
-        transport.stop();
-        transport.setRecording(false);
-        transport.setLoop(false, startBeat, endBeat);
-        sampleRateRt.store(renderSampleRate, std::memory_order_relaxed);
-        transport.prepare(renderSampleRate);
-        for (auto* track : tracks)
-        {
-            if (track != nullptr)
-                track->prepareToPlay(renderSampleRate, 1024);
-        }
-
-        if (includeMasterProcessing)
-        {
-            masterOutputGainRt.store(previousMasterGain, std::memory_order_relaxed);
-            masterSoftClipEnabledRt.store(previousSoftClipEnabled, std::memory_order_relaxed);
-            masterLimiterEnabledRt.store(previousLimiterEnabled, std::memory_order_relaxed);
-            masterGainSmoothingState = previousMasterGain;
-        }
-        else
-        {
-            masterOutputGainRt.store(1.0f, std::memory_order_relaxed);
-            masterSoftClipEnabledRt.store(false, std::memory_order_relaxed);
-            masterLimiterEnabledRt.store(false, std::memory_order_relaxed);
-            masterGainSmoothingState = 1.0f;
-        }
-
         auto parentDir = outputFile.getParentDirectory();
         if (!parentDir.exists() && !parentDir.createDirectory())
         {
             errorMessage = "Unable to create render folder:\n" + parentDir.getFullPathName();
-            restoreRenderState();
             return false;
         }
 
@@ -11648,7 +11743,6 @@ namespace sampledex
         if (outputWithExt.existsAsFile() && !outputWithExt.deleteFile())
         {
             errorMessage = "Unable to overwrite rendered file:\n" + outputWithExt.getFullPathName();
-            restoreRenderState();
             return false;
         }
 
@@ -11656,13 +11750,12 @@ namespace sampledex
         if (stream == nullptr || !stream->openedOk())
         {
             errorMessage = "Unable to open render output stream:\n" + outputWithExt.getFullPathName();
-            restoreRenderState();
             return false;
         }
 
         juce::WavAudioFormat wavFormat;
         juce::AudioFormatWriterOptions writerOptions;
-        writerOptions = writerOptions.withSampleRate(renderSampleRate)
+        writerOptions = writerOptions.withSampleRate(engine.getSampleRate())
                                      .withNumChannels(2)
                                      .withBitsPerSample(24);
         std::unique_ptr<juce::OutputStream> outputStream(std::move(stream));
@@ -11670,36 +11763,36 @@ namespace sampledex
         if (writer == nullptr)
         {
             errorMessage = "Unable to create WAV writer for track render.";
-            restoreRenderState();
             return false;
         }
 
-        const bool renderOk = renderOfflinePassToWriter(
-            *writer,
-            startBeat,
-            endBeat,
-            renderSampleRate,
+        // The engine holds only this track, so no solo is needed; freeze and commit
+        // renders skip the master chain.
+        IsolatedRenderEngine::Pass pass;
+        pass.startBeat = startBeat;
+        pass.endBeat = endBeat;
+        pass.includeMasterProcessing = false;
+        const double renderSampleRate = engine.getSampleRate();
+        ExportSinkPipeline sinks(renderSampleRate, engine.getBlockSize());
+        sinks.addSink(outputWithExt.getFileName(), std::move(writer), 24, false);
+        const bool renderOk = renderOfflinePassToSinks(
+            engine,
+            &sinks,
+            pass,
             24,
             false,
-            &renderCancelRequestedRt,
-            [this, trackIndex](float progress)
+            context.getCancelFlag(),
+            [&context, renderSampleRate](const OfflineRenderProgress& progress)
             {
-                const float clamped = juce::jlimit(0.0f, 1.0f, progress);
-                renderProgressRt.store(clamped, std::memory_order_relaxed);
-                if (juce::isPositiveAndBelow(trackIndex, tracks.size()) && tracks[trackIndex] != nullptr)
-                {
-                    tracks[trackIndex]->setRenderTaskState(
-                        tracks[trackIndex]->getRenderTaskType(),
-                        true,
-                        clamped);
-                }
+                context.setProgress(progress.getFraction(),
+                                    static_cast<double>(progress.samplesRendered) / renderSampleRate);
             });
-        writer.reset();
-        restoreRenderState();
         if (!renderOk)
         {
-            if (renderCancelRequestedRt.load(std::memory_order_relaxed))
+            if (context.isCancelled())
                 errorMessage = "Render cancelled.";
+            else if (sinks.getError().isNotEmpty())
+                errorMessage = sinks.getError();
             else
                 errorMessage = "Track render failed during offline pass.";
             return false;
@@ -11743,8 +11836,8 @@ namespace sampledex
         {
             const double fileSampleRate = juce::jmax(1.0, reader->sampleRate);
             const double fileLengthSeconds = static_cast<double>(reader->lengthInSamples) / fileSampleRate;
-            const double beatsPerSecond = juce::jmax(1.0, bpmRt.load(std::memory_order_relaxed)) / 60.0;
-            clipLengthBeats = juce::jmax(0.25, fileLengthSeconds * beatsPerSecond);
+            const double renderedEndBeat = tempoMapIndex.beatAtSeconds(tempoMapIndex.secondsAtBeat(startBeat) + fileLengthSeconds);
+            clipLengthBeats = juce::jmax(0.25, renderedEndBeat - startBeat);
             renderSampleRate = fileSampleRate;
         }
 
@@ -11801,8 +11894,8 @@ namespace sampledex
         {
             const double fileSampleRate = juce::jmax(1.0, reader->sampleRate);
             const double fileLengthSeconds = static_cast<double>(reader->lengthInSamples) / fileSampleRate;
-            const double beatsPerSecond = juce::jmax(1.0, bpmRt.load(std::memory_order_relaxed)) / 60.0;
-            clipLengthBeats = juce::jmax(0.25, fileLengthSeconds * beatsPerSecond);
+            const double renderedEndBeat = tempoMapIndex.beatAtSeconds(tempoMapIndex.secondsAtBeat(startBeat) + fileLengthSeconds);
+            clipLengthBeats = juce::jmax(0.25, renderedEndBeat - startBeat);
             renderSampleRate = fileSampleRate;
         }
 
@@ -11843,51 +11936,21 @@ namespace sampledex
         if (!juce::isPositiveAndBelow(trackIndex, tracks.size()))
             return;
 
-        const double startBeat = 0.0;
-        const double endBeat = juce::jmax(startBeat + 0.25, getProjectEndBeat());
-        const double renderSampleRate = juce::jmax(22050.0, sampleRateRt.load(std::memory_order_relaxed));
-        auto freezeDir = appDataDir.getChildFile("FreezeCache");
-        freezeDir.createDirectory();
-        const juce::String stem = juce::File::createLegalFileName("Freeze_" + juce::String(trackIndex + 1) + "_" + tracks[trackIndex]->getTrackName());
-        const juce::File outputFile = freezeDir.getNonexistentChildFile(stem, ".wav", false);
-        juce::Component::SafePointer<MainComponent> safeThis(this);
+        queueTrackRenders({ trackIndex }, Track::RenderTaskType::Freeze);
+    }
 
-        runRenderTask("Freeze Track", [safeThis, trackIndex, outputFile, startBeat, endBeat, renderSampleRate]() mutable
+    void MainComponent::freezeAllTracksToAudio()
+    {
+        std::vector<int> trackIndices;
+        for (int i = 0; i < tracks.size(); ++i)
         {
-            if (safeThis == nullptr)
-                return;
-
-            juce::String error;
-            const bool ok = safeThis->renderTrackToAudioFile(trackIndex,
-                                                             outputFile,
-                                                             startBeat,
-                                                             endBeat,
-                                                             renderSampleRate,
-                                                             false,
-                                                             error);
-            if (!ok)
-            {
-                if (error.startsWithIgnoreCase("Render cancelled"))
-                    return;
-                juce::MessageManager::callAsync([errorMessage = error.isNotEmpty() ? error
-                                                                                   : juce::String("Freeze render failed.")]
-                {
-                    juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
-                                                           "Freeze Track",
-                                                           errorMessage);
-                });
-                return;
-            }
+            if (tracks[i] != nullptr
+                && tracks[i]->getChannelType() != Track::ChannelType::Master
+                && !tracks[i]->isFrozenPlaybackOnly())
+                trackIndices.push_back(i);
+        }
 
-            juce::MessageManager::callAsync([safeThis, trackIndex, outputFile, startBeat, endBeat, renderSampleRate]
-            {
-                if (safeThis == nullptr)
-                    return;
-                safeThis->finishFreezeTrack(trackIndex, outputFile, startBeat, endBeat, renderSampleRate);
-            });
-        },
-        trackIndex,
-        Track::RenderTaskType::Freeze);
+        queueTrackRenders(trackIndices, Track::RenderTaskType::Freeze);
     }
 
     void MainComponent::unfreezeTrack(int trackIndex)
@@ -11912,63 +11975,469 @@ namespace sampledex
                                          }),
                         arrangement.end());
 
-        track->setFrozenPlaybackOnly(false);
-        track->setFrozenRenderPath({});
-        rebuildRealtimeSnapshot();
-        refreshChannelRackWindow();
-        refreshStatusText();
-    }
+        track->setFrozenPlaybackOnly(false);
+        track->setFrozenRenderPath({});
+        rebuildRealtimeSnapshot();
+        refreshChannelRackWindow();
+        refreshStatusText();
+    }
+
+    void MainComponent::commitTrackToAudio(int trackIndex)
+    {
+        if (!juce::isPositiveAndBelow(trackIndex, tracks.size()))
+            return;
+
+        queueTrackRenders({ trackIndex }, Track::RenderTaskType::Commit);
+    }
+
+    void MainComponent::queueTrackRenders(const std::vector<int>& trackIndices, Track::RenderTaskType taskType)
+    {
+        // An export owns the shared render status; freeze and commit jobs only queue
+        // behind each other.
+        if (backgroundRenderBusyRt.load(std::memory_order_acquire) && !renderJobQueue.isBusy())
+        {
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
+                                                   "Background Render",
+                                                   "A render task is already running.");
+            return;
+        }
+
+        const bool commit = taskType == Track::RenderTaskType::Commit;
+        std::map<Track*, RenderJobQueue::JobId> jobForTrack;
+        for (const auto& job : trackRenderJobs)
+            jobForTrack[job.track] = job.jobId;
+
+        std::vector<Track*> pending;
+        for (const int trackIndex : trackIndices)
+        {
+            auto* track = juce::isPositiveAndBelow(trackIndex, tracks.size()) ? tracks[trackIndex] : nullptr;
+            if (track != nullptr && jobForTrack.count(track) == 0
+                && std::find(pending.begin(), pending.end(), track) == pending.end())
+                pending.push_back(track);
+        }
+        if (pending.empty())
+            return;
+
+        // An aux strip's input is its send target bus. Its job waits for the jobs of tracks
+        // that feed that bus, so it is cloned once their renders have landed.
+        const auto feedsBus = [](const Track& source, int bus)
+        {
+            return (source.getOutputTargetType() == Track::OutputTargetType::Bus && source.getOutputTargetBus() == bus)
+                || (source.getSendLevel() > 0.0001f && source.getSendTargetBus() == bus);
+        };
+        const auto sourcesOf = [&feedsBus](Track* target, const std::vector<Track*>& candidates)
+        {
+            std::vector<Track*> sources;
+            if (target->getChannelType() != Track::ChannelType::Aux)
+                return sources;
+            for (auto* candidate : candidates)
+                if (candidate != target && feedsBus(*candidate, target->getSendTargetBus()))
+                    sources.push_back(candidate);
+            return sources;
+        };
+
+        const double renderSampleRate = juce::jmax(22050.0, sampleRateRt.load(std::memory_order_relaxed));
+        auto renderDir = appDataDir.getChildFile(commit ? "CommitCache" : "FreezeCache");
+        renderDir.createDirectory();
+
+        const bool startingBatch = !renderJobQueue.isBusy();
+        if (startingBatch)
+        {
+            trackRenderErrors.clear();
+            renderCancelRequestedRt.store(false, std::memory_order_relaxed);
+            renderProgressRt.store(0.0f, std::memory_order_relaxed);
+            renderSpeedFactorRt.store(0.0f, std::memory_order_relaxed);
+            renderTrackIndexRt.store(-1, std::memory_order_relaxed);
+            backgroundRenderBusyRt.store(true, std::memory_order_release);
+        }
+        renderTaskTypeRt.store(static_cast<int>(taskType), std::memory_order_relaxed);
+
+        // Sources are queued before the strips that wait on them; a routing loop between
+        // strips falls back to queue order.
+        std::vector<Track*> allCandidates = pending;
+        for (const auto& job : trackRenderJobs)
+            allCandidates.push_back(job.track);
+        while (!pending.empty())
+        {
+            auto next = std::find_if(pending.begin(), pending.end(), [&](Track* track)
+            {
+                for (auto* source : sourcesOf(track, pending))
+                    if (jobForTrack.count(source) == 0)
+                        return false;
+                return true;
+            });
+            if (next == pending.end())
+                next = pending.begin();
+
+            auto* track = *next;
+            pending.erase(next);
+
+            RenderJobQueue::Job job;
+            job.name = (commit ? "Commit " : "Freeze ") + track->getTrackName();
+            for (auto* source : sourcesOf(track, allCandidates))
+            {
+                const auto found = jobForTrack.find(source);
+                if (found != jobForTrack.end())
+                    job.dependencies.push_back(found->second);
+            }
+
+            const juce::String trackName = track->getTrackName();
+            const juce::File outputFile = renderDir.getNonexistentChildFile(
+                juce::File::createLegalFileName((commit ? "Commit_" : "Freeze_") + juce::String(tracks.indexOf(track) + 1) + "_" + trackName),
+                ".wav",
+                false);
+            auto range = std::make_shared<std::pair<double, double>>(0.0, 4.0);
+
+            job.start = [this, track, taskType, renderSampleRate, outputFile, range](RenderJobQueue::StartedFn started)
+            {
+                const int trackIndex = tracks.indexOf(track);
+                if (trackIndex < 0)
+                {
+                    started({}, "The track was removed before it rendered.");
+                    return;
+                }
+
+                // Only the span the track has material in (its previous freeze aside) is
+                // rendered; the pass tail carries releases and effect tails past the end.
+                const juce::String frozenPath = track->getFrozenRenderPath();
+                double startBeat = std::numeric_limits<double>::max();
+                double endBeat = 0.0;
+                for (const auto& clip : arrangement)
+                {
+                    if (clip.trackIndex != trackIndex)
+                        continue;
+                    if (clip.type == ClipType::Audio
+                        && ((frozenPath.isNotEmpty() && clip.audioFilePath == frozenPath)
+                            || clip.name.startsWithIgnoreCase("Freeze: ")))
+                        continue;
+                    startBeat = juce::jmin(startBeat, juce::jmax(0.0, clip.startBeat));
+                    endBeat = juce::jmax(endBeat, clip.startBeat + juce::jmax(0.0625, clip.lengthBeats));
+                }
+                if (endBeat <= startBeat)
+                {
+                    startBeat = 0.0;
+                    endBeat = juce::jmax(0.25, getProjectEndBeat());
+                }
+                *range = { startBeat, endBeat };
+
+                createIsolatedRenderEngine({ trackIndex }, trackIndex, renderSampleRate,
+                                           [this, track, taskType, outputFile, range, started](std::unique_ptr<IsolatedRenderEngine> createdEngine,
+                                                                                               const juce::String& error)
+                {
+                    if (createdEngine == nullptr)
+                    {
+                        started({}, error);
+                        return;
+                    }
+
+                    std::shared_ptr<IsolatedRenderEngine> engine = std::move(createdEngine);
+                    if (tracks.contains(track))
+                        track->setRenderTaskState(taskType, true, 0.0f);
+                    started([this, engine, outputFile, range](RenderJobQueue::JobContext& context, juce::String& renderError)
+                    {
+                        return renderTrackToAudioFile(*engine, outputFile, range->first, range->second, context, renderError);
+                    },
+                    {});
+                });
+            };
+
+            job.finish = [this, track, commit, trackName, outputFile, range, renderSampleRate](RenderJobQueue::JobState state,
+                                                                                                 const juce::String& error)
+            {
+                trackRenderJobs.erase(std::remove_if(trackRenderJobs.begin(),
+                                                     trackRenderJobs.end(),
+                                                     [track](const TrackRenderJob& job) { return job.track == track; }),
+                                      trackRenderJobs.end());
+
+                const int trackIndex = tracks.indexOf(track);
+                if (trackIndex >= 0)
+                    track->setRenderTaskState(Track::RenderTaskType::None, false, 0.0f);
+
+                if (state == RenderJobQueue::JobState::Succeeded && trackIndex >= 0)
+                {
+                    if (commit)
+                        finishCommitTrack(trackIndex, outputFile, range->first, range->second, renderSampleRate);
+                    else
+                        finishFreezeTrack(trackIndex, outputFile, range->first, range->second, renderSampleRate);
+                }
+                else if (state == RenderJobQueue::JobState::Failed)
+                {
+                    trackRenderErrors.add(trackName + ": " + (error.isNotEmpty() ? error : juce::String("Render failed.")));
+                }
+            };
+
+            const auto jobId = renderJobQueue.addJob(std::move(job));
+            jobForTrack[track] = jobId;
+            trackRenderJobs.push_back({ track, jobId });
+        }
+
+        refreshStatusText();
+    }
+
+    void MainComponent::finishTrackRenderBatch(const RenderJobQueue::Stats& stats)
+    {
+        const bool commit = renderTaskTypeRt.load(std::memory_order_relaxed) == static_cast<int>(Track::RenderTaskType::Commit);
+        const bool wasCancelled = renderCancelRequestedRt.exchange(false, std::memory_order_relaxed);
+        renderTaskTypeRt.store(static_cast<int>(Track::RenderTaskType::None), std::memory_order_relaxed);
+        renderProgressRt.store(wasCancelled ? 0.0f : 1.0f, std::memory_order_relaxed);
+        renderSpeedFactorRt.store(static_cast<float>(stats.speedFactor), std::memory_order_relaxed);
+        backgroundRenderBusyRt.store(false, std::memory_order_release);
+
+        juce::Logger::writeToLog("Track renders: " + juce::String(stats.finishedJobs) + " job(s) in "
+                                 + juce::String(stats.elapsedSeconds, 2) + " s ("
+                                 + juce::String(stats.speedFactor, 1) + "x realtime across "
+                                 + juce::String(renderJobQueue.getWorkerCount()) + " render workers, "
+                                 + juce::String(stats.failedJobs) + " failed"
+                                 + (wasCancelled ? ", cancelled)" : ")"));
+
+        if (!trackRenderErrors.isEmpty())
+        {
+            juce::StringArray shown;
+            for (int i = 0; i < juce::jmin(8, trackRenderErrors.size()); ++i)
+                shown.add(trackRenderErrors[i]);
+            if (trackRenderErrors.size() > shown.size())
+                shown.add("... and " + juce::String(trackRenderErrors.size() - shown.size()) + " more (see log).");
+            for (const auto& error : trackRenderErrors)
+                juce::Logger::writeToLog("Track render failed: " + error);
+
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                                                   commit ? "Commit Track" : "Freeze Track",
+                                                   shown.joinIntoString("\n"));
+            trackRenderErrors.clear();
+        }
+
+        refreshStatusText();
+    }
+
+    juce::String MainComponent::computeTrackRenderCacheKey(int trackIndex) const
+    {
+        if (!smartFreezeEnabled || !juce::isPositiveAndBelow(trackIndex, juce::jmin(tracks.size(), maxRealtimeTracks)))
+            return {};
+
+        // The track being worked on plays live, as do tracks taking input.
+        const auto* track = tracks[trackIndex];
+        if (track == nullptr
+            || trackIndex == selectedTrackIndex
+            || track->isArmed()
+            || track->isInputMonitoringEnabled()
+            || !TrackRenderCache::canCacheTrack(*track))
+            return {};
+
+        std::vector<const Clip*> trackClips;
+        for (const auto& clip : arrangement)
+            if (clip.trackIndex == trackIndex)
+                trackClips.push_back(&clip);
+        if (trackClips.empty())
+            return {};
+
+        return TrackRenderCache::computeKey(*track,
+                                            trackClips,
+                                            tempoEvents,
+                                            bpmRt.load(std::memory_order_relaxed),
+                                            globalTransposeRt.load(std::memory_order_relaxed),
+                                            sampleRateRt.load(std::memory_order_relaxed));
+    }
+
+    void MainComponent::updateTrackRenderCaches()
+    {
+        trackRenderCache.retainTracks(tracks);
+        if (!smartFreezeEnabled)
+            return;
+
+        // Plugin edits do not pass through the snapshot, so every track is re-keyed here;
+        // a cache that stopped matching is unpublished before the next render starts.
+        const double nowMs = juce::Time::getMillisecondCounterHiRes();
+        bool snapshotStale = false;
+        for (int trackIndex = 0; trackIndex < juce::jmin(tracks.size(), maxRealtimeTracks); ++trackIndex)
+            if (auto* track = tracks[trackIndex])
+                snapshotStale = trackRenderCache.setCurrentKey(track, computeTrackRenderCacheKey(trackIndex), nowMs) || snapshotStale;
+        if (snapshotStale)
+            rebuildRealtimeSnapshot(false);
+
+        // Idle time only: nothing else rendering and nothing being recorded.
+        if (renderCacheQueue.isBusy()
+            || renderJobQueue.isBusy()
+            || backgroundRenderBusyRt.load(std::memory_order_relaxed)
+            || transport.recording())
+            return;
+
+        for (int trackIndex = 0; trackIndex < juce::jmin(tracks.size(), maxRealtimeTracks); ++trackIndex)
+        {
+            auto* track = tracks[trackIndex];
+            if (track != nullptr && trackRenderCache.needsRender(track, nowMs))
+            {
+                queueTrackRenderCache(track, trackRenderCache.getCurrentKey(track));
+                return;
+            }
+        }
+    }
+
+    void MainComponent::queueTrackRenderCache(Track* track, const juce::String& key)
+    {
+        const double renderSampleRate = sampleRateRt.load(std::memory_order_relaxed);
+        if (track == nullptr || key.isEmpty() || renderSampleRate <= 0.0)
+            return;
+
+        auto entry = std::make_shared<TrackRenderCache::Entry>();
+        entry->key = key;
+        entry->file = trackRenderCache.getFileForKey(key);
+        entry->sampleRate = renderSampleRate;
+        auto pass = std::make_shared<IsolatedRenderEngine::Pass>();
+        pass->includeMasterProcessing = false;
+        // The render runs on until the plugins' tail has died away (reported tail, then
+        // silence), so long releases and reverbs are not cut off and dry tracks stop early.
+        pass->tailSeconds = Track::maxSleepTailSeconds;
+        pass->endTailOnSilence = true;
+        auto renderedSeconds = std::make_shared<double>(0.0);
+        trackRenderCache.renderStarted(track, key);
+
+        RenderJobQueue::Job job;
+        job.name = "Smart freeze " + track->getTrackName();
+        job.start = [this, track, key, entry, pass, renderedSeconds](RenderJobQueue::StartedFn started)
+        {
+            const int trackIndex = tracks.indexOf(track);
+            if (trackIndex < 0 || trackRenderCache.getCurrentKey(track) != key)
+            {
+                started({}, "The track changed before its cache rendered.");
+                return;
+            }
+
+            double startBeat = std::numeric_limits<double>::max();
+            double endBeat = 0.0;
+            for (const auto& clip : arrangement)
+            {
+                if (clip.trackIndex != trackIndex)
+                    continue;
+                startBeat = juce::jmin(startBeat, juce::jmax(0.0, clip.startBeat));
+                endBeat = juce::jmax(endBeat, clip.startBeat + juce::jmax(0.0625, clip.lengthBeats));
+            }
+            if (endBeat <= startBeat)
+            {
+                started({}, "The track has nothing to render.");
+                return;
+            }
+            pass->startBeat = startBeat;
+            pass->endBeat = endBeat;
+
+            createIsolatedRenderEngine({ trackIndex }, trackIndex, entry->sampleRate,
+                                       [this, entry, pass, renderedSeconds, startBeat, started](std::unique_ptr<IsolatedRenderEngine> createdEngine,
+                                                                                                 const juce::String& error)
+            {
+                if (createdEngine == nullptr)
+                {
+                    started({}, error);
+                    return;
+                }
+
+                std::shared_ptr<IsolatedRenderEngine> engine = std::move(createdEngine);
+                // Mute and solo act after the cache tap, so the clone renders either way.
+                if (auto* clone = engine->getTrack(0))
+                {
+                    clone->setMute(false);
+                    clone->setSolo(false);
+                }
+
+                entry->startBeat = startBeat;
+
+                started([this, engine, entry, pass, renderedSeconds](RenderJobQueue::JobContext& context, juce::String& renderError)
+                {
+                    entry->file.deleteFile();
+                    std::unique_ptr<juce::OutputStream> stream(entry->file.createOutputStream());
+                    if (stream == nullptr)
+                    {
+                        renderError = "Unable to create render cache file:\n" + entry->file.getFullPathName();
+                        return false;
+                    }
+
+                    juce::WavAudioFormat wavFormat;
+                    juce::AudioFormatWriterOptions writerOptions;
+                    writerOptions = writerOptions.withSampleRate(engine->getSampleRate())
+                                                 .withNumChannels(2)
+                                                 .withBitsPerSample(32);
+                    std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(stream, writerOptions));
+                    if (writer == nullptr)
+                    {
+                        renderError = "Unable to create WAV writer for render cache.";
+                        return false;
+                    }
 
-    void MainComponent::commitTrackToAudio(int trackIndex)
-    {
-        if (!juce::isPositiveAndBelow(trackIndex, tracks.size()))
-            return;
+                    OfflineStemCapture capture;
+                    capture.setTapPoint(OfflineStemCapture::TapPoint::PluginChain);
+                    capture.addTrackStem(0, std::move(writer));
+                    pass->stemCapture = &capture;
+                    const double renderSampleRate = engine->getSampleRate();
+                    const bool rendered = renderOfflinePassToSinks(
+                        *engine,
+                        nullptr,
+                        *pass,
+                        32,
+                        false,
+                        context.getCancelFlag(),
+                        [&context, renderSampleRate](const OfflineRenderProgress& progress)
+                        {
+                            context.setProgress(progress.getFraction(),
+                                                static_cast<double>(progress.samplesRendered) / renderSampleRate);
+                        });
+                    pass->stemCapture = nullptr;
+                    capture.close();
 
-        const double startBeat = 0.0;
-        const double endBeat = juce::jmax(startBeat + 0.25, getProjectEndBeat());
-        const double renderSampleRate = juce::jmax(22050.0, sampleRateRt.load(std::memory_order_relaxed));
-        auto commitDir = appDataDir.getChildFile("CommitCache");
-        commitDir.createDirectory();
-        const juce::String stem = juce::File::createLegalFileName("Commit_" + juce::String(trackIndex + 1) + "_" + tracks[trackIndex]->getTrackName());
-        const juce::File outputFile = commitDir.getNonexistentChildFile(stem, ".wav", false);
-        juce::Component::SafePointer<MainComponent> safeThis(this);
+                    if (!rendered)
+                    {
+                        entry->file.deleteFile();
+                        renderError = context.isCancelled() ? "Render cancelled." : "Render cache pass failed.";
+                        return false;
+                    }
+                    *renderedSeconds = static_cast<double>(engine->getLastProgress().samplesRendered) / renderSampleRate;
+                    return true;
+                },
+                {});
+            });
+        };
 
-        runRenderTask("Commit Track", [safeThis, trackIndex, outputFile, startBeat, endBeat, renderSampleRate]() mutable
+        job.finish = [this, track, key, entry, renderedSeconds](RenderJobQueue::JobState state, const juce::String& error)
         {
-            if (safeThis == nullptr)
-                return;
-
-            juce::String error;
-            const bool ok = safeThis->renderTrackToAudioFile(trackIndex,
-                                                             outputFile,
-                                                             startBeat,
-                                                             endBeat,
-                                                             renderSampleRate,
-                                                             false,
-                                                             error);
-            if (!ok)
-            {
-                if (error.startsWithIgnoreCase("Render cancelled"))
-                    return;
-                juce::MessageManager::callAsync([errorMessage = error.isNotEmpty() ? error
-                                                                                   : juce::String("Commit render failed.")]
-                {
-                    juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
-                                                           "Commit Track",
-                                                           errorMessage);
-                });
+            const bool succeeded = state == RenderJobQueue::JobState::Succeeded;
+            if (!tracks.contains(track) || !smartFreezeEnabled)
+            {
+                entry->file.deleteFile();
                 return;
             }
 
-            juce::MessageManager::callAsync([safeThis, trackIndex, outputFile, startBeat, endBeat, renderSampleRate]
+            if (succeeded)
+                entry->lengthBeats = juce::jmax(0.25, tempoMapIndex.beatAtSeconds(tempoMapIndex.secondsAtBeat(entry->startBeat) + *renderedSeconds) - entry->startBeat);
+
+            if (state == RenderJobQueue::JobState::Failed)
+                juce::Logger::writeToLog("Smart freeze: " + track->getTrackName() + " stays live (" + error + ")");
+            if (trackRenderCache.renderFinished(track, succeeded ? entry.get() : nullptr, key))
             {
-                if (safeThis == nullptr)
-                    return;
-                safeThis->finishCommitTrack(trackIndex, outputFile, startBeat, endBeat, renderSampleRate);
-            });
-        },
-        trackIndex,
-        Track::RenderTaskType::Commit);
+                rebuildRealtimeSnapshot(false);
+                refreshStatusText();
+            }
+        };
+
+        renderCacheQueue.addJob(std::move(job));
+    }
+
+    void MainComponent::setSmartFreezeEnabled(bool shouldEnable)
+    {
+        smartFreezeEnabled = shouldEnable;
+        if (!smartFreezeEnabled)
+            renderCacheQueue.cancelAll();
+
+        // Unpublish before any file goes away.
+        rebuildRealtimeSnapshot(false);
+        if (!smartFreezeEnabled)
+            trackRenderCache.clear();
+        saveStartupPreferences();
+        refreshStatusText();
+    }
+
+    void MainComponent::setTrackSleepEnabled(bool shouldEnable)
+    {
+        trackSleepEnabled = shouldEnable;
+        trackSleepEnabledRt.store(trackSleepEnabled, std::memory_order_relaxed);
+        saveStartupPreferences();
+        refreshStatusText();
     }
 
     void MainComponent::showHelpGuide()
@@ -12265,7 +12734,13 @@ namespace sampledex
         streamingAudioReadThread.stopThread(2000);
 
         backgroundRenderPool.removeAllJobs(true, 15000);
+        renderJobQueue.onIdle = nullptr;
+        renderJobQueue.cancelAll();
+        renderCacheQueue.cancelAll();
+        isolatedRenderEngine.reset();
         backgroundRenderBusyRt.store(false, std::memory_order_relaxed);
+        cancelPluginRestores();
+        pluginRestorePool.removeAllJobs(true, 15000);
         realtimeGraphScheduler.setWorkerCount(0);
 
         for (const auto& info : juce::MidiInput::getAvailableDevices())
@@ -12278,11 +12753,15 @@ namespace sampledex
         }
 
         {
-            const juce::ScopedLock audioLock(deviceManager.getAudioCallbackLock());
+            const juce::ScopedLock fileLock(audioTakeFileLock);
+            {
+                const juce::ScopedLock audioLock(deviceManager.getAudioCallbackLock());
+                recordCaptureRingActive = false;
+            }
             for (auto& take : audioTakeWriters)
             {
-                take.writer.reset();
                 take.active = false;
+                take.takeFile.close();
             }
         }
     }
@@ -12578,7 +13057,16 @@ namespace sampledex
         autoScanPluginsOnStartup = true;
         autoQuarantineOnUncleanExit = true;
         micPermissionPromptedOnce = false;
-        pluginScanPassTimeoutMs = 45000;
+        pluginScanTimeoutMs = 45000;
+        automationThinningTolerance = defaultAutomationThinningTolerance;
+        offlineRenderSettings = {};
+        stemExportIncludeBuses = false;
+        stemExportMemoryBudgetMb = defaultStemExportMemoryBudgetMb;
+        exportLoudnessTargetLufs = 0.0f;
+        exportTruePeakCeilingDb = -1.0f;
+        smartFreezeEnabled = false;
+        trackSleepEnabled = true;
+        calibratedRoundTripSamples.clear();
         preferredMacPluginFormat = "AudioUnit";
         if (canonicalBuildPath.trim().isEmpty())
             canonicalBuildPath = "/Users/robertclemons/Downloads/sampledex_daw-main/build/SampledexChordLab_artefacts/Release/Sampledex ChordLab.app";
@@ -12616,7 +13104,89 @@ namespace sampledex
             if (line.startsWithIgnoreCase("plugin_scan_pass_timeout_ms="))
             {
                 const int parsed = line.fromFirstOccurrenceOf("=", false, false).trim().getIntValue();
-                pluginScanPassTimeoutMs = juce::jlimit(10000, 120000, parsed > 0 ? parsed : 45000);
+                pluginScanTimeoutMs = juce::jlimit(10000, 120000, parsed > 0 ? parsed : 45000);
+                continue;
+            }
+
+            if (line.startsWithIgnoreCase("automation_thinning_tolerance="))
+            {
+                const float parsed = line.fromFirstOccurrenceOf("=", false, false).trim().getFloatValue();
+                automationThinningTolerance = juce::jlimit(0.0f, 0.05f, parsed);
+                continue;
+            }
+
+            if (line.startsWithIgnoreCase("offline_render_block_size="))
+            {
+                const int parsed = line.fromFirstOccurrenceOf("=", false, false).trim().getIntValue();
+                offlineRenderSettings.blockSize = juce::jlimit(OfflineRenderSettings::minBlockSize,
+                                                               OfflineRenderSettings::maxBlockSize,
+                                                               parsed > 0 ? parsed : OfflineRenderSettings::defaultBlockSize);
+                continue;
+            }
+
+            if (line.startsWithIgnoreCase("offline_render_workers="))
+            {
+                const int parsed = line.fromFirstOccurrenceOf("=", false, false).trim().getIntValue();
+                offlineRenderSettings.workerCount = juce::jlimit(0, RealtimeGraphScheduler::maxWorkerCount, parsed);
+                continue;
+            }
+
+            if (line.startsWithIgnoreCase("render_job_workers="))
+            {
+                const int parsed = line.fromFirstOccurrenceOf("=", false, false).trim().getIntValue();
+                renderJobWorkers = juce::jlimit(0, RenderJobQueue::maxWorkers, parsed);
+                continue;
+            }
+
+            if (line.startsWithIgnoreCase("stem_export_bus_stems="))
+            {
+                const auto value = line.fromFirstOccurrenceOf("=", false, false).trim();
+                stemExportIncludeBuses = value.getIntValue() != 0;
+                continue;
+            }
+
+            if (line.startsWithIgnoreCase("stem_export_memory_budget_mb="))
+            {
+                const int parsed = line.fromFirstOccurrenceOf("=", false, false).trim().getIntValue();
+                stemExportMemoryBudgetMb = juce::jlimit(16, 16384, parsed > 0 ? parsed : defaultStemExportMemoryBudgetMb);
+                continue;
+            }
+
+            if (line.startsWithIgnoreCase("export_loudness_target_lufs="))
+            {
+                const float parsed = line.fromFirstOccurrenceOf("=", false, false).trim().getFloatValue();
+                exportLoudnessTargetLufs = parsed < 0.0f ? juce::jlimit(-40.0f, -5.0f, parsed) : 0.0f;
+                continue;
+            }
+
+            if (line.startsWithIgnoreCase("export_true_peak_ceiling_db="))
+            {
+                const float parsed = line.fromFirstOccurrenceOf("=", false, false).trim().getFloatValue();
+                exportTruePeakCeilingDb = juce::jlimit(-9.0f, 0.0f, parsed);
+                continue;
+            }
+
+            if (line.startsWithIgnoreCase("smart_freeze_enabled="))
+            {
+                const auto value = line.fromFirstOccurrenceOf("=", false, false).trim();
+                smartFreezeEnabled = value.getIntValue() != 0;
+                continue;
+            }
+
+            if (line.startsWithIgnoreCase("track_sleep_enabled="))
+            {
+                const auto value = line.fromFirstOccurrenceOf("=", false, false).trim();
+                trackSleepEnabled = value.getIntValue() != 0;
+                continue;
+            }
+
+            if (line.startsWithIgnoreCase("latency_calibration="))
+            {
+                const auto value = line.fromFirstOccurrenceOf("=", false, false).trim();
+                const auto key = value.upToLastOccurrenceOf("|", false, false);
+                const int samples = value.fromLastOccurrenceOf("|", false, false).getIntValue();
+                if (key.isNotEmpty() && value.containsChar('|') && samples >= 0)
+                    calibratedRoundTripSamples[key] = samples;
                 continue;
             }
 
@@ -12648,7 +13218,19 @@ namespace sampledex
         lines.add("auto_scan_plugins_on_startup=" + juce::String(autoScanPluginsOnStartup ? 1 : 0));
         lines.add("auto_quarantine_on_unclean_exit=" + juce::String(autoQuarantineOnUncleanExit ? 1 : 0));
         lines.add("mic_permission_prompted_once=" + juce::String(micPermissionPromptedOnce ? 1 : 0));
-        lines.add("plugin_scan_pass_timeout_ms=" + juce::String(pluginScanPassTimeoutMs));
+        lines.add("plugin_scan_pass_timeout_ms=" + juce::String(pluginScanTimeoutMs));
+        lines.add("automation_thinning_tolerance=" + juce::String(automationThinningTolerance, 4));
+        lines.add("offline_render_block_size=" + juce::String(offlineRenderSettings.blockSize));
+        lines.add("offline_render_workers=" + juce::String(offlineRenderSettings.workerCount));
+        lines.add("render_job_workers=" + juce::String(renderJobWorkers));
+        lines.add("stem_export_bus_stems=" + juce::String(stemExportIncludeBuses ? 1 : 0));
+        lines.add("stem_export_memory_budget_mb=" + juce::String(stemExportMemoryBudgetMb));
+        lines.add("export_loudness_target_lufs=" + juce::String(exportLoudnessTargetLufs, 1));
+        lines.add("export_true_peak_ceiling_db=" + juce::String(exportTruePeakCeilingDb, 1));
+        lines.add("smart_freeze_enabled=" + juce::String(smartFreezeEnabled ? 1 : 0));
+        lines.add("track_sleep_enabled=" + juce::String(trackSleepEnabled ? 1 : 0));
+        for (const auto& [key, samples] : calibratedRoundTripSamples)
+            lines.add("latency_calibration=" + key + "|" + juce::String(samples));
         lines.add("mac_plugin_preferred_format="
                   + (preferredMacPluginFormat.equalsIgnoreCase("VST3")
                          ? juce::String("VST3")
@@ -12692,6 +13274,7 @@ namespace sampledex
     void MainComponent::resetStreamingStateForProjectSwitch()
     {
         panicAllNotes();
+        automationWriteRecorder.clear();
         transport.stop();
         transport.setRecording(false);
         recordStartPending = false;
@@ -12704,6 +13287,7 @@ namespace sampledex
         recordEnabledRt.store(false, std::memory_order_relaxed);
         recordButton.setToggleState(false, juce::dontSendNotification);
 
+        cancelPluginRestores();
         const juce::ScopedLock audioLock(deviceManager.getAudioCallbackLock());
         tracks.clear();
         arrangement.clear();
@@ -12760,28 +13344,13 @@ namespace sampledex
                                         : juce::String("Track " + juce::String(i + 1)),
                                     formatManager);
             track->setTransportPlayHead(&transport);
-            track->setVolume(sourceTrack.volume);
-            track->setPan(sourceTrack.pan);
-            track->setSendLevel(sourceTrack.sendLevel);
-            track->setSendTapMode(static_cast<Track::SendTapMode>(juce::jlimit(0, 2, sourceTrack.sendTapMode)));
-            track->setSendTargetBus(sourceTrack.sendTargetBus);
-            track->setMute(sourceTrack.mute);
-            track->setSolo(sourceTrack.solo);
+            RenderProjectBuilder::applyTrackState(*track, sourceTrack, i + 1, sampleRate, blockSize, loadWarnings);
             track->setArm(sourceTrack.arm);
             const bool enableMonitoringOnLoad = sourceTrack.inputMonitoring && !likelyBuiltInOnLoad;
             track->setInputMonitoring(enableMonitoringOnLoad);
             track->setInputSourcePair(sourceTrack.inputSourcePair);
             track->setInputMonitorGain(sourceTrack.inputMonitorGain);
             track->setMonitorTapMode(static_cast<Track::MonitorTapMode>(juce::jlimit(0, 1, sourceTrack.monitorTapMode)));
-            track->setChannelType(static_cast<Track::ChannelType>(juce::jlimit(0, 3, sourceTrack.channelType)));
-            track->setOutputTargetType(static_cast<Track::OutputTargetType>(juce::jlimit(0, 1, sourceTrack.outputTargetType)));
-            track->setOutputTargetBus(sourceTrack.outputTargetBus);
-            track->setEqEnabled(sourceTrack.eqEnabled);
-            track->setEqBandGains(sourceTrack.eqLowGainDb, sourceTrack.eqMidGainDb, sourceTrack.eqHighGainDb);
-            track->setBuiltInEffectsMask(sourceTrack.builtInFxMask);
-            track->setFrozenPlaybackOnly(false);
-            track->setFrozenRenderPath({});
-            track->prepareToPlay(sampleRate, juce::jmax(128, blockSize));
 
             if (sourceTrack.inputMonitoring && !enableMonitoringOnLoad)
             {
@@ -12789,34 +13358,6 @@ namespace sampledex
                                  + " input monitoring was disabled on load to prevent built-in mic feedback.");
             }
 
-            if (track->getChannelType() == Track::ChannelType::Audio)
-                track->disableBuiltInInstrument();
-
-            switch (track->getChannelType() == Track::ChannelType::Audio
-                        ? Track::BuiltInInstrument::None
-                        : static_cast<Track::BuiltInInstrument>(juce::jlimit(0, 2, sourceTrack.builtInInstrumentMode)))
-            {
-                case Track::BuiltInInstrument::None:
-                    track->disableBuiltInInstrument();
-                    break;
-                case Track::BuiltInInstrument::Sampler:
-                {
-                    juce::String samplerError;
-                    if (sourceTrack.samplerSamplePath.isNotEmpty()
-                        && !track->loadSamplerSoundFromFile(juce::File(sourceTrack.samplerSamplePath), samplerError))
-                    {
-                        loadWarnings.add("Track " + juce::String(i + 1)
-                                         + " sampler load failed: "
-                                         + (samplerError.isNotEmpty() ? samplerError : juce::String("Unknown error")));
-                    }
-                    break;
-                }
-                case Track::BuiltInInstrument::BasicSynth:
-                default:
-                    track->useBuiltInSynthInstrument();
-                    break;
-            }
-
             if (!safeModeStartup)
             {
                 for (const auto& slot : sourceTrack.pluginSlots)
@@ -12836,82 +13377,7 @@ namespace sampledex
                         continue;
                     }
 
-                    juce::String lastFailure;
-                    bool loaded = false;
-                    juce::PluginDescription loadedDescription;
-                    const bool isInstrumentSlot = slot.slotIndex == Track::instrumentSlotIndex;
-                    track->setPluginHostingPolicyForSlot(
-                        slot.slotIndex,
-                        static_cast<Track::PluginHostingPolicy>(juce::jlimit(0, 1, slot.hostingPolicy)));
-
-                    for (const auto& candidate : candidates)
-                    {
-                        if (isPluginQuarantined(candidate))
-                            continue;
-
-                        juce::String probeError;
-                        if (!runPluginIsolationProbe(candidate, isInstrumentSlot, probeError))
-                        {
-                            quarantinePlugin(candidate, probeError);
-                            lastFailure = probeError.isNotEmpty() ? probeError
-                                                                  : juce::String("Plugin probe failed.");
-                            continue;
-                        }
-
-                        juce::String pluginError;
-                        loaded = isInstrumentSlot
-                            ? track->loadInstrumentPlugin(candidate, pluginError)
-                            : track->loadPluginInSlot(slot.slotIndex, candidate, pluginError);
-                        if (!loaded || pluginError.isNotEmpty())
-                        {
-                            if (shouldQuarantinePluginLoadError(pluginError))
-                                quarantinePlugin(candidate, pluginError);
-                            lastFailure = pluginError.isNotEmpty() ? pluginError
-                                                                   : juce::String("Plugin load failed.");
-                            loaded = false;
-                            continue;
-                        }
-
-                        loadedDescription = candidate;
-                        break;
-                    }
-
-                    if (!loaded)
-                    {
-                        loadWarnings.add("Track " + juce::String(i + 1)
-                                         + " plugin load failed ("
-                                         + (slot.description.name.isNotEmpty() ? slot.description.name
-                                                                               : slot.description.fileOrIdentifier)
-                                         + "): "
-                                         + (lastFailure.isNotEmpty() ? lastFailure : juce::String("Unknown error")));
-                        continue;
-                    }
-
-                    if (slot.encodedState.isNotEmpty()
-                        && !track->setPluginStateForSlot(slot.slotIndex, slot.encodedState))
-                    {
-                        loadWarnings.add("Track " + juce::String(i + 1)
-                                         + " plugin state restore failed ("
-                                         + (slot.description.name.isNotEmpty() ? slot.description.name
-                                                                               : slot.description.fileOrIdentifier)
-                                         + ").");
-                    }
-                    track->setPluginSlotBypassed(slot.slotIndex, slot.bypassed);
-                    recordLastLoadedPlugin(loadedDescription);
-
-                    if (slot.description.pluginFormatName.isNotEmpty()
-                        && loadedDescription.pluginFormatName.isNotEmpty()
-                        && !loadedDescription.pluginFormatName.equalsIgnoreCase(slot.description.pluginFormatName))
-                    {
-                        loadWarnings.add("Track " + juce::String(i + 1)
-                                         + " plugin format fallback: "
-                                         + (loadedDescription.name.isNotEmpty() ? loadedDescription.name
-                                                                                : loadedDescription.fileOrIdentifier)
-                                         + " loaded as "
-                                         + loadedDescription.pluginFormatName
-                                         + " (requested "
-                                         + slot.description.pluginFormatName + ").");
-                    }
+                    queuePluginRestore(*track, i + 1, slot, std::move(candidates), loadWarnings);
                 }
             }
             else if (!sourceTrack.pluginSlots.empty())
@@ -12920,17 +13386,6 @@ namespace sampledex
                                  + " plugin chain skipped (Safe Mode startup).");
             }
 
-            track->setFrozenRenderPath(sourceTrack.frozenRenderPath);
-            const bool validFrozenClip = sourceTrack.frozenPlaybackOnly
-                                      && sourceTrack.frozenRenderPath.isNotEmpty()
-                                      && juce::File(sourceTrack.frozenRenderPath).existsAsFile();
-            track->setFrozenPlaybackOnly(validFrozenClip);
-            if (sourceTrack.frozenPlaybackOnly && !validFrozenClip)
-            {
-                loadWarnings.add("Track " + juce::String(i + 1)
-                                 + " frozen state disabled because frozen render file is missing.");
-            }
-
             tracks.add(track);
             trackMidiBuffers[static_cast<size_t>(i)].ensureSize(4096);
         }
@@ -12983,42 +13438,321 @@ namespace sampledex
         for (int trackIndex = 0; trackIndex < tracks.size(); ++trackIndex)
             ensureDefaultAutomationLanesForTrack(trackIndex);
 
-        loopButton.setToggleState(loadedProject.loopEnabled, juce::dontSendNotification);
-        transport.setLoop(loadedProject.loopEnabled,
-                          loadedProject.loopStartBeat,
-                          loadedProject.loopEndBeat);
-        loopEnabledRt.store(loadedProject.loopEnabled, std::memory_order_relaxed);
+        loopButton.setToggleState(loadedProject.loopEnabled, juce::dontSendNotification);
+        transport.setLoop(loadedProject.loopEnabled,
+                          loadedProject.loopStartBeat,
+                          loadedProject.loopEndBeat);
+        loopEnabledRt.store(loadedProject.loopEnabled, std::memory_order_relaxed);
+
+        sanitizeRoutingConfiguration(false);
+
+        if (tracks.isEmpty())
+            createNewTrack();
+
+        mixer.rebuildFromTracks(tracks);
+        timeline.refreshHeaders();
+        selectedClipIndex = -1;
+        setSelectedTrackIndex(juce::jlimit(0, juce::jmax(0, tracks.size() - 1), selectedTrackIndex));
+        timeline.selectTrack(selectedTrackIndex);
+        mixer.selectTrack(selectedTrackIndex);
+        undoManager.clearUndoHistory();
+        rebuildRealtimeSnapshot();
+        refreshChannelRackWindow();
+        resized();
+        refreshStatusText();
+        currentProjectFile = fileToLoad;
+        projectDirty = false;
+        projectMutationSerial = 0;
+        lastAutosaveSerial = 0;
+        autosaveProjectFile.deleteFile();
+
+        if (!loadWarnings.isEmpty())
+        {
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                                                   "Project Loaded With Warnings",
+                                                   loadWarnings.joinIntoString("\n"));
+        }
+
+        startQueuedPluginRestores();
+        return true;
+    }
+
+    void MainComponent::queuePluginRestore(Track& track,
+                                           int trackNumber,
+                                           const ProjectSerializer::PluginSlotState& slot,
+                                           juce::Array<juce::PluginDescription> candidates,
+                                           juce::StringArray& warnings)
+    {
+        const auto pluginLabel = slot.description.name.isNotEmpty() ? slot.description.name
+                                                                     : slot.description.fileOrIdentifier;
+        candidates.removeIf([this](const juce::PluginDescription& candidate) { return isPluginQuarantined(candidate); });
+        if (candidates.isEmpty())
+        {
+            warnings.add("Track " + juce::String(trackNumber)
+                         + " plugin load failed (" + pluginLabel + "): every installed variant is quarantined.");
+            return;
+        }
+
+        auto job = std::make_shared<PluginRestoreJob>();
+        job->track = &track;
+        job->trackNumber = trackNumber;
+        job->slot = slot;
+        job->candidates = std::move(candidates);
+        job->pendingToken = track.beginPendingPluginLoad(slot.slotIndex, slot.description);
+        if (job->pendingToken == 0)
+            return;
+
+        track.setPendingPluginState(slot.slotIndex, job->pendingToken, slot.state);
+        queuedPluginRestores.push_back(std::move(job));
+    }
+
+    void MainComponent::startQueuedPluginRestores()
+    {
+        pluginRestoreTotal = static_cast<int>(queuedPluginRestores.size());
+        pluginRestoreCompleted = 0;
+        pluginRestoreWarnings.clear();
+        for (auto& job : queuedPluginRestores)
+            dispatchPluginRestoreProbe(job);
+        queuedPluginRestores.clear();
+        refreshStatusText();
+    }
+
+    void MainComponent::dispatchPluginRestoreProbe(std::shared_ptr<PluginRestoreJob> job)
+    {
+        const auto executable = juce::File::getSpecialLocation(juce::File::currentExecutableFile);
+        const bool probesEnabled = pluginSafetyGuardsEnabled;
+        auto* device = deviceManager.getCurrentAudioDevice();
+        const double probeSampleRate = juce::jmax(44100.0,
+                                                  device != nullptr ? device->getCurrentSampleRate() : 44100.0);
+        const int probeBlockSize = juce::jlimit(64, 4096,
+                                                device != nullptr ? device->getCurrentBufferSizeSamples() : 512);
+
+        pluginRestorePool.addJob([safeThis = juce::Component::SafePointer<MainComponent>(this),
+                                  job,
+                                  generation = pluginRestoreGeneration,
+                                  executable,
+                                  probesEnabled,
+                                  probeSampleRate,
+                                  probeBlockSize]
+        {
+            if (!job->stateDecoded)
+            {
+                job->stateDecoded = true;
+                if (!job->slot.state.isEmpty())
+                    job->stateDecodeFailed = !job->slot.state.read(job->decodedState);
+            }
+
+            const bool isInstrumentSlot = job->slot.slotIndex == Track::instrumentSlotIndex;
+            for (; job->candidateIndex < job->candidates.size(); ++job->candidateIndex)
+            {
+                const auto& candidate = job->candidates.getReference(job->candidateIndex);
+                juce::String probeError;
+                if (!probesEnabled)
+                    break;
+                if (!executable.existsAsFile())
+                    probeError = "Plugin probe failed: host executable path not found.";
+                else if (runPluginProbeProcess(executable, candidate, isInstrumentSlot, probeSampleRate, probeBlockSize, probeError))
+                    break;
+
+                if (probeError.isEmpty())
+                    probeError = "Plugin probe failed.";
+                job->probeFailures.add(candidate);
+                job->probeFailureReasons.add(probeError);
+                job->lastFailure = probeError;
+            }
+
+            juce::MessageManager::callAsync([safeThis, job, generation]
+            {
+                if (safeThis == nullptr || generation != safeThis->pluginRestoreGeneration)
+                    return;
+                safeThis->handlePluginRestoreProbed(job);
+            });
+        });
+    }
+
+    void MainComponent::handlePluginRestoreProbed(std::shared_ptr<PluginRestoreJob> job)
+    {
+        for (int i = 0; i < job->probeFailures.size(); ++i)
+            quarantinePlugin(job->probeFailures.getReference(i), job->probeFailureReasons[i]);
+        job->probeFailures.clear();
+        job->probeFailureReasons.clear();
+
+        if (!tracks.contains(job->track)
+            || !job->track->isPendingPluginLoadCurrent(job->slot.slotIndex, job->pendingToken))
+        {
+            // The track or slot was changed while probing; nothing to restore into.
+            finishPluginRestore(*job, {});
+            return;
+        }
+
+        if (job->candidateIndex >= job->candidates.size())
+        {
+            job->track->cancelPendingPluginLoad(job->slot.slotIndex, job->pendingToken);
+            finishPluginRestore(*job, job->lastFailure.isNotEmpty() ? job->lastFailure : juce::String("Unknown error"));
+            return;
+        }
+
+        pluginRestoresReadyToInstantiate.push_back(std::move(job));
+        pumpPluginRestoreInstantiations();
+    }
+
+    void MainComponent::pumpPluginRestoreInstantiations()
+    {
+        while (pluginRestoresInstantiating < maxConcurrentPluginRestoreInstantiations
+               && !pluginRestoresReadyToInstantiate.empty())
+        {
+            auto job = pluginRestoresReadyToInstantiate.front();
+            pluginRestoresReadyToInstantiate.pop_front();
+            if (!tracks.contains(job->track)
+                || !job->track->isPendingPluginLoadCurrent(job->slot.slotIndex, job->pendingToken))
+            {
+                finishPluginRestore(*job, {});
+                continue;
+            }
+
+            PluginInstantiationService::Request request;
+            request.description = job->candidates.getReference(job->candidateIndex);
+            request.isInstrument = job->slot.slotIndex == Track::instrumentSlotIndex;
+            request.sampleRate = job->track->getPluginHostingSampleRate();
+            request.blockSize = job->track->getPluginHostingBlockSize();
+            request.sandboxed = job->track->getPluginHostingPolicyForSlot(job->slot.slotIndex)
+                                == Track::PluginHostingPolicy::IsolatedBridge;
+            request.onComplete = [safeThis = juce::Component::SafePointer<MainComponent>(this),
+                                  job,
+                                  generation = pluginRestoreGeneration](std::unique_ptr<juce::AudioPluginInstance> instance,
+                                                                        double preparedSampleRate,
+                                                                        int preparedBlockSize,
+                                                                        const juce::String& creationError)
+            {
+                if (safeThis == nullptr || generation != safeThis->pluginRestoreGeneration)
+                    return;
+                --safeThis->pluginRestoresInstantiating;
+                safeThis->handlePluginRestoreInstance(job,
+                                                      std::move(instance),
+                                                      preparedSampleRate,
+                                                      preparedBlockSize,
+                                                      creationError);
+                safeThis->pumpPluginRestoreInstantiations();
+            };
+
+            ++pluginRestoresInstantiating;
+            pluginInstantiationService.requestInstance(std::move(request));
+        }
+    }
+
+    void MainComponent::handlePluginRestoreInstance(std::shared_ptr<PluginRestoreJob> job,
+                                                    std::unique_ptr<juce::AudioPluginInstance> instance,
+                                                    double preparedSampleRate,
+                                                    int preparedBlockSize,
+                                                    const juce::String& creationError)
+    {
+        auto* track = job->track;
+        const int slotIndex = job->slot.slotIndex;
+        if (!tracks.contains(track) || !track->isPendingPluginLoadCurrent(slotIndex, job->pendingToken))
+        {
+            finishPluginRestore(*job, {});
+            return;
+        }
+
+        const auto loadedDescription = job->candidates.getReference(job->candidateIndex);
+        juce::String loadError = creationError;
+        const bool attached = instance != nullptr
+            && track->attachPreparedPlugin(slotIndex,
+                                           std::move(instance),
+                                           loadedDescription,
+                                           preparedSampleRate,
+                                           preparedBlockSize,
+                                           loadError,
+                                           job->pendingToken);
+        if (!attached)
+        {
+            if (shouldQuarantinePluginLoadError(loadError))
+                quarantinePlugin(loadedDescription, loadError);
+            job->lastFailure = loadError.isNotEmpty() ? loadError : juce::String("Plugin load failed.");
+            ++job->candidateIndex;
+            if (job->candidateIndex < job->candidates.size())
+            {
+                dispatchPluginRestoreProbe(job);
+                return;
+            }
+
+            track->cancelPendingPluginLoad(slotIndex, job->pendingToken);
+            finishPluginRestore(*job, job->lastFailure);
+            return;
+        }
 
-        sanitizeRoutingConfiguration(false);
+        const auto pluginLabel = job->slot.description.name.isNotEmpty() ? job->slot.description.name
+                                                                         : job->slot.description.fileOrIdentifier;
+        if (!job->slot.state.isEmpty()
+            && (job->stateDecodeFailed
+                || !track->setPluginStateForSlot(slotIndex,
+                                                 std::make_shared<const juce::MemoryBlock>(std::move(job->decodedState)))))
+        {
+            pluginRestoreWarnings.add("Track " + juce::String(job->trackNumber)
+                                      + " plugin state restore failed (" + pluginLabel + ").");
+        }
+        track->setPluginSlotBypassed(slotIndex, job->slot.bypassed);
+        recordLastLoadedPlugin(loadedDescription);
 
-        if (tracks.isEmpty())
-            createNewTrack();
+        if (job->slot.description.pluginFormatName.isNotEmpty()
+            && loadedDescription.pluginFormatName.isNotEmpty()
+            && !loadedDescription.pluginFormatName.equalsIgnoreCase(job->slot.description.pluginFormatName))
+        {
+            pluginRestoreWarnings.add("Track " + juce::String(job->trackNumber)
+                                      + " plugin format fallback: "
+                                      + (loadedDescription.name.isNotEmpty() ? loadedDescription.name
+                                                                             : loadedDescription.fileOrIdentifier)
+                                      + " loaded as "
+                                      + loadedDescription.pluginFormatName
+                                      + " (requested "
+                                      + job->slot.description.pluginFormatName + ").");
+        }
 
-        mixer.rebuildFromTracks(tracks);
-        timeline.refreshHeaders();
-        selectedClipIndex = -1;
-        setSelectedTrackIndex(juce::jlimit(0, juce::jmax(0, tracks.size() - 1), selectedTrackIndex));
-        timeline.selectTrack(selectedTrackIndex);
-        mixer.selectTrack(selectedTrackIndex);
-        undoManager.clearUndoHistory();
-        rebuildRealtimeSnapshot();
         refreshChannelRackWindow();
-        resized();
+        finishPluginRestore(*job, {});
+    }
+
+    void MainComponent::finishPluginRestore(const PluginRestoreJob& job, const juce::String& failure)
+    {
+        if (failure.isNotEmpty())
+        {
+            pluginRestoreWarnings.add("Track " + juce::String(job.trackNumber)
+                                      + " plugin load failed ("
+                                      + (job.slot.description.name.isNotEmpty() ? job.slot.description.name
+                                                                                : job.slot.description.fileOrIdentifier)
+                                      + "): " + failure);
+        }
+
+        ++pluginRestoreCompleted;
         refreshStatusText();
-        currentProjectFile = fileToLoad;
-        projectDirty = false;
-        projectMutationSerial = 0;
-        lastAutosaveSerial = 0;
-        autosaveProjectFile.deleteFile();
+        if (pluginRestoreCompleted < pluginRestoreTotal)
+            return;
 
-        if (!loadWarnings.isEmpty())
+        // Plugin latencies are known now.
+        rebuildRealtimeSnapshot();
+        refreshChannelRackWindow();
+        if (!pluginRestoreWarnings.isEmpty())
         {
             juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
-                                                   "Project Loaded With Warnings",
-                                                   loadWarnings.joinIntoString("\n"));
+                                                   "Plugins Restored With Warnings",
+                                                   pluginRestoreWarnings.joinIntoString("\n"));
         }
+        pluginRestoreWarnings.clear();
+        pluginRestoreTotal = 0;
+        pluginRestoreCompleted = 0;
+    }
 
-        return true;
+    void MainComponent::cancelPluginRestores()
+    {
+        // Late probe and instantiation callbacks compare against the generation and drop out.
+        ++pluginRestoreGeneration;
+        pluginRestorePool.removeAllJobs(false, 0);
+        queuedPluginRestores.clear();
+        pluginRestoresReadyToInstantiate.clear();
+        pluginRestoresInstantiating = 0;
+        pluginRestoreWarnings.clear();
+        pluginRestoreTotal = 0;
+        pluginRestoreCompleted = 0;
     }
 
     void MainComponent::relinkMissingAudioFiles(std::vector<Clip>& clips,
@@ -13083,9 +13817,9 @@ namespace sampledex
         beginPluginScan();
     }
 
-    void MainComponent::beginPluginScan()
+    void MainComponent::beginPluginScan(bool rescanEverything)
     {
-        if (pluginScanProcess != nullptr && pluginScanProcess->isRunning())
+        if (pluginScanner == nullptr || pluginScanner->isScanning())
             return;
 
         if (formatManager.getNumFormats() == 0)
@@ -13096,8 +13830,8 @@ namespace sampledex
             return;
         }
 
-        pendingScanFormats = getPluginScanFormatsInPreferredOrder();
-        if (pendingScanFormats.isEmpty())
+        const auto scanFormats = getPluginScanFormatsInPreferredOrder();
+        if (scanFormats.isEmpty())
         {
             juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
                                                    "Plugin Scan",
@@ -13105,80 +13839,39 @@ namespace sampledex
             return;
         }
 
-        scanButton.setEnabled(false);
-        scanButton.setButtonText("Scanning...");
-        pluginScanPassCount = 0;
-        pluginScanTotalPassCount = pendingScanFormats.size();
-        pluginScanProgress = -1.0;
-        scanPassStartTimeMs = 0.0;
-        activeScanFormat.clear();
+        PluginScanner::Options options;
+        options.hostExecutable = juce::File::getSpecialLocation(juce::File::currentExecutableFile);
+        options.formatNames = scanFormats;
+        options.maxConcurrentScans = juce::jlimit(2, 8, juce::SystemStats::getNumCpus());
+        options.perPluginTimeoutMs = pluginScanTimeoutMs;
+        options.rescanEverything = rescanEverything;
+
         pluginScanFailedItems.clear();
         pluginScanBlacklistedItems.clear();
-        pluginScanStatusLabel.setText("Plugin scan: preparing...", juce::dontSendNotification);
-        pluginScanDeadMansPedalFile.deleteFile();
-        resized();
-        refreshStatusText();
-
-        if (!startPluginScanPass())
-            finishPluginScan(false, "Unable to launch isolated plugin scan process.");
-    }
-
-    bool MainComponent::startPluginScanPass()
-    {
-        if (pendingScanFormats.isEmpty())
-            return false;
-
-        const auto executable = juce::File::getSpecialLocation(juce::File::currentExecutableFile);
-        if (!executable.existsAsFile())
-            return false;
-
-        activeScanFormat = pendingScanFormats[0];
-        pendingScanFormats.remove(0);
-        pluginScanDeadMansPedalFile.deleteFile();
-
-        const juce::String command = executable.getFullPathName().quoted()
-                                   + " --plugin-scan-pass"
-                                   + " --known=" + knownPluginListFile.getFullPathName().quoted()
-                                   + " --deadman=" + pluginScanDeadMansPedalFile.getFullPathName().quoted()
-                                   + " --plugin-scan-format=" + activeScanFormat.quoted()
-                                   + " --plugin-scan-timeout-ms=" + juce::String(pluginScanPassTimeoutMs);
-
-        pluginScanProcess = std::make_unique<juce::ChildProcess>();
-        if (!pluginScanProcess->start(command))
+        if (!pluginScanner->start(options))
         {
-            pluginScanProcess.reset();
-            return false;
+            finishPluginScan(false, "Unable to launch isolated plugin scan process.");
+            return;
         }
 
-        ++pluginScanPassCount;
+        scanButton.setEnabled(false);
+        scanButton.setButtonText("Scanning...");
         pluginScanProgress = -1.0;
-        scanPassStartTimeMs = juce::Time::getMillisecondCounterHiRes();
-        const auto passLabel = juce::String(pluginScanPassCount)
-                             + "/" + juce::String(juce::jmax(1, pluginScanTotalPassCount));
-        const auto displayFormat = scanFormatDisplayName(activeScanFormat);
-        scanButton.setButtonText("Scanning " + displayFormat + "... (" + passLabel + ")");
-        pluginScanStatusLabel.setText("Scanning " + displayFormat
-                                          + " (pass " + passLabel + ")",
-                                      juce::dontSendNotification);
+        pluginScanStatusLabel.setText("Plugin scan: checking plugin folders...", juce::dontSendNotification);
         resized();
         refreshStatusText();
-        return true;
     }
 
     void MainComponent::finishPluginScan(bool success, const juce::String& detailMessage)
     {
-        if (pluginScanProcess != nullptr && pluginScanProcess->isRunning())
-            pluginScanProcess->kill();
-        pluginScanProcess.reset();
+        const int scannedCount = pluginScanner != nullptr ? pluginScanner->getNumScanned() : 0;
+        const int unchangedCount = pluginScanner != nullptr ? pluginScanner->getNumUnchanged() : 0;
+        if (pluginScanner != nullptr && pluginScanner->isScanning())
+            pluginScanner->cancel();
 
         scanButton.setEnabled(true);
         scanButton.setButtonText("Scan Plugins");
-        pluginScanPassCount = 0;
-        pluginScanTotalPassCount = 0;
         pluginScanProgress = 0.0;
-        scanPassStartTimeMs = 0.0;
-        activeScanFormat.clear();
-        pendingScanFormats.clear();
         pluginScanStatusLabel.setText(success ? "Plugin scan complete" : "Plugin scan failed",
                                       juce::dontSendNotification);
         resized();
@@ -13186,14 +13879,14 @@ namespace sampledex
 
         if (success)
         {
-            if (knownPluginListFile.existsAsFile())
-            {
-                std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(knownPluginListFile));
-                if (xml != nullptr)
-                    knownPluginList.recreateFromXml(*xml);
-            }
+            if (std::unique_ptr<juce::XmlElement> xml(knownPluginList.createXml()); xml != nullptr)
+                xml->writeTo(knownPluginListFile);
+            savePluginStabilityStats();
 
             juce::String completionMessage = "Plugin scan complete.";
+            completionMessage << "\n\nScanned " << scannedCount << " new or changed plugin file"
+                              << (scannedCount == 1 ? "" : "s") << ", "
+                              << unchangedCount << " unchanged.";
             if (!pluginScanFailedItems.isEmpty())
             {
                 completionMessage
@@ -13203,7 +13896,7 @@ namespace sampledex
             if (!pluginScanBlacklistedItems.isEmpty())
             {
                 completionMessage
-                    << "\n\nAuto-blacklisted from dead-man recovery:\n"
+                    << "\n\nQuarantined after crashing or hanging the scanner:\n"
                     << pluginScanBlacklistedItems.joinIntoString("\n");
             }
             if (detailMessage.isNotEmpty() && pluginScanFailedItems.isEmpty())
@@ -13231,54 +13924,37 @@ namespace sampledex
     {
         drainRetiredRealtimeSnapshots();
 
-        if (pluginScanProcess != nullptr)
+        if (latencyCalibrator.isCaptureComplete())
+            finishLatencyCalibration();
+        else if (latencyCalibrator.isRunning()
+                 && (transport.playing()
+                     || juce::Time::getMillisecondCounterHiRes() - latencyCalibrationStartedMs > latencyCalibrationTimeoutMs))
         {
-            if (pluginScanProcess->isRunning())
-            {
-                pluginScanProgress = -1.0;
-                pluginScanStatusBar.repaint();
+            latencyCalibrator.cancel();
+            juce::Logger::writeToLog("Latency calibration cancelled.");
+        }
 
-                if (scanPassStartTimeMs > 0.0)
+        if (pluginScanner != nullptr && pluginScanner->isScanning())
+        {
+            pluginScanner->poll();
+            if (pluginScanner->isScanning())
+            {
+                const int total = pluginScanner->getNumToScan();
+                const int scanned = pluginScanner->getNumScanned();
+                pluginScanProgress = (pluginScanner->isPlanning() || total <= 0)
+                    ? -1.0
+                    : static_cast<double>(scanned) / static_cast<double>(total);
+                if (!pluginScanner->isPlanning())
                 {
-                    const auto elapsedMs = juce::Time::getMillisecondCounterHiRes() - scanPassStartTimeMs;
-                    if (elapsedMs > static_cast<double>(juce::jmax(1000, pluginScanPassTimeoutMs)))
-                    {
-                        pluginScanProcess->kill();
-                        const auto output = pluginScanProcess->readAllProcessOutput().trim();
-                        pluginScanProcess.reset();
-                        handlePluginScanPassResult(-1, output, true);
-
-                        if (!pendingScanFormats.isEmpty())
-                        {
-                            if (startPluginScanPass())
-                                return;
-                            finishPluginScan(false, "Unable to launch isolated plugin scan process.");
-                            return;
-                        }
-
-                        finishPluginScan(true, output);
-                        return;
-                    }
+                    const auto progressLabel = juce::String(scanned) + "/" + juce::String(total);
+                    scanButton.setButtonText("Scanning... (" + progressLabel + ")");
+                    pluginScanStatusLabel.setText("Scanning " + progressLabel
+                                                      + " (" + juce::String(pluginScanner->getNumRunning()) + " parallel, "
+                                                      + juce::String(pluginScanner->getNumUnchanged()) + " unchanged)",
+                                                  juce::dontSendNotification);
                 }
-                return;
-            }
-
-            const int exitCode = static_cast<int>(pluginScanProcess->getExitCode());
-            const auto output = pluginScanProcess->readAllProcessOutput().trim();
-            pluginScanProcess.reset();
-            scanPassStartTimeMs = 0.0;
-
-            handlePluginScanPassResult(exitCode, output, false);
-            if (!pendingScanFormats.isEmpty())
-            {
-                if (startPluginScanPass())
-                    return;
-                finishPluginScan(false, "Unable to launch isolated plugin scan process.");
-                return;
+                pluginScanStatusBar.repaint();
             }
-
-            finishPluginScan(true, output);
-            return;
         }
 
         static int midiDeviceRefreshTicks = 0;
@@ -13333,6 +14009,12 @@ namespace sampledex
             refreshAudioEngineSelectors();
         }
 
+        if (++renderCacheTimerTicks >= renderCacheUpdateTicks)
+        {
+            renderCacheTimerTicks = 0;
+            updateTrackRenderCaches();
+        }
+
         updateDetectedSyncSource();
         applyFeedbackSafetyIfRequested();
         drainTrackPluginDiagnostics();
@@ -13515,15 +14197,40 @@ namespace sampledex
             metronomeEnabledRt.store(false, std::memory_order_relaxed);
         }
 
+        juce::String renderJobLabel;
+        if (renderJobQueue.isBusy())
+        {
+            const auto stats = renderJobQueue.getStats();
+            renderProgressRt.store(stats.progress, std::memory_order_relaxed);
+            renderSpeedFactorRt.store(static_cast<float>(stats.speedFactor), std::memory_order_relaxed);
+            for (const auto& job : trackRenderJobs)
+                if (tracks.contains(job.track) && job.track->isRenderTaskActive())
+                    job.track->setRenderTaskState(job.track->getRenderTaskType(), true, renderJobQueue.getJobProgress(job.jobId));
+
+            renderJobLabel = renderTaskTypeRt.load(std::memory_order_relaxed) == static_cast<int>(Track::RenderTaskType::Commit)
+                                 ? "Commit"
+                                 : "Freeze";
+            if (stats.totalJobs > 1)
+                renderJobLabel << " " << juce::String(stats.finishedJobs) << "/" << juce::String(stats.totalJobs);
+        }
+
         if (backgroundRenderBusyRt.load(std::memory_order_relaxed))
         {
             const int renderTrackIndex = renderTrackIndexRt.load(std::memory_order_relaxed);
             const float progress = juce::jlimit(0.0f, 1.0f, renderProgressRt.load(std::memory_order_relaxed));
-            juce::String taskLabel = "Render";
-            if (juce::isPositiveAndBelow(renderTrackIndex, tracks.size()) && tracks[renderTrackIndex] != nullptr)
+            juce::String taskLabel = renderTaskTypeRt.load(std::memory_order_relaxed) == static_cast<int>(Track::RenderTaskType::Export)
+                                         ? "Export"
+                                         : "Render";
+            if (renderJobLabel.isNotEmpty())
+                taskLabel = renderJobLabel;
+            else if (juce::isPositiveAndBelow(renderTrackIndex, tracks.size()) && tracks[renderTrackIndex] != nullptr)
                 taskLabel = tracks[renderTrackIndex]->getRenderTaskLabel();
             const juce::String pct = juce::String(juce::roundToInt(progress * 100.0f)) + "%";
-            freezeButton.setButtonText(taskLabel + " " + pct);
+            // Render clones are still creating their plugins.
+            if (renderClonePluginLoadsPending > 0)
+                freezeButton.setButtonText(taskLabel + " loading " + juce::String(renderClonePluginLoadsPending) + " plugin(s)");
+            else
+                freezeButton.setButtonText(taskLabel + " " + pct);
             freezeButton.setTooltip("Background render in progress. Open menu to cancel.");
         }
         else
@@ -13569,6 +14276,7 @@ namespace sampledex
         for (auto* track : tracks)
             snapshot->trackPointers.push_back(track);
         snapshot->tempoEvents = tempoEvents;
+        snapshot->tempoMap = tempoMapIndex;
         snapshot->automationLanes = automationLanes;
         snapshot->globalTransposeSemitones = globalTransposeRt.load(std::memory_order_relaxed);
         snapshot->audioClipStreams.resize(snapshot->arrangement.size());
@@ -13602,6 +14310,44 @@ namespace sampledex
                 clip.audioSampleRate = it->second->getSampleRate();
         }
 
+        // An edit that reaches the snapshot re-keys cached tracks first, so a stale render
+        // is never published.
+        snapshot->renderCacheForTrack.assign(snapshot->trackPointers.size(), -1);
+        const double nowMs = juce::Time::getMillisecondCounterHiRes();
+        for (int trackIndex = 0; smartFreezeEnabled && trackIndex < juce::jmin(tracks.size(), maxRealtimeTracks); ++trackIndex)
+        {
+            auto* track = tracks[trackIndex];
+            if (track == nullptr || trackRenderCache.getActiveEntry(track) == nullptr)
+                continue;
+            trackRenderCache.setCurrentKey(track, computeTrackRenderCacheKey(trackIndex), nowMs);
+            const auto* entry = trackRenderCache.getActiveEntry(track);
+            if (entry == nullptr || !entry->file.existsAsFile())
+                continue;
+
+            const auto key = entry->file.getFullPathName();
+            auto it = streamingClipCache.find(key);
+            if (it == streamingClipCache.end() || it->second == nullptr || !it->second->isReady())
+            {
+                auto stream = std::make_shared<StreamingClipSource>(entry->file, audioFormatManager, streamingAudioReadThread);
+                if (!stream->isReady())
+                    continue;
+                it = streamingClipCache.insert_or_assign(key, stream).first;
+            }
+            const auto& stream = it->second;
+
+            Clip cacheClip;
+            cacheClip.type = ClipType::Audio;
+            cacheClip.name = "Smart Freeze: " + track->getTrackName();
+            cacheClip.startBeat = entry->startBeat;
+            cacheClip.lengthBeats = entry->lengthBeats;
+            cacheClip.trackIndex = trackIndex;
+            cacheClip.audioFilePath = entry->file.getFullPathName();
+            cacheClip.audioSampleRate = stream->getSampleRate();
+            snapshot->renderCacheForTrack[static_cast<size_t>(trackIndex)] = static_cast<int>(snapshot->renderCacheClips.size());
+            snapshot->renderCacheClips.push_back(std::move(cacheClip));
+            snapshot->renderCacheStreams.push_back(stream);
+        }
+
         auto newSnapshot = std::static_pointer_cast<const RealtimeStateSnapshot>(snapshot);
         realtimeSnapshotState.storeSnapshot(std::move(newSnapshot));
 
@@ -13617,6 +14363,8 @@ namespace sampledex
     void MainComponent::drainRetiredRealtimeSnapshots()
     {
         realtimeSnapshotState.drainRetiredSnapshots();
+        for (auto* track : tracks)
+            track->drainRetiredPluginObjects();
     }
 
     void MainComponent::setSelectedTrackIndex(int idx)
@@ -13645,57 +14393,22 @@ namespace sampledex
         bpmRt.store(bpm, std::memory_order_relaxed);
         transport.setTempo(bpm);
 
-        bool updatedBaseEvent = false;
-        for (auto& event : tempoEvents)
-        {
-            if (std::abs(event.beat) <= 1.0e-6)
-            {
-                event.bpm = bpm;
-                updatedBaseEvent = true;
-                break;
-            }
-        }
-        if (!updatedBaseEvent)
-            tempoEvents.push_back({ 0.0, bpm });
-
+        RenderProjectBuilder::setBaseTempo(tempoEvents, bpm);
         rebuildTempoEventMap();
     }
 
     void MainComponent::rebuildTempoEventMap()
     {
-        for (auto& event : tempoEvents)
-        {
-            event.beat = juce::jmax(0.0, event.beat);
-            event.bpm = juce::jmax(1.0, event.bpm);
-        }
-
-        std::sort(tempoEvents.begin(), tempoEvents.end(),
-                  [](const TempoEvent& a, const TempoEvent& b)
-                  {
-                      if (std::abs(a.beat - b.beat) > 1.0e-9)
-                          return a.beat < b.beat;
-                      return a.bpm < b.bpm;
-                  });
-
-        if (tempoEvents.empty())
-            tempoEvents.push_back({ 0.0, bpm });
-        else if (tempoEvents.front().beat > 1.0e-6)
-            tempoEvents.insert(tempoEvents.begin(), TempoEvent { 0.0, bpm });
-
+        RenderProjectBuilder::normaliseTempoEvents(tempoEvents, bpm);
+        tempoMapIndex.rebuild(tempoEvents, bpm);
         rebuildRealtimeSnapshot();
     }
 
     double MainComponent::getTempoAtBeat(double beat) const
     {
-        const double clampedBeat = juce::jmax(0.0, beat);
-        double result = juce::jmax(1.0, bpmRt.load(std::memory_order_relaxed));
-        for (const auto& event : tempoEvents)
-        {
-            if (event.beat > clampedBeat + 1.0e-9)
-                break;
-            result = juce::jmax(1.0, event.bpm);
-        }
-        return result;
+        if (tempoMapIndex.isEmpty())
+            return juce::jmax(1.0, bpmRt.load(std::memory_order_relaxed));
+        return tempoMapIndex.getTempoAtBeat(juce::jmax(0.0, beat));
     }
 
     void MainComponent::addTempoEvent(double beat, double tempoBpm)
@@ -13949,12 +14662,15 @@ namespace sampledex
 
         int armedCount = 0;
         int monitorCount = 0;
+        int sleepingCount = 0;
         for (auto* track : tracks)
         {
             if (track->isArmed())
                 ++armedCount;
             if (track->isInputMonitoringEnabled())
                 ++monitorCount;
+            if (track->getSleepStats().asleep)
+                ++sleepingCount;
         }
 
         const juce::String transportState = transport.playing() ? "Playing" : "Stopped";
@@ -14005,7 +14721,10 @@ namespace sampledex
                                      + " OL " + juce::String(overloadCount)
                                      + " IUR " + juce::String(inputUnderruns)
                                      + " PML " + juce::String(midiLockMisses)
-                                     + " LL " + (lowLatencyMode ? juce::String("ON") : juce::String("OFF"));
+                                     + " LL " + (lowLatencyMode ? juce::String("ON") : juce::String("OFF"))
+                                     + " Sleep " + (trackSleepEnabled
+                                                        ? juce::String(sleepingCount) + "/" + juce::String(tracks.size())
+                                                        : juce::String("OFF"));
         const juce::String liveInState = "InCh " + juce::String(activeInputChannelCountRt.load(std::memory_order_relaxed));
         const juce::String monitorSafeState = monitorSafeMode ? "MonSafe ON" : "MonSafe OFF";
         const float inputTrim = inputMonitorSafetyTrimRt.load(std::memory_order_relaxed);
@@ -14023,11 +14742,21 @@ namespace sampledex
         const juce::String pendingRecordState = recordStartPending
             ? ("Rec@" + juce::String(recordStartPendingBeat, 2))
             : "Rec@Now";
+        const juce::String recordRingState = recordCaptureRing.isPrepared()
+            ? ("RecRing "
+               + juce::String(juce::roundToInt(100.0 * recordCaptureRing.getHighWaterFrames()
+                                               / juce::jmax(1, recordCaptureRing.getCapacityFrames())))
+               + "% OVF " + juce::String(recordCaptureRing.getOverflowCount()))
+            : juce::String("RecRing Idle");
         const bool renderBusy = backgroundRenderBusyRt.load(std::memory_order_relaxed);
+        const float renderSpeedFactor = renderSpeedFactorRt.load(std::memory_order_relaxed);
         const juce::String renderState = renderBusy
             ? (juce::String("Render ")
                + juce::String(juce::roundToInt(juce::jlimit(0.0f, 1.0f, renderProgressRt.load(std::memory_order_relaxed)) * 100.0f))
-               + "%")
+               + "%"
+               + (renderSpeedFactor > 0.0f ? " " + juce::String(renderSpeedFactor, 1) + "x" : juce::String())
+               + (renderClonePluginLoadsPending > 0 ? " (loading " + juce::String(renderClonePluginLoadsPending) + " plugins)"
+                                                    : juce::String()))
             : juce::String("Render Idle");
         const int startupGuardBlocksRemaining = startupSafetyBlocksRemainingRt.load(std::memory_order_relaxed);
         const int startupMuteBlocksRemaining = outputSafetyMuteBlocksRt.load(std::memory_order_relaxed);
@@ -14050,13 +14779,15 @@ namespace sampledex
             juce::Logger::writeToLog("Startup/output safety: severe output fault detected; safety mute + guard extension applied.");
             previousStartupFaultEvents = startupFaultEvents;
         }
-        const juce::String scanState = (pluginScanProcess != nullptr)
-            ? ("Scan " + scanFormatDisplayName(activeScanFormat)
-               + " "
-               + juce::String(juce::jmax(1, pluginScanPassCount))
-               + "/"
-               + juce::String(juce::jmax(1, pluginScanTotalPassCount)))
+        const juce::String scanState = (pluginScanner != nullptr && pluginScanner->isScanning())
+            ? (pluginScanner->isPlanning()
+                   ? juce::String("Scan Checking")
+                   : ("Scan " + juce::String(pluginScanner->getNumScanned())
+                      + "/" + juce::String(pluginScanner->getNumToScan())))
             : juce::String("Scan Idle");
+        const juce::String pluginRestoreState = pluginRestoreTotal > 0
+            ? ("Plugins " + juce::String(pluginRestoreCompleted) + "/" + juce::String(pluginRestoreTotal))
+            : juce::String("Plugins Ready");
 
         statusLabel.setText(trackText + "  |  " + sendText + "  |  " + clipText + "  |  " + midiText
                             + "  |  " + midiOutText
@@ -14076,6 +14807,7 @@ namespace sampledex
                             + "  |  " + countInState
                             + "  |  " + punchState
                             + "  |  " + pendingRecordState
+                            + "  |  " + recordRingState
                             + "  |  " + transportState + " / " + recState
                             + "  |  " + followState
                             + "  |  " + auxState
@@ -14085,6 +14817,7 @@ namespace sampledex
                             + "  |  " + renderState
                             + "  |  " + startupSafetyState
                             + "  |  " + scanState
+                            + "  |  " + pluginRestoreState
                             + "  |  Tips: click I1-I4, right-click tracks/strips (send level + mode + bus), vertical-drag empty lanes to reorder",
                             juce::dontSendNotification);
     }
@@ -15013,114 +15746,18 @@ namespace sampledex
         }
 
         auto* sourceTrack = tracks[sourceTrackIndex];
-        auto* clonedTrack = new Track(sourceTrack->getTrackName() + " Copy", formatManager);
-        clonedTrack->setTransportPlayHead(&transport);
-        clonedTrack->setVolume(sourceTrack->getVolume());
-        clonedTrack->setPan(sourceTrack->getPan());
-        clonedTrack->setSendLevel(sourceTrack->getSendLevel());
-        clonedTrack->setSendTapMode(sourceTrack->getSendTapMode());
-        clonedTrack->setSendTargetBus(sourceTrack->getSendTargetBus());
-        clonedTrack->setMute(sourceTrack->isMuted());
-        clonedTrack->setSolo(sourceTrack->isSolo());
-        clonedTrack->setArm(false);
-        clonedTrack->setInputMonitoring(false);
-        clonedTrack->setInputSourcePair(sourceTrack->getInputSourcePair());
-        clonedTrack->setMonitorTapMode(sourceTrack->getMonitorTapMode());
-        clonedTrack->setInputMonitorGain(sourceTrack->getInputMonitorGain());
-        clonedTrack->setChannelType(sourceTrack->getChannelType());
-        clonedTrack->setOutputTargetType(sourceTrack->getOutputTargetType());
-        clonedTrack->setOutputTargetBus(sourceTrack->getOutputTargetBus());
-        clonedTrack->setEqEnabled(sourceTrack->isEqEnabled());
-        clonedTrack->setEqBandGains(sourceTrack->getEqLowGainDb(),
-                                    sourceTrack->getEqMidGainDb(),
-                                    sourceTrack->getEqHighGainDb());
-        clonedTrack->setBuiltInEffectsMask(sourceTrack->getBuiltInEffectsMask());
-
         juce::AudioDeviceManager::AudioDeviceSetup setup;
         deviceManager.getAudioDeviceSetup(setup);
         const double sampleRate = setup.sampleRate > 0.0 ? setup.sampleRate : sampleRateRt.load(std::memory_order_relaxed);
         const int blockSize = setup.bufferSize > 0 ? setup.bufferSize : 512;
-        clonedTrack->prepareToPlay(sampleRate > 0.0 ? sampleRate : 44100.0, juce::jmax(128, blockSize));
-
         juce::String firstLoadError;
-        juce::PluginDescription instrumentDescription;
-        if (sourceTrack->getPluginDescriptionForSlot(Track::instrumentSlotIndex, instrumentDescription))
-        {
-            juce::String error;
-            if (!clonedTrack->loadInstrumentPlugin(instrumentDescription, error))
-            {
-                if (firstLoadError.isEmpty() && error.isNotEmpty())
-                    firstLoadError = error;
-            }
-            else
-            {
-                const auto instrumentState = sourceTrack->getPluginStateForSlot(Track::instrumentSlotIndex);
-                if (instrumentState.isNotEmpty()
-                    && !clonedTrack->setPluginStateForSlot(Track::instrumentSlotIndex, instrumentState)
-                    && firstLoadError.isEmpty())
-                {
-                    firstLoadError = "Instrument state restore failed for duplicated track.";
-                }
-                clonedTrack->setPluginSlotBypassed(Track::instrumentSlotIndex,
-                                                   sourceTrack->isPluginSlotBypassed(Track::instrumentSlotIndex));
-                recordLastLoadedPlugin(instrumentDescription);
-            }
-        }
-        else
-        {
-            const auto mode = sourceTrack->getBuiltInInstrumentMode();
-            if (mode == Track::BuiltInInstrument::None)
-            {
-                clonedTrack->disableBuiltInInstrument();
-            }
-            else if (mode == Track::BuiltInInstrument::Sampler)
-            {
-                const auto samplePath = sourceTrack->getSamplerSamplePath();
-                if (samplePath.isNotEmpty())
-                {
-                    juce::String error;
-                    if (!clonedTrack->loadSamplerSoundFromFile(juce::File(samplePath), error))
-                    {
-                        if (firstLoadError.isEmpty() && error.isNotEmpty())
-                            firstLoadError = error;
-                    }
-                }
-                else
-                {
-                    clonedTrack->useBuiltInSynthInstrument();
-                }
-            }
-            else
-            {
-                clonedTrack->useBuiltInSynthInstrument();
-            }
-        }
-
-        for (int slot = 0; slot < sourceTrack->getPluginSlotCount(); ++slot)
-        {
-            juce::PluginDescription description;
-            if (!sourceTrack->getPluginDescriptionForSlot(slot, description))
-                continue;
-
-            juce::String error;
-            if (!clonedTrack->loadPluginInSlot(slot, description, error))
-            {
-                if (firstLoadError.isEmpty() && error.isNotEmpty())
-                    firstLoadError = error;
-                continue;
-            }
-
-            const auto state = sourceTrack->getPluginStateForSlot(slot);
-            if (state.isNotEmpty()
-                && !clonedTrack->setPluginStateForSlot(slot, state)
-                && firstLoadError.isEmpty())
-            {
-                firstLoadError = "Insert state restore failed for duplicated track (slot "
-                               + juce::String(slot + 1) + ").";
-            }
-            clonedTrack->setPluginSlotBypassed(slot, sourceTrack->isPluginSlotBypassed(slot));
-            recordLastLoadedPlugin(description);
-        }
+        auto* clonedTrack = createTrackClone(*sourceTrack,
+                                             sourceTrack->getTrackName() + " Copy",
+                                             &transport,
+                                             sampleRate,
+                                             blockSize,
+                                             true,
+                                             firstLoadError).release();
 
         const int insertTrackIndex = sourceTrackIndex + 1;
         {
@@ -15936,8 +16573,7 @@ namespace sampledex
                             quarantinedPluginTypes,
                             targetTrackIndex,
                             slotIndex,
-                            slotCount,
-                            targetingInstrument](int selectedMenuId)
+                            slotCount](int selectedMenuId)
                            {
                                if (selectedMenuId == 0)
                                    return;
@@ -16102,103 +16738,143 @@ namespace sampledex
                                if (!juce::isPositiveAndBelow(pluginIndex, pluginTypes.size()))
                                    return;
 
-                               juce::String error;
                                closePluginEditorWindow();
                                const auto& selectedDescription = pluginTypes.getReference(pluginIndex);
-                               const auto tryLoadDescription = [&](const juce::PluginDescription& candidate,
-                                                                   juce::String& loadError)
+                               juce::Array<juce::PluginDescription> candidates;
+                               candidates.add(selectedDescription);
+
+                               juce::Array<juce::PluginDescription> alternatives;
+                               for (const auto& candidate : pluginTypes)
                                {
-                                   loadError.clear();
-                                   if (!runPluginIsolationProbe(candidate, targetingInstrument, loadError))
-                                   {
-                                       const juce::String probeError = loadError.isNotEmpty()
-                                           ? loadError
-                                           : juce::String("Plugin failed isolation probe.");
-                                       quarantinePlugin(candidate, probeError);
-                                       loadError = probeError;
-                                       return false;
-                                   }
+                                   if (candidate.pluginFormatName.equalsIgnoreCase(selectedDescription.pluginFormatName))
+                                       continue;
+                                   if (!pluginDescriptionsShareIdentity(candidate, selectedDescription))
+                                       continue;
+                                   alternatives.add(candidate);
+                               }
 
-                                   const bool loaded = targetingInstrument
-                                       ? track->loadInstrumentPlugin(candidate, loadError)
-                                       : track->loadPluginInSlot(slotIndex, candidate, loadError);
-                                   if (!loaded || loadError.isNotEmpty())
-                                   {
-                                       if (shouldQuarantinePluginLoadError(loadError))
-                                           quarantinePlugin(candidate, loadError);
-                                       return false;
-                                   }
+                               std::sort(alternatives.begin(), alternatives.end(),
+                                         [this](const juce::PluginDescription& a,
+                                                const juce::PluginDescription& b)
+                                         {
+                                             const int rankA = getPluginFormatRank(a.pluginFormatName);
+                                             const int rankB = getPluginFormatRank(b.pluginFormatName);
+                                             if (rankA != rankB)
+                                                 return rankA < rankB;
+                                             return a.pluginFormatName.compareIgnoreCase(b.pluginFormatName) < 0;
+                                         });
+                               candidates.addArray(alternatives);
+
+                               loadPluginCandidatesAsync(targetTrackIndex, slotIndex, candidates, 0, {});
+                           });
+    }
+    void MainComponent::loadPluginCandidatesAsync(int trackIndex,
+                                                  int slotIndex,
+                                                  juce::Array<juce::PluginDescription> candidates,
+                                                  int candidateIndex,
+                                                  juce::String lastError)
+    {
+        if (!juce::isPositiveAndBelow(trackIndex, tracks.size()) || candidates.isEmpty())
+            return;
 
-                                   return true;
-                               };
+        auto* track = tracks[trackIndex];
+        const bool targetingInstrument = slotIndex == Track::instrumentSlotIndex;
+        if (!juce::isPositiveAndBelow(candidateIndex, candidates.size()))
+        {
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                                                   "Plugin Load Error",
+                                                   lastError.isNotEmpty() ? lastError
+                                                                          : juce::String("Unable to load plugin."));
+            refreshChannelRackWindow();
+            return;
+        }
 
-                               juce::PluginDescription loadedDescription = selectedDescription;
-                               bool loaded = tryLoadDescription(selectedDescription, error);
+        const auto candidate = candidates.getReference(candidateIndex);
+        juce::String probeError;
+        if (!runPluginIsolationProbe(candidate, targetingInstrument, probeError))
+        {
+            if (probeError.isEmpty())
+                probeError = "Plugin failed isolation probe.";
+            quarantinePlugin(candidate, probeError);
+            loadPluginCandidatesAsync(trackIndex, slotIndex, std::move(candidates), candidateIndex + 1, probeError);
+            return;
+        }
 
-                               if (!loaded)
-                               {
-                                   juce::Array<juce::PluginDescription> alternatives;
-                                   for (const auto& candidate : pluginTypes)
-                                   {
-                                       if (candidate.pluginFormatName.equalsIgnoreCase(selectedDescription.pluginFormatName))
-                                           continue;
-                                       if (!pluginDescriptionsShareIdentity(candidate, selectedDescription))
-                                           continue;
-                                       alternatives.add(candidate);
-                                   }
+        // The slot passes audio through until the instance is ready.
+        const auto token = track->beginPendingPluginLoad(slotIndex, candidate);
+        if (token == 0)
+            return;
+        refreshChannelRackWindow();
 
-                                   std::sort(alternatives.begin(), alternatives.end(),
-                                             [this](const juce::PluginDescription& a,
-                                                    const juce::PluginDescription& b)
-                                             {
-                                                 const int rankA = getPluginFormatRank(a.pluginFormatName);
-                                                 const int rankB = getPluginFormatRank(b.pluginFormatName);
-                                                 if (rankA != rankB)
-                                                     return rankA < rankB;
-                                                 return a.pluginFormatName.compareIgnoreCase(b.pluginFormatName) < 0;
-                                             });
-
-                                   for (const auto& candidate : alternatives)
-                                   {
-                                       if (tryLoadDescription(candidate, error))
-                                       {
-                                           loaded = true;
-                                           loadedDescription = candidate;
-                                           break;
-                                       }
-                                   }
-                               }
+        PluginInstantiationService::Request request;
+        request.description = candidate;
+        request.isInstrument = targetingInstrument;
+        request.sampleRate = track->getPluginHostingSampleRate();
+        request.blockSize = track->getPluginHostingBlockSize();
+        request.sandboxed = preferredHostingPolicyForPlugin(candidate) == Track::PluginHostingPolicy::IsolatedBridge;
+        pluginInstantiationService.setPlaybackConfiguration(request.sampleRate, request.blockSize);
+        request.onComplete = [safeThis = juce::Component::SafePointer<MainComponent>(this),
+                              track,
+                              trackIndex,
+                              slotIndex,
+                              candidates,
+                              candidateIndex,
+                              token,
+                              targetingInstrument](std::unique_ptr<juce::AudioPluginInstance> instance,
+                                                   double preparedSampleRate,
+                                                   int preparedBlockSize,
+                                                   const juce::String& creationError)
+        {
+            if (safeThis == nullptr || !safeThis->tracks.contains(track))
+                return;
+            // The user loaded or removed something else in this slot meanwhile.
+            if (!track->isPendingPluginLoadCurrent(slotIndex, token))
+                return;
 
-                               if (!loaded)
-                               {
-                                   const juce::String composedError = error.isNotEmpty()
-                                       ? error
-                                       : juce::String("Unable to load plugin.");
-                                   juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
-                                                                          "Plugin Load Error",
-                                                                          composedError);
-                                   return;
-                               }
+            const auto& loadedDescription = candidates.getReference(candidateIndex);
+            juce::String loadError = creationError;
+            const bool attached = instance != nullptr
+                && track->attachPreparedPlugin(slotIndex,
+                                               std::move(instance),
+                                               loadedDescription,
+                                               preparedSampleRate,
+                                               preparedBlockSize,
+                                               loadError,
+                                               token);
+            if (!attached)
+            {
+                track->cancelPendingPluginLoad(slotIndex, token);
+                if (shouldQuarantinePluginLoadError(loadError))
+                    safeThis->quarantinePlugin(loadedDescription, loadError);
+                safeThis->loadPluginCandidatesAsync(trackIndex, slotIndex, candidates, candidateIndex + 1, loadError);
+                return;
+            }
 
-                               track->setPluginHostingPolicyForSlot(slotIndex,
-                                                                    preferredHostingPolicyForPlugin(loadedDescription));
-                               recordLastLoadedPlugin(loadedDescription);
-                               refreshChannelRackWindow();
-                               openPluginEditorWindowForTrack(targetTrackIndex, slotIndex);
+            const auto policy = safeThis->preferredHostingPolicyForPlugin(loadedDescription);
+            track->setPluginHostingPolicyForSlot(slotIndex, policy);
+            safeThis->recordLastLoadedPlugin(loadedDescription);
+            // Warm instances are in-process; a plugin that has crashed is not preloaded.
+            if (policy == Track::PluginHostingPolicy::SafeInProcess)
+                safeThis->pluginInstantiationService.noteRecentlyUsed(loadedDescription, targetingInstrument);
+            safeThis->refreshChannelRackWindow();
+            safeThis->openPluginEditorWindowForTrack(trackIndex, slotIndex);
 
-                               if (!loadedDescription.pluginFormatName.equalsIgnoreCase(selectedDescription.pluginFormatName))
-                               {
-                                   juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
-                                                                          "Plugin Format Fallback",
-                                                                          "Loaded \"" + loadedDescription.name
-                                                                              + "\" as "
-                                                                              + loadedDescription.pluginFormatName
-                                                                              + " because the selected "
-                                                                              + selectedDescription.pluginFormatName
-                                                                              + " variant failed to load.");
-                               }
-                           });
+            const auto& selectedDescription = candidates.getReference(0);
+            if (!loadedDescription.pluginFormatName.equalsIgnoreCase(selectedDescription.pluginFormatName))
+            {
+                juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
+                                                       "Plugin Format Fallback",
+                                                       "Loaded \"" + loadedDescription.name
+                                                           + "\" as "
+                                                           + loadedDescription.pluginFormatName
+                                                           + " because the selected "
+                                                           + selectedDescription.pluginFormatName
+                                                           + " variant failed to load.");
+            }
+        };
+        pluginInstantiationService.requestInstance(std::move(request));
     }
+
     juce::StringArray MainComponent::getMenuBarNames()
     {
         return { "File", "View" };
@@ -16240,6 +16916,7 @@ namespace sampledex
             menu.addItem(menuIdViewProjectSettings, "Project Settings...");
             menu.addItem(menuIdViewAudioSettings, "Audio Settings...");
             menu.addItem(menuIdViewScanPlugins, "Scan Plugins");
+            menu.addItem(menuIdViewRescanAllPlugins, "Rescan All Plugins");
             menu.addItem(menuIdViewAutoScanPlugins,
                          "Scan Plugins On Startup",
                          true,
@@ -16295,6 +16972,9 @@ namespace sampledex
             case menuIdViewScanPlugins:
                 beginPluginScan();
                 break;
+            case menuIdViewRescanAllPlugins:
+                beginPluginScan(true);
+                break;
             case menuIdViewAutoScanPlugins:
                 autoScanPluginsOnStartup = !autoScanPluginsOnStartup;
                 saveStartupPreferences();
@@ -2,9 +2,12 @@
 #include <JuceHeader.h>
 #include <atomic>
 #include <array>
+#include <deque>
 #include <map>
+#include <memory>
 #include <vector>
 #include "Track.h"
+#include "AutomationRecorder.h"
 #include "Mixer.h"
 #include "TimelineModel.h"
 #include "TransportEngine.h"
@@ -20,10 +23,23 @@
 #include "ChordEngine.h"
 #include "ScheduledMidiOutput.h"
 #include "StreamingClipSource.h"
+#include "RecordingTakeFile.h"
+#include "InputCaptureRing.h"
+#include "LatencyCalibrator.h"
 #include "ProjectSerializer.h"
+#include "RenderProjectBuilder.h"
 #include "RealtimeGraphScheduler.h"
+#include "OfflineRenderEngine.h"
+#include "OfflineStemCapture.h"
+#include "ExportSinkPipeline.h"
+#include "LoudnessAnalyzer.h"
+#include "IsolatedRenderEngine.h"
+#include "RenderJobQueue.h"
+#include "TrackRenderCache.h"
 #include "RealtimeAudioEngine.h"
 #include "RealtimeStateSnapshot.h"
+#include "PluginInstantiationService.h"
+#include "PluginScanner.h"
 #include "Theme.h"
 
 namespace sampledex { class LcdDisplay; } 
@@ -133,6 +149,14 @@ namespace sampledex
             bool loopRangeOnly = false;
             bool includeMasterProcessing = true;
             bool enableDither = true;
+            bool includeBusStems = false;
+            // Further mixdown files fed by the same render.
+            std::vector<ExportSinkPipeline::Deliverable> extraDeliverables;
+            // Mixdown only. 0 = off; otherwise the mix is rendered once to a float
+            // intermediate, measured, and encoded at this integrated loudness (LUFS)
+            // without letting its true peak pass truePeakCeilingDb.
+            float loudnessTargetLufs = 0.0f;
+            float truePeakCeilingDb = -1.0f;
         };
 
         class RecordingDiskThread : public juce::Thread
@@ -157,18 +181,13 @@ namespace sampledex
 
         struct AudioTakeWriterState
         {
-            std::unique_ptr<juce::AudioFormatWriter> writer;
+            RecordingTakeFile takeFile;
             juce::File file;
             bool active = false;
             int inputPair = -1;
-            int64 samplesWritten = 0;
             double startBeat = 0.0;
             double sampleRate = 44100.0;
             int trackIndex = -1;
-            std::vector<float> ringLeft;
-            std::vector<float> ringRight;
-            std::unique_ptr<juce::AbstractFifo> ringFifo;
-            std::atomic<int64> droppedSamples { 0 };
             std::atomic<bool> hadWriteError { false };
             juce::String writeErrorMessage;
         };
@@ -220,8 +239,8 @@ namespace sampledex
         void loadToolbarLayoutSettings();
         void saveToolbarLayoutSettings() const;
         void showHelpGuide();
-        void beginPluginScan();
-        bool startPluginScanPass();
+        void beginPluginScan(bool rescanEverything = false);
+        void handlePluginScanResult(const PluginScanDatabase::Entry& entry, bool previouslyFailed);
         void finishPluginScan(bool success, const juce::String& detailMessage);
         bool loadProjectFromFile(const juce::File& fileToLoad);
         void resetStreamingStateForProjectSwitch();
@@ -284,7 +303,7 @@ namespace sampledex
         void closePluginEditorWindow();
         void openEqWindowForTrack(int trackIndex);
         void closeEqWindow();
-        void beginMixdownExportForFormat(const juce::String& formatExtension);
+        void beginMixdownExportForFormat(const juce::String& formatExtension, bool withDeliverableSet = false);
         void beginStemExportForFormat(const juce::String& formatExtension);
         bool promptForExportSettings(const juce::String& formatExtension,
                                      bool exportingStems,
@@ -292,19 +311,50 @@ namespace sampledex
         bool runOfflineExport(const juce::File& destination,
                               bool exportStems,
                               const juce::String& formatExtension,
-                              double exportSampleRate,
-                              int bitDepth,
-                              bool loopRangeOnly,
-                              bool includeMasterProcessing,
-                              bool enableDither);
-        bool renderOfflinePassToWriter(juce::AudioFormatWriter& writer,
-                                       double startBeat,
-                                       double endBeat,
-                                       double exportSampleRate,
-                                       int targetBitDepth,
-                                       bool enableDither,
-                                       std::atomic<bool>* cancelFlag = nullptr,
-                                       std::function<void(float)> progressCallback = {});
+                              const ExportSettings& settings);
+        // Render thread. Starts sinks, feeds it every block and waits for its encoders to
+        // finish; sinks may be null when only the pass's stem capture is wanted.
+        // targetBitDepth and enableDither apply to the stem capture.
+        bool renderOfflinePassToSinks(IsolatedRenderEngine& engine,
+                                      ExportSinkPipeline* sinks,
+                                      const IsolatedRenderEngine::Pass& pass,
+                                      int targetBitDepth,
+                                      bool enableDither,
+                                      std::atomic<bool>* cancelFlag,
+                                      std::function<void(const OfflineRenderProgress&)> progressCallback = {});
+        // Message thread: clones trackIndices with the arrangement, automation, tempo map
+        // and master settings they need. bounceTrackIndex renders unfrozen, without its
+        // previous freeze clip. The clones' plugins are re-created from their state through
+        // pluginInstantiationService, so the message thread stays free while they load;
+        // onReady gets the prepared engine, or null with an error, on the message thread
+        // (at once when nothing needs loading). Setting cancelFlag drops the build: null
+        // engine, empty error.
+        using IsolatedRenderEngineReadyFn = std::function<void(std::unique_ptr<IsolatedRenderEngine> engine,
+                                                               const juce::String& error)>;
+        void createIsolatedRenderEngine(const std::vector<int>& trackIndices,
+                                        int bounceTrackIndex,
+                                        double renderSampleRate,
+                                        IsolatedRenderEngineReadyFn onReady,
+                                        std::atomic<bool>* cancelFlag = nullptr);
+        // A plugin slot of a track clone left pending for the caller to create.
+        struct DeferredPluginLoad
+        {
+            int slotIndex = 0;
+            juce::PluginDescription description;
+            PluginStateBlob state;
+            bool bypassed = false;
+            std::uint64_t pendingToken = 0;
+        };
+        // Loads the clone's plugins here, or, given deferredPluginLoads, leaves their slots
+        // pending and lists them there.
+        std::unique_ptr<Track> createTrackClone(const Track& source,
+                                                const juce::String& cloneName,
+                                                juce::AudioPlayHead* playHead,
+                                                double sampleRate,
+                                                int blockSize,
+                                                bool recordLoadedPlugins,
+                                                juce::String& firstLoadError,
+                                                std::vector<DeferredPluginLoad>* deferredPluginLoads = nullptr);
         double getProjectEndBeat() const;
         juce::AudioFormat* findWritableExportFormatForExtension(const juce::String& extension) const;
         void refreshStatusText();
@@ -314,14 +364,18 @@ namespace sampledex
         void closeChannelRackWindow();
         void refreshChannelRackWindow();
         void freezeTrackToAudio(int trackIndex);
+        void freezeAllTracksToAudio();
         void unfreezeTrack(int trackIndex);
         void commitTrackToAudio(int trackIndex);
-        bool renderTrackToAudioFile(int trackIndex,
+        // Queues one freeze or commit job per track on renderJobQueue.
+        void queueTrackRenders(const std::vector<int>& trackIndices, Track::RenderTaskType taskType);
+        void finishTrackRenderBatch(const RenderJobQueue::Stats& stats);
+        // Render worker.
+        bool renderTrackToAudioFile(IsolatedRenderEngine& engine,
                                     const juce::File& outputFile,
                                     double startBeat,
                                     double endBeat,
-                                    double renderSampleRate,
-                                    bool includeMasterProcessing,
+                                    RenderJobQueue::JobContext& context,
                                     juce::String& errorMessage);
         void finishFreezeTrack(int trackIndex,
                                const juce::File& renderedFile,
@@ -333,10 +387,20 @@ namespace sampledex
                                double startBeat,
                                double endBeat,
                                double renderSampleRate);
-        void runRenderTask(const juce::String& taskName,
-                           std::function<void()> task,
-                           int renderTrackIndex = -1,
-                           Track::RenderTaskType taskType = Track::RenderTaskType::None);
+        // Smart freeze (TrackRenderCache). Empty key = the track plays live right now.
+        juce::String computeTrackRenderCacheKey(int trackIndex) const;
+        // UI timer: re-keys every track, drops stale caches and queues idle renders.
+        void updateTrackRenderCaches();
+        void queueTrackRenderCache(Track* track, const juce::String& key);
+        void setSmartFreezeEnabled(bool shouldEnable);
+        void setTrackSleepEnabled(bool shouldEnable);
+        // Claims the shared render status for a background task; false (after telling the
+        // user) when another render holds it. runRenderTask() runs the task and releases
+        // the claim afterwards; abandonRenderTask() releases a claim whose task never ran.
+        bool beginRenderTask(int renderTrackIndex = -1,
+                             Track::RenderTaskType taskType = Track::RenderTaskType::None);
+        void runRenderTask(const juce::String& taskName, std::function<void()> task);
+        void abandonRenderTask();
         void cancelActiveRenderTask();
         void startCaptureRecordingNow();
         void startCaptureRecordingNow(double requestedStartBeat, int64_t requestedStartSample);
@@ -348,6 +412,13 @@ namespace sampledex
         int chooseBestInputPairForCurrentBlock(int capturedInputChannels, int blockSamples) const;
         void setMonitorSafeMode(bool enabled);
         void calibrateInputMonitoring();
+        void startLatencyCalibration();
+        void finishLatencyCalibration();
+        juce::String getLatencyCalibrationKey() const;
+        // Measured round trip for the current device, rate and buffer size, or -1.
+        int getCalibratedRoundTripSamples() const;
+        // The master limiter's lookahead while it is on; bypassed, it adds no delay.
+        int getMasterLatencySamples() const;
         void clearInputPeakHolds();
         juce::String getLatencySummaryText() const;
         void refreshInputDeviceSafetyState();
@@ -369,6 +440,46 @@ namespace sampledex
         void updatePluginStabilityForDiagnostic(const Track::PluginSlotDiagnostic& diagnostic);
         Track::PluginHostingPolicy preferredHostingPolicyForPlugin(const juce::PluginDescription& desc) const;
         void drainTrackPluginDiagnostics();
+        // Staged plugin restore for project load: state decoding and isolation probes run
+        // on pluginRestorePool, instances come from pluginInstantiationService a few at a
+        // time, and each slot goes live as soon as its own plugin is ready.
+        struct PluginRestoreJob
+        {
+            Track* track = nullptr;
+            int trackNumber = 0;
+            ProjectSerializer::PluginSlotState slot;
+            juce::Array<juce::PluginDescription> candidates;
+            int candidateIndex = 0;
+            std::uint64_t pendingToken = 0;
+            juce::MemoryBlock decodedState;
+            bool stateDecoded = false;
+            bool stateDecodeFailed = false;
+            juce::Array<juce::PluginDescription> probeFailures;
+            juce::StringArray probeFailureReasons;
+            juce::String lastFailure;
+        };
+
+        void queuePluginRestore(Track& track,
+                                int trackNumber,
+                                const ProjectSerializer::PluginSlotState& slot,
+                                juce::Array<juce::PluginDescription> candidates,
+                                juce::StringArray& warnings);
+        void startQueuedPluginRestores();
+        void dispatchPluginRestoreProbe(std::shared_ptr<PluginRestoreJob> job);
+        void handlePluginRestoreProbed(std::shared_ptr<PluginRestoreJob> job);
+        void pumpPluginRestoreInstantiations();
+        void handlePluginRestoreInstance(std::shared_ptr<PluginRestoreJob> job,
+                                         std::unique_ptr<juce::AudioPluginInstance> instance,
+                                         double preparedSampleRate,
+                                         int preparedBlockSize,
+                                         const juce::String& creationError);
+        void finishPluginRestore(const PluginRestoreJob& job, const juce::String& failure);
+        void cancelPluginRestores();
+        void loadPluginCandidatesAsync(int trackIndex,
+                                       int slotIndex,
+                                       juce::Array<juce::PluginDescription> candidates,
+                                       int candidateIndex,
+                                       juce::String lastError);
         bool runPluginIsolationProbe(const juce::PluginDescription& desc,
                                      bool instrumentPlugin,
                                      juce::String& errorMessage) const;
@@ -378,8 +489,6 @@ namespace sampledex
         juce::Array<juce::PluginDescription> getPluginLoadCandidates(const juce::PluginDescription& requested,
                                                                       bool preferRequestedFormatFirst) const;
         juce::StringArray getPluginScanFormatsInPreferredOrder() const;
-        void applyDeadMansPedalBlacklist(const juce::String& scanFormatName);
-        void handlePluginScanPassResult(int exitCode, const juce::String& output, bool timedOut);
         void recordLastLoadedPlugin(const juce::PluginDescription& desc);
         bool readPluginSessionGuard(bool& cleanState, juce::PluginDescription& lastPlugin) const;
         void writePluginSessionGuard(bool cleanState) const;
@@ -408,12 +517,11 @@ namespace sampledex
         const AutomationLane* findAutomationLane(AutomationTarget target, int trackIndex) const;
         AutomationMode getAutomationModeForTrackTarget(int trackIndex, AutomationTarget target) const;
         void setAutomationModeForTrackTarget(int trackIndex, AutomationTarget target, AutomationMode mode);
-        float evaluateAutomationLaneValueAtBeat(const AutomationLane& lane, double beat) const;
         void enqueueAutomationWriteEvent(int laneId, double beat, float value);
         void drainAutomationWriteEvents();
         void resetAutomationLatchStates();
         void applyAutomationForBlock(const RealtimeStateSnapshot& snapshot,
-                                     double beat,
+                                     const TempoBlockSpan& blockSpan,
                                      bool isPlaying);
         void ensureTrackPdcCapacity(int requiredSamples);
         void resetTrackPdcState();
@@ -428,16 +536,16 @@ namespace sampledex
         bool sanitizeRoutingConfiguration(bool showAlert);
 
         juce::AudioPluginFormatManager formatManager;
+        PluginInstantiationService pluginInstantiationService { formatManager };
         TransportBar transportBar;
         TrackList trackListView;
         TimelineView timelineView;
         BrowserPanel browserPanel;
         juce::AudioFormatManager audioFormatManager;
-        std::unique_ptr<juce::ChildProcess> pluginScanProcess;
+        std::unique_ptr<PluginScanner> pluginScanner;
         juce::KnownPluginList knownPluginList;
         juce::File knownPluginListFile;
         juce::File startupSettingsFile;
-        juce::File pluginScanDeadMansPedalFile;
         juce::File pluginSessionGuardFile;
         juce::File quarantinedPluginsFile;
         juce::File pluginStabilityFile;
@@ -461,13 +569,8 @@ namespace sampledex
         juce::String canonicalBuildPath = "/Users/robertclemons/Downloads/sampledex_daw-main/build/SampledexChordLab_artefacts/Release/Sampledex ChordLab.app";
         bool pluginSafetyGuardsEnabled = true;
         juce::String preferredMacPluginFormat = "AudioUnit";
-        int pluginScanPassCount = 0;
-        int pluginScanTotalPassCount = 0;
-        int pluginScanPassTimeoutMs = 45000;
+        int pluginScanTimeoutMs = 45000;
         double pluginScanProgress = 0.0;
-        double scanPassStartTimeMs = 0.0;
-        juce::StringArray pendingScanFormats;
-        juce::String activeScanFormat;
         juce::StringArray pluginScanFailedItems;
         juce::StringArray pluginScanBlacklistedItems;
         juce::PluginDescription lastLoadedPluginDescription;
@@ -489,12 +592,12 @@ namespace sampledex
         std::atomic<bool> recordEnabledRt { false };
         std::atomic<bool> metronomeEnabledRt { false };
         std::atomic<bool> loopEnabledRt { false };
-        std::atomic<float> masterOutputGainRt { 0.9f };
-        std::atomic<bool> masterSoftClipEnabledRt { true };
-        std::atomic<bool> masterLimiterEnabledRt { true };
-        std::atomic<bool> outputDcHighPassEnabledRt { true };
-        std::atomic<float> auxReturnGainRt { 0.5f };
-        std::atomic<bool> auxFxEnabledRt { true };
+        std::atomic<float> masterOutputGainRt { RenderProjectBuilder::defaultMasterGain };
+        std::atomic<bool> masterSoftClipEnabledRt { RenderProjectBuilder::defaultSoftClipEnabled };
+        std::atomic<bool> masterLimiterEnabledRt { RenderProjectBuilder::defaultLimiterEnabled };
+        std::atomic<bool> outputDcHighPassEnabledRt { RenderProjectBuilder::defaultOutputDcHighPassEnabled };
+        std::atomic<float> auxReturnGainRt { RenderProjectBuilder::defaultAuxReturnGain };
+        std::atomic<bool> auxFxEnabledRt { RenderProjectBuilder::defaultAuxFxEnabled };
         std::atomic<float> auxMeterRt { 0.0f };
         std::array<std::atomic<float>, static_cast<size_t>(auxBusCount)> auxBusMeterRt {};
         std::array<std::atomic<int>, static_cast<size_t>(auxBusCount)> auxBusInsertLatencyRt {};
@@ -506,11 +609,10 @@ namespace sampledex
         std::atomic<int> activeInputChannelCountRt { 0 };
         std::atomic<float> liveInputPeakRt { 0.0f };
         std::atomic<float> liveInputRmsRt { 0.0f };
-        std::atomic<bool> monitorSafeModeRt { true };
+        std::atomic<bool> monitorSafeModeRt { RenderProjectBuilder::defaultMonitorSafeMode };
         std::atomic<float> inputMonitorSafetyTrimRt { 1.0f };
         std::atomic<bool> usingLikelyBuiltInAudioRt { false };
         std::atomic<bool> panicRequestedRt { false };
-        std::atomic<bool> offlineRenderActiveRt { false };
         RealtimeSnapshotStateManager realtimeSnapshotState;
         
         juce::MidiMessageCollector midiCollector;
@@ -544,7 +646,14 @@ namespace sampledex
         };
         InputMonitoringMode inputMonitoringMode = InputMonitoringMode::AutoMonitor;
         double recordingLatencyCompensationBeats = 0.0;
+        // Audio takes: the measured round trip when the device has one, else input latency.
+        double recordingAudioLatencyCompensationBeats = 0.0;
         int recordingManualOffsetSamples = 0;
+        LatencyCalibrator latencyCalibrator;
+        double latencyCalibrationStartedMs = 0.0;
+        static constexpr double latencyCalibrationTimeoutMs = 5000.0;
+        // Keyed by getLatencyCalibrationKey(); saved as latency_calibration lines.
+        std::map<juce::String, int> calibratedRoundTripSamples;
         int recordingSafetyPreRollBlocks = 2;
         int recordingSafetyPreRollSamples = 0;
         std::atomic<int> recordingLatencyCompensationSamplesRt { 0 };
@@ -556,12 +665,12 @@ namespace sampledex
         std::array<juce::Reverb, static_cast<size_t>(auxBusCount)> auxReverbs;
         juce::Reverb::Parameters reverbParams;
         bool metronomeEnabled = false;
-        float masterOutputGain = 0.9f;
-        bool masterSoftClipEnabled = true;
-        bool masterLimiterEnabled = true;
-        bool outputDcHighPassEnabled = true;
-        float auxReturnGain = 0.5f;
-        bool auxFxEnabled = true;
+        float masterOutputGain = RenderProjectBuilder::defaultMasterGain;
+        bool masterSoftClipEnabled = RenderProjectBuilder::defaultSoftClipEnabled;
+        bool masterLimiterEnabled = RenderProjectBuilder::defaultLimiterEnabled;
+        bool outputDcHighPassEnabled = RenderProjectBuilder::defaultOutputDcHighPassEnabled;
+        float auxReturnGain = RenderProjectBuilder::defaultAuxReturnGain;
+        bool auxFxEnabled = RenderProjectBuilder::defaultAuxFxEnabled;
 
         std::unique_ptr<LcdDisplay> lcdDisplay;
         std::unique_ptr<juce::TooltipWindow> tooltipWindow;
@@ -638,6 +747,7 @@ namespace sampledex
         int projectScaleMode = 0;
         int projectTransposeSemitones = 0;
         std::vector<TempoEvent> tempoEvents;
+        TempoMapIndex tempoMapIndex; // rebuilt from tempoEvents by rebuildTempoEventMap
         std::vector<SmfPipeline::TimeSignaturePoint> timeSignatureEvents;
         mutable juce::CriticalSection midiDeviceSelectionLock;
         mutable juce::CriticalSection midiLearnLock;
@@ -678,6 +788,7 @@ namespace sampledex
         std::atomic<bool> backgroundRenderBusyRt { false };
         std::atomic<bool> renderCancelRequestedRt { false };
         std::atomic<float> renderProgressRt { 0.0f };
+        std::atomic<float> renderSpeedFactorRt { 0.0f }; // audio seconds per wall second of the running pass
         std::atomic<int> renderTrackIndexRt { -1 };
         std::atomic<int> renderTaskTypeRt { static_cast<int>(Track::RenderTaskType::None) };
         std::atomic<bool> builtInMicHardFailSafeRt { false };
@@ -689,6 +800,15 @@ namespace sampledex
         std::atomic<bool> feedbackAutoMuteRequestedRt { false };
         std::atomic<int> outputSafetyMuteBlocksRt { 0 };
         juce::ThreadPool backgroundRenderPool { 1 };
+        juce::ThreadPool pluginRestorePool { juce::jlimit(2, 8, juce::SystemStats::getNumCpus()) };
+        std::vector<std::shared_ptr<PluginRestoreJob>> queuedPluginRestores;
+        std::deque<std::shared_ptr<PluginRestoreJob>> pluginRestoresReadyToInstantiate;
+        juce::StringArray pluginRestoreWarnings;
+        int pluginRestoresInstantiating = 0;
+        int pluginRestoreTotal = 0;
+        int pluginRestoreCompleted = 0;
+        std::uint32_t pluginRestoreGeneration = 0;
+        static constexpr int maxConcurrentPluginRestoreInstantiations = 4;
         int highCpuFrameCount = 0;
         bool feedbackWarningPending = false;
         std::atomic<int> recordStartRequestRt { 0 };
@@ -722,7 +842,7 @@ namespace sampledex
         juce::Component* dockedChannelRack = nullptr;
         juce::Component* trackInspectorView = nullptr;
         juce::Component* recordingPanelView = nullptr;
-        bool monitorSafeMode = true;
+        bool monitorSafeMode = RenderProjectBuilder::defaultMonitorSafeMode;
         ToolbarProfile activeToolbarProfile = ToolbarProfile::Producer;
         std::array<bool, static_cast<size_t>(ToolbarSection::Count)> toolbarSectionVisibility { true, true, true, true, true, true };
         std::vector<ToolbarOverflowItem> toolbarOverflowItems;
@@ -758,14 +878,17 @@ namespace sampledex
         juce::TimeSliceThread streamingAudioReadThread { "Sampledex Streaming Reader" };
         std::map<juce::String, std::shared_ptr<StreamingClipSource>> streamingClipCache;
         std::array<AudioTakeWriterState, static_cast<size_t>(maxRealtimeTracks)> audioTakeWriters;
-        float masterGainSmoothingState = 0.9f;
+        // Held by the disk thread while it writes takes and by whoever opens or closes them.
+        juce::CriticalSection audioTakeFileLock;
+        // All input channels while takes are recording; the callback pushes it only while
+        // recordCaptureRingActive, which changes under the audio callback lock.
+        InputCaptureRing recordCaptureRing;
+        bool recordCaptureRingActive = false;
+        std::vector<float> recordDeinterleaveLeft;
+        std::vector<float> recordDeinterleaveRight;
         float masterGainDezipperCoeff = 0.0f;
-        std::array<float, 2> outputDcPrevInput { 0.0f, 0.0f };
-        std::array<float, 2> outputDcPrevOutput { 0.0f, 0.0f };
-        std::array<float, 2> masterLimiterPrevInput { 0.0f, 0.0f };
-        std::array<float, 2> masterTruePeakMidpointPrevInput { 0.0f, 0.0f };
+        MasterLimiter masterLimiter;
         std::array<float, 2> outputBoundaryPrevSample { 0.0f, 0.0f };
-        float masterLimiterGainState = 1.0f;
         bool wasTransportPlayingLastBlock = false;
         std::array<juce::AudioBuffer<float>, static_cast<size_t>(maxRealtimeTracks)> trackMainWorkBuffers;
         std::array<juce::AudioBuffer<float>, static_cast<size_t>(maxRealtimeTracks)> trackTimelineWorkBuffers;
@@ -790,10 +913,62 @@ namespace sampledex
         std::atomic<int> automationWriteReadIndex { 0 };
         std::atomic<int> automationWriteWriteIndex { 0 };
         std::atomic<int> droppedAutomationWriteEvents { 0 };
+        AutomationWriteRecorder automationWriteRecorder;
+        // Largest value error a thinned automation pass may introduce; 0 keeps every point.
+        static constexpr float defaultAutomationThinningTolerance = 0.002f;
+        float automationThinningTolerance = defaultAutomationThinningTolerance;
+        OfflineRenderSettings offlineRenderSettings;
+        // Stem export: aux bus stems alongside track stems, and the memory that open stem
+        // writers may use before the export is split into several passes.
+        bool stemExportIncludeBuses = false;
+        static constexpr int defaultStemExportMemoryBudgetMb = 512;
+        int stemExportMemoryBudgetMb = defaultStemExportMemoryBudgetMb;
+        // Mixdown loudness normalisation picked in the export menu (0 = off).
+        float exportLoudnessTargetLufs = 0.0f;
+        float exportTruePeakCeilingDb = -1.0f;
+        // The engine of the running export; created and released on the message thread,
+        // rendered on backgroundRenderPool.
+        std::unique_ptr<IsolatedRenderEngine> isolatedRenderEngine;
+        // Plugins of render clones still being created, for the render status.
+        int renderClonePluginLoadsPending = 0;
+        // Freeze and commit jobs. Each job clones only the track it renders, so a batch
+        // spreads across render_job_workers (startup settings, 0 = automatic).
+        struct TrackRenderJob
+        {
+            Track* track = nullptr; // tracks can be reordered or removed while a batch runs
+            RenderJobQueue::JobId jobId = 0;
+        };
+        int renderJobWorkers = 0;
+        RenderJobQueue renderJobQueue;
+        std::vector<TrackRenderJob> trackRenderJobs;
+        juce::StringArray trackRenderErrors;
+        // Smart freeze renders run one at a time on their own queue so they never hold up
+        // a freeze, commit or export (smart_freeze_enabled in startup settings).
+        bool smartFreezeEnabled = false;
+        TrackRenderCache trackRenderCache;
+        // Keys are refreshed every renderCacheUpdateTicks ticks of the UI timer.
+        static constexpr int renderCacheUpdateTicks = 8;
+        int renderCacheTimerTicks = 0;
+        RenderJobQueue renderCacheQueue { 1 };
+        // Audio thread: tracks that streamed their render cache in the previous block.
+        std::array<bool, static_cast<size_t>(maxRealtimeTracks)> trackPlayedRenderCacheRt {};
+        // Tracks with nothing scheduled and a silent output skip their plugins
+        // (track_sleep_enabled in startup settings). They wake this long before a clip
+        // on top of their plugin latency and one block.
+        static constexpr double trackWakeMarginSeconds = 0.05;
+        bool trackSleepEnabled = true;
+        std::atomic<bool> trackSleepEnabledRt { true };
         std::array<std::array<std::atomic<bool>, 3>, static_cast<size_t>(maxRealtimeTracks)> automationTouchStateRt {};
         std::array<std::array<std::atomic<bool>, 3>, static_cast<size_t>(maxRealtimeTracks)> automationLatchStateRt {};
         std::atomic<bool> masterAutomationTouchRt { false };
         std::atomic<bool> masterAutomationLatchRt { false };
+        // Audio-thread only: per-lane evaluation cursors (indexed like the snapshot's lanes)
+        // and the master gain ramp of the current block.
+        std::array<AutomationLaneCursor, static_cast<size_t>(maxRealtimeTracks) * 3 + 1> automationLaneCursors {};
+        AutomationBlockRamp masterAutomationRamp;
+        juce::AudioBuffer<float> masterAutomationValues;
+        // Audio-thread only: stands in for the tempo map while following an external clock.
+        TempoMapIndex externalClockTempoMap;
 
         juce::AudioBuffer<float> trackSendAudio;
         juce::AudioBuffer<float> trackPdcScratchBuffer;
@@ -802,6 +977,7 @@ namespace sampledex
         std::array<int, static_cast<size_t>(maxRealtimeTracks)> trackPdcWritePositions {};
         int trackPdcBufferSamples = 0;
         std::atomic<int> maxPdcLatencySamplesRt { 0 };
+        std::atomic<int> masterLimiterLatencySamplesRt { 0 };
 
         float bottomPanelRatio = 0.56f;
         float browserPanelRatio = 0.18f;
@@ -0,0 +1,134 @@
+#include "InputCaptureRing.h"
+
+namespace sampledex
+{
+    void InputCaptureRing::prepare(int maxChannels, int newCapacityFrames)
+    {
+        channelStride = juce::jmax(1, maxChannels);
+        capacityFrames = juce::jmax(1024, newCapacityFrames);
+        frames.assign(static_cast<size_t>(capacityFrames) * static_cast<size_t>(channelStride), 0.0f);
+        frameFifo = std::make_unique<juce::AbstractFifo>(capacityFrames);
+        // Enough records for the ring to fill with 16-sample blocks.
+        const int blockCapacity = juce::jmax(256, capacityFrames / 16);
+        blocks.assign(static_cast<size_t>(blockCapacity), Block {});
+        blockFifo = std::make_unique<juce::AbstractFifo>(blockCapacity);
+        highWaterFrames.store(0, std::memory_order_relaxed);
+        overflowBlocks.store(0, std::memory_order_relaxed);
+        droppedFrames.store(0, std::memory_order_relaxed);
+    }
+
+    void InputCaptureRing::release()
+    {
+        frameFifo.reset();
+        blockFifo.reset();
+        frames.clear();
+        frames.shrink_to_fit();
+        blocks.clear();
+        blocks.shrink_to_fit();
+        channelStride = 0;
+        capacityFrames = 0;
+    }
+
+    bool InputCaptureRing::push(const juce::AudioBuffer<float>& input, int numChannels, int numSamples,
+                                float gain, int autoInputPair) noexcept
+    {
+        if (frameFifo == nullptr || numSamples <= 0)
+            return false;
+
+        numChannels = juce::jmin(numChannels, channelStride, input.getNumChannels());
+        numSamples = juce::jmin(numSamples, input.getNumSamples());
+        if (numChannels <= 0 || numSamples <= 0)
+            return false;
+
+        // All or nothing: a partial block would shift every take after it.
+        if (blockFifo->getFreeSpace() < 1 || frameFifo->getFreeSpace() < numSamples)
+        {
+            overflowBlocks.fetch_add(1, std::memory_order_relaxed);
+            droppedFrames.fetch_add(numSamples, std::memory_order_relaxed);
+            return false;
+        }
+
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        frameFifo->prepareToWrite(numSamples, start1, size1, start2, size2);
+        const auto interleave = [&](int startFrame, int sourceOffset, int count)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const float* source = input.getReadPointer(channel, sourceOffset);
+                float* dest = frames.data() + static_cast<size_t>(startFrame) * static_cast<size_t>(channelStride)
+                                            + static_cast<size_t>(channel);
+                for (int frame = 0; frame < count; ++frame)
+                    dest[static_cast<size_t>(frame) * static_cast<size_t>(channelStride)] = source[frame] * gain;
+            }
+        };
+        if (size1 > 0)
+            interleave(start1, 0, size1);
+        if (size2 > 0)
+            interleave(start2, size1, size2);
+        frameFifo->finishedWrite(size1 + size2);
+
+        // The record goes in after its frames, so a visible block is always complete.
+        blockFifo->prepareToWrite(1, start1, size1, start2, size2);
+        blocks[static_cast<size_t>(size1 > 0 ? start1 : start2)] = { numSamples, numChannels, autoInputPair };
+        blockFifo->finishedWrite(1);
+
+        const int fill = frameFifo->getNumReady();
+        if (fill > highWaterFrames.load(std::memory_order_relaxed))
+            highWaterFrames.store(fill, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool InputCaptureRing::peekBlock(Block& block) const noexcept
+    {
+        if (blockFifo == nullptr)
+            return false;
+
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        blockFifo->prepareToRead(1, start1, size1, start2, size2);
+        if (size1 + size2 <= 0)
+            return false;
+        block = blocks[static_cast<size_t>(size1 > 0 ? start1 : start2)];
+        return true;
+    }
+
+    void InputCaptureRing::copyPair(int leftChannel, int rightChannel, int frameOffset, int numFrames,
+                                    float* left, float* right) const noexcept
+    {
+        if (frameFifo == nullptr || numFrames <= 0)
+            return;
+
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        frameFifo->prepareToRead(frameOffset + numFrames, start1, size1, start2, size2);
+        const auto deinterleave = [&](int ringFrame, int outOffset, int count)
+        {
+            const float* source = frames.data() + static_cast<size_t>(ringFrame) * static_cast<size_t>(channelStride);
+            for (int frame = 0; frame < count; ++frame)
+            {
+                left[outOffset + frame] = source[leftChannel];
+                right[outOffset + frame] = source[rightChannel];
+                source += channelStride;
+            }
+        };
+
+        // Frames [frameOffset, frameOffset + numFrames) of the oldest block, which may wrap.
+        const int firstCount = juce::jlimit(0, numFrames, size1 - frameOffset);
+        if (firstCount > 0)
+            deinterleave(start1 + frameOffset, 0, firstCount);
+        if (numFrames > firstCount)
+            deinterleave(start2 + juce::jmax(0, frameOffset - size1), firstCount, numFrames - firstCount);
+    }
+
+    void InputCaptureRing::popBlock() noexcept
+    {
+        Block block;
+        if (!peekBlock(block))
+            return;
+        frameFifo->finishedRead(block.numSamples);
+        blockFifo->finishedRead(1);
+    }
+
+    int InputCaptureRing::getNumBlocksReady() const noexcept
+    {
+        return blockFifo != nullptr ? blockFifo->getNumReady() : 0;
+    }
+}
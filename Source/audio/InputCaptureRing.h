@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace sampledex
+{
+    // Every device input channel for recording, frame-interleaved in one ring so the
+    // audio callback makes a single push per block however many tracks are armed. Each
+    // push is a block: its frames plus a record of how many input channels were live and
+    // which pair auto-input picked, so the reader can resolve a take's source exactly as
+    // the callback would have. Single producer (audio thread), single consumer (disk
+    // thread); prepare() and release() only while neither is using the ring.
+    class InputCaptureRing final
+    {
+    public:
+        struct Block
+        {
+            int numSamples = 0;
+            int numChannels = 0;
+            int autoInputPair = 0;
+        };
+
+        void prepare(int maxChannels, int capacityFrames);
+        void release();
+        bool isPrepared() const noexcept { return frameFifo != nullptr; }
+
+        // Audio thread. Interleaves numChannels of input (at most the prepared count) with
+        // gain applied. A block that does not fit is dropped whole and counted.
+        bool push(const juce::AudioBuffer<float>& input, int numChannels, int numSamples,
+                  float gain, int autoInputPair) noexcept;
+
+        // Reader side: the oldest block, its frames for one source pair, then pop it.
+        bool peekBlock(Block& block) const noexcept;
+        void copyPair(int leftChannel, int rightChannel, int frameOffset, int numFrames,
+                      float* left, float* right) const noexcept;
+        void popBlock() noexcept;
+        int getNumBlocksReady() const noexcept;
+
+        int getCapacityFrames() const noexcept { return capacityFrames; }
+        int getHighWaterFrames() const noexcept { return highWaterFrames.load(std::memory_order_relaxed); }
+        int getOverflowCount() const noexcept { return overflowBlocks.load(std::memory_order_relaxed); }
+        juce::int64 getDroppedFrames() const noexcept { return droppedFrames.load(std::memory_order_relaxed); }
+
+    private:
+        int channelStride = 0;
+        int capacityFrames = 0;
+        std::vector<float> frames;
+        std::unique_ptr<juce::AbstractFifo> frameFifo;
+        std::vector<Block> blocks;
+        std::unique_ptr<juce::AbstractFifo> blockFifo;
+        std::atomic<int> highWaterFrames { 0 };
+        std::atomic<int> overflowBlocks { 0 };
+        std::atomic<juce::int64> droppedFrames { 0 };
+    };
+}
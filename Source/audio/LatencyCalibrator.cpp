@@ -0,0 +1,185 @@
+#include "LatencyCalibrator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+
+namespace sampledex
+{
+    std::vector<float> LatencyCalibrator::createTestSignal()
+    {
+        // Galois LFSR for x^15 + x^14 + 1; one period is 2^15 - 1 samples.
+        constexpr std::uint32_t feedbackMask = 0x6000u;
+        constexpr int length = (1 << mlsOrder) - 1;
+        std::vector<float> sequence(static_cast<size_t>(length));
+        std::uint32_t lfsr = 1u;
+        for (auto& sample : sequence)
+        {
+            const bool bit = (lfsr & 1u) != 0;
+            lfsr >>= 1;
+            if (bit)
+                lfsr ^= feedbackMask;
+            sample = bit ? testLevel : -testLevel;
+        }
+        return sequence;
+    }
+
+    LatencyCalibrator::Result LatencyCalibrator::measure(const float* signalData, int signalLength,
+                                                         const float* captured, int capturedLength,
+                                                         int maxLatency)
+    {
+        Result result;
+        if (signalData == nullptr || captured == nullptr || signalLength <= 0 || capturedLength <= 0)
+        {
+            result.message = "Nothing was captured.";
+            return result;
+        }
+
+        double capturedEnergy = 0.0;
+        for (int i = 0; i < capturedLength; ++i)
+            capturedEnergy += static_cast<double>(captured[i]) * captured[i];
+        if (std::sqrt(capturedEnergy / capturedLength) < 1.0e-4)
+        {
+            result.message = "No test signal reached the input. Connect an output to an input and try again.";
+            return result;
+        }
+
+        int order = 1;
+        while ((1 << order) < signalLength + capturedLength)
+            ++order;
+        const int size = 1 << order;
+        juce::dsp::FFT fft(order);
+        std::vector<float> signalSpectrum(static_cast<size_t>(size) * 2, 0.0f);
+        std::vector<float> capturedSpectrum(static_cast<size_t>(size) * 2, 0.0f);
+        std::copy(signalData, signalData + signalLength, signalSpectrum.begin());
+        std::copy(captured, captured + capturedLength, capturedSpectrum.begin());
+        fft.performRealOnlyForwardTransform(signalSpectrum.data());
+        fft.performRealOnlyForwardTransform(capturedSpectrum.data());
+
+        // Cross-spectrum with phase-transform weighting: only phase is kept, so the peak
+        // stays one sample wide whatever the speaker, room and converters did to the level
+        // of each band. Bins far below the average carry no signal and are left out.
+        auto* signalBins = reinterpret_cast<std::complex<float>*>(signalSpectrum.data());
+        auto* capturedBins = reinterpret_cast<std::complex<float>*>(capturedSpectrum.data());
+        double magnitudeSum = 0.0;
+        for (int bin = 0; bin < size; ++bin)
+        {
+            capturedBins[bin] = std::conj(signalBins[bin]) * capturedBins[bin];
+            magnitudeSum += std::abs(capturedBins[bin]);
+        }
+        const float floor = static_cast<float>(1.0e-3 * magnitudeSum / size);
+        for (int bin = 0; bin < size; ++bin)
+        {
+            const float magnitude = std::abs(capturedBins[bin]);
+            capturedBins[bin] = magnitude > floor ? capturedBins[bin] / magnitude : std::complex<float>();
+        }
+        fft.performRealOnlyInverseTransform(capturedSpectrum.data());
+        const float* correlation = capturedSpectrum.data();
+
+        const int searchEnd = juce::jlimit(1, capturedLength, maxLatency + 1);
+        int peakLag = 0;
+        float peak = 0.0f;
+        for (int lag = 0; lag < searchEnd; ++lag)
+        {
+            const float value = std::abs(correlation[lag]);
+            if (value > peak)
+            {
+                peak = value;
+                peakLag = lag;
+            }
+        }
+
+        constexpr int peakGuard = 32;
+        double noiseEnergy = 0.0;
+        int noiseCount = 0;
+        for (int lag = 0; lag < searchEnd; ++lag)
+        {
+            if (std::abs(lag - peakLag) <= peakGuard)
+                continue;
+            noiseEnergy += static_cast<double>(correlation[lag]) * correlation[lag];
+            ++noiseCount;
+        }
+        const double noiseRms = noiseCount > 0 ? std::sqrt(noiseEnergy / noiseCount) : 0.0;
+        result.confidence = noiseRms > 0.0 ? static_cast<float>(peak / noiseRms) : (peak > 0.0f ? 1000.0f : 0.0f);
+        result.latencySamples = peakLag;
+        result.ok = result.confidence >= minimumConfidence;
+        result.message = result.ok
+            ? "Round trip " + juce::String(peakLag) + " samples (confidence " + juce::String(result.confidence, 1) + ")"
+            : "No clear match (confidence " + juce::String(result.confidence, 1)
+                  + "). Raise the loopback level or reduce background noise.";
+        return result;
+    }
+
+    bool LatencyCalibrator::start(double sampleRate)
+    {
+        if (isRunning() || sampleRate <= 0.0)
+            return false;
+
+        signal = createTestSignal();
+        maxLatencySamples = static_cast<int>(std::ceil(sampleRate * maxLatencySeconds));
+        capture.assign(signal.size() + static_cast<size_t>(maxLatencySamples), 0.0f);
+        position = 0;
+        state.store(State::running, std::memory_order_release);
+        return true;
+    }
+
+    void LatencyCalibrator::cancel() noexcept
+    {
+        state.store(State::idle, std::memory_order_release);
+    }
+
+    LatencyCalibrator::Result LatencyCalibrator::analyse()
+    {
+        if (!isCaptureComplete())
+            return {};
+
+        auto result = measure(signal.data(), static_cast<int>(signal.size()),
+                              capture.data(), static_cast<int>(capture.size()),
+                              maxLatencySamples);
+        capture.clear();
+        capture.shrink_to_fit();
+        state.store(State::idle, std::memory_order_release);
+        return result;
+    }
+
+    bool LatencyCalibrator::processBlock(const juce::AudioBuffer<float>& input, int numInputChannels,
+                                         juce::AudioBuffer<float>& output, int outputStart, int numSamples) noexcept
+    {
+        if (state.load(std::memory_order_acquire) != State::running)
+            return false;
+
+        const int captureLength = static_cast<int>(capture.size());
+        const int signalLength = static_cast<int>(signal.size());
+        const int count = juce::jmin(numSamples, captureLength - position);
+        const int inputChannels = juce::jmin(numInputChannels, input.getNumChannels());
+        const bool haveInput = inputChannels > 0 && input.getNumSamples() >= count;
+
+        for (int channel = 0; channel < output.getNumChannels(); ++channel)
+        {
+            auto* out = output.getWritePointer(channel, outputStart);
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const int index = position + i;
+                out[i] = (i < count && index < signalLength) ? signal[static_cast<size_t>(index)] : 0.0f;
+            }
+        }
+
+        float* dest = capture.data() + position;
+        if (haveInput)
+        {
+            juce::FloatVectorOperations::copy(dest, input.getReadPointer(0), count);
+            for (int channel = 1; channel < inputChannels; ++channel)
+                juce::FloatVectorOperations::add(dest, input.getReadPointer(channel), count);
+        }
+
+        position += count;
+        if (position >= captureLength)
+        {
+            // A cancel() during this block wins: only a run that is still running completes.
+            auto expected = State::running;
+            state.compare_exchange_strong(expected, State::captured, std::memory_order_acq_rel);
+        }
+        return true;
+    }
+}
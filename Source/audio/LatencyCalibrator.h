@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+namespace sampledex
+{
+    // Measures the true round trip of the audio device by loopback: a maximum-length
+    // sequence is played on every output while the sum of the inputs is captured, then
+    // the capture is cross-correlated against the sequence. The lag of the correlation
+    // peak is how many samples after a block's output that sound arrives in a later
+    // block's input, which is what recorded takes must be moved back by.
+    //
+    // start() and analyse() run on the message thread; processBlock() on the audio
+    // thread. start() must not overlap processBlock(): call it under the audio callback
+    // lock or with the device stopped.
+    class LatencyCalibrator final
+    {
+    public:
+        struct Result
+        {
+            bool ok = false;
+            int latencySamples = 0;
+            // Correlation peak over the RMS of the rest of the search range.
+            float confidence = 0.0f;
+            juce::String message;
+        };
+
+        static constexpr int mlsOrder = 15;
+        static constexpr float testLevel = 0.25f;
+        static constexpr double maxLatencySeconds = 1.0;
+        static constexpr float minimumConfidence = 8.0f;
+
+        // One period of the order-15 MLS at +/- testLevel.
+        static std::vector<float> createTestSignal();
+
+        // Correlates a capture (starting with the first sample the signal was played)
+        // against the signal and returns the lag of the strongest match, either polarity.
+        static Result measure(const float* signal, int signalLength,
+                              const float* captured, int capturedLength,
+                              int maxLatencySamples);
+
+        bool start(double sampleRate);
+        void cancel() noexcept;
+        bool isRunning() const noexcept { return state.load(std::memory_order_acquire) == State::running; }
+        bool isCaptureComplete() const noexcept { return state.load(std::memory_order_acquire) == State::captured; }
+
+        // Analyses a complete capture and returns to idle.
+        Result analyse();
+
+        // Audio thread. While running, replaces numSamples of every output channel from
+        // outputStart with the test signal and captures the input sum. Returns true when
+        // it wrote the output, so the caller skips its own processing for the block.
+        bool processBlock(const juce::AudioBuffer<float>& input, int numInputChannels,
+                          juce::AudioBuffer<float>& output, int outputStart, int numSamples) noexcept;
+
+    private:
+        enum class State : int
+        {
+            idle,
+            running,
+            captured
+        };
+
+        std::atomic<State> state { State::idle };
+        std::vector<float> signal;
+        std::vector<float> capture;
+        int position = 0;
+        int maxLatencySamples = 0;
+    };
+}
@@ -0,0 +1,293 @@
+#include "RecordingTakeFile.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <cerrno>
+ #include <fcntl.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+namespace sampledex
+{
+    namespace
+    {
+        void putLittleEndian16(char* dest, std::uint16_t value)
+        {
+            dest[0] = static_cast<char>(value & 0xff);
+            dest[1] = static_cast<char>((value >> 8) & 0xff);
+        }
+
+        void putLittleEndian32(char* dest, std::uint32_t value)
+        {
+            for (int byte = 0; byte < 4; ++byte)
+                dest[byte] = static_cast<char>((value >> (8 * byte)) & 0xff);
+        }
+
+        void putLittleEndian64(char* dest, std::uint64_t value)
+        {
+            for (int byte = 0; byte < 8; ++byte)
+                dest[byte] = static_cast<char>((value >> (8 * byte)) & 0xff);
+        }
+
+        // Matches juce::AudioData's float to 24-bit conversion: clamp, scale, round.
+        void putSample24(char* dest, float sample)
+        {
+            const auto clamped = juce::jlimit(-1.0f, 1.0f, std::isfinite(sample) ? sample : 0.0f);
+            const auto value = juce::roundToInt(static_cast<double>(clamped) * 8388607.0);
+            dest[0] = static_cast<char>(value & 0xff);
+            dest[1] = static_cast<char>((value >> 8) & 0xff);
+            dest[2] = static_cast<char>((value >> 16) & 0xff);
+        }
+    }
+
+    RecordingTakeFile::~RecordingTakeFile()
+    {
+        close();
+    }
+
+    bool RecordingTakeFile::open(const juce::File& fileToWrite, double sampleRate, int numChannels, juce::String& error)
+    {
+        close();
+        file = fileToWrite;
+        rate = sampleRate > 0.0 ? sampleRate : 44100.0;
+        channelCount = juce::jlimit(1, 8, numChannels);
+        failed = false;
+        stagedBytes = 0;
+        writeOffset = headerBytes;
+        allocatedBytes = 0;
+        samplesAppended = 0;
+
+        const auto frameBytes = static_cast<std::int64_t>(channelCount * bytesPerSample);
+        preallocateStepBytes = static_cast<std::int64_t>(std::ceil(rate * preallocateSeconds)) * frameBytes;
+        preallocateStepBytes = ((preallocateStepBytes + writeAlignment - 1) / writeAlignment) * writeAlignment;
+        // Leave room for a chunk plus one frame so a frame never straddles the end.
+        staging.assign(static_cast<size_t>(stagingBytes + writeAlignment + frameBytes), 0);
+
+       #if JUCE_LINUX || JUCE_MAC
+        fd = ::open(file.getFullPathName().toRawUTF8(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            error = "Unable to create recording file: " + file.getFullPathName()
+                  + " (" + juce::String(std::strerror(errno)) + ")";
+            return false;
+        }
+       #else
+        file.deleteFile();
+        stream = std::make_unique<juce::FileOutputStream>(file);
+        if (!stream->openedOk())
+        {
+            error = "Unable to create recording file: " + file.getFullPathName()
+                  + " (" + stream->getStatus().getErrorMessage() + ")";
+            stream.reset();
+            return false;
+        }
+       #endif
+
+        opened = true;
+        reserveAhead(headerBytes + preallocateStepBytes);
+        // Zero sizes until close(); a crash leaves a file that says so rather than one
+        // claiming pre-extended silence as audio.
+        if (!writeHeader(0))
+        {
+            error = "Unable to write recording file header: " + file.getFullPathName();
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool RecordingTakeFile::append(const float* const* channels, int numSamples)
+    {
+        if (!opened || failed || channels == nullptr || numSamples <= 0)
+            return !failed;
+
+        const int frameBytes = channelCount * bytesPerSample;
+        int sample = 0;
+        while (sample < numSamples)
+        {
+            const int room = (stagingBytes + writeAlignment - stagedBytes) / frameBytes;
+            const int count = juce::jmin(numSamples - sample, juce::jmax(1, room));
+            auto* dest = staging.data() + stagedBytes;
+            for (int frame = 0; frame < count; ++frame)
+            {
+                for (int channel = 0; channel < channelCount; ++channel)
+                {
+                    putSample24(dest, channels[channel][sample + frame]);
+                    dest += bytesPerSample;
+                }
+            }
+            stagedBytes += count * frameBytes;
+            sample += count;
+            samplesAppended += count;
+
+            if (stagedBytes >= stagingBytes && !writeStaged(false))
+                return false;
+        }
+        return true;
+    }
+
+    bool RecordingTakeFile::close()
+    {
+        if (!opened)
+            return !failed;
+
+        writeStaged(true);
+        const auto dataBytes = writeOffset - headerBytes;
+        if (!writeHeader(static_cast<std::uint64_t>(dataBytes)))
+            failed = true;
+
+       #if JUCE_LINUX || JUCE_MAC
+        // Drops the unused pre-extension, plus the pad byte RIFF wants after odd-sized data.
+        const auto fileBytes = writeOffset + (dataBytes & 1);
+        if (::ftruncate(fd, static_cast<off_t>(fileBytes)) != 0)
+            failed = true;
+        if (::close(fd) != 0)
+            failed = true;
+        fd = -1;
+       #else
+        if ((dataBytes & 1) != 0)
+        {
+            const char pad = 0;
+            writeAt(writeOffset, &pad, 1);
+        }
+        stream->flush();
+        if (stream->getStatus().failed())
+            failed = true;
+        stream.reset();
+       #endif
+
+        opened = false;
+        staging.clear();
+        staging.shrink_to_fit();
+        return !failed;
+    }
+
+    bool RecordingTakeFile::writeAt(std::int64_t offset, const void* data, std::size_t numBytes)
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        auto* bytes = static_cast<const char*>(data);
+        while (numBytes > 0)
+        {
+            const auto written = ::pwrite(fd, bytes, numBytes, static_cast<off_t>(offset));
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+            {
+                failed = true;
+                return false;
+            }
+            bytes += written;
+            offset += written;
+            numBytes -= static_cast<std::size_t>(written);
+        }
+        return true;
+       #else
+        if (!stream->setPosition(offset) || !stream->write(data, numBytes))
+        {
+            failed = true;
+            return false;
+        }
+        return true;
+       #endif
+    }
+
+    bool RecordingTakeFile::writeStaged(bool includePartialChunk)
+    {
+        const int bytesToWrite = includePartialChunk ? stagedBytes
+                                                     : (stagedBytes / writeAlignment) * writeAlignment;
+        if (bytesToWrite <= 0)
+            return !failed;
+
+        reserveAhead(writeOffset + bytesToWrite);
+        if (!writeAt(writeOffset, staging.data(), static_cast<std::size_t>(bytesToWrite)))
+            return false;
+
+        writeOffset += bytesToWrite;
+        stagedBytes -= bytesToWrite;
+        if (stagedBytes > 0)
+            std::memmove(staging.data(), staging.data() + bytesToWrite, static_cast<size_t>(stagedBytes));
+        return true;
+    }
+
+    void RecordingTakeFile::reserveAhead(std::int64_t endOffset)
+    {
+        if (endOffset <= allocatedBytes)
+            return;
+
+        // Extend a whole step past what is needed, so this runs every preallocateSeconds.
+        const auto target = endOffset + preallocateStepBytes;
+       #if JUCE_LINUX
+        // KEEP_SIZE: the reported length stays at what was written until close(). Not every
+        // file system supports it; a failure just means the file grows as it is written.
+        ::fallocate(fd, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(allocatedBytes),
+                    static_cast<off_t>(target - allocatedBytes));
+       #elif JUCE_MAC
+        fstore_t store {};
+        store.fst_flags = F_ALLOCATECONTIG;
+        store.fst_posmode = F_PEOFPOSMODE;
+        store.fst_offset = 0;
+        store.fst_length = static_cast<off_t>(target - allocatedBytes);
+        if (::fcntl(fd, F_PREALLOCATE, &store) == -1)
+        {
+            store.fst_flags = F_ALLOCATEALL;
+            ::fcntl(fd, F_PREALLOCATE, &store);
+        }
+       #endif
+        allocatedBytes = target;
+    }
+
+    bool RecordingTakeFile::writeHeader(std::uint64_t dataBytes)
+    {
+        // RIFF(12) + JUNK or ds64(8 + 28) + fmt(8 + 16) + JUNK(8 + pad) + data(8) == headerBytes.
+        // The first JUNK reserves room for the ds64 chunk, so a take that outgrows 32-bit
+        // sizes becomes RF64 (EBU Tech 3306) without moving its sample data.
+        constexpr int ds64ChunkBytes = 28;
+        constexpr int fmtChunkBytes = 16;
+        constexpr int junkBytes = headerBytes - 12 - (8 + ds64ChunkBytes) - (8 + fmtChunkBytes) - 8 - 8;
+        static_assert(junkBytes > 0);
+
+        const auto riffBytes = static_cast<std::uint64_t>(headerBytes - 8) + dataBytes + (dataBytes & 1u);
+        const bool rf64 = riffBytes > 0xffffffffu;
+        const auto blockAlign = static_cast<std::uint16_t>(channelCount * bytesPerSample);
+
+        std::array<char, headerBytes> header {};
+        auto* out = header.data();
+        std::memcpy(out, rf64 ? "RF64" : "RIFF", 4);
+        putLittleEndian32(out + 4, rf64 ? 0xffffffffu : static_cast<std::uint32_t>(riffBytes));
+        std::memcpy(out + 8, "WAVE", 4);
+        out += 12;
+
+        std::memcpy(out, rf64 ? "ds64" : "JUNK", 4);
+        putLittleEndian32(out + 4, ds64ChunkBytes);
+        if (rf64)
+        {
+            putLittleEndian64(out + 8, riffBytes);
+            putLittleEndian64(out + 16, dataBytes);
+            putLittleEndian64(out + 24, dataBytes / blockAlign);
+            putLittleEndian32(out + 32, 0); // no table entries
+        }
+        out += 8 + ds64ChunkBytes;
+
+        std::memcpy(out, "fmt ", 4);
+        putLittleEndian32(out + 4, fmtChunkBytes);
+        putLittleEndian16(out + 8, 1); // PCM
+        putLittleEndian16(out + 10, static_cast<std::uint16_t>(channelCount));
+        putLittleEndian32(out + 12, static_cast<std::uint32_t>(juce::roundToInt(rate)));
+        putLittleEndian32(out + 16, static_cast<std::uint32_t>(juce::roundToInt(rate)) * blockAlign);
+        putLittleEndian16(out + 20, blockAlign);
+        putLittleEndian16(out + 22, static_cast<std::uint16_t>(bitsPerSample));
+        out += 8 + fmtChunkBytes;
+
+        std::memcpy(out, "JUNK", 4);
+        putLittleEndian32(out + 4, static_cast<std::uint32_t>(junkBytes));
+        out += 8 + junkBytes;
+
+        std::memcpy(out, "data", 4);
+        putLittleEndian32(out + 4, rf64 ? 0xffffffffu : static_cast<std::uint32_t>(dataBytes));
+        return writeAt(0, header.data(), header.size());
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstdint>
+#include <vector>
+
+namespace sampledex
+{
+    // One recording take written as 24-bit PCM WAV by the recording disk thread. Samples
+    // are packed into a staging buffer allocated at open(), and reach the disk in large
+    // chunks aligned to the file system block, so a 32-track take is a few big writes
+    // per flush instead of one small append per track. The file is pre-extended ahead
+    // of the write position (fallocate on Linux, F_PREALLOCATE on macOS) so it does not
+    // grow one append at a time. The RIFF sizes are written by close(), which also trims
+    // the unused pre-extension; a take past 4 GB is closed as RF64 instead. Not thread
+    // safe: open, append and close on one thread.
+    class RecordingTakeFile final
+    {
+    public:
+        static constexpr int bitsPerSample = 24;
+        static constexpr int bytesPerSample = bitsPerSample / 8;
+        static constexpr int writeAlignment = 4096;
+        static constexpr int stagingBytes = 1 << 20;
+        static constexpr double preallocateSeconds = 30.0;
+        // The header is padded with a JUNK chunk so sample data starts on an aligned offset.
+        static constexpr int headerBytes = writeAlignment;
+
+        RecordingTakeFile() = default;
+        ~RecordingTakeFile();
+
+        bool open(const juce::File& fileToWrite, double sampleRate, int numChannels, juce::String& error);
+
+        // Appends numSamples frames from the channel pointers (numChannels of them). Writes
+        // happen once the staging buffer holds a full chunk. Returns false after an I/O error.
+        bool append(const float* const* channels, int numSamples);
+
+        // Writes what is staged, patches the header and closes the file. Returns false
+        // when anything failed since open(); the file then holds what was written.
+        bool close();
+
+        bool isOpen() const noexcept { return opened; }
+        bool hasFailed() const noexcept { return failed; }
+        const juce::File& getFile() const noexcept { return file; }
+        std::int64_t getSamplesWritten() const noexcept { return samplesAppended; }
+        std::int64_t getBytesAllocated() const noexcept { return allocatedBytes; }
+
+    private:
+        bool writeAt(std::int64_t offset, const void* data, std::size_t numBytes);
+        bool writeStaged(bool includePartialChunk);
+        void reserveAhead(std::int64_t endOffset);
+        bool writeHeader(std::uint64_t dataBytes);
+
+        juce::File file;
+       #if JUCE_LINUX || JUCE_MAC
+        int fd = -1;
+       #else
+        std::unique_ptr<juce::FileOutputStream> stream;
+       #endif
+        bool opened = false;
+        bool failed = false;
+        int channelCount = 2;
+        double rate = 44100.0;
+        std::vector<char> staging;
+        int stagedBytes = 0;
+        std::int64_t writeOffset = headerBytes;
+        std::int64_t allocatedBytes = 0;
+        std::int64_t preallocateStepBytes = 0;
+        std::int64_t samplesAppended = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(RecordingTakeFile)
+    };
+}
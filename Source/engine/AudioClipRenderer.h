@@ -0,0 +1,408 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "TempoMap.h"
+#include "TimelineModel.h"
+
+namespace sampledex
+{
+    // Places one audio clip's slice of a block on a track's timeline buffer: tempo-map
+    // aware source positioning (tape, beat-warp, one-shot), fades, and band-limited or
+    // linear resampling. Shared by the device callback and the isolated offline engine so
+    // both play clips identically. Allocation-free.
+    class AudioClipRenderer final
+    {
+    public:
+        static constexpr int resamplerPhases = 128;
+        static constexpr int resamplerTaps = 32;
+
+        enum class StretchQuality
+        {
+            Fast = 0,
+            High = 1
+        };
+
+        // A clip whose audio is read from disk in windows; in-memory clips pass nullptr.
+        struct StreamInfo
+        {
+            std::int64_t numSamples = 0;
+            int numChannels = 0;
+            double sampleRate = 44100.0;
+        };
+
+        using PolyphaseCoefficients = std::array<std::array<float, resamplerTaps>, resamplerPhases>;
+
+        static const PolyphaseCoefficients& getResamplerCoefficients()
+        {
+            static const PolyphaseCoefficients coeffs = []
+            {
+                PolyphaseCoefficients table {};
+                constexpr int halfTaps = resamplerTaps / 2;
+                constexpr double cutoff = 0.965;
+                constexpr double pi = juce::MathConstants<double>::pi;
+
+                for (int phase = 0; phase < resamplerPhases; ++phase)
+                {
+                    const double frac = static_cast<double>(phase) / static_cast<double>(resamplerPhases);
+                    double norm = 0.0;
+                    for (int tap = 0; tap < resamplerTaps; ++tap)
+                    {
+                        const double x = static_cast<double>(tap - halfTaps + 1) - frac;
+                        const double sincArg = x * cutoff;
+                        const double sinc = std::abs(sincArg) < 1.0e-8
+                            ? 1.0
+                            : std::sin(pi * sincArg) / (pi * sincArg);
+                        const double window = 0.54 - (0.46 * std::cos((2.0 * pi * static_cast<double>(tap))
+                                                                       / static_cast<double>(resamplerTaps - 1)));
+                        const double v = cutoff * sinc * window;
+                        table[static_cast<size_t>(phase)][static_cast<size_t>(tap)] = static_cast<float>(v);
+                        norm += v;
+                    }
+                    const float normInv = static_cast<float>(1.0 / juce::jmax(1.0e-12, norm));
+                    for (int tap = 0; tap < resamplerTaps; ++tap)
+                        table[static_cast<size_t>(phase)][static_cast<size_t>(tap)] *= normInv;
+                }
+                return table;
+            }();
+
+            return coeffs;
+        }
+
+        static inline float sampleBandlimited(const float* src, int srcLength, double sourcePosition) noexcept
+        {
+            if (src == nullptr || srcLength <= 0)
+                return 0.0f;
+
+            const auto& coeffs = getResamplerCoefficients();
+            constexpr int halfTaps = resamplerTaps / 2;
+            const int baseIndex = static_cast<int>(std::floor(sourcePosition));
+            const double frac = sourcePosition - static_cast<double>(baseIndex);
+            const double phasePosition = frac * static_cast<double>(resamplerPhases - 1);
+            const int phaseA = juce::jlimit(0,
+                                            resamplerPhases - 1,
+                                            static_cast<int>(std::floor(phasePosition)));
+            const int phaseB = juce::jlimit(0, resamplerPhases - 1, phaseA + 1);
+            const float phaseMix = static_cast<float>(phasePosition - static_cast<double>(phaseA));
+            const int start = baseIndex - halfTaps + 1;
+            float out = 0.0f;
+            for (int tap = 0; tap < resamplerTaps; ++tap)
+            {
+                const int srcIndex = juce::jlimit(0, srcLength - 1, start + tap);
+                const float coeffA = coeffs[static_cast<size_t>(phaseA)][static_cast<size_t>(tap)];
+                const float coeffB = coeffs[static_cast<size_t>(phaseB)][static_cast<size_t>(tap)];
+                const float coeff = coeffA + ((coeffB - coeffA) * phaseMix);
+                out += src[srcIndex] * coeff;
+            }
+            return out;
+        }
+
+        static inline float sampleLinear(const float* src, int srcLength, double sourcePosition) noexcept
+        {
+            if (src == nullptr || srcLength <= 0)
+                return 0.0f;
+
+            const double clamped = juce::jlimit(0.0, static_cast<double>(srcLength - 1), sourcePosition);
+            const int idxA = juce::jlimit(0, srcLength - 1, static_cast<int>(std::floor(clamped)));
+            const int idxB = juce::jlimit(0, srcLength - 1, idxA + 1);
+            const float frac = static_cast<float>(clamped - static_cast<double>(idxA));
+            return src[idxA] + ((src[idxB] - src[idxA]) * frac);
+        }
+
+        static inline float sampleForStretchQuality(const float* src,
+                                                    int srcLength,
+                                                    double sourcePosition,
+                                                    StretchQuality quality) noexcept
+        {
+            return quality == StretchQuality::High
+                ? sampleBandlimited(src, srcLength, sourcePosition)
+                : sampleLinear(src, srcLength, sourcePosition);
+        }
+
+        static double mapClipBeatToSourceBeat(const Clip& clip, double clipBeat) noexcept
+        {
+            const double localBeat = juce::jmax(0.0, clipBeat);
+            if (clip.stretchMode != ClipStretchMode::BeatWarp || clip.warpMarkers.empty())
+                return localBeat;
+
+            const auto& markers = clip.warpMarkers;
+            if (markers.size() == 1)
+                return juce::jmax(0.0, markers.front().sourceBeat + (localBeat - markers.front().clipBeat));
+
+            if (localBeat <= markers.front().clipBeat)
+                return juce::jmax(0.0, markers.front().sourceBeat + (localBeat - markers.front().clipBeat));
+
+            for (size_t i = 0; i + 1 < markers.size(); ++i)
+            {
+                const auto& a = markers[i];
+                const auto& b = markers[i + 1];
+                if (localBeat <= b.clipBeat)
+                {
+                    const double clipSpan = juce::jmax(1.0e-6, b.clipBeat - a.clipBeat);
+                    const double sourceSpan = b.sourceBeat - a.sourceBeat;
+                    const double t = juce::jlimit(0.0, 1.0, (localBeat - a.clipBeat) / clipSpan);
+                    return juce::jmax(0.0, a.sourceBeat + (sourceSpan * t));
+                }
+            }
+
+            const auto& tailA = markers[markers.size() - 2];
+            const auto& tailB = markers.back();
+            const double clipSpan = juce::jmax(1.0e-6, tailB.clipBeat - tailA.clipBeat);
+            const double slope = (tailB.sourceBeat - tailA.sourceBeat) / clipSpan;
+            return juce::jmax(0.0, tailB.sourceBeat + ((localBeat - tailB.clipBeat) * slope));
+        }
+
+        static inline float applyMicroFadeWindow(double beatInClip,
+                                                 double clipLengthBeats,
+                                                 double beatsPerSample,
+                                                 float inSample) noexcept
+        {
+            constexpr int microFadeSamples = 48;
+            const double microFadeBeats = static_cast<double>(microFadeSamples) * beatsPerSample;
+            if (microFadeBeats <= 0.0)
+                return inSample;
+
+            float fade = 1.0f;
+            if (beatInClip < microFadeBeats)
+                fade = juce::jmin(fade, static_cast<float>(juce::jlimit(0.0, 1.0, beatInClip / microFadeBeats)));
+
+            const double beatsToEnd = juce::jmax(0.0, clipLengthBeats - beatInClip);
+            if (beatsToEnd < microFadeBeats)
+                fade = juce::jmin(fade, static_cast<float>(juce::jlimit(0.0, 1.0, beatsToEnd / microFadeBeats)));
+
+            return inSample * fade;
+        }
+
+        static inline float applyEqualPowerFade(float linearFade) noexcept
+        {
+            const float clamped = juce::jlimit(0.0f, 1.0f, linearFade);
+            return std::sin(clamped * static_cast<float>(juce::MathConstants<double>::halfPi));
+        }
+
+        // Adds the part of clip inside [blockStartBeat, blockEndBeat) to destination.
+        // stream == nullptr plays clip.audioData; otherwise readWindow(scratch, start,
+        // numSamples) fills streamScratch with the source window the segment needs.
+        template <typename ReadWindowFn>
+        static void renderSegment(const Clip& clip,
+                                  const StreamInfo* stream,
+                                  ReadWindowFn&& readWindow,
+                                  const TempoMapIndex& tempoMap,
+                                  const TempoBlockSpan& blockSpan,
+                                  double blockStartBeat,
+                                  double blockEndBeat,
+                                  int blockSamples,
+                                  double sampleRate,
+                                  double fallbackBpm,
+                                  StretchQuality stretchQuality,
+                                  juce::AudioBuffer<float>& streamScratch,
+                                  juce::AudioBuffer<float>& destination)
+        {
+            const bool hasDiskStream = stream != nullptr;
+            if (!hasDiskStream && clip.audioData == nullptr)
+                return;
+
+            const double clipStart = clip.startBeat;
+            const double clipEnd = clip.startBeat + juce::jmax(0.0001, clip.lengthBeats);
+            if (clipEnd <= blockStartBeat || clipStart >= blockEndBeat)
+                return;
+
+            const double segmentStartBeat = juce::jmax(blockStartBeat, clipStart);
+            const double segmentEndBeat = juce::jmin(blockEndBeat, clipEnd);
+            if (segmentEndBeat <= segmentStartBeat)
+                return;
+
+            const int targetStartSample = static_cast<int>(std::round(blockSpan.sampleOffsetForBeat(segmentStartBeat)));
+            int targetNumSamples = static_cast<int>(std::round(blockSpan.sampleOffsetForBeat(segmentEndBeat)))
+                                 - targetStartSample;
+            if (targetNumSamples <= 0)
+                return;
+
+            if (targetStartSample < 0 || targetStartSample >= blockSamples)
+                return;
+            targetNumSamples = juce::jmin(targetNumSamples, blockSamples - targetStartSample);
+            if (targetNumSamples <= 0)
+                return;
+
+            const double sourceSampleRate = hasDiskStream
+                ? juce::jmax(1.0, stream->sampleRate)
+                : juce::jmax(1.0, clip.audioSampleRate);
+            const double clipStartOffsetBeat = segmentStartBeat - clip.startBeat;
+            // Output-side beat step per sample, re-read at each tempo change the segment crosses.
+            double beatStep = tempoMap.getTempoAtBeat(segmentStartBeat) / (60.0 * juce::jmax(1.0, sampleRate));
+            double nextTempoChangeInClip = tempoMap.nextChangeAfterBeat(segmentStartBeat) - clip.startBeat;
+            const double sourceTempoBpm = juce::jmax(1.0,
+                                                     clip.originalTempoBpm > 0.0 ? clip.originalTempoBpm
+                                                                                 : (clip.detectedTempoBpm > 0.0 ? clip.detectedTempoBpm
+                                                                                                         : fallbackBpm));
+            const double sourceSecondsPerBeat = 60.0 / sourceTempoBpm;
+            const double sourceSamplesPerBeat = sourceSecondsPerBeat * sourceSampleRate;
+            // Unwarped audio plays in real time, so its source position follows the tempo
+            // map's elapsed seconds rather than beats times the current tempo.
+            const double clipOriginBeat = clip.startBeat - clip.offsetBeats;
+            const double clipOriginSeconds = tempoMap.secondsAtBeat(clipOriginBeat);
+            const double clipStartSeconds = tempoMap.secondsAtBeat(clip.startBeat);
+            auto sourcePositionForClipBeat = [&](double beatInClip)
+            {
+                const double clipBeatWithOffset = juce::jmax(0.0, beatInClip + clip.offsetBeats);
+                if (clip.oneShot || clip.stretchMode == ClipStretchMode::OneShot)
+                    return clip.offsetBeats * sourceSamplesPerBeat
+                         + (tempoMap.secondsAtBeat(clip.startBeat + beatInClip) - clipStartSeconds) * sourceSampleRate;
+
+                if (clip.stretchMode == ClipStretchMode::BeatWarp)
+                    return mapClipBeatToSourceBeat(clip, clipBeatWithOffset) * sourceSamplesPerBeat;
+
+                return (tempoMap.secondsAtBeat(clipOriginBeat + clipBeatWithOffset) - clipOriginSeconds) * sourceSampleRate;
+            };
+
+            const int clipNumSamples = hasDiskStream
+                ? static_cast<int>(juce::jmin<std::int64_t>(std::numeric_limits<int>::max(), stream->numSamples))
+                : clip.audioData->getNumSamples();
+            const int clipNumChannels = hasDiskStream
+                ? stream->numChannels
+                : clip.audioData->getNumChannels();
+            if (clipNumSamples <= 1 || clipNumChannels <= 0)
+                return;
+
+            std::int64_t readWindowStart = 0;
+            int readWindowLength = 0;
+            if (hasDiskStream)
+            {
+                const std::int64_t clipTotalSamples = stream->numSamples;
+                const double sourceStartPosition = sourcePositionForClipBeat(clipStartOffsetBeat);
+                const double segmentEndInClip = blockSpan.beatAtSample(static_cast<double>(targetStartSample + targetNumSamples))
+                                              - clip.startBeat;
+                const double sourceEndPosition = sourcePositionForClipBeat(segmentEndInClip);
+                const double minSourcePosition = juce::jmin(sourceStartPosition, sourceEndPosition);
+                const double maxSourcePosition = juce::jmax(sourceStartPosition, sourceEndPosition);
+                readWindowStart = juce::jlimit<std::int64_t>(0,
+                                                             juce::jmax<std::int64_t>(0, clipTotalSamples - 1),
+                                                             static_cast<std::int64_t>(std::floor(minSourcePosition)) - resamplerTaps);
+                const double readWindowEndPos = maxSourcePosition + static_cast<double>(resamplerTaps);
+                const std::int64_t windowEnd = juce::jlimit<std::int64_t>(0,
+                                                                          clipTotalSamples,
+                                                                          static_cast<std::int64_t>(std::ceil(readWindowEndPos)) + 2);
+                readWindowLength = static_cast<int>(juce::jmax<std::int64_t>(0, windowEnd - readWindowStart));
+                if (readWindowLength <= 1
+                    || streamScratch.getNumChannels() < clipNumChannels
+                    || streamScratch.getNumSamples() < readWindowLength)
+                {
+                    return;
+                }
+
+                if (!readWindow(streamScratch, readWindowStart, readWindowLength))
+                    return;
+            }
+
+            const float baseGain = juce::jlimit(0.0f, 8.0f, clip.gainLinear);
+            const double fadeInBeats = juce::jmax(0.0, juce::jmax(clip.fadeInBeats, clip.crossfadeInBeats));
+            const double fadeOutBeats = juce::jmax(0.0, juce::jmax(clip.fadeOutBeats, clip.crossfadeOutBeats));
+            double beatInClip = clipStartOffsetBeat;
+            const int clipOutputChannels = destination.getNumChannels();
+            if (clipOutputChannels <= 0 || destination.getNumSamples() < blockSamples)
+                return;
+            const int sourceBufferNumSamples = hasDiskStream ? readWindowLength : clipNumSamples;
+            const double sourceBaseOffset = hasDiskStream ? static_cast<double>(readWindowStart) : 0.0;
+            auto computeLocalSourcePosition = [&](double localBeat)
+            {
+                return sourcePositionForClipBeat(localBeat) - sourceBaseOffset;
+            };
+            auto advanceBeatInClip = [&]
+            {
+                beatInClip += beatStep;
+                if (beatInClip < nextTempoChangeInClip)
+                    return;
+                const double absoluteBeat = clip.startBeat + beatInClip;
+                beatStep = tempoMap.getTempoAtBeat(absoluteBeat) / (60.0 * juce::jmax(1.0, sampleRate));
+                nextTempoChangeInClip = tempoMap.nextChangeAfterBeat(absoluteBeat) - clip.startBeat;
+            };
+            auto fadeGainAt = [&]
+            {
+                float fadeGain = 1.0f;
+                if (fadeInBeats > 0.0)
+                {
+                    const float fadeInLinear = static_cast<float>(juce::jlimit(0.0,
+                                                                               1.0,
+                                                                               beatInClip / fadeInBeats));
+                    fadeGain = juce::jmin(fadeGain, applyEqualPowerFade(fadeInLinear));
+                }
+                if (fadeOutBeats > 0.0)
+                {
+                    const double beatsToEnd = juce::jmax(0.0, clip.lengthBeats - beatInClip);
+                    const float fadeOutLinear = static_cast<float>(juce::jlimit(0.0,
+                                                                                 1.0,
+                                                                                 beatsToEnd / fadeOutBeats));
+                    fadeGain = juce::jmin(fadeGain, applyEqualPowerFade(fadeOutLinear));
+                }
+                return fadeGain;
+            };
+
+            if (clipNumChannels == 1)
+            {
+                const auto* src = hasDiskStream ? streamScratch.getReadPointer(0)
+                                                : clip.audioData->getReadPointer(0);
+                auto* dstL = clipOutputChannels > 0 ? destination.getWritePointer(0) : nullptr;
+                auto* dstR = clipOutputChannels > 1 ? destination.getWritePointer(1) : nullptr;
+
+                for (int sampleIdx = 0; sampleIdx < targetNumSamples; ++sampleIdx)
+                {
+                    const double localSourcePosition = computeLocalSourcePosition(beatInClip);
+                    if (localSourcePosition >= static_cast<double>(sourceBufferNumSamples - 1))
+                        break;
+
+                    const float fadeGain = fadeGainAt();
+                    const int writeIndex = targetStartSample + sampleIdx;
+                    float interpolated = sampleForStretchQuality(src,
+                                                                 sourceBufferNumSamples,
+                                                                 localSourcePosition,
+                                                                 stretchQuality);
+                    interpolated = applyMicroFadeWindow(beatInClip, clip.lengthBeats, beatStep, interpolated);
+                    const float scaled = interpolated * (baseGain * fadeGain);
+                    if (dstL != nullptr)
+                        dstL[writeIndex] += scaled;
+                    if (dstR != nullptr)
+                        dstR[writeIndex] += scaled;
+
+                    advanceBeatInClip();
+                }
+                return;
+            }
+
+            const int mixChannels = juce::jmin(clipNumChannels, clipOutputChannels, 2);
+            if (mixChannels <= 0)
+                return;
+
+            std::array<const float*, 2> srcPointers {};
+            std::array<float*, 2> dstPointers {};
+            for (int ch = 0; ch < mixChannels; ++ch)
+            {
+                srcPointers[static_cast<size_t>(ch)] = hasDiskStream ? streamScratch.getReadPointer(ch)
+                                                                      : clip.audioData->getReadPointer(ch);
+                dstPointers[static_cast<size_t>(ch)] = destination.getWritePointer(ch);
+            }
+
+            for (int sampleIdx = 0; sampleIdx < targetNumSamples; ++sampleIdx)
+            {
+                const double localSourcePosition = computeLocalSourcePosition(beatInClip);
+                if (localSourcePosition >= static_cast<double>(sourceBufferNumSamples - 1))
+                    break;
+
+                const int writeIndex = targetStartSample + sampleIdx;
+                const float sampleGain = baseGain * fadeGainAt();
+                for (int ch = 0; ch < mixChannels; ++ch)
+                {
+                    float interpolated = sampleForStretchQuality(srcPointers[static_cast<size_t>(ch)],
+                                                                 sourceBufferNumSamples,
+                                                                 localSourcePosition,
+                                                                 stretchQuality);
+                    interpolated = applyMicroFadeWindow(beatInClip, clip.lengthBeats, beatStep, interpolated);
+                    dstPointers[static_cast<size_t>(ch)][writeIndex] += interpolated * sampleGain;
+                }
+
+                advanceBeatInClip();
+            }
+        }
+    };
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "TimelineModel.h"
+
+namespace sampledex
+{
+    // Remembers where the last evaluation of one automation lane landed, so evaluating
+    // a playing block is O(1) instead of a binary search per lookup. Any change to the
+    // lane's point storage (a new snapshot) or a backwards jump falls back to a search.
+    class AutomationLaneCursor
+    {
+    public:
+        // Index of the first point strictly after beat (points.size() past the last).
+        size_t seek(const std::vector<AutomationPoint>& points, double beat) noexcept
+        {
+            if (points.data() != cachedData || points.size() != cachedSize)
+            {
+                cachedData = points.data();
+                cachedSize = points.size();
+                return search(points, beat);
+            }
+
+            if (nextIndex > 0 && nextIndex <= cachedSize && points[nextIndex - 1].beat > beat)
+                return search(points, beat);
+            if (nextIndex == 0 && cachedSize > 0 && points[0].beat <= beat)
+                return search(points, beat);
+
+            // Playback moves forward by a few points per block at most.
+            for (int step = 0; step < 8; ++step)
+            {
+                if (nextIndex >= cachedSize || points[nextIndex].beat > beat)
+                    return nextIndex;
+                ++nextIndex;
+            }
+            return search(points, beat);
+        }
+
+        float evaluate(const std::vector<AutomationPoint>& points, double beat) noexcept
+        {
+            if (points.empty())
+                return 0.0f;
+
+            const auto next = seek(points, beat);
+            if (next == 0)
+                return points.front().value;
+            if (next >= points.size())
+                return points.back().value;
+
+            const auto& left = points[next - 1];
+            const auto& right = points[next];
+            const double span = juce::jmax(1.0e-9, right.beat - left.beat);
+            const double alpha = juce::jlimit(0.0, 1.0, (beat - left.beat) / span);
+            return left.value + static_cast<float>((right.value - left.value) * alpha);
+        }
+
+        void reset() noexcept
+        {
+            cachedData = nullptr;
+            cachedSize = 0;
+            nextIndex = 0;
+        }
+
+    private:
+        size_t search(const std::vector<AutomationPoint>& points, double beat) noexcept
+        {
+            const auto it = std::upper_bound(points.begin(),
+                                             points.end(),
+                                             beat,
+                                             [](double b, const AutomationPoint& point)
+                                             {
+                                                 return b < point.beat;
+                                             });
+            nextIndex = static_cast<size_t>(std::distance(points.begin(), it));
+            return nextIndex;
+        }
+
+        const AutomationPoint* cachedData = nullptr;
+        size_t cachedSize = 0;
+        size_t nextIndex = 0;
+    };
+
+    // The values of one automation lane over one audio block as piecewise-linear
+    // segments that break exactly at the lane's points, so gain rides and sweeps follow
+    // the lane per sample regardless of the block size. Fixed capacity; filled on the
+    // audio thread without allocating.
+    class AutomationBlockRamp
+    {
+    public:
+        static constexpr int maxSegments = 32;
+
+        struct Segment
+        {
+            int startSample = 0;
+            int numSamples = 0;
+            float startValue = 0.0f;
+            float increment = 0.0f; // per sample
+        };
+
+        void reset(float minimum, float maximum) noexcept
+        {
+            numSegments = 0;
+            minValue = minimum;
+            maxValue = maximum;
+        }
+
+        void clear() noexcept { numSegments = 0; }
+        bool isActive() const noexcept { return numSegments > 0; }
+        int getNumSegments() const noexcept { return numSegments; }
+        const Segment& getSegment(int index) const noexcept { return segments[static_cast<size_t>(index)]; }
+
+        int getNumSamples() const noexcept
+        {
+            if (numSegments == 0)
+                return 0;
+            const auto& last = segments[static_cast<size_t>(numSegments - 1)];
+            return last.startSample + last.numSamples;
+        }
+
+        // Value the lane reaches at the end of the block.
+        float getEndValue() const noexcept
+        {
+            if (numSegments == 0)
+                return minValue;
+            const auto& last = segments[static_cast<size_t>(numSegments - 1)];
+            return clamp(last.startValue + last.increment * static_cast<float>(last.numSamples));
+        }
+
+        // Writes one value per sample; samples past the ramp hold its end value.
+        void fillValues(float* dest, int numSamples) const noexcept
+        {
+            int written = 0;
+            for (int s = 0; s < numSegments && written < numSamples; ++s)
+            {
+                const auto& segment = segments[static_cast<size_t>(s)];
+                const int count = juce::jmin(segment.numSamples, numSamples - segment.startSample);
+                float value = segment.startValue;
+                for (int i = 0; i < count; ++i)
+                {
+                    dest[segment.startSample + i] = clamp(value);
+                    value += segment.increment;
+                }
+                written = segment.startSample + juce::jmax(0, count);
+            }
+
+            const float endValue = getEndValue();
+            for (int i = written; i < numSamples; ++i)
+                dest[i] = endValue;
+        }
+
+        // Appends the lane's values for numSamples samples starting at sampleOffset, whose
+        // first sample plays startBeat. Call twice for a block that wraps at a loop end.
+        void append(const std::vector<AutomationPoint>& points,
+                    AutomationLaneCursor& cursor,
+                    double startBeat,
+                    double beatsPerSample,
+                    int sampleOffset,
+                    int numSamples) noexcept
+        {
+            if (points.empty() || numSamples <= 0 || numSegments >= maxSegments)
+                return;
+
+            beatsPerSample = juce::jmax(1.0e-12, beatsPerSample);
+            const int endSample = sampleOffset + numSamples;
+            size_t next = cursor.seek(points, startBeat);
+            int sample = sampleOffset;
+            while (sample < endSample)
+            {
+                const double beat = startBeat + static_cast<double>(sample - sampleOffset) * beatsPerSample;
+                while (next < points.size() && points[next].beat <= beat)
+                    ++next;
+
+                int regionEnd = endSample;
+                if (next < points.size())
+                {
+                    const double offset = (points[next].beat - startBeat) / beatsPerSample;
+                    if (offset < static_cast<double>(numSamples))
+                        regionEnd = juce::jlimit(sample + 1,
+                                                 endSample,
+                                                 sampleOffset + static_cast<int>(std::ceil(offset)));
+                }
+
+                Segment segment;
+                segment.startSample = sample;
+                segment.numSamples = regionEnd - sample;
+                if (next == 0)
+                {
+                    segment.startValue = points.front().value;
+                }
+                else if (next >= points.size())
+                {
+                    segment.startValue = points.back().value;
+                }
+                else
+                {
+                    const auto& left = points[next - 1];
+                    const auto& right = points[next];
+                    const double slope = (right.value - left.value) / juce::jmax(1.0e-9, right.beat - left.beat);
+                    segment.startValue = left.value + static_cast<float>(slope * (beat - left.beat));
+                    segment.increment = static_cast<float>(slope * beatsPerSample);
+                }
+
+                if (numSegments == maxSegments - 1 && regionEnd < endSample)
+                {
+                    // Out of room: one straight line to where the lane ends the block.
+                    const double endBeat = startBeat + static_cast<double>(numSamples) * beatsPerSample;
+                    const float endValue = cursor.evaluate(points, endBeat);
+                    segment.numSamples = endSample - sample;
+                    segment.increment = (endValue - segment.startValue) / static_cast<float>(segment.numSamples);
+                    regionEnd = endSample;
+                }
+
+                segments[static_cast<size_t>(numSegments++)] = segment;
+                sample = regionEnd;
+            }
+
+            cursor.seek(points, startBeat + static_cast<double>(numSamples) * beatsPerSample);
+        }
+
+    private:
+        float clamp(float value) const noexcept { return juce::jlimit(minValue, maxValue, value); }
+
+        std::array<Segment, maxSegments> segments {};
+        int numSegments = 0;
+        float minValue = 0.0f;
+        float maxValue = 1.0f;
+    };
+}
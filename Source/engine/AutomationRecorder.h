@@ -0,0 +1,193 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
+#include "TimelineModel.h"
+
+namespace sampledex
+{
+    // Collects automation written during a touch/latch/write pass and folds it into the
+    // lanes once the pass ends, instead of inserting every control-rate point into the
+    // live lane. Points arrive in playback order; a jump backwards (loop wrap, locate)
+    // starts a new run, and later runs overwrite earlier ones where they overlap.
+    // Message thread only.
+    class AutomationWriteRecorder
+    {
+    public:
+        // Points closer than this are the same point; the newer value wins.
+        static constexpr double minBeatDelta = 1.0 / 1024.0;
+
+        // A lane whose writes stop for this long has finished its pass.
+        static constexpr double passEndIdleMs = 250.0;
+
+        void append(int laneId, double beat, float value, double nowMs)
+        {
+            auto& staged = stagedLanes[laneId];
+            staged.lastEventMs = nowMs;
+            const AutomationPoint point { juce::jmax(0.0, beat), value };
+            if (staged.runs.empty() || point.beat + minBeatDelta < staged.runs.back().back().beat)
+            {
+                staged.runs.emplace_back();
+                staged.runs.back().reserve(1024);
+            }
+
+            auto& run = staged.runs.back();
+            if (!run.empty() && std::abs(point.beat - run.back().beat) <= minBeatDelta)
+                run.back() = point;
+            else
+                run.push_back(point);
+        }
+
+        std::vector<int> getFinishedLaneIds(double nowMs, bool includeActive) const
+        {
+            std::vector<int> ids;
+            for (const auto& [laneId, staged] : stagedLanes)
+                if (includeActive || nowMs - staged.lastEventMs >= passEndIdleMs)
+                    ids.push_back(laneId);
+            return ids;
+        }
+
+        bool hasStagedPoints() const noexcept { return !stagedLanes.empty(); }
+
+        void discard(int laneId) { stagedLanes.erase(laneId); }
+        void clear() { stagedLanes.clear(); }
+
+        // Merges the staged runs of laneId into lane.points and drops the staging.
+        // Returns true when the lane's points changed.
+        bool commit(int laneId, AutomationLane& lane, float thinningTolerance)
+        {
+            const auto it = stagedLanes.find(laneId);
+            if (it == stagedLanes.end())
+                return false;
+
+            const auto hashBefore = hashPoints(lane.points);
+            std::vector<AutomationPoint> merged;
+            for (auto& run : it->second.runs)
+            {
+                if (run.empty())
+                    continue;
+                if (thinningTolerance > 0.0f)
+                    thin(run, thinningTolerance);
+                mergeRun(lane.points, run, merged);
+                lane.points.swap(merged);
+            }
+            stagedLanes.erase(it);
+            return hashPoints(lane.points) != hashBefore;
+        }
+
+        // What the lanes will hold once every pending pass is committed, for saving mid-pass.
+        void applyStagedTo(std::vector<AutomationLane>& lanes, float thinningTolerance) const
+        {
+            for (auto& lane : lanes)
+            {
+                const auto it = stagedLanes.find(lane.laneId);
+                if (it == stagedLanes.end())
+                    continue;
+
+                AutomationWriteRecorder copy;
+                copy.stagedLanes.emplace(lane.laneId, it->second);
+                copy.commit(lane.laneId, lane, thinningTolerance);
+            }
+        }
+
+        // Ramer-Douglas-Peucker on value error: removes points that lie within tolerance
+        // of the line between the points that are kept. First and last always stay.
+        static void thin(std::vector<AutomationPoint>& points, float tolerance)
+        {
+            if (points.size() < 3)
+                return;
+
+            std::vector<bool> keep(points.size(), false);
+            keep.front() = true;
+            keep.back() = true;
+            std::vector<std::pair<size_t, size_t>> spans;
+            spans.emplace_back(0, points.size() - 1);
+            while (!spans.empty())
+            {
+                const auto [first, last] = spans.back();
+                spans.pop_back();
+                if (last <= first + 1)
+                    continue;
+
+                const auto& a = points[first];
+                const auto& b = points[last];
+                const double span = juce::jmax(1.0e-12, b.beat - a.beat);
+                float maxError = -1.0f;
+                size_t maxIndex = first;
+                for (size_t i = first + 1; i < last; ++i)
+                {
+                    const double alpha = (points[i].beat - a.beat) / span;
+                    const float expected = a.value + static_cast<float>((b.value - a.value) * alpha);
+                    const float error = std::abs(points[i].value - expected);
+                    if (error > maxError)
+                    {
+                        maxError = error;
+                        maxIndex = i;
+                    }
+                }
+
+                if (maxError > tolerance)
+                {
+                    keep[maxIndex] = true;
+                    spans.emplace_back(first, maxIndex);
+                    spans.emplace_back(maxIndex, last);
+                }
+            }
+
+            size_t write = 0;
+            for (size_t read = 0; read < points.size(); ++read)
+                if (keep[read])
+                    points[write++] = points[read];
+            points.resize(write);
+        }
+
+        static std::uint64_t hashPoints(const std::vector<AutomationPoint>& points) noexcept
+        {
+            std::uint64_t hash = 0xcbf29ce484222325ull ^ static_cast<std::uint64_t>(points.size());
+            for (const auto& point : points)
+            {
+                std::uint64_t beatBits = 0;
+                std::uint32_t valueBits = 0;
+                std::memcpy(&beatBits, &point.beat, sizeof(beatBits));
+                std::memcpy(&valueBits, &point.value, sizeof(valueBits));
+                hash = (hash ^ beatBits) * 0x100000001b3ull;
+                hash = (hash ^ valueBits) * 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+    private:
+        struct StagedLane
+        {
+            std::vector<std::vector<AutomationPoint>> runs;
+            double lastEventMs = 0.0;
+        };
+
+        // Linear merge of a sorted run into sorted lane points: the run replaces every
+        // existing point inside its beat span.
+        static void mergeRun(const std::vector<AutomationPoint>& existing,
+                             const std::vector<AutomationPoint>& run,
+                             std::vector<AutomationPoint>& out)
+        {
+            out.clear();
+            out.reserve(existing.size() + run.size());
+            const double runStart = run.front().beat - minBeatDelta;
+            const double runEnd = run.back().beat + minBeatDelta;
+            size_t i = 0;
+            for (; i < existing.size() && existing[i].beat < runStart; ++i)
+                out.push_back(existing[i]);
+            out.insert(out.end(), run.begin(), run.end());
+            while (i < existing.size() && existing[i].beat <= runEnd)
+                ++i;
+            out.insert(out.end(), existing.begin() + static_cast<std::ptrdiff_t>(i), existing.end());
+        }
+
+        std::map<int, StagedLane> stagedLanes;
+    };
+}
@@ -0,0 +1,398 @@
+#include "ExportSinkPipeline.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace sampledex
+{
+    namespace
+    {
+        // Streams one block at a time through a windowed-sinc interpolator per channel.
+        // Input is kept until the interpolator has enough of it, the interpolator's delay
+        // is trimmed from the start, and flush() pads the end so the output length matches
+        // the input duration exactly.
+        class StreamResampler final
+        {
+        public:
+            StreamResampler(int numChannels, double inputRate, double outputRate, int maxInputBlock)
+                : ratio(inputRate / outputRate),
+                  interpolators(static_cast<size_t>(numChannels)),
+                  samplesToSkip(juce::roundToInt(juce::WindowedSincInterpolator::getBaseLatency() / ratio))
+            {
+                flushPadding = static_cast<int>(std::ceil(juce::WindowedSincInterpolator::getBaseLatency() + (4.0 * ratio))) + 8;
+                const int pendingCapacity = juce::jmax(maxInputBlock, flushPadding) + (2 * static_cast<int>(std::ceil(ratio))) + 16;
+                pending.setSize(numChannels, pendingCapacity, false, true, false);
+                output.setSize(numChannels, static_cast<int>(std::ceil(pendingCapacity / ratio)) + 16, false, true, false);
+
+                // The interpolator does not band-limit, so going down in rate needs a
+                // low-pass below the new Nyquist first (4th-order Butterworth).
+                if (ratio > 1.0)
+                {
+                    const double cutoff = outputRate * 0.45;
+                    for (int ch = 0; ch < numChannels; ++ch)
+                    {
+                        auto& filters = antiAlias.emplace_back();
+                        filters[0].setCoefficients(juce::IIRCoefficients::makeLowPass(inputRate, cutoff, 0.5412));
+                        filters[1].setCoefficients(juce::IIRCoefficients::makeLowPass(inputRate, cutoff, 1.3066));
+                    }
+                }
+            }
+
+            juce::AudioBuffer<float>& getOutput() noexcept { return output; }
+
+            // Returns the number of samples now at the start of getOutput().
+            int process(const juce::AudioBuffer<float>& input, int numSamples) noexcept
+            {
+                append(&input, numSamples);
+                inputTotal += numSamples;
+                return produce(targetLength());
+            }
+
+            int flush() noexcept
+            {
+                append(nullptr, flushPadding);
+                return produce(targetLength());
+            }
+
+        private:
+            std::int64_t targetLength() const noexcept
+            {
+                return static_cast<std::int64_t>(std::llround(static_cast<double>(inputTotal) / ratio));
+            }
+
+            void append(const juce::AudioBuffer<float>* input, int numSamples) noexcept
+            {
+                numSamples = juce::jmin(numSamples, pending.getNumSamples() - pendingSamples);
+                for (int ch = 0; ch < pending.getNumChannels(); ++ch)
+                {
+                    auto* dest = pending.getWritePointer(ch, pendingSamples);
+                    if (input != nullptr && ch < input->getNumChannels())
+                        juce::FloatVectorOperations::copy(dest, input->getReadPointer(ch), numSamples);
+                    else if (input != nullptr && input->getNumChannels() > 0)
+                        juce::FloatVectorOperations::copy(dest, input->getReadPointer(0), numSamples);
+                    else
+                        juce::FloatVectorOperations::clear(dest, numSamples);
+
+                    if (!antiAlias.empty())
+                        for (auto& filter : antiAlias[static_cast<size_t>(ch)])
+                            filter.processSamples(dest, numSamples);
+                }
+                pendingSamples += numSamples;
+            }
+
+            int produce(std::int64_t target) noexcept
+            {
+                // The interpolator reads at most one sample past numOut * ratio.
+                int numOut = static_cast<int>(std::floor(static_cast<double>(pendingSamples - 2) / ratio));
+                numOut = juce::jlimit(0, output.getNumSamples(), numOut);
+                if (numOut == 0)
+                    return 0;
+
+                int used = 0;
+                for (int ch = 0; ch < output.getNumChannels(); ++ch)
+                    used = interpolators[static_cast<size_t>(ch)].process(ratio,
+                                                                          pending.getReadPointer(ch),
+                                                                          output.getWritePointer(ch),
+                                                                          numOut);
+
+                used = juce::jlimit(0, pendingSamples, used);
+                const int remaining = pendingSamples - used;
+                for (int ch = 0; ch < pending.getNumChannels(); ++ch)
+                {
+                    auto* data = pending.getWritePointer(ch);
+                    std::memmove(data, data + used, static_cast<size_t>(remaining) * sizeof(float));
+                }
+                pendingSamples = remaining;
+
+                int start = juce::jmin(numOut, samplesToSkip);
+                samplesToSkip -= start;
+                // Never past the input's duration; rounding may leave a sample for the flush.
+                const int produced = static_cast<int>(juce::jlimit<std::int64_t>(0, numOut - start, target - outputTotal));
+                if (start > 0 && produced > 0)
+                    for (int ch = 0; ch < output.getNumChannels(); ++ch)
+                    {
+                        auto* data = output.getWritePointer(ch);
+                        std::memmove(data, data + start, static_cast<size_t>(produced) * sizeof(float));
+                    }
+                outputTotal += produced;
+                return produced;
+            }
+
+            const double ratio; // input samples per output sample
+            std::vector<juce::WindowedSincInterpolator> interpolators;
+            std::vector<std::array<juce::IIRFilter, 2>> antiAlias;
+            juce::AudioBuffer<float> pending;
+            juce::AudioBuffer<float> output;
+            int pendingSamples = 0;
+            int samplesToSkip = 0;
+            int flushPadding = 0;
+            std::int64_t inputTotal = 0;
+            std::int64_t outputTotal = 0;
+        };
+    }
+
+    class ExportSinkPipeline::Sink final : public juce::Thread
+    {
+    public:
+        Sink(ExportSinkPipeline& ownerRef,
+             const juce::String& sinkName,
+             std::unique_ptr<juce::AudioFormatWriter> writerToUse,
+             int targetBitDepth,
+             bool shouldDither,
+             std::uint32_t ditherSeed,
+             BlockTap blockTap)
+            : juce::Thread("Sampledex Export Encoder"),
+              owner(ownerRef),
+              name(sinkName),
+              writer(std::move(writerToUse)),
+              bitDepth(targetBitDepth),
+              dither(shouldDither && targetBitDepth < 24),
+              ditherState(ditherSeed),
+              tap(std::move(blockTap))
+        {
+            const double outputRate = writer->getSampleRate();
+            if (outputRate > 0.0 && std::abs(outputRate - owner.renderSampleRate) > 0.5)
+                resampler = std::make_unique<StreamResampler>(owner.channelCount, owner.renderSampleRate, outputRate, owner.blockSize);
+            if (dither && resampler == nullptr)
+                stage.setSize(owner.channelCount, owner.blockSize, false, true, false);
+        }
+
+        ~Sink() override
+        {
+            stopThread(10000);
+        }
+
+        void run() override
+        {
+            std::int64_t next = 0;
+            while (!threadShouldExit() && !owner.cancelled.load(std::memory_order_acquire))
+            {
+                const auto available = owner.blocksPushed.load(std::memory_order_acquire);
+                if (next < available)
+                {
+                    const auto slot = static_cast<size_t>(next % static_cast<std::int64_t>(owner.slots.size()));
+                    const bool ok = encode(owner.slots[slot], owner.slotSamples[slot]);
+                    consumedBlocks.store(ok ? ++next : std::numeric_limits<std::int64_t>::max(), std::memory_order_release);
+                    owner.slotFreed.signal();
+                    if (!ok)
+                    {
+                        owner.failed.store(true, std::memory_order_release);
+                        break;
+                    }
+                    continue;
+                }
+
+                if (owner.inputFinished.load(std::memory_order_acquire))
+                {
+                    if (next == owner.blocksPushed.load(std::memory_order_acquire))
+                    {
+                        if (!flushResampler())
+                            owner.failed.store(true, std::memory_order_release);
+                        break;
+                    }
+                    continue;
+                }
+
+                dataReady.wait(20);
+            }
+
+            // Closing flushes the encoder and writes the header on this thread too.
+            writer.reset();
+            consumedBlocks.store(std::numeric_limits<std::int64_t>::max(), std::memory_order_release);
+            owner.slotFreed.signal();
+        }
+
+        std::atomic<std::int64_t> consumedBlocks { 0 };
+        juce::WaitableEvent dataReady;
+        juce::String error;
+
+    private:
+        // The slot is shared by every sink, so dither works on a private copy.
+        bool encode(const juce::AudioBuffer<float>& block, int numSamples)
+        {
+            if (tap)
+                tap(block, numSamples);
+            if (resampler != nullptr)
+                return writeStage(resampler->getOutput(), resampler->process(block, numSamples));
+            if (!dither)
+                return write(block, numSamples);
+
+            for (int ch = 0; ch < stage.getNumChannels(); ++ch)
+                stage.copyFrom(ch, 0, block, juce::jmin(ch, block.getNumChannels() - 1), 0, numSamples);
+            return writeStage(stage, numSamples);
+        }
+
+        bool flushResampler()
+        {
+            return resampler == nullptr || writeStage(resampler->getOutput(), resampler->flush());
+        }
+
+        bool writeStage(juce::AudioBuffer<float>& buffer, int numSamples)
+        {
+            if (dither && numSamples > 0)
+                applyTpdfDither(buffer, 0, numSamples, bitDepth, ditherState);
+            return write(buffer, numSamples);
+        }
+
+        bool write(const juce::AudioBuffer<float>& source, int numSamples)
+        {
+            if (numSamples <= 0 || writer->writeFromAudioSampleBuffer(source, 0, numSamples))
+                return true;
+            error = "Unable to write " + name + " (disk full or encoder error).";
+            return false;
+        }
+
+        ExportSinkPipeline& owner;
+        const juce::String name;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        const int bitDepth;
+        const bool dither;
+        std::uint32_t ditherState;
+        BlockTap tap;
+        std::unique_ptr<StreamResampler> resampler;
+        juce::AudioBuffer<float> stage;
+    };
+
+    ExportSinkPipeline::ExportSinkPipeline(double sampleRate, int maxBlockSize, int numChannels, int queueBlocks)
+        : renderSampleRate(sampleRate),
+          blockSize(juce::jmax(1, maxBlockSize)),
+          channelCount(juce::jmax(1, numChannels))
+    {
+        slots.resize(static_cast<size_t>(juce::jmax(2, queueBlocks)));
+        for (auto& slot : slots)
+            slot.setSize(channelCount, blockSize, false, true, false);
+        slotSamples.assign(slots.size(), 0);
+    }
+
+    ExportSinkPipeline::~ExportSinkPipeline()
+    {
+        if (started && !inputFinished.load(std::memory_order_acquire))
+            cancel();
+        sinks.clear();
+    }
+
+    void ExportSinkPipeline::addSink(const juce::String& name,
+                                     std::unique_ptr<juce::AudioFormatWriter> writer,
+                                     int bitDepth,
+                                     bool dither,
+                                     BlockTap tap)
+    {
+        jassert(!started);
+        if (writer == nullptr || started)
+            return;
+        const auto seed = defaultDitherSeed ^ static_cast<std::uint32_t>(sinks.size() * 0x9e3779b9u);
+        sinks.push_back(std::make_unique<Sink>(*this, name, std::move(writer), bitDepth, dither, seed, std::move(tap)));
+    }
+
+    void ExportSinkPipeline::start()
+    {
+        if (started)
+            return;
+        started = true;
+        for (auto& sink : sinks)
+            sink->startThread(juce::Thread::Priority::normal);
+    }
+
+    std::int64_t ExportSinkPipeline::getSlowestSinkBlock() const noexcept
+    {
+        auto slowest = std::numeric_limits<std::int64_t>::max();
+        for (const auto& sink : sinks)
+            slowest = juce::jmin(slowest, sink->consumedBlocks.load(std::memory_order_acquire));
+        return slowest;
+    }
+
+    void ExportSinkPipeline::wakeSinks() noexcept
+    {
+        for (auto& sink : sinks)
+            sink->dataReady.signal();
+    }
+
+    bool ExportSinkPipeline::push(const juce::AudioBuffer<float>& block, int numSamples)
+    {
+        jassert(started);
+        const auto slotCount = static_cast<std::int64_t>(slots.size());
+        for (int offset = 0; offset < numSamples; offset += blockSize)
+        {
+            const int chunk = juce::jmin(blockSize, numSamples - offset);
+            const auto sequence = blocksPushed.load(std::memory_order_relaxed);
+            if (sequence - getSlowestSinkBlock() >= slotCount)
+            {
+                const auto waitStartMs = juce::Time::getMillisecondCounterHiRes();
+                while (sequence - getSlowestSinkBlock() >= slotCount)
+                {
+                    if (failed.load(std::memory_order_acquire) || cancelled.load(std::memory_order_acquire))
+                        return false;
+                    slotFreed.wait(20);
+                }
+                renderWaitSeconds += (juce::Time::getMillisecondCounterHiRes() - waitStartMs) * 0.001;
+            }
+
+            auto& slot = slots[static_cast<size_t>(sequence % slotCount)];
+            for (int ch = 0; ch < channelCount; ++ch)
+                slot.copyFrom(ch, 0, block, juce::jmin(ch, block.getNumChannels() - 1), offset, chunk);
+            slotSamples[static_cast<size_t>(sequence % slotCount)] = chunk;
+            blocksPushed.store(sequence + 1, std::memory_order_release);
+            wakeSinks();
+        }
+
+        return !failed.load(std::memory_order_acquire) && !cancelled.load(std::memory_order_acquire);
+    }
+
+    bool ExportSinkPipeline::finish()
+    {
+        inputFinished.store(true, std::memory_order_release);
+        wakeSinks();
+        for (auto& sink : sinks)
+            sink->waitForThreadToExit(-1);
+        return !failed.load(std::memory_order_acquire) && !cancelled.load(std::memory_order_acquire);
+    }
+
+    void ExportSinkPipeline::cancel() noexcept
+    {
+        cancelled.store(true, std::memory_order_release);
+        wakeSinks();
+        slotFreed.signal();
+    }
+
+    juce::String ExportSinkPipeline::getError() const
+    {
+        for (const auto& sink : sinks)
+            if (!sink->isThreadRunning() && sink->error.isNotEmpty())
+                return sink->error;
+        return failed.load(std::memory_order_acquire) ? juce::String("Export encoder failed.") : juce::String();
+    }
+
+    void ExportSinkPipeline::applyTpdfDither(juce::AudioBuffer<float>& buffer,
+                                             int startSample,
+                                             int numSamples,
+                                             int bitDepth,
+                                             std::uint32_t& rngState) noexcept
+    {
+        if (bitDepth <= 0 || bitDepth >= 24)
+            return;
+
+        const float scale = static_cast<float>(1u << juce::jmax(1, bitDepth - 1));
+        const float invScale = 1.0f / scale;
+        const float lsb = invScale;
+        constexpr float invUint = 1.0f / 4294967295.0f;
+        const int channels = buffer.getNumChannels();
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            auto* write = buffer.getWritePointer(ch, startSample);
+            if (write == nullptr)
+                continue;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float r1 = static_cast<float>(nextDitherState(rngState)) * invUint;
+                const float r2 = static_cast<float>(nextDitherState(rngState)) * invUint;
+                const float dither = (r1 - r2) * lsb;
+                const float withDither = juce::jlimit(-1.0f, 1.0f, write[i] + dither);
+                write[i] = std::round(withDither * scale) * invScale;
+            }
+        }
+    }
+}
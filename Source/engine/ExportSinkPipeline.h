@@ -0,0 +1,104 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace sampledex
+{
+    // Moves encoding off the render thread. The renderer pushes float blocks into a
+    // bounded ring and each sink (one output file) runs on its own encoder thread with
+    // its own sample-rate conversion, dither and bit depth, so one render can feed
+    // several deliverables at once and disk writes overlap the next blocks' rendering.
+    // When every slot is still being encoded, push() waits for the slowest sink.
+    class ExportSinkPipeline final
+    {
+    public:
+        static constexpr int defaultQueueBlocks = 32;
+        static constexpr std::uint32_t defaultDitherSeed = 0x51ed270bu;
+
+        // One deliverable of a multi-format export. sampleRate 0 = the render rate;
+        // bitDepth 32 is float where the format has it.
+        struct Deliverable
+        {
+            juce::String extension;
+            double sampleRate = 0.0;
+            int bitDepth = 24;
+            bool dither = true;
+            juce::String fileSuffix; // appended to the file name, e.g. " (16-bit 44.1k)"
+        };
+
+        ExportSinkPipeline(double renderSampleRate,
+                           int maxBlockSize,
+                           int numChannels = 2,
+                           int queueBlocks = defaultQueueBlocks);
+        ~ExportSinkPipeline();
+
+        // Encoder thread: sees each rendered block before the sink converts it.
+        using BlockTap = std::function<void(const juce::AudioBuffer<float>& block, int numSamples)>;
+
+        // Before start(). The writer's sample rate sets the sink's output rate (resampled
+        // from the render rate when they differ); TPDF dither applies below 24 bits.
+        void addSink(const juce::String& name,
+                     std::unique_ptr<juce::AudioFormatWriter> writer,
+                     int bitDepth,
+                     bool dither,
+                     BlockTap tap = {});
+        int getNumSinks() const noexcept { return static_cast<int>(sinks.size()); }
+
+        void start();
+
+        // Render thread. Returns false once a sink has failed or the pipeline was cancelled.
+        bool push(const juce::AudioBuffer<float>& block, int numSamples);
+
+        // Render thread: lets every sink drain, flush and close its file. Returns false
+        // when any sink failed; getError() names the first.
+        bool finish();
+
+        // Any thread. Encoders stop without draining; their files are closed as they are.
+        void cancel() noexcept;
+
+        juce::String getError() const;
+        // How long push() has waited on encoders; near zero means encoding kept up.
+        double getRenderWaitSeconds() const noexcept { return renderWaitSeconds; }
+
+        static std::uint32_t nextDitherState(std::uint32_t& state) noexcept
+        {
+            state = (state * 1664525u) + 1013904223u;
+            return state;
+        }
+
+        // Quantises to bitDepth with triangular dither. No-op at 24 bits and above.
+        static void applyTpdfDither(juce::AudioBuffer<float>& buffer,
+                                    int startSample,
+                                    int numSamples,
+                                    int bitDepth,
+                                    std::uint32_t& rngState) noexcept;
+
+    private:
+        class Sink;
+
+        std::int64_t getSlowestSinkBlock() const noexcept;
+        void wakeSinks() noexcept;
+
+        const double renderSampleRate;
+        const int blockSize;
+        const int channelCount;
+        std::vector<juce::AudioBuffer<float>> slots;
+        std::vector<int> slotSamples;
+        std::vector<std::unique_ptr<Sink>> sinks;
+
+        std::atomic<std::int64_t> blocksPushed { 0 };
+        std::atomic<bool> inputFinished { false };
+        std::atomic<bool> cancelled { false };
+        std::atomic<bool> failed { false };
+        juce::WaitableEvent slotFreed;
+        bool started = false;
+        double renderWaitSeconds = 0.0;
+
+        JUCE_DECLARE_NON_COPYABLE(ExportSinkPipeline)
+    };
+}
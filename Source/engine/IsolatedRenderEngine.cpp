@@ -0,0 +1,642 @@
+#include "IsolatedRenderEngine.h"
+
+#include "RealtimeSafetyMonitor.h"
+
+#include <cmath>
+#include <limits>
+
+namespace sampledex
+{
+    namespace
+    {
+        // The render thread takes a track itself, so a graph gains nothing from more
+        // workers than it has other tracks. Keeps parallel freezes of single tracks from
+        // each widening a scheduler to every core.
+        OfflineRenderSettings limitWorkersToGraph(OfflineRenderSettings settings, std::size_t trackCount)
+        {
+            const int usefulWorkers = juce::jmax(0, static_cast<int>(juce::jmin<std::size_t>(trackCount, IsolatedRenderEngine::maxTracks)) - 1);
+            settings.workerLimit = settings.workerLimit >= 0 ? juce::jmin(settings.workerLimit, usefulWorkers) : usefulWorkers;
+            return settings;
+        }
+    }
+
+    IsolatedRenderEngine::IsolatedRenderEngine(std::unique_ptr<IsolatedRenderProject> projectToRender,
+                                               juce::AudioFormatManager& audioFormats,
+                                               const OfflineRenderSettings& settings)
+        : project(projectToRender != nullptr ? std::move(projectToRender) : std::make_unique<IsolatedRenderProject>()),
+          audioFormatManager(audioFormats),
+          renderSettings(limitWorkersToGraph(settings, project->tracks.size())),
+          blockSize(settings.getResolvedBlockSize())
+    {
+        pdcFn = [this](int trackIndex,
+                       int mainDelaySamples,
+                       int sendDelaySamples,
+                       int blockSamples,
+                       juce::AudioBuffer<float>& mainBuffer,
+                       juce::AudioBuffer<float>& sendBuffer)
+        {
+            applyDelayCompensation(trackIndex, mainDelaySamples, sendDelaySamples, blockSamples, mainBuffer, sendBuffer);
+        };
+
+        for (auto& track : project->tracks)
+            if (track != nullptr)
+                track->setTransportPlayHead(&transport);
+    }
+
+    IsolatedRenderEngine::~IsolatedRenderEngine()
+    {
+        for (auto& track : project->tracks)
+        {
+            if (track != nullptr)
+            {
+                track->releaseResources();
+                track->setTransportPlayHead(nullptr);
+            }
+        }
+    }
+
+    Track* IsolatedRenderEngine::getTrack(int index) const noexcept
+    {
+        return juce::isPositiveAndBelow(index, getNumTracks()) ? project->tracks[static_cast<size_t>(index)].get() : nullptr;
+    }
+
+    void IsolatedRenderEngine::prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+        masterGainDezipperCoeff = static_cast<float>(1.0 - std::exp(-1.0 / (sampleRate * 0.005)));
+        transport.prepare(sampleRate);
+        transport.setLoop(false, 0.0, 4.0);
+        constantTempoMap.setConstantTempo(juce::jmax(1.0, project->fallbackBpm));
+        tempoMap = project->tempoMap.isEmpty() ? &constantTempoMap : &project->tempoMap;
+
+        const int trackCount = getNumTracks();
+        for (int i = 0; i < trackCount; ++i)
+            if (auto* track = getTrack(i))
+                track->prepareToPlay(sampleRate, blockSize);
+
+        mainBuffers.assign(static_cast<size_t>(trackCount), juce::AudioBuffer<float>(2, blockSize));
+        sendBuffers.assign(static_cast<size_t>(trackCount), juce::AudioBuffer<float>(2, blockSize));
+        timelineBuffers.assign(static_cast<size_t>(trackCount), juce::AudioBuffer<float>(2, blockSize));
+        pdcScratchBuffers.assign(static_cast<size_t>(trackCount), juce::AudioBuffer<float>(4, blockSize));
+        pdcDelayBuffers.assign(static_cast<size_t>(trackCount), juce::AudioBuffer<float>());
+        pdcWritePositions.assign(static_cast<size_t>(trackCount), 0);
+        pdcBufferSamples = 0;
+        midiBuffers.resize(static_cast<size_t>(trackCount));
+        for (auto& midi : midiBuffers)
+            midi.ensureSize(static_cast<size_t>(Track::getMidiArenaCapacityBytesForBlock(blockSize)));
+        for (auto& bus : auxBusBuffers)
+            bus.setSize(2, blockSize);
+        for (auto& reverb : auxReverbs)
+        {
+            reverb.setParameters(project->auxReverbParameters);
+            reverb.setSampleRate(sampleRate);
+        }
+        mixBuffer.setSize(2, blockSize);
+        streamScratch.setSize(8, blockSize * 16);
+        masterGainValues.setSize(1, blockSize);
+        masterLimiter.prepare(sampleRate, blockSize);
+        laneCursors.assign(project->automationLanes.size(), AutomationLaneCursor());
+
+        // Streamed clips get their own readers: the live engine's buffering readers are
+        // shared with the device callback.
+        clipFiles.assign(project->arrangement.size(), nullptr);
+        for (size_t clipIndex = 0; clipIndex < project->arrangement.size(); ++clipIndex)
+        {
+            auto& clip = project->arrangement[clipIndex];
+            if (clip.type != ClipType::Audio || clip.audioData != nullptr || clip.audioFilePath.isEmpty())
+                continue;
+
+            auto& file = clipFilesByPath[clip.audioFilePath];
+            if (file == nullptr)
+            {
+                std::unique_ptr<juce::AudioFormatReader> reader(audioFormatManager.createReaderFor(juce::File(clip.audioFilePath)));
+                if (reader == nullptr || reader->numChannels <= 0 || reader->lengthInSamples <= 0)
+                    continue;
+
+                file = std::make_unique<ClipFile>();
+                file->info.numSamples = reader->lengthInSamples;
+                file->info.numChannels = static_cast<int>(reader->numChannels);
+                file->info.sampleRate = juce::jmax(1.0, reader->sampleRate);
+                file->reader = std::move(reader);
+            }
+
+            clipFiles[clipIndex] = file.get();
+            if (clip.audioSampleRate <= 1.0)
+                clip.audioSampleRate = file->info.sampleRate;
+        }
+    }
+
+    std::int64_t IsolatedRenderEngine::getPassLengthSamples(const Pass& pass) const noexcept
+    {
+        if (pass.endBeat <= pass.startBeat)
+            return 0;
+        const double contentSeconds = tempoMap->secondsAtBeat(pass.endBeat) - tempoMap->secondsAtBeat(pass.startBeat);
+        return static_cast<std::int64_t>(std::ceil((contentSeconds + juce::jmax(0.0, pass.tailSeconds)) * sampleRate));
+    }
+
+    void IsolatedRenderEngine::beginPass(const Pass& pass)
+    {
+        const int trackCount = getNumTracks();
+        // Later passes start from silence like the first: no reverb or delay tails, no
+        // held voices from the previous pass.
+        if (passesRendered > 0)
+        {
+            for (int i = 0; i < trackCount; ++i)
+                if (auto* track = getTrack(i))
+                    track->prepareToPlay(sampleRate, blockSize);
+            for (auto& reverb : auxReverbs)
+                reverb.reset();
+        }
+        for (int i = 0; i < trackCount; ++i)
+        {
+            if (auto* track = getTrack(i))
+            {
+                track->setPluginsNonRealtime(true);
+                track->panic();
+            }
+        }
+        panicPending = true;
+
+        // Aux strips take their input from their send bus; their insert latency delays
+        // everything feeding that bus.
+        auxBusLatencySamples.fill(0);
+        int maxTrackLatency = 0;
+        for (int i = 0; i < trackCount; ++i)
+        {
+            auto* track = getTrack(i);
+            if (track == nullptr)
+                continue;
+            maxTrackLatency = juce::jmax(maxTrackLatency, track->getTotalPluginLatencySamples());
+            if (track->getChannelType() != Track::ChannelType::Aux)
+                continue;
+            const int bus = juce::jlimit(0, auxBusCount - 1, track->getSendTargetBus());
+            auto& latency = auxBusLatencySamples[static_cast<size_t>(bus)];
+            latency = juce::jmax(latency, juce::jmax(0, track->getInsertPluginLatencySamples()));
+        }
+
+        int maxAuxLatency = 0;
+        for (const int latency : auxBusLatencySamples)
+            maxAuxLatency = juce::jmax(maxAuxLatency, latency);
+        const int requiredPdcSamples = juce::jlimit(2048, 262144, maxTrackLatency + maxAuxLatency + blockSize + 128);
+        if (requiredPdcSamples > pdcBufferSamples)
+        {
+            for (auto& delayBuffer : pdcDelayBuffers)
+                delayBuffer.setSize(4, requiredPdcSamples);
+            pdcBufferSamples = requiredPdcSamples;
+        }
+        for (auto& delayBuffer : pdcDelayBuffers)
+            delayBuffer.clear();
+        std::fill(pdcWritePositions.begin(), pdcWritePositions.end(), 0);
+
+        for (auto& cursor : laneCursors)
+            cursor.reset();
+        masterAutomationRamp.clear();
+        includeMasterProcessing = pass.includeMasterProcessing;
+        masterGainTarget = includeMasterProcessing ? project->masterGain : 1.0f;
+        masterLimiter.reset();
+        masterLimiter.setCurrentGain(masterGainTarget);
+        outputBoundaryPrevSample = { 0.0f, 0.0f };
+
+        stemCapture = pass.stemCapture;
+        if (stemCapture != nullptr)
+            stemCapture->prepare(blockSize);
+
+        firstBlockOfPass = true;
+        transport.stop();
+        transport.setLoop(false, pass.startBeat, pass.endBeat);
+        transport.setPosition(pass.startBeat);
+        transport.play();
+    }
+
+    bool IsolatedRenderEngine::renderPass(const Pass& pass,
+                                          const OfflineRenderEngine::BlockFn& consumeBlock,
+                                          std::atomic<bool>* cancelFlag,
+                                          const OfflineRenderEngine::ProgressFn& progressCallback)
+    {
+        lastProgress = {};
+        const auto totalSamples = getPassLengthSamples(pass);
+        if (totalSamples <= 0 || getNumTracks() <= 0)
+            return false;
+
+        beginPass(pass);
+        OfflineRenderEngine renderEngine(scheduler, renderSettings);
+        lastWorkerCount = renderEngine.getWorkerCount();
+
+        // An enabled master limiter delays the mix by its lookahead: render that much past
+        // the end and drop it from the start, so the file lines up with the timeline. Stem
+        // passes tap before the master and do not use its output.
+        const bool limiterEnabled = includeMasterProcessing && project->limiterEnabled;
+        const int masterLatencySamples = pass.stemCapture == nullptr ? masterLimiter.getLatencySamples(limiterEnabled) : 0;
+        int masterSamplesToSkip = masterLatencySamples;
+
+        std::int64_t silenceCheckStart = std::numeric_limits<std::int64_t>::max();
+        if (pass.endTailOnSilence)
+        {
+            double reportedTailSeconds = 0.0;
+            for (int i = 0; i < getNumTracks(); ++i)
+                if (auto* track = getTrack(i))
+                    reportedTailSeconds = juce::jmax(reportedTailSeconds, track->getPluginChainTailSeconds());
+
+            auto content = pass;
+            content.tailSeconds = 0.0;
+            silenceCheckStart = getPassLengthSamples(content) + masterLatencySamples
+                              + static_cast<std::int64_t>(std::ceil(juce::jlimit(0.0, juce::jmax(0.0, pass.tailSeconds), reportedTailSeconds) * sampleRate));
+        }
+        const int silenceHoldSamples = static_cast<int>(Track::sleepSilenceHoldSeconds * sampleRate);
+        std::int64_t samplesSeen = 0;
+        int silentSamples = 0;
+        bool tailEnded = false;
+        const bool rendered = renderEngine.render(
+            totalSamples + masterLatencySamples,
+            sampleRate,
+            2,
+            [this](juce::AudioBuffer<float>& block, int numSamples)
+            {
+                // Offline there is no deadline; plugins in non-realtime mode may allocate.
+                RealtimeSafetyMonitor::ScopedSuspend offlineScope;
+                renderBlock(block, numSamples);
+                return true;
+            },
+            [&](juce::AudioBuffer<float>& block, int numSamples)
+            {
+                if (samplesSeen >= silenceCheckStart)
+                {
+                    silentSamples = isPassOutputSilent(block, numSamples) ? silentSamples + numSamples : 0;
+                    if (silentSamples >= silenceHoldSamples)
+                    {
+                        tailEnded = true;
+                        return false;
+                    }
+                }
+                samplesSeen += numSamples;
+
+                const int skip = juce::jmin(masterSamplesToSkip, numSamples);
+                masterSamplesToSkip -= skip;
+                if (!consumeBlock || skip == numSamples)
+                    return true;
+                if (skip == 0)
+                    return consumeBlock(block, numSamples);
+                juce::AudioBuffer<float> trimmed(block.getArrayOfWritePointers(), block.getNumChannels(), skip, numSamples - skip);
+                return consumeBlock(trimmed, numSamples - skip);
+            },
+            cancelFlag,
+            progressCallback) || tailEnded;
+
+        transport.stop();
+        stemCapture = nullptr;
+        for (int i = 0; i < getNumTracks(); ++i)
+            if (auto* track = getTrack(i))
+                track->setPluginsNonRealtime(false);
+        lastProgress = renderEngine.getLastProgress();
+        ++passesRendered;
+        return rendered;
+    }
+
+    void IsolatedRenderEngine::renderBlock(juce::AudioBuffer<float>& output, int numSamples)
+    {
+        juce::ScopedNoDenormals noDenormals;
+        output.clear(0, numSamples);
+        const int trackCount = getNumTracks();
+        if (numSamples <= 0 || numSamples > blockSize || trackCount <= 0)
+            return;
+
+        const auto blockRange = transport.advanceWithTempoMap(numSamples, *tempoMap);
+        const double startBeat = blockRange.startBeat;
+        const double endBeat = blockRange.endBeat;
+        TempoBlockSpan blockSpan;
+        blockSpan.set(*tempoMap, sampleRate, numSamples, startBeat, false, 0.0, 0.0);
+        applyAutomation(blockSpan);
+
+        for (auto& bus : auxBusBuffers)
+            bus.clear(0, numSamples);
+        for (int i = 0; i < trackCount; ++i)
+        {
+            midiBuffers[static_cast<size_t>(i)].clear();
+            timelineBuffers[static_cast<size_t>(i)].clear(0, numSamples);
+        }
+
+        if (panicPending)
+        {
+            panicPending = false;
+            for (auto& panicBuffer : midiBuffers)
+            {
+                for (int ch = 1; ch <= 16; ++ch)
+                {
+                    panicBuffer.addEvent(juce::MidiMessage::controllerEvent(ch, 64, 0), 0);
+                    panicBuffer.addEvent(juce::MidiMessage::allNotesOff(ch), 0);
+                    panicBuffer.addEvent(juce::MidiMessage::allSoundOff(ch), 0);
+                }
+            }
+        }
+
+        bool anySolo = false;
+        for (int i = 0; i < trackCount && !anySolo; ++i)
+            anySolo = getTrack(i) != nullptr && getTrack(i)->isSolo();
+
+        const auto trackIsAudible = [&](int trackIndex)
+        {
+            auto* track = getTrack(trackIndex);
+            if (track == nullptr || track->isMuted())
+                return false;
+            return !anySolo || track->isSolo();
+        };
+
+        // Sequencer MIDI and clip audio.
+        const double bpmValue = tempoMap->getTempoAtBeat(startBeat);
+        const int globalTranspose = juce::jlimit(-48, 48, project->globalTransposeSemitones);
+        const int lastBlockSample = juce::jmax(0, numSamples - 1);
+        const auto blockSampleForBeat = [&](double beat)
+        {
+            return juce::jlimit(0, lastBlockSample, static_cast<int>(std::llround(blockSpan.sampleOffsetForBeat(beat))));
+        };
+
+        for (size_t clipIndex = 0; clipIndex < project->arrangement.size(); ++clipIndex)
+        {
+            const auto& clip = project->arrangement[clipIndex];
+            if (!juce::isPositiveAndBelow(clip.trackIndex, trackCount))
+                continue;
+
+            const auto trackBufferIndex = static_cast<size_t>(clip.trackIndex);
+            if (clip.type == ClipType::MIDI)
+            {
+                clip.getEventsInRangeMapped(startBeat,
+                                            endBeat,
+                                            midiBuffers[trackBufferIndex],
+                                            blockSampleForBeat,
+                                            firstBlockOfPass,
+                                            1,
+                                            globalTranspose);
+                continue;
+            }
+
+            auto* file = clipFiles[clipIndex];
+            if ((file == nullptr && clip.audioData == nullptr) || !trackIsAudible(clip.trackIndex))
+                continue;
+
+            AudioClipRenderer::renderSegment(clip,
+                                             file != nullptr ? &file->info : nullptr,
+                                             [file](juce::AudioBuffer<float>& window, std::int64_t windowStart, int windowLength)
+                                             {
+                                                 window.clear();
+                                                 return file->reader->read(&window, 0, windowLength, windowStart, true, true);
+                                             },
+                                             *tempoMap,
+                                             blockSpan,
+                                             startBeat,
+                                             endBeat,
+                                             numSamples,
+                                             sampleRate,
+                                             bpmValue,
+                                             AudioClipRenderer::StretchQuality::High,
+                                             streamScratch,
+                                             timelineBuffers[trackBufferIndex]);
+        }
+
+        // Delay compensation paths, as in the device callback.
+        int maxGraphLatencySamples = 0;
+        for (int i = 0; i < trackCount; ++i)
+        {
+            auto* track = getTrack(i);
+            if (track == nullptr)
+                continue;
+
+            const int trackLatency = juce::jmax(0, track->getTotalPluginLatencySamples());
+            const int sendBusIndex = juce::jlimit(0, auxBusCount - 1, track->getSendTargetBus());
+            const bool outputToBus = track->getOutputTargetType() == Track::OutputTargetType::Bus;
+            const int outputBusIndex = juce::jlimit(0, auxBusCount - 1, track->getOutputTargetBus());
+            const int mainPathLatency = trackLatency + (outputToBus ? auxBusLatencySamples[static_cast<size_t>(outputBusIndex)] : 0);
+            trackMainPathLatencySamples[static_cast<size_t>(i)] = mainPathLatency;
+            maxGraphLatencySamples = juce::jmax(maxGraphLatencySamples, mainPathLatency);
+
+            const bool sendActive = track->getSendLevel() > 0.0001f;
+            const bool sendFeedbackBlocked = outputToBus && sendBusIndex == outputBusIndex && sendActive;
+            trackSendBusIndex[static_cast<size_t>(i)] = sendBusIndex;
+            trackOutputToBus[static_cast<size_t>(i)] = outputToBus;
+            trackOutputBusIndex[static_cast<size_t>(i)] = outputBusIndex;
+            trackSendFeedbackBlocked[static_cast<size_t>(i)] = sendFeedbackBlocked;
+            trackSendPathActive[static_cast<size_t>(i)] = sendActive && !sendFeedbackBlocked;
+            if (sendActive && !sendFeedbackBlocked)
+            {
+                const int sendPathLatency = trackLatency + auxBusLatencySamples[static_cast<size_t>(sendBusIndex)];
+                trackSendPathLatencySamples[static_cast<size_t>(i)] = sendPathLatency;
+                maxGraphLatencySamples = juce::jmax(maxGraphLatencySamples, sendPathLatency);
+            }
+            else
+            {
+                trackSendPathLatencySamples[static_cast<size_t>(i)] = mainPathLatency;
+            }
+        }
+
+        const bool tapPluginChains = stemCapture != nullptr
+                                  && stemCapture->getTapPoint() == OfflineStemCapture::TapPoint::PluginChain;
+        if (stemCapture != nullptr)
+            stemCapture->beginBlock(numSamples);
+
+        for (int i = 0; i < trackCount; ++i)
+        {
+            auto& job = jobs[static_cast<size_t>(i)];
+            job.track = getTrack(i);
+            job.mainBuffer = &mainBuffers[static_cast<size_t>(i)];
+            job.sourceAudio = &timelineBuffers[static_cast<size_t>(i)];
+            job.sendBuffer = &sendBuffers[static_cast<size_t>(i)];
+            job.midi = &midiBuffers[static_cast<size_t>(i)];
+            job.monitorInput = nullptr;
+            job.blockSamples = numSamples;
+            job.monitorSafeInput = project->monitorSafeMode;
+            job.offlineRender = true;
+            job.chainOutputTap = tapPluginChains ? stemCapture->getTrackBuffer(i) : nullptr;
+            job.processTrack = job.track != nullptr && trackIsAudible(i);
+            trackGraphAudible[static_cast<size_t>(i)] = job.processTrack;
+            trackMonitorInputUsed[static_cast<size_t>(i)] = false;
+        }
+
+        TransportBlockContext context;
+        context.numSamples = numSamples;
+        context.sampleRate = sampleRate;
+        context.offlineRenderActive = true;
+
+        RealtimeMixInputs mixInputs;
+        mixInputs.activeTrackCount = trackCount;
+        mixInputs.pdcReady = pdcBufferSamples >= maxGraphLatencySamples + numSamples + 8;
+        mixInputs.trackGraphAudible = &trackGraphAudible;
+        mixInputs.trackMonitorInputUsed = &trackMonitorInputUsed;
+        mixInputs.trackSendFeedbackBlocked = &trackSendFeedbackBlocked;
+        mixInputs.trackOutputToBus = &trackOutputToBus;
+        mixInputs.trackSendBusIndex = &trackSendBusIndex;
+        mixInputs.trackOutputBusIndex = &trackOutputBusIndex;
+        mixInputs.trackMainPathLatencySamples = &trackMainPathLatencySamples;
+        mixInputs.trackSendPathLatencySamples = &trackSendPathLatencySamples;
+        mixInputs.trackSendPathActive = &trackSendPathActive;
+        mixInputs.maxGraphLatencySamples = maxGraphLatencySamples;
+
+        mixBuffer.clear(0, numSamples);
+        RealtimeAudioEngine::runTrackGraph(scheduler, context, mixInputs, jobs, mixBuffer, auxBusBuffers, pdcFn);
+
+        if (stemCapture != nullptr && !tapPluginChains)
+        {
+            for (int i = 0; i < trackCount; ++i)
+                if (jobs[static_cast<size_t>(i)].processTrack)
+                    stemCapture->captureTrack(i, mainBuffers[static_cast<size_t>(i)], numSamples);
+        }
+
+        RealtimeAuxReturnSettings auxReturnSettings;
+        auxReturnSettings.fxEnabled = project->auxFxEnabled;
+        auxReturnSettings.returnGain = project->auxReturnGain;
+        auxReturnSettings.monitorSafe = project->monitorSafeMode;
+        RealtimeAudioEngine::processAuxReturns(context, auxReturnSettings, auxBusBuffers, auxReverbs, nullptr);
+        if (stemCapture != nullptr)
+            for (int bus = 0; bus < auxBusCount; ++bus)
+                stemCapture->captureBus(bus, auxBusBuffers[static_cast<size_t>(bus)], numSamples);
+
+        // The same sum, fades and master chain as the device callback; a pass fades in
+        // from its start like a transport start.
+        RealtimeOutputStage outputStage;
+        outputStage.fadeInAtStart = firstBlockOfPass;
+        outputStage.monitorSafe = project->monitorSafeMode;
+
+        RealtimeMixInputs outputMixInputs;
+        outputMixInputs.targetMasterGain = masterGainTarget;
+        outputMixInputs.useSoftClip = includeMasterProcessing && project->softClipEnabled;
+        outputMixInputs.limiterEnabled = includeMasterProcessing && project->limiterEnabled;
+        outputMixInputs.masterGainDezipperCoeff = masterGainDezipperCoeff;
+        outputMixInputs.outputDcHighPassEnabled = project->outputDcHighPassEnabled;
+        if (masterAutomationRamp.isActive())
+        {
+            masterAutomationRamp.fillValues(masterGainValues.getWritePointer(0), numSamples);
+            outputMixInputs.masterGainValues = masterGainValues.getReadPointer(0);
+        }
+
+        RealtimeMixOutputs outputMixOutputs;
+        RealtimeAudioEngine::renderOutputStage(context,
+                                               outputStage,
+                                               outputMixInputs,
+                                               mixBuffer,
+                                               auxBusBuffers,
+                                               output,
+                                               0,
+                                               outputBoundaryPrevSample,
+                                               masterLimiter,
+                                               outputMixOutputs);
+        firstBlockOfPass = false;
+    }
+
+    bool IsolatedRenderEngine::isPassOutputSilent(const juce::AudioBuffer<float>& block, int numSamples)
+    {
+        if (stemCapture == nullptr)
+            return block.getMagnitude(0, numSamples) < Track::sleepSilenceThreshold;
+
+        for (int i = 0; i < getNumTracks(); ++i)
+            if (auto* tapped = stemCapture->getTrackBuffer(i))
+                if (tapped->getMagnitude(0, juce::jmin(numSamples, tapped->getNumSamples())) >= Track::sleepSilenceThreshold)
+                    return false;
+        return true;
+    }
+
+    void IsolatedRenderEngine::applyAutomation(const TempoBlockSpan& blockSpan)
+    {
+        for (auto& track : project->tracks)
+            if (track != nullptr)
+                track->clearBlockAutomationRamps();
+        masterAutomationRamp.clear();
+
+        const auto buildRamp = [&](const AutomationLane& lane,
+                                   AutomationLaneCursor& cursor,
+                                   AutomationBlockRamp& ramp,
+                                   float minValue,
+                                   float maxValue)
+        {
+            ramp.reset(minValue, maxValue);
+            blockSpan.forEachConstantTempoRun([&](double runStartBeat, double beatsPerSample, int sampleOffset, int runSamples)
+            {
+                ramp.append(lane.points, cursor, runStartBeat, beatsPerSample, sampleOffset, runSamples);
+            });
+            return ramp.getEndValue();
+        };
+
+        // Nobody touches a control during a render: Read, Touch and Latch lanes play
+        // back; Write lanes keep the value the snapshot was taken with.
+        for (size_t laneIndex = 0; laneIndex < project->automationLanes.size(); ++laneIndex)
+        {
+            const auto& lane = project->automationLanes[laneIndex];
+            if (!lane.enabled || lane.points.empty() || lane.mode == AutomationMode::Write)
+                continue;
+
+            auto& cursor = laneCursors[laneIndex];
+            if (lane.target == AutomationTarget::MasterOutput)
+            {
+                if (includeMasterProcessing)
+                    masterGainTarget = buildRamp(lane, cursor, masterAutomationRamp, 0.0f, 1.4f);
+                continue;
+            }
+
+            auto* track = getTrack(lane.trackIndex);
+            if (track == nullptr)
+                continue;
+
+            auto& ramp = track->getBlockAutomationRamp(lane.target);
+            switch (lane.target)
+            {
+                case AutomationTarget::TrackPan:
+                    track->setPan(buildRamp(lane, cursor, ramp, -1.0f, 1.0f));
+                    break;
+                case AutomationTarget::TrackSend:
+                    track->setSendLevel(buildRamp(lane, cursor, ramp, 0.0f, 1.0f));
+                    break;
+                case AutomationTarget::MasterOutput:
+                case AutomationTarget::TrackVolume:
+                default:
+                    track->setVolume(buildRamp(lane, cursor, ramp, 0.0f, 1.2f));
+                    break;
+            }
+        }
+    }
+
+    void IsolatedRenderEngine::applyDelayCompensation(int trackIndex,
+                                                      int mainDelaySamples,
+                                                      int sendDelaySamples,
+                                                      int blockSamples,
+                                                      juce::AudioBuffer<float>& mainBuffer,
+                                                      juce::AudioBuffer<float>& sendBuffer)
+    {
+        if (!juce::isPositiveAndBelow(trackIndex, static_cast<int>(pdcDelayBuffers.size())))
+            return;
+
+        auto& delayBuffer = pdcDelayBuffers[static_cast<size_t>(trackIndex)];
+        auto& scratch = pdcScratchBuffers[static_cast<size_t>(trackIndex)];
+        const int bufferSamples = juce::jmin(blockSamples, mainBuffer.getNumSamples(), sendBuffer.getNumSamples());
+        if (delayBuffer.getNumChannels() < 4 || delayBuffer.getNumSamples() <= 0
+            || bufferSamples <= 0 || scratch.getNumSamples() < bufferSamples)
+            return;
+
+        const int mainChannels = juce::jmin(2, mainBuffer.getNumChannels());
+        const int sendChannels = juce::jmin(2, sendBuffer.getNumChannels());
+        scratch.clear();
+        for (int ch = 0; ch < mainChannels; ++ch)
+            scratch.copyFrom(ch, 0, mainBuffer, ch, 0, bufferSamples);
+        for (int ch = 0; ch < sendChannels; ++ch)
+            scratch.copyFrom(ch + 2, 0, sendBuffer, ch, 0, bufferSamples);
+
+        int writePos = pdcWritePositions[static_cast<size_t>(trackIndex)];
+        const int ringSamples = delayBuffer.getNumSamples();
+        const int clampedMainDelay = juce::jlimit(0, ringSamples - 1, mainDelaySamples);
+        const int clampedSendDelay = juce::jlimit(0, ringSamples - 1, sendDelaySamples);
+        int readMainPos = (writePos - clampedMainDelay + ringSamples) % ringSamples;
+        int readSendPos = (writePos - clampedSendDelay + ringSamples) % ringSamples;
+
+        for (int i = 0; i < bufferSamples; ++i)
+        {
+            for (int ch = 0; ch < mainChannels; ++ch)
+                mainBuffer.setSample(ch, i, clampedMainDelay > 0 ? delayBuffer.getSample(ch, readMainPos) : scratch.getSample(ch, i));
+            for (int ch = 0; ch < sendChannels; ++ch)
+                sendBuffer.setSample(ch, i, clampedSendDelay > 0 ? delayBuffer.getSample(ch + 2, readSendPos) : scratch.getSample(ch + 2, i));
+            for (int ch = 0; ch < 4; ++ch)
+                delayBuffer.setSample(ch, writePos, scratch.getSample(ch, i));
+
+            writePos = (writePos + 1) % ringSamples;
+            readMainPos = (readMainPos + 1) % ringSamples;
+            readSendPos = (readSendPos + 1) % ringSamples;
+        }
+
+        pdcWritePositions[static_cast<size_t>(trackIndex)] = writePos;
+    }
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "AudioClipRenderer.h"
+#include "AutomationRamp.h"
+#include "OfflineRenderEngine.h"
+#include "OfflineStemCapture.h"
+#include "RealtimeAudioEngine.h"
+#include "RealtimeGraphScheduler.h"
+#include "TempoMap.h"
+#include "TimelineModel.h"
+#include "Track.h"
+#include "TransportEngine.h"
+
+namespace sampledex
+{
+    // A copy of the session for one export or bounce, taken on the message thread. The
+    // tracks are clones whose plugins were re-created from their saved state, so nothing
+    // in it is shared with the live engine. Clip and lane track indices refer to tracks.
+    struct IsolatedRenderProject
+    {
+        std::vector<std::unique_ptr<Track>> tracks;
+        std::vector<Clip> arrangement;
+        std::vector<AutomationLane> automationLanes;
+        TempoMapIndex tempoMap;
+        double fallbackBpm = 120.0; // when the tempo map is empty
+        int globalTransposeSemitones = 0;
+
+        float masterGain = 1.0f;
+        bool softClipEnabled = false;
+        bool limiterEnabled = false;
+        bool outputDcHighPassEnabled = true;
+        bool monitorSafeMode = false;
+        bool auxFxEnabled = true;
+        float auxReturnGain = 1.0f;
+        juce::Reverb::Parameters auxReverbParameters;
+    };
+
+    // Renders an IsolatedRenderProject with its own transport, graph scheduler, work
+    // buffers, delay compensation, aux returns and master chain, following the steps of
+    // the device callback minus live input, metronome and meters. The device keeps
+    // playing the live session while a pass runs. Build and prepare() on the message
+    // thread, render passes on one background thread, destroy on the message thread.
+    class IsolatedRenderEngine final
+    {
+    public:
+        static constexpr int maxTracks = 128;
+        static constexpr int auxBusCount = Track::maxSendBuses;
+
+        struct Pass
+        {
+            double startBeat = 0.0;
+            double endBeat = 4.0;
+            double tailSeconds = 2.0; // with endTailOnSilence, the most that is rendered
+            // Ends the tail once the plugins' reported tails have passed and the output (the
+            // track stems, when capturing them) has stayed below Track::sleepSilenceThreshold
+            // for Track::sleepSilenceHoldSeconds. getLastProgress() has the length rendered.
+            bool endTailOnSilence = false;
+            bool includeMasterProcessing = true; // false: unity gain, no soft clip or limiter
+            OfflineStemCapture* stemCapture = nullptr;
+        };
+
+        IsolatedRenderEngine(std::unique_ptr<IsolatedRenderProject> projectToRender,
+                             juce::AudioFormatManager& audioFormats,
+                             const OfflineRenderSettings& settings);
+        ~IsolatedRenderEngine();
+
+        // Prepares the cloned tracks at sampleRate and opens every audio file the
+        // arrangement plays with a private reader.
+        void prepare(double newSampleRate);
+
+        int getNumTracks() const noexcept { return juce::jmin(maxTracks, static_cast<int>(project->tracks.size())); }
+        // Render thread between passes (e.g. to solo a stem's track), or message thread
+        // while no pass runs.
+        Track* getTrack(int index) const noexcept;
+        double getSampleRate() const noexcept { return sampleRate; }
+        int getBlockSize() const noexcept { return blockSize; }
+
+        // Integrated over the tempo map, plus the tail.
+        std::int64_t getPassLengthSamples(const Pass& pass) const noexcept;
+
+        // Renders one pass on the calling thread, widening this engine's scheduler to the
+        // offline worker count, and hands each block (after stems are captured) to
+        // consumeBlock. Returns false when cancelled or when consumeBlock fails; a tail
+        // ended on silence is a success.
+        bool renderPass(const Pass& pass,
+                        const OfflineRenderEngine::BlockFn& consumeBlock,
+                        std::atomic<bool>* cancelFlag = nullptr,
+                        const OfflineRenderEngine::ProgressFn& progressCallback = {});
+
+        const OfflineRenderProgress& getLastProgress() const noexcept { return lastProgress; }
+        int getLastWorkerCount() const noexcept { return lastWorkerCount; }
+
+    private:
+        struct ClipFile
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader;
+            AudioClipRenderer::StreamInfo info;
+        };
+
+        void beginPass(const Pass& pass);
+        void renderBlock(juce::AudioBuffer<float>& output, int numSamples);
+        void applyAutomation(const TempoBlockSpan& blockSpan);
+        void applyDelayCompensation(int trackIndex,
+                                    int mainDelaySamples,
+                                    int sendDelaySamples,
+                                    int blockSamples,
+                                    juce::AudioBuffer<float>& mainBuffer,
+                                    juce::AudioBuffer<float>& sendBuffer);
+        bool isPassOutputSilent(const juce::AudioBuffer<float>& block, int numSamples);
+
+        std::unique_ptr<IsolatedRenderProject> project;
+        juce::AudioFormatManager& audioFormatManager;
+        const OfflineRenderSettings renderSettings;
+        const int blockSize;
+        double sampleRate = 44100.0;
+        float masterGainDezipperCoeff = 0.0015f;
+
+        TransportEngine transport;
+        RealtimeGraphScheduler scheduler;
+        RealtimeAudioEngine::PdcFn pdcFn;
+        TempoMapIndex constantTempoMap;
+        const TempoMapIndex* tempoMap = &constantTempoMap;
+
+        std::map<juce::String, std::unique_ptr<ClipFile>> clipFilesByPath;
+        std::vector<ClipFile*> clipFiles; // one per arrangement clip, nullptr = in memory
+
+        std::vector<juce::AudioBuffer<float>> mainBuffers;
+        std::vector<juce::AudioBuffer<float>> sendBuffers;
+        std::vector<juce::AudioBuffer<float>> timelineBuffers;
+        std::vector<juce::MidiBuffer> midiBuffers;
+        std::vector<juce::AudioBuffer<float>> pdcDelayBuffers;
+        std::vector<juce::AudioBuffer<float>> pdcScratchBuffers;
+        std::vector<int> pdcWritePositions;
+        int pdcBufferSamples = 0;
+        juce::AudioBuffer<float> mixBuffer;
+        juce::AudioBuffer<float> streamScratch;
+        juce::AudioBuffer<float> masterGainValues;
+        std::array<juce::AudioBuffer<float>, auxBusCount> auxBusBuffers;
+        std::array<juce::Reverb, auxBusCount> auxReverbs;
+        std::array<int, auxBusCount> auxBusLatencySamples {};
+
+        std::array<RealtimeTrackGraphJob, maxTracks> jobs {};
+        std::array<bool, maxTracks> trackGraphAudible {};
+        std::array<bool, maxTracks> trackMonitorInputUsed {};
+        std::array<bool, maxTracks> trackSendFeedbackBlocked {};
+        std::array<bool, maxTracks> trackOutputToBus {};
+        std::array<int, maxTracks> trackSendBusIndex {};
+        std::array<int, maxTracks> trackOutputBusIndex {};
+        std::array<int, maxTracks> trackMainPathLatencySamples {};
+        std::array<int, maxTracks> trackSendPathLatencySamples {};
+        std::array<bool, maxTracks> trackSendPathActive {};
+
+        std::vector<AutomationLaneCursor> laneCursors;
+        AutomationBlockRamp masterAutomationRamp;
+        float masterGainTarget = 1.0f;
+        MasterLimiter masterLimiter;
+        std::array<float, 2> outputBoundaryPrevSample {};
+
+        OfflineStemCapture* stemCapture = nullptr;
+        bool includeMasterProcessing = true;
+        bool firstBlockOfPass = true;
+        bool panicPending = false;
+        int passesRendered = 0;
+        OfflineRenderProgress lastProgress;
+        int lastWorkerCount = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(IsolatedRenderEngine)
+    };
+}
@@ -0,0 +1,258 @@
+#include "LoudnessAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sampledex
+{
+    namespace
+    {
+        constexpr double absoluteGateLufs = -70.0;
+        constexpr double integratedRelativeGateLu = -10.0;
+        constexpr double rangeRelativeGateLu = -20.0;
+        constexpr int hopsPerBlock = 4;
+        constexpr int hopsPerShortTerm = 30;
+
+        double energyToLufs(double meanSquare) noexcept
+        {
+            return meanSquare > 0.0 ? -0.691 + (10.0 * std::log10(meanSquare)) : -200.0;
+        }
+
+        double lufsToEnergy(double lufs) noexcept
+        {
+            return std::pow(10.0, (lufs + 0.691) / 10.0);
+        }
+
+        // Mean energy of the values above the absolute gate and then above the relative
+        // gate (relativeLu below that first mean). Returns 0 when nothing passes.
+        double gatedMeanEnergy(const std::vector<double>& energies, double relativeLu, std::vector<double>* passed = nullptr)
+        {
+            const double absoluteGate = lufsToEnergy(absoluteGateLufs);
+            double sum = 0.0;
+            int count = 0;
+            for (const double energy : energies)
+                if (energy > absoluteGate)
+                {
+                    sum += energy;
+                    ++count;
+                }
+            if (count == 0)
+                return 0.0;
+
+            const double relativeGate = lufsToEnergy(energyToLufs(sum / count) + relativeLu);
+            sum = 0.0;
+            count = 0;
+            for (const double energy : energies)
+                if (energy > absoluteGate && energy > relativeGate)
+                {
+                    sum += energy;
+                    ++count;
+                    if (passed != nullptr)
+                        passed->push_back(energy);
+                }
+            return count > 0 ? sum / count : 0.0;
+        }
+    }
+
+    void LoudnessAnalyzer::prepare(double sampleRate, int numChannels)
+    {
+        rate = sampleRate > 0.0 ? sampleRate : 48000.0;
+        channels = juce::jlimit(1, maxChannels, numChannels);
+
+        // K-weighting: the BS.1770 high shelf and high-pass, re-derived for this rate.
+        {
+            const double f0 = 1681.974450955533;
+            const double gainDb = 3.999843853973347;
+            const double q = 0.7071752369554196;
+            const double k = std::tan(juce::MathConstants<double>::pi * f0 / rate);
+            const double vh = std::pow(10.0, gainDb / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + (k / q) + (k * k);
+            Biquad shelf;
+            shelf.b0 = (vh + (vb * k / q) + (k * k)) / a0;
+            shelf.b1 = 2.0 * ((k * k) - vh) / a0;
+            shelf.b2 = (vh - (vb * k / q) + (k * k)) / a0;
+            shelf.a1 = 2.0 * ((k * k) - 1.0) / a0;
+            shelf.a2 = (1.0 - (k / q) + (k * k)) / a0;
+            shelfFilters.fill(shelf);
+        }
+        {
+            const double f0 = 38.13547087602444;
+            const double q = 0.5003270373238773;
+            const double k = std::tan(juce::MathConstants<double>::pi * f0 / rate);
+            const double a0 = 1.0 + (k / q) + (k * k);
+            Biquad highPass;
+            highPass.b0 = 1.0;
+            highPass.b1 = -2.0;
+            highPass.b2 = 1.0;
+            highPass.a1 = 2.0 * ((k * k) - 1.0) / a0;
+            highPass.a2 = (1.0 - (k / q) + (k * k)) / a0;
+            highPassFilters.fill(highPass);
+        }
+
+        hopLength = juce::jmax(1, juce::roundToInt(rate * 0.1));
+
+        // True peak: 4x below 96 kHz, 2x below 192 kHz, otherwise the samples themselves.
+        oversampling = rate < 96000.0 ? 4 : (rate < 192000.0 ? 2 : 1);
+        const int taps = truePeakTapsPerPhase * oversampling;
+        std::vector<double> prototype(static_cast<size_t>(taps));
+        const double centre = (taps - 1) * 0.5;
+        for (int n = 0; n < taps; ++n)
+        {
+            const double x = (n - centre) / oversampling;
+            const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+            const double window = 0.42 - (0.5 * std::cos(juce::MathConstants<double>::twoPi * n / (taps - 1)))
+                                + (0.08 * std::cos(2.0 * juce::MathConstants<double>::twoPi * n / (taps - 1)));
+            prototype[static_cast<size_t>(n)] = sinc * window;
+        }
+
+        truePeakCoefficients.assign(static_cast<size_t>(taps), 0.0f);
+        for (int phase = 0; phase < oversampling; ++phase)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < truePeakTapsPerPhase; ++k)
+                sum += prototype[static_cast<size_t>((k * oversampling) + phase)];
+            for (int k = 0; k < truePeakTapsPerPhase; ++k)
+                truePeakCoefficients[static_cast<size_t>((phase * truePeakTapsPerPhase) + k)]
+                    = static_cast<float>(prototype[static_cast<size_t>((k * oversampling) + phase)] / (sum != 0.0 ? sum : 1.0));
+        }
+
+        reset();
+    }
+
+    void LoudnessAnalyzer::reset()
+    {
+        for (auto& filter : shelfFilters)
+            filter.z1 = filter.z2 = 0.0;
+        for (auto& filter : highPassFilters)
+            filter.z1 = filter.z2 = 0.0;
+        hopSamples = 0;
+        hopEnergy = 0.0;
+        hopEnergies.clear();
+        blockEnergies.clear();
+        shortTermEnergies.clear();
+        for (auto& history : truePeakHistory)
+            history.fill(0.0f);
+        truePeakHistoryPos = 0;
+        truePeak = 0.0f;
+        samplePeak = 0.0f;
+        samplesMeasured = 0;
+    }
+
+    float LoudnessAnalyzer::processTruePeak(int channel, float sample) noexcept
+    {
+        auto& history = truePeakHistory[static_cast<size_t>(channel)];
+        history[static_cast<size_t>(truePeakHistoryPos)] = sample;
+        if (oversampling == 1)
+            return std::abs(sample);
+
+        float peak = 0.0f;
+        for (int phase = 0; phase < oversampling; ++phase)
+        {
+            const float* coefficients = truePeakCoefficients.data() + (phase * truePeakTapsPerPhase);
+            float sum = 0.0f;
+            int index = truePeakHistoryPos;
+            for (int k = 0; k < truePeakTapsPerPhase; ++k)
+            {
+                sum += coefficients[k] * history[static_cast<size_t>(index)];
+                index = index == 0 ? truePeakTapsPerPhase - 1 : index - 1;
+            }
+            peak = juce::jmax(peak, std::abs(sum));
+        }
+        return peak;
+    }
+
+    void LoudnessAnalyzer::process(const juce::AudioBuffer<float>& block, int numSamples) noexcept
+    {
+        const int blockChannels = juce::jmin(channels, block.getNumChannels());
+        if (blockChannels <= 0)
+            return;
+
+        std::array<const float*, maxChannels> reads {};
+        for (int ch = 0; ch < blockChannels; ++ch)
+            reads[static_cast<size_t>(ch)] = block.getReadPointer(ch);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            double frameEnergy = 0.0;
+            for (int ch = 0; ch < blockChannels; ++ch)
+            {
+                const float sample = reads[static_cast<size_t>(ch)][i];
+                samplePeak = juce::jmax(samplePeak, std::abs(sample));
+                truePeak = juce::jmax(truePeak, processTruePeak(ch, sample));
+
+                // Left and right both weigh 1.0.
+                const double weighted = highPassFilters[static_cast<size_t>(ch)].process(
+                    shelfFilters[static_cast<size_t>(ch)].process(static_cast<double>(sample)));
+                frameEnergy += weighted * weighted;
+            }
+            truePeakHistoryPos = (truePeakHistoryPos + 1) % truePeakTapsPerPhase;
+
+            hopEnergy += frameEnergy;
+            if (++hopSamples >= hopLength)
+                endHop();
+        }
+        samplesMeasured += numSamples;
+    }
+
+    void LoudnessAnalyzer::endHop()
+    {
+        hopEnergies.push_back(hopEnergy / hopSamples);
+        hopEnergy = 0.0;
+        hopSamples = 0;
+
+        const auto average = [this](int hops)
+        {
+            double sum = 0.0;
+            for (auto it = hopEnergies.end() - hops; it != hopEnergies.end(); ++it)
+                sum += *it;
+            return sum / hops;
+        };
+
+        const int hops = static_cast<int>(hopEnergies.size());
+        if (hops >= hopsPerBlock)
+            blockEnergies.push_back(average(hopsPerBlock));
+        if (hops >= hopsPerShortTerm)
+            shortTermEnergies.push_back(average(hopsPerShortTerm));
+    }
+
+    LoudnessAnalyzer::Measurement LoudnessAnalyzer::getMeasurement() const
+    {
+        Measurement measurement;
+        measurement.samplesMeasured = samplesMeasured;
+        measurement.truePeakDbtp = juce::Decibels::gainToDecibels(static_cast<double>(truePeak), -120.0);
+        measurement.samplePeakDbfs = juce::Decibels::gainToDecibels(static_cast<double>(samplePeak), -120.0);
+
+        const double integrated = gatedMeanEnergy(blockEnergies, integratedRelativeGateLu);
+        if (integrated <= 0.0)
+            return measurement;
+        measurement.valid = true;
+        measurement.integratedLufs = energyToLufs(integrated);
+
+        // LRA: spread between the 10th and 95th percentile of the gated short-term values.
+        std::vector<double> passed;
+        gatedMeanEnergy(shortTermEnergies, rangeRelativeGateLu, &passed);
+        if (passed.size() >= 2)
+        {
+            std::sort(passed.begin(), passed.end());
+            const auto percentile = [&passed](double fraction)
+            {
+                const auto index = static_cast<size_t>(std::lround(fraction * static_cast<double>(passed.size() - 1)));
+                return energyToLufs(passed[index]);
+            };
+            measurement.loudnessRangeLu = percentile(0.95) - percentile(0.10);
+        }
+        return measurement;
+    }
+
+    double LoudnessAnalyzer::getNormalisationGainDb(const Measurement& measurement,
+                                                    double targetLufs,
+                                                    double ceilingDbtp) noexcept
+    {
+        if (!measurement.valid)
+            return 0.0;
+        const double loudnessGain = targetLufs - measurement.integratedLufs;
+        const double peakHeadroom = ceilingDbtp - measurement.truePeakDbtp;
+        return juce::jmin(loudnessGain, peakHeadroom);
+    }
+}
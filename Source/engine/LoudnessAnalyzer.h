@@ -0,0 +1,82 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace sampledex
+{
+    // Measures a whole programme per ITU-R BS.1770 / EBU R128: gated integrated loudness,
+    // loudness range (EBU Tech 3342) and true peak from an oversampled signal. Feed it
+    // every block of a render in order from one thread, then read getMeasurement().
+    class LoudnessAnalyzer final
+    {
+    public:
+        struct Measurement
+        {
+            bool valid = false;              // false when everything was below the absolute gate
+            double integratedLufs = -70.0;
+            double loudnessRangeLu = 0.0;
+            double truePeakDbtp = -120.0;
+            double samplePeakDbfs = -120.0;
+            std::int64_t samplesMeasured = 0;
+        };
+
+        static constexpr int maxChannels = 2;
+
+        void prepare(double sampleRate, int numChannels);
+        void reset();
+        void process(const juce::AudioBuffer<float>& block, int numSamples) noexcept;
+
+        Measurement getMeasurement() const;
+
+        // Gain that brings integrated loudness to targetLufs without the true peak passing
+        // ceilingDbtp. Zero when nothing could be measured.
+        static double getNormalisationGainDb(const Measurement& measurement,
+                                             double targetLufs,
+                                             double ceilingDbtp) noexcept;
+
+    private:
+        struct Biquad
+        {
+            double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+            double z1 = 0.0, z2 = 0.0;
+
+            double process(double x) noexcept
+            {
+                const double y = (b0 * x) + z1;
+                z1 = (b1 * x) - (a1 * y) + z2;
+                z2 = (b2 * x) - (a2 * y);
+                return y;
+            }
+        };
+
+        static constexpr int truePeakTapsPerPhase = 12;
+
+        void endHop();
+        float processTruePeak(int channel, float sample) noexcept;
+
+        double rate = 48000.0;
+        int channels = 2;
+        std::array<Biquad, maxChannels> shelfFilters {};
+        std::array<Biquad, maxChannels> highPassFilters {};
+
+        // Mean-square energy in 100 ms hops; gating blocks are 4 hops (400 ms, 75% overlap)
+        // and short-term windows 30 hops (3 s).
+        int hopLength = 4800;
+        int hopSamples = 0;
+        double hopEnergy = 0.0;
+        std::vector<double> hopEnergies;
+        std::vector<double> blockEnergies;
+        std::vector<double> shortTermEnergies;
+
+        int oversampling = 4;
+        std::vector<float> truePeakCoefficients; // phase-major, truePeakTapsPerPhase per phase
+        std::array<std::array<float, truePeakTapsPerPhase>, maxChannels> truePeakHistory {};
+        int truePeakHistoryPos = 0;
+        float truePeak = 0.0f;
+        float samplePeak = 0.0f;
+        std::int64_t samplesMeasured = 0;
+    };
+}
@@ -0,0 +1,385 @@
+#include "MasterLimiter.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace sampledex
+{
+    static double besselI0(double x) noexcept
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            const double factor = x / (2.0 * k);
+            term *= factor * factor;
+            sum += term;
+        }
+        return sum;
+    }
+
+    void MasterLimiter::prepare(double sampleRate, int maxBlockSize)
+    {
+        const double rate = sampleRate > 0.0 ? sampleRate : 44100.0;
+        maxBlock = juce::jmax(1, maxBlockSize);
+        window = juce::jlimit(16, 1024, juce::roundToInt(rate * lookaheadSeconds));
+        latencySamples = (truePeakTaps / 2) + window - 1;
+
+        history.setSize(maxChannels, latencySamples + maxBlock);
+        gains.assign(static_cast<size_t>(maxBlock), 1.0f);
+        detector.assign(static_cast<size_t>(maxBlock), 0.0f);
+        scratch.assign(static_cast<size_t>(maxBlock), 0.0f);
+        crossfade.assign(static_cast<size_t>(maxBlock), 0.0f);
+        dequeIndices.assign(static_cast<size_t>(window + 2), 0);
+        dequeValues.assign(static_cast<size_t>(window + 2), 0.0f);
+        averageRing.assign(static_cast<size_t>(window), 1.0f);
+
+        // Kaiser-windowed sinc (beta 5) reaching six samples either side, within 0.5% of
+        // the ideal interpolator up to 17 kHz at 48 kHz; each phase normalised to unity
+        // gain at DC.
+        constexpr int halfWidth = truePeakTaps / 2;
+        constexpr double kaiserBeta = 5.0;
+        interpolationBound = 1.0f;
+        for (size_t phase = 0; phase < phaseCoefficients.size(); ++phase)
+        {
+            const double fraction = static_cast<double>(phase + 1) / static_cast<double>(oversampling);
+            std::array<double, truePeakTaps> prototype {};
+            double sum = 0.0;
+            for (int k = 0; k < truePeakTaps; ++k)
+            {
+                const double x = fraction + (halfWidth - 1) - k;
+                const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+                const double edge = x / halfWidth;
+                const double kaiser = besselI0(kaiserBeta * std::sqrt(juce::jmax(0.0, 1.0 - (edge * edge)))) / besselI0(kaiserBeta);
+                prototype[static_cast<size_t>(k)] = sinc * kaiser;
+                sum += prototype[static_cast<size_t>(k)];
+            }
+            float absoluteSum = 0.0f;
+            for (int k = 0; k < truePeakTaps; ++k)
+            {
+                phaseCoefficients[phase][static_cast<size_t>(k)] = static_cast<float>(prototype[static_cast<size_t>(k)] / (sum != 0.0 ? sum : 1.0));
+                absoluteSum += std::abs(phaseCoefficients[phase][static_cast<size_t>(k)]);
+            }
+            interpolationBound = juce::jmax(interpolationBound, absoluteSum);
+        }
+
+        reset();
+    }
+
+    void MasterLimiter::reset() noexcept
+    {
+        history.clear();
+        dequeFront = 0;
+        detectorIndex = 0;
+        resetEnvelope();
+        limiterMixSet = false;
+        dcPrevInput.fill(0.0f);
+        dcPrevOutput.fill(0.0f);
+        softClipPrevInput.fill(0.0f);
+    }
+
+    void MasterLimiter::resetEnvelope() noexcept
+    {
+        dequeSize = 0;
+        releaseState = 1.0f;
+        std::fill(averageRing.begin(), averageRing.end(), 1.0f);
+        averagePos = 0;
+        averageSum = static_cast<double>(window);
+        samplesAtUnity = window;
+    }
+
+    bool MasterLimiter::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, const Settings& settings) noexcept
+    {
+        numSamples = juce::jmin(numSamples, buffer.getNumSamples() - startSample);
+        if (numSamples <= 0)
+            return false;
+        if (!isPrepared())
+        {
+            jassertfalse;
+            buffer.clear(startSample, numSamples);
+            return false;
+        }
+
+        for (int ch = maxChannels; ch < buffer.getNumChannels(); ++ch)
+            buffer.clear(ch, startSample, numSamples);
+
+        bool fault = false;
+        for (int done = 0; done < numSamples;)
+        {
+            const int count = juce::jmin(maxBlock, numSamples - done);
+            const float* gainValues = settings.gainValues != nullptr ? settings.gainValues + done : nullptr;
+            fault = processChunk(buffer, startSample + done, count, gainValues, settings) || fault;
+            done += count;
+        }
+        return fault;
+    }
+
+    bool MasterLimiter::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                     const float* gainValues, const Settings& settings) noexcept
+    {
+        const int numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+        std::array<float*, maxChannels> channels {};
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[static_cast<size_t>(ch)] = buffer.getWritePointer(ch, startSample);
+
+        // Non-finite input would poison every filter and the gain envelope; drop it here.
+        // findMinAndMax() catches infinities but may step over a NaN, which is the one
+        // value not equal to itself.
+        bool fault = false;
+        constexpr float largestFinite = std::numeric_limits<float>::max();
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* data = channels[static_cast<size_t>(ch)];
+            const auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+            bool bad = !(range.getStart() >= -largestFinite && range.getEnd() <= largestFinite);
+            for (int i = 0; i < numSamples; ++i)
+                bad |= data[i] != data[i];
+            if (!bad)
+                continue;
+            fault = true;
+            for (int i = 0; i < numSamples; ++i)
+                if (!(std::abs(data[i]) <= largestFinite))
+                    data[i] = 0.0f;
+        }
+
+        applyMasterGain(channels.data(), numChannels, numSamples, gainValues, settings);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* data = channels[static_cast<size_t>(ch)];
+            const auto slot = static_cast<size_t>(ch);
+            if (settings.dcBlockerEnabled)
+            {
+                // y[n] = x[n] - x[n-1] + 0.995 y[n-1]; the difference runs vectorised, only
+                // the one-pole recursion is left per sample.
+                constexpr float dcBlockCoeff = 0.995f;
+                float* difference = scratch.data();
+                difference[0] = data[0] - dcPrevInput[slot];
+                if (numSamples > 1)
+                    juce::FloatVectorOperations::subtract(difference + 1, data + 1, data, numSamples - 1);
+                dcPrevInput[slot] = data[numSamples - 1];
+                float previousOutput = dcPrevOutput[slot];
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    previousOutput = difference[i] + (dcBlockCoeff * previousOutput);
+                    data[i] = previousOutput;
+                }
+                dcPrevOutput[slot] = previousOutput;
+            }
+
+            if (settings.softClipEnabled)
+            {
+                // 2x: the clipped midpoint from the previous sample averaged with the clipped sample.
+                const float drive = settings.softClipDrive;
+                const float normaliser = settings.softClipNormaliser;
+                float previousInput = softClipPrevInput[slot];
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float sample = data[i];
+                    const float midpoint = 0.5f * (previousInput + sample);
+                    data[i] = 0.5f * normaliser * (std::tanh(midpoint * drive) + std::tanh(sample * drive));
+                    previousInput = sample;
+                }
+                softClipPrevInput[slot] = previousInput;
+            }
+
+            juce::FloatVectorOperations::copy(history.getWritePointer(ch) + latencySamples, data, numSamples);
+        }
+
+        // Bypassed, there is no lookahead: the block goes out as it is, and the gain starts
+        // again from unity when the limiter comes back. Switching fades from one output to
+        // the other over the window; the limiter keeps running until the fade is done.
+        const float ceiling = juce::jmax(1.0e-3f, settings.ceiling);
+        const float mixTarget = settings.limiterEnabled ? 1.0f : 0.0f;
+        if (!limiterMixSet)
+        {
+            limiterMix = mixTarget;
+            limiterMixSet = true;
+        }
+        const bool crossfading = limiterMix != mixTarget;
+        bool unityGain = true;
+        if (settings.limiterEnabled || crossfading)
+        {
+            detectTruePeaks(numChannels, numSamples, ceiling);
+            unityGain = computeGains(numSamples, ceiling, juce::jlimit(0.0f, 1.0f, settings.release));
+        }
+        else if (samplesAtUnity < window || dequeSize > 0)
+        {
+            resetEnvelope();
+        }
+
+        if (crossfading)
+        {
+            const float step = 1.0f / static_cast<float>(window);
+            for (int i = 0; i < numSamples; ++i)
+            {
+                limiterMix = mixTarget > limiterMix ? juce::jmin(mixTarget, limiterMix + step)
+                                                    : juce::jmax(mixTarget, limiterMix - step);
+                crossfade[static_cast<size_t>(i)] = limiterMix;
+            }
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* data = channels[static_cast<size_t>(ch)];
+            float* delayed = history.getWritePointer(ch);
+            if (crossfading)
+            {
+                // data += (limited - data) * crossfade
+                float* limited = scratch.data();
+                if (unityGain)
+                    juce::FloatVectorOperations::copy(limited, delayed, numSamples);
+                else
+                    juce::FloatVectorOperations::multiply(limited, delayed, gains.data(), numSamples);
+                juce::FloatVectorOperations::subtract(limited, limited, data, numSamples);
+                juce::FloatVectorOperations::multiply(limited, crossfade.data(), numSamples);
+                juce::FloatVectorOperations::add(data, limited, numSamples);
+            }
+            else if (settings.limiterEnabled && unityGain)
+                juce::FloatVectorOperations::copy(data, delayed, numSamples);
+            else if (settings.limiterEnabled)
+                juce::FloatVectorOperations::multiply(data, delayed, gains.data(), numSamples);
+            std::memmove(delayed, delayed + numSamples, sizeof(float) * static_cast<size_t>(latencySamples));
+
+            // Only reachable with the limiter off or fading: a runaway mix is muted, not clamped.
+            // Everything here is finite by now.
+            const auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+            if (range.getStart() < -faultThreshold || range.getEnd() > faultThreshold)
+            {
+                fault = true;
+                for (int i = 0; i < numSamples; ++i)
+                    if (!(std::abs(data[i]) <= faultThreshold))
+                        data[i] = 0.0f;
+            }
+            // The ceiling holds in sample peak whether or not the limiter is on, so a bypassed
+            // limiter clips instead of handing the encoder samples over full scale.
+            juce::FloatVectorOperations::clip(data, data, -ceiling, ceiling, numSamples);
+        }
+        return fault;
+    }
+
+    void MasterLimiter::applyMasterGain(float* const* channels, int numChannels, int numSamples,
+                                        const float* gainValues, const Settings& settings) noexcept
+    {
+        if (gainValues != nullptr)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::multiply(channels[ch], gainValues, numSamples);
+            gainState = gainValues[numSamples - 1];
+            return;
+        }
+
+        const float target = settings.targetGain;
+        if (std::abs(target - gainState) < 1.0e-6f)
+        {
+            gainState = target;
+            if (gainState != 1.0f)
+                for (int ch = 0; ch < numChannels; ++ch)
+                    juce::FloatVectorOperations::multiply(channels[ch], gainState, numSamples);
+            return;
+        }
+
+        // The gain buffer is free until computeGains().
+        float* ramp = gains.data();
+        for (int i = 0; i < numSamples; ++i)
+        {
+            gainState += (target - gainState) * settings.gainDezipperCoeff;
+            ramp[i] = gainState;
+        }
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::multiply(channels[ch], ramp, numSamples);
+    }
+
+    void MasterLimiter::detectTruePeaks(int numChannels, int numSamples, float ceiling) noexcept
+    {
+        // detector[i] covers sample m = i - truePeakTaps / 2 of the block and the three
+        // points between it and the next, loudest channel.
+        float* peaks = detector.data();
+        float* phase = scratch.data();
+        juce::FloatVectorOperations::clear(peaks, numSamples);
+        constexpr int centreTap = (truePeakTaps / 2) - 1;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            // base[i + k] is x[m - truePeakTaps / 2 + 1 + k]; base[i + truePeakTaps - 1] the
+            // newest sample.
+            const float* base = history.getReadPointer(ch) + latencySamples - (truePeakTaps - 1);
+
+            // No filter output can exceed the loudest input sample times the sum of the
+            // taps' magnitudes, and nothing at or under the ceiling changes the gain.
+            const auto range = juce::FloatVectorOperations::findMinAndMax(base, numSamples + truePeakTaps - 1);
+            if (juce::jmax(-range.getStart(), range.getEnd()) * interpolationBound <= ceiling)
+                continue;
+
+            juce::FloatVectorOperations::abs(phase, base + centreTap, numSamples);
+            juce::FloatVectorOperations::max(peaks, peaks, phase, numSamples);
+            for (const auto& coefficients : phaseCoefficients)
+            {
+                juce::FloatVectorOperations::clear(phase, numSamples);
+                for (int k = 0; k < truePeakTaps; ++k)
+                    juce::FloatVectorOperations::addWithMultiply(phase, base + k, coefficients[static_cast<size_t>(k)], numSamples);
+                juce::FloatVectorOperations::abs(phase, phase, numSamples);
+                juce::FloatVectorOperations::max(peaks, peaks, phase, numSamples);
+            }
+        }
+    }
+
+    bool MasterLimiter::computeGains(int numSamples, float ceiling, float release) noexcept
+    {
+        // Nothing over the ceiling and nothing left to release: the gain is exactly one.
+        // Whatever the deque holds is under the ceiling by then, so it can go.
+        if (samplesAtUnity >= window
+            && juce::FloatVectorOperations::findMaximum(detector.data(), numSamples) <= ceiling)
+        {
+            dequeSize = 0;
+            detectorIndex += numSamples;
+            averageSum = static_cast<double>(window);
+            return true;
+        }
+
+        // The gain for detector sample k is at or under ceiling / peak[k] from k + window - 1
+        // through k + window, which is when samples k - truePeakTaps / 2 and the one after
+        // it leave the delay line.
+        const int capacity = static_cast<int>(dequeValues.size());
+        const auto wrap = [capacity](int index) noexcept { return index >= capacity ? index - capacity : index; };
+        const double inverseWindow = 1.0 / static_cast<double>(window);
+        float* out = gains.data();
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float peak = detector[static_cast<size_t>(i)];
+            while (dequeSize > 0 && dequeValues[static_cast<size_t>(wrap(dequeFront + dequeSize - 1))] <= peak)
+                --dequeSize;
+            const auto slot = static_cast<size_t>(wrap(dequeFront + dequeSize));
+            dequeIndices[slot] = detectorIndex;
+            dequeValues[slot] = peak;
+            ++dequeSize;
+            if (dequeIndices[static_cast<size_t>(dequeFront)] < detectorIndex - window)
+            {
+                dequeFront = wrap(dequeFront + 1);
+                --dequeSize;
+            }
+            ++detectorIndex;
+
+            const float windowPeak = dequeValues[static_cast<size_t>(dequeFront)];
+            const float target = windowPeak > ceiling ? ceiling / windowPeak : 1.0f;
+            if (target < releaseState)
+            {
+                releaseState = target;
+            }
+            else
+            {
+                releaseState += (target - releaseState) * release;
+                if (target - releaseState < 1.0e-6f)
+                    releaseState = target;
+            }
+            samplesAtUnity = releaseState >= 1.0f ? juce::jmin(samplesAtUnity + 1, window) : 0;
+
+            averageSum += static_cast<double>(releaseState) - static_cast<double>(averageRing[static_cast<size_t>(averagePos)]);
+            averageRing[static_cast<size_t>(averagePos)] = releaseState;
+            if (++averagePos == window)
+                averagePos = 0;
+            out[i] = juce::jmin(1.0f, static_cast<float>(averageSum * inverseWindow));
+        }
+        return false;
+    }
+}
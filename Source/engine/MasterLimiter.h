@@ -0,0 +1,108 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace sampledex
+{
+    // The master output stage, one block at a time: master gain, DC blocker, soft clip
+    // and a lookahead brickwall limiter on the 4x oversampled (BS.1770) true peak, then
+    // a sample-peak clamp to the ceiling, which holds with the limiter off too. With the
+    // limiter on the audio is delayed by its lookahead, getLatencySamples(true), which
+    // callers add to their latency; bypassed, the block goes out undelayed and the
+    // latency is zero. Switching the limiter crossfades between the delayed and the
+    // undelayed output over the lookahead window, so the jump does not click.
+    //
+    // prepare() on the message thread (or with the device stopped); process() and
+    // reset() on the audio or render thread.
+    class MasterLimiter final
+    {
+    public:
+        struct Settings
+        {
+            const float* gainValues = nullptr; // per-sample automated gain; bypasses the dezipper
+            float targetGain = 1.0f;
+            float gainDezipperCoeff = 0.0015f;
+            bool dcBlockerEnabled = true;
+            bool softClipEnabled = false;
+            float softClipDrive = 1.18f;
+            float softClipNormaliser = 1.0f;
+            bool limiterEnabled = false;
+            float ceiling = 0.985f;
+            float release = 0.0025f; // per sample, towards unity gain
+        };
+
+        static constexpr int maxChannels = 16;
+        static constexpr int oversampling = 4;
+        static constexpr int truePeakTaps = 12; // per phase, as in BS.1770's 48-tap filter
+        static constexpr double lookaheadSeconds = 0.0015;
+        static constexpr float faultThreshold = 24.0f;
+
+        void prepare(double sampleRate, int maxBlockSize);
+        bool isPrepared() const noexcept { return maxBlock > 0; }
+        int getLatencySamples(bool limiterEnabled) const noexcept { return limiterEnabled ? latencySamples : 0; }
+
+        // Clears the delay line and filter state and releases any gain reduction; the next
+        // block starts in its limiter mode without a crossfade. The master gain keeps its
+        // current value.
+        void reset() noexcept;
+        void setCurrentGain(float gain) noexcept { gainState = gain; }
+
+        // Returns true when the block held a non-finite or runaway sample; those samples
+        // are zeroed. Channels past maxChannels are cleared.
+        bool process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, const Settings& settings) noexcept;
+
+    private:
+        bool processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                          const float* gainValues, const Settings& settings) noexcept;
+        void applyMasterGain(float* const* channels, int numChannels, int numSamples,
+                             const float* gainValues, const Settings& settings) noexcept;
+        void detectTruePeaks(int numChannels, int numSamples, float ceiling) noexcept;
+        bool computeGains(int numSamples, float ceiling, float release) noexcept;
+        void resetEnvelope() noexcept;
+
+        int maxBlock = 0;
+        int window = 0;          // samples the gain takes to reach a peak
+        int latencySamples = 0;  // true-peak filter delay plus the window
+
+        // Per channel: latencySamples of history, then the current block. Kept filled while
+        // bypassed, so switching the limiter on picks up from the newest input.
+        juce::AudioBuffer<float> history;
+        std::vector<float> gains;
+        std::vector<float> detector;
+        std::vector<float> scratch;
+        std::vector<float> crossfade;
+        // Phases 1/4, 2/4 and 3/4 of the way to the next sample; tap k reads
+        // x[m - truePeakTaps / 2 + 1 + k].
+        std::array<std::array<float, truePeakTaps>, oversampling - 1> phaseCoefficients {};
+        float interpolationBound = 1.0f; // largest sum of tap magnitudes over the phases
+
+        // Sliding maximum of the detector over window + 1 samples: a monotonic deque of
+        // (sample index, peak) in a ring, values decreasing from front to back.
+        std::vector<std::int64_t> dequeIndices;
+        std::vector<float> dequeValues;
+        int dequeFront = 0;
+        int dequeSize = 0;
+        std::int64_t detectorIndex = 0;
+
+        // Gain with instant attack and one-pole release, then a moving average over the
+        // window so it ramps down ahead of each peak instead of stepping.
+        float releaseState = 1.0f;
+        std::vector<float> averageRing;
+        int averagePos = 0;
+        double averageSum = 0.0;
+        int samplesAtUnity = 0;
+
+        // Weight of the delayed, limited output against the undelayed one: 1 with the
+        // limiter on, 0 bypassed, ramping over the window when it is switched.
+        float limiterMix = 0.0f;
+        bool limiterMixSet = false;
+
+        float gainState = 1.0f;
+        std::array<float, maxChannels> dcPrevInput {};
+        std::array<float, maxChannels> dcPrevOutput {};
+        std::array<float, maxChannels> softClipPrevInput {};
+    };
+}
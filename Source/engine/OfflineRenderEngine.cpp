@@ -0,0 +1,93 @@
+#include "OfflineRenderEngine.h"
+
+#include <thread>
+
+namespace sampledex
+{
+    int OfflineRenderSettings::getResolvedBlockSize() const noexcept
+    {
+        return juce::jlimit(minBlockSize, maxBlockSize, blockSize > 0 ? blockSize : defaultBlockSize);
+    }
+
+    int OfflineRenderSettings::getResolvedWorkerCount() const noexcept
+    {
+        const int limit = workerLimit >= 0 ? juce::jmin(workerLimit, RealtimeGraphScheduler::maxWorkerCount)
+                                           : RealtimeGraphScheduler::maxWorkerCount;
+        if (workerCount > 0)
+            return juce::jmin(workerCount, limit);
+
+        const int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+        return juce::jlimit(0, limit, hardwareThreads - 1);
+    }
+
+    OfflineRenderEngine::OfflineRenderEngine(RealtimeGraphScheduler& schedulerToWiden,
+                                             const OfflineRenderSettings& settings)
+        : scheduler(schedulerToWiden),
+          previousWorkerCount(schedulerToWiden.getWorkerCount()),
+          blockSize(settings.getResolvedBlockSize())
+    {
+        // A realtime device runs a few workers so the callback keeps headroom; offline
+        // there is no deadline, so every core can take a track.
+        scheduler.setWorkerCount(juce::jmax(previousWorkerCount, settings.getResolvedWorkerCount()));
+    }
+
+    OfflineRenderEngine::~OfflineRenderEngine()
+    {
+        scheduler.setWorkerCount(previousWorkerCount);
+    }
+
+    bool OfflineRenderEngine::render(std::int64_t totalSamples,
+                                     double sampleRate,
+                                     int numChannels,
+                                     const BlockFn& renderBlock,
+                                     const BlockFn& consumeBlock,
+                                     std::atomic<bool>* cancelFlag,
+                                     const ProgressFn& progressCallback)
+    {
+        lastProgress = {};
+        lastProgress.totalSamples = juce::jmax<std::int64_t>(0, totalSamples);
+        if (totalSamples <= 0 || sampleRate <= 0.0 || !renderBlock)
+            return false;
+
+        juce::AudioBuffer<float> block(juce::jmax(1, numChannels), blockSize);
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        double lastReportMs = -progressIntervalMs;
+
+        const auto updateProgress = [&]
+        {
+            lastProgress.elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+            const double renderedSeconds = static_cast<double>(lastProgress.samplesRendered) / sampleRate;
+            lastProgress.speedFactor = lastProgress.elapsedSeconds > 0.0 ? renderedSeconds / lastProgress.elapsedSeconds : 0.0;
+        };
+
+        while (lastProgress.samplesRendered < totalSamples)
+        {
+            if (cancelFlag != nullptr && cancelFlag->load(std::memory_order_relaxed))
+                return false;
+
+            const int numSamples = static_cast<int>(juce::jmin<std::int64_t>(blockSize, totalSamples - lastProgress.samplesRendered));
+            block.clear();
+            if (!renderBlock(block, numSamples))
+                return false;
+            if (consumeBlock && !consumeBlock(block, numSamples))
+                return false;
+            lastProgress.samplesRendered += numSamples;
+
+            if (progressCallback)
+            {
+                updateProgress();
+                const double elapsedMs = lastProgress.elapsedSeconds * 1000.0;
+                if (elapsedMs - lastReportMs >= progressIntervalMs)
+                {
+                    lastReportMs = elapsedMs;
+                    progressCallback(lastProgress);
+                }
+            }
+        }
+
+        updateProgress();
+        if (progressCallback)
+            progressCallback(lastProgress);
+        return true;
+    }
+}
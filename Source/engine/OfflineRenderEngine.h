@@ -0,0 +1,82 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "RealtimeGraphScheduler.h"
+
+namespace sampledex
+{
+    struct OfflineRenderSettings
+    {
+        static constexpr int defaultBlockSize = 4096;
+        static constexpr int minBlockSize = 256;
+        static constexpr int maxBlockSize = 8192; // the engine's preallocated work buffers
+
+        int blockSize = defaultBlockSize;
+        int workerCount = 0; // 0 = one per core beside the rendering thread
+        int workerLimit = -1; // caps the resolved count, e.g. to what a small graph can use; -1 = none
+
+        int getResolvedBlockSize() const noexcept;
+        int getResolvedWorkerCount() const noexcept;
+    };
+
+    struct OfflineRenderProgress
+    {
+        std::int64_t samplesRendered = 0;
+        std::int64_t totalSamples = 0;
+        double elapsedSeconds = 0.0;
+        double speedFactor = 0.0; // audio seconds rendered per wall-clock second
+
+        float getFraction() const noexcept
+        {
+            return totalSamples > 0 ? juce::jlimit(0.0f, 1.0f, static_cast<float>(static_cast<double>(samplesRendered)
+                                                                                   / static_cast<double>(totalSamples)))
+                                    : 1.0f;
+        }
+    };
+
+    // Drives a render faster than realtime: large blocks, and the graph scheduler widened
+    // to every core so independent track subgraphs run in parallel for the duration of
+    // the render. The caller supplies one block at a time (normally the engine's own
+    // audio callback with offline mode set, so plugins run non-realtime) and consumes
+    // it (writer, analysis). Runs on the thread that calls render().
+    class OfflineRenderEngine final
+    {
+    public:
+        // Returns false to abort the render.
+        using BlockFn = std::function<bool(juce::AudioBuffer<float>& block, int numSamples)>;
+        using ProgressFn = std::function<void(const OfflineRenderProgress& progress)>;
+
+        OfflineRenderEngine(RealtimeGraphScheduler& schedulerToWiden, const OfflineRenderSettings& settings);
+        ~OfflineRenderEngine();
+
+        int getBlockSize() const noexcept { return blockSize; }
+        int getWorkerCount() const noexcept { return scheduler.getWorkerCount(); }
+
+        // Renders totalSamples in blocks of getBlockSize(). Progress is reported at most
+        // every progressIntervalMs and once at the end. Returns false when cancelled or
+        // when renderBlock/consumeBlock fails.
+        bool render(std::int64_t totalSamples,
+                    double sampleRate,
+                    int numChannels,
+                    const BlockFn& renderBlock,
+                    const BlockFn& consumeBlock,
+                    std::atomic<bool>* cancelFlag = nullptr,
+                    const ProgressFn& progressCallback = {});
+
+        const OfflineRenderProgress& getLastProgress() const noexcept { return lastProgress; }
+
+        static constexpr double progressIntervalMs = 50.0;
+
+    private:
+        RealtimeGraphScheduler& scheduler;
+        const int previousWorkerCount;
+        const int blockSize;
+        OfflineRenderProgress lastProgress;
+
+        JUCE_DECLARE_NON_COPYABLE(OfflineRenderEngine)
+    };
+}
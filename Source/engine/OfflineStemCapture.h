@@ -0,0 +1,182 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Track.h"
+
+namespace sampledex
+{
+    // Taps track (and optionally aux bus) outputs during one offline pass so every stem
+    // is written from the same render instead of one soloed mix per track. The render
+    // thread calls beginBlock(), the engine callback captures post-fader outputs, and the
+    // render thread writes the block to each stem's writer. Stems are pre-master: the
+    // master chain acts on the sum, so master-processed stems still need solo passes.
+    // Track stems can instead tap the plugin chain (render caches).
+    class OfflineStemCapture final
+    {
+    public:
+        enum class TapPoint
+        {
+            PostFader,  // what the track feeds the mix
+            PluginChain // instrument and insert output, before built-in effects, EQ and fader
+        };
+
+        static constexpr int maxTracks = 128;
+        static constexpr int maxBuses = Track::maxSendBuses;
+
+        // Writers keep their own encoder/stream buffers; compressed formats are the
+        // expensive case, so budget for them.
+        static constexpr std::size_t estimatedWriterOverheadBytes = 1u << 20;
+        // Stays well under typical per-process open file limits.
+        static constexpr int maxOpenWriters = 128;
+
+        static std::size_t estimateBytesPerStem(int blockSize, int numChannels = 2) noexcept
+        {
+            return estimatedWriterOverheadBytes
+                 + static_cast<std::size_t>(juce::jmax(1, blockSize)) * static_cast<std::size_t>(juce::jmax(1, numChannels)) * sizeof(float);
+        }
+
+        // How many stems one pass may write at once within memoryBudgetBytes (at least one).
+        static int getMaxStemsPerPass(std::size_t memoryBudgetBytes, int blockSize) noexcept
+        {
+            const auto perStem = estimateBytesPerStem(blockSize);
+            return juce::jlimit(1, maxOpenWriters, static_cast<int>(memoryBudgetBytes / perStem));
+        }
+
+        OfflineStemCapture()
+        {
+            trackStemIndex.fill(-1);
+            busStemIndex.fill(-1);
+        }
+
+        // Message/render thread, before the pass.
+        void addTrackStem(int trackIndex, std::unique_ptr<juce::AudioFormatWriter> writer)
+        {
+            if (juce::isPositiveAndBelow(trackIndex, maxTracks) && writer != nullptr)
+            {
+                trackStemIndex[static_cast<size_t>(trackIndex)] = static_cast<int>(stems.size());
+                stems.push_back({ std::move(writer), {}, 0x51ed270bu ^ static_cast<std::uint32_t>(stems.size() * 0x9e3779b9u) });
+            }
+        }
+
+        void addBusStem(int busIndex, std::unique_ptr<juce::AudioFormatWriter> writer)
+        {
+            if (juce::isPositiveAndBelow(busIndex, maxBuses) && writer != nullptr)
+            {
+                busStemIndex[static_cast<size_t>(busIndex)] = static_cast<int>(stems.size());
+                stems.push_back({ std::move(writer), {}, 0x51ed270bu ^ static_cast<std::uint32_t>(stems.size() * 0x9e3779b9u) });
+            }
+        }
+
+        void prepare(int blockSize, int numChannels = 2)
+        {
+            for (auto& stem : stems)
+                stem.buffer.setSize(juce::jmax(1, numChannels), juce::jmax(1, blockSize), false, true, false);
+        }
+
+        // Before the pass.
+        void setTapPoint(TapPoint newTapPoint) noexcept { tapPoint = newTapPoint; }
+        TapPoint getTapPoint() const noexcept { return tapPoint; }
+
+        int getNumStems() const noexcept { return static_cast<int>(stems.size()); }
+        bool hasTrackStem(int trackIndex) const noexcept { return stemForTrack(trackIndex) != nullptr; }
+        bool hasBusStems() const noexcept
+        {
+            for (const int index : busStemIndex)
+                if (index >= 0)
+                    return true;
+            return false;
+        }
+
+        // Render thread, once per block before the engine callback.
+        void beginBlock(int numSamples) noexcept
+        {
+            for (auto& stem : stems)
+                stem.buffer.clear(0, juce::jmin(numSamples, stem.buffer.getNumSamples()));
+        }
+
+        // Engine callback (render thread or graph mixing). Untapped sources are ignored.
+        void captureTrack(int trackIndex, const juce::AudioBuffer<float>& source, int numSamples) noexcept
+        {
+            if (auto* stem = stemForTrack(trackIndex))
+                copyInto(stem->buffer, source, numSamples);
+        }
+
+        // The buffer a PluginChain tap fills for this block, or nullptr when untapped.
+        juce::AudioBuffer<float>* getTrackBuffer(int trackIndex) noexcept
+        {
+            auto* stem = stemForTrack(trackIndex);
+            return stem != nullptr ? &stem->buffer : nullptr;
+        }
+
+        void captureBus(int busIndex, const juce::AudioBuffer<float>& source, int numSamples) noexcept
+        {
+            if (juce::isPositiveAndBelow(busIndex, maxBuses))
+            {
+                const int index = busStemIndex[static_cast<size_t>(busIndex)];
+                if (index >= 0)
+                    copyInto(stems[static_cast<size_t>(index)].buffer, source, numSamples);
+            }
+        }
+
+        // Render thread, after the engine callback. finish(buffer, numSamples, ditherState)
+        // runs before each write (dither, metering). Returns false when a writer fails.
+        template <typename FinishFn>
+        bool writeBlock(int numSamples, FinishFn&& finish)
+        {
+            for (auto& stem : stems)
+            {
+                finish(stem.buffer, numSamples, stem.ditherState);
+                if (!stem.writer->writeFromAudioSampleBuffer(stem.buffer, 0, numSamples))
+                    return false;
+            }
+            return true;
+        }
+
+        // Flushes and closes every writer.
+        void close() { stems.clear(); }
+
+    private:
+        struct Stem
+        {
+            std::unique_ptr<juce::AudioFormatWriter> writer;
+            juce::AudioBuffer<float> buffer;
+            std::uint32_t ditherState = 0;
+        };
+
+        Stem* stemForTrack(int trackIndex) noexcept
+        {
+            if (!juce::isPositiveAndBelow(trackIndex, maxTracks))
+                return nullptr;
+            const int index = trackStemIndex[static_cast<size_t>(trackIndex)];
+            return index >= 0 ? &stems[static_cast<size_t>(index)] : nullptr;
+        }
+
+        const Stem* stemForTrack(int trackIndex) const noexcept
+        {
+            return const_cast<OfflineStemCapture*>(this)->stemForTrack(trackIndex);
+        }
+
+        static void copyInto(juce::AudioBuffer<float>& dest, const juce::AudioBuffer<float>& source, int numSamples) noexcept
+        {
+            const int samples = juce::jmin(numSamples, dest.getNumSamples(), source.getNumSamples());
+            const int channels = juce::jmin(dest.getNumChannels(), source.getNumChannels());
+            for (int ch = 0; ch < channels; ++ch)
+                dest.copyFrom(ch, 0, source, ch, 0, samples);
+            // A mono source feeds both sides of a stereo stem.
+            if (channels == 1 && dest.getNumChannels() > 1)
+                dest.copyFrom(1, 0, source, 0, 0, samples);
+        }
+
+        std::vector<Stem> stems;
+        std::array<int, maxTracks> trackStemIndex {};
+        std::array<int, maxBuses> busStemIndex {};
+        TapPoint tapPoint = TapPoint::PostFader;
+
+        JUCE_DECLARE_NON_COPYABLE(OfflineStemCapture)
+    };
+}
@@ -0,0 +1,1308 @@
+#include "PluginBridge.h"
+
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <cerrno>
+ #include <fcntl.h>
+ #include <signal.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+ #define SAMPLEDEX_PLUGIN_BRIDGE_SUPPORTED 1
+#else
+ #define SAMPLEDEX_PLUGIN_BRIDGE_SUPPORTED 0
+#endif
+
+#if JUCE_LINUX
+ #include <ctime>
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+#endif
+
+#if JUCE_MAC
+// Darwin's address wait primitive (what libc++ uses for std::atomic::wait). The
+// _SHARED variant keys on the physical page so it works across processes.
+extern "C" int __ulock_wait(std::uint32_t operation, void* address, std::uint64_t value, std::uint32_t timeoutMicroseconds);
+extern "C" int __ulock_wake(std::uint32_t operation, void* address, std::uint64_t wakeValue);
+#endif
+
+namespace sampledex
+{
+    namespace
+    {
+        static_assert(std::atomic<std::uint32_t>::is_always_lock_free,
+                      "Bridge signalling needs address-free 32-bit atomics.");
+
+        using Shared = PluginBridgeShared;
+
+        // Sleeps until word no longer holds expected, the timeout elapses or a spurious
+        // wake happens. Callers always re-check the word.
+        void waitOnWord(std::atomic<std::uint32_t>& word, std::uint32_t expected, int timeoutMicroseconds) noexcept
+        {
+            if (word.load(std::memory_order_acquire) != expected)
+                return;
+
+           #if JUCE_LINUX
+            timespec timeout {};
+            timeout.tv_sec = timeoutMicroseconds / 1000000;
+            timeout.tv_nsec = static_cast<long>(timeoutMicroseconds % 1000000) * 1000L;
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+           #elif JUCE_MAC
+            constexpr std::uint32_t compareAndWaitShared = 3;
+            constexpr std::uint32_t noErrno = 0x01000000;
+            __ulock_wait(compareAndWaitShared | noErrno,
+                         &word,
+                         expected,
+                         static_cast<std::uint32_t>(juce::jmax(1, timeoutMicroseconds)));
+           #else
+            juce::ignoreUnused(timeoutMicroseconds);
+            juce::Thread::sleep(1);
+           #endif
+        }
+
+        void wakeWord(std::atomic<std::uint32_t>& word) noexcept
+        {
+           #if JUCE_LINUX
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+           #elif JUCE_MAC
+            constexpr std::uint32_t compareAndWaitShared = 3;
+            constexpr std::uint32_t wakeAll = 0x00000100;
+            constexpr std::uint32_t noErrno = 0x01000000;
+            __ulock_wake(compareAndWaitShared | wakeAll | noErrno, &word, 0);
+           #else
+            juce::ignoreUnused(word);
+           #endif
+        }
+
+        // Spins briefly (a round trip is usually a few microseconds when the child is
+        // awake), then sleeps on the response word until the deadline.
+        bool awaitResponse(Shared::Channel& channel, std::uint32_t sequence, double timeoutMs) noexcept
+        {
+            for (int spin = 0; spin < 2000; ++spin)
+            {
+                if (channel.responseSequence.load(std::memory_order_acquire) == sequence)
+                    return true;
+            }
+
+            const double deadline = juce::Time::getMillisecondCounterHiRes() + timeoutMs;
+            for (;;)
+            {
+                const auto current = channel.responseSequence.load(std::memory_order_acquire);
+                if (current == sequence)
+                    return true;
+
+                const double remainingMs = deadline - juce::Time::getMillisecondCounterHiRes();
+                if (remainingMs <= 0.0)
+                    return false;
+
+                waitOnWord(channel.responseSequence, current, juce::jmax(1, static_cast<int>(remainingMs * 1000.0)));
+            }
+        }
+
+        void writeErrorText(Shared::Channel& channel, const char* text) noexcept
+        {
+            std::strncpy(channel.errorText, text != nullptr ? text : "", sizeof(channel.errorText) - 1);
+            channel.errorText[sizeof(channel.errorText) - 1] = '\0';
+        }
+
+        juce::String createSharedMemoryName()
+        {
+            static std::atomic<int> counter { 0 };
+            // macOS limits POSIX shared memory names to 31 characters.
+           #if SAMPLEDEX_PLUGIN_BRIDGE_SUPPORTED
+            const auto processId = static_cast<int>(getpid());
+           #else
+            const int processId = 0;
+           #endif
+            return "/sdxb-" + juce::String(processId) + "-" + juce::String(++counter);
+        }
+    }
+
+    juce::String PluginBridgeInfo::toXmlString() const
+    {
+        juce::XmlElement root("PLUGINBRIDGEINFO");
+        root.setAttribute("mainInputs", mainInputChannels);
+        root.setAttribute("mainOutputs", mainOutputChannels);
+        root.setAttribute("acceptsMidi", acceptsMidi);
+        root.setAttribute("producesMidi", producesMidi);
+        root.setAttribute("tailSeconds", tailSeconds);
+        root.setAttribute("latency", latencySamples);
+        for (const auto& parameter : parameters)
+        {
+            auto* element = root.createNewChildElement("PARAM");
+            element->setAttribute("name", parameter.name);
+            element->setAttribute("label", parameter.label);
+            element->setAttribute("default", static_cast<double>(parameter.defaultValue));
+            element->setAttribute("value", static_cast<double>(parameter.value));
+            element->setAttribute("steps", parameter.numSteps);
+            element->setAttribute("discrete", parameter.discrete);
+            element->setAttribute("boolean", parameter.boolean);
+            element->setAttribute("automatable", parameter.automatable);
+        }
+        return root.toString(juce::XmlElement::TextFormat().withoutHeader().singleLine());
+    }
+
+    bool PluginBridgeInfo::fromXmlString(const juce::String& text, PluginBridgeInfo& info)
+    {
+        const auto root = juce::parseXML(text);
+        if (root == nullptr || !root->hasTagName("PLUGINBRIDGEINFO"))
+            return false;
+
+        info = {};
+        info.mainInputChannels = juce::jlimit(0, PluginBridgeShared::maxAudioChannels, root->getIntAttribute("mainInputs"));
+        info.mainOutputChannels = juce::jlimit(0, PluginBridgeShared::maxAudioChannels, root->getIntAttribute("mainOutputs"));
+        info.acceptsMidi = root->getBoolAttribute("acceptsMidi");
+        info.producesMidi = root->getBoolAttribute("producesMidi");
+        info.tailSeconds = juce::jmax(0.0, root->getDoubleAttribute("tailSeconds"));
+        info.latencySamples = juce::jmax(0, root->getIntAttribute("latency"));
+        for (const auto* element : root->getChildWithTagNameIterator("PARAM"))
+        {
+            Parameter parameter;
+            parameter.name = element->getStringAttribute("name");
+            parameter.label = element->getStringAttribute("label");
+            parameter.defaultValue = juce::jlimit(0.0f, 1.0f, static_cast<float>(element->getDoubleAttribute("default")));
+            parameter.value = juce::jlimit(0.0f, 1.0f, static_cast<float>(element->getDoubleAttribute("value")));
+            parameter.numSteps = juce::jmax(1, element->getIntAttribute("steps", parameter.numSteps));
+            parameter.discrete = element->getBoolAttribute("discrete");
+            parameter.boolean = element->getBoolAttribute("boolean");
+            parameter.automatable = element->getBoolAttribute("automatable", true);
+            info.parameters.push_back(std::move(parameter));
+        }
+        return true;
+    }
+
+    PluginBridgeInfo PluginBridgeInfo::fromProcessor(juce::AudioProcessor& processor)
+    {
+        PluginBridgeInfo info;
+        info.mainInputChannels = processor.getMainBusNumInputChannels();
+        info.mainOutputChannels = processor.getMainBusNumOutputChannels();
+        info.acceptsMidi = processor.acceptsMidi();
+        info.producesMidi = processor.producesMidi();
+        info.tailSeconds = processor.getTailLengthSeconds();
+        info.latencySamples = processor.getLatencySamples();
+        for (auto* source : processor.getParameters())
+        {
+            Parameter parameter;
+            parameter.name = source->getName(128);
+            parameter.label = source->getLabel();
+            parameter.defaultValue = source->getDefaultValue();
+            parameter.value = source->getValue();
+            parameter.numSteps = source->getNumSteps();
+            parameter.discrete = source->isDiscrete();
+            parameter.boolean = source->isBoolean();
+            parameter.automatable = source->isAutomatable();
+            info.parameters.push_back(std::move(parameter));
+        }
+        return info;
+    }
+
+    //==============================================================================
+    struct PluginBridgeClient::SharedMapping
+    {
+        juce::String name;
+        Shared* shared = nullptr;
+        size_t size = 0;
+        bool ownsName = false;
+
+        ~SharedMapping()
+        {
+           #if SAMPLEDEX_PLUGIN_BRIDGE_SUPPORTED
+            if (shared != nullptr)
+            {
+                shared->~PluginBridgeShared();
+                munmap(shared, size);
+            }
+           #endif
+            unlinkName();
+        }
+
+        void unlinkName()
+        {
+           #if SAMPLEDEX_PLUGIN_BRIDGE_SUPPORTED
+            if (ownsName)
+                shm_unlink(name.toRawUTF8());
+           #endif
+            ownsName = false;
+        }
+
+        static std::unique_ptr<SharedMapping> create(const juce::String& name, int audioChannels, juce::String& errorText)
+        {
+           #if SAMPLEDEX_PLUGIN_BRIDGE_SUPPORTED
+            const int fd = shm_open(name.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+            if (fd < 0)
+            {
+                errorText = "Unable to create bridge shared memory: " + juce::String(std::strerror(errno));
+                return {};
+            }
+
+            auto mapping = std::make_unique<SharedMapping>();
+            mapping->name = name;
+            mapping->size = Shared::getMappingSize(audioChannels);
+            mapping->ownsName = true;
+            if (ftruncate(fd, static_cast<off_t>(mapping->size)) != 0)
+            {
+                errorText = "Unable to size bridge shared memory: " + juce::String(std::strerror(errno));
+                close(fd);
+                return {};
+            }
+
+            void* address = mmap(nullptr, mapping->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (address == MAP_FAILED)
+            {
+                errorText = "Unable to map bridge shared memory: " + juce::String(std::strerror(errno));
+                return {};
+            }
+
+            mapping->shared = new (address) Shared();
+            mapping->shared->audioChannelCapacity = audioChannels;
+            return mapping;
+           #else
+            juce::ignoreUnused(name, audioChannels);
+            errorText = "Sandboxed plugin hosting is not supported on this platform.";
+            return {};
+           #endif
+        }
+    };
+
+    //==============================================================================
+    PluginBridgeClient::PluginBridgeClient() = default;
+
+    PluginBridgeClient::~PluginBridgeClient()
+    {
+        shutdown();
+    }
+
+    bool PluginBridgeClient::isSupportedOnThisPlatform() noexcept
+    {
+        return SAMPLEDEX_PLUGIN_BRIDGE_SUPPORTED != 0;
+    }
+
+    bool PluginBridgeClient::launch(const juce::File& hostExecutable,
+                                    const juce::PluginDescription& description,
+                                    const PluginBridgeConfig& config,
+                                    juce::String& errorText)
+    {
+        shutdown();
+
+        if (!isSupportedOnThisPlatform())
+        {
+            errorText = "Sandboxed plugin hosting is not supported on this platform.";
+            return false;
+        }
+
+        // Room for every channel the plugin declares; the child runs any further
+        // channels of its own layout on silent scratch buffers.
+        const int audioChannels = juce::jlimit(1,
+                                               Shared::maxAudioChannels,
+                                               juce::jmax(config.numChannels,
+                                                          description.numInputChannels,
+                                                          description.numOutputChannels));
+        mapping = SharedMapping::create(createSharedMemoryName(), audioChannels, errorText);
+        if (mapping == nullptr)
+            return false;
+
+        auto& shared = *mapping->shared;
+        shared.magic = Shared::magicValue;
+        shared.version = Shared::layoutVersion;
+       #if SAMPLEDEX_PLUGIN_BRIDGE_SUPPORTED
+        shared.hostProcessId = static_cast<std::int64_t>(getpid());
+       #endif
+        shared.sampleRate = config.sampleRate > 0.0 ? config.sampleRate : 44100.0;
+        shared.blockSize = juce::jlimit(1, Shared::maxBlockSamples, config.blockSize);
+
+        std::unique_ptr<juce::XmlElement> descriptionXml(description.createXml());
+        const auto descriptionText = descriptionXml != nullptr ? descriptionXml->toString() : juce::String();
+        const auto descriptionBytes = static_cast<int>(descriptionText.getNumBytesAsUTF8());
+        if (descriptionBytes <= 0 || descriptionBytes >= Shared::payloadChunkBytes)
+        {
+            errorText = "Plugin description could not be sent to the sandboxed host.";
+            mapping.reset();
+            return false;
+        }
+        std::memcpy(shared.payload, descriptionText.toRawUTF8(), static_cast<size_t>(descriptionBytes));
+        shared.payloadBytes = descriptionBytes;
+        shared.payloadOffset = 0;
+        shared.payloadTotalBytes = descriptionBytes;
+
+        childProcess = std::make_unique<juce::ChildProcess>();
+        const juce::StringArray arguments { hostExecutable.getFullPathName(),
+                                            "--plugin-bridge-host=" + mapping->name };
+        if (!childProcess->start(arguments, 0))
+        {
+            errorText = "Unable to start the sandboxed plugin host process.";
+            childProcess.reset();
+            mapping.reset();
+            return false;
+        }
+
+        const auto starting = static_cast<std::uint32_t>(Shared::ChildState::Starting);
+        const double deadline = juce::Time::getMillisecondCounterHiRes() + static_cast<double>(config.launchTimeoutMs);
+        while (shared.childState.load(std::memory_order_acquire) == starting
+               && juce::Time::getMillisecondCounterHiRes() < deadline
+               && childProcess->isRunning())
+        {
+            waitOnWord(shared.childState, starting, 20000);
+        }
+
+        // Both sides have it mapped now; nothing is left behind in /dev/shm if either dies.
+        mapping->unlinkName();
+
+        if (shared.childState.load(std::memory_order_acquire) != static_cast<std::uint32_t>(Shared::ChildState::Ready))
+        {
+            errorText = shared.control.errorText[0] != '\0'
+                ? juce::String::fromUTF8(shared.control.errorText)
+                : juce::String("Sandboxed plugin host exited during startup.");
+            shutdown();
+            return false;
+        }
+
+        processSequence = shared.process.responseSequence.load(std::memory_order_acquire);
+        controlSequence = shared.control.responseSequence.load(std::memory_order_acquire);
+        processTimeoutMarginMs = juce::jmax(1.0, config.processTimeoutMarginMs);
+        lastSentParameterValues.clear();
+        failed.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool PluginBridgeClient::isRunning() const noexcept
+    {
+        return mapping != nullptr
+            && childProcess != nullptr
+            && !failed.load(std::memory_order_relaxed);
+    }
+
+    void PluginBridgeClient::shutdown()
+    {
+        if (mapping != nullptr && childProcess != nullptr && !failed.load(std::memory_order_relaxed))
+        {
+            juce::String ignored;
+            sendControlCommand(Shared::Command::Shutdown, ignored);
+        }
+
+        if (childProcess != nullptr)
+        {
+            if (!childProcess->waitForProcessToFinish(1000))
+                childProcess->kill();
+            childProcess.reset();
+        }
+
+        mapping.reset();
+        lastSentParameterValues.clear();
+    }
+
+    bool PluginBridgeClient::sendControlCommand(Shared::Command command, juce::String& errorText)
+    {
+        if (mapping == nullptr || failed.load(std::memory_order_relaxed))
+        {
+            errorText = "Sandboxed plugin host is not running.";
+            return false;
+        }
+
+        auto& channel = mapping->shared->control;
+        channel.command = command;
+        channel.ok = 0;
+        channel.errorText[0] = '\0';
+        const auto sequence = ++controlSequence;
+        channel.requestSequence.store(sequence, std::memory_order_release);
+        wakeWord(channel.requestSequence);
+
+        // State calls on large plugins can legitimately take a while.
+        if (!awaitResponse(channel, sequence, 10000))
+        {
+            failed.store(true, std::memory_order_relaxed);
+            errorText = "Sandboxed plugin host stopped responding.";
+            return false;
+        }
+
+        if (channel.ok == 0)
+        {
+            errorText = juce::String::fromUTF8(channel.errorText);
+            return false;
+        }
+        return true;
+    }
+
+    bool PluginBridgeClient::readPayload(Shared::Command command, juce::MemoryBlock& destination, juce::String& errorText)
+    {
+        if (!sendControlCommand(command, errorText))
+            return false;
+
+        auto& shared = *mapping->shared;
+        const auto totalBytes = shared.payloadTotalBytes;
+        if (totalBytes < 0 || totalBytes > static_cast<std::int64_t>(std::numeric_limits<int>::max()))
+        {
+            errorText = "Sandboxed plugin host sent an invalid transfer size.";
+            return false;
+        }
+
+        destination.setSize(static_cast<size_t>(totalBytes));
+        std::int64_t received = 0;
+        for (;;)
+        {
+            const auto chunkBytes = static_cast<std::int64_t>(juce::jlimit(0, Shared::payloadChunkBytes, shared.payloadBytes));
+            if (shared.payloadOffset != received || received + chunkBytes > totalBytes)
+            {
+                errorText = "Sandboxed plugin host sent an out-of-order transfer chunk.";
+                return false;
+            }
+
+            std::memcpy(static_cast<char*>(destination.getData()) + received, shared.payload, static_cast<size_t>(chunkBytes));
+            received += chunkBytes;
+            if (received == totalBytes)
+                return true;
+            if (chunkBytes == 0)
+            {
+                errorText = "Sandboxed plugin host ended a transfer early.";
+                return false;
+            }
+
+            shared.payloadOffset = received;
+            if (!sendControlCommand(Shared::Command::ReadPayload, errorText))
+                return false;
+        }
+    }
+
+    void PluginBridgeClient::appendParameterChanges(juce::AudioProcessor& parameterSource) noexcept
+    {
+        auto& shared = *mapping->shared;
+        const auto& parameters = parameterSource.getParameters();
+        if (static_cast<int>(lastSentParameterValues.size()) != parameters.size())
+            return;
+
+        int changes = 0;
+        for (int i = 0; i < parameters.size() && changes < Shared::maxParameterChanges; ++i)
+        {
+            const float value = parameters.getUnchecked(i)->getValue();
+            auto& lastSent = lastSentParameterValues[static_cast<size_t>(i)];
+            if (value == lastSent)
+                continue;
+
+            shared.parameterChanges[changes].index = i;
+            shared.parameterChanges[changes].value = value;
+            lastSent = value;
+            ++changes;
+        }
+        shared.numParameterChanges = changes;
+    }
+
+    PluginBridgeClient::ProcessResult PluginBridgeClient::process(juce::AudioBuffer<float>& buffer,
+                                                                 juce::MidiBuffer& midi,
+                                                                 int numSamples,
+                                                                 juce::AudioProcessor* parameterSource) noexcept
+    {
+        if (mapping == nullptr || failed.load(std::memory_order_relaxed))
+            return ProcessResult::notRunning;
+        if (numSamples <= 0 || numSamples > Shared::maxBlockSamples || numSamples > buffer.getNumSamples())
+            return ProcessResult::blockTooLarge;
+
+        auto& shared = *mapping->shared;
+        const int channels = juce::jmin(buffer.getNumChannels(), shared.audioChannelCapacity);
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            std::memcpy(shared.getAudioChannel(ch),
+                        buffer.getReadPointer(ch),
+                        static_cast<size_t>(numSamples) * sizeof(float));
+        }
+        shared.numChannels = channels;
+        shared.numSamples = numSamples;
+
+        int midiCount = 0;
+        for (const auto metadata : midi)
+        {
+            if (midiCount >= Shared::maxMidiEvents)
+                break;
+            if (metadata.numBytes <= 0 || metadata.numBytes > Shared::maxMidiEventBytes)
+                continue;
+
+            auto& event = shared.midiIn[midiCount++];
+            event.sampleOffset = metadata.samplePosition;
+            event.size = static_cast<std::uint16_t>(metadata.numBytes);
+            std::memcpy(event.bytes, metadata.data, static_cast<size_t>(metadata.numBytes));
+        }
+        shared.numMidiIn = midiCount;
+        shared.numMidiOut = 0;
+
+        shared.numParameterChanges = 0;
+        if (parameterSource != nullptr)
+            appendParameterChanges(*parameterSource);
+
+        auto& channel = shared.process;
+        channel.command = Shared::Command::Process;
+        channel.ok = 0;
+        channel.errorText[0] = '\0';
+        const auto sequence = ++processSequence;
+        channel.requestSequence.store(sequence, std::memory_order_release);
+        wakeWord(channel.requestSequence);
+
+        const double blockMs = 1000.0 * static_cast<double>(numSamples) / shared.sampleRate;
+        if (!awaitResponse(channel, sequence, blockMs + processTimeoutMarginMs))
+        {
+            // A late answer would desynchronise the sequence numbers; give up on this child.
+            failed.store(true, std::memory_order_relaxed);
+            return ProcessResult::missedDeadline;
+        }
+
+        if (channel.ok == 0)
+            return ProcessResult::pluginFailed;
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            std::memcpy(buffer.getWritePointer(ch),
+                        shared.getAudioChannel(ch),
+                        static_cast<size_t>(numSamples) * sizeof(float));
+        }
+
+        midi.clear();
+        const int midiOut = juce::jlimit(0, Shared::maxMidiEvents, shared.numMidiOut);
+        for (int i = 0; i < midiOut; ++i)
+        {
+            const auto& event = shared.midiOut[i];
+            midi.addEvent(event.bytes, juce::jlimit(0, Shared::maxMidiEventBytes, static_cast<int>(event.size)), event.sampleOffset);
+        }
+        return ProcessResult::ok;
+    }
+
+    const char* PluginBridgeClient::getFailureText(ProcessResult result) const noexcept
+    {
+        switch (result)
+        {
+            case ProcessResult::ok: return "";
+            case ProcessResult::notRunning: return "Sandboxed plugin host is not running.";
+            case ProcessResult::blockTooLarge: return "Block size exceeds the sandboxed host buffer.";
+            case ProcessResult::missedDeadline: return "Sandboxed plugin host missed its block deadline.";
+            case ProcessResult::pluginFailed:
+                if (mapping != nullptr && mapping->shared->process.errorText[0] != '\0')
+                    return mapping->shared->process.errorText;
+                return "Sandboxed plugin failed to process the block.";
+        }
+        return "Bridge process failure.";
+    }
+
+    bool PluginBridgeClient::prepare(double sampleRate, int blockSize, juce::String& errorText)
+    {
+        if (mapping == nullptr)
+        {
+            errorText = "Sandboxed plugin host is not running.";
+            return false;
+        }
+
+        mapping->shared->sampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+        mapping->shared->blockSize = juce::jlimit(1, Shared::maxBlockSamples, blockSize);
+        return sendControlCommand(Shared::Command::Prepare, errorText);
+    }
+
+    bool PluginBridgeClient::release(juce::String& errorText)
+    {
+        return sendControlCommand(Shared::Command::Release, errorText);
+    }
+
+    bool PluginBridgeClient::getState(juce::MemoryBlock& state, juce::String& errorText)
+    {
+        return readPayload(Shared::Command::GetState, state, errorText);
+    }
+
+    bool PluginBridgeClient::setState(const void* data, size_t numBytes, juce::String& errorText)
+    {
+        if (mapping == nullptr)
+        {
+            errorText = "Sandboxed plugin host is not running.";
+            return false;
+        }
+        if (numBytes > static_cast<size_t>(std::numeric_limits<int>::max()))
+        {
+            errorText = "Plugin state is too large to restore.";
+            return false;
+        }
+
+        // Sent in chunks; the child applies the state once the last one arrived. An
+        // empty state is still one (empty) chunk.
+        auto& shared = *mapping->shared;
+        const auto totalBytes = static_cast<std::int64_t>(numBytes);
+        std::int64_t sent = 0;
+        do
+        {
+            const auto chunkBytes = juce::jmin(totalBytes - sent, static_cast<std::int64_t>(Shared::payloadChunkBytes));
+            if (chunkBytes > 0)
+                std::memcpy(shared.payload, static_cast<const char*>(data) + sent, static_cast<size_t>(chunkBytes));
+            shared.payloadOffset = sent;
+            shared.payloadTotalBytes = totalBytes;
+            shared.payloadBytes = static_cast<std::int32_t>(chunkBytes);
+            if (!sendControlCommand(Shared::Command::SetState, errorText))
+                return false;
+            sent += chunkBytes;
+        }
+        while (sent < totalBytes);
+        return true;
+    }
+
+    bool PluginBridgeClient::getPluginInfo(PluginBridgeInfo& info, juce::String& errorText)
+    {
+        juce::MemoryBlock text;
+        if (!readPayload(Shared::Command::GetPluginInfo, text, errorText))
+            return false;
+
+        if (!PluginBridgeInfo::fromXmlString(text.toString(), info))
+        {
+            errorText = "Sandboxed plugin host sent unreadable plugin info.";
+            return false;
+        }
+        return true;
+    }
+
+    void PluginBridgeClient::resyncParameters(juce::AudioProcessor& parameterSource)
+    {
+        const auto& parameters = parameterSource.getParameters();
+        lastSentParameterValues.resize(static_cast<size_t>(parameters.size()));
+        for (int i = 0; i < parameters.size(); ++i)
+            lastSentParameterValues[static_cast<size_t>(i)] = parameters.getUnchecked(i)->getValue();
+    }
+
+    int PluginBridgeClient::getLatencySamples() const noexcept
+    {
+        return mapping != nullptr ? juce::jmax(0, mapping->shared->latencySamples.load(std::memory_order_relaxed)) : 0;
+    }
+
+    int PluginBridgeClient::getNumChannels() const noexcept
+    {
+        return mapping != nullptr ? mapping->shared->audioChannelCapacity : 0;
+    }
+
+    //==============================================================================
+    namespace
+    {
+        bool isHostAlive(std::int64_t hostProcessId) noexcept
+        {
+           #if SAMPLEDEX_PLUGIN_BRIDGE_SUPPORTED
+            if (hostProcessId <= 0)
+                return true;
+            return kill(static_cast<pid_t>(hostProcessId), 0) == 0 || errno == EPERM;
+           #else
+            juce::ignoreUnused(hostProcessId);
+            return false;
+           #endif
+        }
+
+        struct AttachedMemory
+        {
+            Shared* shared = nullptr;
+            size_t size = 0;
+        };
+
+        // Child side: attaches to the block the engine created. Its size comes from
+        // the file, since the audio area depends on the negotiated channel count.
+        AttachedMemory attachSharedMemory(const juce::String& name)
+        {
+           #if SAMPLEDEX_PLUGIN_BRIDGE_SUPPORTED
+            const int fd = shm_open(name.toRawUTF8(), O_RDWR, S_IRUSR | S_IWUSR);
+            if (fd < 0)
+                return {};
+
+            struct stat info {};
+            if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < Shared::getMappingSize(1))
+            {
+                close(fd);
+                return {};
+            }
+
+            const auto size = static_cast<size_t>(info.st_size);
+            void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (address == MAP_FAILED)
+                return {};
+            return { static_cast<Shared*>(address), size };
+           #else
+            juce::ignoreUnused(name);
+            return {};
+           #endif
+        }
+
+        class BridgeServerThread final : public juce::Thread
+        {
+        public:
+            BridgeServerThread(const juce::String& threadName,
+                               Shared& sharedState,
+                               Shared::Channel& servedChannel,
+                               juce::AudioProcessor& hostedProcessor,
+                               std::atomic<bool>& stopFlag)
+                : juce::Thread(threadName),
+                  shared(sharedState),
+                  channel(servedChannel),
+                  processor(hostedProcessor),
+                  stopRequested(stopFlag)
+            {
+                const int processorChannels = juce::jmax(processor.getTotalNumInputChannels(),
+                                                         processor.getTotalNumOutputChannels());
+                scratchAudio.setSize(juce::jmax(1, processorChannels), Shared::maxBlockSamples);
+                channelPointers.resize(static_cast<size_t>(juce::jmax(processorChannels, shared.audioChannelCapacity)));
+                scratchMidi.ensureSize(static_cast<size_t>(Shared::maxMidiEvents) * 16u);
+            }
+
+            void run() override
+            {
+                auto seen = channel.requestSequence.load(std::memory_order_acquire);
+                while (!threadShouldExit() && !stopRequested.load(std::memory_order_relaxed))
+                {
+                    waitOnWord(channel.requestSequence, seen, 250000);
+                    const auto request = channel.requestSequence.load(std::memory_order_acquire);
+                    if (request == seen)
+                    {
+                        if (!isHostAlive(shared.hostProcessId))
+                            requestStop();
+                        continue;
+                    }
+
+                    seen = request;
+                    channel.ok = handle(channel.command) ? 1 : 0;
+                    channel.responseSequence.store(request, std::memory_order_release);
+                    wakeWord(channel.responseSequence);
+
+                    if (channel.command == Shared::Command::Shutdown)
+                        requestStop();
+                }
+            }
+
+            void requestStop()
+            {
+                stopRequested.store(true, std::memory_order_relaxed);
+                if (auto* messageManager = juce::MessageManager::getInstanceWithoutCreating())
+                    messageManager->stopDispatchLoop();
+            }
+
+        private:
+            bool handle(Shared::Command command)
+            {
+                try
+                {
+                    switch (command)
+                    {
+                        case Shared::Command::Process: return processBlock();
+                        case Shared::Command::Prepare:
+                        {
+                            const juce::ScopedLock callbackLock(processor.getCallbackLock());
+                            processor.setRateAndBufferSizeDetails(shared.sampleRate, shared.blockSize);
+                            processor.prepareToPlay(shared.sampleRate, shared.blockSize);
+                            shared.latencySamples.store(processor.getLatencySamples(), std::memory_order_relaxed);
+                            return true;
+                        }
+                        case Shared::Command::Release:
+                        {
+                            const juce::ScopedLock callbackLock(processor.getCallbackLock());
+                            processor.releaseResources();
+                            return true;
+                        }
+                        case Shared::Command::GetState:
+                            outgoing.reset();
+                            processor.getStateInformation(outgoing);
+                            return sendOutgoingChunk(0);
+                        case Shared::Command::GetPluginInfo:
+                        {
+                            const auto text = PluginBridgeInfo::fromProcessor(processor).toXmlString();
+                            outgoing.replaceAll(text.toRawUTF8(), text.getNumBytesAsUTF8());
+                            return sendOutgoingChunk(0);
+                        }
+                        case Shared::Command::ReadPayload:
+                            return sendOutgoingChunk(shared.payloadOffset);
+                        case Shared::Command::SetState:
+                            return receiveStateChunk();
+                        case Shared::Command::Shutdown:
+                            return true;
+                        case Shared::Command::None:
+                        default:
+                            break;
+                    }
+                }
+                catch (const std::exception& exception)
+                {
+                    writeErrorText(channel, exception.what());
+                    return false;
+                }
+                catch (...)
+                {
+                    writeErrorText(channel, "Plugin threw an unknown exception.");
+                    return false;
+                }
+
+                writeErrorText(channel, "Unsupported bridge command.");
+                return false;
+            }
+
+            bool sendOutgoingChunk(std::int64_t offset)
+            {
+                const auto totalBytes = static_cast<std::int64_t>(outgoing.getSize());
+                if (offset < 0 || offset > totalBytes)
+                {
+                    writeErrorText(channel, "Transfer chunk requested outside the payload.");
+                    return false;
+                }
+
+                const auto chunkBytes = juce::jmin(totalBytes - offset, static_cast<std::int64_t>(Shared::payloadChunkBytes));
+                if (chunkBytes > 0)
+                    std::memcpy(shared.payload, static_cast<const char*>(outgoing.getData()) + offset, static_cast<size_t>(chunkBytes));
+                shared.payloadOffset = offset;
+                shared.payloadTotalBytes = totalBytes;
+                shared.payloadBytes = static_cast<std::int32_t>(chunkBytes);
+                if (offset + chunkBytes == totalBytes)
+                    outgoing.reset();
+                return true;
+            }
+
+            bool receiveStateChunk()
+            {
+                const auto offset = shared.payloadOffset;
+                const auto totalBytes = shared.payloadTotalBytes;
+                const auto chunkBytes = static_cast<std::int64_t>(juce::jlimit(0, Shared::payloadChunkBytes, shared.payloadBytes));
+                if (offset == 0)
+                {
+                    incoming.setSize(static_cast<size_t>(juce::jmax<std::int64_t>(0, totalBytes)));
+                    incomingBytes = 0;
+                }
+
+                if (totalBytes < 0
+                    || offset != incomingBytes
+                    || static_cast<std::int64_t>(incoming.getSize()) != totalBytes
+                    || offset + chunkBytes > totalBytes)
+                {
+                    incoming.reset();
+                    incomingBytes = 0;
+                    writeErrorText(channel, "Plugin state arrived out of order.");
+                    return false;
+                }
+
+                if (chunkBytes > 0)
+                    std::memcpy(static_cast<char*>(incoming.getData()) + offset, shared.payload, static_cast<size_t>(chunkBytes));
+                incomingBytes += chunkBytes;
+                if (incomingBytes < totalBytes)
+                    return true;
+
+                processor.setStateInformation(incoming.getData(), static_cast<int>(incoming.getSize()));
+                shared.latencySamples.store(processor.getLatencySamples(), std::memory_order_relaxed);
+                incoming.reset();
+                incomingBytes = 0;
+                return true;
+            }
+
+            bool processBlock()
+            {
+                const int numSamples = juce::jlimit(0, Shared::maxBlockSamples, shared.numSamples);
+                const int sharedChannels = juce::jlimit(0, shared.audioChannelCapacity, shared.numChannels);
+                const int processorChannels = juce::jmin(scratchAudio.getNumChannels(),
+                                                         juce::jmax(processor.getTotalNumInputChannels(),
+                                                                    processor.getTotalNumOutputChannels()));
+                const int totalChannels = juce::jmin(static_cast<int>(channelPointers.size()),
+                                                     juce::jmax(sharedChannels, processorChannels));
+
+                // The block is processed in place in shared memory; channels the engine did
+                // not send come from preallocated scratch.
+                for (int ch = 0; ch < totalChannels; ++ch)
+                {
+                    if (ch < sharedChannels)
+                    {
+                        channelPointers[static_cast<size_t>(ch)] = shared.getAudioChannel(ch);
+                    }
+                    else
+                    {
+                        channelPointers[static_cast<size_t>(ch)] = scratchAudio.getWritePointer(ch);
+                        juce::FloatVectorOperations::clear(channelPointers[static_cast<size_t>(ch)], numSamples);
+                    }
+                }
+                juce::AudioBuffer<float> block(channelPointers.data(), totalChannels, numSamples);
+
+                scratchMidi.clear();
+                const int midiIn = juce::jlimit(0, Shared::maxMidiEvents, shared.numMidiIn);
+                for (int i = 0; i < midiIn; ++i)
+                {
+                    const auto& event = shared.midiIn[i];
+                    scratchMidi.addEvent(event.bytes,
+                                         juce::jlimit(0, Shared::maxMidiEventBytes, static_cast<int>(event.size)),
+                                         juce::jlimit(0, juce::jmax(0, numSamples - 1), static_cast<int>(event.sampleOffset)));
+                }
+
+                const auto& parameters = processor.getParameters();
+                const int changes = juce::jlimit(0, Shared::maxParameterChanges, shared.numParameterChanges);
+                for (int i = 0; i < changes; ++i)
+                {
+                    const auto& change = shared.parameterChanges[i];
+                    if (juce::isPositiveAndBelow(static_cast<int>(change.index), parameters.size()))
+                        parameters.getUnchecked(change.index)->setValue(change.value);
+                }
+
+                {
+                    const juce::ScopedLock callbackLock(processor.getCallbackLock());
+                    processor.processBlock(block, scratchMidi);
+                }
+
+                int midiOut = 0;
+                for (const auto metadata : scratchMidi)
+                {
+                    if (midiOut >= Shared::maxMidiEvents)
+                        break;
+                    if (metadata.numBytes <= 0 || metadata.numBytes > Shared::maxMidiEventBytes)
+                        continue;
+                    auto& event = shared.midiOut[midiOut++];
+                    event.sampleOffset = metadata.samplePosition;
+                    event.size = static_cast<std::uint16_t>(metadata.numBytes);
+                    std::memcpy(event.bytes, metadata.data, static_cast<size_t>(metadata.numBytes));
+                }
+                shared.numMidiOut = midiOut;
+                shared.latencySamples.store(processor.getLatencySamples(), std::memory_order_relaxed);
+                return true;
+            }
+
+            Shared& shared;
+            Shared::Channel& channel;
+            juce::AudioProcessor& processor;
+            std::atomic<bool>& stopRequested;
+            juce::AudioBuffer<float> scratchAudio;
+            juce::MidiBuffer scratchMidi;
+            std::vector<float*> channelPointers;
+            // Control thread only: the answer being read out and the state being received.
+            juce::MemoryBlock outgoing;
+            juce::MemoryBlock incoming;
+            std::int64_t incomingBytes = 0;
+        };
+    }
+
+    int PluginBridgeServer::run(const juce::String& sharedMemoryName, ProcessorFactory factory)
+    {
+        if (!PluginBridgeClient::isSupportedOnThisPlatform())
+            return 3;
+
+        const auto attached = attachSharedMemory(sharedMemoryName);
+        if (attached.shared == nullptr)
+            return 2;
+
+        auto& shared = *attached.shared;
+        const auto detach = [attached]
+        {
+           #if SAMPLEDEX_PLUGIN_BRIDGE_SUPPORTED
+            munmap(attached.shared, attached.size);
+           #endif
+        };
+
+        if (shared.magic != Shared::magicValue
+            || shared.version != Shared::layoutVersion
+            || shared.audioChannelCapacity <= 0
+            || shared.audioChannelCapacity > Shared::maxAudioChannels
+            || attached.size < Shared::getMappingSize(shared.audioChannelCapacity))
+        {
+            detach();
+            return 2;
+        }
+
+        juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+        const auto fail = [&](const juce::String& reason)
+        {
+            writeErrorText(shared.control, reason.toRawUTF8());
+            shared.childState.store(static_cast<std::uint32_t>(Shared::ChildState::Failed), std::memory_order_release);
+            wakeWord(shared.childState);
+            detach();
+            return 2;
+        };
+
+        const auto descriptionText = juce::String::fromUTF8(shared.payload,
+                                                            juce::jlimit(0, Shared::payloadChunkBytes, shared.payloadBytes));
+        juce::PluginDescription description;
+        const auto descriptionXml = juce::parseXML(descriptionText);
+        if (descriptionXml == nullptr || !description.loadFromXml(*descriptionXml))
+            return fail("Sandboxed host received an unreadable plugin description.");
+
+        juce::String errorText;
+        auto processor = factory != nullptr
+            ? factory(description, shared.sampleRate, shared.blockSize, errorText)
+            : nullptr;
+        if (processor == nullptr)
+            return fail(errorText.isNotEmpty() ? errorText : juce::String("Sandboxed host could not create the plugin."));
+
+        // The plugin keeps its own bus layout; the engine sends the channels that fit
+        // the shared audio area and scratch covers the rest.
+        processor->setRateAndBufferSizeDetails(shared.sampleRate, shared.blockSize);
+        processor->prepareToPlay(shared.sampleRate, shared.blockSize);
+        processor->setNonRealtime(false);
+        shared.latencySamples.store(processor->getLatencySamples(), std::memory_order_relaxed);
+
+        std::atomic<bool> stopRequested { false };
+        BridgeServerThread processThread("Plugin Bridge Audio", shared, shared.process, *processor, stopRequested);
+        BridgeServerThread controlThread("Plugin Bridge Control", shared, shared.control, *processor, stopRequested);
+        processThread.startRealtimeThread(juce::Thread::RealtimeOptions{});
+        controlThread.startThread();
+
+        shared.childState.store(static_cast<std::uint32_t>(Shared::ChildState::Ready), std::memory_order_release);
+        wakeWord(shared.childState);
+
+        // Plugins expect a live message loop on the thread that created them.
+        juce::MessageManager::getInstance()->runDispatchLoop();
+
+        stopRequested.store(true, std::memory_order_relaxed);
+        wakeWord(shared.process.requestSequence);
+        wakeWord(shared.control.requestSequence);
+        processThread.stopThread(2000);
+        controlThread.stopThread(2000);
+
+        processor->releaseResources();
+        processor.reset();
+
+        shared.childState.store(static_cast<std::uint32_t>(Shared::ChildState::Exited), std::memory_order_release);
+        wakeWord(shared.childState);
+        detach();
+        return 0;
+    }
+
+    PluginBridgeServer::ProcessorFactory PluginBridgeServer::createDefaultFactory()
+    {
+        return [](const juce::PluginDescription& description,
+                  double sampleRate,
+                  int blockSize,
+                  juce::String& errorText) -> std::unique_ptr<juce::AudioProcessor>
+        {
+            static juce::AudioPluginFormatManager formatManager;
+            if (formatManager.getNumFormats() == 0)
+                formatManager.addDefaultFormats();
+
+            auto instance = formatManager.createPluginInstance(description, sampleRate, blockSize, errorText);
+            if (instance == nullptr)
+                return {};
+
+            instance->enableAllBuses();
+            return instance;
+        };
+    }
+
+    //==============================================================================
+    // Holds the value the engine side sees; the child gets it with the next block.
+    // Value text is formatted locally, as the plugin's own would need a round trip.
+    class BridgedPluginInstance::RemoteParameter final : public juce::AudioProcessorParameter
+    {
+    public:
+        explicit RemoteParameter(const PluginBridgeInfo::Parameter& info)
+            : name(info.name),
+              label(info.label),
+              defaultValue(info.defaultValue),
+              numSteps(info.numSteps),
+              discrete(info.discrete),
+              boolean(info.boolean),
+              automatable(info.automatable),
+              value(info.value)
+        {
+        }
+
+        float getValue() const override { return value.load(std::memory_order_relaxed); }
+        void setValue(float newValue) override { value.store(newValue, std::memory_order_relaxed); }
+        float getDefaultValue() const override { return defaultValue; }
+        juce::String getName(int maximumStringLength) const override { return name.substring(0, maximumStringLength); }
+        juce::String getLabel() const override { return label; }
+        int getNumSteps() const override { return numSteps; }
+        bool isDiscrete() const override { return discrete; }
+        bool isBoolean() const override { return boolean; }
+        bool isAutomatable() const override { return automatable; }
+
+        juce::String getText(float normalisedValue, int maximumStringLength) const override
+        {
+            if (boolean)
+                return normalisedValue >= 0.5f ? "On" : "Off";
+            return juce::String(normalisedValue, 3).substring(0, maximumStringLength);
+        }
+
+        float getValueForText(const juce::String& text) const override
+        {
+            if (boolean)
+                return text.equalsIgnoreCase("On") ? 1.0f : 0.0f;
+            return juce::jlimit(0.0f, 1.0f, text.getFloatValue());
+        }
+
+    private:
+        const juce::String name;
+        const juce::String label;
+        const float defaultValue;
+        const int numSteps;
+        const bool discrete;
+        const bool boolean;
+        const bool automatable;
+        std::atomic<float> value;
+    };
+
+    namespace
+    {
+        juce::AudioProcessor::BusesProperties makeBridgedBuses(const PluginBridgeInfo& info)
+        {
+            juce::AudioProcessor::BusesProperties buses;
+            if (info.mainInputChannels > 0)
+                buses = buses.withInput("Input", juce::AudioChannelSet::canonicalChannelSet(info.mainInputChannels), true);
+            if (info.mainOutputChannels > 0)
+                buses = buses.withOutput("Output", juce::AudioChannelSet::canonicalChannelSet(info.mainOutputChannels), true);
+            return buses;
+        }
+    }
+
+    BridgedPluginInstance::BridgedPluginInstance(const juce::PluginDescription& pluginDescription,
+                                                 const PluginBridgeInfo& info,
+                                                 std::unique_ptr<PluginBridgeClient> bridgeClient)
+        : juce::AudioPluginInstance(makeBridgedBuses(info)),
+          description(pluginDescription),
+          client(std::move(bridgeClient)),
+          tailSeconds(info.tailSeconds),
+          midiInput(info.acceptsMidi),
+          midiOutput(info.producesMidi)
+    {
+        for (const auto& parameterInfo : info.parameters)
+        {
+            auto parameter = std::make_unique<RemoteParameter>(parameterInfo);
+            remoteParameters.push_back(parameter.get());
+            addParameter(parameter.release());
+        }
+
+        client->resyncParameters(*this);
+        setLatencySamples(info.latencySamples);
+    }
+
+    BridgedPluginInstance::~BridgedPluginInstance() = default;
+
+    std::unique_ptr<BridgedPluginInstance> BridgedPluginInstance::create(const juce::File& hostExecutable,
+                                                                         const juce::PluginDescription& description,
+                                                                         double sampleRate,
+                                                                         int blockSize,
+                                                                         juce::String& errorText)
+    {
+        PluginBridgeConfig config;
+        config.sampleRate = sampleRate;
+        config.blockSize = blockSize;
+
+        auto client = std::make_unique<PluginBridgeClient>();
+        if (!client->launch(hostExecutable, description, config, errorText))
+            return {};
+
+        PluginBridgeInfo info;
+        if (!client->getPluginInfo(info, errorText))
+            return {};
+        if (info.mainOutputChannels <= 0)
+        {
+            errorText = "Sandboxed plugin does not expose a usable output bus.";
+            return {};
+        }
+
+        return std::unique_ptr<BridgedPluginInstance>(new BridgedPluginInstance(description, info, std::move(client)));
+    }
+
+    PluginBridgeClient::ProcessResult BridgedPluginInstance::processBridged(juce::AudioBuffer<float>& buffer,
+                                                                            juce::MidiBuffer& midi,
+                                                                            int numSamples) noexcept
+    {
+        return client->process(buffer, midi, numSamples, this);
+    }
+
+    const char* BridgedPluginInstance::getFailureText(PluginBridgeClient::ProcessResult result) const noexcept
+    {
+        return client->getFailureText(result);
+    }
+
+    bool BridgedPluginInstance::prepareBridge(double sampleRate, int blockSize, juce::String& errorText)
+    {
+        const bool prepared = client->prepare(sampleRate, blockSize, errorText);
+        setLatencySamples(client->getLatencySamples());
+        return prepared;
+    }
+
+    bool BridgedPluginInstance::getBridgeState(juce::MemoryBlock& state, juce::String& errorText)
+    {
+        return client->getState(state, errorText);
+    }
+
+    bool BridgedPluginInstance::setBridgeState(const void* data, size_t numBytes, juce::String& errorText)
+    {
+        if (!client->setState(data, numBytes, errorText))
+            return false;
+
+        setLatencySamples(client->getLatencySamples());
+        refreshParameterValues();
+        return true;
+    }
+
+    void BridgedPluginInstance::refreshParameterValues()
+    {
+        PluginBridgeInfo info;
+        juce::String ignored;
+        if (!client->getPluginInfo(info, ignored))
+            return;
+
+        // The values go back to the child with the next block, which is harmless as
+        // they are what it already holds.
+        const auto count = juce::jmin(remoteParameters.size(), info.parameters.size());
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto* parameter = remoteParameters[i];
+            if (parameter->getValue() == info.parameters[i].value)
+                continue;
+            parameter->setValue(info.parameters[i].value);
+            parameter->sendValueChangedMessageToListeners(info.parameters[i].value);
+        }
+        updateHostDisplay();
+    }
+
+    void BridgedPluginInstance::fillInPluginDescription(juce::PluginDescription& target) const
+    {
+        target = description;
+    }
+
+    const juce::String BridgedPluginInstance::getName() const
+    {
+        return description.name;
+    }
+
+    void BridgedPluginInstance::prepareToPlay(double sampleRate, int blockSize)
+    {
+        juce::String ignored;
+        prepareBridge(sampleRate, blockSize, ignored);
+    }
+
+    void BridgedPluginInstance::releaseResources()
+    {
+        juce::String ignored;
+        client->release(ignored);
+    }
+
+    void BridgedPluginInstance::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+    {
+        if (processBridged(buffer, midi, buffer.getNumSamples()) != PluginBridgeClient::ProcessResult::ok)
+        {
+            buffer.clear();
+            midi.clear();
+        }
+    }
+
+    bool BridgedPluginInstance::isBusesLayoutSupported(const BusesLayout& layout) const
+    {
+        // Any subset of what the child runs: missing inputs reach it as silence.
+        const auto* input = getBus(true, 0);
+        const auto* output = getBus(false, 0);
+        const int maxInputs = input != nullptr ? input->getDefaultLayout().size() : 0;
+        const int maxOutputs = output != nullptr ? output->getDefaultLayout().size() : 0;
+        return layout.inputBuses.size() <= 1
+            && layout.outputBuses.size() <= 1
+            && layout.getMainInputChannels() <= maxInputs
+            && layout.getMainOutputChannels() <= maxOutputs
+            && layout.getMainOutputChannels() > 0;
+    }
+
+    juce::AudioProcessorEditor* BridgedPluginInstance::createEditor()
+    {
+        return new juce::GenericAudioProcessorEditor(*this);
+    }
+
+    void BridgedPluginInstance::getStateInformation(juce::MemoryBlock& destData)
+    {
+        juce::String ignored;
+        if (!getBridgeState(destData, ignored))
+            destData.reset();
+    }
+
+    void BridgedPluginInstance::setStateInformation(const void* data, int sizeInBytes)
+    {
+        juce::String ignored;
+        setBridgeState(data, static_cast<size_t>(juce::jmax(0, sizeInBytes)), ignored);
+    }
+}
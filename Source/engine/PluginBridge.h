@@ -0,0 +1,333 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace sampledex
+{
+    // Shared-memory layout between the engine and a sandboxed plugin host process.
+    //
+    // There are two independent request/response channels so the message thread can
+    // fetch or restore plugin state while the audio thread keeps streaming blocks:
+    //  - the process channel carries one audio block, its MIDI and any parameter
+    //    changes per request and is served by a realtime thread in the child;
+    //  - the control channel carries prepare/state/info/shutdown requests and is
+    //    served by a second child thread, mirroring how an in-process host would call them.
+    // Each channel signals with a sequence word that doubles as a futex (Linux) or
+    // ulock (macOS) address, so an idle side sleeps in the kernel instead of spinning.
+    //
+    // The audio area is not part of the struct: it follows it in the same mapping and
+    // holds audioChannelCapacity channels of maxBlockSamples each (see getMappingSize()).
+    // Payloads larger than one chunk (plugin state, the plugin info) are moved in
+    // payloadChunkBytes pieces, addressed by payloadOffset within payloadTotalBytes.
+    struct PluginBridgeShared
+    {
+        static constexpr std::uint32_t magicValue = 0x53445842u; // "SDXB"
+        static constexpr std::uint32_t layoutVersion = 2u;
+        static constexpr int maxAudioChannels = 64;
+        static constexpr int maxBlockSamples = 8192;
+        static constexpr int maxMidiEvents = 2048;
+        static constexpr int maxMidiEventBytes = 12;
+        static constexpr int maxParameterChanges = 512;
+        static constexpr int payloadChunkBytes = 1024 * 1024;
+        static constexpr int maxErrorTextBytes = 256;
+
+        enum class Command : std::uint32_t
+        {
+            None = 0,
+            Process,
+            Prepare,
+            Release,
+            GetState,       // child captures the state and answers with its first chunk
+            SetState,       // one chunk per request; applied when the last one arrives
+            GetPluginInfo,  // like GetState, for the XML from PluginBridgeInfo
+            ReadPayload,    // next chunk of the last GetState/GetPluginInfo answer
+            Shutdown
+        };
+
+        enum class ChildState : std::uint32_t
+        {
+            Starting = 0,
+            Ready,
+            Failed,
+            Exited
+        };
+
+        struct MidiEvent
+        {
+            std::int32_t sampleOffset = 0;
+            std::uint16_t size = 0;
+            std::uint8_t bytes[maxMidiEventBytes] {};
+        };
+
+        struct ParameterChange
+        {
+            std::int32_t index = 0;
+            float value = 0.0f;
+        };
+
+        struct Channel
+        {
+            std::atomic<std::uint32_t> requestSequence { 0 };
+            std::atomic<std::uint32_t> responseSequence { 0 };
+            Command command = Command::None;
+            std::int32_t ok = 0;
+            char errorText[maxErrorTextBytes] {};
+        };
+
+        static constexpr size_t getAudioOffset() noexcept
+        {
+            return (sizeof(PluginBridgeShared) + 63u) & ~static_cast<size_t>(63u);
+        }
+
+        static constexpr size_t getMappingSize(int audioChannels) noexcept
+        {
+            return getAudioOffset()
+                 + static_cast<size_t>(audioChannels) * static_cast<size_t>(maxBlockSamples) * sizeof(float);
+        }
+
+        // Only valid inside a mapping of getMappingSize(audioChannelCapacity) bytes.
+        float* getAudioChannel(int channel) noexcept
+        {
+            return reinterpret_cast<float*>(reinterpret_cast<char*>(this) + getAudioOffset())
+                 + static_cast<size_t>(channel) * static_cast<size_t>(maxBlockSamples);
+        }
+
+        std::uint32_t magic = 0;
+        std::uint32_t version = 0;
+        std::int64_t hostProcessId = 0;
+        std::int32_t audioChannelCapacity = 0;
+        std::atomic<std::uint32_t> childState { static_cast<std::uint32_t>(ChildState::Starting) };
+        std::atomic<std::int32_t> latencySamples { 0 };
+
+        double sampleRate = 44100.0;
+        std::int32_t blockSize = 512;
+
+        Channel process;
+        std::int32_t numChannels = 0;
+        std::int32_t numSamples = 0;
+        std::int32_t numMidiIn = 0;
+        std::int32_t numMidiOut = 0;
+        std::int32_t numParameterChanges = 0;
+        ParameterChange parameterChanges[maxParameterChanges] {};
+        MidiEvent midiIn[maxMidiEvents] {};
+        MidiEvent midiOut[maxMidiEvents] {};
+
+        Channel control;
+        std::int64_t payloadOffset = 0;
+        std::int64_t payloadTotalBytes = 0;
+        std::int32_t payloadBytes = 0;
+        char payload[payloadChunkBytes] {};
+    };
+
+    struct PluginBridgeConfig
+    {
+        double sampleRate = 44100.0;
+        int blockSize = 512;
+        // Shared audio channels; raised to whatever the description declares.
+        int numChannels = 2;
+        // A block may take its own duration plus this long before the child is
+        // treated as hung, so the deadline scales with the block size.
+        double processTimeoutMarginMs = 10.0;
+        int launchTimeoutMs = 15000;
+    };
+
+    // What the child reports about the plugin it loaded, so the engine side can
+    // present it without loading any of its code.
+    struct PluginBridgeInfo
+    {
+        struct Parameter
+        {
+            juce::String name;
+            juce::String label;
+            float defaultValue = 0.0f;
+            float value = 0.0f;
+            int numSteps = 0x7fffffff;
+            bool discrete = false;
+            bool boolean = false;
+            bool automatable = true;
+        };
+
+        int mainInputChannels = 0;
+        int mainOutputChannels = 2;
+        bool acceptsMidi = false;
+        bool producesMidi = false;
+        double tailSeconds = 0.0;
+        int latencySamples = 0;
+        std::vector<Parameter> parameters;
+
+        juce::String toXmlString() const;
+        static bool fromXmlString(const juce::String& text, PluginBridgeInfo& info);
+        static PluginBridgeInfo fromProcessor(juce::AudioProcessor& processor);
+    };
+
+    // Engine side of the bridge. launch(), prepare(), getState(), setState(),
+    // getPluginInfo() and shutdown() belong to the message thread (or to whichever
+    // thread owns a not yet published client); process() is realtime safe and is
+    // only ever called from one audio thread at a time.
+    class PluginBridgeClient final
+    {
+    public:
+        enum class ProcessResult
+        {
+            ok = 0,
+            notRunning,
+            blockTooLarge,
+            missedDeadline,
+            pluginFailed
+        };
+
+        PluginBridgeClient();
+        ~PluginBridgeClient();
+
+        // Spawns hostExecutable with --plugin-bridge-host=<shared memory name> and waits
+        // until the child has instantiated and prepared the plugin.
+        bool launch(const juce::File& hostExecutable,
+                    const juce::PluginDescription& description,
+                    const PluginBridgeConfig& config,
+                    juce::String& errorText);
+
+        bool isRunning() const noexcept;
+        void shutdown();
+
+        // parameterSource holds the engine-side parameters (see BridgedPluginInstance).
+        // Parameters whose value changed since the previous block are sent along with
+        // the audio. Never allocates; see getFailureText() for what went wrong.
+        ProcessResult process(juce::AudioBuffer<float>& buffer,
+                              juce::MidiBuffer& midi,
+                              int numSamples,
+                              juce::AudioProcessor* parameterSource) noexcept;
+
+        // Static text for result, or the child's own message for pluginFailed. The
+        // pointer stays valid until the next process() call.
+        const char* getFailureText(ProcessResult result) const noexcept;
+
+        bool prepare(double sampleRate, int blockSize, juce::String& errorText);
+        bool release(juce::String& errorText);
+        bool getState(juce::MemoryBlock& state, juce::String& errorText);
+        bool setState(const void* data, size_t numBytes, juce::String& errorText);
+        bool getPluginInfo(PluginBridgeInfo& info, juce::String& errorText);
+
+        // Re-baselines parameter change tracking, e.g. after both sides loaded the same state.
+        void resyncParameters(juce::AudioProcessor& parameterSource);
+
+        int getLatencySamples() const noexcept;
+        int getNumChannels() const noexcept;
+
+        static bool isSupportedOnThisPlatform() noexcept;
+
+    private:
+        struct SharedMapping;
+
+        bool sendControlCommand(PluginBridgeShared::Command command, juce::String& errorText);
+        bool readPayload(PluginBridgeShared::Command command, juce::MemoryBlock& destination, juce::String& errorText);
+        void appendParameterChanges(juce::AudioProcessor& parameterSource) noexcept;
+
+        std::unique_ptr<SharedMapping> mapping;
+        std::unique_ptr<juce::ChildProcess> childProcess;
+        std::vector<float> lastSentParameterValues;
+        std::uint32_t processSequence = 0;
+        std::uint32_t controlSequence = 0;
+        double processTimeoutMarginMs = 10.0;
+        std::atomic<bool> failed { false };
+
+        JUCE_DECLARE_NON_COPYABLE(PluginBridgeClient)
+    };
+
+    // Engine-side stand-in for a plugin running in a PluginBridgeServer child. It
+    // contains none of the plugin's code: parameters mirror what the child reported,
+    // edits are forwarded with the next block, and state, prepare and processing go
+    // over the bridge. The editor is a generic parameter editor.
+    class BridgedPluginInstance final : public juce::AudioPluginInstance
+    {
+    public:
+        ~BridgedPluginInstance() override;
+
+        // Launches the child and waits for it to load the plugin. Loads nothing into
+        // this process, so any thread may call it.
+        static std::unique_ptr<BridgedPluginInstance> create(const juce::File& hostExecutable,
+                                                             const juce::PluginDescription& description,
+                                                             double sampleRate,
+                                                             int blockSize,
+                                                             juce::String& errorText);
+
+        // Audio thread. Unlike processBlock(), a failure is returned instead of being
+        // turned into silence; getFailureText() describes it without allocating.
+        PluginBridgeClient::ProcessResult processBridged(juce::AudioBuffer<float>& buffer,
+                                                         juce::MidiBuffer& midi,
+                                                         int numSamples) noexcept;
+        const char* getFailureText(PluginBridgeClient::ProcessResult result) const noexcept;
+
+        // Message thread variants of the AudioProcessor calls that report errors.
+        bool prepareBridge(double sampleRate, int blockSize, juce::String& errorText);
+        bool getBridgeState(juce::MemoryBlock& state, juce::String& errorText);
+        bool setBridgeState(const void* data, size_t numBytes, juce::String& errorText);
+        bool isBridgeRunning() const noexcept { return client->isRunning(); }
+        // Latest latency the child reported; any thread.
+        int getBridgeLatencySamples() const noexcept { return client->getLatencySamples(); }
+
+        void fillInPluginDescription(juce::PluginDescription& description) const override;
+        const juce::String getName() const override;
+
+        void prepareToPlay(double sampleRate, int blockSize) override;
+        void releaseResources() override;
+        void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) override;
+        using juce::AudioPluginInstance::processBlock;
+        bool isBusesLayoutSupported(const BusesLayout& layout) const override;
+
+        double getTailLengthSeconds() const override { return tailSeconds; }
+        bool acceptsMidi() const override { return midiInput; }
+        bool producesMidi() const override { return midiOutput; }
+
+        bool hasEditor() const override { return true; }
+        juce::AudioProcessorEditor* createEditor() override;
+
+        int getNumPrograms() override { return 1; }
+        int getCurrentProgram() override { return 0; }
+        void setCurrentProgram(int) override {}
+        const juce::String getProgramName(int) override { return {}; }
+        void changeProgramName(int, const juce::String&) override {}
+
+        void getStateInformation(juce::MemoryBlock& destData) override;
+        void setStateInformation(const void* data, int sizeInBytes) override;
+
+    private:
+        class RemoteParameter;
+
+        BridgedPluginInstance(const juce::PluginDescription& pluginDescription,
+                              const PluginBridgeInfo& info,
+                              std::unique_ptr<PluginBridgeClient> bridgeClient);
+
+        // Pulls the child's parameter values after it loaded a state.
+        void refreshParameterValues();
+
+        juce::PluginDescription description;
+        std::unique_ptr<PluginBridgeClient> client;
+        std::vector<RemoteParameter*> remoteParameters;
+        double tailSeconds = 0.0;
+        bool midiInput = false;
+        bool midiOutput = false;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BridgedPluginInstance)
+    };
+
+    // Child side. Creates the plugin through the factory and serves both channels
+    // until the engine sends Shutdown or disappears. Returns a process exit code.
+    class PluginBridgeServer final
+    {
+    public:
+        using ProcessorFactory = std::function<std::unique_ptr<juce::AudioProcessor>(const juce::PluginDescription&,
+                                                                                      double sampleRate,
+                                                                                      int blockSize,
+                                                                                      juce::String& errorText)>;
+
+        static int run(const juce::String& sharedMemoryName, ProcessorFactory factory);
+
+        // Factory used by the app: instantiates the plugin through the default formats.
+        static ProcessorFactory createDefaultFactory();
+    };
+}
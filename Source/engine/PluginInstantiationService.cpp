@@ -0,0 +1,286 @@
+#include "PluginInstantiationService.h"
+#include "Track.h"
+#include <algorithm>
+
+namespace sampledex
+{
+    PluginInstantiationService::PluginInstantiationService(juce::AudioPluginFormatManager& pluginFormatManager,
+                                                           int numWorkerThreads)
+        : formatManager(pluginFormatManager),
+          workerPool(juce::jmax(1, numWorkerThreads))
+    {
+    }
+
+    PluginInstantiationService::~PluginInstantiationService()
+    {
+        lifetime->alive.store(false, std::memory_order_release);
+        workerPool.removeAllJobs(true, 10000);
+        warmInstances.clear();
+    }
+
+    bool PluginInstantiationService::canCreateOffMessageThread(const juce::PluginDescription& description)
+    {
+        // JUCE's hosts for these formats must create instances on the message thread.
+        static const juce::StringArray messageThreadFormats { "VST3", "AudioUnit", "VST", "LV2", "AAX" };
+        return !messageThreadFormats.contains(description.pluginFormatName, true);
+    }
+
+    juce::String PluginInstantiationService::makeKey(const juce::PluginDescription& description, bool isInstrument)
+    {
+        return description.createIdentifierString() + (isInstrument ? "|inst" : "|fx");
+    }
+
+    void PluginInstantiationService::requestInstance(Request request)
+    {
+        pendingRequests.fetch_add(1, std::memory_order_relaxed);
+
+        auto job = std::make_shared<InFlight>();
+        job->request = std::move(request);
+        job->request.onComplete = [this, completion = std::move(job->request.onComplete)](std::unique_ptr<juce::AudioPluginInstance> instance,
+                                                                                         double preparedSampleRate,
+                                                                                         int preparedBlockSize,
+                                                                                         const juce::String& errorText)
+        {
+            pendingRequests.fetch_sub(1, std::memory_order_relaxed);
+            if (completion != nullptr)
+                completion(std::move(instance), preparedSampleRate, preparedBlockSize, errorText);
+        };
+
+        if (!job->request.sandboxed && takeWarmInstance(job->request, job->instance))
+        {
+            // Keep the contract that completions never run inside requestInstance().
+            juce::MessageManager::callAsync([this, job, alive = lifetime]
+            {
+                if (alive->alive.load(std::memory_order_acquire))
+                    deliver(job);
+            });
+            refillWarmPool();
+            return;
+        }
+
+        startCreation(std::move(job));
+    }
+
+    void PluginInstantiationService::startCreation(std::shared_ptr<InFlight> job)
+    {
+        if (job->request.sandboxed || canCreateOffMessageThread(job->request.description))
+        {
+            workerPool.addJob([this, job, alive = lifetime]
+            {
+                if (!alive->alive.load(std::memory_order_acquire))
+                    return;
+                const auto policy = job->request.sandboxed ? Track::PluginHostingPolicy::IsolatedBridge
+                                                           : Track::PluginHostingPolicy::SafeInProcess;
+                job->instance = Track::createPluginInstanceForPolicy(formatManager,
+                                                                     job->request.description,
+                                                                     policy,
+                                                                     job->request.sampleRate,
+                                                                     job->request.blockSize,
+                                                                     job->errorText);
+                startPreparation(job);
+            });
+            return;
+        }
+
+        juce::MessageManager::callAsync([this, job, alive = lifetime]
+        {
+            if (!alive->alive.load(std::memory_order_acquire))
+                return;
+
+            formatManager.createPluginInstanceAsync(job->request.description,
+                                                    job->request.sampleRate,
+                                                    job->request.blockSize,
+                                                    [this, job, alive](std::unique_ptr<juce::AudioPluginInstance> instance,
+                                                                       const juce::String& errorText)
+                                                    {
+                                                        if (!alive->alive.load(std::memory_order_acquire))
+                                                            return;
+                                                        job->instance = std::move(instance);
+                                                        job->errorText = errorText;
+                                                        startPreparation(job);
+                                                    });
+        });
+    }
+
+    void PluginInstantiationService::startPreparation(std::shared_ptr<InFlight> job)
+    {
+        if (job->instance == nullptr)
+        {
+            if (job->errorText.isEmpty())
+                job->errorText = "Unable to create plugin instance.";
+            juce::MessageManager::callAsync([this, job, alive = lifetime]
+            {
+                if (alive->alive.load(std::memory_order_acquire))
+                    deliver(job);
+            });
+            return;
+        }
+
+        const auto prepare = [this, job, alive = lifetime]
+        {
+            if (!alive->alive.load(std::memory_order_acquire))
+                return;
+
+            const auto& request = job->request;
+            if (!Track::preparePluginInstanceForHosting(*job->instance,
+                                                        request.isInstrument,
+                                                        request.sampleRate,
+                                                        request.blockSize,
+                                                        job->errorText))
+            {
+                job->instance.reset();
+            }
+
+            juce::MessageManager::callAsync([this, job, alive]
+            {
+                if (alive->alive.load(std::memory_order_acquire))
+                    deliver(job);
+            });
+        };
+
+        // Bus layout, prepareToPlay and the test render call into the plugin, so they
+        // follow the same thread rule as creating it. This covers warm-pool refills too.
+        if (job->request.sandboxed || canCreateOffMessageThread(job->request.description))
+            workerPool.addJob(prepare);
+        else
+            juce::MessageManager::callAsync(prepare);
+    }
+
+    void PluginInstantiationService::deliver(std::shared_ptr<InFlight> job)
+    {
+        auto& request = job->request;
+        if (request.onComplete != nullptr)
+            request.onComplete(std::move(job->instance), request.sampleRate, request.blockSize, job->errorText);
+    }
+
+    bool PluginInstantiationService::takeWarmInstance(const Request& request,
+                                                      std::unique_ptr<juce::AudioPluginInstance>& instance)
+    {
+        const auto key = makeKey(request.description, request.isInstrument);
+        for (auto it = warmInstances.begin(); it != warmInstances.end(); ++it)
+        {
+            if (it->key != key || it->sampleRate != request.sampleRate || it->blockSize != request.blockSize)
+                continue;
+
+            instance = std::move(it->instance);
+            warmInstances.erase(it);
+            return instance != nullptr;
+        }
+        return false;
+    }
+
+    void PluginInstantiationService::noteRecentlyUsed(const juce::PluginDescription& description, bool isInstrument)
+    {
+        const auto key = makeKey(description, isInstrument);
+        recentPlugins.erase(std::remove_if(recentPlugins.begin(),
+                                           recentPlugins.end(),
+                                           [&key](const RecentPlugin& recent)
+                                           {
+                                               return makeKey(recent.description, recent.isInstrument) == key;
+                                           }),
+                            recentPlugins.end());
+        recentPlugins.insert(recentPlugins.begin(), RecentPlugin { description, isInstrument });
+        refillWarmPool();
+    }
+
+    void PluginInstantiationService::setPlaybackConfiguration(double sampleRate, int blockSize)
+    {
+        if (sampleRate == currentSampleRate && blockSize == currentBlockSize)
+            return;
+
+        currentSampleRate = sampleRate;
+        currentBlockSize = blockSize;
+        warmInstances.clear();
+        refillWarmPool();
+    }
+
+    void PluginInstantiationService::setWarmPoolCapacity(int capacity)
+    {
+        warmPoolCapacity = juce::jmax(0, capacity);
+        refillWarmPool();
+    }
+
+    void PluginInstantiationService::clearWarmPool()
+    {
+        recentPlugins.clear();
+        warmInstances.clear();
+    }
+
+    void PluginInstantiationService::refillWarmPool()
+    {
+        if (static_cast<int>(recentPlugins.size()) > warmPoolCapacity)
+            recentPlugins.resize(static_cast<size_t>(warmPoolCapacity));
+
+        // Drop instances for plugins that fell out of the recent list or the current config.
+        warmInstances.erase(std::remove_if(warmInstances.begin(),
+                                           warmInstances.end(),
+                                           [this](const WarmInstance& warm)
+                                           {
+                                               if (warm.sampleRate != currentSampleRate || warm.blockSize != currentBlockSize)
+                                                   return true;
+                                               for (const auto& recent : recentPlugins)
+                                                   if (makeKey(recent.description, recent.isInstrument) == warm.key)
+                                                       return false;
+                                               return true;
+                                           }),
+                            warmInstances.end());
+
+        for (const auto& recent : recentPlugins)
+        {
+            const auto key = makeKey(recent.description, recent.isInstrument);
+            if (warmingKeys.contains(key))
+                continue;
+            const bool alreadyWarm = std::any_of(warmInstances.begin(),
+                                                 warmInstances.end(),
+                                                 [&key](const WarmInstance& warm) { return warm.key == key; });
+            if (alreadyWarm)
+                continue;
+
+            warmingKeys.add(key);
+            auto job = std::make_shared<InFlight>();
+            job->request.description = recent.description;
+            job->request.isInstrument = recent.isInstrument;
+            job->request.sampleRate = currentSampleRate;
+            job->request.blockSize = currentBlockSize;
+            job->request.onComplete = [this, key](std::unique_ptr<juce::AudioPluginInstance> instance,
+                                                  double preparedSampleRate,
+                                                  int preparedBlockSize,
+                                                  const juce::String&)
+            {
+                warmingKeys.removeString(key);
+                if (instance == nullptr)
+                {
+                    // Don't keep retrying a plugin that cannot be pre-created.
+                    recentPlugins.erase(std::remove_if(recentPlugins.begin(),
+                                                       recentPlugins.end(),
+                                                       [&key](const RecentPlugin& recent)
+                                                       {
+                                                           return makeKey(recent.description, recent.isInstrument) == key;
+                                                       }),
+                                        recentPlugins.end());
+                    return;
+                }
+                if (preparedSampleRate != currentSampleRate
+                    || preparedBlockSize != currentBlockSize)
+                    return;
+
+                const bool stillRecent = std::any_of(recentPlugins.begin(),
+                                                     recentPlugins.end(),
+                                                     [&key](const RecentPlugin& recent)
+                                                     {
+                                                         return makeKey(recent.description, recent.isInstrument) == key;
+                                                     });
+                if (!stillRecent)
+                    return;
+
+                WarmInstance warm;
+                warm.key = key;
+                warm.sampleRate = preparedSampleRate;
+                warm.blockSize = preparedBlockSize;
+                warm.instance = std::move(instance);
+                warmInstances.push_back(std::move(warm));
+            };
+            startCreation(std::move(job));
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace sampledex
+{
+    // Creates and prepares plugin instances without stalling the message thread, and
+    // keeps a few warm, already prepared instances of recently used plugins so the
+    // next insert of the same plugin attaches immediately.
+    //
+    // Creation and preparation (bus layout, prepareToPlay and the guarded test render
+    // in Track::preparePluginInstanceForHosting) only run on the message thread for
+    // formats that require it (JUCE's AU and VST3 hosts both do), dispatched
+    // asynchronously one step per message-loop turn; everything else runs on a worker.
+    // Sandboxed instances load nothing into this process and always use a worker.
+    // All public calls and all completions belong to the message thread.
+    class PluginInstantiationService final
+    {
+    public:
+        using Completion = std::function<void(std::unique_ptr<juce::AudioPluginInstance> instance,
+                                              double preparedSampleRate,
+                                              int preparedBlockSize,
+                                              const juce::String& errorText)>;
+
+        struct Request
+        {
+            juce::PluginDescription description;
+            bool isInstrument = false;
+            double sampleRate = 44100.0;
+            int blockSize = 512;
+            // Launch the plugin in a sandboxed child and deliver the BridgedPluginInstance
+            // driving it. Never served from, or added to, the warm pool.
+            bool sandboxed = false;
+            Completion onComplete;
+        };
+
+        explicit PluginInstantiationService(juce::AudioPluginFormatManager& pluginFormatManager,
+                                            int numWorkerThreads = 2);
+        ~PluginInstantiationService();
+
+        // onComplete is always called later on the message thread, with either a prepared
+        // instance or an error. A matching warm instance is handed out without creating one.
+        void requestInstance(Request request);
+
+        // Records a successful load; the most recent plugins are kept warm.
+        void noteRecentlyUsed(const juce::PluginDescription& description, bool isInstrument);
+
+        // Warm instances prepared for another device configuration are dropped and rebuilt.
+        void setPlaybackConfiguration(double sampleRate, int blockSize);
+
+        void setWarmPoolCapacity(int capacity);
+        int getWarmPoolCapacity() const noexcept { return warmPoolCapacity; }
+        int getNumWarmInstances() const noexcept { return static_cast<int>(warmInstances.size()); }
+        int getNumPendingRequests() const noexcept { return pendingRequests.load(std::memory_order_relaxed); }
+        void clearWarmPool();
+
+        static bool canCreateOffMessageThread(const juce::PluginDescription& description);
+
+    private:
+        struct WarmInstance
+        {
+            juce::String key;
+            double sampleRate = 0.0;
+            int blockSize = 0;
+            std::unique_ptr<juce::AudioPluginInstance> instance;
+        };
+
+        struct RecentPlugin
+        {
+            juce::PluginDescription description;
+            bool isInstrument = false;
+        };
+
+        // Shared with queued jobs and callbacks so they can tell the service is gone.
+        struct Lifetime
+        {
+            std::atomic<bool> alive { true };
+        };
+
+        struct InFlight
+        {
+            Request request;
+            std::unique_ptr<juce::AudioPluginInstance> instance;
+            juce::String errorText;
+        };
+
+        static juce::String makeKey(const juce::PluginDescription& description, bool isInstrument);
+
+        void startCreation(std::shared_ptr<InFlight> job);
+        void startPreparation(std::shared_ptr<InFlight> job);
+        void deliver(std::shared_ptr<InFlight> job);
+        bool takeWarmInstance(const Request& request, std::unique_ptr<juce::AudioPluginInstance>& instance);
+        void refillWarmPool();
+
+        juce::AudioPluginFormatManager& formatManager;
+        juce::ThreadPool workerPool;
+        std::shared_ptr<Lifetime> lifetime = std::make_shared<Lifetime>();
+        std::vector<WarmInstance> warmInstances;
+        std::vector<RecentPlugin> recentPlugins; // most recent first
+        juce::StringArray warmingKeys;
+        double currentSampleRate = 44100.0;
+        int currentBlockSize = 512;
+        int warmPoolCapacity = 3;
+        std::atomic<int> pendingRequests { 0 };
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginInstantiationService)
+    };
+}
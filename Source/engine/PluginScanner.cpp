@@ -0,0 +1,608 @@
+#include "PluginScanner.h"
+#include <algorithm>
+
+namespace sampledex
+{
+    namespace
+    {
+        constexpr int databaseVersion = 1;
+        constexpr juce::int64 hashedBytesPerEnd = 256 * 1024;
+
+        bool isBinaryDirectoryName(const juce::String& name)
+        {
+            // macOS bundles keep code in Contents/MacOS, VST3 bundles in Contents/<arch>-<os>.
+            return name == "MacOS" || name.endsWith("-linux") || name.endsWith("-win");
+        }
+
+        juce::Array<juce::File> findPluginBinaries(const juce::File& target)
+        {
+            juce::Array<juce::File> binaries;
+            if (target.existsAsFile())
+            {
+                binaries.add(target);
+                return binaries;
+            }
+
+            const auto contents = target.getChildFile("Contents");
+            if (!contents.isDirectory())
+                return binaries;
+
+            for (const auto& entry : juce::RangedDirectoryIterator(contents, true, "*", juce::File::findFiles))
+            {
+                const auto file = entry.getFile();
+                if (isBinaryDirectoryName(file.getParentDirectory().getFileName()))
+                    binaries.add(file);
+            }
+
+            std::sort(binaries.begin(), binaries.end());
+            return binaries;
+        }
+
+        bool formatLooksLikeVST3(const juce::AudioPluginFormat& format)
+        {
+            return format.getName().containsIgnoreCase("VST3");
+        }
+
+        bool formatLooksLikeAudioUnit(const juce::AudioPluginFormat& format)
+        {
+            const auto name = format.getName();
+            return name.containsIgnoreCase("AudioUnit") || name.containsIgnoreCase("AU");
+        }
+
+        void addSearchDirectoryIfPresent(juce::FileSearchPath& path, const juce::File& directory)
+        {
+            if (!directory.isDirectory())
+                return;
+
+            const auto canonical = directory.getFullPathName();
+            for (int i = 0; i < path.getNumPaths(); ++i)
+            {
+                if (path[i].getFullPathName() == canonical)
+                    return;
+            }
+
+            path.add(canonical);
+        }
+    }
+
+    //==============================================================================
+    juce::String PluginScanDatabase::makeKey(const juce::String& formatName, const juce::String& fileOrIdentifier)
+    {
+        return formatName + "|" + fileOrIdentifier;
+    }
+
+    juce::String PluginScanDatabase::statusToString(Status status)
+    {
+        switch (status)
+        {
+            case Status::Failed:   return "failed";
+            case Status::Crashed:  return "crashed";
+            case Status::TimedOut: return "timeout";
+            case Status::Scanned:
+            default:               return "scanned";
+        }
+    }
+
+    PluginScanDatabase::Status PluginScanDatabase::statusFromString(const juce::String& text)
+    {
+        if (text == "failed")
+            return Status::Failed;
+        if (text == "crashed")
+            return Status::Crashed;
+        if (text == "timeout")
+            return Status::TimedOut;
+        return Status::Scanned;
+    }
+
+    bool PluginScanDatabase::loadFrom(const juce::File& file)
+    {
+        entries.clear();
+        if (!file.existsAsFile())
+            return false;
+
+        std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(file));
+        if (xml == nullptr
+            || !xml->hasTagName("PLUGINSCANDB")
+            || xml->getIntAttribute("version") != databaseVersion)
+            return false;
+
+        for (auto* entryXml : xml->getChildWithTagNameIterator("ENTRY"))
+        {
+            Entry entry;
+            entry.formatName = entryXml->getStringAttribute("format");
+            entry.fileOrIdentifier = entryXml->getStringAttribute("id");
+            if (entry.formatName.isEmpty() || entry.fileOrIdentifier.isEmpty())
+                continue;
+
+            entry.fingerprint.totalBytes = entryXml->getStringAttribute("bytes", "-1").getLargeIntValue();
+            entry.fingerprint.newestModificationMs = entryXml->getStringAttribute("modified", "0").getLargeIntValue();
+            entry.fingerprint.binaryHash = entryXml->getStringAttribute("hash");
+            entry.status = statusFromString(entryXml->getStringAttribute("status"));
+            entry.failureReason = entryXml->getStringAttribute("reason");
+            entry.scanMillis = entryXml->getIntAttribute("millis");
+            for (auto* pluginXml : entryXml->getChildIterator())
+            {
+                juce::PluginDescription description;
+                if (description.loadFromXml(*pluginXml))
+                    entry.descriptions.push_back(description);
+            }
+            store(std::move(entry));
+        }
+        return true;
+    }
+
+    bool PluginScanDatabase::saveTo(const juce::File& file) const
+    {
+        juce::XmlElement root("PLUGINSCANDB");
+        root.setAttribute("version", databaseVersion);
+        for (const auto& [key, entry] : entries)
+        {
+            juce::ignoreUnused(key);
+            auto* entryXml = root.createNewChildElement("ENTRY");
+            entryXml->setAttribute("format", entry.formatName);
+            entryXml->setAttribute("id", entry.fileOrIdentifier);
+            entryXml->setAttribute("bytes", juce::String(entry.fingerprint.totalBytes));
+            entryXml->setAttribute("modified", juce::String(entry.fingerprint.newestModificationMs));
+            entryXml->setAttribute("hash", entry.fingerprint.binaryHash);
+            entryXml->setAttribute("status", statusToString(entry.status));
+            if (entry.failureReason.isNotEmpty())
+                entryXml->setAttribute("reason", entry.failureReason);
+            entryXml->setAttribute("millis", entry.scanMillis);
+            for (const auto& description : entry.descriptions)
+                entryXml->addChildElement(description.createXml().release());
+        }
+
+        file.getParentDirectory().createDirectory();
+        return root.writeTo(file);
+    }
+
+    const PluginScanDatabase::Entry* PluginScanDatabase::find(const juce::String& formatName,
+                                                              const juce::String& fileOrIdentifier) const
+    {
+        const auto found = entries.find(makeKey(formatName, fileOrIdentifier));
+        return found != entries.end() ? &found->second : nullptr;
+    }
+
+    void PluginScanDatabase::store(Entry entry)
+    {
+        auto key = makeKey(entry.formatName, entry.fileOrIdentifier);
+        entries[std::move(key)] = std::move(entry);
+    }
+
+    void PluginScanDatabase::remove(const juce::String& formatName, const juce::String& fileOrIdentifier)
+    {
+        entries.erase(makeKey(formatName, fileOrIdentifier));
+    }
+
+    std::vector<const PluginScanDatabase::Entry*> PluginScanDatabase::getEntriesForFormat(const juce::String& formatName) const
+    {
+        std::vector<const Entry*> result;
+        for (const auto& [key, entry] : entries)
+        {
+            juce::ignoreUnused(key);
+            if (entry.formatName == formatName)
+                result.push_back(&entry);
+        }
+        return result;
+    }
+
+    PluginScanDatabase::Fingerprint PluginScanDatabase::computeQuickFingerprint(const juce::String& fileOrIdentifier)
+    {
+        Fingerprint fingerprint;
+        if (!juce::File::isAbsolutePath(fileOrIdentifier))
+            return fingerprint;
+
+        const juce::File target(fileOrIdentifier);
+        if (!target.exists())
+            return fingerprint;
+
+        fingerprint.totalBytes = 0;
+        fingerprint.newestModificationMs = target.getLastModificationTime().toMilliseconds();
+        for (const auto& binary : findPluginBinaries(target))
+        {
+            fingerprint.totalBytes += binary.getSize();
+            fingerprint.newestModificationMs = juce::jmax(fingerprint.newestModificationMs,
+                                                          binary.getLastModificationTime().toMilliseconds());
+        }
+        return fingerprint;
+    }
+
+    juce::String PluginScanDatabase::computeBinaryHash(const juce::String& fileOrIdentifier)
+    {
+        if (!juce::File::isAbsolutePath(fileOrIdentifier))
+            return {};
+
+        const juce::File target(fileOrIdentifier);
+        juce::MemoryOutputStream digestInput;
+        for (const auto& binary : findPluginBinaries(target))
+        {
+            juce::FileInputStream input(binary);
+            if (!input.openedOk())
+                continue;
+
+            const auto length = input.getTotalLength();
+            digestInput << binary.getRelativePathFrom(target);
+            digestInput.writeInt64(length);
+            digestInput.writeFromInputStream(input, juce::jmin(length, hashedBytesPerEnd));
+            if (length > hashedBytesPerEnd)
+            {
+                const auto tailStart = juce::jmax(hashedBytesPerEnd, length - hashedBytesPerEnd);
+                if (input.setPosition(tailStart))
+                    digestInput.writeFromInputStream(input, length - tailStart);
+            }
+        }
+
+        if (digestInput.getDataSize() == 0)
+            return {};
+        return juce::SHA256(digestInput.getData(), digestInput.getDataSize()).toHexString();
+    }
+
+    //==============================================================================
+    PluginScanner::PluginScanner(juce::AudioPluginFormatManager& pluginFormatManager,
+                                 juce::KnownPluginList& pluginList,
+                                 const juce::File& scanDatabaseFile)
+        : formatManager(pluginFormatManager),
+          knownPluginList(pluginList),
+          databaseFile(scanDatabaseFile)
+    {
+        database.loadFrom(databaseFile);
+    }
+
+    PluginScanner::~PluginScanner()
+    {
+        cancel();
+        planPool.removeAllJobs(true, 10000);
+    }
+
+    juce::FileSearchPath PluginScanner::getSearchPathForFormat(juce::AudioPluginFormat& format)
+    {
+        auto searchPath = format.getDefaultLocationsToSearch();
+
+        const auto userHome = juce::File::getSpecialLocation(juce::File::userHomeDirectory);
+        const juce::File systemAudioPlugins("/Library/Audio/Plug-Ins");
+        const juce::File userAudioPlugins = userHome.getChildFile("Library")
+                                                    .getChildFile("Audio")
+                                                    .getChildFile("Plug-Ins");
+
+        const auto currentExe = juce::File::getSpecialLocation(juce::File::currentExecutableFile);
+        const auto appContents = currentExe.getParentDirectory().getParentDirectory();
+        const auto appPlugIns = appContents.getChildFile("PlugIns");
+        const auto appResourcesPlugins = appContents.getChildFile("Resources").getChildFile("Plugins");
+
+        if (formatLooksLikeVST3(format))
+        {
+            addSearchDirectoryIfPresent(searchPath, systemAudioPlugins.getChildFile("VST3"));
+            addSearchDirectoryIfPresent(searchPath, userAudioPlugins.getChildFile("VST3"));
+            addSearchDirectoryIfPresent(searchPath, appPlugIns.getChildFile("VST3"));
+            addSearchDirectoryIfPresent(searchPath, appResourcesPlugins.getChildFile("VST3"));
+        }
+        else if (formatLooksLikeAudioUnit(format))
+        {
+            addSearchDirectoryIfPresent(searchPath, systemAudioPlugins.getChildFile("Components"));
+            addSearchDirectoryIfPresent(searchPath, userAudioPlugins.getChildFile("Components"));
+            addSearchDirectoryIfPresent(searchPath, appPlugIns.getChildFile("Components"));
+            addSearchDirectoryIfPresent(searchPath, appResourcesPlugins.getChildFile("Components"));
+        }
+
+        return searchPath;
+    }
+
+    bool PluginScanner::start(const Options& options)
+    {
+        if (isScanning() || !options.hostExecutable.existsAsFile())
+            return false;
+
+        activeOptions = options;
+        activeOptions.maxConcurrentScans = juce::jmax(1, options.maxConcurrentScans);
+        targets.clear();
+        nextTarget = 0;
+        numScanned = 0;
+        numUnchanged = 0;
+
+        auto job = std::make_shared<PlanJob>();
+        auto snapshot = std::make_shared<PluginScanDatabase>(database);
+        planJob = job;
+        state = State::Planning;
+        planPool.addJob([job, snapshot, options = activeOptions, &manager = formatManager]
+        {
+            buildPlan(manager, *snapshot, options, *job);
+            job->finished.store(true, std::memory_order_release);
+        });
+        return true;
+    }
+
+    void PluginScanner::buildPlan(juce::AudioPluginFormatManager& manager,
+                                  const PluginScanDatabase& snapshot,
+                                  const Options& options,
+                                  PlanJob& job)
+    {
+        auto& plan = job.plan;
+        for (const auto& formatName : options.formatNames)
+        {
+            juce::AudioPluginFormat* format = nullptr;
+            for (int i = 0; i < manager.getNumFormats() && format == nullptr; ++i)
+                if (auto* candidate = manager.getFormat(i); candidate != nullptr && candidate->getName() == formatName)
+                    format = candidate;
+            if (format == nullptr)
+                continue;
+
+            const auto searchPath = getSearchPathForFormat(*format);
+            if (searchPath.getNumPaths() <= 0)
+                continue;
+
+            const auto found = format->searchPathsForPlugins(searchPath, true, true);
+            for (const auto& identifier : found)
+            {
+                if (job.cancelled.load(std::memory_order_relaxed))
+                    return;
+
+                const auto* existing = snapshot.find(formatName, identifier);
+                Target target { formatName, identifier, {}, false };
+                if (existing == nullptr || options.rescanEverything)
+                {
+                    target.fingerprint = PluginScanDatabase::computeQuickFingerprint(identifier);
+                    target.fingerprint.binaryHash = PluginScanDatabase::computeBinaryHash(identifier);
+                    target.previouslyFailed = existing != nullptr && existing->status != PluginScanDatabase::Status::Scanned;
+                    plan.targets.push_back(std::move(target));
+                    continue;
+                }
+
+                target.previouslyFailed = existing->status != PluginScanDatabase::Status::Scanned;
+                target.fingerprint = PluginScanDatabase::computeQuickFingerprint(identifier);
+                if (!target.fingerprint.hasFile())
+                {
+                    // No file to fingerprint (e.g. an Audio Unit ID): ask the format instead.
+                    const bool stale = std::any_of(existing->descriptions.begin(),
+                                                   existing->descriptions.end(),
+                                                   [format](const juce::PluginDescription& description)
+                                                   {
+                                                       return format->pluginNeedsRescanning(description);
+                                                   });
+                    if (!stale)
+                    {
+                        plan.unchanged.push_back(*existing);
+                        continue;
+                    }
+                }
+                else if (target.fingerprint.totalBytes == existing->fingerprint.totalBytes
+                         && target.fingerprint.newestModificationMs == existing->fingerprint.newestModificationMs)
+                {
+                    plan.unchanged.push_back(*existing);
+                    continue;
+                }
+                else
+                {
+                    // Touched but possibly identical (reinstall, copy): only rescan if the code differs.
+                    target.fingerprint.binaryHash = PluginScanDatabase::computeBinaryHash(identifier);
+                    if (target.fingerprint.binaryHash.isNotEmpty()
+                        && target.fingerprint.binaryHash == existing->fingerprint.binaryHash)
+                    {
+                        auto refreshed = *existing;
+                        refreshed.fingerprint = target.fingerprint;
+                        plan.unchanged.push_back(std::move(refreshed));
+                        continue;
+                    }
+                }
+
+                if (target.fingerprint.binaryHash.isEmpty())
+                    target.fingerprint.binaryHash = PluginScanDatabase::computeBinaryHash(identifier);
+                plan.targets.push_back(std::move(target));
+            }
+
+            for (const auto* entry : snapshot.getEntriesForFormat(formatName))
+                if (!found.contains(entry->fileOrIdentifier))
+                    plan.removed.emplace_back(entry->formatName, entry->fileOrIdentifier);
+        }
+    }
+
+    void PluginScanner::applyPlan(Plan& plan)
+    {
+        for (const auto& [formatName, fileOrIdentifier] : plan.removed)
+        {
+            database.remove(formatName, fileOrIdentifier);
+            replaceKnownTypes(formatName, fileOrIdentifier, {});
+            knownPluginList.removeFromBlacklist(fileOrIdentifier);
+        }
+
+        for (auto& entry : plan.unchanged)
+        {
+            if (entry.status == PluginScanDatabase::Status::Scanned)
+            {
+                for (const auto& description : entry.descriptions)
+                    knownPluginList.addType(description);
+            }
+            else if (entry.status != PluginScanDatabase::Status::Failed)
+            {
+                knownPluginList.addToBlacklist(entry.fileOrIdentifier);
+            }
+            database.store(std::move(entry));
+        }
+
+        numUnchanged = static_cast<int>(plan.unchanged.size());
+        targets = std::move(plan.targets);
+        nextTarget = 0;
+    }
+
+    void PluginScanner::poll()
+    {
+        if (state == State::Planning)
+        {
+            if (planJob == nullptr || !planJob->finished.load(std::memory_order_acquire))
+                return;
+
+            applyPlan(planJob->plan);
+            planJob.reset();
+            state = State::Scanning;
+        }
+
+        if (state != State::Scanning)
+            return;
+
+        const double nowMs = juce::Time::getMillisecondCounterHiRes();
+        for (auto it = running.begin(); it != running.end();)
+        {
+            const bool timedOut = it->process->isRunning()
+                               && nowMs - it->startMs > static_cast<double>(activeOptions.perPluginTimeoutMs);
+            if (it->process->isRunning() && !timedOut)
+            {
+                ++it;
+                continue;
+            }
+
+            completeScan(*it, timedOut);
+            it = running.erase(it);
+        }
+
+        while (static_cast<int>(running.size()) < activeOptions.maxConcurrentScans && nextTarget < targets.size())
+        {
+            const auto& target = targets[nextTarget++];
+            if (!launchScan(target))
+            {
+                PluginScanDatabase::Entry entry;
+                entry.formatName = target.formatName;
+                entry.fileOrIdentifier = target.fileOrIdentifier;
+                entry.fingerprint = target.fingerprint;
+                entry.status = PluginScanDatabase::Status::Failed;
+                entry.failureReason = "Unable to launch isolated plugin scan process.";
+                ++numScanned;
+                if (onPluginScanned != nullptr)
+                    onPluginScanned(entry, target.previouslyFailed);
+            }
+        }
+
+        if (running.empty() && nextTarget >= targets.size())
+            finish();
+    }
+
+    bool PluginScanner::launchScan(const Target& target)
+    {
+        RunningScan scan;
+        scan.target = target;
+        scan.resultFile = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                              .getNonexistentChildFile("sampledex-plugin-scan", ".xml", false);
+
+        const juce::String command = activeOptions.hostExecutable.getFullPathName().quoted()
+                                   + " --plugin-scan-file=" + target.fileOrIdentifier.quoted()
+                                   + " --plugin-scan-format=" + target.formatName.quoted()
+                                   + " --out=" + scan.resultFile.getFullPathName().quoted();
+
+        scan.process = std::make_unique<juce::ChildProcess>();
+        if (!scan.process->start(command))
+            return false;
+
+        scan.startMs = juce::Time::getMillisecondCounterHiRes();
+        running.push_back(std::move(scan));
+        return true;
+    }
+
+    void PluginScanner::completeScan(RunningScan& scan, bool timedOut)
+    {
+        PluginScanDatabase::Entry entry;
+        entry.formatName = scan.target.formatName;
+        entry.fileOrIdentifier = scan.target.fileOrIdentifier;
+        entry.fingerprint = scan.target.fingerprint;
+        entry.scanMillis = static_cast<int>(juce::Time::getMillisecondCounterHiRes() - scan.startMs);
+
+        if (timedOut)
+        {
+            scan.process->kill();
+            entry.status = PluginScanDatabase::Status::TimedOut;
+            entry.failureReason = "timed out after " + juce::String(entry.scanMillis) + " ms";
+        }
+        else
+        {
+            const auto output = scan.process->readAllProcessOutput().trim();
+            const auto lastLine = output.fromLastOccurrenceOf("\n", false, false).trim();
+            if (lastLine.startsWithIgnoreCase("OK"))
+            {
+                if (std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(scan.resultFile)); xml != nullptr)
+                {
+                    for (auto* pluginXml : xml->getChildIterator())
+                    {
+                        juce::PluginDescription description;
+                        if (description.loadFromXml(*pluginXml))
+                            entry.descriptions.push_back(description);
+                    }
+                }
+                entry.status = entry.descriptions.empty() ? PluginScanDatabase::Status::Failed
+                                                          : PluginScanDatabase::Status::Scanned;
+                if (entry.descriptions.empty())
+                    entry.failureReason = "scan result could not be read";
+            }
+            else if (output.containsIgnoreCase("ERROR:"))
+            {
+                // The child reported the failure itself, so the plugin did not take it down.
+                entry.status = PluginScanDatabase::Status::Failed;
+                entry.failureReason = output.fromLastOccurrenceOf("ERROR:", false, true).trim();
+            }
+            else
+            {
+                entry.status = PluginScanDatabase::Status::Crashed;
+                entry.failureReason = "crashed";
+            }
+        }
+        scan.resultFile.deleteFile();
+
+        if (entry.status == PluginScanDatabase::Status::Scanned)
+        {
+            replaceKnownTypes(entry.formatName, entry.fileOrIdentifier, entry.descriptions);
+            knownPluginList.removeFromBlacklist(entry.fileOrIdentifier);
+        }
+        else
+        {
+            replaceKnownTypes(entry.formatName, entry.fileOrIdentifier, {});
+            if (entry.status != PluginScanDatabase::Status::Failed)
+                knownPluginList.addToBlacklist(entry.fileOrIdentifier);
+        }
+
+        ++numScanned;
+        database.store(entry);
+        if (onPluginScanned != nullptr)
+            onPluginScanned(entry, scan.target.previouslyFailed);
+    }
+
+    void PluginScanner::replaceKnownTypes(const juce::String& formatName,
+                                          const juce::String& fileOrIdentifier,
+                                          const std::vector<juce::PluginDescription>& descriptions)
+    {
+        for (const auto& existing : knownPluginList.getTypes())
+        {
+            if (existing.pluginFormatName == formatName && existing.fileOrIdentifier == fileOrIdentifier)
+                knownPluginList.removeType(existing);
+        }
+
+        for (const auto& description : descriptions)
+            knownPluginList.addType(description);
+    }
+
+    void PluginScanner::cancel()
+    {
+        if (planJob != nullptr)
+            planJob->cancelled.store(true, std::memory_order_relaxed);
+        planJob.reset();
+
+        for (auto& scan : running)
+        {
+            if (scan.process->isRunning())
+                scan.process->kill();
+            scan.resultFile.deleteFile();
+        }
+        running.clear();
+        targets.clear();
+        nextTarget = 0;
+
+        if (state != State::Idle)
+            database.saveTo(databaseFile);
+        state = State::Idle;
+    }
+
+    void PluginScanner::finish()
+    {
+        database.saveTo(databaseFile);
+        state = State::Idle;
+        targets.clear();
+        nextTarget = 0;
+        if (onFinished != nullptr)
+            onFinished();
+    }
+}
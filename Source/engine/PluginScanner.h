@@ -0,0 +1,182 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace sampledex
+{
+    // Persistent record of every plugin file the scanner has inspected, keyed by format
+    // and file (or identifier, for formats such as Audio Units that are not files).
+    // Each entry keeps the fingerprint the binary had when it was scanned, so a rescan
+    // only has to open what was added or changed since.
+    class PluginScanDatabase final
+    {
+    public:
+        enum class Status
+        {
+            Scanned,
+            Failed,   // the scanner ran but found no usable plugin
+            Crashed,
+            TimedOut
+        };
+
+        struct Fingerprint
+        {
+            juce::int64 totalBytes = -1;
+            juce::int64 newestModificationMs = 0;
+            juce::String binaryHash;
+
+            bool hasFile() const noexcept { return totalBytes >= 0; }
+        };
+
+        struct Entry
+        {
+            juce::String formatName;
+            juce::String fileOrIdentifier;
+            Fingerprint fingerprint;
+            Status status = Status::Scanned;
+            juce::String failureReason;
+            int scanMillis = 0;
+            std::vector<juce::PluginDescription> descriptions;
+        };
+
+        bool loadFrom(const juce::File& file);
+        bool saveTo(const juce::File& file) const;
+
+        const Entry* find(const juce::String& formatName, const juce::String& fileOrIdentifier) const;
+        void store(Entry entry);
+        void remove(const juce::String& formatName, const juce::String& fileOrIdentifier);
+        std::vector<const Entry*> getEntriesForFormat(const juce::String& formatName) const;
+        int size() const noexcept { return static_cast<int>(entries.size()); }
+
+        // Byte count and newest modification time over the binaries of a plugin file or
+        // bundle. Returns an empty fingerprint for identifiers that do not name a file.
+        static Fingerprint computeQuickFingerprint(const juce::String& fileOrIdentifier);
+
+        // Hashes the length, head and tail of each binary: enough to tell two builds
+        // apart without reading hundreds of megabytes of embedded resources.
+        static juce::String computeBinaryHash(const juce::String& fileOrIdentifier);
+
+        static juce::String statusToString(Status status);
+        static Status statusFromString(const juce::String& text);
+
+    private:
+        static juce::String makeKey(const juce::String& formatName, const juce::String& fileOrIdentifier);
+
+        std::map<juce::String, Entry> entries;
+    };
+
+    // Scans plugins with a pool of child processes (this executable started with
+    // --plugin-scan-file), one plugin file per child, so a plugin that hangs or crashes
+    // only costs its own timeout. Enumerating and fingerprinting the plugin folders runs
+    // on a worker; binaries whose fingerprint is unchanged are answered from the database
+    // instead of being opened again.
+    // All public calls belong to the message thread; poll() is driven from a timer.
+    class PluginScanner final
+    {
+    public:
+        struct Options
+        {
+            juce::File hostExecutable;
+            juce::StringArray formatNames; // scanned in this order
+            int maxConcurrentScans = 4;
+            int perPluginTimeoutMs = 45000;
+            bool rescanEverything = false;
+        };
+
+        PluginScanner(juce::AudioPluginFormatManager& pluginFormatManager,
+                      juce::KnownPluginList& pluginList,
+                      const juce::File& databaseFile);
+        ~PluginScanner();
+
+        bool start(const Options& options);
+        void poll();
+        void cancel();
+
+        bool isScanning() const noexcept { return state != State::Idle; }
+        bool isPlanning() const noexcept { return state == State::Planning; }
+        int getNumToScan() const noexcept { return static_cast<int>(targets.size()); }
+        int getNumScanned() const noexcept { return numScanned; }
+        int getNumUnchanged() const noexcept { return numUnchanged; }
+        int getNumRunning() const noexcept { return static_cast<int>(running.size()); }
+        const PluginScanDatabase& getDatabase() const noexcept { return database; }
+
+        // Called for every binary that was actually scanned, with whether its previous
+        // scan had failed.
+        std::function<void(const PluginScanDatabase::Entry& entry, bool previouslyFailed)> onPluginScanned;
+        std::function<void()> onFinished;
+
+        static juce::FileSearchPath getSearchPathForFormat(juce::AudioPluginFormat& format);
+
+    private:
+        enum class State
+        {
+            Idle,
+            Planning,
+            Scanning
+        };
+
+        struct Target
+        {
+            juce::String formatName;
+            juce::String fileOrIdentifier;
+            PluginScanDatabase::Fingerprint fingerprint;
+            bool previouslyFailed = false;
+        };
+
+        struct Plan
+        {
+            std::vector<Target> targets;
+            std::vector<PluginScanDatabase::Entry> unchanged;
+            std::vector<std::pair<juce::String, juce::String>> removed; // format, file
+        };
+
+        struct PlanJob
+        {
+            std::atomic<bool> cancelled { false };
+            std::atomic<bool> finished { false };
+            Plan plan;
+        };
+
+        struct RunningScan
+        {
+            Target target;
+            std::unique_ptr<juce::ChildProcess> process;
+            juce::File resultFile;
+            double startMs = 0.0;
+        };
+
+        static void buildPlan(juce::AudioPluginFormatManager& formatManager,
+                              const PluginScanDatabase& snapshot,
+                              const Options& options,
+                              PlanJob& job);
+        void applyPlan(Plan& plan);
+        bool launchScan(const Target& target);
+        void completeScan(RunningScan& scan, bool timedOut);
+        void replaceKnownTypes(const juce::String& formatName,
+                               const juce::String& fileOrIdentifier,
+                               const std::vector<juce::PluginDescription>& descriptions);
+        void finish();
+
+        juce::AudioPluginFormatManager& formatManager;
+        juce::KnownPluginList& knownPluginList;
+        juce::File databaseFile;
+        PluginScanDatabase database;
+        juce::ThreadPool planPool { 1 };
+        std::shared_ptr<PlanJob> planJob;
+        Options activeOptions;
+        State state = State::Idle;
+        std::vector<Target> targets;
+        size_t nextTarget = 0;
+        std::vector<RunningScan> running;
+        int numScanned = 0;
+        int numUnchanged = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginScanner)
+    };
+}
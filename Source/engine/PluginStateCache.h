@@ -0,0 +1,123 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace sampledex
+{
+    // A plugin state as it moves between a Track, the project file and the restore
+    // pipeline. Normally one representation is set: raw bytes from the plugin, inline
+    // base64 from the project XML, or an external chunk file written next to the project.
+    struct PluginStateBlob
+    {
+        std::shared_ptr<const juce::MemoryBlock> data;
+        juce::String encoded;
+        juce::File chunkFile;
+        juce::int64 sizeBytes = 0;
+        juce::String hash;
+
+        bool isEmpty() const noexcept
+        {
+            return data == nullptr && encoded.isEmpty() && chunkFile == juce::File();
+        }
+
+        bool read(juce::MemoryBlock& out) const
+        {
+            out.reset();
+            if (data != nullptr)
+            {
+                out = *data;
+                return true;
+            }
+            if (encoded.isNotEmpty())
+                return out.fromBase64Encoding(encoded);
+            if (chunkFile.existsAsFile() && chunkFile.loadFileAsData(out))
+                return sizeBytes <= 0 || static_cast<juce::int64>(out.getSize()) == sizeBytes;
+            return false;
+        }
+
+        juce::String toBase64() const
+        {
+            if (encoded.isNotEmpty())
+                return encoded;
+            juce::MemoryBlock block;
+            return read(block) ? block.toBase64Encoding() : juce::String();
+        }
+
+        // Fast 64-bit content hash; it names chunk files and detects unchanged states, so
+        // it does not need to be cryptographic, only cheap on states of hundreds of MB.
+        static juce::String hashBytes(const void* bytes, size_t numBytes)
+        {
+            constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15ull;
+            std::uint64_t hashValue = 0xcbf29ce484222325ull ^ static_cast<std::uint64_t>(numBytes);
+            const auto* byteData = static_cast<const std::uint8_t*>(bytes);
+            size_t offset = 0;
+            for (; offset + sizeof(std::uint64_t) <= numBytes; offset += sizeof(std::uint64_t))
+            {
+                std::uint64_t word = 0;
+                std::memcpy(&word, byteData + offset, sizeof(word));
+                hashValue = (hashValue ^ word) * multiplier;
+                hashValue ^= hashValue >> 31;
+            }
+            for (; offset < numBytes; ++offset)
+                hashValue = (hashValue ^ byteData[offset]) * 0x100000001b3ull;
+
+            return juce::String::toHexString(static_cast<juce::int64>(hashValue)).paddedLeft('0', 16);
+        }
+
+        static PluginStateBlob fromMemory(std::shared_ptr<const juce::MemoryBlock> state)
+        {
+            PluginStateBlob blob;
+            if (state == nullptr)
+                return blob;
+            blob.sizeBytes = static_cast<juce::int64>(state->getSize());
+            blob.hash = hashBytes(state->getData(), state->getSize());
+            blob.data = std::move(state);
+            return blob;
+        }
+
+        static PluginStateBlob fromMemory(juce::MemoryBlock&& state)
+        {
+            return fromMemory(std::make_shared<const juce::MemoryBlock>(std::move(state)));
+        }
+    };
+
+    // Counts parameter and state change notifications from one plugin instance, so a
+    // cached copy of its state can be reused for as long as nothing reported a change.
+    // Parameter callbacks may arrive on the audio thread; counting is lock-free.
+    class PluginStateChangeTracker final : public juce::AudioProcessorListener
+    {
+    public:
+        explicit PluginStateChangeTracker(juce::AudioProcessor& processorToWatch)
+            : processor(processorToWatch)
+        {
+            processor.addListener(this);
+        }
+
+        ~PluginStateChangeTracker() override
+        {
+            processor.removeListener(this);
+        }
+
+        std::uint64_t getChangeCount() const noexcept { return changeCount.load(std::memory_order_acquire); }
+        void markChanged() noexcept { changeCount.fetch_add(1, std::memory_order_acq_rel); }
+
+        void audioProcessorParameterChanged(juce::AudioProcessor*, int, float) override { markChanged(); }
+
+        void audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails& details) override
+        {
+            // A latency change alone does not touch the saved state.
+            if (details.programChanged || details.nonParameterStateChanged || details.parameterInfoChanged)
+                markChanged();
+        }
+
+    private:
+        juce::AudioProcessor& processor;
+        std::atomic<std::uint64_t> changeCount { 0 };
+
+        JUCE_DECLARE_NON_COPYABLE(PluginStateChangeTracker)
+    };
+}
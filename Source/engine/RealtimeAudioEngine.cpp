@@ -1,4 +1,5 @@
 #include "RealtimeAudioEngine.h"
+#include "RealtimeSafetyMonitor.h"
 
 namespace sampledex
 {
@@ -22,25 +23,38 @@ namespace sampledex
         }
     }
 
-    static float processSoftClipOversampled2x(float sample,
-                                              float drive,
-                                              float normaliser,
-                                              float& previousInput) noexcept
+    // Output-stage cleanup: drops non-finite samples and clamps runaway levels before the
+    // master chain sees them.
+    static void clampAudioBuffer(juce::AudioBuffer<float>& buffer, int numSamples)
     {
-        const float midpoint = 0.5f * (previousInput + sample);
-        const float clippedMid = std::tanh(midpoint * drive) * normaliser;
-        const float clippedCurrent = std::tanh(sample * drive) * normaliser;
-        previousInput = sample;
-        return 0.5f * (clippedMid + clippedCurrent);
+        const int samples = juce::jmin(numSamples, buffer.getNumSamples());
+        if (samples <= 0)
+            return;
+
+        constexpr float clampAbs = 6.0f;
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* write = buffer.getWritePointer(ch);
+            if (write == nullptr)
+                continue;
+            for (int i = 0; i < samples; ++i)
+            {
+                float s = write[i];
+                if (!std::isfinite(s))
+                    s = 0.0f;
+                write[i] = juce::jlimit(-clampAbs, clampAbs, s);
+            }
+        }
     }
 
-    static void runRealtimeTrackGraphJob(void* context, int index)
-    {
-        auto* jobs = static_cast<RealtimeTrackGraphJob*>(context);
-        if (jobs == nullptr || index < 0)
-            return;
+    static constexpr float auxMonitorSafeDrive = 1.18f;
+    static constexpr float masterSoftClipDrive = 1.15f;
+    static constexpr float masterSoftClipDriveMonitorSafe = 1.22f;
+    static constexpr float masterLimiterCeiling = 0.985f;
+    static constexpr float masterLimiterRelease = 0.0025f;
 
-        auto& job = jobs[index];
+    static void processTrackGraphJob(RealtimeTrackGraphJob& job)
+    {
         if (!job.processTrack || job.track == nullptr || job.mainBuffer == nullptr || job.sendBuffer == nullptr || job.midi == nullptr)
             return;
 
@@ -51,11 +65,34 @@ namespace sampledex
                                         *job.midi,
                                         job.sourceAudio,
                                         job.monitorInput,
-                                        job.monitorSafeInput);
+                                        job.monitorSafeInput,
+                                        job.sourceIsRenderCache,
+                                        job.chainOutputTap,
+                                        job.sleepAllowed);
         sanitizeAudioBuffer(*job.mainBuffer, job.blockSamples);
         sanitizeAudioBuffer(*job.sendBuffer, job.blockSamples);
     }
 
+    static void runRealtimeTrackGraphJob(void* context, int index)
+    {
+        auto* jobs = static_cast<RealtimeTrackGraphJob*>(context);
+        if (jobs == nullptr || index < 0)
+            return;
+
+        // Graph workers run on their own threads, so they need their own guard.
+        RealtimeSafetyMonitor::ScopedRealtimeContext realtimeSafetyScope;
+        auto& job = jobs[index];
+        if (job.offlineRender)
+        {
+            // Offline renders let plugins do non-realtime work (allocation, file I/O).
+            RealtimeSafetyMonitor::ScopedSuspend offlineScope;
+            processTrackGraphJob(job);
+            return;
+        }
+
+        processTrackGraphJob(job);
+    }
+
     void RealtimeAudioEngine::runTrackGraph(RealtimeGraphScheduler& scheduler,
                                             const TransportBlockContext& context,
                                             RealtimeMixInputs& mixInputs,
@@ -64,11 +101,14 @@ namespace sampledex
                                             std::array<juce::AudioBuffer<float>, Track::maxSendBuses>& auxBusBuffers,
                                             const PdcFn& pdcFn)
     {
-        const bool useParallelGraph = !context.offlineRenderActive
-            && !context.lowLatencyProcessing
-            && context.numSamples >= 256
-            && scheduler.getWorkerCount() > 0
-            && mixInputs.activeTrackCount >= 4;
+        // Offline there is no deadline to protect, so any two tracks are worth splitting;
+        // live, small graphs and low-latency blocks stay on the callback thread.
+        const bool useParallelGraph = scheduler.getWorkerCount() > 0
+            && (context.offlineRenderActive
+                    ? mixInputs.activeTrackCount >= 2
+                    : (!context.lowLatencyProcessing
+                       && context.numSamples >= 256
+                       && mixInputs.activeTrackCount >= 4));
 
         if (useParallelGraph)
             scheduler.run(mixInputs.activeTrackCount, jobs.data(), &runRealtimeTrackGraphJob);
@@ -121,100 +161,167 @@ namespace sampledex
         }
     }
 
-    void RealtimeAudioEngine::applyOutputLimiting(const TransportBlockContext& context,
-                                                   RealtimeMixInputs& mixInputs,
-                                                   juce::AudioBuffer<float>& outputBuffer,
-                                                   int startSample,
-                                                   float& masterGainSmoothingState,
-                                                   float& masterLimiterGainState,
-                                                   std::array<float, 2>& masterLimiterPrevInput,
-                                                   std::array<float, 2>& masterTruePeakMidpointPrevInput,
-                                                   std::array<float, 2>& outputDcPrevInput,
-                                                   std::array<float, 2>& outputDcPrevOutput,
-                                                   RealtimeMixOutputs& mixOutputs)
+    void RealtimeAudioEngine::processAuxReturns(const TransportBlockContext& context,
+                                                const RealtimeAuxReturnSettings& settings,
+                                                std::array<juce::AudioBuffer<float>, Track::maxSendBuses>& auxBusBuffers,
+                                                std::array<juce::Reverb, Track::maxSendBuses>& auxReverbs,
+                                                std::array<float, Track::maxSendBuses>* busPeaks)
     {
-        const int outputChannels = outputBuffer.getNumChannels();
-        mixOutputs.outputChannels = outputChannels;
-        for (int i = 0; i < context.numSamples; ++i)
+        const int numSamples = context.numSamples;
+        for (size_t bus = 0; bus < auxBusBuffers.size(); ++bus)
         {
-            masterGainSmoothingState += (mixInputs.targetMasterGain - masterGainSmoothingState) * mixInputs.masterGainDezipperCoeff;
-            float overPeak = 0.0f;
-            for (int ch = 0; ch < outputChannels; ++ch)
+            auto& auxBus = auxBusBuffers[bus];
+            auto& reverb = auxReverbs[bus];
+            const int auxChannels = auxBus.getNumChannels();
+            float peak = 0.0f;
+            if (numSamples <= 0 || auxBus.getNumSamples() < numSamples || auxChannels <= 0
+                || settings.returnGain <= 0.0001f)
             {
-                auto* write = outputBuffer.getWritePointer(ch, startSample);
-                if (write == nullptr)
-                    continue;
-                float sample = write[i] * masterGainSmoothingState;
-                if (mixInputs.useSoftClip)
+                auxBus.clear();
+                if (busPeaks != nullptr)
+                    (*busPeaks)[bus] = peak;
+                continue;
+            }
+
+            clampAudioBuffer(auxBus, numSamples);
+            // Low-latency blocks skip the reverb but keep the dry return.
+            if (settings.fxEnabled && !context.lowLatencyProcessing)
+            {
+                int firstMonoChannel = 0;
+                if (auxChannels >= 2)
                 {
-                    auto& prevIn = masterTruePeakMidpointPrevInput[static_cast<size_t>(juce::jmin(ch, 1))];
-                    sample = processSoftClipOversampled2x(sample, mixInputs.softClipDrive, mixInputs.softClipNormaliser, prevIn);
+                    reverb.processStereo(auxBus.getWritePointer(0), auxBus.getWritePointer(1), numSamples);
+                    firstMonoChannel = 2;
                 }
-                write[i] = sample;
-                overPeak = juce::jmax(overPeak, std::abs(sample));
+
+                // Any channels above stereo are treated as mono for safety.
+                for (int ch = firstMonoChannel; ch < auxChannels; ++ch)
+                    reverb.processMono(auxBus.getWritePointer(ch), numSamples);
             }
 
-            const float targetGain = (mixInputs.limiterEnabled && overPeak > mixInputs.limiterCeiling) ? (mixInputs.limiterCeiling / overPeak) : 1.0f;
-            if (targetGain < masterLimiterGainState)
-                masterLimiterGainState += (targetGain - masterLimiterGainState) * mixInputs.limiterAttack;
-            else
-                masterLimiterGainState += (targetGain - masterLimiterGainState) * mixInputs.limiterRelease;
+            auxBus.applyGain(0, numSamples, settings.returnGain);
+            clampAudioBuffer(auxBus, numSamples);
 
-            for (int ch = 0; ch < outputChannels; ++ch)
+            if (settings.fxEnabled && settings.monitorSafe)
             {
-                auto* write = outputBuffer.getWritePointer(ch, startSample);
-                if (write == nullptr)
-                    continue;
-                float limited = write[i] * masterLimiterGainState;
-                limited = juce::jlimit(-mixInputs.limiterCeiling, mixInputs.limiterCeiling, limited);
-                write[i] = limited;
-                masterLimiterPrevInput[static_cast<size_t>(juce::jmin(ch, 1))] = limited;
+                const float normalise = 1.0f / std::tanh(auxMonitorSafeDrive);
+                for (int ch = 0; ch < auxChannels; ++ch)
+                {
+                    auto* write = auxBus.getWritePointer(ch);
+                    for (int i = 0; i < numSamples; ++i)
+                        write[i] = std::tanh(write[i] * auxMonitorSafeDrive) * normalise;
+                }
             }
+
+            if (busPeaks != nullptr)
+            {
+                for (int ch = 0; ch < auxChannels; ++ch)
+                    peak = juce::jmax(peak, auxBus.getMagnitude(ch, 0, numSamples));
+                (*busPeaks)[bus] = peak;
+            }
+        }
+    }
+
+    void RealtimeAudioEngine::renderOutputStage(const TransportBlockContext& context,
+                                                const RealtimeOutputStage& stage,
+                                                RealtimeMixInputs& masterInputs,
+                                                juce::AudioBuffer<float>& mixBuffer,
+                                                std::array<juce::AudioBuffer<float>, Track::maxSendBuses>& auxBusBuffers,
+                                                juce::AudioBuffer<float>& outputBuffer,
+                                                int startSample,
+                                                std::array<float, 2>& boundaryPrevSample,
+                                                MasterLimiter& masterLimiter,
+                                                RealtimeMixOutputs& mixOutputs)
+    {
+        const int numSamples = context.numSamples;
+        if (numSamples <= 0 || startSample + numSamples > outputBuffer.getNumSamples())
+            return;
+
+        // Sum.
+        const int outputChannels = juce::jmin(mixBuffer.getNumChannels(), outputBuffer.getNumChannels());
+        clampAudioBuffer(mixBuffer, numSamples);
+        for (int ch = 0; ch < outputChannels; ++ch)
+        {
+            outputBuffer.addFrom(ch, startSample, mixBuffer, ch, 0, numSamples);
+            for (const auto& auxBus : auxBusBuffers)
+                if (ch < auxBus.getNumChannels())
+                    outputBuffer.addFrom(ch, startSample, auxBus, ch, 0, numSamples);
         }
 
-        if (mixInputs.outputDcHighPassEnabled)
+        // Transport boundary fades.
+        if (stage.fadeInAtStart || stage.fadeOutAtEnd)
         {
-            constexpr float dcBlockCoeff = 0.995f;
-            for (int ch = 0; ch < juce::jmin(outputChannels, 2); ++ch)
+            const int boundaryFadeSamples = juce::jmin(64, juce::jmax(1, numSamples / 8));
+            for (int ch = 0; ch < outputChannels; ++ch)
             {
                 auto* write = outputBuffer.getWritePointer(ch, startSample);
-                if (write == nullptr)
-                    continue;
+                if (stage.fadeInAtStart)
+                {
+                    const float first = write[0];
+                    for (int i = 0; i < boundaryFadeSamples; ++i)
+                        write[i] = first * (static_cast<float>(i + 1) / static_cast<float>(boundaryFadeSamples));
+                }
 
-                float prevIn = outputDcPrevInput[static_cast<size_t>(ch)];
-                float prevOut = outputDcPrevOutput[static_cast<size_t>(ch)];
-                for (int i = 0; i < context.numSamples; ++i)
+                if (stage.fadeOutAtEnd)
                 {
-                    const float in = write[i];
-                    const float out = in - prevIn + (dcBlockCoeff * prevOut);
-                    write[i] = out;
-                    prevIn = in;
-                    prevOut = out;
+                    const float last = write[numSamples - 1];
+                    for (int i = 0; i < boundaryFadeSamples; ++i)
+                    {
+                        const float t = 1.0f - (static_cast<float>(i + 1) / static_cast<float>(boundaryFadeSamples));
+                        write[numSamples - boundaryFadeSamples + i] = last * t;
+                    }
                 }
-                outputDcPrevInput[static_cast<size_t>(ch)] = prevIn;
-                outputDcPrevOutput[static_cast<size_t>(ch)] = prevOut;
             }
         }
 
-        constexpr float hardOutputClamp = 1.25f;
-        constexpr float faultThreshold = 24.0f;
-        for (int ch = 0; ch < outputChannels; ++ch)
+        // Block continuity.
+        const int continuityFadeSamples = juce::jmin(32, numSamples);
+        for (int ch = 0; ch < juce::jmin(outputChannels, 2); ++ch)
         {
             auto* write = outputBuffer.getWritePointer(ch, startSample);
-            if (write == nullptr)
-                continue;
-            for (int i = 0; i < context.numSamples; ++i)
+            const float previousTail = boundaryPrevSample[static_cast<size_t>(ch)];
+            const float currentHead = write[0];
+            for (int i = 0; i < continuityFadeSamples; ++i)
             {
-                float sample = write[i];
-                if (!std::isfinite(sample) || std::abs(sample) > faultThreshold)
-                {
-                    mixOutputs.severeOutputFault = true;
-                    sample = 0.0f;
-                }
-                else
-                    sample = juce::jlimit(-hardOutputClamp, hardOutputClamp, sample);
-                write[i] = sample;
+                const float t = static_cast<float>(i + 1) / static_cast<float>(continuityFadeSamples);
+                write[i] = previousTail + ((currentHead - previousTail) * t);
             }
+            boundaryPrevSample[static_cast<size_t>(ch)] = write[numSamples - 1];
         }
+
+        if (stage.rampStartGain < 1.0f || stage.rampEndGain < 1.0f)
+            for (int ch = 0; ch < outputChannels; ++ch)
+                outputBuffer.applyGainRamp(ch, startSample, numSamples, stage.rampStartGain, stage.rampEndGain);
+
+        // Master chain.
+        masterInputs.softClipDrive = stage.monitorSafe ? masterSoftClipDriveMonitorSafe : masterSoftClipDrive;
+        masterInputs.softClipNormaliser = 1.0f / std::tanh(masterInputs.softClipDrive);
+        masterInputs.limiterCeiling = masterLimiterCeiling;
+        masterInputs.limiterRelease = masterLimiterRelease;
+        applyOutputLimiting(context, masterInputs, outputBuffer, startSample, masterLimiter, mixOutputs);
+    }
+
+    void RealtimeAudioEngine::applyOutputLimiting(const TransportBlockContext& context,
+                                                   RealtimeMixInputs& mixInputs,
+                                                   juce::AudioBuffer<float>& outputBuffer,
+                                                   int startSample,
+                                                   MasterLimiter& masterLimiter,
+                                                   RealtimeMixOutputs& mixOutputs)
+    {
+        mixOutputs.outputChannels = outputBuffer.getNumChannels();
+
+        MasterLimiter::Settings settings;
+        settings.gainValues = mixInputs.masterGainValues;
+        settings.targetGain = mixInputs.targetMasterGain;
+        settings.gainDezipperCoeff = mixInputs.masterGainDezipperCoeff;
+        settings.dcBlockerEnabled = mixInputs.outputDcHighPassEnabled;
+        settings.softClipEnabled = mixInputs.useSoftClip;
+        settings.softClipDrive = mixInputs.softClipDrive;
+        settings.softClipNormaliser = mixInputs.softClipNormaliser;
+        settings.limiterEnabled = mixInputs.limiterEnabled;
+        settings.ceiling = mixInputs.limiterCeiling;
+        settings.release = mixInputs.limiterRelease;
+        if (masterLimiter.process(outputBuffer, startSample, context.numSamples, settings))
+            mixOutputs.severeOutputFault = true;
     }
 }
@@ -5,6 +5,7 @@
 #include <functional>
 #include <atomic>
 
+#include "MasterLimiter.h"
 #include "RealtimeGraphScheduler.h"
 #include "Track.h"
 
@@ -29,6 +30,10 @@ namespace sampledex
         int blockSamples = 0;
         bool processTrack = false;
         bool monitorSafeInput = false;
+        bool offlineRender = false; // no deadline: plugins may allocate, lock and render non-realtime
+        bool sourceIsRenderCache = false; // sourceAudio stands in for the instrument and inserts
+        juce::AudioBuffer<float>* chainOutputTap = nullptr; // receives the instrument and insert output
+        bool sleepAllowed = false; // nothing scheduled within the pre-roll; the track may sleep once silent
     };
 
     struct RealtimeMixInputs
@@ -43,13 +48,12 @@ namespace sampledex
         bool limiterEnabled = false;
         bool useSoftClip = false;
         float targetMasterGain = 1.0f;
+        const float* masterGainValues = nullptr; // per-sample automated gain; bypasses the dezipper
         float masterGainDezipperCoeff = 0.0015f;
         float softClipDrive = 1.18f;
         float softClipNormaliser = 1.0f;
         float limiterCeiling = 0.985f;
-        float limiterAttack = 0.45f;
         float limiterRelease = 0.0025f;
-        float limiterRecovery = 0.015f;
         std::array<bool, 128>* trackGraphAudible = nullptr;
         std::array<bool, 128>* trackMonitorInputUsed = nullptr;
         std::array<bool, 128>* trackSendFeedbackBlocked = nullptr;
@@ -63,6 +67,22 @@ namespace sampledex
         bool outputDcHighPassEnabled = true;
     };
 
+    struct RealtimeAuxReturnSettings
+    {
+        bool fxEnabled = true;
+        float returnGain = 1.0f;
+        bool monitorSafe = false; // saturate the returns so a runaway reverb cannot spike
+    };
+
+    struct RealtimeOutputStage
+    {
+        bool fadeInAtStart = false; // transport start, note chase or loop wrap
+        bool fadeOutAtEnd = false; // transport stop
+        float rampStartGain = 1.0f; // startup/recovery ramp across the block
+        float rampEndGain = 1.0f;
+        bool monitorSafe = false; // hotter soft clip drive
+    };
+
     struct RealtimeMixOutputs
     {
         bool severeOutputFault = false;
@@ -82,16 +102,33 @@ namespace sampledex
                                   std::array<juce::AudioBuffer<float>, Track::maxSendBuses>& auxBusBuffers,
                                   const PdcFn& pdcFn);
 
+        // Reverb, return gain and monitor-safe saturation on each aux bus. Writes each
+        // bus's peak after processing to busPeaks when given.
+        static void processAuxReturns(const TransportBlockContext& context,
+                                      const RealtimeAuxReturnSettings& settings,
+                                      std::array<juce::AudioBuffer<float>, Track::maxSendBuses>& auxBusBuffers,
+                                      std::array<juce::Reverb, Track::maxSendBuses>& auxReverbs,
+                                      std::array<float, Track::maxSendBuses>* busPeaks);
+
+        // Sums the track mix and aux returns into outputBuffer, applies the boundary and
+        // continuity fades, then the master chain. The caller sets the master gain, soft
+        // clip, limiter and DC switches on masterInputs; the drive and ceiling are shared.
+        static void renderOutputStage(const TransportBlockContext& context,
+                                      const RealtimeOutputStage& stage,
+                                      RealtimeMixInputs& masterInputs,
+                                      juce::AudioBuffer<float>& mixBuffer,
+                                      std::array<juce::AudioBuffer<float>, Track::maxSendBuses>& auxBusBuffers,
+                                      juce::AudioBuffer<float>& outputBuffer,
+                                      int startSample,
+                                      std::array<float, 2>& boundaryPrevSample,
+                                      MasterLimiter& masterLimiter,
+                                      RealtimeMixOutputs& mixOutputs);
+
         static void applyOutputLimiting(const TransportBlockContext& context,
                                         RealtimeMixInputs& mixInputs,
                                         juce::AudioBuffer<float>& outputBuffer,
                                         int startSample,
-                                        float& masterGainSmoothingState,
-                                        float& masterLimiterGainState,
-                                        std::array<float, 2>& masterLimiterPrevInput,
-                                        std::array<float, 2>& masterTruePeakMidpointPrevInput,
-                                        std::array<float, 2>& outputDcPrevInput,
-                                        std::array<float, 2>& outputDcPrevOutput,
+                                        MasterLimiter& masterLimiter,
                                         RealtimeMixOutputs& mixOutputs);
     };
 
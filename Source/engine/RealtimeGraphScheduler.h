@@ -14,6 +14,9 @@ namespace sampledex
     public:
         using JobFn = void(*)(void*, int);
 
+        // Realtime playback uses a few workers; offline renders widen to every core.
+        static constexpr int maxWorkerCount = 32;
+
         RealtimeGraphScheduler() = default;
         ~RealtimeGraphScheduler()
         {
@@ -155,7 +158,6 @@ namespace sampledex
             dispatchGeneration.store(0, std::memory_order_relaxed);
         }
 
-        static constexpr int maxWorkerCount = 8;
         std::vector<std::unique_ptr<Worker>> workers;
         std::atomic<bool> shutdownRequested { false };
         std::atomic<int> nextJobIndex { 0 };
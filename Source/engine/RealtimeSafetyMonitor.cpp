@@ -0,0 +1,395 @@
+#include "RealtimeSafetyMonitor.h"
+
+#if SAMPLEDEX_RT_SAFETY_CHECKS
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if __has_include(<execinfo.h>)
+ #include <execinfo.h>
+ #define SAMPLEDEX_RT_SAFETY_HAS_BACKTRACE 1
+#else
+ #define SAMPLEDEX_RT_SAFETY_HAS_BACKTRACE 0
+#endif
+
+#if defined(__linux__) && defined(__GLIBC__)
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #include <unistd.h>
+ #define SAMPLEDEX_RT_SAFETY_INTERPOSE_LIBC 1
+#else
+ #define SAMPLEDEX_RT_SAFETY_INTERPOSE_LIBC 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+ #define SAMPLEDEX_RT_SAFETY_TLS __attribute__((tls_model("initial-exec")))
+#else
+ #define SAMPLEDEX_RT_SAFETY_TLS
+#endif
+
+namespace sampledex
+{
+    namespace
+    {
+        // Everything below is touched from inside malloc/free, so it must be trivially
+        // constructible and never allocate. Thread-locals use the initial-exec model to
+        // avoid lazy TLS allocation on first access.
+        thread_local int realtimeDepth SAMPLEDEX_RT_SAFETY_TLS = 0;
+        thread_local int suspendDepth SAMPLEDEX_RT_SAFETY_TLS = 0;
+        thread_local int hookDepth SAMPLEDEX_RT_SAFETY_TLS = 0;
+        thread_local int allowedLockDepth SAMPLEDEX_RT_SAFETY_TLS = 0;
+
+        std::atomic<bool> detectorEnabled { false };
+        std::atomic<bool> abortOnViolation { false };
+        std::atomic<std::uint64_t> totalViolations { 0 };
+        std::array<std::atomic<std::uint64_t>, static_cast<size_t>(RealtimeSafetyMonitor::ViolationKind::count)> kindViolations {};
+        std::atomic<int> nextViolationSlot { 0 };
+        std::array<RealtimeSafetyMonitor::Violation, RealtimeSafetyMonitor::maxRecordedViolations> recordedViolations {};
+        std::array<std::atomic<bool>, RealtimeSafetyMonitor::maxRecordedViolations> recordedViolationReady {};
+
+        struct ScopedHookReentry final
+        {
+            ScopedHookReentry() noexcept { ++hookDepth; }
+            ~ScopedHookReentry() noexcept { --hookDepth; }
+        };
+
+        std::uint64_t currentThreadTag() noexcept
+        {
+           #if SAMPLEDEX_RT_SAFETY_INTERPOSE_LIBC
+            return static_cast<std::uint64_t>(pthread_self());
+           #else
+            return reinterpret_cast<std::uint64_t>(&realtimeDepth);
+           #endif
+        }
+
+        void writeRawToStderr(const char* text) noexcept
+        {
+           #if SAMPLEDEX_RT_SAFETY_INTERPOSE_LIBC
+            const auto ignored = ::write(2, text, std::strlen(text));
+            juce::ignoreUnused(ignored);
+           #else
+            std::fputs(text, stderr);
+           #endif
+        }
+
+        void recordViolation(RealtimeSafetyMonitor::ViolationKind kind, std::size_t bytes) noexcept
+        {
+            if (realtimeDepth <= 0 || suspendDepth > 0 || hookDepth > 0)
+                return;
+            if (kind == RealtimeSafetyMonitor::ViolationKind::MutexLock && allowedLockDepth > 0)
+                return;
+            if (!detectorEnabled.load(std::memory_order_relaxed))
+                return;
+
+            ScopedHookReentry reentry;
+            totalViolations.fetch_add(1, std::memory_order_relaxed);
+            kindViolations[static_cast<size_t>(kind)].fetch_add(1, std::memory_order_relaxed);
+
+            const int slot = nextViolationSlot.fetch_add(1, std::memory_order_acq_rel);
+            if (slot < RealtimeSafetyMonitor::maxRecordedViolations)
+            {
+                auto& violation = recordedViolations[static_cast<size_t>(slot)];
+                violation.kind = kind;
+                violation.bytes = bytes;
+                violation.threadTag = currentThreadTag();
+               #if SAMPLEDEX_RT_SAFETY_HAS_BACKTRACE
+                violation.frameCount = ::backtrace(violation.frames, RealtimeSafetyMonitor::maxStackFrames);
+               #else
+                violation.frameCount = 0;
+               #endif
+                recordedViolationReady[static_cast<size_t>(slot)].store(true, std::memory_order_release);
+            }
+
+            if (abortOnViolation.load(std::memory_order_relaxed))
+            {
+                writeRawToStderr("Sampledex realtime safety violation: ");
+                writeRawToStderr(RealtimeSafetyMonitor::getKindName(kind));
+                writeRawToStderr(" called inside realtime context\n");
+                std::abort();
+            }
+        }
+
+        void* allocateForOperatorNew(std::size_t size) noexcept
+        {
+            ScopedHookReentry reentry;
+            return std::malloc(size == 0 ? 1 : size);
+        }
+
+        void* allocateAlignedForOperatorNew(std::size_t size, std::size_t alignment) noexcept
+        {
+            ScopedHookReentry reentry;
+            const std::size_t resolvedAlignment = juce::jmax(alignment, sizeof(void*));
+           #if defined(_WIN32)
+            return _aligned_malloc(size == 0 ? 1 : size, resolvedAlignment);
+           #else
+            void* result = nullptr;
+            if (posix_memalign(&result, resolvedAlignment, size == 0 ? 1 : size) != 0)
+                return nullptr;
+            return result;
+           #endif
+        }
+
+        void releaseForOperatorDelete(void* ptr) noexcept
+        {
+            ScopedHookReentry reentry;
+            std::free(ptr);
+        }
+
+        void releaseAlignedForOperatorDelete(void* ptr) noexcept
+        {
+            ScopedHookReentry reentry;
+           #if defined(_WIN32)
+            _aligned_free(ptr);
+           #else
+            std::free(ptr);
+           #endif
+        }
+    }
+
+    void RealtimeSafetyMonitor::enterRealtimeContext() noexcept { ++realtimeDepth; }
+    void RealtimeSafetyMonitor::exitRealtimeContext() noexcept { realtimeDepth = juce::jmax(0, realtimeDepth - 1); }
+    void RealtimeSafetyMonitor::suspendChecks() noexcept { ++suspendDepth; }
+    void RealtimeSafetyMonitor::resumeChecks() noexcept { suspendDepth = juce::jmax(0, suspendDepth - 1); }
+    void RealtimeSafetyMonitor::allowLocks() noexcept { ++allowedLockDepth; }
+    void RealtimeSafetyMonitor::disallowLocks() noexcept { allowedLockDepth = juce::jmax(0, allowedLockDepth - 1); }
+    bool RealtimeSafetyMonitor::isInRealtimeContext() noexcept { return realtimeDepth > 0; }
+
+    void RealtimeSafetyMonitor::setEnabled(bool shouldBeEnabled) noexcept
+    {
+       #if SAMPLEDEX_RT_SAFETY_HAS_BACKTRACE
+        if (shouldBeEnabled)
+        {
+            // The first backtrace() call lazily loads the unwinder, which allocates.
+            // Prime it here so the first recorded violation does not recurse.
+            void* primeFrames[2] {};
+            ::backtrace(primeFrames, 2);
+        }
+       #endif
+        detectorEnabled.store(shouldBeEnabled, std::memory_order_release);
+    }
+
+    bool RealtimeSafetyMonitor::isEnabled() noexcept
+    {
+        return detectorEnabled.load(std::memory_order_acquire);
+    }
+
+    void RealtimeSafetyMonitor::setAbortOnViolation(bool shouldAbort) noexcept
+    {
+        abortOnViolation.store(shouldAbort, std::memory_order_relaxed);
+    }
+
+    std::uint64_t RealtimeSafetyMonitor::getViolationCount() noexcept
+    {
+        return totalViolations.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t RealtimeSafetyMonitor::getViolationCount(ViolationKind kind) noexcept
+    {
+        if (kind == ViolationKind::count)
+            return 0;
+        return kindViolations[static_cast<size_t>(kind)].load(std::memory_order_relaxed);
+    }
+
+    void RealtimeSafetyMonitor::reset() noexcept
+    {
+        for (auto& ready : recordedViolationReady)
+            ready.store(false, std::memory_order_relaxed);
+        for (auto& count : kindViolations)
+            count.store(0, std::memory_order_relaxed);
+        totalViolations.store(0, std::memory_order_relaxed);
+        nextViolationSlot.store(0, std::memory_order_release);
+    }
+
+    juce::String RealtimeSafetyMonitor::createReport()
+    {
+        ScopedSuspend suspend;
+
+        juce::String report;
+        report << "Realtime safety report: " << juce::String(static_cast<juce::int64>(getViolationCount()))
+               << " violation(s)" << juce::newLine;
+        for (int kindIndex = 0; kindIndex < static_cast<int>(ViolationKind::count); ++kindIndex)
+        {
+            const auto kind = static_cast<ViolationKind>(kindIndex);
+            const auto count = getViolationCount(kind);
+            if (count > 0)
+                report << "  " << getKindName(kind) << ": " << juce::String(static_cast<juce::int64>(count)) << juce::newLine;
+        }
+
+        const int recorded = juce::jmin(maxRecordedViolations, nextViolationSlot.load(std::memory_order_acquire));
+        for (int slot = 0; slot < recorded; ++slot)
+        {
+            if (!recordedViolationReady[static_cast<size_t>(slot)].load(std::memory_order_acquire))
+                continue;
+
+            const auto& violation = recordedViolations[static_cast<size_t>(slot)];
+            report << juce::newLine << "#" << (slot + 1) << " " << getKindName(violation.kind);
+            if (violation.bytes > 0)
+                report << " (" << juce::String(static_cast<juce::int64>(violation.bytes)) << " bytes)";
+            report << " on thread 0x" << juce::String::toHexString(static_cast<juce::int64>(violation.threadTag)) << juce::newLine;
+
+           #if SAMPLEDEX_RT_SAFETY_HAS_BACKTRACE
+            if (violation.frameCount > 0)
+            {
+                char** symbols = ::backtrace_symbols(violation.frames, violation.frameCount);
+                // Skip recordViolation() and the interposer itself.
+                for (int frame = 2; frame < violation.frameCount; ++frame)
+                {
+                    report << "    ";
+                    if (symbols != nullptr)
+                        report << symbols[frame];
+                    else
+                        report << juce::String::toHexString(reinterpret_cast<juce::pointer_sized_int>(violation.frames[frame]));
+                    report << juce::newLine;
+                }
+                std::free(symbols);
+            }
+           #endif
+        }
+
+        if (nextViolationSlot.load(std::memory_order_acquire) > maxRecordedViolations)
+            report << juce::newLine << "(only the first " << maxRecordedViolations << " call sites were recorded)" << juce::newLine;
+
+        return report;
+    }
+}
+
+// --- Interposers ---
+// operator new/delete replacement is portable. Raw malloc and pthread mutex hooks are
+// only installed on glibc, where the executable's definitions shadow libc's through
+// normal symbol resolution and the real implementations are reachable directly.
+
+using sampledex::RealtimeSafetyMonitor;
+
+void* operator new(std::size_t size)
+{
+    sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::OperatorNew, size);
+    if (auto* ptr = sampledex::allocateForOperatorNew(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::OperatorNew, size);
+    if (auto* ptr = sampledex::allocateForOperatorNew(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::OperatorNew, size);
+    return sampledex::allocateForOperatorNew(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::OperatorNew, size);
+    return sampledex::allocateForOperatorNew(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::OperatorNew, size);
+    if (auto* ptr = sampledex::allocateAlignedForOperatorNew(size, static_cast<std::size_t>(alignment)))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::OperatorNew, size);
+    if (auto* ptr = sampledex::allocateAlignedForOperatorNew(size, static_cast<std::size_t>(alignment)))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+    sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::OperatorDelete, 0);
+    sampledex::releaseForOperatorDelete(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+    sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::OperatorDelete, 0);
+    sampledex::releaseForOperatorDelete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { operator delete[](ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    if (ptr == nullptr)
+        return;
+    sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::OperatorDelete, 0);
+    sampledex::releaseAlignedForOperatorDelete(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept { operator delete(ptr, alignment); }
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept { operator delete(ptr, alignment); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept { operator delete(ptr, alignment); }
+
+#if SAMPLEDEX_RT_SAFETY_INTERPOSE_LIBC
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void __libc_free(void*);
+
+    void* malloc(size_t size)
+    {
+        sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::Malloc, size);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::Calloc, count * size);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::Realloc, size);
+        return __libc_realloc(ptr, size);
+    }
+
+    void free(void* ptr)
+    {
+        if (ptr != nullptr)
+            sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::Free, 0);
+        __libc_free(ptr);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        using LockFn = int (*)(pthread_mutex_t*);
+        static std::atomic<LockFn> realLock { nullptr };
+
+        sampledex::recordViolation(RealtimeSafetyMonitor::ViolationKind::MutexLock, 0);
+
+        auto fn = realLock.load(std::memory_order_acquire);
+        if (fn == nullptr)
+        {
+            fn = reinterpret_cast<LockFn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+            if (fn == nullptr)
+                return EINVAL;
+            realLock.store(fn, std::memory_order_release);
+        }
+        return fn(mutex);
+    }
+}
+#endif
+
+#endif // SAMPLEDEX_RT_SAFETY_CHECKS
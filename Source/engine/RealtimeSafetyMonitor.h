@@ -0,0 +1,144 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+
+#ifndef SAMPLEDEX_RT_SAFETY_CHECKS
+ #define SAMPLEDEX_RT_SAFETY_CHECKS 0
+#endif
+
+namespace sampledex
+{
+    // Debug/CI instrumentation that flags heap allocations and blocking mutex locks
+    // made while the calling thread is inside a realtime context.
+    //
+    // Build with -DSAMPLEDEX_RT_SAFETY_CHECKS=ON to enable the interposers. In normal
+    // builds every entry point here compiles down to an empty inline function so the
+    // guards can stay in the audio callback permanently.
+    class RealtimeSafetyMonitor final
+    {
+    public:
+        enum class ViolationKind : int
+        {
+            Malloc = 0,
+            Calloc,
+            Realloc,
+            Free,
+            OperatorNew,
+            OperatorDelete,
+            MutexLock,
+            count
+        };
+
+        static constexpr int maxRecordedViolations = 64;
+        static constexpr int maxStackFrames = 24;
+
+        struct Violation
+        {
+            ViolationKind kind = ViolationKind::Malloc;
+            std::size_t bytes = 0;
+            std::uint64_t threadTag = 0;
+            int frameCount = 0;
+            void* frames[maxStackFrames] {};
+        };
+
+        // Marks the current thread as realtime for the lifetime of the scope. Nests.
+        class ScopedRealtimeContext final
+        {
+        public:
+            ScopedRealtimeContext() noexcept { enterRealtimeContext(); }
+            ~ScopedRealtimeContext() noexcept { exitRealtimeContext(); }
+
+            JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeContext)
+        };
+
+        // Temporarily suspends checking on the current thread, for code that is
+        // known to allocate but is intentionally allowed (e.g. diagnostics).
+        class ScopedSuspend final
+        {
+        public:
+            ScopedSuspend() noexcept { suspendChecks(); }
+            ~ScopedSuspend() noexcept { resumeChecks(); }
+
+            JUCE_DECLARE_NON_COPYABLE(ScopedSuspend)
+        };
+
+        // Lets the current thread take mutexes for the scope; allocations are still
+        // flagged. Only for a lock whose other users are known to run while this audio
+        // path is stopped, so it is never contended.
+        class ScopedAllowUncontendedLock final
+        {
+        public:
+            ScopedAllowUncontendedLock() noexcept { allowLocks(); }
+            ~ScopedAllowUncontendedLock() noexcept { disallowLocks(); }
+
+            JUCE_DECLARE_NON_COPYABLE(ScopedAllowUncontendedLock)
+        };
+
+       #if SAMPLEDEX_RT_SAFETY_CHECKS
+        static constexpr bool isCompiledIn() noexcept { return true; }
+
+        static void enterRealtimeContext() noexcept;
+        static void exitRealtimeContext() noexcept;
+        static void suspendChecks() noexcept;
+        static void resumeChecks() noexcept;
+        static void allowLocks() noexcept;
+        static void disallowLocks() noexcept;
+        static bool isInRealtimeContext() noexcept;
+
+        // Arms the detector. Nothing is recorded until this has been called, so
+        // static initialisation and device startup are not reported.
+        static void setEnabled(bool shouldBeEnabled) noexcept;
+        static bool isEnabled() noexcept;
+
+        // When set, the first violation calls std::abort() so a debugger or core
+        // dump lands on the offending call site.
+        static void setAbortOnViolation(bool shouldAbort) noexcept;
+
+        static std::uint64_t getViolationCount() noexcept;
+        static std::uint64_t getViolationCount(ViolationKind kind) noexcept;
+        static void reset() noexcept;
+
+        // Symbolised, human readable summary. Allocates; never call from the audio thread.
+        static juce::String createReport();
+       #else
+        static constexpr bool isCompiledIn() noexcept { return false; }
+
+        static void enterRealtimeContext() noexcept {}
+        static void exitRealtimeContext() noexcept {}
+        static void suspendChecks() noexcept {}
+        static void resumeChecks() noexcept {}
+        static void allowLocks() noexcept {}
+        static void disallowLocks() noexcept {}
+        static bool isInRealtimeContext() noexcept { return false; }
+        static void setEnabled(bool) noexcept {}
+        static bool isEnabled() noexcept { return false; }
+        static void setAbortOnViolation(bool) noexcept {}
+        static std::uint64_t getViolationCount() noexcept { return 0; }
+        static std::uint64_t getViolationCount(ViolationKind) noexcept { return 0; }
+        static void reset() noexcept {}
+        static juce::String createReport() { return "Realtime safety checks are not compiled in."; }
+       #endif
+
+        static const char* getKindName(ViolationKind kind) noexcept
+        {
+            switch (kind)
+            {
+                case ViolationKind::Malloc: return "malloc";
+                case ViolationKind::Calloc: return "calloc";
+                case ViolationKind::Realloc: return "realloc";
+                case ViolationKind::Free: return "free";
+                case ViolationKind::OperatorNew: return "operator new";
+                case ViolationKind::OperatorDelete: return "operator delete";
+                case ViolationKind::MutexLock: return "pthread_mutex_lock";
+                case ViolationKind::count:
+                default: break;
+            }
+            return "unknown";
+        }
+
+    private:
+        RealtimeSafetyMonitor() = delete;
+    };
+}
@@ -8,23 +8,25 @@
 #include "TimelineModel.h"
 #include "Track.h"
 #include "StreamingClipSource.h"
+#include "TempoMap.h"
 
 namespace sampledex
 {
-    struct TempoEvent
-    {
-        double beat = 0.0;
-        double bpm = 120.0;
-    };
-
     struct RealtimeStateSnapshot
     {
         std::vector<Clip> arrangement;
         std::vector<Track*> trackPointers;
         std::vector<TempoEvent> tempoEvents;
+        TempoMapIndex tempoMap;
         std::vector<AutomationLane> automationLanes;
         int globalTransposeSemitones = 0;
         std::vector<std::shared_ptr<StreamingClipSource>> audioClipStreams;
+
+        // Smart freeze: clips of rendered instrument and insert output that stand in for
+        // a track's own clips and plugins. renderCacheForTrack indexes them per track (-1 = live).
+        std::vector<Clip> renderCacheClips;
+        std::vector<std::shared_ptr<StreamingClipSource>> renderCacheStreams;
+        std::vector<int> renderCacheForTrack;
     };
 
     class RealtimeSnapshotStateManager
@@ -0,0 +1,295 @@
+#include "RenderJobQueue.h"
+
+#include <algorithm>
+
+namespace sampledex
+{
+    RenderJobQueue::RenderJobQueue(int numWorkers)
+        : workerCount(resolveWorkerCount(numWorkers))
+    {
+        workerPool = std::make_unique<juce::ThreadPool>(workerCount);
+    }
+
+    RenderJobQueue::~RenderJobQueue()
+    {
+        cancelUpdate();
+        lifetime->alive.store(false, std::memory_order_release);
+        for (auto& record : jobs)
+            record->context.cancelled.store(true, std::memory_order_relaxed);
+        workerPool->removeAllJobs(true, 15000);
+        jobs.clear();
+    }
+
+    int RenderJobQueue::resolveWorkerCount(int requestedWorkers) noexcept
+    {
+        if (requestedWorkers > 0)
+            return juce::jmin(requestedWorkers, maxWorkers);
+        return juce::jlimit(1, maxWorkers, juce::SystemStats::getNumCpus() / 2);
+    }
+
+    void RenderJobQueue::setWorkerCount(int numWorkers)
+    {
+        workerCount = resolveWorkerCount(numWorkers);
+        if (!isBusy() && workerPool->getNumThreads() != workerCount)
+            workerPool = std::make_unique<juce::ThreadPool>(workerCount);
+    }
+
+    RenderJobQueue::JobId RenderJobQueue::addJob(Job job)
+    {
+        if (!isBusy())
+        {
+            batchTotalJobs = 0;
+            batchFinishedJobs = 0;
+            batchFailedJobs = 0;
+            batchFinishedSeconds = 0.0;
+            batchStartMs = juce::Time::getMillisecondCounterHiRes();
+            endedJobStates.clear();
+        }
+
+        auto record = std::make_unique<Record>();
+        record->id = nextJobId++;
+        record->job = std::move(job);
+        const JobId id = record->id;
+        jobs.push_back(std::move(record));
+        ++batchTotalJobs;
+
+        // Jobs never start inside addJob(), so a batch can be queued before any of it runs.
+        triggerAsyncUpdate();
+        return id;
+    }
+
+    void RenderJobQueue::cancelAll()
+    {
+        std::vector<JobId> waiting;
+        for (auto& record : jobs)
+        {
+            record->context.cancelled.store(true, std::memory_order_relaxed);
+            if (record->state == JobState::Waiting)
+                waiting.push_back(record->id);
+        }
+
+        // Running jobs end when their render sees the flag.
+        for (const JobId id : waiting)
+            endJob(id, JobState::Cancelled, {});
+        finishBatchIfIdle();
+    }
+
+    RenderJobQueue::Stats RenderJobQueue::getStats() const
+    {
+        Stats stats;
+        stats.totalJobs = batchTotalJobs;
+        stats.finishedJobs = batchFinishedJobs;
+        stats.failedJobs = batchFailedJobs;
+
+        double renderedSeconds = batchFinishedSeconds;
+        float runningProgress = 0.0f;
+        for (const auto& record : jobs)
+        {
+            if (record->state != JobState::Running)
+                continue;
+            ++stats.runningJobs;
+            runningProgress += record->context.progress.load(std::memory_order_relaxed);
+            renderedSeconds += record->context.renderedSeconds.load(std::memory_order_relaxed);
+        }
+
+        if (batchTotalJobs > 0)
+            stats.progress = juce::jlimit(0.0f, 1.0f, (static_cast<float>(batchFinishedJobs) + runningProgress)
+                                                          / static_cast<float>(batchTotalJobs));
+        stats.elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - batchStartMs) * 0.001;
+        stats.speedFactor = stats.elapsedSeconds > 0.0 ? renderedSeconds / stats.elapsedSeconds : 0.0;
+        return stats;
+    }
+
+    float RenderJobQueue::getJobProgress(JobId id) const noexcept
+    {
+        if (const auto* record = findRecord(id))
+            return record->state == JobState::Running ? record->context.progress.load(std::memory_order_relaxed) : 0.0f;
+        return 1.0f;
+    }
+
+    RenderJobQueue::Record* RenderJobQueue::findRecord(JobId id) const noexcept
+    {
+        for (const auto& record : jobs)
+            if (record->id == id)
+                return record.get();
+        return nullptr;
+    }
+
+    void RenderJobQueue::handleAsyncUpdate()
+    {
+        // Starting or ending a job can change what else may run, so sweep until stable.
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            int running = 0;
+            for (const auto& record : jobs)
+                if (record->state == JobState::Starting || record->state == JobState::Running)
+                    ++running;
+
+            // By index: a start or finish callback may queue more jobs.
+            for (size_t index = 0; index < jobs.size(); ++index)
+            {
+                auto* record = jobs[index].get();
+                if (record->state != JobState::Waiting)
+                    continue;
+
+                bool ready = true;
+                bool blocked = false;
+                for (const JobId dependency : record->job.dependencies)
+                {
+                    if (findRecord(dependency) != nullptr)
+                    {
+                        ready = false;
+                        continue;
+                    }
+
+                    // Jobs from an earlier batch have already succeeded or been reported.
+                    const auto ended = endedJobStates.find(dependency);
+                    if (ended != endedJobStates.end() && ended->second != JobState::Succeeded)
+                        blocked = true;
+                }
+
+                if (blocked)
+                {
+                    endJob(record->id, JobState::Cancelled, "Skipped because a render it depends on did not finish.");
+                    changed = true;
+                    break;
+                }
+
+                if (ready && running < workerCount)
+                {
+                    if (!launch(*record))
+                    {
+                        changed = true;
+                        break;
+                    }
+                    ++running;
+                }
+            }
+        }
+
+        finishBatchIfIdle();
+    }
+
+    bool RenderJobQueue::launch(Record& record)
+    {
+        const JobId id = record.id;
+        if (!record.job.start)
+        {
+            endJob(id, JobState::Failed, "Render could not start.");
+            return false;
+        }
+
+        record.state = JobState::Starting;
+        record.job.start([this, id, alive = lifetime](RenderFn render, const juce::String& error)
+        {
+            if (alive->alive.load(std::memory_order_acquire))
+                jobStarted(id, std::move(render), error);
+        });
+        return findRecord(id) != nullptr;
+    }
+
+    void RenderJobQueue::jobStarted(JobId id, RenderFn render, const juce::String& error)
+    {
+        auto* record = findRecord(id);
+        if (record == nullptr || record->state != JobState::Starting)
+            return;
+
+        if (!render)
+            endJob(id, JobState::Failed, error.isNotEmpty() ? error : juce::String("Render could not start."));
+        else if (record->context.isCancelled())
+            endJob(id, JobState::Cancelled, {});
+        else
+        {
+            record->render = std::move(render);
+            record->state = JobState::Running;
+            runRender(*record);
+        }
+
+        // A start that finishes inside launch() is picked up by the sweep running it.
+        triggerAsyncUpdate();
+    }
+
+    void RenderJobQueue::runRender(Record& record)
+    {
+        if (runsOnMessageThread)
+        {
+            juce::String renderError;
+            const bool ok = record.render(record.context, renderError);
+            endJob(record.id,
+                   ok ? JobState::Succeeded : (record.context.isCancelled() ? JobState::Cancelled : JobState::Failed),
+                   renderError);
+            return;
+        }
+
+        workerPool->addJob([this, id = record.id, render = &record.render, context = &record.context, alive = lifetime]
+        {
+            if (!alive->alive.load(std::memory_order_acquire))
+                return;
+
+            juce::String renderError;
+            bool ok = false;
+            try
+            {
+                ok = (*render)(*context, renderError);
+            }
+            catch (const std::exception& e)
+            {
+                renderError = "Render failed: " + juce::String(e.what());
+            }
+            catch (...)
+            {
+                renderError = "Render failed with an unknown error.";
+            }
+
+            juce::MessageManager::callAsync([this, id, ok, renderError, alive]
+            {
+                if (!alive->alive.load(std::memory_order_acquire))
+                    return;
+                const auto* record = findRecord(id);
+                if (record == nullptr)
+                    return;
+                const auto state = ok ? JobState::Succeeded
+                                      : (record->context.isCancelled() ? JobState::Cancelled : JobState::Failed);
+                endJob(id, state, renderError);
+                handleAsyncUpdate();
+            });
+        });
+    }
+
+    void RenderJobQueue::endJob(JobId id, JobState state, const juce::String& error)
+    {
+        const auto it = std::find_if(jobs.begin(), jobs.end(), [id](const auto& record) { return record->id == id; });
+        if (it == jobs.end())
+            return;
+
+        // Out of the active list before finish() runs, so it may queue follow-up jobs.
+        std::unique_ptr<Record> record = std::move(*it);
+        jobs.erase(it);
+        record->state = state;
+        endedJobStates[id] = state;
+        ++batchFinishedJobs;
+        if (state == JobState::Failed)
+            ++batchFailedJobs;
+        batchFinishedSeconds += record->context.renderedSeconds.load(std::memory_order_relaxed);
+
+        record->render = {};
+        if (record->job.finish)
+            record->job.finish(state, error);
+    }
+
+    void RenderJobQueue::finishBatchIfIdle()
+    {
+        if (isBusy() || batchTotalJobs == 0)
+            return;
+
+        const auto finalStats = getStats();
+        batchTotalJobs = 0;
+        endedJobStates.clear();
+        if (workerPool->getNumThreads() != workerCount)
+            workerPool = std::make_unique<juce::ThreadPool>(workerCount);
+        if (onIdle)
+            onIdle(finalStats);
+    }
+}
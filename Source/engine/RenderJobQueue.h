@@ -0,0 +1,153 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace sampledex
+{
+    // Runs render jobs (freeze, commit) on a pool of render workers. A job may depend on
+    // other jobs and starts once they have all succeeded; if one fails or is cancelled,
+    // so are the jobs waiting on it. Each job is started on the message thread, where it
+    // builds its input from the session as it is at that moment (so a job can see the
+    // results of the jobs it waited for), and the render itself runs on a worker. A start
+    // may finish later (e.g. once cloned plugins are created); the job holds its worker
+    // slot meanwhile. All public calls, start and finish callbacks belong to the message
+    // thread.
+    class RenderJobQueue final : private juce::AsyncUpdater
+    {
+    public:
+        using JobId = int;
+
+        enum class JobState
+        {
+            Waiting,
+            Starting,
+            Running,
+            Succeeded,
+            Failed,
+            Cancelled
+        };
+
+        // Handed to a running render. Progress and rendered audio time feed the queue's
+        // progress and throughput readout.
+        class JobContext
+        {
+        public:
+            std::atomic<bool>* getCancelFlag() noexcept { return &cancelled; }
+            bool isCancelled() const noexcept { return cancelled.load(std::memory_order_relaxed); }
+
+            void setProgress(float fraction, double renderedAudioSeconds) noexcept
+            {
+                progress.store(juce::jlimit(0.0f, 1.0f, fraction), std::memory_order_relaxed);
+                renderedSeconds.store(juce::jmax(0.0, renderedAudioSeconds), std::memory_order_relaxed);
+            }
+
+        private:
+            friend class RenderJobQueue;
+            std::atomic<bool> cancelled { false };
+            std::atomic<float> progress { 0.0f };
+            std::atomic<double> renderedSeconds { 0.0 };
+        };
+
+        // Worker thread. Returns false (with error set) when the render fails.
+        using RenderFn = std::function<bool(JobContext& context, juce::String& error)>;
+        // Message thread, once per start, now or later: the render to run, or an empty
+        // function (with error set) to fail the job.
+        using StartedFn = std::function<void(RenderFn render, const juce::String& error)>;
+
+        struct Job
+        {
+            juce::String name;
+            std::vector<JobId> dependencies;
+            // Builds the job's input and hands the render to started. The render function
+            // is destroyed on the message thread once the job ends, so whatever it owns
+            // (cloned tracks, plugins) is released there. A job cancelled while starting
+            // ends when started is called.
+            std::function<void(StartedFn started)> start;
+            std::function<void(JobState state, const juce::String& error)> finish;
+        };
+
+        // Since the queue last went idle.
+        struct Stats
+        {
+            int totalJobs = 0;
+            int finishedJobs = 0;
+            int runningJobs = 0;
+            int failedJobs = 0;
+            float progress = 0.0f;
+            double elapsedSeconds = 0.0;
+            double speedFactor = 0.0; // audio seconds rendered per wall-clock second, summed over workers
+        };
+
+        static constexpr int maxWorkers = 16;
+
+        explicit RenderJobQueue(int numWorkers = 0);
+        ~RenderJobQueue() override;
+
+        // 0 = about half the cores, since each render may also widen its own graph.
+        static int resolveWorkerCount(int requestedWorkers) noexcept;
+
+        // Takes effect when the queue is idle.
+        void setWorkerCount(int numWorkers);
+        int getWorkerCount() const noexcept { return workerCount; }
+
+        // Renders on the message thread instead, one job at a time (blocks the UI).
+        void setRunsOnMessageThread(bool shouldRunOnMessageThread) noexcept { runsOnMessageThread = shouldRunOnMessageThread; }
+
+        JobId addJob(Job job);
+        void cancelAll();
+
+        bool isBusy() const noexcept { return !jobs.empty(); }
+        Stats getStats() const;
+        // 0 while waiting, 1 once ended.
+        float getJobProgress(JobId id) const noexcept;
+
+        // Called once the last job of a batch has ended.
+        std::function<void(const Stats& finalStats)> onIdle;
+
+    private:
+        struct Record
+        {
+            JobId id = 0;
+            Job job;
+            JobState state = JobState::Waiting;
+            RenderFn render;
+            JobContext context;
+        };
+
+        // Shared with queued jobs and callbacks so they can tell the queue is gone.
+        struct Lifetime
+        {
+            std::atomic<bool> alive { true };
+        };
+
+        void handleAsyncUpdate() override;
+        Record* findRecord(JobId id) const noexcept;
+        // Returns false when the job has already ended.
+        bool launch(Record& record);
+        void jobStarted(JobId id, RenderFn render, const juce::String& error);
+        void runRender(Record& record);
+        void endJob(JobId id, JobState state, const juce::String& error);
+        void finishBatchIfIdle();
+
+        std::unique_ptr<juce::ThreadPool> workerPool;
+        int workerCount = 1;
+        bool runsOnMessageThread = false;
+        std::shared_ptr<Lifetime> lifetime = std::make_shared<Lifetime>();
+        std::vector<std::unique_ptr<Record>> jobs; // waiting or running
+        std::map<JobId, JobState> endedJobStates; // this batch
+        JobId nextJobId = 1;
+        int batchTotalJobs = 0;
+        int batchFinishedJobs = 0;
+        int batchFailedJobs = 0;
+        double batchFinishedSeconds = 0.0;
+        double batchStartMs = 0.0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderJobQueue)
+    };
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace sampledex
+{
+    struct TempoEvent
+    {
+        double beat = 0.0;
+        double bpm = 120.0;
+    };
+
+    // Step tempo map with the elapsed time at every tempo change, so beat <-> seconds <->
+    // sample conversions anywhere in the project are a binary search plus one division
+    // instead of a walk over every earlier event. Built on the message thread when the
+    // snapshot is rebuilt; read-only (and allocation-free) on the audio thread.
+    class TempoMapIndex
+    {
+    public:
+        // events must be sorted by beat (rebuildTempoEventMap keeps them that way).
+        void rebuild(const std::vector<TempoEvent>& events, double fallbackBpm)
+        {
+            segments.clear();
+            segments.reserve(events.size() + 1);
+            segments.push_back({ 0.0, juce::jmax(1.0, fallbackBpm), 0.0 });
+            for (const auto& event : events)
+            {
+                const double beat = juce::jmax(0.0, event.beat);
+                const double tempo = juce::jmax(1.0, event.bpm);
+                auto& last = segments.back();
+                if (beat <= last.beat + 1.0e-9)
+                {
+                    last.bpm = tempo;
+                    continue;
+                }
+                const double seconds = last.seconds + (beat - last.beat) * (60.0 / last.bpm);
+                segments.push_back({ beat, tempo, seconds });
+            }
+        }
+
+        // Single-tempo map for an external clock. Reuses the storage, so after the first
+        // call it does not allocate.
+        void setConstantTempo(double bpm)
+        {
+            segments.resize(1);
+            segments.front() = { 0.0, juce::jmax(1.0, bpm), 0.0 };
+        }
+
+        bool isEmpty() const noexcept { return segments.empty(); }
+        int getNumChanges() const noexcept { return juce::jmax(0, static_cast<int>(segments.size()) - 1); }
+
+        double getTempoAtBeat(double beat) const noexcept
+        {
+            return segments.empty() ? 120.0 : segments[segmentForBeat(beat)].bpm;
+        }
+
+        // Seconds from beat 0; beats before 0 extrapolate the first tempo.
+        double secondsAtBeat(double beat) const noexcept
+        {
+            if (segments.empty())
+                return beat * 0.5;
+            const auto& segment = segments[segmentForBeat(beat)];
+            return segment.seconds + (beat - segment.beat) * (60.0 / segment.bpm);
+        }
+
+        double beatAtSeconds(double seconds) const noexcept
+        {
+            if (segments.empty())
+                return seconds * 2.0;
+            const auto& segment = segments[segmentForSeconds(seconds)];
+            return segment.beat + (seconds - segment.seconds) * (segment.bpm / 60.0);
+        }
+
+        double samplesBetweenBeats(double fromBeat, double toBeat, double sampleRate) const noexcept
+        {
+            return (secondsAtBeat(toBeat) - secondsAtBeat(fromBeat)) * sampleRate;
+        }
+
+        // The beat reached numSamples after fromBeat.
+        double beatAfterSamples(double fromBeat, double numSamples, double sampleRate) const noexcept
+        {
+            if (sampleRate <= 0.0)
+                return fromBeat;
+            return beatAtSeconds(secondsAtBeat(fromBeat) + numSamples / sampleRate);
+        }
+
+        // First tempo change strictly after beat, or +inf when the tempo holds from there on.
+        double nextChangeAfterBeat(double beat) const noexcept
+        {
+            const auto next = segmentForBeat(beat) + 1;
+            return next < segments.size() ? segments[next].beat
+                                          : std::numeric_limits<double>::infinity();
+        }
+
+    private:
+        struct Segment
+        {
+            double beat = 0.0;
+            double bpm = 120.0;
+            double seconds = 0.0; // elapsed time at beat
+        };
+
+        size_t segmentForBeat(double beat) const noexcept
+        {
+            const auto it = std::upper_bound(segments.begin(),
+                                             segments.end(),
+                                             beat + 1.0e-9,
+                                             [](double b, const Segment& segment) { return b < segment.beat; });
+            return it == segments.begin() ? 0 : static_cast<size_t>(std::distance(segments.begin(), it) - 1);
+        }
+
+        size_t segmentForSeconds(double seconds) const noexcept
+        {
+            const auto it = std::upper_bound(segments.begin(),
+                                             segments.end(),
+                                             seconds,
+                                             [](double s, const Segment& segment) { return s < segment.seconds; });
+            return it == segments.begin() ? 0 : static_cast<size_t>(std::distance(segments.begin(), it) - 1);
+        }
+
+        std::vector<Segment> segments;
+    };
+
+    // One audio block on the timeline: maps beats to sample offsets inside the block and
+    // splits it into runs of constant tempo. A block that wraps at the loop end continues
+    // from the loop start at getWrapSample().
+    class TempoBlockSpan
+    {
+    public:
+        void set(const TempoMapIndex& tempoMap,
+                 double sampleRate,
+                 int numSamples,
+                 double startBeat,
+                 bool wrapped,
+                 double loopStartBeat,
+                 double loopEndBeat) noexcept
+        {
+            map = &tempoMap;
+            rate = juce::jmax(1.0, sampleRate);
+            blockSamples = juce::jmax(0, numSamples);
+            firstBeat = startBeat;
+            firstOriginSeconds = map->secondsAtBeat(startBeat);
+            wrapSample = blockSamples;
+            wrapOriginSeconds = firstOriginSeconds;
+            if (wrapped && loopEndBeat > startBeat && loopEndBeat > loopStartBeat)
+            {
+                const double secondsToLoopEnd = map->secondsAtBeat(loopEndBeat) - firstOriginSeconds;
+                wrapSample = juce::jlimit(0, blockSamples, static_cast<int>(std::ceil(secondsToLoopEnd * rate - 1.0e-9)));
+                wrapOriginSeconds = map->secondsAtBeat(loopStartBeat) - secondsToLoopEnd;
+            }
+        }
+
+        int getNumSamples() const noexcept { return blockSamples; }
+        int getWrapSample() const noexcept { return wrapSample; }
+
+        // Fractional sample offset of beat; beats before the block start belong to the
+        // part after the loop wrap.
+        double sampleOffsetForBeat(double beat) const noexcept
+        {
+            if (map == nullptr)
+                return 0.0;
+            const bool afterWrap = wrapSample < blockSamples && beat < firstBeat;
+            return (map->secondsAtBeat(beat) - (afterWrap ? wrapOriginSeconds : firstOriginSeconds)) * rate;
+        }
+
+        double beatAtSample(double sampleOffset) const noexcept
+        {
+            if (map == nullptr)
+                return firstBeat;
+            const double origin = sampleOffset >= static_cast<double>(wrapSample) ? wrapOriginSeconds : firstOriginSeconds;
+            return map->beatAtSeconds(origin + sampleOffset / rate);
+        }
+
+        // Calls callback(startBeat, beatsPerSample, sampleOffset, numSamples) for each
+        // run of the block that plays at one tempo, in order.
+        template <typename Callback>
+        void forEachConstantTempoRun(Callback&& callback) const
+        {
+            if (map == nullptr)
+                return;
+            forEachRunInPart(firstOriginSeconds, 0, wrapSample, callback);
+            forEachRunInPart(wrapOriginSeconds, wrapSample, blockSamples, callback);
+        }
+
+    private:
+        template <typename Callback>
+        void forEachRunInPart(double originSeconds, int fromSample, int toSample, Callback& callback) const
+        {
+            int sample = fromSample;
+            while (sample < toSample)
+            {
+                const double beat = map->beatAtSeconds(originSeconds + static_cast<double>(sample) / rate);
+                const double changeBeat = map->nextChangeAfterBeat(beat);
+                int runEnd = toSample;
+                if (std::isfinite(changeBeat))
+                {
+                    const double changeSample = (map->secondsAtBeat(changeBeat) - originSeconds) * rate;
+                    if (changeSample < static_cast<double>(toSample))
+                        runEnd = juce::jlimit(sample + 1, toSample, static_cast<int>(std::ceil(changeSample - 1.0e-9)));
+                }
+
+                callback(beat, map->getTempoAtBeat(beat) / (60.0 * rate), sample, runEnd - sample);
+                sample = runEnd;
+            }
+        }
+
+        const TempoMapIndex* map = nullptr;
+        double rate = 44100.0;
+        int blockSamples = 0;
+        double firstBeat = 0.0;
+        double firstOriginSeconds = 0.0;
+        int wrapSample = 0;
+        double wrapOriginSeconds = 0.0;
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include <JuceHeader.h>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <tuple>
 #include <vector>
 #include <memory>
@@ -187,6 +189,9 @@ namespace sampledex
         // Audio Content (RAM Cache)
         // We use shared_ptr so we can pass this around efficiently without copying heavy audio data
         std::shared_ptr<juce::AudioBuffer<float>> audioData;
+        // Names the contents of audioData for render caches: set the buffer through
+        // setAudioData() and call markAudioDataEdited() after writing into it.
+        std::uint64_t audioDataRevision = 0;
         juce::String audioFilePath;
         double audioSampleRate = 44100.0; 
         float gainLinear = 1.0f;
@@ -219,6 +224,7 @@ namespace sampledex
                             sourceMidiChannel,
                             sourceTrackName,
                             audioData,
+                            audioDataRevision,
                             audioFilePath,
                             audioSampleRate,
                             gainLinear,
@@ -248,6 +254,7 @@ namespace sampledex
                             other.sourceMidiChannel,
                             other.sourceTrackName,
                             other.audioData,
+                            other.audioDataRevision,
                             other.audioFilePath,
                             other.audioSampleRate,
                             other.gainLinear,
@@ -263,6 +270,19 @@ namespace sampledex
                             other.oneShot);
         }
 
+        // --- Audio Helper ---
+        void setAudioData(std::shared_ptr<juce::AudioBuffer<float>> buffer)
+        {
+            audioData = std::move(buffer);
+            markAudioDataEdited();
+        }
+
+        void markAudioDataEdited() noexcept
+        {
+            static std::atomic<std::uint64_t> lastRevision { 0 };
+            audioDataRevision = lastRevision.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
         // --- MIDI Helper ---
         void getEventsInRange(double fromBeat,
                               double toBeat,
@@ -278,8 +298,6 @@ namespace sampledex
                 return;
 
             const double secondsPerBeat = 60.0 / bpm;
-            const int channel = juce::jlimit(1, 16, midiChannel);
-            const int transpose = juce::jlimit(-48, 48, transposeSemitones);
             const int estimatedSamples = blockNumSamples > 0
                 ? blockNumSamples
                 : juce::jmax(1, static_cast<int>(std::ceil((toBeat - fromBeat) * secondsPerBeat * sampleRate)));
@@ -290,6 +308,28 @@ namespace sampledex
                 return juce::jlimit(0, juce::jmax(0, estimatedSamples - 1), sampleOffset);
             };
 
+            getEventsInRangeMapped(fromBeat, toBeat, dest, beatToSample, chaseNotesAtBlockStart, midiChannel, transposeSemitones);
+        }
+
+        // Same as getEventsInRange, with the sample offset of each event supplied by
+        // beatToSample(absoluteBeat) -> int, e.g. from a tempo map. Chased notes start at
+        // beatToSample(fromBeat).
+        template <typename BeatToSample>
+        void getEventsInRangeMapped(double fromBeat,
+                                    double toBeat,
+                                    juce::MidiBuffer& dest,
+                                    BeatToSample&& beatToSample,
+                                    bool chaseNotesAtBlockStart = false,
+                                    int midiChannel = 1,
+                                    int transposeSemitones = 0) const
+        {
+            if (type != ClipType::MIDI || toBeat <= fromBeat)
+                return;
+
+            const int channel = juce::jlimit(1, 16, midiChannel);
+            const int transpose = juce::jlimit(-48, 48, transposeSemitones);
+            const int chaseSample = chaseNotesAtBlockStart ? beatToSample(fromBeat) : 0;
+
             for (const auto& ev : events)
             {
                 const double noteAbsStart = startBeat + ev.startBeat - offsetBeats;
@@ -297,7 +337,7 @@ namespace sampledex
                 const int noteNumber = juce::jlimit(0, 127, ev.noteNumber + transpose);
 
                 if (chaseNotesAtBlockStart && noteAbsStart < fromBeat && noteAbsEnd > fromBeat)
-                    dest.addEvent(juce::MidiMessage::noteOn(channel, noteNumber, ev.velocity), 0);
+                    dest.addEvent(juce::MidiMessage::noteOn(channel, noteNumber, ev.velocity), chaseSample);
 
                 if (noteAbsStart >= fromBeat && noteAbsStart < toBeat)
                 {
@@ -1,11 +1,20 @@
 #pragma once
 #include <JuceHeader.h>
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <cstdio>
 #include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <thread>
+#include <utility>
 #include <vector>
+#include "AutomationRamp.h"
+#include "PluginBridge.h"
+#include "PluginStateCache.h"
+#include "RealtimeSafetyMonitor.h"
 #include "TimelineModel.h"
 
 namespace sampledex
@@ -103,6 +112,12 @@ namespace sampledex
         static constexpr int maxInsertSlots = 4;
         static constexpr int maxSendBuses = 4;
         static constexpr int maxInputSourcePairs = 64;
+        // Sleeping: output below the threshold for the hold time (after the plugin tail,
+        // capped at maxSleepTailSeconds) counts as finished.
+        static constexpr float sleepSilenceThreshold = 1.0e-5f;
+        static constexpr double sleepSilenceHoldSeconds = 0.5;
+        static constexpr double maxSleepTailSeconds = 30.0;
+        static constexpr int sleepCounterLimit = 1 << 30;
 
         enum class SendTapMode : int
         {
@@ -167,6 +182,24 @@ namespace sampledex
             IsolatedBridge = 1
         };
 
+        // What happens when a block carries more MIDI than the preallocated arenas hold.
+        enum class MidiOverflowPolicy : int
+        {
+            DropNewest = 0,       // drop anything that does not fit
+            PreserveReleases = 1  // keep headroom so note-offs / pedal-ups always land
+        };
+
+        // Bytes of MIDI storage reserved per track for a block of the given size.
+        // Sized for dense MPE/CC streams; also used by the host for its per-track buffers.
+        static int getMidiArenaCapacityBytesForBlock(int samplesPerBlock) noexcept
+        {
+            constexpr int minimumEvents = 2048;
+            constexpr int eventsPerSample = 2;
+            constexpr int bytesPerEvent = 16;
+            const int events = juce::jmax(minimumEvents, juce::jmax(0, samplesPerBlock) * eventsPerSample);
+            return events * bytesPerEvent;
+        }
+
         struct PluginSlotDiagnostic
         {
             int slotIndex = instrumentSlotIndex;
@@ -192,10 +225,15 @@ namespace sampledex
                 cachedLoaded.store(false, std::memory_order_relaxed);
             for (auto& cachedBypassed : cachedInsertSlotBypassed)
                 cachedBypassed.store(false, std::memory_order_relaxed);
+            ensurePluginProcessBufferCapacityLocked(2, 8192);
+            publishPluginChainLocked();
             updatePluginUiCacheLocked();
         }
 
-        ~Track() override {}
+        ~Track() override
+        {
+            delete publishedPluginChain.exchange(nullptr, std::memory_order_acq_rel);
+        }
 
         juce::String getTrackName() const { return name; }
         void setTrackName(const juce::String& newName)
@@ -212,6 +250,27 @@ namespace sampledex
         float getPan() const { return pan.load(); }
         void setSendLevel(float level) { sendLevel.store(juce::jlimit(0.0f, 1.0f, level)); }
         float getSendLevel() const { return sendLevel.load(); }
+
+        // Per-sample automation of volume, pan or send for the next processed block.
+        // Written by the audio callback before the track graph runs; an inactive ramp
+        // leaves the fader on its usual block-length smoothing.
+        AutomationBlockRamp& getBlockAutomationRamp(AutomationTarget target) noexcept
+        {
+            switch (target)
+            {
+                case AutomationTarget::TrackPan: return blockAutomationRamps[1];
+                case AutomationTarget::TrackSend: return blockAutomationRamps[2];
+                case AutomationTarget::TrackVolume:
+                case AutomationTarget::MasterOutput:
+                default: return blockAutomationRamps[0];
+            }
+        }
+
+        void clearBlockAutomationRamps() noexcept
+        {
+            for (auto& ramp : blockAutomationRamps)
+                ramp.clear();
+        }
         void setSendTapMode(SendTapMode mode)
         {
             sendTapMode.store(static_cast<int>(mode), std::memory_order_relaxed);
@@ -359,32 +418,36 @@ namespace sampledex
         float getMeterPeakLevel() const { return meterPeakLevel.load(std::memory_order_relaxed); }
         float getMeterRmsLevel() const { return meterRmsLevel.load(std::memory_order_relaxed); }
         float getPostFaderOutputPeak() const { return postFaderOutputPeak.load(std::memory_order_relaxed); }
+
+        struct SleepStats
+        {
+            bool asleep = false;
+            std::uint64_t sleptBlocks = 0;
+            std::uint64_t totalBlocks = 0; // blocks that reached the plugin chain, asleep or not
+        };
+        SleepStats getSleepStats() const
+        {
+            SleepStats stats;
+            stats.asleep = trackAsleep.load(std::memory_order_relaxed);
+            stats.sleptBlocks = sleepBlocksSlept.load(std::memory_order_relaxed);
+            stats.totalBlocks = sleepBlocksTotal.load(std::memory_order_relaxed);
+            return stats;
+        }
         bool isMeterClipping() const { return meterClipHoldFrames.load(std::memory_order_relaxed) > 0; }
+        // Lock-free: safe to call from the audio thread for PDC.
         int getTotalPluginLatencySamples() const
         {
-            juce::ScopedLock sl(processLock);
-            int total = 0;
-            if (instrumentSlot.instance != nullptr && !instrumentSlot.bypassed)
-                total += juce::jmax(0, instrumentSlot.instance->getLatencySamples());
-            for (const auto& slot : pluginSlots)
-            {
-                if (slot.instance == nullptr || slot.bypassed)
-                    continue;
-                total += juce::jmax(0, slot.instance->getLatencySamples());
-            }
-            return juce::jmax(0, total);
+            const ScopedPluginChainReader chainReader(*this);
+            const auto* chain = chainReader.get();
+            if (chain == nullptr)
+                return 0;
+            return juce::jmax(0, getChainEntryLatencySamples(chain->instrument) + getChainInsertLatencySamples(*chain));
         }
         int getInsertPluginLatencySamples() const
         {
-            juce::ScopedLock sl(processLock);
-            int total = 0;
-            for (const auto& slot : pluginSlots)
-            {
-                if (slot.instance == nullptr || slot.bypassed)
-                    continue;
-                total += juce::jmax(0, slot.instance->getLatencySamples());
-            }
-            return juce::jmax(0, total);
+            const ScopedPluginChainReader chainReader(*this);
+            const auto* chain = chainReader.get();
+            return chain != nullptr ? juce::jmax(0, getChainInsertLatencySamples(*chain)) : 0;
         }
         float getInputMeterPeakLevel() const { return inputMeterPeakLevel.load(std::memory_order_relaxed); }
         float getInputMeterRmsLevel() const { return inputMeterRmsLevel.load(std::memory_order_relaxed); }
@@ -487,28 +550,21 @@ namespace sampledex
 
         void useBuiltInSynthInstrument()
         {
-            std::unique_ptr<juce::AudioPluginInstance> oldInstrument;
             {
                 juce::ScopedLock sl(processLock);
-                oldInstrument = std::move(instrumentSlot.instance);
-                instrumentSlot.host.reset();
-                instrumentSlot.description = {};
-                instrumentSlot.hasDescription = false;
-                instrumentSlot.bypassed = false;
-                instrumentSlot.stabilityCrashCount = 0;
-                instrumentSlot.stabilitySuccessCount = 0;
-                instrumentSlot.lastCrashSummary.clear();
+                retirePluginSlotLocked(instrumentSlot);
                 builtInInstrumentMode = BuiltInInstrument::BasicSynth;
+                publishPluginChainLocked();
             }
 
-            if (oldInstrument)
-                oldInstrument->releaseResources();
+            drainRetiredPluginObjects();
         }
 
         void disableBuiltInInstrument()
         {
             juce::ScopedLock sl(processLock);
             builtInInstrumentMode = BuiltInInstrument::None;
+            publishPluginChainLocked();
         }
 
         bool loadSamplerSoundFromFile(const juce::File& file, juce::String& errorMsg)
@@ -545,25 +601,18 @@ namespace sampledex
                 0.18,
                 20.0);
 
-            std::unique_ptr<juce::AudioPluginInstance> oldInstrument;
             {
                 juce::ScopedLock sl(processLock);
-                oldInstrument = std::move(instrumentSlot.instance);
-                instrumentSlot.host.reset();
-                instrumentSlot.description = {};
-                instrumentSlot.hasDescription = false;
-                instrumentSlot.bypassed = false;
-                instrumentSlot.stabilityCrashCount = 0;
-                instrumentSlot.stabilitySuccessCount = 0;
-                instrumentSlot.lastCrashSummary.clear();
+                retirePluginSlotLocked(instrumentSlot);
+                const ScopedAudioSuspension suspension(*this);
                 samplerSynth.clearSounds();
                 samplerSynth.addSound(sound.release());
                 samplerSamplePath = file.getFullPathName();
                 builtInInstrumentMode = BuiltInInstrument::Sampler;
+                publishPluginChainLocked();
             }
 
-            if (oldInstrument)
-                oldInstrument->releaseResources();
+            drainRetiredPluginObjects();
 
             errorMsg.clear();
             return true;
@@ -600,71 +649,92 @@ namespace sampledex
             return "None";
         }
 
-        bool loadInstrumentPlugin(const juce::PluginDescription& desc, juce::String& errorMsg)
+        double getPluginHostingSampleRate() const
         {
-            double sampleRateToUse = 44100.0;
-            int blockSizeToUse = 512;
-            juce::AudioPlayHead* playHeadToUse = nullptr;
-            {
-                juce::ScopedLock sl(processLock);
-                sampleRateToUse = preparedSampleRate > 0.0 ? preparedSampleRate
-                                  : (juce::AudioProcessor::getSampleRate() > 0.0 ? juce::AudioProcessor::getSampleRate() : 44100.0);
-                blockSizeToUse = preparedBlockSize > 0 ? preparedBlockSize
-                                 : (juce::AudioProcessor::getBlockSize() > 0 ? juce::AudioProcessor::getBlockSize() : 512);
-                playHeadToUse = transportPlayHead;
-            }
+            juce::ScopedLock sl(processLock);
+            return preparedSampleRate > 0.0 ? preparedSampleRate
+                   : (juce::AudioProcessor::getSampleRate() > 0.0 ? juce::AudioProcessor::getSampleRate() : 44100.0);
+        }
 
-            std::unique_ptr<juce::AudioPluginInstance> instance =
-                fmtMgr.createPluginInstance(desc, sampleRateToUse, blockSizeToUse, errorMsg);
-            if (instance == nullptr)
-                return false;
+        int getPluginHostingBlockSize() const
+        {
+            juce::ScopedLock sl(processLock);
+            return preparedBlockSize > 0 ? preparedBlockSize
+                   : (juce::AudioProcessor::getBlockSize() > 0 ? juce::AudioProcessor::getBlockSize() : 512);
+        }
 
-            if (!configurePluginBusLayout(*instance, true))
+        // Bus layout, prepare and a guarded test render for a freshly created instance.
+        // Touches no track state, so PluginInstantiationService runs it off the message thread.
+        static bool preparePluginInstanceForHosting(juce::AudioPluginInstance& instance,
+                                                    bool isInstrument,
+                                                    double sampleRate,
+                                                    int blockSize,
+                                                    juce::String& errorMsg)
+        {
+            if (!configurePluginBusLayout(instance, isInstrument))
             {
-                errorMsg = "Plugin bus layout is incompatible with track hosting.";
+                errorMsg = isInstrument ? "Plugin bus layout is incompatible with track hosting."
+                                        : "Plugin bus layout is incompatible with insert hosting.";
                 return false;
             }
 
-            const int instrumentInputs = juce::jmax(0, juce::jmin(2, instance->getMainBusNumInputChannels()));
-            const int instrumentOutputs = getUsableMainOutputChannels(*instance);
-            if (instrumentOutputs <= 0)
+            int inputs = 0;
+            int outputs = 0;
+            if (isInstrument)
             {
-                errorMsg = "Instrument plugin does not expose a usable output bus.";
-                return false;
+                inputs = juce::jmax(0, juce::jmin(2, instance.getMainBusNumInputChannels()));
+                outputs = getUsableMainOutputChannels(instance);
+                if (outputs <= 0)
+                {
+                    errorMsg = "Instrument plugin does not expose a usable output bus.";
+                    return false;
+                }
             }
-            instance->setPlayConfigDetails(instrumentInputs, instrumentOutputs, sampleRateToUse, blockSizeToUse);
-            instance->setRateAndBufferSizeDetails(sampleRateToUse, blockSizeToUse);
-            instance->setPlayHead(playHeadToUse);
-            instance->prepareToPlay(sampleRateToUse, blockSizeToUse);
-            instance->setNonRealtime(false);
-            if (!validatePluginInstanceSafety(*instance, true, blockSizeToUse, errorMsg))
+            else
             {
-                instance->releaseResources();
-                return false;
+                inputs = juce::jmax(1, juce::jmin(2, instance.getMainBusNumInputChannels()));
+                outputs = juce::jmax(inputs, getUsableMainOutputChannels(instance));
+                if (outputs <= 0)
+                {
+                    errorMsg = "Effect plugin does not expose a usable output bus.";
+                    return false;
+                }
             }
 
-            std::unique_ptr<juce::AudioPluginInstance> oldInstrument;
+            instance.setPlayConfigDetails(inputs, outputs, sampleRate, blockSize);
+            instance.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            instance.prepareToPlay(sampleRate, blockSize);
+            instance.setNonRealtime(false);
+            if (!validatePluginInstanceSafety(instance, isInstrument, blockSize, errorMsg))
             {
-                juce::ScopedLock sl(processLock);
-                oldInstrument = std::move(instrumentSlot.instance);
-                instrumentSlot.instance = std::move(instance);
-                instrumentSlot.host.reset();
-                instrumentSlot.description = desc;
-                instrumentSlot.hasDescription = true;
-                instrumentSlot.bypassed = false;
-                instrumentSlot.stabilityCrashCount = 0;
-                instrumentSlot.stabilitySuccessCount = 0;
-                instrumentSlot.lastCrashSummary.clear();
-                builtInInstrumentMode = BuiltInInstrument::None;
-
-                const int requiredChannels = getRequiredPluginChannelsLocked(2);
-                ensurePluginProcessBufferCapacityLocked(requiredChannels, juce::jmax(8192, blockSizeToUse));
+                instance.releaseResources();
+                return false;
             }
+            return true;
+        }
 
-            if (oldInstrument)
-                oldInstrument->releaseResources();
+        // Loads the plugin here, or for IsolatedBridge launches it in a sandboxed child
+        // and returns the BridgedPluginInstance driving it. Launching waits for the
+        // child to load the plugin, so no track lock may be held.
+        static std::unique_ptr<juce::AudioPluginInstance> createPluginInstanceForPolicy(juce::AudioPluginFormatManager& formatManager,
+                                                                                        const juce::PluginDescription& desc,
+                                                                                        PluginHostingPolicy policy,
+                                                                                        double sampleRate,
+                                                                                        int blockSize,
+                                                                                        juce::String& errorMsg)
+        {
+            if (policy == PluginHostingPolicy::IsolatedBridge)
+                return BridgedPluginInstance::create(juce::File::getSpecialLocation(juce::File::currentExecutableFile),
+                                                     desc,
+                                                     sampleRate,
+                                                     blockSize,
+                                                     errorMsg);
+            return formatManager.createPluginInstance(desc, sampleRate, blockSize, errorMsg);
+        }
 
-            return true;
+        bool loadInstrumentPlugin(const juce::PluginDescription& desc, juce::String& errorMsg)
+        {
+            return createAndAttachPlugin(instrumentSlotIndex, desc, errorMsg);
         }
 
         void loadPlugin(const juce::PluginDescription& desc, juce::String& errorMsg)
@@ -683,68 +753,121 @@ namespace sampledex
                 return false;
             }
 
-            double sampleRateToUse = 44100.0;
-            int blockSizeToUse = 512;
-            juce::AudioPlayHead* playHeadToUse = nullptr;
+            return createAndAttachPlugin(slotIndex, desc, errorMsg);
+        }
+
+        // Clears the slot and marks it as waiting for an asynchronously created instance.
+        // Until attachPreparedPlugin() is called with the returned token the slot passes
+        // audio through (an instrument slot stays silent). Returns 0 for a bad slot.
+        std::uint64_t beginPendingPluginLoad(int slotIndex, const juce::PluginDescription& desc)
+        {
+            std::uint64_t token = 0;
             {
                 juce::ScopedLock sl(processLock);
-                sampleRateToUse = preparedSampleRate > 0.0 ? preparedSampleRate
-                                  : (juce::AudioProcessor::getSampleRate() > 0.0 ? juce::AudioProcessor::getSampleRate() : 44100.0);
-                blockSizeToUse = preparedBlockSize > 0 ? preparedBlockSize
-                                 : (juce::AudioProcessor::getBlockSize() > 0 ? juce::AudioProcessor::getBlockSize() : 512);
-                playHeadToUse = transportPlayHead;
+                auto* slot = getSlotForIndexLocked(slotIndex);
+                if (slot == nullptr)
+                    return 0;
+
+                retirePluginSlotLocked(*slot);
+                slot->description = desc;
+                slot->hasDescription = true;
+                slot->pendingLoadToken = ++lastPendingLoadToken;
+                token = slot->pendingLoadToken;
+                if (slotIndex == instrumentSlotIndex)
+                    builtInInstrumentMode = BuiltInInstrument::None;
+                publishPluginChainLocked();
+                updatePluginUiCacheLocked();
             }
 
-            std::unique_ptr<juce::AudioPluginInstance> instance =
-                fmtMgr.createPluginInstance(desc, sampleRateToUse, blockSizeToUse, errorMsg);
-            if (instance == nullptr)
-                return false;
+            drainRetiredPluginObjects();
+            return token;
+        }
 
-            if (!configurePluginBusLayout(*instance, false))
+        void cancelPendingPluginLoad(int slotIndex, std::uint64_t token)
+        {
+            juce::ScopedLock sl(processLock);
+            auto* slot = getSlotForIndexLocked(slotIndex);
+            if (slot == nullptr || token == 0 || slot->pendingLoadToken != token)
+                return;
+
+            slot->pendingLoadToken = 0;
+            slot->pendingState = {};
+            if (slot->instance == nullptr)
             {
-                errorMsg = "Plugin bus layout is incompatible with insert hosting.";
-                return false;
+                slot->description = {};
+                slot->hasDescription = false;
             }
+            updatePluginUiCacheLocked();
+        }
+
+        bool isPluginSlotLoadPending(int slotIndex) const
+        {
+            juce::ScopedLock sl(processLock);
+            const auto* slot = getSlotForIndexLocked(slotIndex);
+            return slot != nullptr && slot->pendingLoadToken != 0;
+        }
 
-            const int effectInputs = juce::jmax(1, juce::jmin(2, instance->getMainBusNumInputChannels()));
-            const int effectOutputs = juce::jmax(effectInputs, getUsableMainOutputChannels(*instance));
-            if (effectOutputs <= 0)
+        bool isPendingPluginLoadCurrent(int slotIndex, std::uint64_t token) const
+        {
+            juce::ScopedLock sl(processLock);
+            const auto* slot = getSlotForIndexLocked(slotIndex);
+            return slot != nullptr && token != 0 && slot->pendingLoadToken == token;
+        }
+
+        // Installs an instance that already went through preparePluginInstanceForHosting().
+        // pendingLoadToken must match beginPendingPluginLoad() unless it is 0; a stale token
+        // means the slot was changed meanwhile and the instance is rejected.
+        bool attachPreparedPlugin(int slotIndex,
+                                  std::unique_ptr<juce::AudioPluginInstance> instance,
+                                  const juce::PluginDescription& desc,
+                                  double preparedAtSampleRate,
+                                  int preparedAtBlockSize,
+                                  juce::String& errorMsg,
+                                  std::uint64_t pendingLoadToken = 0)
+        {
+            if (instance == nullptr)
             {
-                errorMsg = "Effect plugin does not expose a usable output bus.";
+                errorMsg = "Plugin instance is missing.";
                 return false;
             }
-            instance->setPlayConfigDetails(effectInputs, effectOutputs, sampleRateToUse, blockSizeToUse);
-            instance->setRateAndBufferSizeDetails(sampleRateToUse, blockSizeToUse);
-            instance->setPlayHead(playHeadToUse);
-            instance->prepareToPlay(sampleRateToUse, blockSizeToUse);
-            instance->setNonRealtime(false);
-            if (!validatePluginInstanceSafety(*instance, false, blockSizeToUse, errorMsg))
+
+            const double sampleRate = getPluginHostingSampleRate();
+            const int blockSize = getPluginHostingBlockSize();
+            if (sampleRate != preparedAtSampleRate || blockSize != preparedAtBlockSize)
             {
+                // The device changed while the instance was being created.
                 instance->releaseResources();
-                return false;
+                if (!preparePluginInstanceForHosting(*instance, slotIndex == instrumentSlotIndex, sampleRate, blockSize, errorMsg))
+                    return false;
             }
 
-            std::unique_ptr<juce::AudioPluginInstance> oldInsert;
             {
                 juce::ScopedLock sl(processLock);
-                auto& slot = pluginSlots[static_cast<size_t>(slotIndex)];
-                oldInsert = std::move(slot.instance);
-                slot.instance = std::move(instance);
-                slot.host.reset();
-                slot.description = desc;
-                slot.hasDescription = true;
-                slot.bypassed = false;
-                slot.stabilityCrashCount = 0;
-                slot.stabilitySuccessCount = 0;
-                slot.lastCrashSummary.clear();
+                auto* slot = getSlotForIndexLocked(slotIndex);
+                if (slot == nullptr)
+                {
+                    errorMsg = "Invalid insert slot index.";
+                    return false;
+                }
+                if (pendingLoadToken != 0 && slot->pendingLoadToken != pendingLoadToken)
+                {
+                    errorMsg = "Plugin load was superseded by another change to the slot.";
+                    return false;
+                }
 
-                const int requiredChannels = getRequiredPluginChannelsLocked(2);
-                ensurePluginProcessBufferCapacityLocked(requiredChannels, juce::jmax(8192, blockSizeToUse));
+                instance->setPlayHead(transportPlayHead);
+                retirePluginSlotLocked(*slot);
+                slot->instance = std::move(instance);
+                slot->stateTracker = std::make_unique<PluginStateChangeTracker>(*slot->instance);
+                slot->description = desc;
+                slot->hasDescription = true;
+                if (slotIndex == instrumentSlotIndex)
+                    builtInInstrumentMode = BuiltInInstrument::None;
+                publishPluginChainLocked();
+                updatePluginUiCacheLocked();
             }
 
-            if (oldInsert)
-                oldInsert->releaseResources();
-
+            drainRetiredPluginObjects();
             return true;
         }
 
@@ -767,18 +890,15 @@ namespace sampledex
         juce::AudioProcessorEditor* createPluginEditorForSlot(int slotIndex)
         {
             juce::ScopedLock sl(processLock);
-            if (slotIndex == instrumentSlotIndex)
-            {
-                if (instrumentSlot.instance)
-                    return instrumentSlot.instance->createEditorIfNeeded();
-                return nullptr;
-            }
-
-            if (!juce::isPositiveAndBelow(slotIndex, maxInsertSlots))
+            auto* slot = getSlotForIndexLocked(slotIndex);
+            if (slot == nullptr || slot->instance == nullptr)
                 return nullptr;
 
-            auto& slot = pluginSlots[static_cast<size_t>(slotIndex)];
-            return slot.instance ? slot.instance->createEditorIfNeeded() : nullptr;
+            // Editors can change state without notifying any listener.
+            slot->editorShownSinceStateCache = true;
+            if (slot->stateTracker != nullptr)
+                slot->stateTracker->markChanged();
+            return slot->instance->createEditorIfNeeded();
         }
 
         bool hasPlugin() const
@@ -857,78 +977,201 @@ namespace sampledex
         bool getPluginDescriptionForSlot(int slotIndex, juce::PluginDescription& outDescription) const
         {
             juce::ScopedLock sl(processLock);
-            if (slotIndex == instrumentSlotIndex)
-            {
-                if (instrumentSlot.instance == nullptr)
-                    return false;
-                outDescription = instrumentSlot.description;
-                return true;
-            }
-
-            if (!juce::isPositiveAndBelow(slotIndex, maxInsertSlots))
-                return false;
-
-            const auto& slot = pluginSlots[static_cast<size_t>(slotIndex)];
-            if (slot.instance == nullptr)
+            // Pending slots report what they are loading so a save meanwhile keeps them.
+            const auto* slot = getSlotForIndexLocked(slotIndex);
+            if (slot == nullptr || (slot->instance == nullptr && slot->pendingLoadToken == 0))
                 return false;
 
-            outDescription = slot.description;
+            outDescription = slot->description;
             return true;
         }
 
         juce::String getPluginStateForSlot(int slotIndex) const
         {
-            juce::ScopedLock sl(processLock);
-            auto* slot = const_cast<Track*>(this)->getSlotForIndexLocked(slotIndex);
-            if (slot == nullptr || slot->instance == nullptr)
-                return {};
+            return getPluginStateBlobForSlot(slotIndex).toBase64();
+        }
 
-            if (!const_cast<Track*>(this)->ensureHostForSlotLocked(*slot) || slot->host == nullptr)
-                return {};
+        // Returns the slot state, asking the plugin only when it may have changed since the
+        // last snapshot: a parameter or state change was reported, its editor has been open,
+        // it has no parameters to observe, or it runs in a sandbox process.
+        //
+        // The plugin is asked without processLock, which a large state or a sandboxed
+        // child could hold for a long time. A chain reader taken under the lock pins the
+        // instance and host meanwhile: retired objects are only freed once no reader is
+        // left, and prepareToPlay() waits for readers before touching the instance.
+        PluginStateBlob getPluginStateBlobForSlot(int slotIndex) const
+        {
+            auto& self = const_cast<Track&>(*this);
+            std::optional<ScopedPluginChainReader> pin;
+            PluginSlotHost* host = nullptr;
+            std::uint64_t changeCount = 0;
+            std::uint64_t generation = 0;
+            {
+                juce::ScopedLock sl(processLock);
+                auto* slot = self.getSlotForIndexLocked(slotIndex);
+                if (slot == nullptr)
+                    return {};
+                if (slot->instance == nullptr)
+                    return slot->pendingLoadToken != 0 ? slot->pendingState : PluginStateBlob();
+
+                host = self.getHostForSlotLocked(*slot);
+                if (host == nullptr)
+                    return {};
+
+                changeCount = slot->stateTracker != nullptr ? slot->stateTracker->getChangeCount() : 0;
+                const bool canVerify = slot->stateTracker != nullptr
+                                    && !host->usesBridgeTransport()
+                                    && !slot->instance->getParameters().isEmpty()
+                                    && slot->instance->getActiveEditor() == nullptr
+                                    && !slot->editorShownSinceStateCache;
+                if (canVerify && !slot->cachedState.isEmpty() && slot->cachedStateChangeCount == changeCount)
+                    return slot->cachedState;
+
+                generation = slot->instanceGeneration;
+                pin.emplace(*this);
+            }
 
             PluginBridgeMessage message;
             message.type = PluginBridgeMessage::Type::GetState;
             juce::String errorText;
-            if (!slot->host->handleMessage(message, errorText))
+            const bool captured = host->handleMessage(message, errorText);
+            // Released before the lock is taken again: prepareToPlay() holds the lock
+            // while it waits for readers.
+            pin.reset();
+            if (!captured)
                 return {};
 
-            return message.statePayload.toBase64Encoding();
+            juce::ScopedLock sl(processLock);
+            auto* slot = self.getSlotForIndexLocked(slotIndex);
+            if (slot == nullptr || slot->instanceGeneration != generation)
+                return PluginStateBlob::fromMemory(std::move(message.statePayload)); // replaced meanwhile; not cached
+
+            rememberPluginStateLocked(*slot, std::move(message.statePayload), changeCount);
+            return slot->cachedState;
         }
 
-        bool setPluginStateForSlot(int slotIndex, const juce::String& encodedState)
+        // Changes whenever the slot's state may have: a new instance, a loaded state, an
+        // opened editor or a change the plugin reported. Reads no state, so it is cheap to
+        // poll; it only means something while arePluginStatesObservable() holds.
+        struct PluginStateRevision
+        {
+            std::uint64_t instanceGeneration = 0;
+            std::uint64_t changeCount = 0;
+        };
+
+        PluginStateRevision getPluginStateRevisionForSlot(int slotIndex) const
         {
             juce::ScopedLock sl(processLock);
-            if (encodedState.isEmpty())
-                return false;
+            const auto* slot = getSlotForIndexLocked(slotIndex);
+            if (slot == nullptr || slot->instance == nullptr)
+                return {};
+            return { slot->instanceGeneration, slot->stateTracker != nullptr ? slot->stateTracker->getChangeCount() : 0 };
+        }
 
-            PluginSlot* slot = nullptr;
-            if (slotIndex == instrumentSlotIndex)
-            {
-                if (instrumentSlot.instance == nullptr)
-                    return false;
-                slot = &instrumentSlot;
-            }
-            else
-            {
-                if (!juce::isPositiveAndBelow(slotIndex, maxInsertSlots))
-                    return false;
-                slot = &pluginSlots[static_cast<size_t>(slotIndex)];
-                if (slot->instance == nullptr)
+        // The longest tail the instrument and insert plugins report, in seconds; infinite
+        // when one never stops producing output.
+        double getPluginChainTailSeconds() const
+        {
+            const ScopedPluginChainReader chainReader(*this);
+            const auto* chain = chainReader.get();
+            return chain != nullptr ? chain->tailSeconds : 0.0;
+        }
+
+        // True when every loaded plugin reports its own parameter and state changes (it
+        // has parameters, runs in process and has no editor open), so the state blobs
+        // above stay cheap to poll and a changed blob means the plugin really changed.
+        bool arePluginStatesObservable() const
+        {
+            juce::ScopedLock sl(processLock);
+            const auto observable = [this](const PluginSlot& slot)
+            {
+                if (slot.instance == nullptr)
+                    return slot.pendingLoadToken == 0;
+                auto* host = const_cast<Track*>(this)->getHostForSlotLocked(const_cast<PluginSlot&>(slot));
+                return host != nullptr
+                    && slot.stateTracker != nullptr
+                    && !host->usesBridgeTransport()
+                    && !slot.instance->getParameters().isEmpty()
+                    && slot.instance->getActiveEditor() == nullptr;
+            };
+
+            if (!observable(instrumentSlot))
+                return false;
+            for (const auto& slot : pluginSlots)
+                if (!observable(slot))
                     return false;
-            }
+            return true;
+        }
+
+        bool setPluginStateForSlot(int slotIndex, const juce::String& encodedState)
+        {
+            if (encodedState.isEmpty())
+                return false;
 
             juce::MemoryBlock block;
             if (!block.fromBase64Encoding(encodedState))
                 return false;
 
-            if (!ensureHostForSlotLocked(*slot) || slot->host == nullptr)
+            return setPluginStateForSlot(slotIndex, block);
+        }
+
+        bool setPluginStateForSlot(int slotIndex, const PluginStateBlob& state)
+        {
+            if (state.data != nullptr)
+                return setPluginStateForSlot(slotIndex, state.data);
+
+            juce::MemoryBlock block;
+            if (state.isEmpty() || !state.read(block))
+                return false;
+            return setPluginStateForSlot(slotIndex, std::make_shared<const juce::MemoryBlock>(std::move(block)));
+        }
+
+        bool setPluginStateForSlot(int slotIndex, const juce::MemoryBlock& state)
+        {
+            return setPluginStateForSlot(slotIndex, std::make_shared<const juce::MemoryBlock>(state));
+        }
+
+        bool setPluginStateForSlot(int slotIndex, std::shared_ptr<const juce::MemoryBlock> state)
+        {
+            if (state == nullptr)
+                return false;
+
+            juce::ScopedLock sl(processLock);
+            auto* slot = getSlotForIndexLocked(slotIndex);
+            if (slot == nullptr || slot->instance == nullptr)
+                return false;
+
+            auto* host = getHostForSlotLocked(*slot);
+            if (host == nullptr)
                 return false;
 
             PluginBridgeMessage message;
             message.type = PluginBridgeMessage::Type::SetState;
-            message.statePayload = block;
+            message.statePayload = *state;
             juce::String errorText;
-            return slot->host->handleMessage(message, errorText);
+            if (!host->handleMessage(message, errorText))
+                return false;
+
+            // Plugins notify parameter changes while loading a state; the snapshot starts
+            // after that. A plugin that normalises the state on load is caught by the
+            // hash comparison on the next real read. Not every plugin notifies, so the
+            // load counts as a change itself.
+            if (slot->stateTracker != nullptr)
+                slot->stateTracker->markChanged();
+            slot->cachedState = PluginStateBlob::fromMemory(std::move(state));
+            slot->cachedStateChangeCount = slot->stateTracker != nullptr ? slot->stateTracker->getChangeCount() : 0;
+            slot->editorShownSinceStateCache = slot->instance->getActiveEditor() != nullptr;
+            return true;
+        }
+
+        // Keeps the saved state of a slot that is still loading, so saving the project
+        // before the plugin is live does not drop it.
+        void setPendingPluginState(int slotIndex, std::uint64_t token, const PluginStateBlob& state)
+        {
+            juce::ScopedLock sl(processLock);
+            auto* slot = getSlotForIndexLocked(slotIndex);
+            if (slot != nullptr && token != 0 && slot->pendingLoadToken == token)
+                slot->pendingState = state;
         }
 
         juce::String getPluginSummary() const
@@ -985,28 +1228,64 @@ namespace sampledex
         void setPluginSlotBypassed(int slotIndex, bool shouldBypass)
         {
             juce::ScopedLock sl(processLock);
-            if (slotIndex == instrumentSlotIndex)
-            {
-                instrumentSlot.bypassed = shouldBypass;
-                updatePluginUiCacheLocked();
+            auto* slot = getSlotForIndexLocked(slotIndex);
+            if (slot == nullptr)
                 return;
-            }
 
-            if (!juce::isPositiveAndBelow(slotIndex, maxInsertSlots))
-                return;
-            pluginSlots[static_cast<size_t>(slotIndex)].bypassed = shouldBypass;
+            // Report any crash the audio thread flagged before the user clears its bypass.
+            collectPluginCrashReportsLocked();
+            slot->setBypassed(shouldBypass);
             updatePluginUiCacheLocked();
         }
 
+        // Records the policy for the slot's next load. A loaded plugin hosted the other
+        // way is moved, keeping its state and bypass: the replacement is created (for
+        // a sandbox, its child launched) and restored before the lock is taken to swap it in.
         void setPluginHostingPolicyForSlot(int slotIndex, PluginHostingPolicy policy)
         {
-            juce::ScopedLock sl(processLock);
-            auto* slot = getSlotForIndexLocked(slotIndex);
-            if (slot == nullptr)
+            juce::PluginDescription description;
+            bool wasBypassed = false;
+            {
+                juce::ScopedLock sl(processLock);
+                auto* slot = getSlotForIndexLocked(slotIndex);
+                if (slot == nullptr)
+                    return;
+
+                slot->hostingPolicy = policy;
+                const bool isBridged = dynamic_cast<BridgedPluginInstance*>(slot->instance.get()) != nullptr;
+                if (slot->instance == nullptr || isBridged == (policy == PluginHostingPolicy::IsolatedBridge))
+                    return;
+
+                description = slot->description;
+                wasBypassed = slot->isBypassed();
+            }
+
+            const auto state = getPluginStateBlobForSlot(slotIndex);
+            const double sampleRate = getPluginHostingSampleRate();
+            const int blockSize = getPluginHostingBlockSize();
+            juce::String errorMsg;
+            auto replacement = createPluginInstanceForPolicy(fmtMgr, description, policy, sampleRate, blockSize, errorMsg);
+            if (replacement != nullptr
+                && !preparePluginInstanceForHosting(*replacement, slotIndex == instrumentSlotIndex, sampleRate, blockSize, errorMsg))
+                replacement.reset();
+
+            juce::MemoryBlock stateData;
+            if (replacement != nullptr && !state.isEmpty() && state.read(stateData))
+                replacement->setStateInformation(stateData.getData(), static_cast<int>(stateData.getSize()));
+
+            if (replacement == nullptr
+                || !attachPreparedPlugin(slotIndex, std::move(replacement), description, sampleRate, blockSize, errorMsg))
+            {
+                juce::ScopedLock sl(processLock);
+                if (auto* slot = getSlotForIndexLocked(slotIndex))
+                {
+                    slot->lastCrashSummary = "Unable to move plugin to its new host: " + errorMsg;
+                    pushSlotDiagnosticLocked(slotIndex, *slot, slot->lastCrashSummary);
+                }
                 return;
-            slot->hostingPolicy = policy;
-            slot->host.reset();
-            updatePluginUiCacheLocked();
+            }
+
+            setPluginSlotBypassed(slotIndex, wasBypassed);
         }
 
         PluginHostingPolicy getPluginHostingPolicyForSlot(int slotIndex) const
@@ -1022,6 +1301,7 @@ namespace sampledex
         bool popNextPluginSlotDiagnostic(PluginSlotDiagnostic& out)
         {
             juce::ScopedLock sl(processLock);
+            collectPluginCrashReportsLocked();
             if (pendingSlotDiagnostics.empty())
                 return false;
             out = pendingSlotDiagnostics.front();
@@ -1029,46 +1309,49 @@ namespace sampledex
             return true;
         }
 
+        // Frees plugins, hosts and chains replaced since the last call, once no
+        // processBlockAndSends() can still be reading them. Message thread only;
+        // returns immediately while a block is in flight and retries on the next call.
+        void drainRetiredPluginObjects()
+        {
+            std::vector<RetiredPluginObjects> drained;
+            {
+                juce::ScopedLock sl(processLock);
+                if (retiredPluginObjects.empty()
+                    || activePluginChainReaders.load(std::memory_order_seq_cst) != 0)
+                    return;
+                drained.swap(retiredPluginObjects);
+            }
+
+            for (auto& retired : drained)
+            {
+                retired.host.reset();
+                if (retired.instance != nullptr)
+                    retired.instance->releaseResources();
+            }
+        }
+
         void clearPluginSlot(int slotIndex)
         {
-            std::unique_ptr<juce::AudioPluginInstance> oldInstance;
-            bool clearedInstrument = false;
             {
                 juce::ScopedLock sl(processLock);
                 if (slotIndex == instrumentSlotIndex)
                 {
-                    oldInstance = std::move(instrumentSlot.instance);
-                    instrumentSlot.host.reset();
-                    instrumentSlot.description = {};
-                    instrumentSlot.hasDescription = false;
-                    instrumentSlot.bypassed = false;
-                    instrumentSlot.stabilityCrashCount = 0;
-                    instrumentSlot.stabilitySuccessCount = 0;
-                    instrumentSlot.lastCrashSummary.clear();
+                    retirePluginSlotLocked(instrumentSlot);
                     builtInInstrumentMode = BuiltInInstrument::BasicSynth;
                     samplerSamplePath.clear();
-                    clearedInstrument = true;
                 }
                 else
                 {
                     if (!juce::isPositiveAndBelow(slotIndex, maxInsertSlots))
                         return;
 
-                    auto& slot = pluginSlots[static_cast<size_t>(slotIndex)];
-                    oldInstance = std::move(slot.instance);
-                    slot.host.reset();
-                    slot.description = {};
-                    slot.hasDescription = false;
-                    slot.bypassed = false;
-                    slot.stabilityCrashCount = 0;
-                    slot.stabilitySuccessCount = 0;
-                    slot.lastCrashSummary.clear();
+                    retirePluginSlotLocked(pluginSlots[static_cast<size_t>(slotIndex)]);
                 }
+                publishPluginChainLocked();
             }
 
-            if (oldInstance)
-                oldInstance->releaseResources();
-            juce::ignoreUnused(clearedInstrument);
+            drainRetiredPluginObjects();
         }
 
         bool movePluginSlot(int fromIndex, int toIndex)
@@ -1091,6 +1374,7 @@ namespace sampledex
                     pluginSlots[static_cast<size_t>(i)] = std::move(pluginSlots[static_cast<size_t>(i - 1)]);
             }
             pluginSlots[static_cast<size_t>(toIndex)] = std::move(movedSlot);
+            publishPluginChainLocked();
             return true;
         }
 
@@ -1164,6 +1448,33 @@ namespace sampledex
                 setPluginStateForSlot(desc.isInstrument ? instrumentSlotIndex : 0, stateParams);
         }
 
+        // --- MIDI arena diagnostics ---
+        void setMidiOverflowPolicy(MidiOverflowPolicy policy)
+        {
+            midiOverflowPolicy.store(static_cast<int>(policy), std::memory_order_relaxed);
+        }
+
+        MidiOverflowPolicy getMidiOverflowPolicy() const
+        {
+            return static_cast<MidiOverflowPolicy>(midiOverflowPolicy.load(std::memory_order_relaxed));
+        }
+
+        int getDroppedMidiEventCount() const noexcept
+        {
+            return droppedMidiEvents.load(std::memory_order_relaxed);
+        }
+
+        int getMidiArenaHighWaterBytes() const noexcept
+        {
+            return midiArenaHighWaterBytes.load(std::memory_order_relaxed);
+        }
+
+        void resetMidiArenaStats() noexcept
+        {
+            droppedMidiEvents.store(0, std::memory_order_relaxed);
+            midiArenaHighWaterBytes.store(0, std::memory_order_relaxed);
+        }
+
         // --- Recording ---
         void startRecording() 
         { 
@@ -1239,22 +1550,17 @@ namespace sampledex
             recordedReadIndex.store(read, std::memory_order_release);
         }
 
+        // Serviced by the audio thread at the start of its next block.
         void panic()
         {
-            juce::ScopedTryLock sl(processLock);
-            if (!sl.isLocked())
-                return;
-
-            fallbackSynth.allNotesOff(0, false);
-            samplerSynth.allNotesOff(0, false);
-            for (auto& note : activeNotes)
-                note.active = false;
+            panicRequested.store(true, std::memory_order_relaxed);
         }
 
         // --- Audio Processing ---
         void prepareToPlay(double sampleRate, int samplesPerBlock) override
         {
             juce::ScopedLock sl(processLock);
+            const ScopedAudioSuspension suspension(*this);
             preparedSampleRate = sampleRate;
             preparedBlockSize = samplesPerBlock;
             prevLeftGain = volume.load();
@@ -1272,6 +1578,7 @@ namespace sampledex
             startupRampDurationSamples = juce::jmax(1, juce::roundToInt(sampleRate * 0.02));
             startupRampSamplesRemaining = startupRampDurationSamples;
             prepareBuiltInEffectsLocked(sampleRate, samplesPerBlock);
+            ensureMidiArenaCapacityLocked(samplesPerBlock);
 
             if (instrumentSlot.instance)
             {
@@ -1287,11 +1594,11 @@ namespace sampledex
                     instrumentSlot.instance->setPlayHead(transportPlayHead);
                     instrumentSlot.instance->prepareToPlay(sampleRate, samplesPerBlock);
                     instrumentSlot.instance->setNonRealtime(false);
-                    instrumentSlot.bypassed = false;
+                    instrumentSlot.setBypassed(false);
                 }
                 else
                 {
-                    instrumentSlot.bypassed = true;
+                    instrumentSlot.setBypassed(true);
                 }
             }
             for (auto& slot : pluginSlots)
@@ -1302,7 +1609,7 @@ namespace sampledex
                 const int effectOutputs = juce::jmax(effectInputs, getUsableMainOutputChannels(*slot.instance));
                 if (effectOutputs <= 0)
                 {
-                    slot.bypassed = true;
+                    slot.setBypassed(true);
                     continue;
                 }
                 slot.instance->setPlayConfigDetails(effectInputs,
@@ -1313,7 +1620,7 @@ namespace sampledex
                 slot.instance->setPlayHead(transportPlayHead);
                 slot.instance->prepareToPlay(sampleRate, samplesPerBlock);
                 slot.instance->setNonRealtime(false);
-                slot.bypassed = false;
+                slot.setBypassed(false);
             }
 
             const int requiredChannels = getRequiredPluginChannelsLocked(2);
@@ -1321,6 +1628,10 @@ namespace sampledex
             pluginProcessBuffer.clear();
             sendTapBuffer.clear();
             lastSuccessfulOutputBuffer.clear();
+            checkBridgedHostLocked(instrumentSlot);
+            for (auto& slot : pluginSlots)
+                checkBridgedHostLocked(slot);
+            publishPluginChainLocked();
         }
 
         void releaseResources() override
@@ -1356,7 +1667,10 @@ namespace sampledex
                                   juce::MidiBuffer& midi,
                                   const juce::AudioBuffer<float>* sourceAudio,
                                   const juce::AudioBuffer<float>* monitoredInput,
-                                  bool monitorSafeInput)
+                                  bool monitorSafeInput,
+                                  bool sourceIsRenderCache = false,
+                                  juce::AudioBuffer<float>* chainOutputTap = nullptr,
+                                  bool sleepAllowed = false)
         {
             juce::ScopedNoDenormals noDenormals;
 
@@ -1469,8 +1783,33 @@ namespace sampledex
                     sendBuffer.addFrom(ch, 0, mainBuffer, ch, 0, sendSamples, sendGain);
             };
 
-            const juce::ScopedTryLock sl(processLock);
-            if (!sl.isLocked())
+            // No processLock here: the message thread publishes an immutable chain and
+            // only frees what it replaced once no block is still reading it. Everything
+            // else it changes under a ScopedAudioSuspension, which this block respects.
+            const ScopedPluginChainReader chainReader(*this);
+            if (audioSuspensionCount.load(std::memory_order_seq_cst) != 0)
+            {
+                mainBuffer.clear();
+                if (sendBuffer.getNumChannels() > 0)
+                    sendBuffer.clear();
+                updateMeterState(mainBuffer, true);
+                storePostFaderPeak(mainBuffer);
+                updateInputMeterState(nullptr, true);
+                midi.clear();
+                return;
+            }
+
+            if (panicRequested.exchange(false, std::memory_order_relaxed))
+            {
+                const RealtimeSafetyMonitor::ScopedAllowUncontendedLock synthLock;
+                fallbackSynth.allNotesOff(0, false);
+                samplerSynth.allNotesOff(0, false);
+                for (auto& note : activeNotes)
+                    note.active = false;
+            }
+
+            const auto* chain = chainReader.get();
+            if (chain == nullptr)
             {
                 applyLastGoodOutput(sendLevel.load(std::memory_order_relaxed));
                 updateMeterState(mainBuffer, true);
@@ -1492,8 +1831,7 @@ namespace sampledex
                 return;
             }
 
-            const int requiredChannels = juce::jmax(mainBuffer.getNumChannels(),
-                                                    getRequiredPluginChannelsLocked(2));
+            const int requiredChannels = juce::jmax(mainBuffer.getNumChannels(), chain->requiredChannels);
             const int requiredSamples = mainBuffer.getNumSamples();
 
             if (requiredChannels <= 0 || requiredSamples <= 0)
@@ -1517,11 +1855,52 @@ namespace sampledex
                 return;
             }
 
+            // Sleeping: sleepAllowed means the caller has nothing scheduled for this track
+            // within its pre-roll. Once there has also been no MIDI or monitored input for the
+            // chain's reported tail and its output has stayed silent for the hold time, the
+            // instrument, inserts and built-in effects are skipped until something arrives.
+            const bool quietInput = sleepAllowed
+                                    && midi.isEmpty()
+                                    && !(inputMonitoring.load(std::memory_order_relaxed) && monitoredInput != nullptr);
+            if (!quietInput)
+            {
+                sleepSamplesSinceInput = 0;
+                sleepSilentSamples = 0;
+            }
+
+            const double sleepRate = juce::jmax(8000.0, preparedSampleRate);
+            const bool tailFinite = std::isfinite(chain->tailSeconds);
+            const int tailSamples = static_cast<int>(juce::jlimit(0.0, maxSleepTailSeconds, chain->tailSeconds) * sleepRate);
+            double holdSeconds = sleepSilenceHoldSeconds;
+            // Echoes of the built-in delay arrive one delay time apart; silence between them is not the end.
+            if (isBuiltInEffectEnabled(BuiltInEffect::Delay))
+                holdSeconds += 0.001 * juce::jlimit(5.0f, 1800.0f, builtInDelayTimeMs.load(std::memory_order_relaxed));
+            const int holdSamples = static_cast<int>(holdSeconds * sleepRate);
+
+            sleepBlocksTotal.store(sleepBlocksTotal.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            if (quietInput && tailFinite && sleepSamplesSinceInput >= tailSamples && sleepSilentSamples >= holdSamples)
+            {
+                mainBuffer.clear();
+                if (sendBuffer.getNumChannels() > 0)
+                    sendBuffer.clear();
+                updateMeterState(mainBuffer, true);
+                storePostFaderPeak(mainBuffer);
+                updateInputMeterState(nullptr, true);
+                midi.clear();
+                trackAsleep.store(true, std::memory_order_relaxed);
+                sleepBlocksSlept.store(sleepBlocksSlept.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return;
+            }
+            trackAsleep.store(false, std::memory_order_relaxed);
+            if (quietInput)
+                sleepSamplesSinceInput = juce::jmin(sleepSamplesSinceInput + requiredSamples, sleepCounterLimit);
+
             pluginProcessBuffer.clear();
-            juce::MidiBuffer instrumentMidi;
-            instrumentMidi.addEvents(midi, 0, requiredSamples, 0);
-            juce::MidiBuffer insertMidi;
-            insertMidi.addEvents(midi, 0, requiredSamples, 0);
+            // Do not allocate on the audio thread: route through the arenas sized in prepareToPlay.
+            auto& instrumentMidi = instrumentMidiArena;
+            copyMidiIntoArena(midi, instrumentMidi, 0, requiredSamples, 0);
+            auto& insertMidi = insertMidiArena;
+            copyMidiIntoArena(midi, insertMidi, 0, requiredSamples, 0);
 
             const bool monitorInputActive = inputMonitoring.load(std::memory_order_relaxed)
                                             && monitoredInput != nullptr
@@ -1636,21 +2015,29 @@ namespace sampledex
                 }
             };
 
+            // A render cache source already holds what the instrument and inserts would
+            // produce for this block, so both stages are skipped.
+            const bool runPluginChain = !sourceIsRenderCache;
+
             // 1. Instrument stage (Instrument plugin > Sampler > Built-in synth)
             try
             {
-                if (instrumentSlot.instance != nullptr && !instrumentSlot.bypassed)
-                    processSlotWithBridgeLocked(instrumentSlot,
-                                                instrumentSlotIndex,
-                                                pluginProcessBuffer,
-                                                instrumentMidi,
-                                                requiredSamples);
-                else if (builtInInstrumentMode == BuiltInInstrument::Sampler && samplerSynth.getNumSounds() > 0)
+                if (runPluginChain && chain->instrument.instance != nullptr && !chain->instrument.runtime->bypassed.load(std::memory_order_relaxed))
+                    processChainEntry(chain->instrument,
+                                      pluginProcessBuffer,
+                                      instrumentMidi,
+                                      requiredSamples);
+                else if (runPluginChain && chain->builtInInstrumentMode == BuiltInInstrument::Sampler && samplerSynth.getNumSounds() > 0)
                 {
+                    // juce::Synthesiser takes its own lock while rendering. Its only other
+                    // users are prepareToPlay() and the sampler loader, which suspend this
+                    // track's audio first, so the lock is never contended here.
+                    const RealtimeSafetyMonitor::ScopedAllowUncontendedLock synthLock;
                     samplerSynth.renderNextBlock(pluginProcessBuffer, midi, 0, requiredSamples);
                 }
-                else if (builtInInstrumentMode == BuiltInInstrument::BasicSynth)
+                else if (runPluginChain && chain->builtInInstrumentMode == BuiltInInstrument::BasicSynth)
                 {
+                    const RealtimeSafetyMonitor::ScopedAllowUncontendedLock synthLock;
                     fallbackSynth.renderNextBlock(pluginProcessBuffer, midi, 0, requiredSamples);
                 }
 
@@ -1658,24 +2045,32 @@ namespace sampledex
                 mixSourceAudio(pluginProcessBuffer);
 
                 // Post-insert monitor mode feeds live input through insert FX + EQ.
-                if (monitorTap == MonitorTapMode::PostInserts)
+                if (runPluginChain && monitorTap == MonitorTapMode::PostInserts)
                     mixMonitoredInput(pluginProcessBuffer);
 
                 // 2. Insert FX stage
-                for (int slotIndex = 0; slotIndex < maxInsertSlots; ++slotIndex)
+                for (int entryIndex = 0; runPluginChain && entryIndex < chain->insertCount; ++entryIndex)
                 {
-                    auto& slot = pluginSlots[static_cast<size_t>(slotIndex)];
-                    if (slot.instance == nullptr || slot.bypassed)
+                    const auto& entry = chain->inserts[static_cast<size_t>(entryIndex)];
+                    if (entry.runtime->bypassed.load(std::memory_order_relaxed))
                         continue;
-                    processSlotWithBridgeLocked(slot,
-                                                slotIndex,
-                                                pluginProcessBuffer,
-                                                insertMidi,
-                                                requiredSamples);
+                    processChainEntry(entry,
+                                      pluginProcessBuffer,
+                                      insertMidi,
+                                      requiredSamples);
+                }
+
+                // Offline render cache pass: keep the instrument and insert output.
+                if (chainOutputTap != nullptr)
+                {
+                    const int tapSamples = juce::jmin(requiredSamples, chainOutputTap->getNumSamples());
+                    const int tapChannels = juce::jmin(chainOutputTap->getNumChannels(), pluginProcessBuffer.getNumChannels());
+                    for (int ch = 0; ch < tapChannels; ++ch)
+                        chainOutputTap->copyFrom(ch, 0, pluginProcessBuffer, ch, 0, tapSamples);
                 }
 
                 // 2b. Built-in DSP essentials (toggleable track-local effects).
-                applyBuiltInEffectsLocked(pluginProcessBuffer, requiredSamples);
+                applyBuiltInEffects(pluginProcessBuffer, requiredSamples);
             }
             catch (...)
             {
@@ -1703,6 +2098,17 @@ namespace sampledex
                 }
             }
 
+            // Output silence detector for sleeping, on what the chain and built-in effects produced.
+            if (quietInput)
+            {
+                float chainPeak = 0.0f;
+                for (int ch = 0; ch < pluginProcessBuffer.getNumChannels() && chainPeak < sleepSilenceThreshold; ++ch)
+                    chainPeak = juce::jmax(chainPeak, pluginProcessBuffer.getMagnitude(ch, 0, requiredSamples));
+                sleepSilentSamples = chainPeak < sleepSilenceThreshold
+                    ? juce::jmin(sleepSilentSamples + requiredSamples, sleepCounterLimit)
+                    : 0;
+            }
+
             const int pluginOutputChannels = pluginProcessBuffer.getNumChannels();
             const int copyChannels = juce::jmin(mainBuffer.getNumChannels(), pluginOutputChannels);
             if (copyChannels > 0 && pluginOutputChannels > copyChannels)
@@ -1775,7 +2181,7 @@ namespace sampledex
             // 4. In-DAW 3-band EQ stage
             if (eqEnabled.load(std::memory_order_relaxed))
             {
-                updateEqFiltersIfNeededLocked();
+                updateEqFiltersIfNeeded();
                 const int eqChannelCount = juce::jmin(mainBuffer.getNumChannels(), 2);
                 for (int ch = 0; ch < eqChannelCount; ++ch)
                 {
@@ -1819,10 +2225,43 @@ namespace sampledex
             // 5. Mute
             const float currentSend = sendLevel.load(std::memory_order_relaxed);
             const auto sendTap = getSendTapMode();
+            const int blockSamples = mainBuffer.getNumSamples();
+
+            // Automated faders follow their lane per sample; the others keep the block ramp.
+            float* volumeValues = nullptr;
+            float* panValues = nullptr;
+            float* sendValues = nullptr;
+            const bool hasAutomationRamp = std::any_of(blockAutomationRamps.begin(),
+                                                       blockAutomationRamps.end(),
+                                                       [](const AutomationBlockRamp& ramp) { return ramp.isActive(); });
+            if (hasAutomationRamp
+                && automationValueScratch.getNumChannels() >= 3
+                && automationValueScratch.getNumSamples() >= blockSamples)
+            {
+                const auto fillValues = [blockSamples](const AutomationBlockRamp& ramp, float* dest, float from, float to)
+                {
+                    if (ramp.isActive())
+                    {
+                        ramp.fillValues(dest, blockSamples);
+                        return;
+                    }
+                    const float step = blockSamples > 1 ? (to - from) / static_cast<float>(blockSamples - 1) : 0.0f;
+                    for (int i = 0; i < blockSamples; ++i)
+                        dest[i] = from + step * static_cast<float>(i);
+                };
+
+                volumeValues = automationValueScratch.getWritePointer(0);
+                panValues = automationValueScratch.getWritePointer(1);
+                sendValues = automationValueScratch.getWritePointer(2);
+                const float currentPan = juce::jlimit(-1.0f, 1.0f, pan.load());
+                fillValues(blockAutomationRamps[0], volumeValues, prevVolumeGain, volume.load());
+                fillValues(blockAutomationRamps[1], panValues, currentPan, currentPan);
+                fillValues(blockAutomationRamps[2], sendValues, prevSendGain, currentSend);
+            }
 
             const auto copyToSendBus = [&](const juce::AudioBuffer<float>& sourceBuffer)
             {
-                if (currentSend <= 0.0f || sendBuffer.getNumChannels() <= 0)
+                if ((sendValues == nullptr && currentSend <= 0.0f) || sendBuffer.getNumChannels() <= 0)
                     return;
 
                 const int channelCount = juce::jmin(sourceBuffer.getNumChannels(), sendBuffer.getNumChannels());
@@ -1834,6 +2273,12 @@ namespace sampledex
                     if (dst == nullptr || src == nullptr)
                         continue;
 
+                    if (sendValues != nullptr)
+                    {
+                        juce::FloatVectorOperations::addWithMultiply(dst, src, sendValues, sampleCount);
+                        continue;
+                    }
+
                     if (sampleCount == 1)
                     {
                         dst[0] += src[0] * currentSend;
@@ -1880,22 +2325,39 @@ namespace sampledex
                 for (int ch = 0; ch < mainBuffer.getNumChannels(); ++ch)
                 {
                     sendTapBuffer.copyFrom(ch, 0, mainBuffer, ch, 0, mainBuffer.getNumSamples());
-                    sendTapBuffer.applyGainRamp(ch, 0, mainBuffer.getNumSamples(), prevVolumeGain, vol);
+                    if (volumeValues != nullptr)
+                        juce::FloatVectorOperations::multiply(sendTapBuffer.getWritePointer(ch), volumeValues, blockSamples);
+                    else
+                        sendTapBuffer.applyGainRamp(ch, 0, mainBuffer.getNumSamples(), prevVolumeGain, vol);
                 }
             }
 
             // 7. Apply to Main Buffer
-            if (mainBuffer.getNumChannels() > 0)
-                mainBuffer.applyGainRamp(0, 0, mainBuffer.getNumSamples(), prevLeftGain, leftGain);
-            if (mainBuffer.getNumChannels() > 1)
-                mainBuffer.applyGainRamp(1, 0, mainBuffer.getNumSamples(), prevRightGain, rightGain);
-            for (int ch = 2; ch < mainBuffer.getNumChannels(); ++ch)
-                mainBuffer.applyGain(ch, 0, mainBuffer.getNumSamples(), vol);
-
-            prevLeftGain = leftGain;
-            prevRightGain = rightGain;
-            prevVolumeGain = vol;
-            prevSendGain = currentSend;
+            if (volumeValues != nullptr && blockSamples > 0)
+            {
+                applyAutomatedFaderGains(mainBuffer, volumeValues, panValues);
+
+                const int last = blockSamples - 1;
+                const float endAngle = (panValues[last] + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+                prevLeftGain = volumeValues[last] * std::cos(endAngle);
+                prevRightGain = volumeValues[last] * std::sin(endAngle);
+                prevVolumeGain = volumeValues[last];
+                prevSendGain = sendValues[last];
+            }
+            else
+            {
+                if (mainBuffer.getNumChannels() > 0)
+                    mainBuffer.applyGainRamp(0, 0, mainBuffer.getNumSamples(), prevLeftGain, leftGain);
+                if (mainBuffer.getNumChannels() > 1)
+                    mainBuffer.applyGainRamp(1, 0, mainBuffer.getNumSamples(), prevRightGain, rightGain);
+                for (int ch = 2; ch < mainBuffer.getNumChannels(); ++ch)
+                    mainBuffer.applyGain(ch, 0, mainBuffer.getNumSamples(), vol);
+
+                prevLeftGain = leftGain;
+                prevRightGain = rightGain;
+                prevVolumeGain = vol;
+                prevSendGain = currentSend;
+            }
 
             // 8. Post-fader send routing
             if (sendTap == SendTapMode::PostFader
@@ -1909,7 +2371,7 @@ namespace sampledex
                 copyToSendBus(mainBuffer);
             }
 
-            applyStartupRampLocked(mainBuffer);
+            applyStartupRamp(mainBuffer);
 
             storePostFaderPeak(mainBuffer);
 
@@ -1967,6 +2429,9 @@ namespace sampledex
             juce::MemoryBlock statePayload;
             double sampleRate = 44100.0;
             int blockSize = 512;
+            // Process failures are reported here rather than in errorText, which
+            // would allocate on the audio thread.
+            const char* failureText = nullptr;
         };
 
         class PluginSlotHost
@@ -1975,6 +2440,7 @@ namespace sampledex
             virtual ~PluginSlotHost() = default;
             virtual bool handleMessage(PluginBridgeMessage& message, juce::String& errorText) = 0;
             virtual bool usesBridgeTransport() const = 0;
+            virtual int getLatencySamples() const = 0;
         };
 
         class InProcessPluginSlotHost final : public PluginSlotHost
@@ -1996,7 +2462,7 @@ namespace sampledex
                     case PluginBridgeMessage::Type::Process:
                         if (message.context.audio == nullptr || message.context.midi == nullptr)
                         {
-                            errorText = "Bridge process message was missing audio or MIDI payload.";
+                            message.failureText = "Bridge process message was missing audio or MIDI payload.";
                             return false;
                         }
                         instance.processBlock(*message.context.audio, *message.context.midi);
@@ -2018,41 +2484,179 @@ namespace sampledex
             }
 
             bool usesBridgeTransport() const override { return false; }
+            int getLatencySamples() const override { return instance.getLatencySamples(); }
 
         private:
             juce::AudioPluginInstance& instance;
         };
 
+        // Host for a BridgedPluginInstance, whose plugin runs in a child process (see
+        // PluginBridge.h). Same calls as in process, but failures carry the bridge's
+        // reason, and a block failure is reported without allocating.
         class BridgedPluginSlotHost final : public PluginSlotHost
         {
         public:
-            explicit BridgedPluginSlotHost(juce::AudioPluginInstance& pluginInstance)
-                : fallbackHost(pluginInstance)
+            explicit BridgedPluginSlotHost(BridgedPluginInstance& bridgedInstance)
+                : instance(bridgedInstance)
             {
             }
 
             bool handleMessage(PluginBridgeMessage& message, juce::String& errorText) override
             {
-                return fallbackHost.handleMessage(message, errorText);
+                switch (message.type)
+                {
+                    case PluginBridgeMessage::Type::Prepare:
+                        instance.setRateAndBufferSizeDetails(message.sampleRate, message.blockSize);
+                        return instance.prepareBridge(message.sampleRate, message.blockSize, errorText);
+                    case PluginBridgeMessage::Type::Process:
+                    {
+                        if (message.context.audio == nullptr || message.context.midi == nullptr)
+                        {
+                            message.failureText = "Bridge process message was missing audio or MIDI payload.";
+                            return false;
+                        }
+                        const auto result = instance.processBridged(*message.context.audio,
+                                                                    *message.context.midi,
+                                                                    message.context.samples);
+                        if (result == PluginBridgeClient::ProcessResult::ok)
+                            return true;
+                        message.failureText = instance.getFailureText(result);
+                        return false;
+                    }
+                    case PluginBridgeMessage::Type::Release:
+                        instance.releaseResources();
+                        return true;
+                    case PluginBridgeMessage::Type::GetState:
+                        return instance.getBridgeState(message.statePayload, errorText);
+                    case PluginBridgeMessage::Type::SetState:
+                        return instance.setBridgeState(message.statePayload.getData(), message.statePayload.getSize(), errorText);
+                }
+
+                errorText = "Unsupported bridge message type.";
+                return false;
             }
 
             bool usesBridgeTransport() const override { return true; }
+            int getLatencySamples() const override { return instance.getBridgeLatencySamples(); }
 
         private:
-            InProcessPluginSlotHost fallbackHost;
+            BridgedPluginInstance& instance;
+        };
+
+        // State the audio thread writes back to. Lives on the heap so published chains
+        // keep a stable pointer to it even when slots are reordered.
+        struct PluginSlotRuntime
+        {
+            std::atomic<bool> bypassed { false };
+            std::atomic<int> crashCount { 0 };
+            std::atomic<int> successCount { 0 };
+            std::atomic<bool> crashReportPending { false };
+            std::array<char, 256> crashText {};
         };
 
         struct PluginSlot
         {
             std::unique_ptr<juce::AudioPluginInstance> instance;
             std::unique_ptr<PluginSlotHost> host;
+            std::unique_ptr<PluginSlotRuntime> runtime = std::make_unique<PluginSlotRuntime>();
             juce::PluginDescription description;
             bool hasDescription = false;
-            bool bypassed = false;
             PluginHostingPolicy hostingPolicy = PluginHostingPolicy::SafeInProcess;
-            int stabilityCrashCount = 0;
-            int stabilitySuccessCount = 0;
             juce::String lastCrashSummary;
+            std::uint64_t pendingLoadToken = 0;
+            PluginStateBlob pendingState;
+            std::unique_ptr<PluginStateChangeTracker> stateTracker;
+            PluginStateBlob cachedState;
+            std::uint64_t cachedStateChangeCount = 0;
+            bool editorShownSinceStateCache = false;
+            std::uint64_t instanceGeneration = 0; // unique across all slots; renewed whenever the instance is retired
+
+            bool isBypassed() const { return runtime->bypassed.load(std::memory_order_relaxed); }
+            void setBypassed(bool shouldBypass) { runtime->bypassed.store(shouldBypass, std::memory_order_relaxed); }
+            int getCrashCount() const { return runtime->crashCount.load(std::memory_order_relaxed); }
+        };
+
+        struct PluginChainEntry
+        {
+            juce::AudioPluginInstance* instance = nullptr;
+            PluginSlotHost* host = nullptr;
+            PluginSlotRuntime* runtime = nullptr;
+            int slotIndex = instrumentSlotIndex;
+        };
+
+        // Immutable snapshot of what the audio thread processes. Rebuilt and swapped
+        // in by the message thread whenever a slot changes.
+        struct PluginChain
+        {
+            PluginChainEntry instrument;
+            std::array<PluginChainEntry, static_cast<size_t>(maxInsertSlots)> inserts {};
+            int insertCount = 0;
+            BuiltInInstrument builtInInstrumentMode = BuiltInInstrument::BasicSynth;
+            int requiredChannels = 2;
+            double tailSeconds = 0.0; // longest plugin-reported tail; infinite = never sleeps
+        };
+
+        // Objects swapped out of the live chain. Freed by drainRetiredPluginObjects()
+        // once no processBlockAndSends() call can still be holding them.
+        struct RetiredPluginObjects
+        {
+            std::unique_ptr<const PluginChain> chain;
+            std::unique_ptr<juce::AudioPluginInstance> instance;
+            std::unique_ptr<PluginSlotHost> host;
+            std::unique_ptr<PluginSlotRuntime> runtime;
+        };
+
+        class ScopedPluginChainReader final
+        {
+        public:
+            explicit ScopedPluginChainReader(const Track& ownerTrack) noexcept
+                : owner(ownerTrack)
+            {
+                // The increment must be visible before the pointer is read so the
+                // writer's grace-period check cannot miss this reader.
+                owner.activePluginChainReaders.fetch_add(1, std::memory_order_seq_cst);
+                chain = owner.publishedPluginChain.load(std::memory_order_seq_cst);
+            }
+
+            ~ScopedPluginChainReader() noexcept
+            {
+                owner.activePluginChainReaders.fetch_sub(1, std::memory_order_release);
+            }
+
+            const PluginChain* get() const noexcept { return chain; }
+
+        private:
+            const Track& owner;
+            const PluginChain* chain = nullptr;
+
+            JUCE_DECLARE_NON_COPYABLE(ScopedPluginChainReader)
+        };
+
+        // Message thread, for changes the chain snapshot does not cover: the process
+        // buffers, MIDI arenas, built-in synths and effects. New blocks output silence
+        // until the scope ends, and the constructor waits for a block already inside
+        // processBlockAndSends() to leave, so everything it reads can be reallocated.
+        class ScopedAudioSuspension final
+        {
+        public:
+            explicit ScopedAudioSuspension(Track& ownerTrack) noexcept
+                : owner(ownerTrack)
+            {
+                // Paired with the reader: either it sees the suspension, or this sees it.
+                owner.audioSuspensionCount.fetch_add(1, std::memory_order_seq_cst);
+                while (owner.activePluginChainReaders.load(std::memory_order_seq_cst) != 0)
+                    std::this_thread::yield();
+            }
+
+            ~ScopedAudioSuspension() noexcept
+            {
+                owner.audioSuspensionCount.fetch_sub(1, std::memory_order_release);
+            }
+
+        private:
+            Track& owner;
+
+            JUCE_DECLARE_NON_COPYABLE(ScopedAudioSuspension)
         };
 
         PluginSlot* getSlotForIndexLocked(int slotIndex)
@@ -2073,59 +2677,227 @@ namespace sampledex
             return &pluginSlots[static_cast<size_t>(slotIndex)];
         }
 
+        // The host follows the instance: a BridgedPluginInstance was launched into its
+        // child before it got here, so nothing below starts a process under the lock.
         bool ensureHostForSlotLocked(PluginSlot& slot)
         {
             if (slot.instance == nullptr)
                 return false;
 
-            const bool needsBridge = slot.hostingPolicy == PluginHostingPolicy::IsolatedBridge;
+            auto* bridged = dynamic_cast<BridgedPluginInstance*>(slot.instance.get());
+            const bool needsBridge = bridged != nullptr;
             const bool hasBridge = slot.host != nullptr && slot.host->usesBridgeTransport();
             const bool hasInProcess = slot.host != nullptr && !slot.host->usesBridgeTransport();
             if ((needsBridge && hasBridge) || (!needsBridge && hasInProcess))
                 return true;
 
-            if (needsBridge)
-                slot.host = std::make_unique<BridgedPluginSlotHost>(*slot.instance);
+            // The published chain may still point at the old host.
+            if (slot.host != nullptr)
+            {
+                RetiredPluginObjects retired;
+                retired.host = std::move(slot.host);
+                retiredPluginObjects.push_back(std::move(retired));
+            }
+
+            if (bridged != nullptr)
+                slot.host = std::make_unique<BridgedPluginSlotHost>(*bridged);
             else
                 slot.host = std::make_unique<InProcessPluginSlotHost>(*slot.instance);
-            return slot.host != nullptr;
+            return true;
         }
 
-        void pushSlotDiagnosticLocked(int slotIndex, const PluginSlot& slot, const juce::String& summary)
+        // Bypasses a sandboxed slot whose child did not survive being prepared.
+        void checkBridgedHostLocked(PluginSlot& slot)
         {
-            PluginSlotDiagnostic diagnostic;
-            diagnostic.slotIndex = slotIndex;
-            diagnostic.description = slot.description;
-            diagnostic.summary = summary;
-            diagnostic.autoBypassed = slot.bypassed;
-            diagnostic.crashCount = slot.stabilityCrashCount;
-            pendingSlotDiagnostics.push_back(std::move(diagnostic));
+            auto* bridged = dynamic_cast<BridgedPluginInstance*>(slot.instance.get());
+            if (bridged == nullptr || slot.isBypassed() || bridged->isBridgeRunning())
+                return;
+
+            slot.setBypassed(true);
+            slot.lastCrashSummary = "Sandboxed plugin host failed to prepare.";
         }
 
-        bool processSlotWithBridgeLocked(PluginSlot& slot,
-                                         int slotIndex,
-                                         juce::AudioBuffer<float>& buffer,
-                                         juce::MidiBuffer& midi,
-                                         int requiredSamples)
+        PluginSlotHost* getHostForSlotLocked(PluginSlot& slot)
         {
-            if (slot.instance == nullptr || slot.bypassed)
-                return true;
+            const auto* previousHost = slot.host.get();
+            if (!ensureHostForSlotLocked(slot))
+                return nullptr;
+            if (slot.host.get() != previousHost)
+                publishPluginChainLocked();
+            return slot.host.get();
+        }
+
+        void retirePluginSlotLocked(PluginSlot& slot)
+        {
+            // The tracker is registered with the instance, so it goes first.
+            slot.stateTracker.reset();
+            RetiredPluginObjects retired;
+            retired.instance = std::move(slot.instance);
+            retired.host = std::move(slot.host);
+            retired.runtime = std::exchange(slot.runtime, std::make_unique<PluginSlotRuntime>());
+            retiredPluginObjects.push_back(std::move(retired));
+            slot.instanceGeneration = nextPluginInstanceGeneration();
+
+            slot.description = {};
+            slot.hasDescription = false;
+            slot.lastCrashSummary.clear();
+            slot.pendingLoadToken = 0;
+            slot.pendingState = {};
+            slot.cachedState = {};
+            slot.cachedStateChangeCount = 0;
+            slot.editorShownSinceStateCache = false;
+        }
+
+        static std::uint64_t nextPluginInstanceGeneration() noexcept
+        {
+            static std::atomic<std::uint64_t> lastGeneration { 0 };
+            return lastGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        // Keeps the last state read from a plugin. An unchanged hash keeps the previous
+        // buffer, so repeated saves of an untouched plugin share one copy.
+        static void rememberPluginStateLocked(PluginSlot& slot, juce::MemoryBlock&& state, std::uint64_t changeCount)
+        {
+            auto blob = PluginStateBlob::fromMemory(std::move(state));
+            if (slot.cachedState.data != nullptr
+                && slot.cachedState.hash == blob.hash
+                && slot.cachedState.sizeBytes == blob.sizeBytes)
+                blob.data = slot.cachedState.data;
+
+            slot.cachedState = std::move(blob);
+            slot.cachedStateChangeCount = changeCount;
+            slot.editorShownSinceStateCache = slot.instance != nullptr && slot.instance->getActiveEditor() != nullptr;
+        }
+
+        bool makeChainEntryLocked(PluginSlot& slot, int slotIndex, PluginChainEntry& entry)
+        {
+            if (slot.instance == nullptr)
+                return false;
 
             if (getUsableMainOutputChannels(*slot.instance) <= 0)
             {
-                slot.bypassed = true;
-                slot.lastCrashSummary = "Plugin does not expose a usable output bus.";
-                pushSlotDiagnosticLocked(slotIndex, slot, slot.lastCrashSummary);
+                if (!slot.isBypassed())
+                {
+                    slot.setBypassed(true);
+                    slot.lastCrashSummary = "Plugin does not expose a usable output bus.";
+                    pushSlotDiagnosticLocked(slotIndex, slot, slot.lastCrashSummary);
+                }
                 return false;
             }
 
-            if (!ensureHostForSlotLocked(slot) || slot.host == nullptr)
-            {
-                slot.bypassed = true;
-                slot.lastCrashSummary = "Unable to create plugin host bridge.";
-                pushSlotDiagnosticLocked(slotIndex, slot, slot.lastCrashSummary);
+            if (!ensureHostForSlotLocked(slot))
                 return false;
+
+            entry.instance = slot.instance.get();
+            entry.host = slot.host.get();
+            entry.runtime = slot.runtime.get();
+            entry.slotIndex = slotIndex;
+            return true;
+        }
+
+        static double getChainTailSecondsLocked(const PluginChain& chain)
+        {
+            double tail = 0.0;
+            const auto addEntry = [&tail](const PluginChainEntry& entry)
+            {
+                if (entry.instance != nullptr)
+                    tail = juce::jmax(tail, entry.instance->getTailLengthSeconds());
+            };
+            addEntry(chain.instrument);
+            for (int entryIndex = 0; entryIndex < chain.insertCount; ++entryIndex)
+                addEntry(chain.inserts[static_cast<size_t>(entryIndex)]);
+            return tail;
+        }
+
+        void publishPluginChainLocked()
+        {
+            auto chain = std::make_unique<PluginChain>();
+            makeChainEntryLocked(instrumentSlot, instrumentSlotIndex, chain->instrument);
+            for (int slotIndex = 0; slotIndex < maxInsertSlots; ++slotIndex)
+            {
+                auto& entry = chain->inserts[static_cast<size_t>(chain->insertCount)];
+                if (makeChainEntryLocked(pluginSlots[static_cast<size_t>(slotIndex)], slotIndex, entry))
+                    ++chain->insertCount;
+            }
+            chain->builtInInstrumentMode = builtInInstrumentMode;
+            chain->requiredChannels = getRequiredPluginChannelsLocked(2);
+            chain->tailSeconds = getChainTailSecondsLocked(*chain);
+
+            const PluginChain* previous = publishedPluginChain.exchange(chain.release(), std::memory_order_seq_cst);
+            if (previous != nullptr)
+            {
+                RetiredPluginObjects retired;
+                retired.chain.reset(previous);
+                retiredPluginObjects.push_back(std::move(retired));
             }
+        }
+
+        void collectPluginCrashReportsLocked()
+        {
+            const auto collect = [this](PluginSlot& slot, int slotIndex)
+            {
+                if (!slot.runtime->crashReportPending.exchange(false, std::memory_order_acquire))
+                    return;
+                slot.lastCrashSummary = juce::String::fromUTF8(slot.runtime->crashText.data());
+                pushSlotDiagnosticLocked(slotIndex, slot, slot.lastCrashSummary);
+            };
+
+            collect(instrumentSlot, instrumentSlotIndex);
+            for (int slotIndex = 0; slotIndex < maxInsertSlots; ++slotIndex)
+                collect(pluginSlots[static_cast<size_t>(slotIndex)], slotIndex);
+            updatePluginUiCacheLocked();
+        }
+
+        void pushSlotDiagnosticLocked(int slotIndex, const PluginSlot& slot, const juce::String& summary)
+        {
+            PluginSlotDiagnostic diagnostic;
+            diagnostic.slotIndex = slotIndex;
+            diagnostic.description = slot.description;
+            diagnostic.summary = summary;
+            diagnostic.autoBypassed = slot.isBypassed();
+            diagnostic.crashCount = slot.getCrashCount();
+            pendingSlotDiagnostics.push_back(std::move(diagnostic));
+        }
+
+        static int getChainEntryLatencySamples(const PluginChainEntry& entry)
+        {
+            if (entry.instance == nullptr || entry.runtime->bypassed.load(std::memory_order_relaxed))
+                return 0;
+            if (entry.host != nullptr)
+                return juce::jmax(0, entry.host->getLatencySamples());
+            return juce::jmax(0, entry.instance->getLatencySamples());
+        }
+
+        static int getChainInsertLatencySamples(const PluginChain& chain)
+        {
+            int total = 0;
+            for (int entryIndex = 0; entryIndex < chain.insertCount; ++entryIndex)
+                total += getChainEntryLatencySamples(chain.inserts[static_cast<size_t>(entryIndex)]);
+            return total;
+        }
+
+        // Audio thread. Failures are written into the slot runtime without allocating
+        // and turned into diagnostics by collectPluginCrashReportsLocked().
+        static void recordChainEntryCrash(const PluginChainEntry& entry, const char* detail) noexcept
+        {
+            auto& runtime = *entry.runtime;
+            std::snprintf(runtime.crashText.data(),
+                          runtime.crashText.size(),
+                          "Plugin host crash in %s: %s",
+                          entry.host->usesBridgeTransport() ? "isolated bridge" : "in-process host",
+                          detail);
+            runtime.crashCount.fetch_add(1, std::memory_order_relaxed);
+            runtime.bypassed.store(true, std::memory_order_relaxed);
+            runtime.crashReportPending.store(true, std::memory_order_release);
+        }
+
+        static bool processChainEntry(const PluginChainEntry& entry,
+                                      juce::AudioBuffer<float>& buffer,
+                                      juce::MidiBuffer& midi,
+                                      int requiredSamples)
+        {
+            if (entry.instance == nullptr || entry.host == nullptr)
+                return true;
 
             PluginBridgeMessage message;
             message.type = PluginBridgeMessage::Type::Process;
@@ -2133,34 +2905,27 @@ namespace sampledex
             message.context.midi = &midi;
             message.context.samples = requiredSamples;
 
-            juce::String bridgeError;
+            juce::String unusedErrorText;
             try
             {
-                if (!slot.host->handleMessage(message, bridgeError))
-                    throw std::runtime_error(bridgeError.isNotEmpty() ? bridgeError.toStdString() : "Bridge process failure");
+                if (!entry.host->handleMessage(message, unusedErrorText))
+                {
+                    recordChainEntryCrash(entry, message.failureText != nullptr ? message.failureText : "Bridge process failure");
+                    return false;
+                }
             }
             catch (const std::exception& exception)
             {
-                slot.bypassed = true;
-                ++slot.stabilityCrashCount;
-                slot.lastCrashSummary = "Plugin host crash in "
-                    + (slot.host->usesBridgeTransport() ? juce::String("isolated bridge") : juce::String("in-process host"))
-                    + ": " + juce::String(exception.what());
-                pushSlotDiagnosticLocked(slotIndex, slot, slot.lastCrashSummary);
+                recordChainEntryCrash(entry, exception.what());
                 return false;
             }
             catch (...)
             {
-                slot.bypassed = true;
-                ++slot.stabilityCrashCount;
-                slot.lastCrashSummary = "Plugin host crash in "
-                    + (slot.host->usesBridgeTransport() ? juce::String("isolated bridge") : juce::String("in-process host"))
-                    + ": unknown exception.";
-                pushSlotDiagnosticLocked(slotIndex, slot, slot.lastCrashSummary);
+                recordChainEntryCrash(entry, "unknown exception.");
                 return false;
             }
 
-            ++slot.stabilitySuccessCount;
+            entry.runtime->successCount.fetch_add(1, std::memory_order_relaxed);
             return true;
         }
 
@@ -2169,12 +2934,14 @@ namespace sampledex
             if (slotIndex == instrumentSlotIndex)
             {
                 return instrumentSlot.instance != nullptr
+                    || instrumentSlot.pendingLoadToken != 0
                     || builtInInstrumentMode == BuiltInInstrument::BasicSynth
                     || (builtInInstrumentMode == BuiltInInstrument::Sampler && samplerSynth.getNumSounds() > 0);
             }
 
             return juce::isPositiveAndBelow(slotIndex, maxInsertSlots)
-                && pluginSlots[static_cast<size_t>(slotIndex)].instance != nullptr;
+                && (pluginSlots[static_cast<size_t>(slotIndex)].instance != nullptr
+                    || pluginSlots[static_cast<size_t>(slotIndex)].pendingLoadToken != 0);
         }
 
         juce::String getSlotNameLocked(int slotIndex) const
@@ -2183,6 +2950,8 @@ namespace sampledex
             {
                 if (instrumentSlot.instance != nullptr)
                     return instrumentSlot.description.name;
+                if (instrumentSlot.pendingLoadToken != 0)
+                    return instrumentSlot.description.name + " (loading)";
                 if (builtInInstrumentMode == BuiltInInstrument::Sampler && samplerSynth.getNumSounds() > 0)
                     return "Built-in Sampler";
                 if (builtInInstrumentMode == BuiltInInstrument::BasicSynth)
@@ -2194,16 +2963,18 @@ namespace sampledex
                 return {};
 
             const auto& slot = pluginSlots[static_cast<size_t>(slotIndex)];
+            if (slot.instance == nullptr && slot.pendingLoadToken != 0)
+                return slot.description.name + " (loading)";
             return slot.instance != nullptr ? slot.description.name : juce::String{};
         }
 
         bool getSlotBypassedLocked(int slotIndex) const
         {
             if (slotIndex == instrumentSlotIndex)
-                return instrumentSlot.bypassed;
+                return instrumentSlot.isBypassed();
             if (!juce::isPositiveAndBelow(slotIndex, maxInsertSlots))
                 return false;
-            return pluginSlots[static_cast<size_t>(slotIndex)].bypassed;
+            return pluginSlots[static_cast<size_t>(slotIndex)].isBypassed();
         }
 
         void updatePluginUiCacheLocked() const
@@ -2328,7 +3099,7 @@ namespace sampledex
             return juce::jlimit(0.0f, 1.0f, builtInSaturationMix.load(std::memory_order_relaxed));
         }
 
-        void applyBuiltInGateLocked(juce::AudioBuffer<float>& buffer, int channels, int samples)
+        void applyBuiltInGate(juce::AudioBuffer<float>& buffer, int channels, int samples)
         {
             if (samples <= 0 || channels <= 0)
                 return;
@@ -2380,7 +3151,7 @@ namespace sampledex
             builtInGateOpen = gateOpen;
         }
 
-        void applyBuiltInSaturationLocked(juce::AudioBuffer<float>& buffer, int channels, int samples)
+        void applyBuiltInSaturation(juce::AudioBuffer<float>& buffer, int channels, int samples)
         {
             if (samples <= 0 || channels <= 0)
                 return;
@@ -2440,7 +3211,7 @@ namespace sampledex
             builtInSaturationSmoothedMix = targetMix;
         }
 
-        void applyBuiltInDelayLocked(juce::AudioBuffer<float>& buffer, int channels, int samples)
+        void applyBuiltInDelay(juce::AudioBuffer<float>& buffer, int channels, int samples)
         {
             if (channels <= 0 || samples <= 0)
                 return;
@@ -2566,7 +3337,9 @@ namespace sampledex
             builtInDelaySmoothedMix = juce::jlimit(0.0f, 1.0f, smoothedMix);
         }
 
-        void applyBuiltInEffectsLocked(juce::AudioBuffer<float>& buffer, int samples)
+        // Audio thread. The effects' state is only rebuilt by prepareBuiltInEffectsLocked(),
+        // under a ScopedAudioSuspension; parameters arrive through atomics.
+        void applyBuiltInEffects(juce::AudioBuffer<float>& buffer, int samples)
         {
             const int channels = juce::jmin(2, buffer.getNumChannels());
             if (channels <= 0 || samples <= 0)
@@ -2581,11 +3354,11 @@ namespace sampledex
             juce::dsp::ProcessContextReplacing<float> context(stereoBlock);
 
             if ((fxMask & getBuiltInEffectBit(BuiltInEffect::Gate)) != 0u)
-                applyBuiltInGateLocked(buffer, channels, samples);
+                applyBuiltInGate(buffer, channels, samples);
             if ((fxMask & getBuiltInEffectBit(BuiltInEffect::Compressor)) != 0u)
                 builtInCompressor.process(context);
             if ((fxMask & getBuiltInEffectBit(BuiltInEffect::Saturation)) != 0u)
-                applyBuiltInSaturationLocked(buffer, channels, samples);
+                applyBuiltInSaturation(buffer, channels, samples);
             if ((fxMask & getBuiltInEffectBit(BuiltInEffect::Chorus)) != 0u)
                 builtInChorus.process(context);
             if ((fxMask & getBuiltInEffectBit(BuiltInEffect::Flanger)) != 0u)
@@ -2593,7 +3366,7 @@ namespace sampledex
             if ((fxMask & getBuiltInEffectBit(BuiltInEffect::Phaser)) != 0u)
                 builtInPhaser.process(context);
             if ((fxMask & getBuiltInEffectBit(BuiltInEffect::Delay)) != 0u)
-                applyBuiltInDelayLocked(buffer, channels, samples);
+                applyBuiltInDelay(buffer, channels, samples);
             if ((fxMask & getBuiltInEffectBit(BuiltInEffect::Reverb)) != 0u)
             {
                 auto params = builtInReverb.getParameters();
@@ -2616,31 +3389,79 @@ namespace sampledex
                 builtInLimiter.process(context);
         }
 
-        static void processPluginWithChunkedMidi(juce::AudioProcessor& processor,
-                                                 juce::AudioBuffer<float>& buffer,
-                                                 const juce::MidiBuffer& midi,
-                                                 int samples)
+        static bool isMidiReleaseEvent(const juce::uint8* data, int numBytes) noexcept
         {
-            const int channels = buffer.getNumChannels();
-            if (channels <= 0 || samples <= 0)
-                return;
+            if (data == nullptr || numBytes <= 0)
+                return false;
 
-            constexpr int maxChunkSize = 64;
-            juce::MidiBuffer chunkMidi;
-            std::vector<float*> channelPointers(static_cast<size_t>(channels), nullptr);
+            const int status = data[0] & 0xf0;
+            if (status == 0x80)
+                return true;
+            if (status == 0x90)
+                return numBytes >= 3 && data[2] == 0;
+            if (status == 0xb0 && numBytes >= 3)
+            {
+                const int controller = data[1];
+                if (controller == 64 || controller == 66 || controller == 67)
+                    return data[2] < 64;
+                return controller == 120 || controller == 123;
+            }
+            return false;
+        }
 
-            for (int chunkStart = 0; chunkStart < samples; chunkStart += maxChunkSize)
+        void ensureMidiArenaCapacityLocked(int samplesPerBlock)
+        {
+            midiArenaCapacityBytes = getMidiArenaCapacityBytesForBlock(samplesPerBlock);
+            midiArenaReleaseHeadroomBytes = midiArenaCapacityBytes / 8;
+            for (auto* arena : { &instrumentMidiArena, &insertMidiArena })
             {
-                const int chunkSize = juce::jmin(maxChunkSize, samples - chunkStart);
-                chunkMidi.clear();
-                chunkMidi.addEvents(midi, chunkStart, chunkSize, -chunkStart);
+                arena->clear();
+                arena->ensureSize(static_cast<size_t>(midiArenaCapacityBytes));
+            }
+        }
 
-                for (int ch = 0; ch < channels; ++ch)
-                    channelPointers[static_cast<size_t>(ch)] = buffer.getWritePointer(ch, chunkStart);
+        // Copies [startSample, startSample + numSamples) of source into a preallocated arena,
+        // applying the overflow policy instead of letting the arena grow on the audio thread.
+        void copyMidiIntoArena(const juce::MidiBuffer& source,
+                                     juce::MidiBuffer& arena,
+                                     int startSample,
+                                     int numSamples,
+                                     int sampleDelta) noexcept
+        {
+            constexpr int eventHeaderBytes = static_cast<int>(sizeof(juce::int32) + sizeof(juce::uint16));
+            arena.clear();
+            if (numSamples <= 0 || source.isEmpty())
+                return;
 
-                juce::AudioBuffer<float> chunkBuffer(channelPointers.data(), channels, chunkSize);
-                processor.processBlock(chunkBuffer, chunkMidi);
+            const bool preserveReleases = getMidiOverflowPolicy() == MidiOverflowPolicy::PreserveReleases;
+            const int endSample = startSample + numSamples;
+            int dropped = 0;
+            for (auto it = source.findNextSamplePosition(startSample); it != source.cend(); ++it)
+            {
+                const auto metadata = *it;
+                if (metadata.samplePosition >= endSample)
+                    break;
+
+                const int eventBytes = eventHeaderBytes + metadata.numBytes;
+                const bool isRelease = isMidiReleaseEvent(metadata.data, metadata.numBytes);
+                const int budget = (preserveReleases && !isRelease)
+                    ? midiArenaCapacityBytes - midiArenaReleaseHeadroomBytes
+                    : midiArenaCapacityBytes;
+                if (arena.data.size() + eventBytes > budget)
+                {
+                    ++dropped;
+                    continue;
+                }
+
+                arena.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition + sampleDelta);
             }
+
+            if (dropped > 0)
+                droppedMidiEvents.fetch_add(dropped, std::memory_order_relaxed);
+
+            const int usedBytes = arena.data.size();
+            if (usedBytes > midiArenaHighWaterBytes.load(std::memory_order_relaxed))
+                midiArenaHighWaterBytes.store(usedBytes, std::memory_order_relaxed);
         }
 
         int getRequiredPluginChannelsLocked(int minimumChannels) const
@@ -2665,19 +3486,60 @@ namespace sampledex
             return juce::jmax(2, requiredChannels);
         }
 
+        // Equal-power pan and volume with one gain per sample, for automated faders.
+        static void applyAutomatedFaderGains(juce::AudioBuffer<float>& buffer,
+                                             const float* volumeValues,
+                                             const float* panValues)
+        {
+            const int numSamples = buffer.getNumSamples();
+            const int numChannels = buffer.getNumChannels();
+            auto* left = numChannels > 0 ? buffer.getWritePointer(0) : nullptr;
+            auto* right = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float angle = (juce::jlimit(-1.0f, 1.0f, panValues[i]) + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+                if (left != nullptr)
+                    left[i] *= volumeValues[i] * std::cos(angle);
+                if (right != nullptr)
+                    right[i] *= volumeValues[i] * std::sin(angle);
+            }
+            for (int ch = 2; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::multiply(buffer.getWritePointer(ch), volumeValues, numSamples);
+        }
+
         void ensurePluginProcessBufferCapacityLocked(int channels, int samples)
         {
             channels = juce::jmax(2, channels);
             samples = juce::jmax(512, samples);
             pluginProcessBuffer.setSize(channels, samples, false, false, true);
             sendTapBuffer.setSize(channels, samples, false, false, true);
+            automationValueScratch.setSize(3, samples, false, false, true);
             lastSuccessfulOutputBuffer.setSize(channels, samples, false, false, true);
         }
 
-        bool validatePluginInstanceSafety(juce::AudioPluginInstance& instance,
-                                          bool isInstrument,
-                                          int blockSize,
-                                          juce::String& errorMsg) const
+        bool createAndAttachPlugin(int slotIndex, const juce::PluginDescription& desc, juce::String& errorMsg)
+        {
+            const double sampleRate = getPluginHostingSampleRate();
+            const int blockSize = getPluginHostingBlockSize();
+            auto instance = createPluginInstanceForPolicy(fmtMgr,
+                                                          desc,
+                                                          getPluginHostingPolicyForSlot(slotIndex),
+                                                          sampleRate,
+                                                          blockSize,
+                                                          errorMsg);
+            if (instance == nullptr)
+                return false;
+
+            if (!preparePluginInstanceForHosting(*instance, slotIndex == instrumentSlotIndex, sampleRate, blockSize, errorMsg))
+                return false;
+
+            return attachPreparedPlugin(slotIndex, std::move(instance), desc, sampleRate, blockSize, errorMsg);
+        }
+
+        static bool validatePluginInstanceSafety(juce::AudioPluginInstance& instance,
+                                                 bool isInstrument,
+                                                 int blockSize,
+                                                 juce::String& errorMsg)
         {
             const int safeBlockSize = juce::jlimit(64, 2048, blockSize > 0 ? blockSize : 512);
             const int channels = juce::jmax(1,
@@ -2734,7 +3596,7 @@ namespace sampledex
             return true;
         }
 
-        bool configurePluginBusLayout(juce::AudioPluginInstance& instance, bool isInstrument) const
+        static bool configurePluginBusLayout(juce::AudioPluginInstance& instance, bool isInstrument)
         {
             auto makeSet = [](int channels)
             {
@@ -2792,12 +3654,13 @@ namespace sampledex
             return instance.getMainBusNumOutputChannels() > 0;
         }
 
-        int getUsableMainOutputChannels(const juce::AudioPluginInstance& instance) const
+        static int getUsableMainOutputChannels(const juce::AudioPluginInstance& instance)
         {
             return juce::jmax(0, juce::jmin(2, instance.getMainBusNumOutputChannels()));
         }
 
-        void updateEqFiltersIfNeededLocked()
+        // Audio thread; the message thread only sets the gains and eqDirty.
+        void updateEqFiltersIfNeeded()
         {
             const float low = eqLowGainDb.load(std::memory_order_relaxed);
             const float mid = eqMidGainDb.load(std::memory_order_relaxed);
@@ -2831,7 +3694,7 @@ namespace sampledex
             cachedEqHighGainDb = high;
         }
 
-        void applyStartupRampLocked(juce::AudioBuffer<float>& target)
+        void applyStartupRamp(juce::AudioBuffer<float>& target)
         {
             if (startupRampSamplesRemaining <= 0)
                 return;
@@ -2872,6 +3735,12 @@ namespace sampledex
         PluginSlot instrumentSlot;
         std::array<PluginSlot, static_cast<size_t>(maxInsertSlots)> pluginSlots;
         std::vector<PluginSlotDiagnostic> pendingSlotDiagnostics;
+        std::vector<RetiredPluginObjects> retiredPluginObjects;
+        std::atomic<const PluginChain*> publishedPluginChain { nullptr };
+        mutable std::atomic<int> activePluginChainReaders { 0 };
+        std::atomic<int> audioSuspensionCount { 0 };
+        std::atomic<bool> panicRequested { false };
+        std::uint64_t lastPendingLoadToken = 0;
         juce::AudioPlayHead* transportPlayHead = nullptr;
         BuiltInInstrument builtInInstrumentMode = BuiltInInstrument::BasicSynth;
         juce::String samplerSamplePath;
@@ -2899,6 +3768,11 @@ namespace sampledex
         std::atomic<int> outputTargetBus { 0 };
         std::atomic<float> currentLevel { 0.0f };
         std::atomic<float> postFaderOutputPeak { 0.0f };
+        std::atomic<bool> trackAsleep { false };
+        std::atomic<std::uint64_t> sleepBlocksSlept { 0 };
+        std::atomic<std::uint64_t> sleepBlocksTotal { 0 };
+        int sleepSamplesSinceInput = 0; // audio thread
+        int sleepSilentSamples = 0;     // audio thread
         std::atomic<float> meterPeakLevel { 0.0f };
         std::atomic<float> meterRmsLevel { 0.0f };
         std::atomic<int> meterClipHoldFrames { 0 };
@@ -2916,6 +3790,8 @@ namespace sampledex
         float prevRightGain = 0.8f;
         float prevVolumeGain = 0.8f;
         float prevSendGain = 0.0f;
+        std::array<AutomationBlockRamp, 3> blockAutomationRamps {}; // volume, pan, send
+        juce::AudioBuffer<float> automationValueScratch;
         int startupRampSamplesRemaining = 0;
         float startupRampGain = 0.0f;
         std::array<float, 2> monitorDcPrevInput { 0.0f, 0.0f };
@@ -2926,6 +3802,13 @@ namespace sampledex
         juce::AudioBuffer<float> pluginProcessBuffer;
         juce::AudioBuffer<float> sendTapBuffer;
         juce::AudioBuffer<float> lastSuccessfulOutputBuffer;
+        juce::MidiBuffer instrumentMidiArena;
+        juce::MidiBuffer insertMidiArena;
+        int midiArenaCapacityBytes = 0;
+        int midiArenaReleaseHeadroomBytes = 0;
+        std::atomic<int> midiOverflowPolicy { static_cast<int>(MidiOverflowPolicy::PreserveReleases) };
+        std::atomic<int> droppedMidiEvents { 0 };
+        std::atomic<int> midiArenaHighWaterBytes { 0 };
         juce::Synthesiser fallbackSynth;
         juce::Synthesiser samplerSynth;
         std::array<juce::IIRFilter, 2> eqLowFilters;
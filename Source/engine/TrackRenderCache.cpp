@@ -0,0 +1,293 @@
+#include "TrackRenderCache.h"
+
+#include <algorithm>
+
+namespace sampledex
+{
+    namespace
+    {
+        void writeClip(juce::MemoryOutputStream& out, const Clip& clip)
+        {
+            out.writeInt(static_cast<int>(clip.type));
+            out.writeDouble(clip.startBeat);
+            out.writeDouble(clip.lengthBeats);
+            out.writeDouble(clip.offsetBeats);
+
+            out.writeInt(static_cast<int>(clip.events.size()));
+            for (const auto& event : clip.events)
+            {
+                out.writeDouble(event.startBeat);
+                out.writeDouble(event.durationBeats);
+                out.writeInt(event.noteNumber);
+                out.writeByte(static_cast<char>(event.velocity));
+            }
+            out.writeInt(static_cast<int>(clip.ccEvents.size()));
+            for (const auto& event : clip.ccEvents)
+            {
+                out.writeDouble(event.beat);
+                out.writeInt(event.controller);
+                out.writeByte(static_cast<char>(event.value));
+            }
+            out.writeInt(static_cast<int>(clip.pitchBendEvents.size()));
+            for (const auto& event : clip.pitchBendEvents)
+            {
+                out.writeDouble(event.beat);
+                out.writeInt(event.value);
+            }
+            out.writeInt(static_cast<int>(clip.channelPressureEvents.size()));
+            for (const auto& event : clip.channelPressureEvents)
+            {
+                out.writeDouble(event.beat);
+                out.writeByte(static_cast<char>(event.pressure));
+            }
+            out.writeInt(static_cast<int>(clip.polyAftertouchEvents.size()));
+            for (const auto& event : clip.polyAftertouchEvents)
+            {
+                out.writeDouble(event.beat);
+                out.writeInt(event.noteNumber);
+                out.writeByte(static_cast<char>(event.pressure));
+            }
+            out.writeInt(static_cast<int>(clip.programChangeEvents.size()));
+            for (const auto& event : clip.programChangeEvents)
+            {
+                out.writeDouble(event.beat);
+                out.writeInt(event.bankMsb);
+                out.writeInt(event.bankLsb);
+                out.writeInt(event.program);
+            }
+            out.writeInt(static_cast<int>(clip.rawEvents.size()));
+            for (const auto& event : clip.rawEvents)
+            {
+                out.writeDouble(event.beat);
+                out.writeByte(static_cast<char>(event.status));
+                out.writeByte(static_cast<char>(event.data1));
+                out.writeByte(static_cast<char>(event.data2));
+            }
+            out.writeInt(clip.sourceMidiChannel);
+
+            // In-memory audio has no path; its revision changes with every new buffer and edit.
+            out.writeString(clip.audioFilePath);
+            out.writeBool(clip.audioData != nullptr);
+            out.writeInt64(static_cast<juce::int64>(clip.audioDataRevision));
+            out.writeDouble(clip.audioSampleRate);
+            out.writeFloat(clip.gainLinear);
+            out.writeDouble(clip.fadeInBeats);
+            out.writeDouble(clip.fadeOutBeats);
+            out.writeDouble(clip.crossfadeInBeats);
+            out.writeDouble(clip.crossfadeOutBeats);
+            out.writeDouble(clip.detectedTempoBpm);
+            out.writeInt(static_cast<int>(clip.stretchMode));
+            out.writeDouble(clip.originalTempoBpm);
+            out.writeInt(static_cast<int>(clip.warpMarkers.size()));
+            for (const auto& marker : clip.warpMarkers)
+            {
+                out.writeDouble(marker.clipBeat);
+                out.writeDouble(marker.sourceBeat);
+                out.writeFloat(marker.strength);
+                out.writeBool(marker.transientAnchor);
+            }
+            out.writeBool(clip.formantPreserve);
+            out.writeBool(clip.oneShot);
+        }
+
+        void writePluginSlot(juce::MemoryOutputStream& out, const Track& track, int slotIndex)
+        {
+            juce::PluginDescription description;
+            if (!track.getPluginDescriptionForSlot(slotIndex, description))
+            {
+                out.writeBool(false);
+                return;
+            }
+
+            out.writeBool(true);
+            out.writeString(description.createIdentifierString());
+            out.writeBool(track.isPluginSlotBypassed(slotIndex));
+            // The state itself is only serialised when a render clones the track.
+            const auto revision = track.getPluginStateRevisionForSlot(slotIndex);
+            out.writeInt64(static_cast<juce::int64>(revision.instanceGeneration));
+            out.writeInt64(static_cast<juce::int64>(revision.changeCount));
+        }
+    }
+
+    void TrackRenderCache::setDirectory(const juce::File& newDirectory)
+    {
+        clear();
+        directory = newDirectory;
+        if (directory.isDirectory())
+            for (const auto& stale : directory.findChildFiles(juce::File::findFiles, false, "*.wav"))
+                stale.deleteFile();
+        directory.createDirectory();
+    }
+
+    juce::File TrackRenderCache::getFileForKey(const juce::String& key) const
+    {
+        return directory.getChildFile(key + ".wav");
+    }
+
+    bool TrackRenderCache::canCacheTrack(const Track& track)
+    {
+        if (track.getChannelType() == Track::ChannelType::Aux
+            || track.isFrozenPlaybackOnly()
+            || track.isRenderTaskActive())
+            return false;
+
+        bool hasPlugin = track.hasInstrumentPlugin() && !track.isPluginSlotBypassed(Track::instrumentSlotIndex);
+        for (int slot = 0; slot < track.getPluginSlotCount() && !hasPlugin; ++slot)
+            hasPlugin = track.hasPluginInSlot(slot) && !track.isPluginSlotBypassed(slot);
+        return hasPlugin && track.arePluginStatesObservable();
+    }
+
+    juce::String TrackRenderCache::computeKey(const Track& track,
+                                              const std::vector<const Clip*>& trackClips,
+                                              const std::vector<TempoEvent>& tempoEvents,
+                                              double fallbackBpm,
+                                              int globalTransposeSemitones,
+                                              double sampleRate)
+    {
+        juce::MemoryOutputStream out(4096);
+        out.writeDouble(sampleRate);
+        out.writeDouble(fallbackBpm);
+        out.writeInt(globalTransposeSemitones);
+        out.writeInt(static_cast<int>(tempoEvents.size()));
+        for (const auto& event : tempoEvents)
+        {
+            out.writeDouble(event.beat);
+            out.writeDouble(event.bpm);
+        }
+
+        out.writeInt(static_cast<int>(track.getBuiltInInstrumentMode()));
+        out.writeString(track.getSamplerSamplePath());
+        out.writeInt(static_cast<int>(track.getMidiOverflowPolicy()));
+        writePluginSlot(out, track, Track::instrumentSlotIndex);
+        for (int slot = 0; slot < track.getPluginSlotCount(); ++slot)
+            writePluginSlot(out, track, slot);
+
+        out.writeInt(static_cast<int>(trackClips.size()));
+        for (const auto* clip : trackClips)
+            writeClip(out, *clip);
+
+        return PluginStateBlob::hashBytes(out.getData(), out.getDataSize());
+    }
+
+    bool TrackRenderCache::setCurrentKey(const Track* track, const juce::String& key, double nowMs)
+    {
+        auto& state = states[track];
+        if (state.key == key)
+            return false;
+
+        const bool wasActive = renders.count(state.key) > 0;
+        state.key = key;
+        state.keySinceMs = nowMs;
+        return wasActive || renders.count(key) > 0;
+    }
+
+    juce::String TrackRenderCache::getCurrentKey(const Track* track) const
+    {
+        const auto it = states.find(track);
+        return it != states.end() ? it->second.key : juce::String();
+    }
+
+    const TrackRenderCache::Entry* TrackRenderCache::getActiveEntry(const Track* track) const
+    {
+        const auto state = states.find(track);
+        if (state == states.end() || state->second.key.isEmpty())
+            return nullptr;
+        const auto render = renders.find(state->second.key);
+        return render != renders.end() ? &render->second : nullptr;
+    }
+
+    bool TrackRenderCache::needsRender(const Track* track, double nowMs) const
+    {
+        const auto it = states.find(track);
+        if (it == states.end())
+            return false;
+        const auto& state = it->second;
+        return state.key.isNotEmpty()
+            && nowMs - state.keySinceMs >= settleMs
+            && state.renderingKey.isEmpty()
+            && state.failedKey != state.key
+            && renders.count(state.key) == 0;
+    }
+
+    void TrackRenderCache::renderStarted(const Track* track, const juce::String& key)
+    {
+        states[track].renderingKey = key;
+    }
+
+    bool TrackRenderCache::renderFinished(const Track* track, const Entry* rendered, const juce::String& key)
+    {
+        auto& state = states[track];
+        if (state.renderingKey == key)
+            state.renderingKey.clear();
+
+        // A failure for a key the track has since left is not held against it.
+        if (rendered == nullptr)
+        {
+            if (state.key == key)
+                state.failedKey = key;
+            return false;
+        }
+
+        renders[rendered->key] = *rendered;
+        renderOrder.erase(std::remove(renderOrder.begin(), renderOrder.end(), rendered->key), renderOrder.end());
+        renderOrder.push_back(rendered->key);
+        evictOldRenders();
+        return state.key == rendered->key;
+    }
+
+    void TrackRenderCache::retainTracks(const juce::OwnedArray<Track>& liveTracks)
+    {
+        for (auto it = states.begin(); it != states.end();)
+        {
+            if (liveTracks.contains(it->first))
+                ++it;
+            else
+                it = states.erase(it);
+        }
+    }
+
+    void TrackRenderCache::clear()
+    {
+        for (const auto& render : renders)
+            render.second.file.deleteFile();
+        renders.clear();
+        renderOrder.clear();
+        for (auto& state : states)
+        {
+            state.second.keySinceMs = 0.0;
+            state.second.failedKey.clear();
+        }
+    }
+
+    int TrackRenderCache::getNumActiveTracks() const
+    {
+        int active = 0;
+        for (const auto& state : states)
+            if (renders.count(state.second.key) > 0)
+                ++active;
+        return active;
+    }
+
+    void TrackRenderCache::evictOldRenders()
+    {
+        // Oldest first, but never a render some track is playing from.
+        for (size_t index = 0; index < renderOrder.size() && static_cast<int>(renders.size()) > maxStoredRenders;)
+        {
+            const auto key = renderOrder[index];
+            const bool inUse = std::any_of(states.begin(), states.end(), [&key](const auto& state) { return state.second.key == key; });
+            if (inUse)
+            {
+                ++index;
+                continue;
+            }
+
+            const auto render = renders.find(key);
+            if (render != renders.end())
+            {
+                render->second.file.deleteFile();
+                renders.erase(render);
+            }
+            renderOrder.erase(renderOrder.begin() + static_cast<std::ptrdiff_t>(index));
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <vector>
+
+#include "TempoMap.h"
+#include "TimelineModel.h"
+#include "Track.h"
+
+namespace sampledex
+{
+    // Smart freeze. Keeps audio of what each track's instrument and insert plugins
+    // produce, rendered offline and keyed by a hash of everything that audio depends on:
+    // the track's clips, its plugins (identity, state revision, bypass), built-in
+    // instrument, the tempo map and the sample rate. Plugin states enter the key by their
+    // instance and change count, so keying never serialises a plugin. While a track's key
+    // still matches a render, the device callback streams that file instead of running
+    // the plugins. Built-in effects, EQ, fader, pan, sends and their automation stay
+    // live, so mixing never invalidates a cache. Renders are kept by key, so undoing a
+    // clip edit finds its render again. Message thread only.
+    class TrackRenderCache final
+    {
+    public:
+        struct Entry
+        {
+            juce::String key;
+            juce::File file;
+            double startBeat = 0.0;
+            double lengthBeats = 0.0;
+            double sampleRate = 44100.0;
+        };
+
+        // A key has to hold this long before it is worth rendering.
+        static constexpr double settleMs = 2000.0;
+        static constexpr int maxStoredRenders = 64;
+
+        // Renders are written here; files left by earlier sessions are removed.
+        void setDirectory(const juce::File& newDirectory);
+        juce::File getFileForKey(const juce::String& key) const;
+
+        // True when a cache would save work and its key can be trusted: the track has a
+        // plugin to skip and every plugin reports its own changes.
+        static bool canCacheTrack(const Track& track);
+
+        // trackClips are the clips on the track, in arrangement order.
+        static juce::String computeKey(const Track& track,
+                                       const std::vector<const Clip*>& trackClips,
+                                       const std::vector<TempoEvent>& tempoEvents,
+                                       double fallbackBpm,
+                                       int globalTransposeSemitones,
+                                       double sampleRate);
+
+        // Records the track's key as of now (empty = cannot be cached). Returns true when
+        // the render the track was playing from changed, so the snapshot must be rebuilt.
+        bool setCurrentKey(const Track* track, const juce::String& key, double nowMs);
+        juce::String getCurrentKey(const Track* track) const;
+
+        // The render matching the track's current key, or nullptr.
+        const Entry* getActiveEntry(const Track* track) const;
+
+        // The key has settled, has no render yet and none is running or has failed.
+        bool needsRender(const Track* track, double nowMs) const;
+        void renderStarted(const Track* track, const juce::String& key);
+        // Returns true when the render became the track's active entry.
+        bool renderFinished(const Track* track, const Entry* rendered, const juce::String& key);
+
+        // Drops state for tracks that no longer exist.
+        void retainTracks(const juce::OwnedArray<Track>& liveTracks);
+        // Forgets every render and deletes its file.
+        void clear();
+
+        int getNumActiveTracks() const;
+
+    private:
+        struct TrackState
+        {
+            juce::String key;
+            double keySinceMs = 0.0;
+            juce::String renderingKey;
+            juce::String failedKey;
+        };
+
+        void evictOldRenders();
+
+        juce::File directory;
+        std::map<const Track*, TrackState> states;
+        std::map<juce::String, Entry> renders;
+        std::vector<juce::String> renderOrder; // oldest first
+    };
+}
@@ -1,8 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <array>
 #include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "TempoMap.h"
 
 namespace sampledex
 {
@@ -180,6 +185,7 @@ namespace sampledex
             BlockRange block;
             block.startBeat = currentBeatRt.load(std::memory_order_relaxed);
             block.startSample = currentSampleRt.load(std::memory_order_relaxed);
+            publishPositionSnapshot(block.startBeat, block.startSample);
 
             if (!isPlayingRt.load(std::memory_order_relaxed) || numSamples <= 0)
             {
@@ -241,6 +247,7 @@ namespace sampledex
             BlockRange block;
             block.startBeat = currentBeatRt.load(std::memory_order_relaxed);
             block.startSample = currentSampleRt.load(std::memory_order_relaxed);
+            publishPositionSnapshot(block.startBeat, block.startSample);
 
             if (!isPlayingRt.load(std::memory_order_relaxed) || numSamples <= 0)
             {
@@ -284,6 +291,81 @@ namespace sampledex
             return block;
         }
 
+        // Advances by numSamples following the tempo map, so a tempo change inside the block
+        // takes effect at its exact sample and the end beat is the integral of the map over
+        // the block rather than the block-start tempo times its length. The reported tempo
+        // (and getBeatsPerSample) is the one in force at the block start.
+        BlockRange advanceWithTempoMap(int numSamples, const TempoMapIndex& tempoMap)
+        {
+            BlockRange block;
+            block.startBeat = currentBeatRt.load(std::memory_order_relaxed);
+            block.startSample = currentSampleRt.load(std::memory_order_relaxed);
+
+            const double clampedTempo = juce::jmax(1.0, tempoMap.getTempoAtBeat(block.startBeat));
+            if (std::abs(tempoRt.load(std::memory_order_relaxed) - clampedTempo) > 1.0e-9)
+            {
+                const auto localSampleRate = sampleRateRt.load(std::memory_order_relaxed);
+                const auto localSamplesPerBeat = (60.0 / clampedTempo) * localSampleRate;
+                tempoRt.store(clampedTempo, std::memory_order_relaxed);
+                samplesPerBeatRt.store(localSamplesPerBeat, std::memory_order_relaxed);
+                beatsPerSampleRt.store(localSamplesPerBeat > 0.0 ? (1.0 / localSamplesPerBeat) : 0.0,
+                                       std::memory_order_relaxed);
+            }
+
+            publishPositionSnapshot(block.startBeat, block.startSample);
+
+            const auto localSampleRate = sampleRateRt.load(std::memory_order_relaxed);
+            if (!isPlayingRt.load(std::memory_order_relaxed) || numSamples <= 0 || localSampleRate <= 0.0)
+            {
+                block.endBeat = block.startBeat;
+                block.endSample = block.startSample;
+                return block;
+            }
+
+            const double startSeconds = tempoMap.secondsAtBeat(block.startBeat);
+            const double endSeconds = startSeconds + static_cast<double>(numSamples) / localSampleRate;
+            auto nextBeat = tempoMap.beatAtSeconds(endSeconds);
+
+            const bool looping = isLoopingRt.load(std::memory_order_relaxed);
+            const double loopStart = loopStartBeatRt.load(std::memory_order_relaxed);
+            const double loopEnd = loopEndBeatRt.load(std::memory_order_relaxed);
+            if (looping && loopEnd > loopStart)
+            {
+                if (nextBeat >= loopEnd && block.startBeat < loopEnd)
+                {
+                    // Time left over past the loop end continues from the loop start.
+                    const double loopStartSeconds = tempoMap.secondsAtBeat(loopStart);
+                    const double loopSeconds = tempoMap.secondsAtBeat(loopEnd) - loopStartSeconds;
+                    if (loopSeconds > 0.0)
+                    {
+                        const double overshoot = std::fmod(endSeconds - tempoMap.secondsAtBeat(loopEnd), loopSeconds);
+                        nextBeat = tempoMap.beatAtSeconds(loopStartSeconds + overshoot);
+                        block.wrapped = true;
+                    }
+                }
+
+                const auto loopLength = loopEnd - loopStart;
+                while (nextBeat >= loopEnd)
+                {
+                    nextBeat -= loopLength;
+                    block.wrapped = true;
+                }
+                while (nextBeat < loopStart)
+                {
+                    nextBeat += loopLength;
+                    block.wrapped = true;
+                }
+            }
+
+            const auto nextSample = block.startSample + static_cast<int64_t>(numSamples);
+            currentSampleRt.store(nextSample, std::memory_order_relaxed);
+            currentBeatRt.store(nextBeat, std::memory_order_relaxed);
+
+            block.endBeat = nextBeat;
+            block.endSample = nextSample;
+            return block;
+        }
+
         void setLoop(bool enable, double startBeat, double endBeat)
         {
             juce::ScopedLock lock(stateLock);
@@ -330,44 +412,180 @@ namespace sampledex
             return juce::jmax(0, juce::roundToInt(lookaheadBeats * localSamplesPerBeat));
         }
 
+        // Wait-free. Returns the position published at the start of the current block
+        // (or by the last transport edit while the device is stopped).
         juce::AudioPlayHead::CurrentPositionInfo getCurrentPositionInfo() const
         {
-            juce::ScopedLock lock(stateLock);
-            refreshFromRtLocked();
-            return positionInfo;
+            const auto snapshot = readPositionSnapshot();
+
+            juce::AudioPlayHead::CurrentPositionInfo info;
+            info.resetToDefault();
+            info.bpm = snapshot.bpm;
+            info.timeSigNumerator = snapshot.timeSigNumerator;
+            info.timeSigDenominator = snapshot.timeSigDenominator;
+            info.timeInSamples = snapshot.timeInSamples;
+            info.timeInSeconds = snapshot.sampleRate > 0.0
+                ? static_cast<double>(snapshot.timeInSamples) / snapshot.sampleRate
+                : 0.0;
+            info.ppqPosition = snapshot.ppqPosition;
+            info.ppqPositionOfLastBarStart = getLastBarStart(snapshot);
+            info.isPlaying = snapshot.isPlaying;
+            info.isRecording = snapshot.isRecording;
+            info.ppqLoopStart = snapshot.ppqLoopStart;
+            info.ppqLoopEnd = snapshot.ppqLoopEnd;
+            info.isLooping = snapshot.isLooping;
+            return info;
         }
 
+        // Called by every hosted plugin, possibly from several graph workers at once.
         juce::Optional<juce::AudioPlayHead::PositionInfo> getPosition() const override
         {
-            juce::ScopedLock lock(stateLock);
-            refreshFromRtLocked();
+            const auto snapshot = readPositionSnapshot();
 
             juce::AudioPlayHead::PositionInfo info;
-            info.setTimeInSamples(positionInfo.timeInSamples);
-            info.setTimeInSeconds(positionInfo.timeInSeconds);
-            info.setPpqPosition(positionInfo.ppqPosition);
-            info.setPpqPositionOfLastBarStart(positionInfo.ppqPositionOfLastBarStart);
-            info.setEditOriginTime(positionInfo.editOriginTime);
-            info.setBpm(positionInfo.bpm);
+            info.setTimeInSamples(snapshot.timeInSamples);
+            info.setTimeInSeconds(snapshot.sampleRate > 0.0
+                                      ? static_cast<double>(snapshot.timeInSamples) / snapshot.sampleRate
+                                      : 0.0);
+            info.setPpqPosition(snapshot.ppqPosition);
+            info.setPpqPositionOfLastBarStart(getLastBarStart(snapshot));
+            info.setEditOriginTime(snapshot.editOriginTime);
+            info.setBpm(snapshot.bpm);
             info.setTimeSignature(juce::AudioPlayHead::TimeSignature{
-                positionInfo.timeSigNumerator,
-                positionInfo.timeSigDenominator
+                snapshot.timeSigNumerator,
+                snapshot.timeSigDenominator
             });
-            if (positionInfo.isLooping && positionInfo.ppqLoopEnd > positionInfo.ppqLoopStart)
+            if (snapshot.isLooping && snapshot.ppqLoopEnd > snapshot.ppqLoopStart)
             {
                 info.setLoopPoints(juce::AudioPlayHead::LoopPoints{
-                    positionInfo.ppqLoopStart,
-                    positionInfo.ppqLoopEnd
+                    snapshot.ppqLoopStart,
+                    snapshot.ppqLoopEnd
                 });
             }
-            info.setFrameRate(positionInfo.frameRate);
-            info.setIsPlaying(positionInfo.isPlaying);
-            info.setIsRecording(positionInfo.isRecording);
-            info.setIsLooping(positionInfo.isLooping);
+            info.setFrameRate(static_cast<juce::AudioPlayHead::FrameRateType>(snapshot.frameRateType));
+            info.setIsPlaying(snapshot.isPlaying);
+            info.setIsRecording(snapshot.isRecording);
+            info.setIsLooping(snapshot.isLooping);
             return info;
         }
 
     private:
+        struct PositionSnapshot
+        {
+            int64_t timeInSamples = 0;
+            double ppqPosition = 0.0;
+            double bpm = 120.0;
+            double sampleRate = 44100.0;
+            double ppqLoopStart = 0.0;
+            double ppqLoopEnd = 8.0;
+            double editOriginTime = 0.0;
+            int timeSigNumerator = 4;
+            int timeSigDenominator = 4;
+            int frameRateType = static_cast<int>(juce::AudioPlayHead::fpsUnknown);
+            bool isPlaying = false;
+            bool isRecording = false;
+            bool isLooping = false;
+        };
+
+        static_assert(std::is_trivially_copyable_v<PositionSnapshot>);
+        static constexpr size_t positionSnapshotWords = (sizeof(PositionSnapshot) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+        using PositionSnapshotWords = std::array<std::uint64_t, positionSnapshotWords>;
+
+        // One half of the double-buffered seqlock. The payload is stored as relaxed
+        // atomic words so torn reads are detected rather than being a data race.
+        struct PositionSlot
+        {
+            std::atomic<std::uint32_t> sequence { 0 };
+            std::array<std::atomic<std::uint64_t>, positionSnapshotWords> words {};
+        };
+
+        static double getLastBarStart(const PositionSnapshot& snapshot) noexcept
+        {
+            const auto beatsPerBar = static_cast<double>(snapshot.timeSigNumerator)
+                                   * (4.0 / static_cast<double>(juce::jmax(1, snapshot.timeSigDenominator)));
+            return beatsPerBar > 0.0 ? std::floor(snapshot.ppqPosition / beatsPerBar) * beatsPerBar : 0.0;
+        }
+
+        // Writes into the slot readers are not using, then flips the published index.
+        // Writers never wait: if the audio thread and the message thread collide, the
+        // loser skips and the next block republishes from the same atomics.
+        void publishPositionSnapshot(double beat, int64_t samplePosition) noexcept
+        {
+            if (positionWriterActive.exchange(true, std::memory_order_acquire))
+                return;
+
+            PositionSnapshot snapshot;
+            snapshot.timeInSamples = samplePosition;
+            snapshot.ppqPosition = beat;
+            snapshot.bpm = tempoRt.load(std::memory_order_relaxed);
+            snapshot.sampleRate = sampleRateRt.load(std::memory_order_relaxed);
+            snapshot.ppqLoopStart = loopStartBeatRt.load(std::memory_order_relaxed);
+            snapshot.ppqLoopEnd = loopEndBeatRt.load(std::memory_order_relaxed);
+            snapshot.timeSigNumerator = timeSigNumeratorRt.load(std::memory_order_relaxed);
+            snapshot.timeSigDenominator = timeSigDenominatorRt.load(std::memory_order_relaxed);
+            snapshot.editOriginTime = editOriginTimeRt.load(std::memory_order_relaxed);
+            snapshot.frameRateType = frameRateTypeRt.load(std::memory_order_relaxed);
+            snapshot.isPlaying = isPlayingRt.load(std::memory_order_relaxed);
+            snapshot.isRecording = isRecordingRt.load(std::memory_order_relaxed);
+            snapshot.isLooping = isLoopingRt.load(std::memory_order_relaxed);
+
+            PositionSnapshotWords words {};
+            std::memcpy(words.data(), &snapshot, sizeof(snapshot));
+
+            const int target = 1 - publishedPositionSlot.load(std::memory_order_relaxed);
+            auto& slot = positionSlots[static_cast<size_t>(target)];
+            const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+            slot.sequence.store(sequence + 1u, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < positionSnapshotWords; ++i)
+                slot.words[i].store(words[i], std::memory_order_relaxed);
+            slot.sequence.store(sequence + 2u, std::memory_order_release);
+            publishedPositionSlot.store(target, std::memory_order_release);
+
+            positionWriterActive.store(false, std::memory_order_release);
+        }
+
+        PositionSnapshot readPositionSnapshot() const noexcept
+        {
+            // A retry needs two publishes to land inside one read, so this almost never
+            // loops; the bound keeps it wait-free regardless.
+            for (int attempt = 0; attempt < 4; ++attempt)
+            {
+                const int index = publishedPositionSlot.load(std::memory_order_acquire);
+                const auto& slot = positionSlots[static_cast<size_t>(index)];
+                const auto before = slot.sequence.load(std::memory_order_acquire);
+                if ((before & 1u) != 0)
+                    continue;
+
+                PositionSnapshotWords words {};
+                for (size_t i = 0; i < positionSnapshotWords; ++i)
+                    words[i] = slot.words[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) != before)
+                    continue;
+
+                PositionSnapshot snapshot;
+                std::memcpy(static_cast<void*>(&snapshot), words.data(), sizeof(snapshot));
+                return snapshot;
+            }
+
+            PositionSnapshot fallback;
+            fallback.timeInSamples = currentSampleRt.load(std::memory_order_relaxed);
+            fallback.ppqPosition = currentBeatRt.load(std::memory_order_relaxed);
+            fallback.bpm = tempoRt.load(std::memory_order_relaxed);
+            fallback.sampleRate = sampleRateRt.load(std::memory_order_relaxed);
+            fallback.ppqLoopStart = loopStartBeatRt.load(std::memory_order_relaxed);
+            fallback.ppqLoopEnd = loopEndBeatRt.load(std::memory_order_relaxed);
+            fallback.timeSigNumerator = timeSigNumeratorRt.load(std::memory_order_relaxed);
+            fallback.timeSigDenominator = timeSigDenominatorRt.load(std::memory_order_relaxed);
+            fallback.editOriginTime = editOriginTimeRt.load(std::memory_order_relaxed);
+            fallback.frameRateType = frameRateTypeRt.load(std::memory_order_relaxed);
+            fallback.isPlaying = isPlayingRt.load(std::memory_order_relaxed);
+            fallback.isRecording = isRecordingRt.load(std::memory_order_relaxed);
+            fallback.isLooping = isLoopingRt.load(std::memory_order_relaxed);
+            return fallback;
+        }
+
         void updateSampleFromBeatLocked()
         {
             const auto samplePos = positionInfo.ppqPosition * samplesPerBeat;
@@ -400,6 +618,11 @@ namespace sampledex
             loopStartBeatRt.store(positionInfo.ppqLoopStart, std::memory_order_relaxed);
             loopEndBeatRt.store(positionInfo.ppqLoopEnd, std::memory_order_relaxed);
             sampleRateRt.store(sampleRate, std::memory_order_relaxed);
+            timeSigNumeratorRt.store(positionInfo.timeSigNumerator, std::memory_order_relaxed);
+            timeSigDenominatorRt.store(positionInfo.timeSigDenominator, std::memory_order_relaxed);
+            editOriginTimeRt.store(positionInfo.editOriginTime, std::memory_order_relaxed);
+            frameRateTypeRt.store(static_cast<int>(positionInfo.frameRate), std::memory_order_relaxed);
+            publishPositionSnapshot(positionInfo.ppqPosition, positionInfo.timeInSamples);
         }
 
         void refreshFromRtLocked() const
@@ -435,5 +658,12 @@ namespace sampledex
         std::atomic<double> loopStartBeatRt { 0.0 };
         std::atomic<double> loopEndBeatRt { 8.0 };
         std::atomic<int> syncSourceRt { static_cast<int>(SyncSource::Internal) };
+        std::atomic<int> timeSigNumeratorRt { 4 };
+        std::atomic<int> timeSigDenominatorRt { 4 };
+        std::atomic<double> editOriginTimeRt { 0.0 };
+        std::atomic<int> frameRateTypeRt { static_cast<int>(juce::AudioPlayHead::fpsUnknown) };
+        std::array<PositionSlot, 2> positionSlots;
+        std::atomic<int> publishedPositionSlot { 0 };
+        std::atomic<bool> positionWriterActive { false };
     };
 }
@@ -25,7 +25,7 @@ namespace sampledex
             int hostingPolicy = static_cast<int>(Track::PluginHostingPolicy::SafeInProcess);
             juce::PluginDescription description;
             bool hasDescription = false;
-            juce::String encodedState;
+            PluginStateBlob state;
         };
 
         struct TrackState
@@ -58,6 +58,16 @@ namespace sampledex
             std::vector<PluginSlotState> pluginSlots;
         };
 
+        // States above this size are stored as binary files next to the project instead of
+        // inline base64, named by content hash so an unchanged state is never rewritten.
+        static constexpr juce::int64 externalPluginStateThresholdBytes = 256 * 1024;
+
+        static juce::File getPluginStateChunkDirectory(const juce::File& projectFile)
+        {
+            return projectFile.getSiblingFile(projectFile.getFileNameWithoutExtension() + "_data")
+                              .getChildFile("plugin-states");
+        }
+
         struct ProjectState
         {
             double bpm = 120.0;
@@ -120,6 +130,8 @@ namespace sampledex
                 t->setAttribute("denominator", point.denominator);
             }
 
+            const auto chunkDir = getPluginStateChunkDirectory(file);
+            juce::StringArray referencedChunks;
             auto* tracksXml = root.createNewChildElement("TRACKS");
             for (const auto& track : project.tracks)
             {
@@ -167,11 +179,9 @@ namespace sampledex
                         }
                     }
 
-                    if (slot.encodedState.isNotEmpty())
-                    {
-                        auto* stateXml = slotXml->createNewChildElement("STATE");
-                        stateXml->addTextElement(slot.encodedState);
-                    }
+                    if (!slot.state.isEmpty()
+                        && !writePluginSlotState(*slotXml, slot.state, file, chunkDir, referencedChunks, errorMessage))
+                        return false;
                 }
             }
 
@@ -333,6 +343,7 @@ namespace sampledex
                 return false;
             }
 
+            removeUnreferencedPluginStateChunks(chunkDir, referencedChunks);
             errorMessage.clear();
             return true;
         }
@@ -448,7 +459,7 @@ namespace sampledex
                                 slot.hasDescription = slot.description.loadFromXml(*legacyDesc);
 
                             if (auto* stateXml = slotXml->getChildByName("STATE"))
-                                slot.encodedState = stateXml->getAllSubText().trim();
+                                slot.state = readPluginSlotState(*stateXml, file.getParentDirectory());
 
                             track.pluginSlots.push_back(std::move(slot));
                         }
@@ -463,7 +474,7 @@ namespace sampledex
                         slot.description.pluginFormatName = legacyPlugin->getStringAttribute("format");
                         slot.description.name = slot.description.fileOrIdentifier;
                         slot.hasDescription = slot.description.fileOrIdentifier.isNotEmpty();
-                        slot.encodedState = legacyPlugin->getStringAttribute("state");
+                        slot.state.encoded = legacyPlugin->getStringAttribute("state");
                         track.pluginSlots.push_back(std::move(slot));
                     }
 
@@ -696,5 +707,99 @@ namespace sampledex
             errorMessage.clear();
             return true;
         }
+
+    private:
+        static bool writePluginSlotState(juce::XmlElement& slotXml,
+                                         const PluginStateBlob& state,
+                                         const juce::File& projectFile,
+                                         const juce::File& chunkDir,
+                                         juce::StringArray& referencedChunks,
+                                         juce::String& errorMessage)
+        {
+            auto* stateXml = slotXml.createNewChildElement("STATE");
+            const bool isExternal = state.sizeBytes > externalPluginStateThresholdBytes && state.hash.isNotEmpty();
+            if (!isExternal)
+            {
+                stateXml->addTextElement(state.toBase64());
+                return true;
+            }
+
+            const auto chunkName = state.hash + "-" + juce::String(state.sizeBytes) + ".bin";
+            const auto chunkFile = chunkDir.getChildFile(chunkName);
+            referencedChunks.addIfNotAlreadyThere(chunkName);
+
+            // Content-addressed: a file with this name and size already holds these bytes.
+            if (!chunkFile.existsAsFile() || chunkFile.getSize() != state.sizeBytes)
+            {
+                if (!chunkDir.isDirectory() && !chunkDir.createDirectory())
+                {
+                    errorMessage = "Unable to create plugin state folder:\n" + chunkDir.getFullPathName();
+                    return false;
+                }
+
+                juce::TemporaryFile temp(chunkFile);
+                bool written = false;
+                if (state.data != nullptr)
+                    written = temp.getFile().replaceWithData(state.data->getData(), state.data->getSize());
+                else if (state.chunkFile.existsAsFile())
+                    written = state.chunkFile.copyFileTo(temp.getFile());
+                else
+                {
+                    juce::MemoryBlock block;
+                    written = state.read(block) && temp.getFile().replaceWithData(block.getData(), block.getSize());
+                }
+
+                if (!written || !temp.overwriteTargetFileWithTemporary())
+                {
+                    errorMessage = "Unable to write plugin state:\n" + chunkFile.getFullPathName();
+                    return false;
+                }
+            }
+
+            stateXml->setAttribute("chunkRelative", chunkFile.getRelativePathFrom(projectFile.getParentDirectory()));
+            stateXml->setAttribute("chunkAbsolute", chunkFile.getFullPathName());
+            stateXml->setAttribute("bytes", juce::String(state.sizeBytes));
+            stateXml->setAttribute("hash", state.hash);
+            return true;
+        }
+
+        // Chunks are only referenced, not read, here; the restore pipeline loads them on
+        // a worker when the plugin is instantiated.
+        static PluginStateBlob readPluginSlotState(const juce::XmlElement& stateXml, const juce::File& projectDir)
+        {
+            PluginStateBlob state;
+            const auto relativePath = stateXml.getStringAttribute("chunkRelative");
+            const auto absolutePath = stateXml.getStringAttribute("chunkAbsolute");
+            if (relativePath.isEmpty() && absolutePath.isEmpty())
+            {
+                state.encoded = stateXml.getAllSubText().trim();
+                return state;
+            }
+
+            state.chunkFile = relativePath.isNotEmpty() ? projectDir.getChildFile(relativePath) : juce::File();
+            if (!state.chunkFile.existsAsFile() && juce::File::isAbsolutePath(absolutePath))
+                state.chunkFile = juce::File(absolutePath);
+            state.sizeBytes = stateXml.getStringAttribute("bytes").getLargeIntValue();
+            state.hash = stateXml.getStringAttribute("hash");
+            return state;
+        }
+
+        static void removeUnreferencedPluginStateChunks(const juce::File& chunkDir, const juce::StringArray& referencedChunks)
+        {
+            if (!chunkDir.isDirectory())
+                return;
+
+            for (const auto& entry : juce::RangedDirectoryIterator(chunkDir, false, "*.bin", juce::File::findFiles))
+                if (!referencedChunks.contains(entry.getFile().getFileName()))
+                    entry.getFile().deleteFile();
+
+            if (referencedChunks.isEmpty() && chunkDir.getNumberOfChildFiles(juce::File::findFilesAndDirectories) == 0)
+            {
+                chunkDir.deleteFile();
+                const auto dataDir = chunkDir.getParentDirectory();
+                if (dataDir.getNumberOfChildFiles(juce::File::findFilesAndDirectories) == 0)
+                    dataDir.deleteFile();
+            }
+        }
     };
 }
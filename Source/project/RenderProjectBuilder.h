@@ -0,0 +1,219 @@
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+#include "IsolatedRenderEngine.h"
+#include "ProjectSerializer.h"
+#include "TempoMap.h"
+#include "TimelineModel.h"
+#include "Track.h"
+
+namespace sampledex
+{
+    // Turns a session into the IsolatedRenderProject a render takes. The app's export
+    // (from its live tracks) and the headless render (from a project file) both go
+    // through here, so the two cannot drift apart in what they render.
+    class RenderProjectBuilder
+    {
+    public:
+        // Master and aux settings. A project file does not store them, so the app starts
+        // from these and a headless render uses them as they are.
+        static constexpr float defaultMasterGain = 0.9f;
+        static constexpr bool defaultSoftClipEnabled = true;
+        static constexpr bool defaultLimiterEnabled = true;
+        static constexpr bool defaultOutputDcHighPassEnabled = true;
+        static constexpr bool defaultMonitorSafeMode = true;
+        static constexpr bool defaultAuxFxEnabled = true;
+        static constexpr float defaultAuxReturnGain = 0.5f;
+
+        static juce::Reverb::Parameters getDefaultAuxReverbParameters()
+        {
+            juce::Reverb::Parameters parameters;
+            parameters.roomSize = 0.6f;
+            parameters.damping = 0.5f;
+            parameters.wetLevel = 1.0f;
+            parameters.dryLevel = 0.0f;
+            return parameters;
+        }
+
+        struct MixSettings
+        {
+            float masterGain = defaultMasterGain;
+            bool softClipEnabled = defaultSoftClipEnabled;
+            bool limiterEnabled = defaultLimiterEnabled;
+            bool outputDcHighPassEnabled = defaultOutputDcHighPassEnabled;
+            bool monitorSafeMode = defaultMonitorSafeMode;
+            bool auxFxEnabled = defaultAuxFxEnabled;
+            float auxReturnGain = defaultAuxReturnGain;
+            juce::Reverb::Parameters auxReverbParameters = getDefaultAuxReverbParameters();
+        };
+
+        // Clamps and sorts the tempo changes and anchors the first at beat 0, as the
+        // session keeps them before building its tempo map.
+        static void normaliseTempoEvents(std::vector<TempoEvent>& events, double bpm)
+        {
+            for (auto& event : events)
+            {
+                event.beat = juce::jmax(0.0, event.beat);
+                event.bpm = juce::jmax(1.0, event.bpm);
+            }
+
+            std::sort(events.begin(), events.end(),
+                      [](const TempoEvent& a, const TempoEvent& b)
+                      {
+                          if (std::abs(a.beat - b.beat) > 1.0e-9)
+                              return a.beat < b.beat;
+                          return a.bpm < b.bpm;
+                      });
+
+            if (events.empty())
+                events.push_back({ 0.0, bpm });
+            else if (events.front().beat > 1.0e-6)
+                events.insert(events.begin(), TempoEvent { 0.0, bpm });
+        }
+
+        // Sets the tempo at beat 0 to bpm, the project tempo, adding the event if needed.
+        static void setBaseTempo(std::vector<TempoEvent>& events, double bpm)
+        {
+            for (auto& event : events)
+            {
+                if (std::abs(event.beat) <= 1.0e-6)
+                {
+                    event.bpm = bpm;
+                    return;
+                }
+            }
+            events.push_back({ 0.0, bpm });
+        }
+
+        // Sets a track up from its saved state: mixer, routing, EQ, built-in instrument and
+        // effects, plugin hosting policies and frozen playback. Live input (arm,
+        // monitoring) and the plugins themselves are left to the caller.
+        static void applyTrackState(Track& track,
+                                    const ProjectSerializer::TrackState& state,
+                                    int trackNumber,
+                                    double sampleRate,
+                                    int blockSize,
+                                    juce::StringArray& warnings)
+        {
+            track.setVolume(state.volume);
+            track.setPan(state.pan);
+            track.setSendLevel(state.sendLevel);
+            track.setSendTapMode(static_cast<Track::SendTapMode>(juce::jlimit(0, 2, state.sendTapMode)));
+            track.setSendTargetBus(state.sendTargetBus);
+            track.setMute(state.mute);
+            track.setSolo(state.solo);
+            track.setChannelType(static_cast<Track::ChannelType>(juce::jlimit(0, 3, state.channelType)));
+            track.setOutputTargetType(static_cast<Track::OutputTargetType>(juce::jlimit(0, 1, state.outputTargetType)));
+            track.setOutputTargetBus(state.outputTargetBus);
+            track.setEqEnabled(state.eqEnabled);
+            track.setEqBandGains(state.eqLowGainDb, state.eqMidGainDb, state.eqHighGainDb);
+            track.setBuiltInEffectsMask(state.builtInFxMask);
+            track.prepareToPlay(sampleRate, juce::jmax(128, blockSize));
+
+            switch (track.getChannelType() == Track::ChannelType::Audio
+                        ? Track::BuiltInInstrument::None
+                        : static_cast<Track::BuiltInInstrument>(juce::jlimit(0, 2, state.builtInInstrumentMode)))
+            {
+                case Track::BuiltInInstrument::None:
+                    track.disableBuiltInInstrument();
+                    break;
+                case Track::BuiltInInstrument::Sampler:
+                {
+                    juce::String samplerError;
+                    if (state.samplerSamplePath.isNotEmpty()
+                        && !track.loadSamplerSoundFromFile(juce::File(state.samplerSamplePath), samplerError))
+                    {
+                        warnings.add("Track " + juce::String(trackNumber)
+                                     + " sampler load failed: "
+                                     + (samplerError.isNotEmpty() ? samplerError : juce::String("Unknown error")));
+                    }
+                    break;
+                }
+                case Track::BuiltInInstrument::BasicSynth:
+                default:
+                    track.useBuiltInSynthInstrument();
+                    break;
+            }
+
+            for (const auto& slot : state.pluginSlots)
+                if (slot.hasDescription)
+                    track.setPluginHostingPolicyForSlot(slot.slotIndex,
+                                                        static_cast<Track::PluginHostingPolicy>(juce::jlimit(0, 1, slot.hostingPolicy)));
+
+            track.setFrozenRenderPath(state.frozenRenderPath);
+            const bool validFrozenClip = state.frozenPlaybackOnly
+                                      && state.frozenRenderPath.isNotEmpty()
+                                      && juce::File(state.frozenRenderPath).existsAsFile();
+            track.setFrozenPlaybackOnly(validFrozenClip);
+            if (state.frozenPlaybackOnly && !validFrozenClip)
+            {
+                warnings.add("Track " + juce::String(trackNumber)
+                             + " frozen state disabled because frozen render file is missing.");
+            }
+        }
+
+        // Fills in everything but the tracks, which the caller has already put in
+        // project.tracks. renderIndexForTrack maps a session track index to its index
+        // there (-1 = not rendered); clips and automation of tracks that are not rendered
+        // are dropped, master automation is kept. skipClip, when set, drops more clips.
+        static void setSession(IsolatedRenderProject& project,
+                               const std::vector<int>& renderIndexForTrack,
+                               const std::vector<Clip>& arrangement,
+                               const std::vector<AutomationLane>& automationLanes,
+                               const TempoMapIndex& tempoMap,
+                               double bpm,
+                               int transposeSemitones,
+                               const MixSettings& mix,
+                               const std::function<bool(const Clip&)>& skipClip = {})
+        {
+            const auto renderIndexFor = [&renderIndexForTrack](int trackIndex)
+            {
+                return juce::isPositiveAndBelow(trackIndex, static_cast<int>(renderIndexForTrack.size()))
+                    ? renderIndexForTrack[static_cast<size_t>(trackIndex)]
+                    : -1;
+            };
+
+            project.arrangement.clear();
+            project.arrangement.reserve(arrangement.size());
+            for (const auto& clip : arrangement)
+            {
+                const int renderIndex = renderIndexFor(clip.trackIndex);
+                if (renderIndex < 0 || (skipClip && skipClip(clip)))
+                    continue;
+                project.arrangement.push_back(clip);
+                project.arrangement.back().trackIndex = renderIndex;
+            }
+
+            project.automationLanes.clear();
+            for (const auto& lane : automationLanes)
+            {
+                if (lane.target == AutomationTarget::MasterOutput)
+                {
+                    project.automationLanes.push_back(lane);
+                    continue;
+                }
+
+                const int renderIndex = renderIndexFor(lane.trackIndex);
+                if (renderIndex < 0)
+                    continue;
+                project.automationLanes.push_back(lane);
+                project.automationLanes.back().trackIndex = renderIndex;
+            }
+
+            project.tempoMap = tempoMap;
+            project.fallbackBpm = juce::jmax(1.0, bpm);
+            project.globalTransposeSemitones = transposeSemitones;
+            project.masterGain = mix.masterGain;
+            project.softClipEnabled = mix.softClipEnabled;
+            project.limiterEnabled = mix.limiterEnabled;
+            project.outputDcHighPassEnabled = mix.outputDcHighPassEnabled;
+            project.monitorSafeMode = mix.monitorSafeMode;
+            project.auxFxEnabled = mix.auxFxEnabled;
+            project.auxReturnGain = mix.auxReturnGain;
+            project.auxReverbParameters = mix.auxReverbParameters;
+        }
+    };
+}
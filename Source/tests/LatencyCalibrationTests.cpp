@@ -0,0 +1,165 @@
+#include <JuceHeader.h>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+#include "LatencyCalibrator.h"
+
+using namespace sampledex;
+
+namespace
+{
+    constexpr double testSampleRate = 48000.0;
+    constexpr int testBlockSize = 256;
+
+    // The output reaches the input after delaySamples, through a one-pole low-pass (a
+    // small speaker and mic), with gain, optional polarity flip and background noise.
+    struct SyntheticLoopback
+    {
+        int delaySamples = 0;
+        float gain = 0.3f;
+        bool invert = false;
+        float noiseLevel = 0.01f;
+        float smoothing = 0.6f;
+
+        std::deque<float> line;
+        float filterState = 0.0f;
+        juce::Random random { 0x5a17 };
+
+        float process(float output)
+        {
+            line.push_back(output);
+            float delayed = 0.0f;
+            if (static_cast<int>(line.size()) > delaySamples)
+            {
+                delayed = line.front();
+                line.pop_front();
+            }
+            filterState += smoothing * (delayed - filterState);
+            const float noise = (random.nextFloat() * 2.0f - 1.0f) * noiseLevel;
+            return (invert ? -filterState : filterState) * gain + noise;
+        }
+    };
+
+    bool expectLatency(const char* name, const LatencyCalibrator::Result& result, int expected)
+    {
+        const bool passed = result.ok && std::abs(result.latencySamples - expected) <= 1;
+        std::printf("%s: %s measured %d expected %d confidence %.1f\n",
+                    passed ? "PASS" : "FAIL",
+                    name,
+                    result.latencySamples,
+                    expected,
+                    static_cast<double>(result.confidence));
+        return passed;
+    }
+
+    bool measuresOfflineCapture(int delaySamples, bool invert, float noiseLevel)
+    {
+        const auto signal = LatencyCalibrator::createTestSignal();
+        const int maxLatency = static_cast<int>(testSampleRate * LatencyCalibrator::maxLatencySeconds);
+        std::vector<float> captured(signal.size() + static_cast<size_t>(maxLatency), 0.0f);
+
+        SyntheticLoopback loopback;
+        loopback.delaySamples = delaySamples;
+        loopback.invert = invert;
+        loopback.noiseLevel = noiseLevel;
+        for (size_t i = 0; i < captured.size(); ++i)
+            captured[i] = loopback.process(i < signal.size() ? signal[i] : 0.0f);
+
+        const auto result = LatencyCalibrator::measure(signal.data(), static_cast<int>(signal.size()),
+                                                       captured.data(), static_cast<int>(captured.size()),
+                                                       maxLatency);
+        const auto name = "offline delay " + juce::String(delaySamples)
+                        + (invert ? " inverted" : "") + " noise " + juce::String(noiseLevel, 3);
+        return expectLatency(name.toRawUTF8(), result, delaySamples);
+    }
+
+    // The device path: blocks through processBlock(), the loopback running between the
+    // output of one callback and the inputs of the following ones.
+    bool measuresThroughCallbacks(int delaySamples)
+    {
+        LatencyCalibrator calibrator;
+        {
+            juce::AudioBuffer<float> unused(2, testBlockSize);
+            if (calibrator.processBlock(unused, 2, unused, 0, testBlockSize))
+            {
+                std::puts("FAIL: idle calibrator wrote output");
+                return false;
+            }
+        }
+        if (!calibrator.start(testSampleRate))
+            return false;
+
+        SyntheticLoopback loopback;
+        loopback.delaySamples = delaySamples;
+        juce::AudioBuffer<float> input(2, testBlockSize);
+        juce::AudioBuffer<float> output(2, testBlockSize);
+        input.clear();
+        std::vector<float> pendingInput(static_cast<size_t>(testBlockSize), 0.0f);
+
+        int blocks = 0;
+        while (calibrator.isRunning() && blocks++ < 10000)
+        {
+            // Input of this callback is what the loopback produced during the last one;
+            // left carries it and right is an unconnected channel.
+            for (int i = 0; i < testBlockSize; ++i)
+            {
+                input.setSample(0, i, pendingInput[static_cast<size_t>(i)]);
+                input.setSample(1, i, 0.0f);
+            }
+            if (!calibrator.processBlock(input, 2, output, 0, testBlockSize))
+                return false;
+            for (int i = 0; i < testBlockSize; ++i)
+                pendingInput[static_cast<size_t>(i)] = loopback.process(output.getSample(0, i));
+        }
+
+        if (!calibrator.isCaptureComplete())
+        {
+            std::puts("FAIL: capture did not complete");
+            return false;
+        }
+        // One block of buffering on top of the loopback's own delay.
+        const auto name = "callbacks delay " + juce::String(delaySamples);
+        return expectLatency(name.toRawUTF8(), calibrator.analyse(), delaySamples + testBlockSize);
+    }
+
+    bool rejectsSilence()
+    {
+        const auto signal = LatencyCalibrator::createTestSignal();
+        std::vector<float> captured(signal.size() + 48000, 0.0f);
+        const auto result = LatencyCalibrator::measure(signal.data(), static_cast<int>(signal.size()),
+                                                       captured.data(), static_cast<int>(captured.size()),
+                                                       48000);
+        std::printf("%s: silence rejected\n", result.ok ? "FAIL" : "PASS");
+        return !result.ok;
+    }
+
+    bool rejectsUncorrelatedNoise()
+    {
+        const auto signal = LatencyCalibrator::createTestSignal();
+        std::vector<float> captured(signal.size() + 48000, 0.0f);
+        juce::Random random(0x1234);
+        for (auto& sample : captured)
+            sample = (random.nextFloat() * 2.0f - 1.0f) * 0.1f;
+        const auto result = LatencyCalibrator::measure(signal.data(), static_cast<int>(signal.size()),
+                                                       captured.data(), static_cast<int>(captured.size()),
+                                                       48000);
+        std::printf("%s: noise rejected (confidence %.1f)\n", result.ok ? "FAIL" : "PASS",
+                    static_cast<double>(result.confidence));
+        return !result.ok;
+    }
+}
+
+int main()
+{
+    bool passed = true;
+    passed = measuresOfflineCapture(0, false, 0.0f) && passed;
+    passed = measuresOfflineCapture(1234, false, 0.01f) && passed;
+    passed = measuresOfflineCapture(377, true, 0.05f) && passed;
+    passed = measuresOfflineCapture(20000, false, 0.001f) && passed;
+    passed = measuresThroughCallbacks(97) && passed;
+    passed = measuresThroughCallbacks(2048 + 13) && passed;
+    passed = rejectsSilence() && passed;
+    passed = rejectsUncorrelatedNoise() && passed;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,433 @@
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "MasterLimiter.h"
+#include "OfflineRenderEngine.h"
+#include "RealtimeAudioEngine.h"
+#include "Track.h"
+#include "TransportEngine.h"
+
+using namespace sampledex;
+
+namespace
+{
+    constexpr double benchmarkSampleRate = 48000.0;
+    constexpr int benchmarkTrackCount = 12;
+    constexpr double benchmarkSeconds = 30.0;
+
+    struct BenchmarkOptions
+    {
+        int blockSize = OfflineRenderSettings::defaultBlockSize;
+        int workerCount = 0;
+        double minSpeedFactor = 1.0;   // the parallel pass must stay faster than realtime
+        double minParallelGain = 1.2;  // ...and this much faster than one thread, given 4+ cores
+        double maxQuietLimiterCost = 1.0; // master limiter cost over the old stage, nothing to limit
+        double maxLimitingCost = 3.0;     // ...and while it limits loud material
+    };
+
+    // A synthetic session: every track runs the built-in synth into a few built-in
+    // effects, so each track is independent, CPU-bound work like a plugin chain.
+    struct Session
+    {
+        explicit Session(int blockSize)
+        {
+            transport.prepare(benchmarkSampleRate);
+            transport.setTempo(120.0);
+            transport.play();
+
+            for (int i = 0; i < benchmarkTrackCount; ++i)
+            {
+                auto* track = tracks.add(new Track("Offline Track " + juce::String(i + 1), formatManager));
+                track->setTransportPlayHead(&transport);
+                track->useBuiltInSynthInstrument();
+                track->setBuiltInEffectEnabled(Track::BuiltInEffect::Saturation, true);
+                track->setBuiltInEffectEnabled(Track::BuiltInEffect::Chorus, true);
+                track->setBuiltInEffectEnabled(Track::BuiltInEffect::Reverb, true);
+                track->prepareToPlay(benchmarkSampleRate, blockSize);
+                track->setPluginsNonRealtime(true);
+                mainBuffers.emplace_back(2, blockSize);
+                sendBuffers.emplace_back(2, blockSize);
+                sourceBuffers.emplace_back(2, blockSize);
+                sourceBuffers.back().clear();
+            }
+
+            midiBuffers.resize(static_cast<size_t>(benchmarkTrackCount));
+            for (auto& midi : midiBuffers)
+                midi.ensureSize(static_cast<size_t>(Track::getMidiArenaCapacityBytesForBlock(blockSize)));
+            for (auto& bus : auxBusBuffers)
+                bus.setSize(2, blockSize);
+            mixBuffer.setSize(2, blockSize);
+            trackOutputToBus.fill(false);
+            trackSendFeedbackBlocked.fill(false);
+            trackMonitorInputUsed.fill(false);
+            trackSendBusIndex.fill(0);
+            trackOutputBusIndex.fill(0);
+        }
+
+        ~Session()
+        {
+            for (auto* track : tracks)
+                track->releaseResources();
+        }
+
+        void renderBlock(RealtimeGraphScheduler& scheduler, juce::AudioBuffer<float>& out, int numSamples, std::int64_t blockIndex)
+        {
+            transport.advanceWithTempo(numSamples, 120.0);
+            for (int i = 0; i < benchmarkTrackCount; ++i)
+            {
+                auto& midi = midiBuffers[static_cast<size_t>(i)];
+                midi.clear();
+                const int note = 40 + static_cast<int>((blockIndex * 5 + i * 7) % 36);
+                midi.addEvent(juce::MidiMessage::noteOn(1, note, static_cast<juce::uint8>(96)), 0);
+                midi.addEvent(juce::MidiMessage::noteOff(1, note), juce::jmax(0, numSamples - 1));
+
+                auto& job = jobs[static_cast<size_t>(i)];
+                job.track = tracks[i];
+                job.mainBuffer = &mainBuffers[static_cast<size_t>(i)];
+                job.sourceAudio = &sourceBuffers[static_cast<size_t>(i)];
+                job.sendBuffer = &sendBuffers[static_cast<size_t>(i)];
+                job.midi = &midi;
+                job.blockSamples = numSamples;
+                job.processTrack = true;
+                job.offlineRender = true;
+                trackGraphAudible[static_cast<size_t>(i)] = true;
+            }
+
+            TransportBlockContext context;
+            context.numSamples = numSamples;
+            context.sampleRate = benchmarkSampleRate;
+            context.offlineRenderActive = true;
+
+            RealtimeMixInputs mixInputs;
+            mixInputs.activeTrackCount = benchmarkTrackCount;
+            mixInputs.auxBusCount = Track::maxSendBuses;
+            mixInputs.trackGraphAudible = &trackGraphAudible;
+            mixInputs.trackMonitorInputUsed = &trackMonitorInputUsed;
+            mixInputs.trackSendFeedbackBlocked = &trackSendFeedbackBlocked;
+            mixInputs.trackOutputToBus = &trackOutputToBus;
+            mixInputs.trackSendBusIndex = &trackSendBusIndex;
+            mixInputs.trackOutputBusIndex = &trackOutputBusIndex;
+
+            mixBuffer.clear();
+            for (auto& bus : auxBusBuffers)
+                bus.clear();
+            RealtimeAudioEngine::runTrackGraph(scheduler, context, mixInputs, jobs, mixBuffer, auxBusBuffers, {});
+            for (int ch = 0; ch < out.getNumChannels(); ++ch)
+                out.copyFrom(ch, 0, mixBuffer, ch, 0, numSamples);
+        }
+
+        juce::AudioPluginFormatManager formatManager;
+        TransportEngine transport;
+        juce::OwnedArray<Track> tracks;
+        std::vector<juce::AudioBuffer<float>> mainBuffers;
+        std::vector<juce::AudioBuffer<float>> sendBuffers;
+        std::vector<juce::AudioBuffer<float>> sourceBuffers;
+        std::vector<juce::MidiBuffer> midiBuffers;
+        std::array<RealtimeTrackGraphJob, 128> jobs {};
+        std::array<bool, 128> trackGraphAudible {};
+        std::array<bool, 128> trackMonitorInputUsed {};
+        std::array<bool, 128> trackSendFeedbackBlocked {};
+        std::array<bool, 128> trackOutputToBus {};
+        std::array<int, 128> trackSendBusIndex {};
+        std::array<int, 128> trackOutputBusIndex {};
+        std::array<juce::AudioBuffer<float>, Track::maxSendBuses> auxBusBuffers;
+        juce::AudioBuffer<float> mixBuffer;
+    };
+
+    struct PassResult
+    {
+        bool ok = false;
+        OfflineRenderProgress progress;
+        int workers = 0;
+        juce::AudioBuffer<float> rendered;
+    };
+
+    PassResult runPass(const OfflineRenderSettings& settings, bool parallel)
+    {
+        RealtimeGraphScheduler scheduler;
+        Session session(settings.getResolvedBlockSize());
+
+        PassResult result;
+        const auto totalSamples = static_cast<std::int64_t>(benchmarkSeconds * benchmarkSampleRate);
+        result.rendered.setSize(2, static_cast<int>(totalSamples));
+        std::unique_ptr<OfflineRenderEngine> engine;
+        if (parallel)
+            engine = std::make_unique<OfflineRenderEngine>(scheduler, settings);
+
+        const int blockSize = settings.getResolvedBlockSize();
+        juce::AudioBuffer<float> block(2, blockSize);
+        std::int64_t blockIndex = 0;
+        std::int64_t written = 0;
+        const auto renderBlock = [&](juce::AudioBuffer<float>& out, int numSamples)
+        {
+            session.renderBlock(scheduler, out, numSamples, blockIndex++);
+            return true;
+        };
+        const auto consumeBlock = [&](juce::AudioBuffer<float>& out, int numSamples)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                result.rendered.copyFrom(ch, static_cast<int>(written), out, ch, 0, numSamples);
+            written += numSamples;
+            return true;
+        };
+
+        if (engine != nullptr)
+        {
+            result.ok = engine->render(totalSamples, benchmarkSampleRate, 2, renderBlock, consumeBlock);
+            result.progress = engine->getLastProgress();
+            result.workers = engine->getWorkerCount();
+            return result;
+        }
+
+        // Serial reference: same block size, graph on the calling thread only.
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        while (written < totalSamples)
+        {
+            const int numSamples = static_cast<int>(juce::jmin<std::int64_t>(blockSize, totalSamples - written));
+            block.clear();
+            renderBlock(block, numSamples);
+            consumeBlock(block, numSamples);
+        }
+        result.progress.samplesRendered = written;
+        result.progress.totalSamples = totalSamples;
+        result.progress.elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        result.progress.speedFactor = result.progress.elapsedSeconds > 0.0
+            ? benchmarkSeconds / result.progress.elapsedSeconds
+            : 0.0;
+        result.ok = true;
+        return result;
+    }
+
+    constexpr double masterStageSeconds = 20.0;
+    constexpr int masterStageRepeats = 5;
+
+    // The per-sample master stage MasterLimiter replaced, kept as its cost reference:
+    // gain dezipper, peak-following gain, ceiling clamp, DC blocker and output clamp.
+    struct PreviousMasterStage
+    {
+        void process(juce::AudioBuffer<float>& buffer, int numSamples, const MasterLimiter::Settings& settings)
+        {
+            const int channels = juce::jmin(buffer.getNumChannels(), 2);
+            for (int i = 0; i < numSamples; ++i)
+            {
+                gain += (settings.targetGain - gain) * settings.gainDezipperCoeff;
+                float overPeak = 0.0f;
+                for (int ch = 0; ch < channels; ++ch)
+                {
+                    auto* write = buffer.getWritePointer(ch);
+                    write[i] *= gain;
+                    overPeak = juce::jmax(overPeak, std::abs(write[i]));
+                }
+
+                const float target = (settings.limiterEnabled && overPeak > settings.ceiling) ? settings.ceiling / overPeak : 1.0f;
+                limiterGain += (target - limiterGain) * (target < limiterGain ? 0.45f : settings.release);
+                for (int ch = 0; ch < channels; ++ch)
+                {
+                    auto* write = buffer.getWritePointer(ch);
+                    write[i] = juce::jlimit(-settings.ceiling, settings.ceiling, write[i] * limiterGain);
+                }
+            }
+
+            for (int ch = 0; ch < channels; ++ch)
+            {
+                auto* write = buffer.getWritePointer(ch);
+                const auto slot = static_cast<size_t>(ch);
+                if (settings.dcBlockerEnabled)
+                {
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        const float in = write[i];
+                        dcPrevOutput[slot] = in - dcPrevInput[slot] + (0.995f * dcPrevOutput[slot]);
+                        dcPrevInput[slot] = in;
+                        write[i] = dcPrevOutput[slot];
+                    }
+                }
+                constexpr float hardOutputClamp = 1.25f;
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float sample = write[i];
+                    write[i] = (!std::isfinite(sample) || std::abs(sample) > MasterLimiter::faultThreshold)
+                        ? 0.0f
+                        : juce::jlimit(-hardOutputClamp, hardOutputClamp, sample);
+                }
+            }
+        }
+
+        float gain = 1.0f;
+        float limiterGain = 1.0f;
+        std::array<float, 2> dcPrevInput {};
+        std::array<float, 2> dcPrevOutput {};
+    };
+
+    // Stereo noise over a 1 kHz tone; at level 2 the limiter works on almost every block.
+    juce::AudioBuffer<float> makeMasterStageSignal(float level)
+    {
+        const int length = static_cast<int>(masterStageSeconds * benchmarkSampleRate);
+        juce::AudioBuffer<float> signal(2, length);
+        juce::Random random(0x3a57e2);
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            auto* write = signal.getWritePointer(ch);
+            for (int i = 0; i < length; ++i)
+            {
+                const double tone = std::sin(juce::MathConstants<double>::twoPi * 1000.0 * i / benchmarkSampleRate);
+                write[i] = level * (0.6f * static_cast<float>(tone) + 0.4f * (random.nextFloat() * 2.0f - 1.0f));
+            }
+        }
+        return signal;
+    }
+
+    // Fastest of a few runs over the signal, block by block; the block copy is counted
+    // for both stages alike.
+    template <typename Process>
+    double timeMasterStage(const juce::AudioBuffer<float>& signal, int blockSize, Process&& process)
+    {
+        juce::AudioBuffer<float> block(2, blockSize);
+        double best = 0.0;
+        for (int repeat = 0; repeat < masterStageRepeats; ++repeat)
+        {
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            for (int start = 0; start < signal.getNumSamples(); start += blockSize)
+            {
+                const int numSamples = juce::jmin(blockSize, signal.getNumSamples() - start);
+                for (int ch = 0; ch < 2; ++ch)
+                    block.copyFrom(ch, 0, signal, ch, start, numSamples);
+                process(block, numSamples);
+            }
+            const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+            best = repeat == 0 ? elapsed : juce::jmin(best, elapsed);
+        }
+        return best;
+    }
+
+    // Limiter cost over the old stage's, for the same signal and settings.
+    double measureMasterStage(const char* name, float level, int blockSize)
+    {
+        MasterLimiter::Settings settings;
+        settings.limiterEnabled = true;
+        const auto signal = makeMasterStageSignal(level);
+
+        PreviousMasterStage previous;
+        const double previousSeconds = timeMasterStage(signal, blockSize, [&](juce::AudioBuffer<float>& block, int numSamples)
+        {
+            previous.process(block, numSamples, settings);
+        });
+
+        MasterLimiter limiter;
+        limiter.prepare(benchmarkSampleRate, blockSize);
+        const double limiterSeconds = timeMasterStage(signal, blockSize, [&](juce::AudioBuffer<float>& block, int numSamples)
+        {
+            limiter.process(block, 0, numSamples, settings);
+        });
+
+        const double frames = static_cast<double>(signal.getNumSamples());
+        const double cost = previousSeconds > 0.0 ? limiterSeconds / previousSeconds : 0.0;
+        std::printf("master %-9s | old stage %5.1f ns, limiter %5.1f ns per stereo frame | %.2fx\n",
+                    name,
+                    1.0e9 * previousSeconds / frames,
+                    1.0e9 * limiterSeconds / frames,
+                    cost);
+        return cost;
+    }
+
+    void printPass(const char* name, const PassResult& pass)
+    {
+        std::printf("%-8s workers %2d | %6.2f s for %.0f s of audio | %7.1fx realtime\n",
+                    name,
+                    pass.workers,
+                    pass.progress.elapsedSeconds,
+                    benchmarkSeconds,
+                    pass.progress.speedFactor);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String argument(argv[i]);
+        const auto value = argument.fromFirstOccurrenceOf("=", false, false);
+        if (argument.startsWith("--block-size="))
+            options.blockSize = value.getIntValue();
+        else if (argument.startsWith("--workers="))
+            options.workerCount = value.getIntValue();
+        else if (argument.startsWith("--min-speed-factor="))
+            options.minSpeedFactor = value.getDoubleValue();
+        else if (argument.startsWith("--min-parallel-gain="))
+            options.minParallelGain = value.getDoubleValue();
+        else if (argument.startsWith("--max-quiet-limiter-cost="))
+            options.maxQuietLimiterCost = value.getDoubleValue();
+        else if (argument.startsWith("--max-limiting-cost="))
+            options.maxLimitingCost = value.getDoubleValue();
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    OfflineRenderSettings settings;
+    settings.blockSize = options.blockSize;
+    settings.workerCount = options.workerCount;
+    std::printf("%d tracks, block %d, %u hardware threads\n",
+                benchmarkTrackCount,
+                settings.getResolvedBlockSize(),
+                std::thread::hardware_concurrency());
+
+    const auto serial = runPass(settings, false);
+    const auto parallel = runPass(settings, true);
+    printPass("serial", serial);
+    printPass("parallel", parallel);
+
+    bool ok = serial.ok && parallel.ok;
+    if (!ok)
+        std::fputs("render pass failed\n", stderr);
+
+    // Tracks are mixed in index order on the calling thread either way, so the result
+    // must not depend on which worker processed a track.
+    for (int ch = 0; ok && ch < 2; ++ch)
+    {
+        const auto* a = serial.rendered.getReadPointer(ch);
+        const auto* b = parallel.rendered.getReadPointer(ch);
+        for (int s = 0; s < serial.rendered.getNumSamples(); ++s)
+        {
+            if (a[s] != b[s])
+            {
+                std::fprintf(stderr, "parallel output differs from serial output at channel %d sample %d\n", ch, s);
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    if (ok && parallel.progress.speedFactor < options.minSpeedFactor)
+    {
+        std::fprintf(stderr, "speed factor %.2fx is below the required %.2fx\n", parallel.progress.speedFactor, options.minSpeedFactor);
+        ok = false;
+    }
+
+    const double gain = serial.progress.speedFactor > 0.0 ? parallel.progress.speedFactor / serial.progress.speedFactor : 0.0;
+    std::printf("parallel gain %.2fx\n", gain);
+    if (ok && parallel.workers >= 3 && gain < options.minParallelGain)
+    {
+        std::fprintf(stderr, "parallel gain %.2fx is below the required %.2fx\n", gain, options.minParallelGain);
+        ok = false;
+    }
+
+    const double quietCost = measureMasterStage("quiet", 0.3f, settings.getResolvedBlockSize());
+    const double limitingCost = measureMasterStage("limiting", 2.0f, settings.getResolvedBlockSize());
+    if (quietCost > options.maxQuietLimiterCost)
+    {
+        std::fprintf(stderr, "quiet master limiter costs %.2fx the old stage, over the allowed %.2fx\n", quietCost, options.maxQuietLimiterCost);
+        ok = false;
+    }
+    if (limitingCost > options.maxLimitingCost)
+    {
+        std::fprintf(stderr, "limiting master limiter costs %.2fx the old stage, over the allowed %.2fx\n", limitingCost, options.maxLimitingCost);
+        ok = false;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,250 @@
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "PluginBridge.h"
+
+using namespace sampledex;
+
+namespace
+{
+    constexpr double benchmarkSampleRate = 48000.0;
+    constexpr int warmupBlocks = 200;
+    constexpr int measuredBlocks = 4000;
+    constexpr float benchmarkGain = 0.5f;
+
+    // Minimal stand-in for a plugin: one gain parameter, so the run also covers
+    // parameter forwarding from the engine side, and a state that is stored as is.
+    class GainProcessor final : public juce::AudioProcessor
+    {
+    public:
+        GainProcessor()
+            : juce::AudioProcessor(BusesProperties()
+                                       .withInput("Input", juce::AudioChannelSet::stereo(), true)
+                                       .withOutput("Output", juce::AudioChannelSet::stereo(), true))
+        {
+            gain = new juce::AudioParameterFloat(juce::ParameterID { "gain", 1 }, "Gain", 0.0f, 1.0f, 1.0f);
+            addParameter(gain);
+        }
+
+        const juce::String getName() const override { return "Bridge Benchmark Gain"; }
+        void prepareToPlay(double, int) override {}
+        void releaseResources() override {}
+
+        void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override
+        {
+            buffer.applyGain(gain->get());
+        }
+
+        juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+        bool hasEditor() const override { return false; }
+        bool acceptsMidi() const override { return true; }
+        bool producesMidi() const override { return false; }
+        double getTailLengthSeconds() const override { return 0.0; }
+        int getNumPrograms() override { return 1; }
+        int getCurrentProgram() override { return 0; }
+        void setCurrentProgram(int) override {}
+        const juce::String getProgramName(int) override { return {}; }
+        void changeProgramName(int, const juce::String&) override {}
+        void getStateInformation(juce::MemoryBlock& destData) override { destData = state; }
+        void setStateInformation(const void* data, int sizeInBytes) override { state.replaceAll(data, static_cast<size_t>(sizeInBytes)); }
+
+        juce::AudioParameterFloat* gain = nullptr;
+        juce::MemoryBlock state;
+    };
+
+    struct Timings
+    {
+        double medianMicros = 0.0;
+        double p99Micros = 0.0;
+        double maxMicros = 0.0;
+    };
+
+    Timings summarise(std::vector<double>& samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        Timings timings;
+        timings.medianMicros = samples[samples.size() / 2];
+        timings.p99Micros = samples[(samples.size() * 99) / 100];
+        timings.maxMicros = samples.back();
+        return timings;
+    }
+
+    double ticksToMicros(juce::int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+    }
+
+    void fillInput(juce::AudioBuffer<float>& buffer, int block)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int s = 0; s < buffer.getNumSamples(); ++s)
+                buffer.setSample(ch, s, 0.25f * std::sin(static_cast<float>(block * buffer.getNumSamples() + s) * 0.01f));
+    }
+
+    // Larger than one transfer chunk, so both directions take several round trips.
+    bool checkLargeStateRoundTrip(PluginBridgeClient& client)
+    {
+        juce::MemoryBlock sent(static_cast<size_t>(PluginBridgeShared::payloadChunkBytes) * 3 + 12345);
+        for (size_t i = 0; i < sent.getSize(); ++i)
+            sent[i] = static_cast<char>((i * 131u) >> 3);
+
+        juce::String errorText;
+        juce::MemoryBlock received;
+        if (!client.setState(sent.getData(), sent.getSize(), errorText) || !client.getState(received, errorText))
+        {
+            std::fprintf(stderr, "state transfer failed: %s\n", errorText.toRawUTF8());
+            return false;
+        }
+        if (received != sent)
+        {
+            std::fprintf(stderr, "state came back different (%d of %d bytes)\n",
+                         static_cast<int>(received.getSize()),
+                         static_cast<int>(sent.getSize()));
+            return false;
+        }
+
+        PluginBridgeInfo info;
+        if (!client.getPluginInfo(info, errorText) || info.parameters.size() != 1 || info.parameters[0].name != "Gain")
+        {
+            std::fprintf(stderr, "plugin info query failed: %s\n", errorText.toRawUTF8());
+            return false;
+        }
+
+        std::printf("state round trip of %d bytes ok\n", static_cast<int>(sent.getSize()));
+        return true;
+    }
+
+    bool runBlockSize(PluginBridgeClient& client, GainProcessor& parameters, int blockSize)
+    {
+        juce::String errorText;
+        if (!client.prepare(benchmarkSampleRate, blockSize, errorText))
+        {
+            std::fprintf(stderr, "prepare failed: %s\n", errorText.toRawUTF8());
+            return false;
+        }
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::AudioBuffer<float> reference(2, blockSize);
+        juce::MidiBuffer midi;
+        midi.ensureSize(1024);
+        GainProcessor inProcess;
+        inProcess.gain->setValueNotifyingHost(benchmarkGain);
+
+        std::vector<double> bridged;
+        std::vector<double> direct;
+        bridged.reserve(measuredBlocks);
+        direct.reserve(measuredBlocks);
+
+        bool outputMatches = true;
+        for (int block = 0; block < warmupBlocks + measuredBlocks; ++block)
+        {
+            fillInput(buffer, block);
+            reference.makeCopyOf(buffer, true);
+            midi.clear();
+            midi.addEvent(juce::MidiMessage::noteOn(1, 60, static_cast<juce::uint8>(100)), 0);
+
+            const auto bridgedStart = juce::Time::getHighResolutionTicks();
+            const auto result = client.process(buffer, midi, blockSize, &parameters);
+            if (result != PluginBridgeClient::ProcessResult::ok)
+            {
+                std::fprintf(stderr, "process failed at block %d: %s\n", block, client.getFailureText(result));
+                return false;
+            }
+            const auto bridgedEnd = juce::Time::getHighResolutionTicks();
+
+            midi.clear();
+            inProcess.processBlock(reference, midi);
+            const auto directEnd = juce::Time::getHighResolutionTicks();
+
+            for (int ch = 0; ch < buffer.getNumChannels() && outputMatches; ++ch)
+                for (int s = 0; s < blockSize && outputMatches; ++s)
+                    outputMatches = std::abs(buffer.getSample(ch, s) - reference.getSample(ch, s)) < 1.0e-6f;
+
+            if (block >= warmupBlocks)
+            {
+                bridged.push_back(ticksToMicros(bridgedEnd - bridgedStart));
+                direct.push_back(ticksToMicros(directEnd - bridgedEnd));
+            }
+        }
+
+        if (!outputMatches)
+        {
+            std::fprintf(stderr, "bridged output differs from in-process output at block size %d\n", blockSize);
+            return false;
+        }
+
+        const auto bridgedTimings = summarise(bridged);
+        const auto directTimings = summarise(direct);
+        const double budgetMicros = 1.0e6 * static_cast<double>(blockSize) / benchmarkSampleRate;
+        std::printf("block %4d  budget %8.1f us | bridged median %7.1f p99 %7.1f max %8.1f us | in-process median %6.1f p99 %6.1f us\n",
+                    blockSize,
+                    budgetMicros,
+                    bridgedTimings.medianMicros,
+                    bridgedTimings.p99Micros,
+                    bridgedTimings.maxMicros,
+                    directTimings.medianMicros,
+                    directTimings.p99Micros);
+        return true;
+    }
+
+    int runChild(const juce::String& sharedMemoryName)
+    {
+        return PluginBridgeServer::run(sharedMemoryName,
+                                       [](const juce::PluginDescription&, double, int, juce::String&)
+                                       {
+                                           return std::unique_ptr<juce::AudioProcessor>(std::make_unique<GainProcessor>());
+                                       });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String argument(argv[i]);
+        if (argument.startsWith("--plugin-bridge-host="))
+            return runChild(argument.fromFirstOccurrenceOf("=", false, false));
+    }
+
+    if (!PluginBridgeClient::isSupportedOnThisPlatform())
+    {
+        std::puts("PluginBridgeBenchmark: sandboxed hosting is not supported on this platform, skipping.");
+        return 0;
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::PluginDescription description;
+    description.name = "Bridge Benchmark Gain";
+    description.pluginFormatName = "Internal";
+    description.fileOrIdentifier = "bridge-benchmark-gain";
+    description.numInputChannels = 2;
+    description.numOutputChannels = 2;
+
+    PluginBridgeConfig config;
+    config.sampleRate = benchmarkSampleRate;
+    config.blockSize = 512;
+    // Generous so a loaded CI machine measures jitter rather than failing outright.
+    config.processTimeoutMarginMs = 500.0;
+
+    PluginBridgeClient client;
+    juce::String errorText;
+    if (!client.launch(juce::File::getSpecialLocation(juce::File::currentExecutableFile), description, config, errorText))
+    {
+        std::fprintf(stderr, "launch failed: %s\n", errorText.toRawUTF8());
+        return 1;
+    }
+
+    GainProcessor parameters;
+    client.resyncParameters(parameters);
+    parameters.gain->setValueNotifyingHost(benchmarkGain);
+
+    bool ok = checkLargeStateRoundTrip(client);
+    for (const int blockSize : { 32, 64, 128, 256, 512 })
+        ok = ok && runBlockSize(client, parameters, blockSize);
+
+    client.shutdown();
+    return ok ? 0 : 1;
+}
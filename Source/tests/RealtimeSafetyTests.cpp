@@ -0,0 +1,139 @@
+#include <JuceHeader.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "RealtimeSafetyMonitor.h"
+#include "ScheduledMidiOutput.h"
+#include "Track.h"
+#include "TransportEngine.h"
+
+using namespace sampledex;
+
+namespace
+{
+    constexpr double testSampleRate = 48000.0;
+    constexpr int testBlockSize = 256;
+    constexpr int testTrackCount = 4;
+    constexpr int testBlockCount = 400;
+
+    bool detectorCatchesKnownAllocation()
+    {
+        RealtimeSafetyMonitor::reset();
+        {
+            RealtimeSafetyMonitor::ScopedRealtimeContext realtimeScope;
+            std::vector<int> deliberateAllocation(64, 1);
+            juce::ignoreUnused(deliberateAllocation);
+        }
+        const bool caught = RealtimeSafetyMonitor::getViolationCount(RealtimeSafetyMonitor::ViolationKind::OperatorNew) > 0;
+        RealtimeSafetyMonitor::reset();
+        return caught;
+    }
+
+    bool runSyntheticSession()
+    {
+        juce::AudioPluginFormatManager formatManager;
+        TransportEngine transport;
+        transport.prepare(testSampleRate);
+        transport.setTempo(124.0);
+        transport.setLoop(true, 0.0, 8.0);
+        transport.play();
+
+        juce::OwnedArray<Track> tracks;
+        std::vector<juce::AudioBuffer<float>> mainBuffers;
+        std::vector<juce::AudioBuffer<float>> sendBuffers;
+        std::vector<juce::AudioBuffer<float>> sourceBuffers;
+        std::vector<juce::MidiBuffer> midiBuffers(static_cast<size_t>(testTrackCount));
+        for (int i = 0; i < testTrackCount; ++i)
+        {
+            auto* track = tracks.add(new Track("RT Track " + juce::String(i + 1), formatManager));
+            track->setTransportPlayHead(&transport);
+            track->prepareToPlay(testSampleRate, testBlockSize);
+            mainBuffers.emplace_back(2, testBlockSize);
+            sendBuffers.emplace_back(2, testBlockSize);
+            sourceBuffers.emplace_back(2, testBlockSize);
+            midiBuffers[static_cast<size_t>(i)].ensureSize(static_cast<size_t>(Track::getMidiArenaCapacityBytesForBlock(testBlockSize)));
+        }
+
+        ScheduledMidiOutput scheduledOutput;
+        scheduledOutput.reset();
+        juce::MidiBuffer scheduledMidi;
+        scheduledMidi.ensureSize(1024);
+
+        RealtimeSafetyMonitor::reset();
+        for (int block = 0; block < testBlockCount; ++block)
+        {
+            // Anything the message thread would do (building MIDI, filling source audio)
+            // stays outside the guard; everything the audio callback does goes inside.
+            for (int i = 0; i < testTrackCount; ++i)
+            {
+                auto& midi = midiBuffers[static_cast<size_t>(i)];
+                midi.clear();
+                const int note = 48 + ((block + i * 3) % 24);
+                if ((block % 8) == 0)
+                    midi.addEvent(juce::MidiMessage::noteOn(1, note, static_cast<juce::uint8>(100)), 0);
+                if ((block % 8) == 6)
+                    midi.addEvent(juce::MidiMessage::allNotesOff(1), testBlockSize / 2);
+
+                // Dense MPE-style controller stream to exercise the per-track MIDI arenas.
+                for (int s = 0; s < testBlockSize; s += 4)
+                {
+                    const int channel = 2 + ((s / 4) % 15);
+                    midi.addEvent(juce::MidiMessage::pitchWheel(channel, 8192 + ((block * 37 + s) % 2048)), s);
+                    midi.addEvent(juce::MidiMessage::channelPressureChange(channel, (block + s) % 128), s);
+                }
+
+                auto& source = sourceBuffers[static_cast<size_t>(i)];
+                for (int ch = 0; ch < source.getNumChannels(); ++ch)
+                    for (int s = 0; s < testBlockSize; ++s)
+                        source.setSample(ch, s, 0.05f * std::sin(static_cast<float>(block * testBlockSize + s) * 0.01f));
+            }
+
+            RealtimeSafetyMonitor::ScopedRealtimeContext realtimeScope;
+            transport.advanceWithTempo(testBlockSize, 124.0);
+            juce::ignoreUnused(transport.getPosition());
+
+            scheduledMidi.clear();
+            scheduledOutput.process(testBlockSize, testSampleRate, scheduledMidi);
+
+            for (int i = 0; i < testTrackCount; ++i)
+            {
+                auto& main = mainBuffers[static_cast<size_t>(i)];
+                auto& send = sendBuffers[static_cast<size_t>(i)];
+                main.clear();
+                send.clear();
+                tracks[i]->processBlockAndSends(main,
+                                                send,
+                                                midiBuffers[static_cast<size_t>(i)],
+                                                &sourceBuffers[static_cast<size_t>(i)],
+                                                nullptr,
+                                                false);
+            }
+        }
+
+        const bool clean = RealtimeSafetyMonitor::getViolationCount() == 0;
+        if (!clean)
+            std::fputs(RealtimeSafetyMonitor::createReport().toRawUTF8(), stderr);
+
+        for (auto* track : tracks)
+            track->releaseResources();
+        return clean;
+    }
+}
+
+int main()
+{
+    if (!RealtimeSafetyMonitor::isCompiledIn())
+    {
+        std::fputs("RealtimeSafetyTests requires SAMPLEDEX_RT_SAFETY_CHECKS=1\n", stderr);
+        return 1;
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    RealtimeSafetyMonitor::setEnabled(true);
+
+    const bool detectorOk = detectorCatchesKnownAllocation();
+    const bool sessionOk = detectorOk && runSyntheticSession();
+
+    RealtimeSafetyMonitor::setEnabled(false);
+    return (detectorOk && sessionOk) ? 0 : 1;
+}
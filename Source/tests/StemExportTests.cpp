@@ -0,0 +1,187 @@
+#include <JuceHeader.h>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "IsolatedRenderEngine.h"
+#include "OfflineStemCapture.h"
+#include "Track.h"
+
+using namespace sampledex;
+
+namespace
+{
+    constexpr double testSampleRate = 48000.0;
+    constexpr int testBlockSize = 512;
+    constexpr int stemBus = 0;   // track 1 sends here; the aux strip listens to it
+    constexpr int outputBus = 1; // track 2 plays into this bus instead of the master
+
+    // Keeps every float sample it is given, in place of a stem file.
+    class MemoryStemWriter final : public juce::AudioFormatWriter
+    {
+    public:
+        explicit MemoryStemWriter(std::vector<std::vector<float>>& destination)
+            : juce::AudioFormatWriter(nullptr, "Memory", testSampleRate, 2, 32),
+              samples(destination)
+        {
+            usesFloatingPointData = true;
+            samples.assign(2, {});
+        }
+
+        bool write(const int** samplesToWrite, int numSamples) override
+        {
+            for (size_t ch = 0; ch < samples.size() && samplesToWrite[ch] != nullptr; ++ch)
+            {
+                const auto* source = reinterpret_cast<const float*>(samplesToWrite[ch]);
+                samples[ch].insert(samples[ch].end(), source, source + numSamples);
+            }
+            return true;
+        }
+
+    private:
+        std::vector<std::vector<float>>& samples;
+    };
+
+    using Stem = std::vector<std::vector<float>>;
+
+    // Three synth tracks and an aux strip: one track feeds the aux bus through its send,
+    // one plays into a bus instead of the master, so the buses depend on tracks in
+    // other shards.
+    std::unique_ptr<IsolatedRenderProject> createProject(juce::AudioPluginFormatManager& pluginFormats)
+    {
+        auto project = std::make_unique<IsolatedRenderProject>();
+        project->fallbackBpm = 120.0;
+        for (int i = 0; i < 4; ++i)
+        {
+            auto track = std::make_unique<Track>("Stem Track " + juce::String(i + 1), pluginFormats);
+            if (i < 3)
+            {
+                track->useBuiltInSynthInstrument();
+                Clip clip;
+                clip.name = "Notes " + juce::String(i + 1);
+                clip.type = ClipType::MIDI;
+                clip.startBeat = 0.0;
+                clip.lengthBeats = 8.0;
+                clip.trackIndex = i;
+                for (int beat = 0; beat < 8; ++beat)
+                    clip.events.push_back({ static_cast<double>(beat), 0.75, 48 + i * 7 + (beat % 3) * 4, static_cast<std::uint8_t>(90 + i * 10) });
+                project->arrangement.push_back(std::move(clip));
+            }
+            project->tracks.push_back(std::move(track));
+        }
+
+        project->tracks[1]->setSendTargetBus(stemBus);
+        project->tracks[1]->setSendLevel(0.6f);
+        project->tracks[2]->routeOutputToBus(outputBus);
+        project->tracks[3]->setChannelType(Track::ChannelType::Aux);
+        project->tracks[3]->setSendTargetBus(stemBus);
+        project->auxReverbParameters.roomSize = 0.6f;
+        project->auxReverbParameters.wetLevel = 1.0f;
+        project->auxReverbParameters.dryLevel = 0.0f;
+        return project;
+    }
+
+    // Renders the track and bus stems in passes of at most stemsPerPass writers, bus stems
+    // first, as the export does when the writers do not fit in its memory budget.
+    bool renderStems(IsolatedRenderEngine& engine, int stemsPerPass, std::vector<Stem>& trackStems, std::vector<Stem>& busStems)
+    {
+        const int trackCount = engine.getNumTracks();
+        trackStems.assign(static_cast<size_t>(trackCount), {});
+        busStems.assign(2, {});
+
+        IsolatedRenderEngine::Pass pass;
+        pass.startBeat = 0.0;
+        pass.endBeat = 8.0;
+        pass.tailSeconds = 1.0;
+        pass.includeMasterProcessing = false;
+
+        bool busStemsPending = true;
+        int nextTrack = 0;
+        while (nextTrack < trackCount || busStemsPending)
+        {
+            OfflineStemCapture capture;
+            if (busStemsPending)
+            {
+                capture.addBusStem(stemBus, std::make_unique<MemoryStemWriter>(busStems[0]));
+                capture.addBusStem(outputBus, std::make_unique<MemoryStemWriter>(busStems[1]));
+                busStemsPending = false;
+            }
+            while (nextTrack < trackCount && capture.getNumStems() < stemsPerPass)
+            {
+                capture.addTrackStem(nextTrack, std::make_unique<MemoryStemWriter>(trackStems[static_cast<size_t>(nextTrack)]));
+                ++nextTrack;
+            }
+
+            auto stemPass = pass;
+            stemPass.stemCapture = &capture;
+            const bool rendered = engine.renderPass(stemPass, [&capture](juce::AudioBuffer<float>&, int numSamples)
+            {
+                return capture.writeBlock(numSamples, [](juce::AudioBuffer<float>&, int, std::uint32_t&) {});
+            });
+            capture.close();
+            if (!rendered)
+                return false;
+        }
+        return true;
+    }
+
+    float largestDifference(const Stem& a, const Stem& b)
+    {
+        if (a.size() != b.size())
+            return INFINITY;
+        float difference = 0.0f;
+        for (size_t ch = 0; ch < a.size(); ++ch)
+        {
+            if (a[ch].size() != b[ch].size())
+                return INFINITY;
+            for (size_t i = 0; i < a[ch].size(); ++i)
+                difference = juce::jmax(difference, std::abs(a[ch][i] - b[ch][i]));
+        }
+        return difference;
+    }
+
+    float peakOf(const Stem& stem)
+    {
+        float peak = 0.0f;
+        for (const auto& channel : stem)
+            for (const float sample : channel)
+                peak = juce::jmax(peak, std::abs(sample));
+        return peak;
+    }
+
+    bool shardedStemsMatchOnePass()
+    {
+        juce::AudioPluginFormatManager pluginFormats;
+        juce::AudioFormatManager audioFormats;
+        OfflineRenderSettings settings;
+        settings.blockSize = testBlockSize;
+        IsolatedRenderEngine engine(createProject(pluginFormats), audioFormats, settings);
+        engine.prepare(testSampleRate);
+
+        std::vector<Stem> referenceTracks, referenceBuses, shardedTracks, shardedBuses;
+        bool passed = renderStems(engine, OfflineStemCapture::maxOpenWriters, referenceTracks, referenceBuses)
+                   && renderStems(engine, 2, shardedTracks, shardedBuses);
+
+        float difference = passed ? 0.0f : INFINITY;
+        for (size_t i = 0; i < referenceTracks.size() && passed; ++i)
+            difference = juce::jmax(difference, largestDifference(referenceTracks[i], shardedTracks[i]));
+        for (size_t bus = 0; bus < referenceBuses.size() && passed; ++bus)
+            difference = juce::jmax(difference, largestDifference(referenceBuses[bus], shardedBuses[bus]));
+
+        // The stems must hold audio for the comparison to mean anything.
+        const bool audible = passed && peakOf(referenceTracks[0]) > 0.01f
+                          && peakOf(referenceBuses[0]) > 0.01f && peakOf(referenceBuses[1]) > 0.01f;
+        passed = passed && audible && difference < 1.0e-5f;
+        std::printf("%s: sharded stems match a single pass (largest difference %g)\n", passed ? "PASS" : "FAIL", difference);
+        return passed;
+    }
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    bool passed = true;
+    passed = shardedStemsMatchOnePass() && passed;
+    return passed ? 0 : 1;
+}